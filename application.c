@@ -8,33 +8,122 @@ extern "C" {
 #include <SDL.h>
 #include <SDL_log.h>
 
+#include "clock.h"
 #include "render.h"
 #include "input.h"
+#include "latency.h"
 #include "test.h"
 #include "font.h"
+#include "io.h"
+#include "pack.h"
+#include "pace.h"
+#include "replay.h"
 #include "time.h"
+#include "watch.h"
 
-typedef enum {
-    EVENT_RUN_GAME_LOOP = 1
-} EApplicationEventType;
+#pragma region Settings
+/** Packed assets built by ShquarkzPacker, loose files under assets/ are used when it is missing. */
+static const pStr AssetPackPath = "assets.pak";
+/** Input latency distributions written on shutdown. */
+static const pStr LatencyPath = "latency.json";
+#pragma endregion
 
 #pragma region Private Variables
 static Bool bInitialized = False;
+static FPack* AssetPack = NULL;
 static Bool bShutdownRequested = False;
+
+/** Input of the current simulation step, gameplay reads it instead of handling events. */
+static FInputSnapshot InputSnapshot;
+
+/** Session log given on the command line, recorded or replayed instead of live input. */
+static pStr RecordPath = NULL;
+static pStr ReplayPath = NULL;
+/** Replays the frames as fast as they complete instead of at the recorded speed. */
+static Bool bReplayFast = False;
+static FReplay* ReplayLog = NULL;
+
+/** Renders offscreen without a window, reading the frames back for a checksum of the last one when asked to. */
+static Bool bHeadless = False;
+static Bool bChecksum = False;
+
+/** Chunk shading given on the command line, for comparing the shader variants. */
+static Bool bMaterialAtlas = False;
+static U32 EnabledChunkFeatures = 0;
+static U32 DisabledChunkFeatures = 0;
+static Bool bFacePulling = False;
+/** HUD text size in pixels, the default when zero. */
+static F32 TextSize = 0.f;
+/** Renders on the main thread, for debugging. */
+static Bool bSingleThread = False;
 #pragma endregion
 
 #pragma region Private Function Declarations
-/** Advances game step by pushing a frame event to SDL. */
-static void Application_AdvanceGameStep();
+/** Waits for the next event until the frame is due. Returns False once it is due, after spinning to its start. */
+static Bool Application_WaitEvent(SDL_Event* OutEvent);
+
+/** Advances game simulation by a single frame of the delta time in milliseconds. */
+static void Application_Tick(U32 DeltaTime);
+
+/** Runs the frames of the replayed log, feeding its events to the input service, then prints the frame times. */
+static void Application_RunReplay();
 
-/** Advances game simulation by a single frame. */
-static void Application_Tick();
+/** Sleeps and spins until the clock reaches the deadline. */
+static void Application_WaitUntil(U64 Deadline);
 
-/** Handles SDL events. */
-static void Application_HandleEvent(SDL_Event Event);
+static void Application_PrintUsage(pStr Program);
+
+/** Switches frame pacing to the idle frame time while the window is minimized or unfocused. */
+static void Application_HandleWindowEvent(const SDL_WindowEvent* Event);
 #pragma endregion
 
 #pragma region Public Function Definitions
+Bool Application_ParseOptions(const int ArgumentCount, char* Arguments[]) {
+    for (int Index = 1; Index < ArgumentCount; Index++) {
+        const pStr Argument = Arguments[Index];
+        const Bool bHasValue = Index + 1 < ArgumentCount;
+
+        if (SDL_strcmp(Argument, "--record") == 0 && bHasValue) {
+            RecordPath = Arguments[++Index];
+        } else if (SDL_strcmp(Argument, "--replay") == 0 && bHasValue) {
+            ReplayPath = Arguments[++Index];
+        } else if (SDL_strcmp(Argument, "--fast") == 0) {
+            bReplayFast = True;
+        } else if (SDL_strcmp(Argument, "--headless") == 0) {
+            bHeadless = True;
+        } else if (SDL_strcmp(Argument, "--checksum") == 0) {
+            bHeadless = True;
+            bChecksum = True;
+        } else if (SDL_strcmp(Argument, "--atlas") == 0) {
+            bMaterialAtlas = True;
+        } else if (SDL_strcmp(Argument, "--no-detail") == 0) {
+            DisabledChunkFeatures |= RENDER_CHUNK_DETAIL;
+        } else if (SDL_strcmp(Argument, "--no-fog") == 0) {
+            DisabledChunkFeatures |= RENDER_CHUNK_FOG;
+        } else if (SDL_strcmp(Argument, "--smudge") == 0) {
+            EnabledChunkFeatures |= RENDER_CHUNK_SMUDGE;
+        } else if (SDL_strcmp(Argument, "--rim") == 0) {
+            EnabledChunkFeatures |= RENDER_CHUNK_RIM;
+        } else if (SDL_strcmp(Argument, "--faces") == 0) {
+            bFacePulling = True;
+        } else if (SDL_strcmp(Argument, "--text-size") == 0 && bHasValue) {
+            TextSize = (F32)SDL_atof(Arguments[++Index]);
+        } else if (SDL_strcmp(Argument, "--single-thread") == 0) {
+            bSingleThread = True;
+        } else {
+            Application_PrintUsage(Arguments[0]);
+            return False;
+        }
+    }
+
+    if (RecordPath != NULL && ReplayPath != NULL) {
+        Application_PrintUsage(Arguments[0]);
+        return False;
+    }
+
+    return True;
+}
+
 Bool Application_Initialize() {
     if (bInitialized) {
         return bInitialized;
@@ -51,25 +140,97 @@ Bool Application_Initialize() {
     }
 
     Time_Initialize();
+    Latency_Initialize();
+    Io_Initialize(IO_BACKEND_DEFAULT);
+
+    AssetPack = Pack_Open(AssetPackPath);
+    if (AssetPack != NULL) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Using asset pack %s with %u entries", AssetPackPath, Pack_GetEntryCount(AssetPack));
+        Io_MountPack(AssetPack);
+    } else {
+        // Loose assets are being edited, reload them on change.
+        Watch_Initialize();
+    }
+
+    // A replay generates the world it was recorded in.
+    FRenderSettings RenderSettings;
+    Render_GetDefaultSettings(&RenderSettings);
+    RenderSettings.bHeadless = bHeadless;
+    RenderSettings.bReadback = bChecksum;
+    RenderSettings.bMaterialArray = !bMaterialAtlas;
+    RenderSettings.ChunkFeatures = (RenderSettings.ChunkFeatures | EnabledChunkFeatures) & ~DisabledChunkFeatures;
+    RenderSettings.bFacePulling = bFacePulling;
+    RenderSettings.bSingleThread = bSingleThread;
+    if (TextSize > 0.f) {
+        RenderSettings.TextSize = TextSize;
+    }
+    if (ReplayPath != NULL) {
+        ReplayLog = Replay_Open(ReplayPath);
+        if (ReplayLog == NULL) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to open the replay %s.", ReplayPath);
+            return False;
+        }
+        RenderSettings.Seed = Replay_GetSeed(ReplayLog);
+    } else if (RecordPath != NULL) {
+        ReplayLog = Replay_Create(RecordPath, RenderSettings.Seed);
+        if (ReplayLog == NULL) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to create the recording %s.", RecordPath);
+            return False;
+        }
+    }
+
     Font_Initialize();
-    Render_Initialize();
+    Render_Initialize(&RenderSettings);
     Input_Initialize();
+    if (RecordPath != NULL) {
+        Input_SetRecorder(ReplayLog);
+    }
 
-    bInitialized = True;
+    // Frames follow the display refresh, vsync alone would block the render thread and not the main loop.
+    FPaceSettings PaceSettings;
+    Pace_GetDefaultSettings(&PaceSettings);
+    if (Render_GetRefreshNanoseconds() > 0) {
+        PaceSettings.FrameNanoseconds = Render_GetRefreshNanoseconds();
+    }
+    Pace_Initialize(&PaceSettings);
 
-    Application_AdvanceGameStep();
+    bInitialized = True;
 
     return bInitialized;
 }
 
 void Application_Run() {
+    if (ReplayPath != NULL) {
+        Application_RunReplay();
+        Test_Run();
+        return;
+    }
+
     SDL_Event Event;
 
-    // Main game loop.
-    while (!bShutdownRequested && SDL_WaitEvent(&Event)) {
+    // Main game loop, events are handled as they arrive between frames.
+    while (!bShutdownRequested) {
+        if (!Application_WaitEvent(&Event)) {
+            const U32 DeltaTime = Time_Tick();
+
+            // The frame follows the events it consumes in the recording.
+            if (RecordPath != NULL) {
+                const FReplayRecord Record = {REPLAY_RECORD_FRAME, Clock_GetNanoseconds(), 0, 0, 0, DeltaTime};
+                if (!Replay_Write(ReplayLog, &Record)) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to record the frame, recording stopped.");
+                    Input_SetRecorder(NULL);
+                    RecordPath = NULL;
+                }
+            }
+
+            Application_Tick(DeltaTime);
+            Pace_EndFrame();
+            continue;
+        }
+
         switch (Event.type) {
-        case SDL_USEREVENT:
-            Application_HandleEvent(Event);
+        case SDL_WINDOWEVENT:
+            Application_HandleWindowEvent(&Event.window);
             break;
 
         case SDL_KEYDOWN:
@@ -97,9 +258,31 @@ void Application_RequestShutdown() {
 }
 
 void Application_Shutdown() {
+    // The render thread uses the watches and the font until it stops.
     Render_Shutdown();
+
+    // Frames queued at shutdown are rendered by now, the last one is read back.
+    FRenderReadback Readback;
+    if (bChecksum && Render_GetReadback(&Readback, NULL)) {
+        printf("Frame %llu checksum %016llx (%ux%u)\n", (unsigned long long)Readback.Frame, (unsigned long long)Readback.Checksum, Readback.Width,
+               Readback.Height);
+    }
+    Watch_Shutdown();
+    Input_SetRecorder(NULL);
+    Input_Shutdown();
+    Replay_Close(ReplayLog);
+    ReplayLog = NULL;
+    Font_Shutdown();
+    Io_Shutdown();
+    Pack_Close(AssetPack);
+    AssetPack = NULL;
     Time_Shutdown();
 
+    if (Latency_Write(LatencyPath)) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Input latency written to %s", LatencyPath);
+    }
+    Latency_Shutdown();
+
     SDL_QuitSubSystem(SDL_INIT_EVENTS);
     SDL_Quit();
 }
@@ -107,39 +290,127 @@ void Application_Shutdown() {
 #pragma endregion
 
 #pragma region Private Function Definitions
-void Application_AdvanceGameStep() {
-    SDL_Event Event;
-    SDL_UserEvent UserEvent;
+Bool Application_WaitEvent(SDL_Event* OutEvent) {
+    for (;;) {
+        const U64 SleepNanoseconds = Pace_GetSleepNanoseconds();
+        if (SleepNanoseconds < 1000000) {
+            break;
+        }
 
-    UserEvent.timestamp = 0;
-    UserEvent.windowID = SDL_GetWindowID(Render_GetSDLWindow());
-    UserEvent.type = SDL_USEREVENT;
-    UserEvent.code = EVENT_RUN_GAME_LOOP;
-    UserEvent.data1 = 0;
-    UserEvent.data2 = 0;
+        // SDL waits in milliseconds, the rest is spun by Pace_BeginFrame.
+        const U64 Requested = SleepNanoseconds / 1000000 * 1000000;
+        const U64 Start = Clock_GetNanoseconds();
+        if (SDL_WaitEventTimeout(OutEvent, (int)(Requested / 1000000))) {
+            return True;
+        }
+        Pace_OnSlept(Requested, Clock_GetNanoseconds() - Start);
+    }
 
-    Event.type = SDL_USEREVENT;
-    Event.user = UserEvent;
+    // Events received by now belong to this frame.
+    if (SDL_PollEvent(OutEvent)) {
+        return True;
+    }
+
+    Pace_BeginFrame();
+    return False;
+}
+
+void Application_Tick(const U32 DeltaTime) {
+    // Services read the step's delta from the time service, a replay steps with the recorded deltas.
+    Time_SetDeltaTime(DeltaTime);
+
+    Input_BuildSnapshot(Clock_GetNanoseconds(), &InputSnapshot);
+    if (Input_IsActionPressed(&InputSnapshot, INPUT_ACTION_EXIT)) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Requested application exit.");
+        Application_RequestShutdown();
+    }
+
+    if (Input_IsActionPressed(&InputSnapshot, INPUT_ACTION_TOGGLE_OVERLAY)) {
+        Render_ToggleOverlay();
+    }
 
-    SDL_PushEvent(&Event);
+    // Changed assets are reloaded and finished asset reads dispatched by the render thread, handlers upload on it.
+    Render_Tick(InputSnapshot.EventTimestamps, InputSnapshot.EventCount);
 }
 
-void Application_Tick() {
-    U32 DeltaTime = Time_Tick();
+void Application_RunReplay() {
+    const U64 Start = Clock_GetNanoseconds();
+    FReplayRecord Record;
+    SDL_Event Event;
+
+    while (!bShutdownRequested && Replay_Read(ReplayLog, &Record)) {
+        if (!bReplayFast) {
+            Application_WaitUntil(Start + Record.Timestamp);
+        }
+
+        if (Record.Type != REPLAY_RECORD_FRAME) {
+            if (Input_GetReplayEvent(&Record, &Event)) {
+                Input_HandleEvent(&Event);
+            }
+            continue;
+        }
+
+        // Live input is ignored, only closing the window ends the replay early.
+        while (SDL_PollEvent(&Event)) {
+            if (Event.type == SDL_QUIT) {
+                bShutdownRequested = True;
+            }
+        }
 
-    if (DeltaTime <= 0.0f) {
-        DeltaTime = 0;
+        // Events of the frame were all handled before it, its snapshot takes every one of them as recorded.
+        const U64 FrameStart = Clock_GetNanoseconds();
+        Time_Tick();
+        Application_Tick(Record.DeltaTime);
+        const U64 FrameEnd = Clock_GetNanoseconds();
+        Replay_AddFrame(ReplayLog, FrameEnd - FrameStart, FrameEnd - Start);
     }
-    
-    Render_Tick();
 
-    Application_AdvanceGameStep();
+    FReplayStats Stats;
+    Replay_GetStats(ReplayLog, &Stats);
+    printf("Replayed %u frames in %.3f s, recorded in %.3f s\n", Stats.Frames, (F64)Stats.ReplayNanoseconds / 1e9,
+           (F64)Stats.RecordedNanoseconds / 1e9);
+    printf("Frame time: min %.3f ms, mean %.3f ms, deviation %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+           (F64)Stats.MinNanoseconds / 1e6, Stats.MeanNanoseconds / 1e6, Stats.DeviationNanoseconds / 1e6, (F64)Stats.P50Nanoseconds / 1e6,
+           (F64)Stats.P90Nanoseconds / 1e6, (F64)Stats.P99Nanoseconds / 1e6, (F64)Stats.MaxNanoseconds / 1e6);
 }
 
-void Application_HandleEvent(const SDL_Event Event) {
-    switch (Event.user.code) {
-    case EVENT_RUN_GAME_LOOP:
-        Application_Tick();
+void Application_WaitUntil(const U64 Deadline) {
+    for (U64 Now = Clock_GetNanoseconds(); Now < Deadline; Now = Clock_GetNanoseconds()) {
+        // SDL sleeps in milliseconds and may oversleep, the last two are spun.
+        if (Deadline - Now > 2000000) {
+            SDL_Delay((U32)((Deadline - Now) / 1000000 - 2));
+        }
+    }
+}
+
+void Application_PrintUsage(const pStr Program) {
+    printf("Usage: %s [options]\n"
+           "  --record PATH   record the input and frames of the session to PATH\n"
+           "  --replay PATH   replay a recorded session and print its frame times\n"
+           "  --fast          replay as fast as frames complete instead of at the recorded speed\n"
+           "  --headless      render offscreen without a window, on EGL\n"
+           "  --checksum      render headless and print the checksum of the last frame on exit\n"
+           "  --atlas         sample chunk materials from the texture atlas instead of the texture array\n"
+           "  --no-detail     leave the material texture out of the chunk shader\n"
+           "  --no-fog        leave the distance fog out of the chunk shader\n"
+           "  --smudge        blend chunk materials into the materials across the face edges\n"
+           "  --rim           add the view-dependent effects of the reflective and polished materials\n"
+           "  --faces         draw chunks from face records pulled by the vertex shader instead of indexed meshes\n"
+           "  --text-size PX  draw the HUD text at PX pixels per em\n"
+           "  --single-thread render each frame on the main thread instead of a render thread, for debugging\n",
+           Program);
+}
+
+void Application_HandleWindowEvent(const SDL_WindowEvent* Event) {
+    switch (Event->event) {
+    case SDL_WINDOWEVENT_MINIMIZED:
+    case SDL_WINDOWEVENT_FOCUS_LOST:
+        Pace_SetIdle(True);
+        break;
+
+    case SDL_WINDOWEVENT_RESTORED:
+    case SDL_WINDOWEVENT_FOCUS_GAINED:
+        Pace_SetIdle(False);
         break;
 
     default:
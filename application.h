@@ -1,6 +1,9 @@
 ﻿#pragma once
 #include "typedefs.h"
 
+/** Reads the command line options, printing the usage when they are invalid. Returns False then. */
+Bool Application_ParseOptions(int ArgumentCount, char* Arguments[]);
+
 /** Handles the application initialization and startup. */
 Bool Application_Initialize();
 
@@ -0,0 +1,92 @@
+#version 430 core
+
+// Vertex pulling variant of vs.glsl, sharing its outputs and fs.glsl. Each face is one 32-bit record of the section
+// storage buffer, see MESHER_PACK_FACE, expanded into two triangles from gl_VertexID without vertex or index buffers.
+layout(std430, binding = 0) readonly buffer Faces {
+    uint faces[];
+};
+
+// Output data ; will be interpolated for each fragment.
+out vec3 norm;
+out vec3 pos;
+out vec3 eyepos;
+out vec3 tint;
+out vec2 uv;
+// Material layer the mesher picked for the face.
+flat out float layer;
+#if defined(SMUDGE) || defined(RIM)
+out vec2 faceUv;
+#endif
+#ifdef SMUDGE
+flat out vec4 smudgeLayers;
+#endif
+
+// Values that stay constant for the whole mesh.
+uniform mat4 MVP;
+uniform mat4 M;
+uniform vec3 eyePosition;
+// Origin of the drawn section within the chunk, face positions are relative to it.
+uniform vec3 sectionOrigin;
+
+// Palette of the mesher, see Mesher_GetFacePalette.
+uniform vec3 blockColors[7];
+uniform float blockMaterials[7];
+uniform float lightCurve[16];
+uniform float occlusionCurve[4];
+
+// Face corners for each EDirection, counter-clockwise when looking at the face from outside, as in mesher.c.
+const vec3 faceCorners[24] = vec3[](
+    vec3(1, 0, 0), vec3(1, 1, 0), vec3(1, 1, 1), vec3(1, 0, 1),
+    vec3(0, 0, 0), vec3(0, 0, 1), vec3(0, 1, 1), vec3(0, 1, 0),
+    vec3(0, 1, 0), vec3(0, 1, 1), vec3(1, 1, 1), vec3(1, 1, 0),
+    vec3(0, 0, 0), vec3(1, 0, 0), vec3(1, 0, 1), vec3(0, 0, 1),
+    vec3(0, 0, 1), vec3(1, 0, 1), vec3(1, 1, 1), vec3(0, 1, 1),
+    vec3(0, 0, 0), vec3(0, 1, 0), vec3(1, 1, 0), vec3(1, 0, 0));
+
+const vec3 faceNormals[6] = vec3[](vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 1, 0), vec3(0, -1, 0), vec3(0, 0, 1), vec3(0, 0, -1));
+
+const vec2 faceTexCoords[4] = vec2[](vec2(0, 0), vec2(1, 0), vec2(1, 1), vec2(0, 1));
+
+// Corners of the two triangles of a quad, rotated by one when the quad is split along its other diagonal.
+const uint quadCorners[6] = uint[](0u, 1u, 2u, 0u, 2u, 3u);
+
+void main() {
+
+    uint face = faces[gl_VertexID / 6];
+    vec3 block = vec3(face & 15u, (face >> 4) & 15u, (face >> 8) & 15u);
+    uint direction = (face >> 12) & 7u;
+    uint type = (face >> 15) & 31u;
+    uint occlusion = (face >> 20) & 255u;
+    uint light = face >> 28;
+
+    // Split along the brighter diagonal, as the mesher does for its indices.
+    uint first = (occlusion & 3u) + ((occlusion >> 4) & 3u) < ((occlusion >> 2) & 3u) + (occlusion >> 6) ? 1u : 0u;
+    uint corner = (first + quadCorners[gl_VertexID % 6]) & 3u;
+
+    vec3 position = sectionOrigin + block + faceCorners[direction * 4u + corner];
+
+    norm = (M*vec4(faceNormals[direction], 0)).xyz;
+    pos = (M*vec4(position, 1)).xyz;
+    eyepos = eyePosition;
+    // Block color lit by the block in front of the face and darkened by the occlusion of the corner.
+    tint = blockColors[type] * lightCurve[light] * occlusionCurve[(occlusion >> (corner * 2u)) & 3u];
+    layer = blockMaterials[type];
+
+    vec2 texCoord = faceTexCoords[corner];
+#if defined(SMUDGE) || defined(RIM)
+    faceUv = texCoord;
+#endif
+#ifdef SMUDGE
+    // Face records don't know their neighbours, the face smudges into its own material.
+    smudgeLayers = vec4(layer);
+#endif
+#ifdef MATERIAL_ARRAY
+    uv = texCoord;
+#else
+    // Tile of the material in the 8x8 atlas, inset by half a texel of its 64 px so filtering stays inside the tile.
+    uv = (vec2(mod(layer, 8.0), floor(layer / 8.0)) + 0.0078125 + texCoord * 0.984375) * 0.125;
+#endif
+
+    gl_Position =  MVP * vec4(position, 1);
+
+}
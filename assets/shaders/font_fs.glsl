@@ -1,12 +1,16 @@
 ﻿#version 330 core
 precision mediump float;
 in vec2 vTextureCoords;
+in vec4 vColor;
 out vec4 outColor;
 
+// Distance field of the glyphs, 0.5 on the outline, see font_atlas.h.
 uniform sampler2D sTexture;
-uniform vec3 textColor;
 
 void main () {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(sTexture, vTextureCoords).r);
-    outColor = vec4(textColor, 1.0) * sampled;
-}
\ No newline at end of file
+    // The edge is smoothed over one screen pixel whatever the scale of the quad, keeping text sharp at every size.
+    float distance = texture(sTexture, vTextureCoords).r;
+    float width = max(fwidth(distance) * 0.5, 1e-4);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    outColor = vec4(vColor.rgb, vColor.a * alpha);
+}
@@ -1,10 +1,15 @@
 ﻿#version 330 core
 layout (location = 0) in vec2 inPosition;
 layout (location = 1) in vec2 inTextureCoord;
+layout (location = 2) in vec4 inColor;
 out vec2 vTextureCoords;
-uniform mat4 transform;
+out vec4 vColor;
+
+/** Size of the framebuffer in pixels, positions are in pixels from its top left corner. */
+uniform vec2 screenSize;
 
 void main() {
-    gl_Position = transform * vec4(inPosition, 0.0, 1.0);
+    gl_Position = vec4(inPosition / screenSize * vec2(2.0, -2.0) + vec2(-1.0, 1.0), 0.0, 1.0);
     vTextureCoords = inTextureCoord;
-}
\ No newline at end of file
+    vColor = inColor;
+}
@@ -1,99 +1,88 @@
 #version 330 core
 
+// Variants are compiled in with defines, see Render_LoadProgram. MATERIAL_ARRAY samples the material layer of a
+// texture array instead of the atlas tile, DETAIL modulates the block color by the material and FOG fades distant faces.
+// With DETAIL, SMUDGE blends the material into the materials across the face edges and RIM adds the view-dependent
+// effects of the reflective and polished materials.
+
 // Interpolated values from the vertex shaders
 in vec3 norm;
 in vec3 pos;
 in vec3 eyepos;
-//Tex format: 4 smudge texNrs + texNr,U,V
-in vec4 tex1;
-in vec3 tex4;
+in vec3 tint;
+in vec2 uv;
+flat in float layer;
+#if defined(SMUDGE) || defined(RIM)
+// Position on the face.
+in vec2 faceUv;
+#endif
+#ifdef SMUDGE
+// Material layers across the -u, +u, -v and +v edges of the face.
+flat in vec4 smudgeLayers;
+#endif
 
 // Output data
 out vec3 color;
 
 // Values that stay constant for the whole mesh.
-uniform sampler2D texture;
+#ifdef MATERIAL_ARRAY
+uniform sampler2DArray materials;
+#else
+uniform sampler2D materials;
+#endif
+
+// Samples a material layer at a position on the face.
+vec3 sampleMaterial(vec2 at, float materialLayer)
+{
+#ifdef MATERIAL_ARRAY
+    return texture(materials, vec3(at, materialLayer)).rgb;
+#else
+    return texture(materials, (vec2(mod(materialLayer, 8.0), floor(materialLayer / 8.0)) + 0.0078125 + at * 0.984375) * 0.125).rgb;
+#endif
+}
 
 void main()
 {
 
-    //Jod, main texture
-    float grad = abs(1.0-tex4.y-tex4.z);
-    bool odd = tex4.y+tex4.z > 1.0;
-    float shft = 0.125*round(tex4.x/grad);
-    float maintx = shft;
-
-    float def = 0.002 + 0.121*tex4.y;
-    float def2 = 0.002 + 0.121*tex4.z;
-
-    vec2 texcrd;
-    texcrd.x = def + shft;
-    texcrd.y = def2 + 0.125*floor(shft);
-
+    // The light of the face comes baked into the vertex colors, faces facing up are brightest so block edges stay readable.
     vec3 N = normalize(norm);
-    vec3 EyeDir = normalize(eyepos - pos);
-    float NdotV = clamp(dot(EyeDir, N), 0, 1);
-
-    if (shft == 0.75)
-    {
-        vec2 ArcExy; ArcExy.x = EyeDir.x; ArcExy.y = EyeDir.y;
-        vec2 ArcEyz; ArcEyz.x = EyeDir.y; ArcEyz.y = EyeDir.z;
-        vec2 ArcNxy; ArcNxy.x = N.x; ArcNxy.y = N.y;
-        vec2 ArcNyz; ArcNyz.x = N.y; ArcNyz.y = N.z;
-        normalize(ArcExy); normalize(ArcEyz); normalize(ArcNxy); normalize(ArcNyz);
-        texcrd.x = 0.001 + 0.123*(0.5 + mod(asin(ArcExy.x) - asin(ArcNxy.x), 1)*0.5) + shft;
-        texcrd.y = 0.001 + 0.123*(0.5 + mod(asin(ArcEyz.x) - asin(ArcNyz.x), 1)*0.5);
-    }
-
-    vec3 color1 = texture2D(texture, texcrd).rgb;
-    float edge;
-    if (shft == 0.25)
-    {
-        edge = clamp(pow(NdotV, 15), 0.0, 1.0);
-        if (edge > 0.8) color1 *= (1 + edge*0.5);
-    }
-
+    float shade = 0.8 + 0.2*N.y - 0.1*abs(N.z);
+    color = tint*shade;
 
-    //Jod, smudge textures
-
-    def = 0.125 - def;
-    def2 = 0.125 - def2;
-
-    float modo;
-    float modn;
-    if (odd)
-    {
-        modo = 1.0-tex4.z;
-        modn = 1.0-tex4.y;
-    }
-    else
-    {
-        modo = tex4.y;
-        modn = tex4.z;
-    }
-
-    int tcount = 0;
-    shft = 0.125*round(tex1.z/modo); if (shft > 0) tcount++; if ((shft == 0.75)&&(shft != maintx)) shft=0.625;
-    if (shft != 0.75){ texcrd.x = def + shft; texcrd.y = def2 + 0.125*floor(shft); }
-    vec3 color2 = texture2D(texture, texcrd).rgb;
-    shft = 0.125*round(tex1.w/modo); if (shft > 0) tcount++; if ((shft == 0.75)&&(shft != maintx)) shft=0.625;
-    if (shft != 0.75){ texcrd.x = def + shft; texcrd.y = def2 + 0.125*floor(shft); }
-    color2 += texture2D(texture, texcrd).rgb;
-
-    if (tcount > 0) color2/=tcount;
-
-    tcount=0;
-    shft = 0.125*round(tex1.x/modn); if (shft > 0) tcount++; if ((shft == 0.75)&&(shft != maintx)) shft=0.625;
-    if (shft != 0.75){ texcrd.x = def + shft; texcrd.y = def2 + 0.125*floor(shft); }
-    vec3 color3 = texture2D(texture, texcrd).rgb;
-    shft = 0.125*round(tex1.y/modn); if (shft > 0) tcount++; if ((shft == 0.75)&&(shft != maintx)) shft=0.625;
-    if (shft != 0.75){ texcrd.x = def + shft; texcrd.y = def2 + 0.125*floor(shft); }
-    color3 += texture2D(texture, texcrd).rgb;
-
-    if (tcount > 0) color3/=tcount;
-
-    //Jod, output color
-    edge = 1.0-NdotV;
-    color = clamp((color1*grad + color2*modo + color3*modn)*(1.0-edge*0.5), 0, 1);
+#ifdef DETAIL
+#ifdef RIM
+    vec3 EyeDir = normalize(eyepos - pos);
 
-}
\ No newline at end of file
+    // The reflective material of tile 6 is looked up along the view direction instead of the face.
+    vec2 rimUv = 0.5 + mod(asin(EyeDir.xy) - asin(N.xy), 1.0)*0.5;
+    vec3 material = sampleMaterial(layer == 6.0 ? rimUv : faceUv, layer);
+
+    // The polished material of tile 2 glints when looked at head on.
+    float edge = clamp(pow(clamp(dot(EyeDir, N), 0.0, 1.0), 15.0), 0.0, 1.0);
+    if (layer == 2.0 && edge > 0.8) material *= 1.0 + edge*0.5;
+#elif defined(MATERIAL_ARRAY)
+    vec3 material = texture(materials, vec3(uv, layer)).rgb;
+#else
+    vec3 material = texture(materials, uv).rgb;
+#endif
+
+#ifdef SMUDGE
+    // Towards its edges the material smudges into the materials across them. The neighbour is sampled mirrored, so
+    // both faces blend the same texels half and half at the shared edge.
+    vec2 weights = 0.5*smoothstep(0.5, 1.0, abs(faceUv - 0.5)*2.0);
+    vec3 acrossU = sampleMaterial(vec2(1.0 - faceUv.x, faceUv.y), faceUv.x < 0.5 ? smudgeLayers.x : smudgeLayers.y);
+    vec3 acrossV = sampleMaterial(vec2(faceUv.x, 1.0 - faceUv.y), faceUv.y < 0.5 ? smudgeLayers.z : smudgeLayers.w);
+    material = material*(1.0 - weights.x - weights.y) + acrossU*weights.x + acrossV*weights.y;
+#endif
+
+    // Detail of the material, kept faint over the block color.
+    color *= 0.85 + 0.3*dot(material, vec3(0.3333));
+#endif
+
+#ifdef FOG
+    // Distant faces fade into the clear color.
+    float fog = clamp((length(eyepos - pos) - 96.0) / 64.0, 0.0, 1.0);
+    color = mix(color, vec3(0.039, 0.035, 0.314), fog);
+#endif
+
+}
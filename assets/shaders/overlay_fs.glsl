@@ -0,0 +1,7 @@
+#version 330 core
+in vec4 vColor;
+out vec4 outColor;
+
+void main() {
+    outColor = vColor;
+}
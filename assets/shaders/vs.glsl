@@ -1,17 +1,25 @@
 #version 330 core
 
-// Input vertex data, different for all executions of this shader.
+// Input vertex data, as laid out by Shape_Buffer.
 layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 normal;
-layout(location = 2) in vec4 intex1;
-layout(location = 3) in vec3 intex4;
+layout(location = 1) in vec3 vertexColor;
+layout(location = 2) in vec4 texCoord;
+layout(location = 3) in vec3 normal;
 
 // Output data ; will be interpolated for each fragment.
 out vec3 norm;
 out vec3 pos;
 out vec3 eyepos;
-out vec4 tex1;
-out vec3 tex4;
+out vec3 tint;
+out vec2 uv;
+// Material layer the mesher picked for the face.
+flat out float layer;
+#if defined(SMUDGE) || defined(RIM)
+out vec2 faceUv;
+#endif
+#ifdef SMUDGE
+flat out vec4 smudgeLayers;
+#endif
 
 // Values that stay constant for the whole mesh.
 uniform mat4 MVP;
@@ -23,10 +31,25 @@ void main() {
     norm = (M*vec4(normal, 0)).xyz;
     pos = (M*vec4(position, 1)).xyz;
     eyepos = eyePosition;
-    tex1 = intex1;
-    tex4 = intex4;
+    // Block color with the light of the face baked in by the mesher.
+    tint = vertexColor;
+    layer = texCoord.z;
+#if defined(SMUDGE) || defined(RIM)
+    faceUv = texCoord.xy;
+#endif
+#ifdef SMUDGE
+    // Layers across the -u, +u, -v and +v edges, packed 6 bits each by the mesher.
+    smudgeLayers = mod(floor(texCoord.w / vec4(1.0, 64.0, 4096.0, 262144.0)), 64.0);
+#endif
+
+#ifdef MATERIAL_ARRAY
+    uv = texCoord.xy;
+#else
+    // Tile of the material in the 8x8 atlas, inset by half a texel of its 64 px so filtering stays inside the tile.
+    uv = (vec2(mod(layer, 8.0), floor(layer / 8.0)) + 0.0078125 + texCoord.xy * 0.984375) * 0.125;
+#endif
 
     // Output position of the vertex, in clip space : MVP * position
     gl_Position =  MVP * vec4(position, 1);
 
-}
\ No newline at end of file
+}
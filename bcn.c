@@ -0,0 +1,412 @@
+#include "bcn.h"
+
+#include <math.h>
+#include <string.h>
+
+#pragma region Settings
+/** Least squares refinements of the color endpoints, each one only kept if it lowers the error. */
+#define BCN_REFINE_ITERATIONS 2
+/** Power iterations finding the principal axis of the block colors. */
+#define BCN_AXIS_ITERATIONS 8
+#pragma endregion
+
+#pragma region Private Function Declarations
+/** Quantizes a color of 0-255 channels to 5:6:5 bits. */
+static inline U16 Bcn_PackColor(const F32* Color) {
+    I32 Channels[3];
+    static const F32 Scales[3] = {31.f / 255.f, 63.f / 255.f, 31.f / 255.f};
+    static const I32 Limits[3] = {31, 63, 31};
+    for (U32 Channel = 0; Channel < 3; Channel++) {
+        Channels[Channel] = (I32)(Color[Channel] * Scales[Channel] + 0.5f);
+        Channels[Channel] = Channels[Channel] < 0 ? 0 : Channels[Channel] > Limits[Channel] ? Limits[Channel] : Channels[Channel];
+    }
+
+    return (U16)(Channels[0] << 11 | Channels[1] << 5 | Channels[2]);
+}
+
+/** Expands a 5:6:5 color to 8 bits per channel the way the hardware does. */
+static inline void Bcn_UnpackColor(const U16 Color, I32* OutColor) {
+    const I32 Red = Color >> 11 & 31, Green = Color >> 5 & 63, Blue = Color & 31;
+    OutColor[0] = Red << 3 | Red >> 2;
+    OutColor[1] = Green << 2 | Green >> 4;
+    OutColor[2] = Blue << 3 | Blue >> 2;
+}
+
+/** Writes the four color palette of the endpoints, three colors and black if the endpoints ask for the DXT1 alpha mode. */
+static void Bcn_GetPalette(U16 Color0, U16 Color1, Bool bAlphaMode, I32 OutPalette[4][3]);
+
+/** Picks the closest palette entry for every texel. Returns the squared error. */
+static U32 Bcn_FitIndices(const U8* Texels, U16 Color0, U16 Color1, U32* OutIndices);
+
+/** Encodes the color part of a block in the four color mode. */
+static void Bcn_EncodeColor(const U8* Texels, U8* OutBlock);
+
+static void Bcn_EncodeAlphaDxt3(const U8* Texels, U8* OutBlock);
+
+static void Bcn_EncodeAlphaDxt5(const U8* Texels, U8* OutBlock);
+
+/** Writes the eight alpha palette of the DXT5 endpoints, six interpolated values with 0 and 255 when Alpha0 <= Alpha1. */
+static void Bcn_GetAlphaPalette(U32 Alpha0, U32 Alpha1, U32* OutPalette);
+
+/** Picks the closest alpha palette entry for every texel. Returns the squared error. */
+static U32 Bcn_FitAlpha(const U8* Texels, U32 Alpha0, U32 Alpha1, U64* OutIndices);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Bcn_EncodeBlock(const EDdsFormat Format, const U8* Texels, U8* OutBlock) {
+    switch (Format) {
+    case DDS_FORMAT_DXT1:
+        Bcn_EncodeColor(Texels, OutBlock);
+        break;
+    case DDS_FORMAT_DXT3:
+        Bcn_EncodeAlphaDxt3(Texels, OutBlock);
+        Bcn_EncodeColor(Texels, OutBlock + 8);
+        break;
+    case DDS_FORMAT_DXT5:
+        Bcn_EncodeAlphaDxt5(Texels, OutBlock);
+        Bcn_EncodeColor(Texels, OutBlock + 8);
+        break;
+    default:
+        break;
+    }
+}
+
+void Bcn_DecodeBlock(const EDdsFormat Format, const U8* Block, U8* OutTexels) {
+    const U8* ColorBlock = Format == DDS_FORMAT_DXT1 ? Block : Block + 8;
+    const U16 Color0 = (U16)(ColorBlock[0] | ColorBlock[1] << 8);
+    const U16 Color1 = (U16)(ColorBlock[2] | ColorBlock[3] << 8);
+    const U32 Indices = (U32)ColorBlock[4] | (U32)ColorBlock[5] << 8 | (U32)ColorBlock[6] << 16 | (U32)ColorBlock[7] << 24;
+
+    // Only DXT1 has the alpha mode, the other formats always interpolate four colors.
+    const Bool bAlphaMode = Format == DDS_FORMAT_DXT1 && Color0 <= Color1;
+    I32 Palette[4][3];
+    Bcn_GetPalette(Color0, Color1, bAlphaMode, Palette);
+
+    U64 AlphaBits = 0;
+    U32 AlphaPalette[8];
+    if (Format != DDS_FORMAT_DXT1) {
+        for (U32 Byte = Format == DDS_FORMAT_DXT3 ? 0 : 2; Byte < 8; Byte++) {
+            AlphaBits |= (U64)Block[Byte] << (Format == DDS_FORMAT_DXT3 ? Byte : Byte - 2) * 8;
+        }
+        if (Format == DDS_FORMAT_DXT5) {
+            Bcn_GetAlphaPalette(Block[0], Block[1], AlphaPalette);
+        }
+    }
+
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const U32 Index = Indices >> Texel * 2 & 3;
+        U8* OutTexel = &OutTexels[Texel * 4];
+        OutTexel[0] = (U8)Palette[Index][0];
+        OutTexel[1] = (U8)Palette[Index][1];
+        OutTexel[2] = (U8)Palette[Index][2];
+
+        switch (Format) {
+        case DDS_FORMAT_DXT3:
+            OutTexel[3] = (U8)((AlphaBits >> Texel * 4 & 15) * 17);
+            break;
+        case DDS_FORMAT_DXT5:
+            OutTexel[3] = (U8)AlphaPalette[AlphaBits >> Texel * 3 & 7];
+            break;
+        default:
+            OutTexel[3] = bAlphaMode && Index == 3 ? 0 : 255;
+            break;
+        }
+    }
+}
+
+U32 Bcn_EncodeImage(const FImage* Image, const EDdsFormat Format, U8* OutBlocks) {
+    const U32 BlockSize = Dds_GetBlockSize(Format);
+    const U32 BlockColumns = (Image->Width + 3) / 4, BlockRows = (Image->Height + 3) / 4;
+
+    U8 Texels[16 * 4];
+    U8* Block = OutBlocks;
+    for (U32 BlockRow = 0; BlockRow < BlockRows; BlockRow++) {
+        for (U32 BlockColumn = 0; BlockColumn < BlockColumns; BlockColumn++) {
+            for (U32 Texel = 0; Texel < 16; Texel++) {
+                U32 X = BlockColumn * 4 + Texel % 4, Y = BlockRow * 4 + Texel / 4;
+                X = X < Image->Width ? X : Image->Width - 1;
+                Y = Y < Image->Height ? Y : Image->Height - 1;
+                memcpy(&Texels[Texel * 4], &Image->Pixels[((size_t)Y * Image->Width + X) * 4], 4);
+            }
+
+            Bcn_EncodeBlock(Format, Texels, Block);
+            Block += BlockSize;
+        }
+    }
+
+    return (U32)(Block - OutBlocks);
+}
+
+Bool Bcn_DecodeImage(const U8* Blocks, const EDdsFormat Format, const U32 Width, const U32 Height, FImage* OutImage) {
+    const U32 BlockSize = Dds_GetBlockSize(Format);
+    if (BlockSize == 0 || !Image_Create(Width, Height, OutImage)) {
+        return False;
+    }
+
+    const U32 BlockColumns = (Width + 3) / 4, BlockRows = (Height + 3) / 4;
+    U8 Texels[16 * 4];
+    for (U32 BlockRow = 0; BlockRow < BlockRows; BlockRow++) {
+        for (U32 BlockColumn = 0; BlockColumn < BlockColumns; BlockColumn++) {
+            Bcn_DecodeBlock(Format, Blocks + ((size_t)BlockRow * BlockColumns + BlockColumn) * BlockSize, Texels);
+
+            for (U32 Texel = 0; Texel < 16; Texel++) {
+                const U32 X = BlockColumn * 4 + Texel % 4, Y = BlockRow * 4 + Texel / 4;
+                if (X < Width && Y < Height) {
+                    memcpy(&OutImage->Pixels[((size_t)Y * Width + X) * 4], &Texels[Texel * 4], 4);
+                }
+            }
+        }
+    }
+
+    return True;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void Bcn_GetPalette(const U16 Color0, const U16 Color1, const Bool bAlphaMode, I32 OutPalette[4][3]) {
+    Bcn_UnpackColor(Color0, OutPalette[0]);
+    Bcn_UnpackColor(Color1, OutPalette[1]);
+    for (U32 Channel = 0; Channel < 3; Channel++) {
+        if (bAlphaMode) {
+            OutPalette[2][Channel] = (OutPalette[0][Channel] + OutPalette[1][Channel]) / 2;
+            OutPalette[3][Channel] = 0;
+        } else {
+            OutPalette[2][Channel] = (2 * OutPalette[0][Channel] + OutPalette[1][Channel]) / 3;
+            OutPalette[3][Channel] = (OutPalette[0][Channel] + 2 * OutPalette[1][Channel]) / 3;
+        }
+    }
+}
+
+U32 Bcn_FitIndices(const U8* Texels, const U16 Color0, const U16 Color1, U32* OutIndices) {
+    I32 Palette[4][3];
+    Bcn_GetPalette(Color0, Color1, False, Palette);
+
+    U32 Indices = 0, Error = 0;
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const U8* Color = &Texels[Texel * 4];
+        U32 BestIndex = 0, BestError = 0xFFFFFFFF;
+        for (U32 Index = 0; Index < 4; Index++) {
+            const I32 Red = Color[0] - Palette[Index][0], Green = Color[1] - Palette[Index][1], Blue = Color[2] - Palette[Index][2];
+            const U32 IndexError = (U32)(Red * Red + Green * Green + Blue * Blue);
+            if (IndexError < BestError) {
+                BestError = IndexError;
+                BestIndex = Index;
+            }
+        }
+
+        Indices |= BestIndex << Texel * 2;
+        Error += BestError;
+    }
+
+    *OutIndices = Indices;
+    return Error;
+}
+
+void Bcn_EncodeColor(const U8* Texels, U8* OutBlock) {
+    F32 Mean[3] = {0.f, 0.f, 0.f};
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        for (U32 Channel = 0; Channel < 3; Channel++) {
+            Mean[Channel] += Texels[Texel * 4 + Channel] / 16.f;
+        }
+    }
+
+    // Covariance of the colors: RR, RG, RB, GG, GB, BB.
+    F32 Covariance[6] = {0.f};
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const F32 Red = Texels[Texel * 4] - Mean[0], Green = Texels[Texel * 4 + 1] - Mean[1], Blue = Texels[Texel * 4 + 2] - Mean[2];
+        Covariance[0] += Red * Red;
+        Covariance[1] += Red * Green;
+        Covariance[2] += Red * Blue;
+        Covariance[3] += Green * Green;
+        Covariance[4] += Green * Blue;
+        Covariance[5] += Blue * Blue;
+    }
+
+    // Power iteration from the luminance axis converges on the direction the colors spread along.
+    F32 Axis[3] = {0.299f, 0.587f, 0.114f};
+    for (U32 Iteration = 0; Iteration < BCN_AXIS_ITERATIONS; Iteration++) {
+        const F32 Next[3] = {
+            Covariance[0] * Axis[0] + Covariance[1] * Axis[1] + Covariance[2] * Axis[2],
+            Covariance[1] * Axis[0] + Covariance[3] * Axis[1] + Covariance[4] * Axis[2],
+            Covariance[2] * Axis[0] + Covariance[4] * Axis[1] + Covariance[5] * Axis[2],
+        };
+        const F32 Length = sqrtf(Next[0] * Next[0] + Next[1] * Next[1] + Next[2] * Next[2]);
+        if (Length < 1e-6f) {
+            break;
+        }
+        Axis[0] = Next[0] / Length;
+        Axis[1] = Next[1] / Length;
+        Axis[2] = Next[2] / Length;
+    }
+
+    F32 MinProjection = 0.f, MaxProjection = 0.f;
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const F32 Projection = (Texels[Texel * 4] - Mean[0]) * Axis[0] + (Texels[Texel * 4 + 1] - Mean[1]) * Axis[1] + (Texels[Texel * 4 + 2] - Mean[2]) * Axis[2];
+        MinProjection = Projection < MinProjection ? Projection : MinProjection;
+        MaxProjection = Projection > MaxProjection ? Projection : MaxProjection;
+    }
+
+    // Endpoints at the extremes pulled in by a sixteenth, the interpolated colors then cover the spread evenly.
+    const F32 Inset = (MaxProjection - MinProjection) / 16.f;
+    F32 Endpoints[2][3];
+    for (U32 Channel = 0; Channel < 3; Channel++) {
+        Endpoints[0][Channel] = Mean[Channel] + Axis[Channel] * (MaxProjection - Inset);
+        Endpoints[1][Channel] = Mean[Channel] + Axis[Channel] * (MinProjection + Inset);
+    }
+
+    U16 Color0 = Bcn_PackColor(Endpoints[0]), Color1 = Bcn_PackColor(Endpoints[1]);
+    if (Color0 < Color1) {
+        const U16 Swap = Color0;
+        Color0 = Color1;
+        Color1 = Swap;
+    }
+
+    U32 Indices = 0;
+    U32 Error = Color0 == Color1 ? 0 : Bcn_FitIndices(Texels, Color0, Color1, &Indices);
+
+    // Least squares endpoints for the chosen indices, weights of the first endpoint by index.
+    static const F32 Weights[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+    for (U32 Iteration = 0; Iteration < BCN_REFINE_ITERATIONS && Error > 0 && Color0 != Color1; Iteration++) {
+        F32 WeightSquares = 0.f, CrossWeights = 0.f, OtherSquares = 0.f;
+        F32 Weighted[2][3] = {{0.f}};
+        for (U32 Texel = 0; Texel < 16; Texel++) {
+            const F32 Weight = Weights[Indices >> Texel * 2 & 3];
+            WeightSquares += Weight * Weight;
+            CrossWeights += Weight * (1.f - Weight);
+            OtherSquares += (1.f - Weight) * (1.f - Weight);
+            for (U32 Channel = 0; Channel < 3; Channel++) {
+                Weighted[0][Channel] += Weight * Texels[Texel * 4 + Channel];
+                Weighted[1][Channel] += (1.f - Weight) * Texels[Texel * 4 + Channel];
+            }
+        }
+
+        const F32 Determinant = WeightSquares * OtherSquares - CrossWeights * CrossWeights;
+        if (fabsf(Determinant) < 1e-6f) {
+            break;
+        }
+
+        for (U32 Channel = 0; Channel < 3; Channel++) {
+            Endpoints[0][Channel] = (OtherSquares * Weighted[0][Channel] - CrossWeights * Weighted[1][Channel]) / Determinant;
+            Endpoints[1][Channel] = (WeightSquares * Weighted[1][Channel] - CrossWeights * Weighted[0][Channel]) / Determinant;
+        }
+
+        U16 Refined0 = Bcn_PackColor(Endpoints[0]), Refined1 = Bcn_PackColor(Endpoints[1]);
+        if (Refined0 < Refined1) {
+            const U16 Swap = Refined0;
+            Refined0 = Refined1;
+            Refined1 = Swap;
+        }
+        if (Refined0 == Refined1) {
+            break;
+        }
+
+        U32 RefinedIndices;
+        const U32 RefinedError = Bcn_FitIndices(Texels, Refined0, Refined1, &RefinedIndices);
+        if (RefinedError >= Error) {
+            break;
+        }
+
+        Color0 = Refined0;
+        Color1 = Refined1;
+        Indices = RefinedIndices;
+        Error = RefinedError;
+    }
+
+    // Equal endpoints would select the DXT1 alpha mode, every texel takes the first color instead.
+    if (Color0 == Color1) {
+        Indices = 0;
+    }
+
+    OutBlock[0] = (U8)Color0;
+    OutBlock[1] = (U8)(Color0 >> 8);
+    OutBlock[2] = (U8)Color1;
+    OutBlock[3] = (U8)(Color1 >> 8);
+    OutBlock[4] = (U8)Indices;
+    OutBlock[5] = (U8)(Indices >> 8);
+    OutBlock[6] = (U8)(Indices >> 16);
+    OutBlock[7] = (U8)(Indices >> 24);
+}
+
+void Bcn_EncodeAlphaDxt3(const U8* Texels, U8* OutBlock) {
+    memset(OutBlock, 0, 8);
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const U32 Alpha = (Texels[Texel * 4 + 3] + 8) / 17;
+        OutBlock[Texel / 2] |= (U8)(Alpha << Texel % 2 * 4);
+    }
+}
+
+void Bcn_EncodeAlphaDxt5(const U8* Texels, U8* OutBlock) {
+    U32 Min = 255, Max = 0, InnerMin = 255, InnerMax = 0;
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const U32 Alpha = Texels[Texel * 4 + 3];
+        Min = Alpha < Min ? Alpha : Min;
+        Max = Alpha > Max ? Alpha : Max;
+        if (Alpha != 0 && Alpha != 255) {
+            InnerMin = Alpha < InnerMin ? Alpha : InnerMin;
+            InnerMax = Alpha > InnerMax ? Alpha : InnerMax;
+        }
+    }
+
+    // Eight interpolated values between the extremes, or six between the values other than 0 and 255 plus those two.
+    U32 Alpha0 = Max, Alpha1 = Min;
+    U64 Indices = 0;
+    U32 Error = Bcn_FitAlpha(Texels, Alpha0, Alpha1, &Indices);
+    if (Error > 0 && Max > Min) {
+        const U32 Inner0 = InnerMin <= InnerMax ? InnerMin : 0, Inner1 = InnerMin <= InnerMax ? InnerMax : 0;
+        U64 InnerIndices;
+        const U32 InnerError = Bcn_FitAlpha(Texels, Inner0, Inner1, &InnerIndices);
+        if (InnerError < Error) {
+            Alpha0 = Inner0;
+            Alpha1 = Inner1;
+            Indices = InnerIndices;
+        }
+    }
+
+    OutBlock[0] = (U8)Alpha0;
+    OutBlock[1] = (U8)Alpha1;
+    for (U32 Byte = 0; Byte < 6; Byte++) {
+        OutBlock[2 + Byte] = (U8)(Indices >> Byte * 8);
+    }
+}
+
+void Bcn_GetAlphaPalette(const U32 Alpha0, const U32 Alpha1, U32* OutPalette) {
+    OutPalette[0] = Alpha0;
+    OutPalette[1] = Alpha1;
+    if (Alpha0 > Alpha1) {
+        for (U32 Index = 2; Index < 8; Index++) {
+            OutPalette[Index] = ((8 - Index) * Alpha0 + (Index - 1) * Alpha1) / 7;
+        }
+    } else {
+        for (U32 Index = 2; Index < 6; Index++) {
+            OutPalette[Index] = ((6 - Index) * Alpha0 + (Index - 1) * Alpha1) / 5;
+        }
+        OutPalette[6] = 0;
+        OutPalette[7] = 255;
+    }
+}
+
+U32 Bcn_FitAlpha(const U8* Texels, const U32 Alpha0, const U32 Alpha1, U64* OutIndices) {
+    U32 Palette[8];
+    Bcn_GetAlphaPalette(Alpha0, Alpha1, Palette);
+
+    U64 Indices = 0;
+    U32 Error = 0;
+    for (U32 Texel = 0; Texel < 16; Texel++) {
+        const I32 Alpha = Texels[Texel * 4 + 3];
+        U32 BestIndex = 0, BestError = 0xFFFFFFFF;
+        for (U32 Index = 0; Index < 8; Index++) {
+            const I32 Difference = Alpha - (I32)Palette[Index];
+            if ((U32)(Difference * Difference) < BestError) {
+                BestError = (U32)(Difference * Difference);
+                BestIndex = Index;
+            }
+        }
+
+        Indices |= (U64)BestIndex << Texel * 3;
+        Error += BestError;
+    }
+
+    *OutIndices = Indices;
+    return Error;
+}
+#pragma endregion
@@ -0,0 +1,22 @@
+#pragma once
+#include "typedefs.h"
+#include "dds.h"
+#include "image.h"
+
+/**
+ * Block compression of the DXT formats of dds.h. Colors are fit along the principal axis of each block and refined by
+ * least squares, DXT5 alpha tries both interpolation modes and keeps the closer one. DXT1 blocks always use the four
+ * color mode, images with transparency are meant for DXT5.
+ */
+
+/** Encodes 4x4 RGBA texels, the top row first, into a block of the format. */
+void Bcn_EncodeBlock(EDdsFormat Format, const U8* Texels, U8* OutBlock);
+
+/** Decodes a block of the format into 4x4 RGBA texels. */
+void Bcn_DecodeBlock(EDdsFormat Format, const U8* Block, U8* OutTexels);
+
+/** Encodes the image block by block, edge texels repeat into partial blocks. Returns the bytes written. */
+U32 Bcn_EncodeImage(const FImage* Image, EDdsFormat Format, U8* OutBlocks);
+
+/** Decodes a level of the format into a new image. Returns False on failure. */
+Bool Bcn_DecodeImage(const U8* Blocks, EDdsFormat Format, U32 Width, U32 Height, FImage* OutImage);
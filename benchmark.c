@@ -0,0 +1,358 @@
+#include "benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock.h"
+
+#define BENCHMARK_NAME_LENGTH 128
+#define BENCHMARK_LINE_LENGTH 1024
+
+/** Measured benchmark statistics. */
+typedef struct {
+    const FBenchmark* Benchmark;
+    U64 Work;
+    F64 MinNs;
+    F64 MedianNs;
+    F64 MeanNs;
+    F64 MaxNs;
+    F64 StdDevNs;
+    Bool bSkipped;
+} FBenchmarkResult;
+
+/** Baseline benchmark entry. */
+typedef struct {
+    char Name[BENCHMARK_NAME_LENGTH];
+    F64 MedianNs;
+} FBenchmarkBaseline;
+
+#pragma region Private Variables
+/** Sink for Benchmark_DoNotOptimize. */
+static const void* volatile BenchmarkSink;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static void Benchmark_PrintUsage(pStr Program);
+static int Benchmark_CompareTimes(const void* A, const void* B);
+static Bool Benchmark_Measure(const FBenchmark* Benchmark, const FBenchmarkOptions* Options, FBenchmarkResult* OutResult);
+static Bool Benchmark_WriteResults(const FBenchmarkResult* Results, U32 ResultCount, const FBenchmarkOptions* Options);
+static FBenchmarkBaseline* Benchmark_ReadBaseline(pStr Path, U32* OutCount);
+static Bool Benchmark_CompareBaseline(const FBenchmarkResult* Results, U32 ResultCount, const FBenchmarkOptions* Options, Bool* bOutRegressed);
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Benchmark_ParseOptions(const int ArgumentCount, char* Arguments[], FBenchmarkOptions* OutOptions) {
+    OutOptions->Repetitions = 10;
+    OutOptions->WarmUp = 2;
+    OutOptions->Filter = NULL;
+    OutOptions->OutputPath = NULL;
+    OutOptions->BaselinePath = NULL;
+    OutOptions->Threshold = 10.0;
+    OutOptions->bList = False;
+
+    for (int Index = 1; Index < ArgumentCount; Index++) {
+        const pStr Argument = Arguments[Index];
+        const Bool bHasValue = Index + 1 < ArgumentCount;
+
+        if (strcmp(Argument, "--repetitions") == 0 && bHasValue) {
+            OutOptions->Repetitions = (U32)strtoul(Arguments[++Index], NULL, 10);
+        } else if (strcmp(Argument, "--warmup") == 0 && bHasValue) {
+            OutOptions->WarmUp = (U32)strtoul(Arguments[++Index], NULL, 10);
+        } else if (strcmp(Argument, "--filter") == 0 && bHasValue) {
+            OutOptions->Filter = Arguments[++Index];
+        } else if (strcmp(Argument, "--output") == 0 && bHasValue) {
+            OutOptions->OutputPath = Arguments[++Index];
+        } else if (strcmp(Argument, "--baseline") == 0 && bHasValue) {
+            OutOptions->BaselinePath = Arguments[++Index];
+        } else if (strcmp(Argument, "--threshold") == 0 && bHasValue) {
+            OutOptions->Threshold = strtod(Arguments[++Index], NULL);
+        } else if (strcmp(Argument, "--list") == 0) {
+            OutOptions->bList = True;
+        } else {
+            Benchmark_PrintUsage(Arguments[0]);
+            return False;
+        }
+    }
+
+    if (OutOptions->Repetitions == 0) {
+        Benchmark_PrintUsage(Arguments[0]);
+        return False;
+    }
+
+    return True;
+}
+
+int Benchmark_RunAll(const FBenchmark* Benchmarks, const U32 BenchmarkCount, const FBenchmarkOptions* Options) {
+    if (Options->bList) {
+        for (U32 Index = 0; Index < BenchmarkCount; Index++) {
+            printf("%s\n", Benchmarks[Index].Name);
+        }
+        return 0;
+    }
+
+    FBenchmarkResult* Results = calloc(BenchmarkCount > 0 ? BenchmarkCount : 1, sizeof *Results);
+    U32 ResultCount = 0;
+    Bool bSkipped = False;
+
+    for (U32 Index = 0; Index < BenchmarkCount; Index++) {
+        const FBenchmark* Benchmark = &Benchmarks[Index];
+        if (Options->Filter != NULL && strstr(Benchmark->Name, Options->Filter) == NULL) {
+            continue;
+        }
+
+        fprintf(stderr, "Running %s...\n", Benchmark->Name);
+        if (!Benchmark_Measure(Benchmark, Options, &Results[ResultCount])) {
+            fprintf(stderr, "Skipped %s, setup failed\n", Benchmark->Name);
+            bSkipped = True;
+        }
+        ResultCount++;
+    }
+
+    int ExitCode = 0;
+    if (!Benchmark_WriteResults(Results, ResultCount, Options)) {
+        ExitCode = 2;
+    } else if (Options->BaselinePath != NULL) {
+        Bool bRegressed = False;
+        if (!Benchmark_CompareBaseline(Results, ResultCount, Options, &bRegressed)) {
+            ExitCode = 2;
+        } else if (bRegressed) {
+            ExitCode = 1;
+        }
+    }
+
+    // A benchmark that couldn't run fails the run, a missing result must not pass as an unchanged one.
+    if (ExitCode == 0 && bSkipped) {
+        ExitCode = 1;
+    }
+
+    free(Results);
+
+    return ExitCode;
+}
+
+U64 Benchmark_GetNanoseconds() {
+    return Clock_GetNanoseconds();
+}
+
+void Benchmark_DoNotOptimize(const void* Value) {
+    BenchmarkSink = Value;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void Benchmark_PrintUsage(const pStr Program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --repetitions N   measured repetitions per benchmark (default 10)\n"
+            "  --warmup N        unmeasured warm-up repetitions (default 2)\n"
+            "  --filter TEXT     run only benchmarks whose name contains TEXT\n"
+            "  --output PATH     write JSON results to PATH instead of stdout\n"
+            "  --baseline PATH   compare median times against a previous results file\n"
+            "  --threshold PCT   allowed median growth over the baseline in percent (default 10)\n"
+            "  --list            list benchmark names\n",
+            Program);
+}
+
+int Benchmark_CompareTimes(const void* A, const void* B) {
+    const U64 TimeA = *(const U64*)A;
+    const U64 TimeB = *(const U64*)B;
+    return TimeA < TimeB ? -1 : TimeA > TimeB ? 1 : 0;
+}
+
+Bool Benchmark_Measure(const FBenchmark* Benchmark, const FBenchmarkOptions* Options, FBenchmarkResult* OutResult) {
+    memset(OutResult, 0, sizeof *OutResult);
+    OutResult->Benchmark = Benchmark;
+
+    void* State = NULL;
+    if (Benchmark->Setup != NULL && !Benchmark->Setup(&State)) {
+        OutResult->bSkipped = True;
+        return False;
+    }
+
+    for (U32 Repetition = 0; Repetition < Options->WarmUp; Repetition++) {
+        Benchmark->Run(State);
+    }
+
+    U64* Times = malloc(Options->Repetitions * sizeof *Times);
+    for (U32 Repetition = 0; Repetition < Options->Repetitions; Repetition++) {
+        const U64 Start = Benchmark_GetNanoseconds();
+        OutResult->Work = Benchmark->Run(State);
+        Times[Repetition] = Benchmark_GetNanoseconds() - Start;
+    }
+
+    if (Benchmark->Teardown != NULL) {
+        Benchmark->Teardown(State);
+    }
+
+    qsort(Times, Options->Repetitions, sizeof *Times, Benchmark_CompareTimes);
+
+    const U32 Count = Options->Repetitions;
+    F64 Sum = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        Sum += (F64)Times[Index];
+    }
+
+    OutResult->MinNs = (F64)Times[0];
+    OutResult->MaxNs = (F64)Times[Count - 1];
+    OutResult->MedianNs = Count % 2 ? (F64)Times[Count / 2] : ((F64)Times[Count / 2 - 1] + (F64)Times[Count / 2]) / 2.0;
+    OutResult->MeanNs = Sum / Count;
+
+    F64 Variance = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        const F64 Delta = (F64)Times[Index] - OutResult->MeanNs;
+        Variance += Delta * Delta;
+    }
+    OutResult->StdDevNs = Count > 1 ? sqrt(Variance / (Count - 1)) : 0.0;
+
+    free(Times);
+
+    return True;
+}
+
+Bool Benchmark_WriteResults(const FBenchmarkResult* Results, const U32 ResultCount, const FBenchmarkOptions* Options) {
+    FILE* pFile = stdout;
+    if (Options->OutputPath != NULL) {
+        pFile = fopen(Options->OutputPath, "w");
+        if (pFile == NULL) {
+            fprintf(stderr, "Unable to open results file %s\n", Options->OutputPath);
+            return False;
+        }
+    }
+
+    // One benchmark per line, baselines are read back line by line.
+    fprintf(pFile, "{\n  \"repetitions\": %u,\n  \"warmup\": %u,\n  \"benchmarks\": [\n", Options->Repetitions, Options->WarmUp);
+
+    U32 Written = 0;
+    for (U32 Index = 0; Index < ResultCount; Index++) {
+        const FBenchmarkResult* Result = &Results[Index];
+        if (Result->bSkipped) {
+            continue;
+        }
+
+        const F64 WorkPerSecond = Result->MedianNs > 0.0 ? (F64)Result->Work * 1e9 / Result->MedianNs : 0.0;
+        fprintf(pFile,
+                "%s    {\"name\": \"%s\", \"unit\": \"%s\", \"work\": %llu, \"min_ns\": %.0f, \"median_ns\": %.0f, \"mean_ns\": %.0f, \"max_ns\": %.0f, "
+                "\"stddev_ns\": %.0f, \"work_per_second\": %.2f",
+                Written > 0 ? ",\n" : "", Result->Benchmark->Name, Result->Benchmark->Unit, (unsigned long long)Result->Work, Result->MinNs, Result->MedianNs,
+                Result->MeanNs, Result->MaxNs, Result->StdDevNs, WorkPerSecond);
+        if (Result->Benchmark->ItemUnit != NULL && Result->Benchmark->ItemSize > 0) {
+            fprintf(pFile, ", \"item_unit\": \"%s\", \"items_per_second\": %.2f", Result->Benchmark->ItemUnit,
+                    WorkPerSecond / (F64)Result->Benchmark->ItemSize);
+        }
+        fprintf(pFile, "}");
+        Written++;
+    }
+
+    fprintf(pFile, "\n  ]\n}\n");
+
+    if (pFile != stdout) {
+        fclose(pFile);
+    }
+
+    return True;
+}
+
+FBenchmarkBaseline* Benchmark_ReadBaseline(const pStr Path, U32* OutCount) {
+    FILE* pFile = fopen(Path, "r");
+    if (pFile == NULL) {
+        fprintf(stderr, "Unable to open baseline file %s\n", Path);
+        return NULL;
+    }
+
+    FBenchmarkBaseline* Baselines = NULL;
+    U32 Count = 0, Capacity = 0;
+    char Line[BENCHMARK_LINE_LENGTH];
+
+    while (fgets(Line, sizeof Line, pFile) != NULL) {
+        const char* Name = strstr(Line, "\"name\": \"");
+        const char* Median = strstr(Line, "\"median_ns\": ");
+        if (Name == NULL || Median == NULL) {
+            continue;
+        }
+
+        Name += strlen("\"name\": \"");
+        const char* NameEnd = strchr(Name, '"');
+        if (NameEnd == NULL || NameEnd - Name >= BENCHMARK_NAME_LENGTH) {
+            continue;
+        }
+
+        if (Count == Capacity) {
+            Capacity = Capacity ? Capacity * 2 : 16;
+            Baselines = realloc(Baselines, Capacity * sizeof *Baselines);
+        }
+
+        FBenchmarkBaseline* Baseline = &Baselines[Count++];
+        memcpy(Baseline->Name, Name, (size_t)(NameEnd - Name));
+        Baseline->Name[NameEnd - Name] = '\0';
+        Baseline->MedianNs = strtod(Median + strlen("\"median_ns\": "), NULL);
+    }
+
+    fclose(pFile);
+
+    *OutCount = Count;
+    return Baselines != NULL ? Baselines : calloc(1, sizeof *Baselines);
+}
+
+Bool Benchmark_CompareBaseline(const FBenchmarkResult* Results, const U32 ResultCount, const FBenchmarkOptions* Options, Bool* bOutRegressed) {
+    U32 BaselineCount;
+    FBenchmarkBaseline* Baselines = Benchmark_ReadBaseline(Options->BaselinePath, &BaselineCount);
+    if (Baselines == NULL) {
+        return False;
+    }
+
+    *bOutRegressed = False;
+    fprintf(stderr, "\n%-32s %14s %14s %9s\n", "Benchmark", "Baseline ns", "Current ns", "Delta");
+
+    for (U32 Index = 0; Index < ResultCount; Index++) {
+        const FBenchmarkResult* Result = &Results[Index];
+        if (Result->bSkipped) {
+            continue;
+        }
+
+        const FBenchmarkBaseline* Baseline = NULL;
+        for (U32 BaselineIndex = 0; BaselineIndex < BaselineCount; BaselineIndex++) {
+            if (strcmp(Baselines[BaselineIndex].Name, Result->Benchmark->Name) == 0) {
+                Baseline = &Baselines[BaselineIndex];
+                break;
+            }
+        }
+
+        if (Baseline == NULL || Baseline->MedianNs <= 0.0) {
+            fprintf(stderr, "%-32s %14s %14.0f %9s\n", Result->Benchmark->Name, "-", Result->MedianNs, "new");
+            continue;
+        }
+
+        const F64 Delta = (Result->MedianNs - Baseline->MedianNs) / Baseline->MedianNs * 100.0;
+        const Bool bRegressed = Delta > Options->Threshold;
+        fprintf(stderr, "%-32s %14.0f %14.0f %+8.1f%%%s\n", Result->Benchmark->Name, Baseline->MedianNs, Result->MedianNs, Delta, bRegressed ? " REGRESSED" : "");
+
+        if (bRegressed) {
+            *bOutRegressed = True;
+        }
+    }
+
+    // Selected baseline entries without a measured result are benchmarks that were skipped, renamed or removed.
+    for (U32 BaselineIndex = 0; BaselineIndex < BaselineCount; BaselineIndex++) {
+        const FBenchmarkBaseline* Baseline = &Baselines[BaselineIndex];
+        if (Options->Filter != NULL && strstr(Baseline->Name, Options->Filter) == NULL) {
+            continue;
+        }
+
+        Bool bMeasured = False;
+        for (U32 Index = 0; Index < ResultCount && !bMeasured; Index++) {
+            bMeasured = !Results[Index].bSkipped && strcmp(Results[Index].Benchmark->Name, Baseline->Name) == 0;
+        }
+
+        if (!bMeasured) {
+            fprintf(stderr, "%-32s %14.0f %14s %9s MISSING\n", Baseline->Name, Baseline->MedianNs, "-", "-");
+            *bOutRegressed = True;
+        }
+    }
+
+    free(Baselines);
+
+    return True;
+}
+#pragma endregion
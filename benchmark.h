@@ -0,0 +1,53 @@
+#pragma once
+#include "typedefs.h"
+
+/** Benchmark case. Setup and Teardown run outside of the measured time. */
+typedef struct {
+    /** Unique benchmark name, baseline entries are matched by it. */
+    pStr Name;
+    /** Unit of the work amount returned by Run, e.g. "bytes" or "blocks". */
+    pStr Unit;
+    /** Prepares the benchmark state, optional. Returns False to skip the benchmark. */
+    Bool (*Setup)(void** OutState);
+    /** Runs a single measured repetition, returns the amount of processed work in units. */
+    U64 (*Run)(void* State);
+    /** Frees the benchmark state, optional. */
+    void (*Teardown)(void* State);
+    /** Secondary rate unit, e.g. "chunks" for a benchmark counting bytes, optional. */
+    pStr ItemUnit;
+    /** Work units per item of the secondary unit. */
+    U64 ItemSize;
+} FBenchmark;
+
+/** Benchmark runner options. */
+typedef struct {
+    /** Measured repetitions per benchmark. */
+    U32 Repetitions;
+    /** Unmeasured repetitions run before the measured ones. */
+    U32 WarmUp;
+    /** Only benchmarks whose name contains the filter are run, NULL runs all. */
+    pStr Filter;
+    /** Results file, NULL writes the results to stdout. */
+    pStr OutputPath;
+    /** Baseline results file to compare against, optional. */
+    pStr BaselinePath;
+    /** Allowed median time growth over the baseline in percent. */
+    F64 Threshold;
+    /** Only list the benchmark names. */
+    Bool bList;
+} FBenchmarkOptions;
+
+/** Parses command line options. Returns False and prints usage on invalid options. */
+Bool Benchmark_ParseOptions(int ArgumentCount, char* Arguments[], FBenchmarkOptions* OutOptions);
+
+/**
+ * Runs the benchmarks and writes JSON results. Returns the process exit code: 0 on success, 1 if a benchmark
+ * regressed over the baseline threshold, 2 if the results or the baseline could not be processed.
+ */
+int Benchmark_RunAll(const FBenchmark* Benchmarks, U32 BenchmarkCount, const FBenchmarkOptions* Options);
+
+/** Returns a monotonic high resolution timestamp in nanoseconds. */
+U64 Benchmark_GetNanoseconds();
+
+/** Keeps the compiler from optimizing away a computed value. */
+void Benchmark_DoNotOptimize(const void* Value);
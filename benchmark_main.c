@@ -0,0 +1,1175 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bcn.h"
+#include "benchmark.h"
+#include "cell.h"
+#include "chunk.h"
+#include "connectivity.h"
+#include "containers/vector.h"
+#include "dds.h"
+#include "file.h"
+#include "font_atlas.h"
+#include "io.h"
+#include "light.h"
+#include "mesher.h"
+#include "pack.h"
+#include "physics.h"
+#include "raycast.h"
+#include "region.h"
+#include "shader_source.h"
+#include "shape_optimizer.h"
+#include "stream.h"
+#include "terrain.h"
+
+#pragma region Settings
+static const pStr ChunkFragmentShaderPath = "assets/shaders/fs.glsl";
+static const pStr ChunkTexturePath = "assets/textures/texture.dds";
+static const pStr FontPath = "assets/fonts/ttf/DejaVuLGCSansMono.ttf";
+
+/** Assets read by the io benchmarks, the sources of the set the game loads on startup. */
+static const pStr IoBenchmarkPaths[] = {
+    "assets/fonts/ttf/DejaVuLGCSansMono.ttf", "assets/shaders/font_fs.glsl", "assets/shaders/font_vs.glsl", "assets/shaders/fs.glsl",
+    "assets/shaders/vs.glsl",                 "assets/textures/texture.dds",
+};
+#define IO_BENCHMARK_PATH_COUNT (sizeof IoBenchmarkPaths / sizeof IoBenchmarkPaths[0])
+/** Archive of the io benchmark assets, written by the pack benchmark setup and removed by the teardown. */
+static const pStr BenchmarkPackPath = "benchmark_assets.pak";
+/** Region file written by the region benchmarks and removed by their teardown. */
+static const pStr BenchmarkRegionPath = "benchmark_region.sqr";
+
+/** Elements pushed by the container benchmarks. */
+#define BENCHMARK_CONTAINER_ELEMENTS 100000
+/** World seed used by the chunk benchmarks. */
+#define BENCHMARK_SEED 1337
+/** Chunks saved and loaded by the region benchmarks, a 3x3x3 block of a single region. */
+#define BENCHMARK_REGION_CHUNKS 27
+/** Meshed chunks around the camera of the stream benchmark, horizontally and vertically. */
+#define BENCHMARK_STREAM_RADIUS 2
+#define BENCHMARK_STREAM_VERTICAL_RADIUS 1
+/** Structures of the connectivity benchmarks, a wall on the ground and a platform on a single pillar. */
+#define BENCHMARK_WALL_WIDTH 64
+#define BENCHMARK_WALL_HEIGHT 24
+#define BENCHMARK_PILLAR_HEIGHT 8
+#define BENCHMARK_PLATFORM_SIZE 48
+/** Generated terrain of the raycast and physics benchmarks, 4x3x4 chunks around the origin. */
+#define BENCHMARK_TERRAIN_CHUNKS 48
+/** Rays of the raycast benchmarks, cast from above the terrain. */
+#define BENCHMARK_RAYS 4096
+#define BENCHMARK_RAY_DISTANCE 128.f
+/** Bodies of the physics benchmark, resting on the terrain before they are pushed. */
+#define BENCHMARK_BODIES 4096
+/** Edits of each light edit benchmark run, digging out a surface block and putting a lamp in its place. */
+#define BENCHMARK_LIGHT_EDITS 4
+/** Water cube dropped on the terrain by the cell benchmark, and the ticks and cell budget it gets to flow. */
+#define BENCHMARK_FLOOD_SIZE 16
+#define BENCHMARK_FLOOD_TICKS 16
+#define BENCHMARK_FLOOD_CELLS_PER_TICK 4096
+/** Chunk columns the flood stays within, around the origin, restored after each run. */
+#define BENCHMARK_FLOOD_CHUNKS 12
+/** Quads per side of the prop of the shape optimizer benchmark, a height field exported as a triangle soup. */
+#define BENCHMARK_PROP_SIZE 200
+#pragma endregion
+
+#pragma region Container
+static U64 Benchmark_ContainerAdd(void* State) {
+    FVector(U32) Vector = NULL;
+    for (U32 Index = 0; Index < BENCHMARK_CONTAINER_ELEMENTS; Index++) {
+        FVector_Add(Vector, Index);
+    }
+
+    Benchmark_DoNotOptimize(Vector);
+    FVector_Free(Vector);
+
+    return BENCHMARK_CONTAINER_ELEMENTS;
+}
+
+static U64 Benchmark_ContainerReserveAdd(void* State) {
+    FVector(U32) Vector = NULL;
+    FVector_Reserve(Vector, BENCHMARK_CONTAINER_ELEMENTS);
+    for (U32 Index = 0; Index < BENCHMARK_CONTAINER_ELEMENTS; Index++) {
+        FVector_Add(Vector, Index);
+    }
+
+    Benchmark_DoNotOptimize(Vector);
+    FVector_Free(Vector);
+
+    return BENCHMARK_CONTAINER_ELEMENTS;
+}
+#pragma endregion
+
+#pragma region Chunk
+static Bool Benchmark_ChunkSetup(void** OutState) {
+    *OutState = Chunk_Create(0, 0, 0);
+    return *OutState != NULL;
+}
+
+static void Benchmark_ChunkTeardown(void* State) {
+    Chunk_Destroy(State);
+}
+
+static U64 Benchmark_ChunkFill(void* State) {
+    FChunk* Chunk = State;
+    for (I32 Y = 0; Y < CHUNK_SIZE; Y++) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                Chunk_SetBlockType(Chunk, X, Y, Z, (Byte)((X ^ Y ^ Z) & 1 ? BLOCK_TYPE_STONE : BLOCK_TYPE_AIR));
+            }
+        }
+    }
+
+    Benchmark_DoNotOptimize(Chunk);
+
+    return CHUNK_VOLUME;
+}
+
+static U64 Benchmark_ChunkGenerate(void* State) {
+    FChunk* Chunk = State;
+    Terrain_Generate(Chunk, BENCHMARK_SEED);
+    Benchmark_DoNotOptimize(Chunk);
+
+    return CHUNK_VOLUME;
+}
+#pragma endregion
+
+#pragma region Mesher
+/** Generated 3x3x3 chunk neighbourhood and output shapes. */
+typedef struct {
+    FChunk* Chunks[27];
+    FChunkNeighbourhood Neighbourhood;
+    FShape Shapes[CHUNK_SECTION_COUNT];
+} FMesherBenchmarkState;
+
+static Bool Benchmark_MesherSetup(void** OutState) {
+    FMesherBenchmarkState* State = calloc(1, sizeof *State);
+
+    // Center chunk spans the terrain surface.
+    for (I32 Index = 0; Index < 27; Index++) {
+        State->Chunks[Index] = Chunk_Create(Index % 3 - 1, Index / 9 - 1, Index / 3 % 3 - 1);
+        Terrain_Generate(State->Chunks[Index], BENCHMARK_SEED);
+        Light_ComputeChunk(State->Chunks[Index]);
+        State->Neighbourhood.Chunks[Index] = State->Chunks[Index];
+    }
+
+    *OutState = State;
+    return True;
+}
+
+static void Benchmark_MesherTeardown(void* State) {
+    FMesherBenchmarkState* MesherState = State;
+    for (U32 Index = 0; Index < 27; Index++) {
+        Chunk_Destroy(MesherState->Chunks[Index]);
+    }
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Shape_Free(&MesherState->Shapes[Section]);
+    }
+    free(MesherState);
+}
+
+static U64 Benchmark_MesherChunk(void* State) {
+    FMesherBenchmarkState* MesherState = State;
+    Mesher_BuildChunk(&MesherState->Neighbourhood, MesherState->Shapes);
+    Benchmark_DoNotOptimize(MesherState->Shapes);
+
+    return CHUNK_VOLUME;
+}
+
+static U64 Benchmark_MesherChunkFaces(void* State) {
+    FMesherBenchmarkState* MesherState = State;
+    Mesher_BuildChunkFaces(&MesherState->Neighbourhood, MesherState->Shapes);
+    Benchmark_DoNotOptimize(MesherState->Shapes);
+
+    return CHUNK_VOLUME;
+}
+#pragma endregion
+
+#pragma region Shape Optimizer
+/** Unwelded prop with shuffled triangles and 32-bit indices, copied to the work shape before each run. */
+typedef struct {
+    FShape Source;
+    FShape Work;
+} FShapeOptimizerBenchmarkState;
+
+static void Benchmark_ShapeOptimizerTeardown(void* State) {
+    FShapeOptimizerBenchmarkState* OptimizerState = State;
+    Shape_Free(&OptimizerState->Source);
+    Shape_Free(&OptimizerState->Work);
+    free(OptimizerState);
+}
+
+static void Benchmark_CopyAttribute(FVector(F32)* Target, const FVector(F32) Source) {
+    FVector_Clear(*Target);
+    FVector_Reserve(*Target, FVector_GetSize(Source));
+    memcpy(*Target, Source, FVector_GetSize(Source) * sizeof(F32));
+    FVector_SetSize(*Target, FVector_GetSize(Source));
+}
+
+static Bool Benchmark_ShapeOptimizerSetup(void** OutState) {
+    FShapeOptimizerBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    // Every triangle gets its own corners, as exporters write them, so the weld has to find the shared ones.
+    const U32 TriangleCount = BENCHMARK_PROP_SIZE * BENCHMARK_PROP_SIZE * 2;
+    U32* Order = malloc(TriangleCount * sizeof *Order);
+    for (U32 Triangle = 0; Triangle < TriangleCount; Triangle++) {
+        Order[Triangle] = Triangle;
+    }
+    U32 Random = BENCHMARK_SEED;
+    for (U32 Triangle = TriangleCount - 1; Triangle > 0; Triangle--) {
+        Random = Random * 1664525u + 1013904223u;
+        const U32 Other = (Random >> 8) % (Triangle + 1);
+        const U32 Swap = Order[Triangle];
+        Order[Triangle] = Order[Other];
+        Order[Other] = Swap;
+    }
+
+    FShape* Shape = &State->Source;
+    FVector_Reserve(Shape->Vertices, TriangleCount * 9);
+    FVector_Reserve(Shape->Normals, TriangleCount * 9);
+    FVector_Reserve(Shape->TexCoords, TriangleCount * 3 * SHAPE_TEXCOORD_COMPONENTS);
+    FVector_Reserve(Shape->Indices32, TriangleCount * 3);
+    static const U32 QuadCorners[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+    for (U32 Triangle = 0; Triangle < TriangleCount; Triangle++) {
+        const U32 Quad = Order[Triangle] / 2;
+        const U32 First = Order[Triangle] % 2 * 3;
+        for (U32 Corner = First; Corner < First + 3; Corner++) {
+            const U32 X = Quad % BENCHMARK_PROP_SIZE + QuadCorners[Corner][0];
+            const U32 Z = Quad / BENCHMARK_PROP_SIZE + QuadCorners[Corner][1];
+            const F32 Height = sinf((F32)X * 0.1f) * cosf((F32)Z * 0.1f) * 4.f;
+
+            FVector_Add(Shape->Indices32, (U32)FVector_GetSize(Shape->Vertices) / 3);
+            FVector_Add(Shape->Vertices, (F32)X);
+            FVector_Add(Shape->Vertices, Height);
+            FVector_Add(Shape->Vertices, (F32)Z);
+            FVector_Add(Shape->Normals, 0.f);
+            FVector_Add(Shape->Normals, 1.f);
+            FVector_Add(Shape->Normals, 0.f);
+            FVector_Add(Shape->TexCoords, (F32)X / BENCHMARK_PROP_SIZE);
+            FVector_Add(Shape->TexCoords, (F32)Z / BENCHMARK_PROP_SIZE);
+            FVector_Add(Shape->TexCoords, 0.f);
+            FVector_Add(Shape->TexCoords, 0.f);
+        }
+    }
+    free(Order);
+
+    *OutState = State;
+    return True;
+}
+
+/** Welds, reorders and narrows the indices of a fresh copy of the prop. */
+static U64 Benchmark_ShapeOptimizerOptimize(void* State) {
+    FShapeOptimizerBenchmarkState* OptimizerState = State;
+    FShape* Work = &OptimizerState->Work;
+    const FShape* Source = &OptimizerState->Source;
+    Benchmark_CopyAttribute(&Work->Vertices, Source->Vertices);
+    Benchmark_CopyAttribute(&Work->Normals, Source->Normals);
+    Benchmark_CopyAttribute(&Work->TexCoords, Source->TexCoords);
+    FVector_Clear(Work->Indices32);
+    FVector_Reserve(Work->Indices32, FVector_GetSize(Source->Indices32));
+    memcpy(Work->Indices32, Source->Indices32, FVector_GetSize(Source->Indices32) * sizeof(U32));
+    FVector_SetSize(Work->Indices32, FVector_GetSize(Source->Indices32));
+
+    FShapeOptimizerSettings Settings;
+    ShapeOptimizer_GetDefaultSettings(&Settings);
+    FShapeOptimizerStats Stats;
+    ShapeOptimizer_Optimize(Work, &Settings, &Stats);
+    Benchmark_DoNotOptimize(Work);
+
+    return Stats.Triangles;
+}
+#pragma endregion
+
+#pragma region Files
+static U64 Benchmark_FileReadText(void* State) {
+    I64 Length = 0;
+    const pStr Text = File_ReadText(ChunkFragmentShaderPath, &Length);
+    Benchmark_DoNotOptimize(Text);
+    free(Text);
+
+    return (U64)Length;
+}
+
+/** File contents loaded once by the setup. */
+typedef struct {
+    pStr Data;
+    I64 Length;
+} FFileBenchmarkState;
+
+static Bool Benchmark_FileSetup(const pStr Path, void** OutState) {
+    FFileBenchmarkState* State = calloc(1, sizeof *State);
+    State->Data = File_ReadText(Path, &State->Length);
+    if (State->Data == NULL) {
+        free(State);
+        return False;
+    }
+
+    *OutState = State;
+    return True;
+}
+
+static void Benchmark_FileTeardown(void* State) {
+    FFileBenchmarkState* FileState = State;
+    free(FileState->Data);
+    free(FileState);
+}
+
+static Bool Benchmark_DdsSetup(void** OutState) {
+    return Benchmark_FileSetup(ChunkTexturePath, OutState);
+}
+
+static U64 Benchmark_DdsParse(void* State) {
+    const FFileBenchmarkState* FileState = State;
+    FDdsImage Image;
+    Dds_Parse((const U8*)FileState->Data, (U64)FileState->Length, &Image);
+    Benchmark_DoNotOptimize(&Image);
+
+    return (U64)FileState->Length;
+}
+
+static Bool Benchmark_ShaderSetup(void** OutState) {
+    return Benchmark_FileSetup(ChunkFragmentShaderPath, OutState);
+}
+
+static U64 Benchmark_ShaderPreprocess(void* State) {
+    static const pStr Defines[] = {"SMUDGE_BLENDING 1", "RIM_LIGHTING"};
+
+    const FFileBenchmarkState* FileState = State;
+    I64 Length = 0;
+    const pStr Source = ShaderSource_Preprocess(FileState->Data, FileState->Length, "assets/shaders/", Defines, 2, &Length);
+    Benchmark_DoNotOptimize(Source);
+    free(Source);
+
+    return (U64)FileState->Length;
+}
+
+/** First mip level of the chunk texture decoded once by the setup, and room for its blocks. */
+typedef struct {
+    FImage Image;
+    U8* Blocks;
+} FBcnBenchmarkState;
+
+static Bool Benchmark_BcnSetup(void** OutState) {
+    I64 Length = 0;
+    U8* Data = (U8*)File_ReadText(ChunkTexturePath, &Length);
+    FDdsImage Dds;
+    if (Data == NULL || !Dds_Parse(Data, (U64)Length, &Dds)) {
+        free(Data);
+        return False;
+    }
+
+    FBcnBenchmarkState* State = calloc(1, sizeof *State);
+    const Bool bDecoded = Bcn_DecodeImage(Data + Dds.MipLevels[0].Offset, Dds.Format, Dds.Width, Dds.Height, &State->Image);
+    free(Data);
+    State->Blocks = malloc((size_t)State->Image.Width * State->Image.Height);
+    if (!bDecoded || State->Blocks == NULL) {
+        Image_Free(&State->Image);
+        free(State->Blocks);
+        free(State);
+        return False;
+    }
+
+    *OutState = State;
+    return True;
+}
+
+static void Benchmark_BcnTeardown(void* State) {
+    FBcnBenchmarkState* BcnState = State;
+    Image_Free(&BcnState->Image);
+    free(BcnState->Blocks);
+    free(BcnState);
+}
+
+static U64 Benchmark_BcnEncodeDxt1(void* State) {
+    FBcnBenchmarkState* BcnState = State;
+    Bcn_EncodeImage(&BcnState->Image, DDS_FORMAT_DXT1, BcnState->Blocks);
+    Benchmark_DoNotOptimize(BcnState->Blocks);
+
+    return (U64)BcnState->Image.Width * BcnState->Image.Height;
+}
+
+static Bool Benchmark_FontSetup(void** OutState) {
+    return Benchmark_FileSetup(FontPath, OutState);
+}
+
+static U64 Benchmark_FontBuildAtlas(void* State) {
+    const FFileBenchmarkState* FileState = State;
+    FFontAtlasSettings Settings;
+    FontAtlas_GetDefaultSettings(&Settings);
+    FFontAtlas Atlas;
+    if (!FontAtlas_Build((const U8*)FileState->Data, (U64)FileState->Length, &Settings, &Atlas)) {
+        return 0;
+    }
+
+    Benchmark_DoNotOptimize(Atlas.Pixels);
+    FontAtlas_Free(&Atlas);
+
+    return FONT_ATLAS_GLYPH_COUNT;
+}
+#pragma endregion
+
+#pragma region Io
+static U64 Benchmark_IoReadBlocking(void* State) {
+    U64 Bytes = 0;
+    for (U32 Index = 0; Index < IO_BENCHMARK_PATH_COUNT; Index++) {
+        I64 Length = 0;
+        const pStr Data = File_ReadText(IoBenchmarkPaths[Index], &Length);
+        Benchmark_DoNotOptimize(Data);
+        free(Data);
+        Bytes += (U64)Length;
+    }
+
+    return Bytes;
+}
+
+static Bool Benchmark_IoThreadsSetup(void** OutState) {
+    return Io_Initialize(IO_BACKEND_THREADS);
+}
+
+static Bool Benchmark_IoUringSetup(void** OutState) {
+    if (!Io_Initialize(IO_BACKEND_URING)) {
+        return False;
+    }
+
+    // Skipped when the kernel has no io_uring and the service fell back to worker threads.
+    if (Io_GetBackend() != IO_BACKEND_URING) {
+        Io_Shutdown();
+        return False;
+    }
+
+    return True;
+}
+
+static void Benchmark_IoTeardown(void* State) {
+    Io_Shutdown();
+}
+
+static U64 Benchmark_IoReadAsync(void* State) {
+    U32 Ids[IO_BENCHMARK_PATH_COUNT];
+    for (U32 Index = 0; Index < IO_BENCHMARK_PATH_COUNT; Index++) {
+        FIoReadRequest Request = {0};
+        Request.Path = IoBenchmarkPaths[Index];
+        Request.Priority = IO_PRIORITY_NORMAL;
+        Ids[Index] = Io_Read(&Request);
+    }
+
+    U64 Bytes = 0;
+    for (U32 Index = 0; Index < IO_BENCHMARK_PATH_COUNT; Index++) {
+        FIoResult Result;
+        if (Io_Wait(Ids[Index], &Result) == IO_STATUS_COMPLETED) {
+            Benchmark_DoNotOptimize(Result.Data);
+            Bytes += Result.Length;
+        }
+        Io_Release(Ids[Index]);
+    }
+
+    return Bytes;
+}
+#pragma endregion
+
+#pragma region Pack
+static Bool Benchmark_PackSetup(void** OutState) {
+    if (!Pack_Write(BenchmarkPackPath, IoBenchmarkPaths, IO_BENCHMARK_PATH_COUNT, True)) {
+        return False;
+    }
+
+    FPack* Pack = Pack_Open(BenchmarkPackPath);
+    if (Pack == NULL) {
+        remove(BenchmarkPackPath);
+        return False;
+    }
+
+    *OutState = Pack;
+    return True;
+}
+
+static void Benchmark_PackTeardown(void* State) {
+    Pack_Close(State);
+    remove(BenchmarkPackPath);
+}
+
+static U64 Benchmark_PackRead(void* State) {
+    const FPack* Pack = State;
+
+    U64 Bytes = 0;
+    for (U32 Index = 0; Index < IO_BENCHMARK_PATH_COUNT; Index++) {
+        const FPackEntry* Entry = Pack_FindEntry(Pack, IoBenchmarkPaths[Index]);
+        U8* Data = malloc(Entry->Size);
+        Pack_ReadEntry(Pack, Entry, Data, Entry->Size);
+        Benchmark_DoNotOptimize(Data);
+        free(Data);
+        Bytes += Entry->Size;
+    }
+
+    return Bytes;
+}
+
+static Bool Benchmark_IoPackSetup(void** OutState) {
+    if (!Benchmark_PackSetup(OutState)) {
+        return False;
+    }
+
+    if (!Io_Initialize(IO_BACKEND_DEFAULT)) {
+        Benchmark_PackTeardown(*OutState);
+        return False;
+    }
+
+    Io_MountPack(*OutState);
+    return True;
+}
+
+static void Benchmark_IoPackTeardown(void* State) {
+    Io_Shutdown();
+    Benchmark_PackTeardown(State);
+}
+#pragma endregion
+
+#pragma region Region
+/** Generated chunks of a single region and the region file they are saved to. */
+typedef struct {
+    FChunk* Chunks[BENCHMARK_REGION_CHUNKS];
+    FChunk* Loaded;
+    FRegion* Region;
+} FRegionBenchmarkState;
+
+static void Benchmark_RegionTeardown(void* State) {
+    FRegionBenchmarkState* RegionState = State;
+    for (U32 Index = 0; Index < BENCHMARK_REGION_CHUNKS; Index++) {
+        Chunk_Destroy(RegionState->Chunks[Index]);
+    }
+    Chunk_Destroy(RegionState->Loaded);
+    if (RegionState->Region != NULL) {
+        Region_Close(RegionState->Region);
+    }
+    remove(BenchmarkRegionPath);
+    free(RegionState);
+}
+
+static Bool Benchmark_RegionSetup(void** OutState) {
+    remove(BenchmarkRegionPath);
+
+    FRegionBenchmarkState* State = calloc(1, sizeof *State);
+    for (I32 Index = 0; Index < BENCHMARK_REGION_CHUNKS; Index++) {
+        State->Chunks[Index] = Chunk_Create(Index % 3, Index / 9, Index / 3 % 3);
+        Terrain_Generate(State->Chunks[Index], BENCHMARK_SEED);
+    }
+    State->Loaded = Chunk_Create(0, 0, 0);
+
+    State->Region = Region_Open(BenchmarkRegionPath, 0, 0, 0);
+    if (State->Region == NULL) {
+        Benchmark_RegionTeardown(State);
+        return False;
+    }
+
+    *OutState = State;
+    return True;
+}
+
+/** Saves every chunk and flushes, replaced versions are reused by the next repetition. */
+static U64 Benchmark_RegionSave(FRegionBenchmarkState* State, const ERegionCompression Compression) {
+    for (U32 Index = 0; Index < BENCHMARK_REGION_CHUNKS; Index++) {
+        Region_SaveChunk(State->Region, State->Chunks[Index], Compression);
+    }
+    Region_Flush(State->Region);
+
+    return (U64)BENCHMARK_REGION_CHUNKS * CHUNK_VOLUME * sizeof(FBlock);
+}
+
+static U64 Benchmark_RegionSaveFast(void* State) {
+    return Benchmark_RegionSave(State, REGION_COMPRESSION_FAST);
+}
+
+static U64 Benchmark_RegionSaveArchival(void* State) {
+    return Benchmark_RegionSave(State, REGION_COMPRESSION_ARCHIVAL);
+}
+
+static Bool Benchmark_RegionLoadSetup(void** OutState) {
+    if (!Benchmark_RegionSetup(OutState)) {
+        return False;
+    }
+
+    Benchmark_RegionSaveFast(*OutState);
+    return True;
+}
+
+static U64 Benchmark_RegionLoad(void* State) {
+    FRegionBenchmarkState* RegionState = State;
+    for (U32 Index = 0; Index < BENCHMARK_REGION_CHUNKS; Index++) {
+        const FChunk* Chunk = RegionState->Chunks[Index];
+        Region_LoadChunk(RegionState->Region, Chunk->X, Chunk->Y, Chunk->Z, RegionState->Loaded);
+        Benchmark_DoNotOptimize(RegionState->Loaded);
+    }
+
+    return (U64)BENCHMARK_REGION_CHUNKS * CHUNK_VOLUME * sizeof(FBlock);
+}
+#pragma endregion
+
+#pragma region Stream
+/** Block toggled by the edit benchmark, the corner of four sections shared with the sections around it. */
+#define BENCHMARK_STREAM_EDIT_X 15
+#define BENCHMARK_STREAM_EDIT_Y 47
+#define BENCHMARK_STREAM_EDIT_Z 15
+
+/** Camera on the terrain surface looking along negative Z. */
+static const F32 StreamCameraPosition[3] = {16.f, 40.f, 16.f};
+static const F32 StreamCameraForward[3] = {0.f, 0.f, -1.f};
+
+/** Creates a stream around the benchmark camera and updates it until every mesh is uploaded. */
+static FStream* Benchmark_StreamCreateFilled() {
+    FStreamSettings Settings;
+    Stream_GetDefaultSettings(&Settings);
+    Settings.Radius = BENCHMARK_STREAM_RADIUS;
+    Settings.VerticalRadius = BENCHMARK_STREAM_VERTICAL_RADIUS;
+    Settings.Seed = BENCHMARK_SEED;
+
+    FStream* Stream = Stream_Create(&Settings);
+    if (Stream == NULL) {
+        return NULL;
+    }
+
+    do {
+        Stream_Update(Stream, StreamCameraPosition, StreamCameraForward);
+    } while (!Stream_IsIdle(Stream));
+
+    return Stream;
+}
+
+/** Streams the chunks around a fresh camera until every mesh is uploaded, including the worker startup. */
+static U64 Benchmark_StreamFill(void* State) {
+    FStream* Stream = Benchmark_StreamCreateFilled();
+    if (Stream == NULL) {
+        return 0;
+    }
+
+    FStreamStats Stats;
+    Stream_GetStats(Stream, &Stats);
+    Stream_Destroy(Stream);
+
+    return Stats.LoadedChunks;
+}
+
+static Bool Benchmark_StreamEditSetup(void** OutState) {
+    *OutState = Benchmark_StreamCreateFilled();
+    return *OutState != NULL;
+}
+
+static void Benchmark_StreamEditTeardown(void* State) {
+    Stream_Destroy(State);
+}
+
+/** Toggles a block and updates the stream once, remeshing the eight sections around the block. */
+static U64 Benchmark_StreamEdit(void* State) {
+    FStream* Stream = State;
+    const Byte Type = World_GetBlockType(Stream_GetWorld(Stream), BENCHMARK_STREAM_EDIT_X, BENCHMARK_STREAM_EDIT_Y, BENCHMARK_STREAM_EDIT_Z);
+    Stream_SetBlockType(Stream, BENCHMARK_STREAM_EDIT_X, BENCHMARK_STREAM_EDIT_Y, BENCHMARK_STREAM_EDIT_Z,
+                        Type == BLOCK_TYPE_AIR ? BLOCK_TYPE_STONE : BLOCK_TYPE_AIR);
+    Stream_Update(Stream, StreamCameraPosition, StreamCameraForward);
+
+    return 1;
+}
+#pragma endregion
+
+#pragma region Connectivity
+typedef struct {
+    FChunk* Chunks[4];
+    FWorld* World;
+    FConnectivity* Connectivity;
+} FConnectivityBenchmarkState;
+
+static void Benchmark_ConnectivityTeardown(void* State) {
+    FConnectivityBenchmarkState* ConnectivityState = State;
+    Connectivity_Destroy(ConnectivityState->Connectivity);
+    World_Destroy(ConnectivityState->World);
+    for (U32 Index = 0; Index < 4; Index++) {
+        Chunk_Destroy(ConnectivityState->Chunks[Index]);
+    }
+    free(ConnectivityState);
+}
+
+/** Places a block of the benchmark structures the way edits do. */
+static void Benchmark_ConnectivitySet(FConnectivityBenchmarkState* State, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FChunk* Chunk = World_GetChunk(State->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+    if (Type == BLOCK_TYPE_AIR) {
+        Connectivity_RemoveBlock(State->Connectivity, X, Y, Z);
+    } else {
+        Connectivity_AddBlock(State->Connectivity, X, Y, Z);
+    }
+}
+
+/** Builds a 64x64 block ground layer with a wall along X and a platform resting on a pillar in the middle. */
+static Bool Benchmark_ConnectivitySetup(void** OutState) {
+    FConnectivityBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    State->World = World_Create();
+    State->Connectivity = Connectivity_Create(State->World, NULL, NULL);
+    Bool bCreated = State->World != NULL && State->Connectivity != NULL;
+    for (U32 Index = 0; Index < 4; Index++) {
+        State->Chunks[Index] = Chunk_Create((I32)(Index & 1), 0, (I32)(Index >> 1));
+        bCreated = bCreated && State->Chunks[Index] != NULL;
+    }
+    if (!bCreated) {
+        Benchmark_ConnectivityTeardown(State);
+        return False;
+    }
+
+    for (U32 Index = 0; Index < 4; Index++) {
+        FChunk* Chunk = State->Chunks[Index];
+        World_AddChunk(State->World, Chunk);
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                FBlock* Block = &Chunk->Blocks[Chunk_GetBlockIndex(X, 0, Z)];
+                Block->Type = BLOCK_TYPE_STONE;
+                Block->Flags = BLOCK_FLAG_ANCHORED;
+            }
+        }
+        Chunk_UpdateBlockCount(Chunk);
+    }
+
+    for (I32 Y = 1; Y <= BENCHMARK_WALL_HEIGHT; Y++) {
+        for (I32 X = 0; X < BENCHMARK_WALL_WIDTH; X++) {
+            Benchmark_ConnectivitySet(State, X, Y, 4, BLOCK_TYPE_STONE);
+        }
+    }
+
+    const I32 Center = CHUNK_SIZE;
+    for (I32 Y = 1; Y <= BENCHMARK_PILLAR_HEIGHT; Y++) {
+        Benchmark_ConnectivitySet(State, Center, Y, Center, BLOCK_TYPE_STONE);
+    }
+
+    // Platform blocks placed before the one over the pillar float until it joins them to the pillar.
+    const I32 PlatformBegin = Center - BENCHMARK_PLATFORM_SIZE / 2;
+    for (I32 Z = PlatformBegin; Z < PlatformBegin + BENCHMARK_PLATFORM_SIZE; Z++) {
+        for (I32 X = PlatformBegin; X < PlatformBegin + BENCHMARK_PLATFORM_SIZE; X++) {
+            Benchmark_ConnectivitySet(State, X, BENCHMARK_PILLAR_HEIGHT + 1, Z, BLOCK_TYPE_STONE);
+        }
+    }
+    Connectivity_ClearBatches(State->Connectivity);
+
+    *OutState = State;
+    return True;
+}
+
+/** Removes and replaces a block at the bottom of the wall, the blocks above are reattached to the next column. */
+static U64 Benchmark_ConnectivityRemoveSupported(void* State) {
+    FConnectivityBenchmarkState* ConnectivityState = State;
+    Benchmark_ConnectivitySet(ConnectivityState, BENCHMARK_WALL_WIDTH / 2, 1, 4, BLOCK_TYPE_AIR);
+    Benchmark_ConnectivitySet(ConnectivityState, BENCHMARK_WALL_WIDTH / 2, 1, 4, BLOCK_TYPE_STONE);
+
+    return 2;
+}
+
+/** Removes and replaces the top of the pillar, the whole platform floats and is supported again. */
+static U64 Benchmark_ConnectivityCollapse(void* State) {
+    FConnectivityBenchmarkState* ConnectivityState = State;
+    Benchmark_ConnectivitySet(ConnectivityState, CHUNK_SIZE, BENCHMARK_PILLAR_HEIGHT, CHUNK_SIZE, BLOCK_TYPE_AIR);
+    Benchmark_ConnectivitySet(ConnectivityState, CHUNK_SIZE, BENCHMARK_PILLAR_HEIGHT, CHUNK_SIZE, BLOCK_TYPE_STONE);
+    Connectivity_ClearBatches(ConnectivityState->Connectivity);
+
+    return 2;
+}
+#pragma endregion
+
+#pragma region Terrain
+typedef struct {
+    FChunk* Chunks[BENCHMARK_TERRAIN_CHUNKS];
+    FWorld* World;
+} FBenchmarkTerrain;
+
+static void Benchmark_DestroyTerrain(FBenchmarkTerrain* Terrain) {
+    World_Destroy(Terrain->World);
+    for (U32 Index = 0; Index < BENCHMARK_TERRAIN_CHUNKS; Index++) {
+        Chunk_Destroy(Terrain->Chunks[Index]);
+    }
+}
+
+/** Generates the terrain chunks into a world, cleans up after itself on failure. */
+static Bool Benchmark_CreateTerrain(FBenchmarkTerrain* OutTerrain) {
+    OutTerrain->World = World_Create();
+    Bool bCreated = OutTerrain->World != NULL;
+    for (U32 Index = 0; Index < BENCHMARK_TERRAIN_CHUNKS; Index++) {
+        OutTerrain->Chunks[Index] = Chunk_Create((I32)(Index % 4) - 2, (I32)(Index / 16), (I32)(Index / 4 % 4) - 2);
+        bCreated = bCreated && OutTerrain->Chunks[Index] != NULL;
+    }
+    if (!bCreated) {
+        Benchmark_DestroyTerrain(OutTerrain);
+        return False;
+    }
+
+    for (U32 Index = 0; Index < BENCHMARK_TERRAIN_CHUNKS; Index++) {
+        Terrain_Generate(OutTerrain->Chunks[Index], BENCHMARK_SEED);
+        World_AddChunk(OutTerrain->World, OutTerrain->Chunks[Index]);
+    }
+
+    return True;
+}
+#pragma endregion
+
+#pragma region Raycast
+typedef struct {
+    FBenchmarkTerrain Terrain;
+    F32 OriginX[BENCHMARK_RAYS];
+    F32 OriginY[BENCHMARK_RAYS];
+    F32 OriginZ[BENCHMARK_RAYS];
+    F32 DirectionX[BENCHMARK_RAYS];
+    F32 DirectionY[BENCHMARK_RAYS];
+    F32 DirectionZ[BENCHMARK_RAYS];
+    F32 MaxDistance[BENCHMARK_RAYS];
+    FRaycastHit Hits[BENCHMARK_RAYS];
+} FRaycastBenchmarkState;
+
+static void Benchmark_RaycastTeardown(void* State) {
+    FRaycastBenchmarkState* RaycastState = State;
+    Benchmark_DestroyTerrain(&RaycastState->Terrain);
+    free(RaycastState);
+}
+
+/** Generates the terrain and spreads the rays over the lower hemisphere around a point above it. */
+static Bool Benchmark_RaycastSetup(void** OutState) {
+    FRaycastBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    if (!Benchmark_CreateTerrain(&State->Terrain)) {
+        free(State);
+        return False;
+    }
+
+    for (U32 Index = 0; Index < BENCHMARK_RAYS; Index++) {
+        const F32 Angle = (F32)Index * 2.39996323f;
+        const F32 Down = (F32)(Index + 1) / BENCHMARK_RAYS;
+        State->OriginX[Index] = 0.5f;
+        State->OriginY[Index] = 70.5f;
+        State->OriginZ[Index] = 0.5f;
+        State->DirectionX[Index] = cosf(Angle);
+        State->DirectionY[Index] = -Down;
+        State->DirectionZ[Index] = sinf(Angle);
+        State->MaxDistance[Index] = BENCHMARK_RAY_DISTANCE;
+    }
+
+    *OutState = State;
+    return True;
+}
+
+static U64 Benchmark_RaycastSingle(void* State) {
+    FRaycastBenchmarkState* RaycastState = State;
+    for (U32 Index = 0; Index < BENCHMARK_RAYS; Index++) {
+        const F32 Origin[3] = {RaycastState->OriginX[Index], RaycastState->OriginY[Index], RaycastState->OriginZ[Index]};
+        const F32 Direction[3] = {RaycastState->DirectionX[Index], RaycastState->DirectionY[Index], RaycastState->DirectionZ[Index]};
+        Raycast_Cast(RaycastState->Terrain.World, Origin, Direction, RaycastState->MaxDistance[Index], &RaycastState->Hits[Index]);
+    }
+    Benchmark_DoNotOptimize(RaycastState->Hits);
+
+    return BENCHMARK_RAYS;
+}
+
+static U64 Benchmark_RaycastBatch(void* State) {
+    FRaycastBenchmarkState* RaycastState = State;
+    const FRaycastRays Rays = {
+        RaycastState->OriginX,    RaycastState->OriginY,    RaycastState->OriginZ,     RaycastState->DirectionX,
+        RaycastState->DirectionY, RaycastState->DirectionZ, RaycastState->MaxDistance,
+    };
+    Raycast_CastBatch(RaycastState->Terrain.World, &Rays, BENCHMARK_RAYS, RaycastState->Hits);
+    Benchmark_DoNotOptimize(RaycastState->Hits);
+
+    return BENCHMARK_RAYS;
+}
+#pragma endregion
+
+#pragma region Physics
+typedef struct {
+    FBenchmarkTerrain Terrain;
+    FPhysics* Physics;
+    U32 Bodies[BENCHMARK_BODIES];
+    U32 Run;
+} FPhysicsBenchmarkState;
+
+static void Benchmark_PhysicsTeardown(void* State) {
+    FPhysicsBenchmarkState* PhysicsState = State;
+    Physics_Destroy(PhysicsState->Physics);
+    Benchmark_DestroyTerrain(&PhysicsState->Terrain);
+    free(PhysicsState);
+}
+
+/** Drops the bodies in a grid over the terrain and lets them settle. */
+static Bool Benchmark_PhysicsSetup(void** OutState) {
+    FPhysicsBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    if (!Benchmark_CreateTerrain(&State->Terrain)) {
+        free(State);
+        return False;
+    }
+
+    FPhysicsSettings Settings;
+    Physics_GetDefaultSettings(&Settings);
+    Settings.World = State->Terrain.World;
+    State->Physics = Physics_Create(&Settings);
+    if (State->Physics == NULL) {
+        Benchmark_PhysicsTeardown(State);
+        return False;
+    }
+
+    // 64x64 bodies two blocks apart, the grid covers the terrain but the border chunks.
+    for (U32 Index = 0; Index < BENCHMARK_BODIES; Index++) {
+        const F32 Position[3] = {(F32)(Index % 64) * 2.f - 63.5f, 80.f, (F32)(Index / 64) * 2.f - 63.5f};
+        const F32 HalfExtents[3] = {0.3f, 0.9f, 0.3f};
+        State->Bodies[Index] = Physics_AddBody(State->Physics, Position, HalfExtents);
+    }
+    for (U32 Index = 0; Index < 180; Index++) {
+        Physics_Update(State->Physics, Settings.StepSeconds);
+    }
+
+    *OutState = State;
+    return True;
+}
+
+/** Pushes every body in a direction turning with each run and steps once, the worst case of all bodies awake. */
+static U64 Benchmark_PhysicsStep(void* State) {
+    FPhysicsBenchmarkState* PhysicsState = State;
+    const F32 Angle = (F32)PhysicsState->Run++ * 2.39996323f;
+    for (U32 Index = 0; Index < BENCHMARK_BODIES; Index++) {
+        const F32 Velocity[3] = {cosf(Angle + (F32)Index) * 4.f, 0.f, sinf(Angle + (F32)Index) * 4.f};
+        Physics_SetVelocity(PhysicsState->Physics, PhysicsState->Bodies[Index], Velocity);
+    }
+    Physics_Update(PhysicsState->Physics, 1.0 / 60.0);
+
+    return BENCHMARK_BODIES;
+}
+#pragma endregion
+
+#pragma region Light
+/** Generates the chunk spanning the terrain surface. */
+static Bool Benchmark_LightChunkSetup(void** OutState) {
+    FChunk* Chunk = Chunk_Create(0, 0, 0);
+    if (Chunk == NULL) {
+        return False;
+    }
+
+    Terrain_Generate(Chunk, BENCHMARK_SEED);
+    *OutState = Chunk;
+    return True;
+}
+
+/** Lights the generated chunk from scratch, as the load jobs do. */
+static U64 Benchmark_LightChunk(void* State) {
+    FChunk* Chunk = State;
+    Light_ComputeChunk(Chunk);
+    Benchmark_DoNotOptimize(Chunk->Light);
+
+    return CHUNK_VOLUME;
+}
+
+typedef struct {
+    FBenchmarkTerrain Terrain;
+    FLight* Light;
+    /** Surface block edited by the runs and its generated type. */
+    I32 Surface[3];
+    Byte SurfaceType;
+} FLightEditBenchmarkState;
+
+static void Benchmark_LightEditTeardown(void* State) {
+    FLightEditBenchmarkState* LightState = State;
+    Light_Destroy(LightState->Light);
+    Benchmark_DestroyTerrain(&LightState->Terrain);
+    free(LightState);
+}
+
+/** Lights the terrain chunks one by one and exchanges their light as the stream does. */
+static Bool Benchmark_LightEditSetup(void** OutState) {
+    FLightEditBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    if (!Benchmark_CreateTerrain(&State->Terrain)) {
+        free(State);
+        return False;
+    }
+
+    State->Light = Light_Create(State->Terrain.World, 0, NULL, NULL);
+    if (State->Light == NULL) {
+        Benchmark_LightEditTeardown(State);
+        return False;
+    }
+
+    for (U32 Index = 0; Index < BENCHMARK_TERRAIN_CHUNKS; Index++) {
+        const FChunk* Chunk = State->Terrain.Chunks[Index];
+        Light_ComputeChunk(State->Terrain.Chunks[Index]);
+        Light_AddChunk(State->Light, Chunk->X, Chunk->Y, Chunk->Z);
+    }
+    Light_Update(State->Light);
+
+    State->Surface[0] = 0;
+    State->Surface[1] = Terrain_GetHeight(0, 0, BENCHMARK_SEED) - 1;
+    State->Surface[2] = 0;
+    State->SurfaceType = World_GetBlockType(State->Terrain.World, 0, State->Surface[1], 0);
+
+    *OutState = State;
+    return True;
+}
+
+/** Opens the surface to the sunlight, closes it, puts a lamp in it and closes it again, propagating each edit. */
+static U64 Benchmark_LightEdit(void* State) {
+    FLightEditBenchmarkState* LightState = State;
+    const I32* Surface = LightState->Surface;
+    FChunk* Chunk = World_GetChunk(LightState->Terrain.World, World_GetChunkCoordinate(Surface[0]), World_GetChunkCoordinate(Surface[1]),
+                                   World_GetChunkCoordinate(Surface[2]));
+    const Byte Types[BENCHMARK_LIGHT_EDITS] = {BLOCK_TYPE_AIR, LightState->SurfaceType, BLOCK_TYPE_LAMP, LightState->SurfaceType};
+
+    for (U32 Index = 0; Index < BENCHMARK_LIGHT_EDITS; Index++) {
+        Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(Surface[0]), World_GetLocalCoordinate(Surface[1]), World_GetLocalCoordinate(Surface[2]), Types[Index]);
+        Light_UpdateBlock(LightState->Light, Surface[0], Surface[1], Surface[2]);
+        Light_Update(LightState->Light);
+    }
+    Benchmark_DoNotOptimize(Chunk->Light);
+
+    return BENCHMARK_LIGHT_EDITS;
+}
+#pragma endregion
+
+#pragma region Cells
+typedef struct {
+    FBenchmarkTerrain Terrain;
+    /** Generated chunks the flood reaches and their copies. */
+    FChunk* Chunks[BENCHMARK_FLOOD_CHUNKS];
+    FChunk* Copies[BENCHMARK_FLOOD_CHUNKS];
+    /** Lowest block of the water cube. */
+    I32 Base[3];
+} FCellBenchmarkState;
+
+static void Benchmark_CellTeardown(void* State) {
+    FCellBenchmarkState* CellState = State;
+    for (U32 Index = 0; Index < BENCHMARK_FLOOD_CHUNKS; Index++) {
+        Chunk_Destroy(CellState->Copies[Index]);
+    }
+    Benchmark_DestroyTerrain(&CellState->Terrain);
+    free(CellState);
+}
+
+/** Generates the terrain and copies the chunk columns around the origin, the runs flood them. */
+static Bool Benchmark_CellSetup(void** OutState) {
+    FCellBenchmarkState* State = calloc(1, sizeof *State);
+    if (State == NULL) {
+        return False;
+    }
+
+    if (!Benchmark_CreateTerrain(&State->Terrain)) {
+        free(State);
+        return False;
+    }
+
+    U32 Count = 0;
+    for (U32 Index = 0; Index < BENCHMARK_TERRAIN_CHUNKS; Index++) {
+        FChunk* Chunk = State->Terrain.Chunks[Index];
+        if (Chunk->X < -1 || Chunk->X > 0 || Chunk->Z < -1 || Chunk->Z > 0) {
+            continue;
+        }
+
+        State->Chunks[Count] = Chunk;
+        State->Copies[Count] = Chunk_Create(Chunk->X, Chunk->Y, Chunk->Z);
+        if (State->Copies[Count] == NULL) {
+            Benchmark_CellTeardown(State);
+            return False;
+        }
+        memcpy(State->Copies[Count], Chunk, sizeof(FChunk));
+        Count++;
+    }
+
+    // The cube floats a few blocks over the ground, below the top of the terrain chunks.
+    const I32 Top = 3 * CHUNK_SIZE - BENCHMARK_FLOOD_SIZE;
+    const I32 Height = Terrain_GetHeight(0, 0, BENCHMARK_SEED) + 4;
+    State->Base[0] = -BENCHMARK_FLOOD_SIZE / 2;
+    State->Base[1] = Height < Top ? Height : Top;
+    State->Base[2] = -BENCHMARK_FLOOD_SIZE / 2;
+
+    *OutState = State;
+    return True;
+}
+
+/** Drops the water cube, lets it fall and spread for the ticks and restores the terrain. */
+static U64 Benchmark_CellFlood(void* State) {
+    FCellBenchmarkState* CellState = State;
+    FCells* Cells = Cells_Create(CellState->Terrain.World, BENCHMARK_FLOOD_CELLS_PER_TICK, 0, NULL, NULL);
+    if (Cells == NULL) {
+        return 0;
+    }
+
+    const I32* Base = CellState->Base;
+    for (I32 Y = Base[1]; Y < Base[1] + BENCHMARK_FLOOD_SIZE; Y++) {
+        for (I32 Z = Base[2]; Z < Base[2] + BENCHMARK_FLOOD_SIZE; Z++) {
+            for (I32 X = Base[0]; X < Base[0] + BENCHMARK_FLOOD_SIZE; X++) {
+                FChunk* Chunk = World_GetChunk(CellState->Terrain.World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+                Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), BLOCK_TYPE_WATER);
+                Cells_ActivateBlock(Cells, X, Y, Z);
+            }
+        }
+    }
+
+    U64 SteppedCells = 0;
+    for (U32 Tick = 0; Tick < BENCHMARK_FLOOD_TICKS; Tick++) {
+        FCellStats Stats;
+        Cells_Tick(Cells);
+        Cells_GetStats(Cells, &Stats);
+        SteppedCells += Stats.SteppedCells;
+    }
+    Cells_Destroy(Cells);
+
+    for (U32 Index = 0; Index < BENCHMARK_FLOOD_CHUNKS; Index++) {
+        memcpy(CellState->Chunks[Index], CellState->Copies[Index], sizeof(FChunk));
+    }
+
+    return SteppedCells;
+}
+#pragma endregion
+
+static const FBenchmark Benchmarks[] = {
+    {"container.add", "elements", NULL, Benchmark_ContainerAdd, NULL},
+    {"container.reserve_add", "elements", NULL, Benchmark_ContainerReserveAdd, NULL},
+    {"chunk.fill", "blocks", Benchmark_ChunkSetup, Benchmark_ChunkFill, Benchmark_ChunkTeardown},
+    {"chunk.generate", "blocks", Benchmark_ChunkSetup, Benchmark_ChunkGenerate, Benchmark_ChunkTeardown},
+    {"mesher.chunk", "blocks", Benchmark_MesherSetup, Benchmark_MesherChunk, Benchmark_MesherTeardown},
+    {"mesher.chunk_faces", "blocks", Benchmark_MesherSetup, Benchmark_MesherChunkFaces, Benchmark_MesherTeardown},
+    {"shape.optimize", "triangles", Benchmark_ShapeOptimizerSetup, Benchmark_ShapeOptimizerOptimize, Benchmark_ShapeOptimizerTeardown},
+    {"file.read_text", "bytes", NULL, Benchmark_FileReadText, NULL},
+    {"dds.parse", "bytes", Benchmark_DdsSetup, Benchmark_DdsParse, Benchmark_FileTeardown},
+    {"shader.preprocess", "bytes", Benchmark_ShaderSetup, Benchmark_ShaderPreprocess, Benchmark_FileTeardown},
+    {"bcn.encode_dxt1", "texels", Benchmark_BcnSetup, Benchmark_BcnEncodeDxt1, Benchmark_BcnTeardown},
+    {"font.build_atlas", "glyphs", Benchmark_FontSetup, Benchmark_FontBuildAtlas, Benchmark_FileTeardown},
+    {"io.read_blocking", "bytes", NULL, Benchmark_IoReadBlocking, NULL},
+    {"io.read_threads", "bytes", Benchmark_IoThreadsSetup, Benchmark_IoReadAsync, Benchmark_IoTeardown},
+    {"io.read_uring", "bytes", Benchmark_IoUringSetup, Benchmark_IoReadAsync, Benchmark_IoTeardown},
+    {"io.read_pack", "bytes", Benchmark_IoPackSetup, Benchmark_IoReadAsync, Benchmark_IoPackTeardown},
+    {"pack.read", "bytes", Benchmark_PackSetup, Benchmark_PackRead, Benchmark_PackTeardown},
+    {"region.save_fast", "bytes", Benchmark_RegionSetup, Benchmark_RegionSaveFast, Benchmark_RegionTeardown, "chunks", CHUNK_VOLUME * sizeof(FBlock)},
+    {"region.save_archival", "bytes", Benchmark_RegionSetup, Benchmark_RegionSaveArchival, Benchmark_RegionTeardown, "chunks", CHUNK_VOLUME * sizeof(FBlock)},
+    {"region.load", "bytes", Benchmark_RegionLoadSetup, Benchmark_RegionLoad, Benchmark_RegionTeardown, "chunks", CHUNK_VOLUME * sizeof(FBlock)},
+    {"stream.fill", "chunks", NULL, Benchmark_StreamFill, NULL},
+    {"stream.edit", "edits", Benchmark_StreamEditSetup, Benchmark_StreamEdit, Benchmark_StreamEditTeardown},
+    {"connectivity.remove_supported", "edits", Benchmark_ConnectivitySetup, Benchmark_ConnectivityRemoveSupported, Benchmark_ConnectivityTeardown},
+    {"connectivity.collapse", "edits", Benchmark_ConnectivitySetup, Benchmark_ConnectivityCollapse, Benchmark_ConnectivityTeardown},
+    {"raycast.single", "rays", Benchmark_RaycastSetup, Benchmark_RaycastSingle, Benchmark_RaycastTeardown},
+    {"raycast.batch", "rays", Benchmark_RaycastSetup, Benchmark_RaycastBatch, Benchmark_RaycastTeardown},
+    {"physics.step", "bodies", Benchmark_PhysicsSetup, Benchmark_PhysicsStep, Benchmark_PhysicsTeardown},
+    {"light.chunk", "blocks", Benchmark_LightChunkSetup, Benchmark_LightChunk, Benchmark_ChunkTeardown},
+    {"light.edit", "edits", Benchmark_LightEditSetup, Benchmark_LightEdit, Benchmark_LightEditTeardown},
+    {"cell.flood", "cells", Benchmark_CellSetup, Benchmark_CellFlood, Benchmark_CellTeardown},
+};
+
+int main(int argc, char* argv[]) {
+    FBenchmarkOptions Options;
+    if (!Benchmark_ParseOptions(argc, argv, &Options)) {
+        return 2;
+    }
+
+    return Benchmark_RunAll(Benchmarks, sizeof Benchmarks / sizeof Benchmarks[0], &Options);
+}
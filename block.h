@@ -1,141 +1,109 @@
 #pragma once
-//
-// #ifdef __cplusplus
-// extern "C" {
-// #endif
-//
-// #include "malloc.h"
-// #include "chunk.h"
-// #include "containers/vector.h"
-//
-// #pragma pack(push, 1)
-// typedef struct {
-//     /** Block position. */
-//     FByteVector Position;
-//     /** Chunk that owns the block. */
-//     FChunk* ParentChunk;
-//     /** Parent bit, determines direction of the parent block. */
-//     Byte ParentBit;
-//     /** Children bits, determines direction of children blocks. */
-//     Byte ChildBits;
-//     /** Touching block bits, determine directions occupied by non-hierarchical but adjoined blocks. */
-//     Byte TouchingBits;
-//     /** Block type. */
-//     Byte Type;
-//     /** Block control flags. */
-//     Byte Flags;
-// } FBlock;
-// #pragma pack(pop)
-//
-// inline FBlock* Block_Create() {
-//     FBlock* Block = calloc(1, sizeof *Block);
-//     return Block;
-// }
-//
-// inline void Block_Destroy(FBlock* Block) {
-//     free(Block);
-// }
-//
-// inline U32 Block_GetId(FBlock* Block) {
-//     U32 Id = 0;
-//     Id |= Block->Position.X + 0x80;
-//     Id |= (Block->Position.Y + 0x80) << 0x08;
-//     Id |= (Block->Position.Y + 0x80) << 0x10;
-//     return Id;
-// }
-//
-// static U32 Block_PositionToId(const FByteVector Position) {
-//     U32 Id = 0;
-//     Id |= Position.X + 0x80;
-//     Id |= (Position.Y + 0x80) << 0x08;
-//     Id |= (Position.Y + 0x80) << 0x10;
-//     return Id;
-// }
-//
-// static FByteVector Block_IdToPosition(const U32 Id) {
-//     FByteVector Position;
-//     Position.X = (Id & 0x000000FF) - 0x80;
-//     Position.Y = ((Id & 0x0000FF00) >> 0x08) - 0x80;
-//     Position.Z = ((Id & 0x00FF0000) >> 0x10) - 0x80;
-//     return Position;
-// }
-//
-// inline void Block_SetParentBit(FBlock* Block, const enum EDirection Parent) {
-//     switch (Parent) {
-//     case XPositive:
-//         Block->ParentBit = 0b00000001;
-//         break;
-//     case XNegative:
-//         Block->ParentBit = 0b00000010;
-//         break;
-//     case YPositive:
-//         Block->ParentBit = 0b00000100;
-//         break;
-//     case YNegative:
-//         Block->ParentBit = 0b00001000;
-//         break;
-//     case ZPositive:
-//         Block->ParentBit = 0b00010000;
-//         break;
-//     case ZNegative:
-//         Block->ParentBit = 0b00100000;
-//         break;
-//     default:
-//         Block->ParentBit = 0b00000000;
-//         break;
-//     }
-// }
-//
-// inline void Block_SwitchChildBit(FBlock* Block, const EDirection Child) {
-//     switch (Child) {
-//     case XPositive:
-//         Block->ChildBits |= 0b00000001;
-//         break;
-//     case XNegative:
-//         Block->ChildBits |= 0b00000010;
-//         break;
-//     case YPositive:
-//         Block->ChildBits |= 0b00000100;
-//         break;
-//     case YNegative:
-//         Block->ChildBits |= 0b00001000;
-//         break;
-//     case ZPositive:
-//         Block->ChildBits |= 0b00010000;
-//         break;
-//     case ZNegative:
-//         Block->ChildBits |= 0b00100000;
-//         break;
-//     default:
-//         break;
-//     }
-// }
-//
-// inline void Block_SwitchTouchingBit(FBlock* Block, const EDirection Child) {
-//     switch (Child) {
-//     case XPositive:
-//         Block->TouchingBits |= 0b00000001;
-//         break;
-//     case XNegative:
-//         Block->TouchingBits |= 0b00000010;
-//         break;
-//     case YPositive:
-//         Block->TouchingBits |= 0b00000100;
-//         break;
-//     case YNegative:
-//         Block->TouchingBits |= 0b00001000;
-//         break;
-//     case ZPositive:
-//         Block->TouchingBits |= 0b00010000;
-//         break;
-//     case ZNegative:
-//         Block->TouchingBits |= 0b00100000;
-//         break;
-//     default:
-//         break;
-//     }
-// }
-//
-// #ifdef __cplusplus
-// }
-// #endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "typedefs.h"
+
+/** Block types, zero is empty space. */
+typedef enum {
+    BLOCK_TYPE_AIR = 0,
+    BLOCK_TYPE_STONE,
+    BLOCK_TYPE_DIRT,
+    BLOCK_TYPE_GRASS,
+    BLOCK_TYPE_SAND,
+    BLOCK_TYPE_WATER,
+    BLOCK_TYPE_LAMP,
+    BLOCK_TYPE_COUNT
+} EBlockType;
+
+/** Brightest light level, sunlight under the open sky. Levels fit a nibble. */
+#define BLOCK_LIGHT_MAX 15
+
+/** Bits of all six directions. */
+#define BLOCK_DIRECTION_BITS 0x3F
+
+/** Block is ground, structures connected to it through the block hierarchy are supported. Set on generated terrain. */
+#define BLOCK_FLAG_ANCHORED 0x01
+/** Block belongs to a structure cut off from the ground, see Connectivity_RemoveBlock. */
+#define BLOCK_FLAG_FLOATING 0x02
+
+/**
+ * Block stored in a chunk. Block position and owning chunk are implied by the block index in the FChunk block storage,
+ * so they are not stored per block.
+ */
+#pragma pack(push, 1)
+typedef struct {
+    /** Block type. */
+    Byte Type;
+    /** Block control flags. */
+    Byte Flags;
+    /** Parent bit, determines direction of the parent block. */
+    Byte ParentBit;
+    /** Children bits, determines direction of children blocks. */
+    Byte ChildBits;
+    /** Touching block bits, determine directions occupied by non-hierarchical but adjoined blocks. */
+    Byte TouchingBits;
+} FBlock;
+#pragma pack(pop)
+
+/** Block offsets along each EDirection. */
+static const I32 BlockDirectionOffsets[6][3] = {
+    {1, 0, 0}, {-1, 0, 0},
+    {0, 1, 0}, {0, -1, 0},
+    {0, 0, 1}, {0, 0, -1},
+};
+
+/** Returns True if the block is solid. */
+static inline Bool Block_IsSolid(const Byte Type) {
+    return Type != BLOCK_TYPE_AIR && Type != BLOCK_TYPE_WATER;
+}
+
+/** Returns the block light level the block type emits. */
+static inline Byte Block_GetEmission(const Byte Type) {
+    return Type == BLOCK_TYPE_LAMP ? BLOCK_LIGHT_MAX - 1 : 0;
+}
+
+/** Returns the bit of the direction, as used by ParentBit, ChildBits and TouchingBits. */
+static inline Byte Block_GetDirectionBit(const EDirection Direction) {
+    return (Byte)(1u << Direction);
+}
+
+/** Returns the direction of a single direction bit. */
+static inline EDirection Block_GetBitDirection(const Byte Bit) {
+    EDirection Direction = XPositive;
+    while (Direction < ZNegative && !(Bit & Block_GetDirectionBit(Direction))) {
+        Direction++;
+    }
+    return Direction;
+}
+
+/** Returns the opposite direction. */
+static inline EDirection Block_GetOppositeDirection(const EDirection Direction) {
+    return (EDirection)(Direction ^ 1);
+}
+
+static inline void Block_SetParentBit(FBlock* Block, const EDirection Parent) {
+    if (Parent >= XPositive && Parent <= ZNegative) {
+        Block->ParentBit = Block_GetDirectionBit(Parent);
+    } else {
+        Block->ParentBit = 0;
+    }
+}
+
+static inline void Block_SwitchChildBit(FBlock* Block, const EDirection Child) {
+    if (Child >= XPositive && Child <= ZNegative) {
+        Block->ChildBits |= Block_GetDirectionBit(Child);
+    }
+}
+
+static inline void Block_SwitchTouchingBit(FBlock* Block, const EDirection Child) {
+    if (Child >= XPositive && Child <= ZNegative) {
+        Block->TouchingBits |= Block_GetDirectionBit(Child);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
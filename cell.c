@@ -0,0 +1,834 @@
+#include "cell.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "block.h"
+#include "clock.h"
+#include "containers/vector.h"
+#include "thread.h"
+
+#pragma region Settings
+/** Maximum number of worker threads. */
+#define CELLS_MAX_WORKERS 16
+/** Chunk lookups remembered by a context, a power of two. */
+#define CELLS_CACHE_SIZE 16
+/** Initial capacity of the active cell set, a power of two. */
+#define CELLS_SET_CAPACITY 1024
+/** Chunk parities, a pass each. */
+#define CELLS_PASS_COUNT 8
+/** Type read for blocks of missing chunks, nothing moves into them. */
+#define CELLS_MISSING_TYPE BLOCK_TYPE_COUNT
+#pragma endregion
+
+/** Key of the empty slots of the active cell set, packed positions never have the top bit set. */
+#define CELLS_EMPTY_KEY (~0ull)
+
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+} FCellPosition;
+
+/** Block a job changed, at a world block position. */
+typedef struct {
+    FChunk* Chunk;
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Byte PreviousType;
+    Byte Type;
+} FCellChange;
+
+/** Move into another chunk, applied after the passes if both blocks are still what the job saw. */
+typedef struct {
+    FCellPosition From;
+    FCellPosition To;
+    Byte Type;
+    Byte TargetType;
+} FCellCrossing;
+
+/** Items of one chunk stepped by one thread, with the ranges of its results in the context that ran it. */
+typedef struct {
+    FChunk* Chunk;
+    U32 Begin;
+    U32 End;
+    U32 Context;
+    U32 ChangeBegin;
+    U32 ChangeEnd;
+    U32 CrossingBegin;
+    U32 CrossingEnd;
+} FCellJob;
+
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Bool bValid;
+    FChunk* Chunk;
+} FCellCacheEntry;
+
+/** Stepping state of one thread. */
+typedef struct {
+    const FWorld* World;
+    FCellCacheEntry Cache[CELLS_CACHE_SIZE];
+    FVector(FCellChange) Changes;
+    FVector(FCellCrossing) Crossings;
+    /** Blocks of the stepped chunk written this tick, a bit per block. They keep their place until the next tick. */
+    U64 Written[CHUNK_VOLUME / 64];
+    U32 MovedCells;
+} FCellContext;
+
+typedef struct {
+    FCells* Cells;
+    FThread* Thread;
+    U32 Index;
+} FCellWorker;
+
+struct FCells {
+    FWorld* World;
+    U32 MaxCellsPerTick;
+    CellBlockHandler OnBlockChanged;
+    void* UserData;
+
+    /** Active cells in activation order, the ones before the head were taken by a tick. */
+    FVector(FCellPosition) Active;
+    U32 ActiveHead;
+    /** Packed positions of the active cells, open addressing so a cell is queued once. */
+    U64* Keys;
+    U32 KeyCapacity;
+    U32 KeyCount;
+
+    /** Active cells taken by the tick as the chunk parity, the chunk and the block index from the top bits down. */
+    FVector(U64) Items;
+    FVector(U64) SortedItems;
+    /** Chunks of the taken cells by the ids in the items, and their slots by position, InvalidId when empty. */
+    FVector(FCellPosition) TickChunks;
+    U32* ChunkSlots;
+    U32 ChunkSlotCapacity;
+    FVector(FCellJob) Jobs;
+    U32 PassEnds[CELLS_PASS_COUNT];
+
+    /** Context of the ticking thread first, then one per worker. */
+    FCellContext Contexts[CELLS_MAX_WORKERS + 1];
+    FCellWorker Workers[CELLS_MAX_WORKERS];
+    U32 WorkerCount;
+    FMutex* Mutex;
+    FCondition* WorkStarted;
+    FCondition* WorkFinished;
+    /** Started passes count up so workers tell them apart. */
+    U32 Generation;
+    /** Jobs of the running pass. */
+    U32 NextJob;
+    U32 EndJob;
+    U32 UnfinishedJobs;
+    Bool bStopping;
+
+    FCellStats Stats;
+};
+
+#pragma region Private Function Declarations
+static int Cells_WorkerMain(void* UserData);
+
+/** Runs jobs of the running pass until none are left. */
+static void Cells_WorkJobs(FCells* Cells, U32 ContextIndex);
+
+/** Steps the items of the job in block index order, bottom up, so columns fall together. */
+static void Cells_RunJob(FCells* Cells, U32 ContextIndex, FCellJob* Job);
+
+/** Runs the jobs of each pass, the ones of a pass in parallel. */
+static void Cells_RunPasses(FCells* Cells);
+
+/** Takes the oldest active cells within the budget and groups them into a job per chunk, ordered by pass. */
+static void Cells_BuildJobs(FCells* Cells);
+
+/** Sorts the items by key, a byte per pass from the lowest, skipping bytes all keys share. */
+static void Cells_SortItems(FCells* Cells);
+
+/** Returns the id of the chunk among the chunks of the tick, adding it if it is new. */
+static U32 Cells_GetTickChunk(FCells* Cells, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+static inline U32 Cells_GetChunkSlot(const FCells* Cells, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    return ((U32)ChunkX * 0x8DA6B343u ^ (U32)ChunkY * 0xD8163841u ^ (U32)ChunkZ * 0xCB1AB31Fu) >> 12 & (Cells->ChunkSlotCapacity - 1);
+}
+
+/** Moves the water or sand block if a rule lets it. X, Y and Z are local to the chunk. */
+static void Cells_Step(FCellContext* Context, FChunk* Chunk, I32 X, I32 Y, I32 Z, U64 Tick);
+
+/** Swaps the block with the target block, recorded as a crossing when the target is in another chunk. */
+static void Cells_Move(FCellContext* Context, FChunk* Chunk, I32 X, I32 Y, I32 Z, I32 TargetX, I32 TargetY, I32 TargetZ, Byte TargetType);
+
+/** Returns the type of a block local to the chunk, beyond its borders too. */
+static Byte Cells_GetType(FCellContext* Context, const FChunk* Chunk, I32 X, I32 Y, I32 Z);
+
+static FChunk* Cells_GetChunk(FCellContext* Context, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Applies the crossing if its blocks didn't change since the job saw them, else its block tries again next tick. */
+static void Cells_ApplyCrossing(FCells* Cells, const FCellCrossing* Crossing);
+
+/** Activates the changed block and reports it. */
+static void Cells_OnChanged(FCells* Cells, FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte PreviousType);
+
+/** Sets the type of a block of the chunk at a world block position. */
+static void Cells_SetType(FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte Type);
+
+/** Queues the cell unless it is queued already. */
+static void Cells_Activate(FCells* Cells, I32 X, I32 Y, I32 Z);
+
+static inline U64 Cells_PackPosition(const I32 X, const I32 Y, const I32 Z) {
+    return ((U64)X & 0x1FFFFF) << 42 | ((U64)Y & 0x1FFFFF) << 21 | ((U64)Z & 0x1FFFFF);
+}
+
+static inline U32 Cells_GetSlot(const FCells* Cells, const U64 Key) {
+    return (U32)((Key * 0x9E3779B97F4A7C15ull) >> 32) & (Cells->KeyCapacity - 1);
+}
+
+/** Adds the key to the set. Returns False if it was there. */
+static Bool Cells_InsertKey(FCells* Cells, U64 Key);
+
+/** Removes the key, the following keys of its probe run shift back so lookups never stop early. */
+static void Cells_RemoveKey(FCells* Cells, U64 Key);
+
+static Bool Cells_GrowKeys(FCells* Cells);
+#pragma endregion
+
+#pragma region Public Function Definitions
+FCells* Cells_Create(FWorld* World, const U32 MaxCellsPerTick, U32 WorkerCount, const CellBlockHandler OnBlockChanged, void* UserData) {
+    FCells* Cells = calloc(1, sizeof(FCells));
+    if (Cells == NULL) {
+        return NULL;
+    }
+
+    Cells->World = World;
+    Cells->MaxCellsPerTick = MaxCellsPerTick > 0 ? MaxCellsPerTick : 1;
+    Cells->OnBlockChanged = OnBlockChanged;
+    Cells->UserData = UserData;
+    for (U32 Index = 0; Index <= CELLS_MAX_WORKERS; Index++) {
+        Cells->Contexts[Index].World = World;
+    }
+
+    // A tick takes a chunk per cell at most, the slots stay at most half full.
+    Cells->ChunkSlotCapacity = 64;
+    while (Cells->ChunkSlotCapacity < Cells->MaxCellsPerTick * 2) {
+        Cells->ChunkSlotCapacity *= 2;
+    }
+    Cells->ChunkSlots = malloc(Cells->ChunkSlotCapacity * sizeof(U32));
+    if (Cells->ChunkSlots != NULL) {
+        memset(Cells->ChunkSlots, 0xFF, Cells->ChunkSlotCapacity * sizeof(U32));
+    }
+
+    Cells->Mutex = Mutex_Create();
+    Cells->WorkStarted = Condition_Create();
+    Cells->WorkFinished = Condition_Create();
+    if (Cells->ChunkSlots == NULL || Cells->Mutex == NULL || Cells->WorkStarted == NULL || Cells->WorkFinished == NULL || !Cells_GrowKeys(Cells)) {
+        Cells_Destroy(Cells);
+        return NULL;
+    }
+
+    if (WorkerCount > CELLS_MAX_WORKERS) {
+        WorkerCount = CELLS_MAX_WORKERS;
+    }
+
+    for (U32 Index = 0; Index < WorkerCount; Index++) {
+        FCellWorker* Worker = &Cells->Workers[Index];
+        Worker->Cells = Cells;
+        Worker->Index = Index + 1;
+        Worker->Thread = Thread_Create(Cells_WorkerMain, "Cells", Worker);
+        if (Worker->Thread == NULL) {
+            fprintf(stderr, "Failed to start cell worker %u\n", Index);
+            break;
+        }
+        Cells->WorkerCount++;
+    }
+
+    return Cells;
+}
+
+void Cells_Destroy(FCells* Cells) {
+    if (Cells == NULL) {
+        return;
+    }
+
+    if (Cells->Mutex != NULL && Cells->WorkStarted != NULL) {
+        Mutex_Lock(Cells->Mutex);
+        Cells->bStopping = True;
+        Condition_Broadcast(Cells->WorkStarted);
+        Mutex_Unlock(Cells->Mutex);
+    }
+
+    for (U32 Index = 0; Index < Cells->WorkerCount; Index++) {
+        Thread_Join(Cells->Workers[Index].Thread);
+    }
+
+    for (U32 Index = 0; Index <= CELLS_MAX_WORKERS; Index++) {
+        FVector_Free(Cells->Contexts[Index].Changes);
+        FVector_Free(Cells->Contexts[Index].Crossings);
+    }
+
+    if (Cells->WorkFinished != NULL) {
+        Condition_Destroy(Cells->WorkFinished);
+    }
+    if (Cells->WorkStarted != NULL) {
+        Condition_Destroy(Cells->WorkStarted);
+    }
+    if (Cells->Mutex != NULL) {
+        Mutex_Destroy(Cells->Mutex);
+    }
+    FVector_Free(Cells->Jobs);
+    FVector_Free(Cells->TickChunks);
+    FVector_Free(Cells->SortedItems);
+    FVector_Free(Cells->Items);
+    free(Cells->ChunkSlots);
+    FVector_Free(Cells->Active);
+    free(Cells->Keys);
+    free(Cells);
+}
+
+void Cells_ActivateBlock(FCells* Cells, const I32 X, const I32 Y, const I32 Z) {
+    Cells_Activate(Cells, X, Y, Z);
+    for (U32 Direction = 0; Direction < 6; Direction++) {
+        Cells_Activate(Cells, X + BlockDirectionOffsets[Direction][0], Y + BlockDirectionOffsets[Direction][1], Z + BlockDirectionOffsets[Direction][2]);
+    }
+}
+
+Bool Cells_IsPending(const FCells* Cells) {
+    return Cells->KeyCount > 0;
+}
+
+void Cells_Tick(FCells* Cells) {
+    Cells->Stats.SteppedCells = 0;
+    Cells->Stats.MovedCells = 0;
+    Cells->Stats.Jobs = 0;
+    Cells->Stats.Nanoseconds = 0;
+    if (Cells->KeyCount == 0) {
+        return;
+    }
+
+    const U64 Start = Clock_GetNanoseconds();
+    Cells_BuildJobs(Cells);
+    Cells_RunPasses(Cells);
+
+    // The handler expects one block changed at a time, so the changes are undone and redone one by one. Jobs never
+    // change the same block, the order of the undo doesn't matter.
+    if (Cells->OnBlockChanged != NULL) {
+        for (U32 Index = 0; Index <= Cells->WorkerCount; Index++) {
+            const FCellContext* Context = &Cells->Contexts[Index];
+            for (size_t Change = 0; Change < FVector_GetSize(Context->Changes); Change++) {
+                const FCellChange* Item = &Context->Changes[Change];
+                Cells_SetType(Item->Chunk, Item->X, Item->Y, Item->Z, Item->PreviousType);
+            }
+        }
+    }
+
+    // Results are read in job order, not in the order the threads finished, so a tick always has the same outcome.
+    for (size_t Index = 0; Index < FVector_GetSize(Cells->Jobs); Index++) {
+        const FCellJob* Job = &Cells->Jobs[Index];
+        const FCellContext* Context = &Cells->Contexts[Job->Context];
+        for (U32 Change = Job->ChangeBegin; Change < Job->ChangeEnd; Change++) {
+            const FCellChange* Item = &Context->Changes[Change];
+            Cells_SetType(Item->Chunk, Item->X, Item->Y, Item->Z, Item->Type);
+            Cells_OnChanged(Cells, Item->Chunk, Item->X, Item->Y, Item->Z, Item->PreviousType);
+        }
+    }
+
+    // Chunks of the passes are done, moves between them can't race anymore.
+    for (size_t Index = 0; Index < FVector_GetSize(Cells->Jobs); Index++) {
+        const FCellJob* Job = &Cells->Jobs[Index];
+        const FCellContext* Context = &Cells->Contexts[Job->Context];
+        for (U32 Crossing = Job->CrossingBegin; Crossing < Job->CrossingEnd; Crossing++) {
+            Cells_ApplyCrossing(Cells, &Context->Crossings[Crossing]);
+        }
+    }
+
+    for (U32 Index = 0; Index <= Cells->WorkerCount; Index++) {
+        FCellContext* Context = &Cells->Contexts[Index];
+        Cells->Stats.MovedCells += Context->MovedCells;
+        Context->MovedCells = 0;
+        FVector_Clear(Context->Changes);
+        FVector_Clear(Context->Crossings);
+    }
+
+    Cells->Stats.Jobs = (U32)FVector_GetSize(Cells->Jobs);
+    Cells->Stats.ActiveCells = Cells->KeyCount;
+    Cells->Stats.Ticks++;
+    Cells->Stats.Nanoseconds = Clock_GetNanoseconds() - Start;
+}
+
+void Cells_GetStats(const FCells* Cells, FCellStats* OutStats) {
+    *OutStats = Cells->Stats;
+    OutStats->ActiveCells = Cells->KeyCount;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+int Cells_WorkerMain(void* UserData) {
+    FCellWorker* Worker = UserData;
+    FCells* Cells = Worker->Cells;
+
+    U32 Generation = 0;
+    Mutex_Lock(Cells->Mutex);
+    for (;;) {
+        while (Cells->Generation == Generation && !Cells->bStopping) {
+            Condition_Wait(Cells->WorkStarted, Cells->Mutex);
+        }
+
+        if (Cells->bStopping) {
+            break;
+        }
+
+        Generation = Cells->Generation;
+        Mutex_Unlock(Cells->Mutex);
+        Cells_WorkJobs(Cells, Worker->Index);
+        Mutex_Lock(Cells->Mutex);
+    }
+    Mutex_Unlock(Cells->Mutex);
+
+    return 0;
+}
+
+void Cells_WorkJobs(FCells* Cells, const U32 ContextIndex) {
+    Mutex_Lock(Cells->Mutex);
+    while (Cells->NextJob < Cells->EndJob) {
+        FCellJob* Job = &Cells->Jobs[Cells->NextJob++];
+        Mutex_Unlock(Cells->Mutex);
+
+        Cells_RunJob(Cells, ContextIndex, Job);
+
+        Mutex_Lock(Cells->Mutex);
+        if (--Cells->UnfinishedJobs == 0) {
+            Condition_Signal(Cells->WorkFinished);
+        }
+    }
+    Mutex_Unlock(Cells->Mutex);
+}
+
+void Cells_RunJob(FCells* Cells, const U32 ContextIndex, FCellJob* Job) {
+    FCellContext* Context = &Cells->Contexts[ContextIndex];
+
+    // Chunks come and go between ticks.
+    memset(Context->Cache, 0, sizeof Context->Cache);
+    memset(Context->Written, 0, sizeof Context->Written);
+
+    Job->Context = ContextIndex;
+    Job->ChangeBegin = (U32)FVector_GetSize(Context->Changes);
+    Job->CrossingBegin = (U32)FVector_GetSize(Context->Crossings);
+
+    for (U32 Index = Job->Begin; Index < Job->End; Index++) {
+        const U32 BlockIndex = (U32)(Cells->Items[Index] & (CHUNK_VOLUME - 1));
+        const I32 X = (I32)(BlockIndex % CHUNK_SIZE);
+        const I32 Z = (I32)(BlockIndex / CHUNK_SIZE % CHUNK_SIZE);
+        const I32 Y = (I32)(BlockIndex / CHUNK_AREA);
+        Cells_Step(Context, Job->Chunk, X, Y, Z, Cells->Stats.Ticks);
+    }
+
+    Job->ChangeEnd = (U32)FVector_GetSize(Context->Changes);
+    Job->CrossingEnd = (U32)FVector_GetSize(Context->Crossings);
+}
+
+void Cells_RunPasses(FCells* Cells) {
+    U32 PassBegin = 0;
+    for (U32 Pass = 0; Pass < CELLS_PASS_COUNT; Pass++) {
+        const U32 PassEnd = Cells->PassEnds[Pass];
+        if (Cells->WorkerCount == 0 || PassEnd - PassBegin <= 1) {
+            for (U32 Index = PassBegin; Index < PassEnd; Index++) {
+                Cells_RunJob(Cells, 0, &Cells->Jobs[Index]);
+            }
+        } else {
+            Mutex_Lock(Cells->Mutex);
+            Cells->NextJob = PassBegin;
+            Cells->EndJob = PassEnd;
+            Cells->UnfinishedJobs = PassEnd - PassBegin;
+            Cells->Generation++;
+            Condition_Broadcast(Cells->WorkStarted);
+            Mutex_Unlock(Cells->Mutex);
+
+            Cells_WorkJobs(Cells, 0);
+
+            // The next pass steps the neighbours of these chunks, it waits for every job of this one.
+            Mutex_Lock(Cells->Mutex);
+            while (Cells->UnfinishedJobs > 0) {
+                Condition_Wait(Cells->WorkFinished, Cells->Mutex);
+            }
+            Mutex_Unlock(Cells->Mutex);
+        }
+        PassBegin = PassEnd;
+    }
+}
+
+void Cells_BuildJobs(FCells* Cells) {
+    const U32 Available = (U32)FVector_GetSize(Cells->Active) - Cells->ActiveHead;
+    const U32 Count = Available < Cells->MaxCellsPerTick ? Available : Cells->MaxCellsPerTick;
+
+    FVector_Clear(Cells->Items);
+    FVector_Clear(Cells->TickChunks);
+    FVector_Clear(Cells->Jobs);
+    FVector_Reserve(Cells->Items, Count);
+    for (U32 Index = 0; Index < Count; Index++) {
+        const FCellPosition Position = Cells->Active[Cells->ActiveHead + Index];
+        Cells_RemoveKey(Cells, Cells_PackPosition(Position.X, Position.Y, Position.Z));
+
+        const I32 ChunkX = World_GetChunkCoordinate(Position.X);
+        const I32 ChunkY = World_GetChunkCoordinate(Position.Y);
+        const I32 ChunkZ = World_GetChunkCoordinate(Position.Z);
+        const U64 Parity = (U64)(ChunkX & 1) | (U64)(ChunkY & 1) << 1 | (U64)(ChunkZ & 1) << 2;
+        const U64 Chunk = Cells_GetTickChunk(Cells, ChunkX, ChunkY, ChunkZ);
+        const U64 Item = Parity << 56 | Chunk << 15 | Chunk_GetBlockIndex(Position.X - ChunkX * CHUNK_SIZE, Position.Y - ChunkY * CHUNK_SIZE, Position.Z - ChunkZ * CHUNK_SIZE);
+        FVector_Add(Cells->Items, Item);
+    }
+
+    for (size_t Index = 0; Index < FVector_GetSize(Cells->TickChunks); Index++) {
+        const FCellPosition* Chunk = &Cells->TickChunks[Index];
+        U32 Slot = Cells_GetChunkSlot(Cells, Chunk->X, Chunk->Y, Chunk->Z);
+        while (Cells->ChunkSlots[Slot] != Index) {
+            Slot = (Slot + 1) & (Cells->ChunkSlotCapacity - 1);
+        }
+        Cells->ChunkSlots[Slot] = InvalidId;
+    }
+    Cells->ActiveHead += Count;
+    Cells->Stats.SteppedCells = Count;
+
+    // Cells left over carry to the next ticks, the taken ones are dropped once they are half of the vector.
+    const U32 Remaining = (U32)FVector_GetSize(Cells->Active) - Cells->ActiveHead;
+    if (Cells->ActiveHead >= Remaining) {
+        memmove(Cells->Active, Cells->Active + Cells->ActiveHead, Remaining * sizeof(FCellPosition));
+        FVector_SetSize(Cells->Active, Remaining);
+        Cells->ActiveHead = 0;
+    }
+
+    // Sorted by key the items of a chunk are contiguous and bottom up, and the chunks ordered by pass.
+    Cells_SortItems(Cells);
+
+    U32 Pass = 0;
+    for (U32 Begin = 0; Begin < Count;) {
+        const U64 First = Cells->Items[Begin];
+        U32 End = Begin + 1;
+        while (End < Count && Cells->Items[End] >> 15 == First >> 15) {
+            End++;
+        }
+
+        const U32 Parity = (U32)(First >> 56);
+        const FCellPosition* TickChunk = &Cells->TickChunks[First >> 15 & 0xFFFFFFFF];
+        while (Pass < Parity) {
+            Cells->PassEnds[Pass++] = (U32)FVector_GetSize(Cells->Jobs);
+        }
+
+        // Cells of chunks evicted since their activation are dropped.
+        FChunk* Chunk = World_GetChunk(Cells->World, TickChunk->X, TickChunk->Y, TickChunk->Z);
+        if (Chunk != NULL) {
+            const FCellJob Job = {Chunk, Begin, End};
+            if (FVector_GetSize(Cells->Jobs) == FVector_GetCapacity(Cells->Jobs)) {
+                const size_t Capacity = FVector_GetCapacity(Cells->Jobs) * 2 + 64;
+                FVector_Reserve(Cells->Jobs, Capacity);
+            }
+            FVector_Add(Cells->Jobs, Job);
+        }
+        Begin = End;
+    }
+    while (Pass < CELLS_PASS_COUNT) {
+        Cells->PassEnds[Pass++] = (U32)FVector_GetSize(Cells->Jobs);
+    }
+}
+
+void Cells_SortItems(FCells* Cells) {
+    const size_t Count = FVector_GetSize(Cells->Items);
+    FVector_Reserve(Cells->SortedItems, Count);
+    FVector_SetSize(Cells->SortedItems, Count);
+
+    U64 Different = 0;
+    for (size_t Index = 1; Index < Count; Index++) {
+        Different |= Cells->Items[Index] ^ Cells->Items[0];
+    }
+
+    for (U32 Shift = 0; Shift < 64; Shift += 8) {
+        if ((Different >> Shift & 0xFF) == 0) {
+            continue;
+        }
+
+        U32 Offsets[256] = {0};
+        for (size_t Index = 0; Index < Count; Index++) {
+            Offsets[Cells->Items[Index] >> Shift & 0xFF]++;
+        }
+        U32 Offset = 0;
+        for (U32 Digit = 0; Digit < 256; Digit++) {
+            const U32 Size = Offsets[Digit];
+            Offsets[Digit] = Offset;
+            Offset += Size;
+        }
+        for (size_t Index = 0; Index < Count; Index++) {
+            Cells->SortedItems[Offsets[Cells->Items[Index] >> Shift & 0xFF]++] = Cells->Items[Index];
+        }
+
+        U64* Items = Cells->Items;
+        Cells->Items = Cells->SortedItems;
+        Cells->SortedItems = Items;
+    }
+}
+
+U32 Cells_GetTickChunk(FCells* Cells, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    U32 Slot = Cells_GetChunkSlot(Cells, ChunkX, ChunkY, ChunkZ);
+    for (;; Slot = (Slot + 1) & (Cells->ChunkSlotCapacity - 1)) {
+        const U32 Chunk = Cells->ChunkSlots[Slot];
+        if (Chunk == InvalidId) {
+            break;
+        }
+
+        const FCellPosition* TickChunk = &Cells->TickChunks[Chunk];
+        if (TickChunk->X == ChunkX && TickChunk->Y == ChunkY && TickChunk->Z == ChunkZ) {
+            return Chunk;
+        }
+    }
+
+    const FCellPosition TickChunk = {ChunkX, ChunkY, ChunkZ};
+    if (FVector_GetSize(Cells->TickChunks) == FVector_GetCapacity(Cells->TickChunks)) {
+        const size_t Capacity = FVector_GetCapacity(Cells->TickChunks) * 2 + 64;
+        FVector_Reserve(Cells->TickChunks, Capacity);
+    }
+    FVector_Add(Cells->TickChunks, TickChunk);
+    Cells->ChunkSlots[Slot] = (U32)FVector_GetSize(Cells->TickChunks) - 1;
+
+    return Cells->ChunkSlots[Slot];
+}
+
+void Cells_Step(FCellContext* Context, FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const U64 Tick) {
+    static const I32 SideOffsets[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+
+    const U32 Index = Chunk_GetBlockIndex(X, Y, Z);
+    if (Context->Written[Index / 64] >> (Index % 64) & 1) {
+        return;
+    }
+
+    const Byte Type = Chunk->Blocks[Index].Type;
+    if (Type != BLOCK_TYPE_WATER && Type != BLOCK_TYPE_SAND) {
+        return;
+    }
+
+    const Byte Below = Cells_GetType(Context, Chunk, X, Y - 1, Z);
+    if (Below == BLOCK_TYPE_AIR || (Type == BLOCK_TYPE_SAND && Below == BLOCK_TYPE_WATER)) {
+        Cells_Move(Context, Chunk, X, Y, Z, X, Y - 1, Z, Below);
+        return;
+    }
+
+    // Sides are tried from a direction hashed from the position and tick, no side is favoured and replays match.
+    const U32 First = ((U32)(Chunk->X * CHUNK_SIZE + X) * 0x8DA6B343u ^ (U32)(Chunk->Y * CHUNK_SIZE + Y) * 0xD8163841u ^
+                       (U32)(Chunk->Z * CHUNK_SIZE + Z) * 0xCB1AB31Fu ^ (U32)Tick * 0x9E3779B9u) >> 30;
+    const Bool bPressed = Type == BLOCK_TYPE_WATER && (Below == BLOCK_TYPE_WATER || Cells_GetType(Context, Chunk, X, Y + 1, Z) == BLOCK_TYPE_WATER);
+    for (U32 Side = 0; Side < 4; Side++) {
+        const I32 SideX = X + SideOffsets[(First + Side) & 3][0];
+        const I32 SideZ = Z + SideOffsets[(First + Side) & 3][1];
+        if (Cells_GetType(Context, Chunk, SideX, Y, SideZ) != BLOCK_TYPE_AIR) {
+            continue;
+        }
+
+        const Byte SideBelow = Cells_GetType(Context, Chunk, SideX, Y - 1, SideZ);
+        if (Type == BLOCK_TYPE_SAND) {
+            // Sand slides down slopes steeper than one block per block.
+            if (SideBelow == BLOCK_TYPE_AIR) {
+                Cells_Move(Context, Chunk, X, Y, Z, SideX, Y - 1, SideZ, BLOCK_TYPE_AIR);
+                return;
+            }
+        } else if (SideBelow == BLOCK_TYPE_AIR || (bPressed && SideBelow != BLOCK_TYPE_WATER && SideBelow != CELLS_MISSING_TYPE)) {
+            // Water with water above or below it spreads over the ground, so piles level out into sheets. Spreading
+            // over other water wouldn't lower anything, a block on a lake stays put instead of wandering.
+            Cells_Move(Context, Chunk, X, Y, Z, SideX, Y, SideZ, BLOCK_TYPE_AIR);
+            return;
+        }
+    }
+}
+
+void Cells_Move(FCellContext* Context, FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const I32 TargetX, const I32 TargetY, const I32 TargetZ,
+                const Byte TargetType) {
+    const I32 OriginX = Chunk->X * CHUNK_SIZE;
+    const I32 OriginY = Chunk->Y * CHUNK_SIZE;
+    const I32 OriginZ = Chunk->Z * CHUNK_SIZE;
+    const Byte Type = Chunk_GetBlockType(Chunk, X, Y, Z);
+
+    if (!Chunk_IsInside(TargetX, TargetY, TargetZ)) {
+        const FCellCrossing Crossing = {
+            {OriginX + X, OriginY + Y, OriginZ + Z},
+            {OriginX + TargetX, OriginY + TargetY, OriginZ + TargetZ},
+            Type,
+            TargetType,
+        };
+        if (FVector_GetSize(Context->Crossings) == FVector_GetCapacity(Context->Crossings)) {
+            const size_t Capacity = FVector_GetCapacity(Context->Crossings) * 2 + 64;
+            FVector_Reserve(Context->Crossings, Capacity);
+        }
+        FVector_Add(Context->Crossings, Crossing);
+        return;
+    }
+
+    Chunk_SetBlockType(Chunk, TargetX, TargetY, TargetZ, Type);
+    Chunk_SetBlockType(Chunk, X, Y, Z, TargetType);
+
+    const U32 Index = Chunk_GetBlockIndex(X, Y, Z);
+    const U32 TargetIndex = Chunk_GetBlockIndex(TargetX, TargetY, TargetZ);
+    Context->Written[Index / 64] |= 1ull << (Index % 64);
+    Context->Written[TargetIndex / 64] |= 1ull << (TargetIndex % 64);
+    Context->MovedCells++;
+
+    const FCellChange Changes[2] = {
+        {Chunk, OriginX + X, OriginY + Y, OriginZ + Z, Type, TargetType},
+        {Chunk, OriginX + TargetX, OriginY + TargetY, OriginZ + TargetZ, TargetType, Type},
+    };
+    for (U32 Change = 0; Change < 2; Change++) {
+        if (FVector_GetSize(Context->Changes) == FVector_GetCapacity(Context->Changes)) {
+            const size_t Capacity = FVector_GetCapacity(Context->Changes) * 2 + 64;
+            FVector_Reserve(Context->Changes, Capacity);
+        }
+        FVector_Add(Context->Changes, Changes[Change]);
+    }
+}
+
+Byte Cells_GetType(FCellContext* Context, const FChunk* Chunk, const I32 X, const I32 Y, const I32 Z) {
+    if (Chunk_IsInside(X, Y, Z)) {
+        return Chunk_GetBlockType(Chunk, X, Y, Z);
+    }
+
+    const I32 WorldX = Chunk->X * CHUNK_SIZE + X;
+    const I32 WorldY = Chunk->Y * CHUNK_SIZE + Y;
+    const I32 WorldZ = Chunk->Z * CHUNK_SIZE + Z;
+    const FChunk* Neighbour =
+        Cells_GetChunk(Context, World_GetChunkCoordinate(WorldX), World_GetChunkCoordinate(WorldY), World_GetChunkCoordinate(WorldZ));
+    if (Neighbour == NULL) {
+        return CELLS_MISSING_TYPE;
+    }
+
+    return Chunk_GetBlockType(Neighbour, World_GetLocalCoordinate(WorldX), World_GetLocalCoordinate(WorldY), World_GetLocalCoordinate(WorldZ));
+}
+
+FChunk* Cells_GetChunk(FCellContext* Context, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    const U32 Slot = ((U32)ChunkX * 0x8DA6B343u ^ (U32)ChunkY * 0xD8163841u ^ (U32)ChunkZ * 0xCB1AB31Fu) >> 28 & (CELLS_CACHE_SIZE - 1);
+    FCellCacheEntry* Entry = &Context->Cache[Slot];
+    if (!Entry->bValid || Entry->X != ChunkX || Entry->Y != ChunkY || Entry->Z != ChunkZ) {
+        *Entry = (FCellCacheEntry){ChunkX, ChunkY, ChunkZ, True, World_GetChunk(Context->World, ChunkX, ChunkY, ChunkZ)};
+    }
+
+    return Entry->Chunk;
+}
+
+void Cells_ApplyCrossing(FCells* Cells, const FCellCrossing* Crossing) {
+    const FCellPosition* From = &Crossing->From;
+    const FCellPosition* To = &Crossing->To;
+    FChunk* FromChunk = World_GetChunk(Cells->World, World_GetChunkCoordinate(From->X), World_GetChunkCoordinate(From->Y), World_GetChunkCoordinate(From->Z));
+    FChunk* ToChunk = World_GetChunk(Cells->World, World_GetChunkCoordinate(To->X), World_GetChunkCoordinate(To->Y), World_GetChunkCoordinate(To->Z));
+    const I32 FromX = World_GetLocalCoordinate(From->X);
+    const I32 FromY = World_GetLocalCoordinate(From->Y);
+    const I32 FromZ = World_GetLocalCoordinate(From->Z);
+    const I32 ToX = World_GetLocalCoordinate(To->X);
+    const I32 ToY = World_GetLocalCoordinate(To->Y);
+    const I32 ToZ = World_GetLocalCoordinate(To->Z);
+
+    // Another move may have taken the target or moved the block away during the passes.
+    if (ToChunk == NULL || Chunk_GetBlockType(FromChunk, FromX, FromY, FromZ) != Crossing->Type ||
+        Chunk_GetBlockType(ToChunk, ToX, ToY, ToZ) != Crossing->TargetType) {
+        Cells_Activate(Cells, From->X, From->Y, From->Z);
+        return;
+    }
+
+    Cells->Stats.MovedCells++;
+    Chunk_SetBlockType(FromChunk, FromX, FromY, FromZ, Crossing->TargetType);
+    Cells_OnChanged(Cells, FromChunk, From->X, From->Y, From->Z, Crossing->Type);
+    Chunk_SetBlockType(ToChunk, ToX, ToY, ToZ, Crossing->Type);
+    Cells_OnChanged(Cells, ToChunk, To->X, To->Y, To->Z, Crossing->TargetType);
+}
+
+void Cells_SetType(FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+}
+
+void Cells_OnChanged(FCells* Cells, FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const Byte PreviousType) {
+    Cells_ActivateBlock(Cells, X, Y, Z);
+    if (Cells->OnBlockChanged != NULL) {
+        Cells->OnBlockChanged(Chunk, X, Y, Z, PreviousType, Cells->UserData);
+    }
+}
+
+void Cells_Activate(FCells* Cells, const I32 X, const I32 Y, const I32 Z) {
+    if (!Cells_InsertKey(Cells, Cells_PackPosition(X, Y, Z))) {
+        return;
+    }
+
+    const FCellPosition Position = {X, Y, Z};
+    if (FVector_GetSize(Cells->Active) == FVector_GetCapacity(Cells->Active)) {
+        const size_t Capacity = FVector_GetCapacity(Cells->Active) * 2 + 64;
+        FVector_Reserve(Cells->Active, Capacity);
+    }
+    FVector_Add(Cells->Active, Position);
+}
+
+Bool Cells_InsertKey(FCells* Cells, const U64 Key) {
+    // Kept at most half full, probe runs stay short.
+    if ((Cells->KeyCount + 1) * 2 > Cells->KeyCapacity && !Cells_GrowKeys(Cells)) {
+        fprintf(stderr, "Failed to grow the active cell set\n");
+        return False;
+    }
+
+    U32 Slot = Cells_GetSlot(Cells, Key);
+    while (Cells->Keys[Slot] != CELLS_EMPTY_KEY) {
+        if (Cells->Keys[Slot] == Key) {
+            return False;
+        }
+        Slot = (Slot + 1) & (Cells->KeyCapacity - 1);
+    }
+
+    Cells->Keys[Slot] = Key;
+    Cells->KeyCount++;
+    return True;
+}
+
+void Cells_RemoveKey(FCells* Cells, const U64 Key) {
+    const U32 Mask = Cells->KeyCapacity - 1;
+    U32 Slot = Cells_GetSlot(Cells, Key);
+    while (Cells->Keys[Slot] != Key) {
+        if (Cells->Keys[Slot] == CELLS_EMPTY_KEY) {
+            return;
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+
+    Cells->KeyCount--;
+    for (U32 Next = (Slot + 1) & Mask;; Next = (Next + 1) & Mask) {
+        const U64 NextKey = Cells->Keys[Next];
+        if (NextKey == CELLS_EMPTY_KEY) {
+            break;
+        }
+
+        // A key moves into the hole unless its home slot lies cyclically after the hole and up to its current slot.
+        const U32 Home = Cells_GetSlot(Cells, NextKey);
+        if (((Next - Home) & Mask) >= ((Next - Slot) & Mask)) {
+            Cells->Keys[Slot] = NextKey;
+            Slot = Next;
+        }
+    }
+    Cells->Keys[Slot] = CELLS_EMPTY_KEY;
+}
+
+Bool Cells_GrowKeys(FCells* Cells) {
+    const U32 OldCapacity = Cells->KeyCapacity;
+    const U32 Capacity = OldCapacity > 0 ? OldCapacity * 2 : CELLS_SET_CAPACITY;
+    U64* Keys = malloc(Capacity * sizeof(U64));
+    if (Keys == NULL) {
+        return False;
+    }
+    memset(Keys, 0xFF, Capacity * sizeof(U64));
+
+    U64* OldKeys = Cells->Keys;
+    Cells->Keys = Keys;
+    Cells->KeyCapacity = Capacity;
+    for (U32 Slot = 0; Slot < OldCapacity; Slot++) {
+        if (OldKeys[Slot] == CELLS_EMPTY_KEY) {
+            continue;
+        }
+
+        U32 NewSlot = Cells_GetSlot(Cells, OldKeys[Slot]);
+        while (Keys[NewSlot] != CELLS_EMPTY_KEY) {
+            NewSlot = (NewSlot + 1) & (Capacity - 1);
+        }
+        Keys[NewSlot] = OldKeys[Slot];
+    }
+    free(OldKeys);
+
+    return True;
+}
+#pragma endregion
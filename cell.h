@@ -1 +1,51 @@
 #pragma once
+#include "typedefs.h"
+#include "world.h"
+
+/**
+ * Cellular automaton moving water and sand through the blocks of a world. Only active cells are stepped, the blocks
+ * changed by the last tick and by edits with their neighbours, so settled water costs nothing. Water falls and spreads
+ * sideways off other water, sand falls through air and water and slides down slopes. Blocks are moved, never created
+ * or destroyed.
+ */
+typedef struct FCells FCells;
+
+/** Called on the ticking thread for each block a tick changed, with the world block position and the type it had. */
+typedef void (*CellBlockHandler)(FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte PreviousType, void* UserData);
+
+typedef struct {
+    /** Active cells waiting for a tick, including the ones the last tick had no budget for. */
+    U32 ActiveCells;
+    /** Cells stepped by the last tick and the cells among them that moved. */
+    U32 SteppedCells;
+    U32 MovedCells;
+    /** Chunks stepped by the last tick, each by one thread. */
+    U32 Jobs;
+    U64 Nanoseconds;
+    /** Ticks run since the automaton was created. */
+    U64 Ticks;
+} FCellStats;
+
+/**
+ * Creates the automaton and starts its workers, 0 steps on the ticking thread only. A tick steps the cells activated
+ * first, at most the budget, the rest carries over to the next ticks. Returns NULL on failure.
+ */
+FCells* Cells_Create(FWorld* World, U32 MaxCellsPerTick, U32 WorkerCount, CellBlockHandler OnBlockChanged, void* UserData);
+
+/** Stops the workers and frees the active cells. */
+void Cells_Destroy(FCells* Cells);
+
+/** Activates the block at the world block position and its six neighbours, after the block changed. */
+void Cells_ActivateBlock(FCells* Cells, I32 X, I32 Y, I32 Z);
+
+/** Returns True when cells are active. */
+Bool Cells_IsPending(const FCells* Cells);
+
+/**
+ * Steps the active cells within the budget. Chunks are stepped in eight passes by the parity of their coordinates, the
+ * chunks of a pass never touch, so each is stepped by one thread without locks. Moves across chunk borders are applied
+ * after the passes. The blocks of the world must not be read by other threads meanwhile.
+ */
+void Cells_Tick(FCells* Cells);
+
+void Cells_GetStats(const FCells* Cells, FCellStats* OutStats);
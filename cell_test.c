@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "cell.h"
+#include "check.h"
+
+#pragma region Settings
+/** 2x1x2 chunks with a stone floor and one chunk on top of the first. */
+#define CELL_TEST_CHUNKS 5
+#define CELL_TEST_CELLS_PER_TICK 4096
+#define CELL_TEST_MAX_TICKS 200
+#pragma endregion
+
+typedef struct {
+    FChunk* Chunks[CELL_TEST_CHUNKS];
+    FWorld* World;
+    FCells* Cells;
+    /** Blocks reported changed by the ticks. */
+    U32 ChangedBlocks;
+} FCellTest;
+
+#pragma region Private Function Declarations
+static void CellTest_Create(FCellTest* Test, U32 WorkerCount);
+static void CellTest_Destroy(FCellTest* Test);
+static void CellTest_OnBlockChanged(FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte PreviousType, void* UserData);
+static void CellTest_Set(FCellTest* Test, I32 X, I32 Y, I32 Z, Byte Type);
+static U32 CellTest_Count(const FCellTest* Test, Byte Type);
+static void CellTest_Settle(FCellTest* Test);
+static void CellTest_Place(FCellTest* Test);
+static void CellTest_Steps(FCellTest* Test);
+#pragma endregion
+
+int main() {
+    FCellTest Test;
+    CellTest_Create(&Test, 0);
+    CellTest_Steps(&Test);
+    CellTest_Destroy(&Test);
+
+    // Settling on the ticking thread alone and with workers moves every block to the same place.
+    FCellTest Serial;
+    FCellTest Parallel;
+    CellTest_Create(&Serial, 0);
+    CellTest_Create(&Parallel, 2);
+    CellTest_Place(&Serial);
+    CellTest_Place(&Parallel);
+    const U32 Sand = CellTest_Count(&Serial, BLOCK_TYPE_SAND);
+    const U32 Water = CellTest_Count(&Serial, BLOCK_TYPE_WATER);
+    CellTest_Settle(&Serial);
+    CellTest_Settle(&Parallel);
+
+    // Blocks are moved, never created or destroyed.
+    CHECK(CellTest_Count(&Serial, BLOCK_TYPE_SAND) == Sand && CellTest_Count(&Serial, BLOCK_TYPE_WATER) == Water);
+    for (U32 Index = 0; Index < CELL_TEST_CHUNKS; Index++) {
+        CHECK(memcmp(Serial.Chunks[Index]->Blocks, Parallel.Chunks[Index]->Blocks, sizeof Serial.Chunks[Index]->Blocks) == 0);
+    }
+    CHECK(Serial.ChangedBlocks == Parallel.ChangedBlocks && Serial.ChangedBlocks > 0);
+
+    CellTest_Destroy(&Serial);
+    CellTest_Destroy(&Parallel);
+
+    printf("cell_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void CellTest_Create(FCellTest* Test, const U32 WorkerCount) {
+    Test->World = World_Create();
+    CHECK(Test->World != NULL);
+    Test->ChangedBlocks = 0;
+
+    for (I32 Index = 0; Index < CELL_TEST_CHUNKS; Index++) {
+        FChunk* Chunk = Index < 4 ? Chunk_Create(Index & 1, 0, Index >> 1) : Chunk_Create(0, 1, 0);
+        CHECK(Chunk != NULL);
+        if (Index < 4) {
+            for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+                for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                    Chunk_SetBlockType(Chunk, X, 0, Z, BLOCK_TYPE_STONE);
+                }
+            }
+        }
+        World_AddChunk(Test->World, Chunk);
+        Test->Chunks[Index] = Chunk;
+    }
+
+    Test->Cells = Cells_Create(Test->World, CELL_TEST_CELLS_PER_TICK, WorkerCount, CellTest_OnBlockChanged, Test);
+    CHECK(Test->Cells != NULL);
+}
+
+void CellTest_Destroy(FCellTest* Test) {
+    Cells_Destroy(Test->Cells);
+    World_Destroy(Test->World);
+    for (U32 Index = 0; Index < CELL_TEST_CHUNKS; Index++) {
+        Chunk_Destroy(Test->Chunks[Index]);
+    }
+}
+
+void CellTest_OnBlockChanged(FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const Byte PreviousType, void* UserData) {
+    FCellTest* Test = UserData;
+    CHECK(World_GetBlockType(Test->World, X, Y, Z) != PreviousType);
+    Test->ChangedBlocks++;
+}
+
+void CellTest_Set(FCellTest* Test, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+    Cells_ActivateBlock(Test->Cells, X, Y, Z);
+}
+
+U32 CellTest_Count(const FCellTest* Test, const Byte Type) {
+    U32 Count = 0;
+    for (U32 Index = 0; Index < CELL_TEST_CHUNKS; Index++) {
+        for (U32 Block = 0; Block < CHUNK_VOLUME; Block++) {
+            Count += Test->Chunks[Index]->Blocks[Block].Type == Type;
+        }
+    }
+
+    return Count;
+}
+
+void CellTest_Settle(FCellTest* Test) {
+    for (U32 Tick = 0; Tick < CELL_TEST_MAX_TICKS && Cells_IsPending(Test->Cells); Tick++) {
+        Cells_Tick(Test->Cells);
+    }
+    CHECK(!Cells_IsPending(Test->Cells));
+}
+
+void CellTest_Place(FCellTest* Test) {
+    // Sand and water poured over chunk borders, from the chunk on top and onto each other.
+    for (I32 Y = 20; Y < 40; Y++) {
+        CellTest_Set(Test, 31, Y, 31, Y % 3 == 0 ? BLOCK_TYPE_WATER : BLOCK_TYPE_SAND);
+        CellTest_Set(Test, 8 + Y % 4, Y, 9, Y % 2 == 0 ? BLOCK_TYPE_WATER : BLOCK_TYPE_SAND);
+    }
+}
+
+void CellTest_Steps(FCellTest* Test) {
+    // Sand falls through air one block per tick.
+    CellTest_Set(Test, 5, 10, 5, BLOCK_TYPE_SAND);
+    Cells_Tick(Test->Cells);
+    CHECK(World_GetBlockType(Test->World, 5, 10, 5) == BLOCK_TYPE_AIR);
+    CHECK(World_GetBlockType(Test->World, 5, 9, 5) == BLOCK_TYPE_SAND);
+    CHECK(Test->ChangedBlocks == 2);
+    CellTest_Settle(Test);
+    CHECK(World_GetBlockType(Test->World, 5, 1, 5) == BLOCK_TYPE_SAND);
+
+    // Sand sinks through water by swapping with it.
+    CellTest_Set(Test, 10, 1, 10, BLOCK_TYPE_WATER);
+    CellTest_Set(Test, 10, 2, 10, BLOCK_TYPE_SAND);
+    Cells_Tick(Test->Cells);
+    CHECK(World_GetBlockType(Test->World, 10, 1, 10) == BLOCK_TYPE_SAND);
+    CHECK(World_GetBlockType(Test->World, 10, 2, 10) == BLOCK_TYPE_WATER);
+    CellTest_Settle(Test);
+
+    // Sand on a single block slides down one of its sides.
+    CellTest_Set(Test, 15, 1, 15, BLOCK_TYPE_STONE);
+    CellTest_Set(Test, 15, 2, 15, BLOCK_TYPE_SAND);
+    Cells_Tick(Test->Cells);
+    CHECK(World_GetBlockType(Test->World, 15, 2, 15) == BLOCK_TYPE_AIR);
+    const U32 Slid = (World_GetBlockType(Test->World, 16, 1, 15) == BLOCK_TYPE_SAND) + (World_GetBlockType(Test->World, 14, 1, 15) == BLOCK_TYPE_SAND) +
+                     (World_GetBlockType(Test->World, 15, 1, 16) == BLOCK_TYPE_SAND) + (World_GetBlockType(Test->World, 15, 1, 14) == BLOCK_TYPE_SAND);
+    CHECK(Slid == 1);
+    CellTest_Settle(Test);
+
+    // A water column levels out into a sheet on the floor, across the chunk border.
+    for (I32 Y = 1; Y <= 4; Y++) {
+        CellTest_Set(Test, 31, Y, 20, BLOCK_TYPE_WATER);
+    }
+    CellTest_Settle(Test);
+    U32 Sheet = 0;
+    for (I32 Z = 16; Z < 25; Z++) {
+        for (I32 X = 26; X < 37; X++) {
+            Sheet += World_GetBlockType(Test->World, X, 1, Z) == BLOCK_TYPE_WATER;
+            CHECK(World_GetBlockType(Test->World, X, 2, Z) == BLOCK_TYPE_AIR);
+        }
+    }
+    CHECK(Sheet == 4);
+
+    // A settled block stays put.
+    const U32 ChangedBlocks = Test->ChangedBlocks;
+    Cells_ActivateBlock(Test->Cells, 5, 1, 5);
+    CellTest_Settle(Test);
+    CHECK(Test->ChangedBlocks == ChangedBlocks);
+}
+#pragma endregion
@@ -0,0 +1,12 @@
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Fails the test executable with the location of the condition. Unlike assert it stays active in release builds. */
+#define CHECK(Condition)                                                                                                                   \
+    do {                                                                                                                                   \
+        if (!(Condition)) {                                                                                                                \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #Condition);                                                  \
+            exit(1);                                                                                                                       \
+        }                                                                                                                                  \
+    } while (0)
@@ -0,0 +1,69 @@
+#include "chunk.h"
+
+#include <stdlib.h>
+
+FChunk* Chunk_Create(const I32 X, const I32 Y, const I32 Z) {
+    FChunk* Chunk = calloc(1, sizeof *Chunk);
+    if (Chunk == NULL) {
+        return NULL;
+    }
+
+    Chunk->X = X;
+    Chunk->Y = Y;
+    Chunk->Z = Z;
+
+    return Chunk;
+}
+
+void Chunk_Destroy(FChunk* Chunk) {
+    free(Chunk);
+}
+
+void Chunk_SetBlockType(FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FBlock* Block = &Chunk->Blocks[Chunk_GetBlockIndex(X, Y, Z)];
+
+    const Bool bRemoved = Block->Type != BLOCK_TYPE_AIR && Type == BLOCK_TYPE_AIR;
+    if (Block->Type == BLOCK_TYPE_AIR && Type != BLOCK_TYPE_AIR) {
+        Chunk->BlockCount++;
+        Chunk->OccupiedCells |= Chunk_GetCellBit(X, Y, Z);
+    } else if (bRemoved) {
+        Chunk->BlockCount--;
+    }
+
+    Block->Type = Type;
+
+    // The cell stays occupied while any of its blocks is left.
+    if (bRemoved) {
+        const I32 CellX = X & ~(CHUNK_CELL_SIZE - 1);
+        const I32 CellY = Y & ~(CHUNK_CELL_SIZE - 1);
+        const I32 CellZ = Z & ~(CHUNK_CELL_SIZE - 1);
+        for (I32 BlockY = CellY; BlockY < CellY + CHUNK_CELL_SIZE; BlockY++) {
+            for (I32 BlockZ = CellZ; BlockZ < CellZ + CHUNK_CELL_SIZE; BlockZ++) {
+                for (I32 BlockX = CellX; BlockX < CellX + CHUNK_CELL_SIZE; BlockX++) {
+                    if (Chunk_GetBlockType(Chunk, BlockX, BlockY, BlockZ) != BLOCK_TYPE_AIR) {
+                        return;
+                    }
+                }
+            }
+        }
+        Chunk->OccupiedCells &= ~Chunk_GetCellBit(X, Y, Z);
+    }
+}
+
+void Chunk_UpdateBlockCount(FChunk* Chunk) {
+    U32 BlockCount = 0;
+    U64 OccupiedCells = 0;
+    for (I32 Y = 0; Y < CHUNK_SIZE; Y++) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                if (Chunk_GetBlockType(Chunk, X, Y, Z) != BLOCK_TYPE_AIR) {
+                    BlockCount++;
+                    OccupiedCells |= Chunk_GetCellBit(X, Y, Z);
+                }
+            }
+        }
+    }
+
+    Chunk->BlockCount = BlockCount;
+    Chunk->OccupiedCells = OccupiedCells;
+}
@@ -1,6 +1,116 @@
 #pragma once
 #include "typedefs.h"
+#include "block.h"
 
-typedef struct {
-    Byte Id;
+/** Number of blocks along each chunk axis. */
+#define CHUNK_SIZE 32
+/** Number of blocks in a chunk layer. */
+#define CHUNK_AREA (CHUNK_SIZE * CHUNK_SIZE)
+/** Number of blocks in a chunk. */
+#define CHUNK_VOLUME (CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE)
+
+/** Number of blocks along each section axis. Sections are meshed separately so their meshes fit 16-bit indices. */
+#define CHUNK_SECTION_SIZE 16
+/** Number of sections along each chunk axis. */
+#define CHUNK_SECTIONS_PER_AXIS (CHUNK_SIZE / CHUNK_SECTION_SIZE)
+/** Number of sections in a chunk. */
+#define CHUNK_SECTION_COUNT (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS)
+
+/** Number of blocks along each cell axis. Cells are tracked as occupied or empty so rays can skip empty space. */
+#define CHUNK_CELL_SIZE 8
+/** Number of cells along each chunk axis, the cells of a chunk fit a 64-bit mask. */
+#define CHUNK_CELLS_PER_AXIS (CHUNK_SIZE / CHUNK_CELL_SIZE)
+
+/** Index of the center chunk in the FChunkNeighbourhood. */
+#define CHUNK_NEIGHBOURHOOD_CENTER 13
+
+typedef struct FChunk {
+    /** Chunk position in chunks. */
+    I32 X;
+    I32 Y;
+    I32 Z;
+    /** Number of non-empty blocks, lets empty chunks be skipped without scanning. */
+    U32 BlockCount;
+    /** Cells holding non-empty blocks, a bit per cell, see Chunk_GetCellBit. */
+    U64 OccupiedCells;
+    /** Blocks, Y-major then Z then X, see Chunk_GetBlockIndex. */
+    FBlock Blocks[CHUNK_VOLUME];
+    /** Light of the blocks by block index, sunlight in the high nibble and block light in the low one. See light.h. */
+    Byte Light[CHUNK_VOLUME];
 } FChunk;
+
+/** A chunk with its 26 surrounding chunks, indexed by (DY + 1) * 9 + (DZ + 1) * 3 + (DX + 1). Missing chunks are NULL and treated as empty. */
+typedef struct {
+    const FChunk* Chunks[27];
+} FChunkNeighbourhood;
+
+/** Allocates an empty chunk at the chunk position. */
+FChunk* Chunk_Create(I32 X, I32 Y, I32 Z);
+
+/** Frees the chunk. */
+void Chunk_Destroy(FChunk* Chunk);
+
+/** Sets the block type, keeps the chunk block count up to date. */
+void Chunk_SetBlockType(FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte Type);
+
+/** Recounts non-empty blocks and occupied cells after the block storage was written directly. */
+void Chunk_UpdateBlockCount(FChunk* Chunk);
+
+/** Returns the block index for the local block position. */
+static inline U32 Chunk_GetBlockIndex(const I32 X, const I32 Y, const I32 Z) {
+    return ((U32)Y * CHUNK_SIZE + (U32)Z) * CHUNK_SIZE + (U32)X;
+}
+
+/** Returns the bit of the cell holding the local block position in FChunk::OccupiedCells. */
+static inline U64 Chunk_GetCellBit(const I32 X, const I32 Y, const I32 Z) {
+    const U32 Cell = (((U32)Y / CHUNK_CELL_SIZE) * CHUNK_CELLS_PER_AXIS + (U32)Z / CHUNK_CELL_SIZE) * CHUNK_CELLS_PER_AXIS + (U32)X / CHUNK_CELL_SIZE;
+    return 1ull << Cell;
+}
+
+/** Returns True if the local block position is inside the chunk. */
+static inline Bool Chunk_IsInside(const I32 X, const I32 Y, const I32 Z) {
+    return (U32)X < CHUNK_SIZE && (U32)Y < CHUNK_SIZE && (U32)Z < CHUNK_SIZE;
+}
+
+/** Returns the block type at the local block position. */
+static inline Byte Chunk_GetBlockType(const FChunk* Chunk, const I32 X, const I32 Y, const I32 Z) {
+    return Chunk->Blocks[Chunk_GetBlockIndex(X, Y, Z)].Type;
+}
+
+/** Returns the sunlight of the block at the block index. */
+static inline Byte Chunk_GetSunLight(const FChunk* Chunk, const U32 Index) {
+    return Chunk->Light[Index] >> 4;
+}
+
+/** Returns the block light of the block at the block index. */
+static inline Byte Chunk_GetBlockLight(const FChunk* Chunk, const U32 Index) {
+    return Chunk->Light[Index] & 0x0F;
+}
+
+/** Returns the block type at the position relative to the center chunk of the neighbourhood, positions may go one chunk out in each direction. */
+static inline Byte Chunk_GetNeighbourhoodBlockType(const FChunkNeighbourhood* Neighbourhood, const I32 X, const I32 Y, const I32 Z) {
+    const I32 DX = X < 0 ? -1 : X >= CHUNK_SIZE ? 1 : 0;
+    const I32 DY = Y < 0 ? -1 : Y >= CHUNK_SIZE ? 1 : 0;
+    const I32 DZ = Z < 0 ? -1 : Z >= CHUNK_SIZE ? 1 : 0;
+
+    const FChunk* Chunk = Neighbourhood->Chunks[(DY + 1) * 9 + (DZ + 1) * 3 + (DX + 1)];
+    if (Chunk == NULL) {
+        return BLOCK_TYPE_AIR;
+    }
+
+    return Chunk_GetBlockType(Chunk, X - DX * CHUNK_SIZE, Y - DY * CHUNK_SIZE, Z - DZ * CHUNK_SIZE);
+}
+
+/** Returns the light byte at the position relative to the center chunk of the neighbourhood, missing chunks are open sky. */
+static inline Byte Chunk_GetNeighbourhoodLight(const FChunkNeighbourhood* Neighbourhood, const I32 X, const I32 Y, const I32 Z) {
+    const I32 DX = X < 0 ? -1 : X >= CHUNK_SIZE ? 1 : 0;
+    const I32 DY = Y < 0 ? -1 : Y >= CHUNK_SIZE ? 1 : 0;
+    const I32 DZ = Z < 0 ? -1 : Z >= CHUNK_SIZE ? 1 : 0;
+
+    const FChunk* Chunk = Neighbourhood->Chunks[(DY + 1) * 9 + (DZ + 1) * 3 + (DX + 1)];
+    if (Chunk == NULL) {
+        return BLOCK_LIGHT_MAX << 4;
+    }
+
+    return Chunk->Light[Chunk_GetBlockIndex(X - DX * CHUNK_SIZE, Y - DY * CHUNK_SIZE, Z - DZ * CHUNK_SIZE)];
+}
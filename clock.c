@@ -0,0 +1,23 @@
+#include "clock.h"
+
+#if OS_WINDOWS
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+U64 Clock_GetNanoseconds() {
+#if OS_WINDOWS
+    static LARGE_INTEGER Frequency;
+    LARGE_INTEGER Counter;
+    if (Frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&Frequency);
+    }
+    QueryPerformanceCounter(&Counter);
+    return (U64)((F64)Counter.QuadPart * 1e9 / (F64)Frequency.QuadPart);
+#else
+    struct timespec Time;
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return (U64)Time.tv_sec * 1000000000ull + (U64)Time.tv_nsec;
+#endif
+}
@@ -0,0 +1,5 @@
+#pragma once
+#include "typedefs.h"
+
+/** Returns monotonic time in nanoseconds from an unspecified starting point. */
+U64 Clock_GetNanoseconds();
@@ -0,0 +1,25 @@
+# Cooks the assets/ tree from scratch, checks a second run cooks nothing and packs the cooked tree.
+file(REMOVE_RECURSE ${OUTPUT})
+
+execute_process(COMMAND ${COOKER} assets ${OUTPUT} RESULT_VARIABLE CookResult OUTPUT_VARIABLE CookOutput)
+message(STATUS "${CookOutput}")
+if (NOT CookResult EQUAL 0)
+    message(FATAL_ERROR "Cooking assets failed")
+endif ()
+
+foreach (CookedPath assets/fonts/ttf/DejaVuLGCSansMono.sdf assets/textures/texture.dds assets/shaders/fs.glsl)
+    if (NOT EXISTS ${OUTPUT}/${CookedPath})
+        message(FATAL_ERROR "Cooked asset ${CookedPath} is missing")
+    endif ()
+endforeach ()
+
+execute_process(COMMAND ${COOKER} assets ${OUTPUT} RESULT_VARIABLE RecookResult OUTPUT_VARIABLE RecookOutput)
+if (NOT RecookResult EQUAL 0 OR NOT RecookOutput MATCHES ": 0 cooked,")
+    message(FATAL_ERROR "Cooking unchanged assets again wasn't a no-op:\n${RecookOutput}")
+endif ()
+
+execute_process(COMMAND ${PACKER} assets ${OUTPUT}/assets.pak WORKING_DIRECTORY ${OUTPUT} RESULT_VARIABLE PackResult)
+execute_process(COMMAND ${PACKER} --verify ${OUTPUT}/assets.pak RESULT_VARIABLE VerifyResult OUTPUT_QUIET)
+if (NOT PackResult EQUAL 0 OR NOT VerifyResult EQUAL 0)
+    message(FATAL_ERROR "Packing the cooked assets failed")
+endif ()
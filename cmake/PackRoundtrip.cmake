@@ -0,0 +1,10 @@
+# Packs the assets/ tree and verifies every entry of the result against its content hash.
+execute_process(COMMAND ${PACKER} assets ${OUTPUT} RESULT_VARIABLE PackResult)
+if (NOT PackResult EQUAL 0)
+    message(FATAL_ERROR "Packing assets failed")
+endif ()
+
+execute_process(COMMAND ${PACKER} --verify ${OUTPUT} RESULT_VARIABLE VerifyResult)
+if (NOT VerifyResult EQUAL 0)
+    message(FATAL_ERROR "Asset pack verification failed")
+endif ()
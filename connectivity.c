@@ -0,0 +1,692 @@
+#include "connectivity.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+
+#pragma region Settings
+/** Initial number of visited set slots, a power of two. */
+#define CONNECTIVITY_MIN_CAPACITY 1024
+/** Tag of blocks known to be supported, other tags are orphan indices. */
+#define CONNECTIVITY_TAG_SUPPORTED 0xFF
+/** Blocks a removal can orphan, one per direction. */
+#define CONNECTIVITY_MAX_ORPHANS 6
+#pragma endregion
+
+/** Result of a walk from a touching block toward the ground. */
+typedef enum {
+    CONNECTIVITY_LINK_SUPPORTED,
+    /** Touching block is in the structure searched. */
+    CONNECTIVITY_LINK_SAME,
+    /** Touching block floats, it can't support the structure. */
+    CONNECTIVITY_LINK_FLOATING,
+    /** Touching block is in the structure of an orphan not searched yet. */
+    CONNECTIVITY_LINK_ORPHAN,
+} EConnectivityLink;
+
+/** State of an orphaned child of a removed block. */
+typedef enum {
+    CONNECTIVITY_ORPHAN_PENDING,
+    CONNECTIVITY_ORPHAN_SUPPORTED,
+    CONNECTIVITY_ORPHAN_FLOATING,
+    /** Attached to the structure of another orphan, see FConnectivityOrphan::MergedInto. */
+    CONNECTIVITY_ORPHAN_MERGED,
+} EConnectivityOrphan;
+
+typedef struct {
+    FConnectivityBlock Block;
+    EConnectivityOrphan State;
+    U32 MergedInto;
+} FConnectivityOrphan;
+
+typedef struct {
+    FVector(FConnectivityBlock) Items;
+} FConnectivityBlockList;
+
+/** Visited set slot, slots of older generations are empty. */
+typedef struct {
+    U64 Key;
+    U32 Generation;
+    Byte Tag;
+} FConnectivitySlot;
+
+struct FConnectivity {
+    FWorld* World;
+    ConnectivityChunkHandler OnChunkChanged;
+    void* UserData;
+
+    /** Blocks tagged by the current edit, open addressing with linear probing. */
+    FConnectivitySlot* Slots;
+    U32 Capacity;
+    U32 Count;
+    U32 Generation;
+
+    FConnectivityOrphan Orphans[CONNECTIVITY_MAX_ORPHANS];
+    U32 OrphanCount;
+
+    /** Breadth-first queue of the searched structure and path of the current walk. */
+    FConnectivityBlockList Queue;
+    FConnectivityBlockList Path;
+
+    /** Floating structures, batch ends index the blocks. */
+    FConnectivityBlockList BatchBlocks;
+    FVector(U32) BatchEnds;
+
+    /** Chunks changed by the current edit, the last one is checked first. */
+    FVector(FChunk*) ChangedChunks;
+
+    FConnectivityStats Stats;
+};
+
+#pragma region Private Function Declarations
+/** Returns the block at the world block position, NULL if its chunk isn't loaded. */
+static FBlock* Connectivity_GetBlock(const FConnectivity* Connectivity, I32 X, I32 Y, I32 Z, FChunk** OutChunk);
+
+/** Returns the solid block at the world block position, NULL if it isn't solid or its chunk isn't loaded. Records the chunk as changed. */
+static FBlock* Connectivity_GetChangedBlock(FConnectivity* Connectivity, I32 X, I32 Y, I32 Z);
+
+static void Connectivity_MarkChanged(FConnectivity* Connectivity, FChunk* Chunk);
+
+/** Calls the handler for the chunks changed by the edit. */
+static void Connectivity_NotifyChanged(FConnectivity* Connectivity);
+
+/** Returns the neighbour of the block in the direction. */
+static FConnectivityBlock Connectivity_GetNeighbour(FConnectivityBlock Block, EDirection Direction);
+
+/** Searches the structure of the orphan for a supported touching block, the orphan is resolved when it returns. */
+static void Connectivity_ResolveOrphan(FConnectivity* Connectivity, U32 Orphan);
+
+/** Walks the parents of the block until the ground, a tagged block or a root. Returns the link and the orphan for orphan links. */
+static EConnectivityLink Connectivity_Walk(FConnectivity* Connectivity, FConnectivityBlock Block, U32 Orphan, U32* OutOrphan);
+
+/** Returns the link of the blocks of the orphan, following merges. */
+static EConnectivityLink Connectivity_GetOrphanLink(const FConnectivity* Connectivity, U32 Orphan, U32 Searched, U32* OutOrphan);
+
+/** Makes the block the root of its tree and the child of its neighbour in the direction, reversing the parents on the way. */
+static void Connectivity_Reroot(FConnectivity* Connectivity, FConnectivityBlock Block, EDirection Direction);
+
+/** Clears the floating flags of the tree under the block, floating trees it touches are attached to it. */
+static void Connectivity_Support(FConnectivity* Connectivity, FConnectivityBlock Root);
+
+/** Clears the floating flags of the children of the queued blocks from the head on. Returns the new head. */
+static size_t Connectivity_SupportTrees(FConnectivity* Connectivity, size_t Head);
+
+/** Starts a new visited set generation. */
+static void Connectivity_ResetTags(FConnectivity* Connectivity);
+
+/** Returns the tag of the block, False if it isn't tagged. */
+static Bool Connectivity_GetTag(const FConnectivity* Connectivity, FConnectivityBlock Block, Byte* OutTag);
+
+static void Connectivity_SetTag(FConnectivity* Connectivity, FConnectivityBlock Block, Byte Tag);
+
+/** Rehashes the tagged blocks into a set of the capacity. */
+static Bool Connectivity_Resize(FConnectivity* Connectivity, U32 Capacity);
+
+/** Packs the block position into a set key, 21 bits per axis. */
+static U64 Connectivity_GetKey(FConnectivityBlock Block);
+
+static void Connectivity_PushBlock(FConnectivityBlockList* List, FConnectivityBlock Block);
+#pragma endregion
+
+#pragma region Public Function Definitions
+FConnectivity* Connectivity_Create(FWorld* World, const ConnectivityChunkHandler OnChunkChanged, void* UserData) {
+    FConnectivity* Connectivity = calloc(1, sizeof *Connectivity);
+    if (Connectivity == NULL) {
+        return NULL;
+    }
+
+    Connectivity->World = World;
+    Connectivity->OnChunkChanged = OnChunkChanged;
+    Connectivity->UserData = UserData;
+
+    if (!Connectivity_Resize(Connectivity, CONNECTIVITY_MIN_CAPACITY)) {
+        free(Connectivity);
+        return NULL;
+    }
+
+    return Connectivity;
+}
+
+void Connectivity_Destroy(FConnectivity* Connectivity) {
+    if (Connectivity == NULL) {
+        return;
+    }
+
+    free(Connectivity->Slots);
+    FVector_Free(Connectivity->Queue.Items);
+    FVector_Free(Connectivity->Path.Items);
+    FVector_Free(Connectivity->BatchBlocks.Items);
+    FVector_Free(Connectivity->BatchEnds);
+    FVector_Free(Connectivity->ChangedChunks);
+    free(Connectivity);
+}
+
+void Connectivity_AddBlock(FConnectivity* Connectivity, const I32 X, const I32 Y, const I32 Z) {
+    FBlock* Block = Connectivity_GetChangedBlock(Connectivity, X, Y, Z);
+    if (Block == NULL) {
+        return;
+    }
+
+    Connectivity->Stats.VisitedBlocks = 0;
+    Connectivity->Stats.WalkedBlocks = 0;
+
+    Block->Flags &= (Byte)~(BLOCK_FLAG_ANCHORED | BLOCK_FLAG_FLOATING);
+    Block->ParentBit = 0;
+    Block->ChildBits = 0;
+    Block->TouchingBits = 0;
+
+    // Blocks rest on the block below when they can, the hierarchy then follows how structures are built.
+    static const EDirection Order[6] = {YNegative, XPositive, XNegative, ZPositive, ZNegative, YPositive};
+
+    const FConnectivityBlock Added = {X, Y, Z};
+    FBlock* Neighbours[6] = {0};
+    I32 Parent = -1;
+    for (U32 Index = 0; Index < 6; Index++) {
+        const EDirection Direction = Order[Index];
+        const FConnectivityBlock Position = Connectivity_GetNeighbour(Added, Direction);
+        Neighbours[Direction] = Connectivity_GetChangedBlock(Connectivity, Position.X, Position.Y, Position.Z);
+        if (Parent < 0 && Neighbours[Direction] != NULL && !(Neighbours[Direction]->Flags & BLOCK_FLAG_FLOATING)) {
+            Parent = (I32)Direction;
+        }
+    }
+
+    const Bool bSupported = Parent >= 0;
+    if (!bSupported) {
+        Block->Flags |= BLOCK_FLAG_FLOATING;
+        for (U32 Index = 0; Index < 6 && Parent < 0; Index++) {
+            if (Neighbours[Order[Index]] != NULL) {
+                Parent = (I32)Order[Index];
+            }
+        }
+    }
+
+    if (Parent >= 0) {
+        Block->ParentBit = Block_GetDirectionBit((EDirection)Parent);
+        Neighbours[Parent]->ChildBits |= Block_GetDirectionBit(Block_GetOppositeDirection((EDirection)Parent));
+    }
+
+    for (U32 Index = 0; Index < 6; Index++) {
+        const EDirection Direction = Order[Index];
+        FBlock* Neighbour = Neighbours[Direction];
+        if (Neighbour == NULL || (I32)Direction == Parent) {
+            continue;
+        }
+
+        // A supported block holds up the floating structures it touches.
+        if (bSupported && (Neighbour->Flags & BLOCK_FLAG_FLOATING)) {
+            const FConnectivityBlock Position = Connectivity_GetNeighbour(Added, Direction);
+            Connectivity_Reroot(Connectivity, Position, Block_GetOppositeDirection(Direction));
+            Connectivity_Support(Connectivity, Position);
+            continue;
+        }
+
+        Block->TouchingBits |= Block_GetDirectionBit(Direction);
+        Neighbour->TouchingBits |= Block_GetDirectionBit(Block_GetOppositeDirection(Direction));
+    }
+
+    if (Parent < 0) {
+        Connectivity_PushBlock(&Connectivity->BatchBlocks, Added);
+        FVector_Add(Connectivity->BatchEnds, (U32)FVector_GetSize(Connectivity->BatchBlocks.Items));
+        Connectivity->Stats.FloatingStructures++;
+    }
+
+    Connectivity_NotifyChanged(Connectivity);
+}
+
+void Connectivity_RemoveBlock(FConnectivity* Connectivity, const I32 X, const I32 Y, const I32 Z) {
+    FBlock* Block = Connectivity_GetChangedBlock(Connectivity, X, Y, Z);
+    FChunk* Chunk = NULL;
+    if (Block == NULL) {
+        // The block is usually no longer solid, its bits are still there.
+        Block = Connectivity_GetBlock(Connectivity, X, Y, Z, &Chunk);
+        if (Block == NULL) {
+            return;
+        }
+        Connectivity_MarkChanged(Connectivity, Chunk);
+    }
+
+    Connectivity->Stats.VisitedBlocks = 0;
+    Connectivity->Stats.WalkedBlocks = 0;
+
+    const FBlock Removed = *Block;
+    Block->Flags &= (Byte)~(BLOCK_FLAG_ANCHORED | BLOCK_FLAG_FLOATING);
+    Block->ParentBit = 0;
+    Block->ChildBits = 0;
+    Block->TouchingBits = 0;
+
+    const FConnectivityBlock Position = {X, Y, Z};
+    Connectivity->OrphanCount = 0;
+    for (EDirection Direction = XPositive; Direction <= ZNegative; Direction++) {
+        const Byte Bit = Block_GetDirectionBit(Direction);
+        if (!((Removed.ParentBit | Removed.ChildBits | Removed.TouchingBits) & Bit)) {
+            continue;
+        }
+
+        const FConnectivityBlock NeighbourPosition = Connectivity_GetNeighbour(Position, Direction);
+        FBlock* Neighbour = Connectivity_GetChangedBlock(Connectivity, NeighbourPosition.X, NeighbourPosition.Y, NeighbourPosition.Z);
+        if (Neighbour == NULL) {
+            continue;
+        }
+
+        const Byte OppositeBit = Block_GetDirectionBit(Block_GetOppositeDirection(Direction));
+        if (Removed.ParentBit & Bit) {
+            Neighbour->ChildBits &= (Byte)~OppositeBit;
+        } else if (Removed.ChildBits & Bit) {
+            Neighbour->ParentBit = 0;
+            if (!(Removed.Flags & BLOCK_FLAG_FLOATING)) {
+                Connectivity->Orphans[Connectivity->OrphanCount++] = (FConnectivityOrphan){NeighbourPosition, CONNECTIVITY_ORPHAN_PENDING, 0};
+            }
+        } else {
+            Neighbour->TouchingBits &= (Byte)~OppositeBit;
+        }
+    }
+
+    // Orphans of a floating block stay floating, the structure was reported already.
+    if (Connectivity->OrphanCount > 0) {
+        Connectivity_ResetTags(Connectivity);
+        for (U32 Orphan = 0; Orphan < Connectivity->OrphanCount; Orphan++) {
+            Connectivity_ResolveOrphan(Connectivity, Orphan);
+        }
+    }
+
+    Connectivity_NotifyChanged(Connectivity);
+}
+
+U32 Connectivity_GetBatchCount(const FConnectivity* Connectivity) {
+    return (U32)FVector_GetSize(Connectivity->BatchEnds);
+}
+
+const FConnectivityBlock* Connectivity_GetBatch(const FConnectivity* Connectivity, const U32 Index, U32* OutCount) {
+    const U32 Begin = Index > 0 ? Connectivity->BatchEnds[Index - 1] : 0;
+    *OutCount = Connectivity->BatchEnds[Index] - Begin;
+    return &Connectivity->BatchBlocks.Items[Begin];
+}
+
+void Connectivity_ClearBatches(FConnectivity* Connectivity) {
+    FVector_Clear(Connectivity->BatchBlocks.Items);
+    FVector_Clear(Connectivity->BatchEnds);
+}
+
+void Connectivity_GetStats(const FConnectivity* Connectivity, FConnectivityStats* OutStats) {
+    *OutStats = Connectivity->Stats;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+FBlock* Connectivity_GetBlock(const FConnectivity* Connectivity, const I32 X, const I32 Y, const I32 Z, FChunk** OutChunk) {
+    FChunk* Chunk = World_GetChunk(Connectivity->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    *OutChunk = Chunk;
+    if (Chunk == NULL) {
+        return NULL;
+    }
+
+    return &Chunk->Blocks[Chunk_GetBlockIndex(World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z))];
+}
+
+FBlock* Connectivity_GetChangedBlock(FConnectivity* Connectivity, const I32 X, const I32 Y, const I32 Z) {
+    FChunk* Chunk;
+    FBlock* Block = Connectivity_GetBlock(Connectivity, X, Y, Z, &Chunk);
+    if (Block == NULL || !Block_IsSolid(Block->Type)) {
+        return NULL;
+    }
+
+    Connectivity_MarkChanged(Connectivity, Chunk);
+    return Block;
+}
+
+void Connectivity_MarkChanged(FConnectivity* Connectivity, FChunk* Chunk) {
+    FChunk** Chunks = Connectivity->ChangedChunks;
+    const size_t Count = FVector_GetSize(Chunks);
+    for (size_t Index = Count; Index > 0; Index--) {
+        if (Chunks[Index - 1] == Chunk) {
+            return;
+        }
+    }
+
+    FVector_Add(Connectivity->ChangedChunks, Chunk);
+}
+
+void Connectivity_NotifyChanged(FConnectivity* Connectivity) {
+    if (Connectivity->OnChunkChanged != NULL) {
+        for (size_t Index = 0; Index < FVector_GetSize(Connectivity->ChangedChunks); Index++) {
+            Connectivity->OnChunkChanged(Connectivity->ChangedChunks[Index], Connectivity->UserData);
+        }
+    }
+
+    FVector_Clear(Connectivity->ChangedChunks);
+}
+
+FConnectivityBlock Connectivity_GetNeighbour(const FConnectivityBlock Block, const EDirection Direction) {
+    const I32* Offset = BlockDirectionOffsets[Direction];
+    return (FConnectivityBlock){Block.X + Offset[0], Block.Y + Offset[1], Block.Z + Offset[2]};
+}
+
+void Connectivity_ResolveOrphan(FConnectivity* Connectivity, const U32 Orphan) {
+    FConnectivityOrphan* Record = &Connectivity->Orphans[Orphan];
+    if (Record->State != CONNECTIVITY_ORPHAN_PENDING) {
+        return;
+    }
+
+    FVector_Clear(Connectivity->Queue.Items);
+    Connectivity_PushBlock(&Connectivity->Queue, Record->Block);
+    Connectivity_SetTag(Connectivity, Record->Block, (Byte)Orphan);
+
+    // Breadth first so supports close to the removed block are found before the far ends of the structure.
+    for (size_t Head = 0; Head < FVector_GetSize(Connectivity->Queue.Items); Head++) {
+        const FConnectivityBlock Current = Connectivity->Queue.Items[Head];
+        FChunk* Chunk;
+        const FBlock* Block = Connectivity_GetBlock(Connectivity, Current.X, Current.Y, Current.Z, &Chunk);
+        Connectivity->Stats.VisitedBlocks++;
+
+        for (EDirection Direction = XPositive; Direction <= ZNegative; Direction++) {
+            const Byte Bit = Block_GetDirectionBit(Direction);
+            if (!((Block->ChildBits | Block->TouchingBits) & Bit)) {
+                continue;
+            }
+
+            const FConnectivityBlock Neighbour = Connectivity_GetNeighbour(Current, Direction);
+            FChunk* NeighbourChunk;
+            const FBlock* NeighbourBlock = Connectivity_GetBlock(Connectivity, Neighbour.X, Neighbour.Y, Neighbour.Z, &NeighbourChunk);
+
+            if (Block->ChildBits & Bit) {
+                // The rest of the structure can't be seen, it is assumed to be supported there.
+                if (NeighbourBlock == NULL) {
+                    Record->State = CONNECTIVITY_ORPHAN_SUPPORTED;
+                    return;
+                }
+
+                if (Block_IsSolid(NeighbourBlock->Type)) {
+                    Connectivity_SetTag(Connectivity, Neighbour, (Byte)Orphan);
+                    Connectivity_PushBlock(&Connectivity->Queue, Neighbour);
+                }
+                continue;
+            }
+
+            if (NeighbourBlock == NULL) {
+                Record->State = CONNECTIVITY_ORPHAN_SUPPORTED;
+                return;
+            }
+            if (!Block_IsSolid(NeighbourBlock->Type)) {
+                continue;
+            }
+
+            U32 Other;
+            const EConnectivityLink Link = Connectivity_Walk(Connectivity, Neighbour, Orphan, &Other);
+            if (Link == CONNECTIVITY_LINK_SUPPORTED) {
+                Connectivity_Reroot(Connectivity, Current, Direction);
+                Record->State = CONNECTIVITY_ORPHAN_SUPPORTED;
+                Connectivity->Stats.ReattachedStructures++;
+                return;
+            }
+
+            // Touching orphans are one structure, it is searched once through the other orphan.
+            if (Link == CONNECTIVITY_LINK_ORPHAN) {
+                Connectivity_Reroot(Connectivity, Current, Direction);
+                Record->State = CONNECTIVITY_ORPHAN_MERGED;
+                Record->MergedInto = Other;
+                return;
+            }
+        }
+    }
+
+    const size_t Count = FVector_GetSize(Connectivity->Queue.Items);
+    for (size_t Index = 0; Index < Count; Index++) {
+        const FConnectivityBlock Current = Connectivity->Queue.Items[Index];
+        FBlock* Block = Connectivity_GetChangedBlock(Connectivity, Current.X, Current.Y, Current.Z);
+        Block->Flags |= BLOCK_FLAG_FLOATING;
+        Connectivity_PushBlock(&Connectivity->BatchBlocks, Current);
+    }
+
+    FVector_Add(Connectivity->BatchEnds, (U32)FVector_GetSize(Connectivity->BatchBlocks.Items));
+    Record->State = CONNECTIVITY_ORPHAN_FLOATING;
+    Connectivity->Stats.FloatingStructures++;
+}
+
+EConnectivityLink Connectivity_Walk(FConnectivity* Connectivity, const FConnectivityBlock Block, const U32 Orphan, U32* OutOrphan) {
+    FVector_Clear(Connectivity->Path.Items);
+
+    EConnectivityLink Link = CONNECTIVITY_LINK_SUPPORTED;
+    FConnectivityBlock Current = Block;
+    for (;;) {
+        Byte Tag;
+        if (Connectivity_GetTag(Connectivity, Current, &Tag)) {
+            if (Tag != CONNECTIVITY_TAG_SUPPORTED) {
+                Link = Connectivity_GetOrphanLink(Connectivity, Tag, Orphan, OutOrphan);
+            }
+            break;
+        }
+
+        // Parents in chunks that aren't loaded are assumed to be supported.
+        FChunk* Chunk;
+        const FBlock* Parent = Connectivity_GetBlock(Connectivity, Current.X, Current.Y, Current.Z, &Chunk);
+        if (Parent == NULL || !Block_IsSolid(Parent->Type) || (Parent->Flags & BLOCK_FLAG_ANCHORED)) {
+            break;
+        }
+
+        if (Parent->Flags & BLOCK_FLAG_FLOATING) {
+            Link = CONNECTIVITY_LINK_FLOATING;
+            break;
+        }
+
+        // Roots are orphans of the removal, roots left by earlier removals are assumed to be supported.
+        if (Parent->ParentBit == 0) {
+            for (U32 Index = 0; Index < Connectivity->OrphanCount; Index++) {
+                const FConnectivityBlock Root = Connectivity->Orphans[Index].Block;
+                if (Root.X == Current.X && Root.Y == Current.Y && Root.Z == Current.Z) {
+                    Link = Connectivity_GetOrphanLink(Connectivity, Index, Orphan, OutOrphan);
+                    break;
+                }
+            }
+            break;
+        }
+
+        Connectivity_PushBlock(&Connectivity->Path, Current);
+        Connectivity->Stats.WalkedBlocks++;
+        Current = Connectivity_GetNeighbour(Current, Block_GetBitDirection(Parent->ParentBit));
+    }
+
+    // Later walks stop at the supported blocks of this one.
+    if (Link == CONNECTIVITY_LINK_SUPPORTED) {
+        for (size_t Index = 0; Index < FVector_GetSize(Connectivity->Path.Items); Index++) {
+            Connectivity_SetTag(Connectivity, Connectivity->Path.Items[Index], CONNECTIVITY_TAG_SUPPORTED);
+        }
+    }
+
+    return Link;
+}
+
+EConnectivityLink Connectivity_GetOrphanLink(const FConnectivity* Connectivity, U32 Orphan, const U32 Searched, U32* OutOrphan) {
+    while (Connectivity->Orphans[Orphan].State == CONNECTIVITY_ORPHAN_MERGED) {
+        Orphan = Connectivity->Orphans[Orphan].MergedInto;
+    }
+
+    if (Orphan == Searched) {
+        return CONNECTIVITY_LINK_SAME;
+    }
+
+    switch (Connectivity->Orphans[Orphan].State) {
+        case CONNECTIVITY_ORPHAN_SUPPORTED:
+            return CONNECTIVITY_LINK_SUPPORTED;
+        case CONNECTIVITY_ORPHAN_FLOATING:
+            return CONNECTIVITY_LINK_FLOATING;
+        default:
+            *OutOrphan = Orphan;
+            return CONNECTIVITY_LINK_ORPHAN;
+    }
+}
+
+void Connectivity_Reroot(FConnectivity* Connectivity, const FConnectivityBlock Block, const EDirection Direction) {
+    const FConnectivityBlock ParentPosition = Connectivity_GetNeighbour(Block, Direction);
+    FBlock* Parent = Connectivity_GetChangedBlock(Connectivity, ParentPosition.X, ParentPosition.Y, ParentPosition.Z);
+    const Byte ChildBit = Block_GetDirectionBit(Block_GetOppositeDirection(Direction));
+    Parent->ChildBits |= ChildBit;
+    Parent->TouchingBits &= (Byte)~ChildBit;
+
+    FConnectivityBlock Current = Block;
+    EDirection ParentDirection = Direction;
+    for (;;) {
+        FBlock* Child = Connectivity_GetChangedBlock(Connectivity, Current.X, Current.Y, Current.Z);
+        const Byte PreviousParentBit = Child->ParentBit;
+        const Byte ParentBit = Block_GetDirectionBit(ParentDirection);
+        Child->ParentBit = ParentBit;
+        Child->ChildBits &= (Byte)~ParentBit;
+        Child->TouchingBits &= (Byte)~ParentBit;
+        if (PreviousParentBit == 0) {
+            break;
+        }
+
+        // The previous parent becomes a child, the walk continues up to the old root.
+        Child->ChildBits |= PreviousParentBit;
+        const EDirection PreviousDirection = Block_GetBitDirection(PreviousParentBit);
+        Current = Connectivity_GetNeighbour(Current, PreviousDirection);
+        ParentDirection = Block_GetOppositeDirection(PreviousDirection);
+    }
+}
+
+void Connectivity_Support(FConnectivity* Connectivity, const FConnectivityBlock Root) {
+    FVector_Clear(Connectivity->Queue.Items);
+    Connectivity_PushBlock(&Connectivity->Queue, Root);
+    Connectivity_GetChangedBlock(Connectivity, Root.X, Root.Y, Root.Z)->Flags &= (Byte)~BLOCK_FLAG_FLOATING;
+    size_t Head = Connectivity_SupportTrees(Connectivity, 0);
+
+    // Floating trees split by earlier removals touch without a tree link, they join this tree.
+    for (size_t Scanned = 0; Scanned < FVector_GetSize(Connectivity->Queue.Items); Scanned++) {
+        const FConnectivityBlock Current = Connectivity->Queue.Items[Scanned];
+        const FBlock* Block = Connectivity_GetChangedBlock(Connectivity, Current.X, Current.Y, Current.Z);
+        for (EDirection Direction = XPositive; Direction <= ZNegative; Direction++) {
+            if (!(Block->TouchingBits & Block_GetDirectionBit(Direction))) {
+                continue;
+            }
+
+            const FConnectivityBlock Neighbour = Connectivity_GetNeighbour(Current, Direction);
+            FBlock* NeighbourBlock = Connectivity_GetChangedBlock(Connectivity, Neighbour.X, Neighbour.Y, Neighbour.Z);
+            if (NeighbourBlock == NULL || !(NeighbourBlock->Flags & BLOCK_FLAG_FLOATING)) {
+                continue;
+            }
+
+            // The tree is cleared before the next touching block, so a floating block is never in a tree joined already.
+            Connectivity_Reroot(Connectivity, Neighbour, Block_GetOppositeDirection(Direction));
+            NeighbourBlock->Flags &= (Byte)~BLOCK_FLAG_FLOATING;
+            Connectivity_PushBlock(&Connectivity->Queue, Neighbour);
+            Head = Connectivity_SupportTrees(Connectivity, Head);
+        }
+    }
+}
+
+size_t Connectivity_SupportTrees(FConnectivity* Connectivity, size_t Head) {
+    for (; Head < FVector_GetSize(Connectivity->Queue.Items); Head++) {
+        const FConnectivityBlock Current = Connectivity->Queue.Items[Head];
+        const FBlock* Block = Connectivity_GetChangedBlock(Connectivity, Current.X, Current.Y, Current.Z);
+        Connectivity->Stats.VisitedBlocks++;
+
+        for (EDirection Direction = XPositive; Direction <= ZNegative; Direction++) {
+            if (!(Block->ChildBits & Block_GetDirectionBit(Direction))) {
+                continue;
+            }
+
+            const FConnectivityBlock Child = Connectivity_GetNeighbour(Current, Direction);
+            FBlock* ChildBlock = Connectivity_GetChangedBlock(Connectivity, Child.X, Child.Y, Child.Z);
+            if (ChildBlock != NULL) {
+                ChildBlock->Flags &= (Byte)~BLOCK_FLAG_FLOATING;
+                Connectivity_PushBlock(&Connectivity->Queue, Child);
+            }
+        }
+    }
+
+    return Head;
+}
+
+void Connectivity_ResetTags(FConnectivity* Connectivity) {
+    Connectivity->Count = 0;
+    Connectivity->Generation++;
+
+    // Slots of a wrapped generation would look tagged again.
+    if (Connectivity->Generation == 0) {
+        memset(Connectivity->Slots, 0, Connectivity->Capacity * sizeof *Connectivity->Slots);
+        Connectivity->Generation = 1;
+    }
+}
+
+Bool Connectivity_GetTag(const FConnectivity* Connectivity, const FConnectivityBlock Block, Byte* OutTag) {
+    const U64 Key = Connectivity_GetKey(Block);
+    const U32 Mask = Connectivity->Capacity - 1;
+    for (U32 Slot = (U32)(Key * 0x9E3779B97F4A7C15ull >> 40) & Mask;; Slot = (Slot + 1) & Mask) {
+        const FConnectivitySlot* Entry = &Connectivity->Slots[Slot];
+        if (Entry->Generation != Connectivity->Generation) {
+            return False;
+        }
+        if (Entry->Key == Key) {
+            *OutTag = Entry->Tag;
+            return True;
+        }
+    }
+}
+
+void Connectivity_SetTag(FConnectivity* Connectivity, const FConnectivityBlock Block, const Byte Tag) {
+    // Keep the load factor under a half so probe sequences stay short.
+    if ((Connectivity->Count + 1) * 2 > Connectivity->Capacity) {
+        Connectivity_Resize(Connectivity, Connectivity->Capacity * 2);
+    }
+
+    const U64 Key = Connectivity_GetKey(Block);
+    const U32 Mask = Connectivity->Capacity - 1;
+    for (U32 Slot = (U32)(Key * 0x9E3779B97F4A7C15ull >> 40) & Mask;; Slot = (Slot + 1) & Mask) {
+        FConnectivitySlot* Entry = &Connectivity->Slots[Slot];
+        if (Entry->Generation != Connectivity->Generation) {
+            *Entry = (FConnectivitySlot){Key, Connectivity->Generation, Tag};
+            Connectivity->Count++;
+            return;
+        }
+        if (Entry->Key == Key) {
+            Entry->Tag = Tag;
+            return;
+        }
+    }
+}
+
+Bool Connectivity_Resize(FConnectivity* Connectivity, const U32 Capacity) {
+    FConnectivitySlot* Slots = calloc(Capacity, sizeof *Slots);
+    if (Slots == NULL) {
+        return False;
+    }
+
+    FConnectivitySlot* PreviousSlots = Connectivity->Slots;
+    const U32 PreviousCapacity = Connectivity->Capacity;
+    const U32 Generation = Connectivity->Generation == 0 ? 1 : Connectivity->Generation;
+
+    Connectivity->Slots = Slots;
+    Connectivity->Capacity = Capacity;
+    Connectivity->Generation = Generation;
+
+    const U32 Mask = Capacity - 1;
+    for (U32 Index = 0; Index < PreviousCapacity; Index++) {
+        const FConnectivitySlot* Entry = &PreviousSlots[Index];
+        if (Entry->Generation != Generation) {
+            continue;
+        }
+
+        U32 Slot = (U32)(Entry->Key * 0x9E3779B97F4A7C15ull >> 40) & Mask;
+        while (Slots[Slot].Generation == Generation) {
+            Slot = (Slot + 1) & Mask;
+        }
+        Slots[Slot] = *Entry;
+    }
+
+    free(PreviousSlots);
+
+    return True;
+}
+
+U64 Connectivity_GetKey(const FConnectivityBlock Block) {
+    return ((U64)((U32)Block.X & 0x1FFFFF) << 42) | ((U64)((U32)Block.Y & 0x1FFFFF) << 21) | (U64)((U32)Block.Z & 0x1FFFFF);
+}
+
+void Connectivity_PushBlock(FConnectivityBlockList* List, const FConnectivityBlock Block) {
+    if (FVector_GetSize(List->Items) == FVector_GetCapacity(List->Items)) {
+        const size_t Capacity = FVector_GetCapacity(List->Items) * 2 + 64;
+        FVector_Reserve(List->Items, Capacity);
+    }
+    FVector_Add(List->Items, Block);
+}
+#pragma endregion
@@ -0,0 +1,60 @@
+#pragma once
+#include "typedefs.h"
+#include "chunk.h"
+#include "world.h"
+
+/**
+ * Keeps the block hierarchy of ParentBit, ChildBits and TouchingBits consistent with the solid blocks of a world and
+ * finds structures cut off from the ground. Every solid block either is anchored ground or has a parent leading to
+ * the ground, touching bits mark the other solid neighbours.
+ */
+typedef struct FConnectivity FConnectivity;
+
+/** World block position. */
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+} FConnectivityBlock;
+
+/** Called once per chunk whose blocks had their hierarchy bits changed by an edit. */
+typedef void (*ConnectivityChunkHandler)(FChunk* Chunk, void* UserData);
+
+typedef struct {
+    /** Blocks visited in the structures around the last edit and blocks walked toward the ground. */
+    U32 VisitedBlocks;
+    U32 WalkedBlocks;
+    /** Totals since the connectivity was created. */
+    U64 ReattachedStructures;
+    U64 FloatingStructures;
+} FConnectivityStats;
+
+/** Creates the connectivity of the world, the handler is optional. Returns NULL on failure. */
+FConnectivity* Connectivity_Create(FWorld* World, ConnectivityChunkHandler OnChunkChanged, void* UserData);
+
+void Connectivity_Destroy(FConnectivity* Connectivity);
+
+/**
+ * Links a block that became solid to its solid neighbours. The block gets a supported neighbour as its parent, below
+ * first, and floating structures it touches are supported through it. A block without a supported neighbour is
+ * floating, and reported as a batch when it touches no floating structure either.
+ */
+void Connectivity_AddBlock(FConnectivity* Connectivity, I32 X, I32 Y, I32 Z);
+
+/**
+ * Unlinks a block that stopped being solid. Only the subtrees of its children are searched: each is reattached to
+ * the first supported block it touches, or reported as a floating batch when it touches none. Removing a floating
+ * block only unlinks it. Blocks in chunks that aren't loaded are assumed supported.
+ */
+void Connectivity_RemoveBlock(FConnectivity* Connectivity, I32 X, I32 Y, I32 Z);
+
+/** Returns the number of floating structures found since the batches were last cleared. */
+U32 Connectivity_GetBatchCount(const FConnectivity* Connectivity);
+
+/** Returns the blocks of the floating structure, they stay in the world and are flagged BLOCK_FLAG_FLOATING. */
+const FConnectivityBlock* Connectivity_GetBatch(const FConnectivity* Connectivity, U32 Index, U32* OutCount);
+
+/** Drops the reported batches, usually after their collapse was handled. */
+void Connectivity_ClearBatches(FConnectivity* Connectivity);
+
+void Connectivity_GetStats(const FConnectivity* Connectivity, FConnectivityStats* OutStats);
@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "check.h"
+#include "connectivity.h"
+
+#pragma region Settings
+/** Ground chunks, 2x2 around the chunk corner at X = Z = CHUNK_SIZE. */
+#define CONNECTIVITY_TEST_CHUNKS 4
+#define CONNECTIVITY_TEST_PILLAR_HEIGHT 5
+#define CONNECTIVITY_TEST_PLATFORM_SIZE 5
+/** Longest parent chain walked before a block counts as unsupported. */
+#define CONNECTIVITY_TEST_MAX_CHAIN 4096
+#pragma endregion
+
+typedef struct {
+    FChunk* Chunks[CONNECTIVITY_TEST_CHUNKS];
+    FWorld* World;
+    FConnectivity* Connectivity;
+} FConnectivityTest;
+
+#pragma region Private Function Declarations
+static void ConnectivityTest_Create(FConnectivityTest* Test);
+static void ConnectivityTest_Destroy(FConnectivityTest* Test);
+static void ConnectivityTest_Set(FConnectivityTest* Test, I32 X, I32 Y, I32 Z, Byte Type);
+static FBlock* ConnectivityTest_GetBlock(const FConnectivityTest* Test, I32 X, I32 Y, I32 Z);
+static void ConnectivityTest_CheckHierarchy(const FConnectivityTest* Test);
+static void ConnectivityTest_Wall(FConnectivityTest* Test);
+static void ConnectivityTest_Platform(FConnectivityTest* Test);
+#pragma endregion
+
+int main() {
+    FConnectivityTest Test;
+    ConnectivityTest_Create(&Test);
+
+    ConnectivityTest_Wall(&Test);
+    ConnectivityTest_Platform(&Test);
+
+    ConnectivityTest_Destroy(&Test);
+
+    printf("connectivity_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void ConnectivityTest_Create(FConnectivityTest* Test) {
+    Test->World = World_Create();
+    CHECK(Test->World != NULL);
+    Test->Connectivity = Connectivity_Create(Test->World, NULL, NULL);
+    CHECK(Test->Connectivity != NULL);
+
+    // Anchored ground layer, the way terrain generation flags it.
+    for (U32 Index = 0; Index < CONNECTIVITY_TEST_CHUNKS; Index++) {
+        FChunk* Chunk = Chunk_Create((I32)(Index & 1), 0, (I32)(Index >> 1));
+        CHECK(Chunk != NULL);
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                FBlock* Block = &Chunk->Blocks[Chunk_GetBlockIndex(X, 0, Z)];
+                Block->Type = BLOCK_TYPE_STONE;
+                Block->Flags = BLOCK_FLAG_ANCHORED;
+            }
+        }
+        Chunk_UpdateBlockCount(Chunk);
+        World_AddChunk(Test->World, Chunk);
+        Test->Chunks[Index] = Chunk;
+    }
+}
+
+void ConnectivityTest_Destroy(FConnectivityTest* Test) {
+    Connectivity_Destroy(Test->Connectivity);
+    World_Destroy(Test->World);
+    for (U32 Index = 0; Index < CONNECTIVITY_TEST_CHUNKS; Index++) {
+        Chunk_Destroy(Test->Chunks[Index]);
+    }
+}
+
+void ConnectivityTest_Set(FConnectivityTest* Test, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+    if (Type == BLOCK_TYPE_AIR) {
+        Connectivity_RemoveBlock(Test->Connectivity, X, Y, Z);
+    } else {
+        Connectivity_AddBlock(Test->Connectivity, X, Y, Z);
+    }
+}
+
+FBlock* ConnectivityTest_GetBlock(const FConnectivityTest* Test, const I32 X, const I32 Y, const I32 Z) {
+    FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    return Chunk != NULL ? &Chunk->Blocks[Chunk_GetBlockIndex(World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z))]
+                         : NULL;
+}
+
+void ConnectivityTest_CheckHierarchy(const FConnectivityTest* Test) {
+    for (I32 Y = 1; Y < CHUNK_SIZE; Y++) {
+        for (I32 Z = 0; Z < 2 * CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < 2 * CHUNK_SIZE; X++) {
+                const FBlock* Block = ConnectivityTest_GetBlock(Test, X, Y, Z);
+                if (!Block_IsSolid(Block->Type) || (Block->Flags & BLOCK_FLAG_FLOATING)) {
+                    continue;
+                }
+
+                // Supported blocks lead to the ground through parents that list them as children.
+                I32 CurrentX = X;
+                I32 CurrentY = Y;
+                I32 CurrentZ = Z;
+                const FBlock* Current = Block;
+                U32 Steps = 0;
+                while (!(Current->Flags & BLOCK_FLAG_ANCHORED)) {
+                    CHECK(Current->ParentBit != 0 && Steps++ < CONNECTIVITY_TEST_MAX_CHAIN);
+                    const EDirection Direction = Block_GetBitDirection(Current->ParentBit);
+                    CurrentX += BlockDirectionOffsets[Direction][0];
+                    CurrentY += BlockDirectionOffsets[Direction][1];
+                    CurrentZ += BlockDirectionOffsets[Direction][2];
+
+                    const FBlock* Parent = ConnectivityTest_GetBlock(Test, CurrentX, CurrentY, CurrentZ);
+                    CHECK(Parent != NULL && Block_IsSolid(Parent->Type));
+                    CHECK(Parent->ChildBits & Block_GetDirectionBit(Block_GetOppositeDirection(Direction)));
+                    Current = Parent;
+                }
+            }
+        }
+    }
+}
+
+void ConnectivityTest_Wall(FConnectivityTest* Test) {
+    // A wall across the chunk border, its columns hold each other up.
+    for (I32 Y = 1; Y <= 4; Y++) {
+        for (I32 X = CHUNK_SIZE - 4; X < CHUNK_SIZE + 4; X++) {
+            ConnectivityTest_Set(Test, X, Y, 4, BLOCK_TYPE_STONE);
+        }
+    }
+    CHECK(Connectivity_GetBatchCount(Test->Connectivity) == 0);
+    ConnectivityTest_CheckHierarchy(Test);
+
+    // Removing a block at the bottom reattaches the blocks above to the next column.
+    FConnectivityStats Before;
+    Connectivity_GetStats(Test->Connectivity, &Before);
+    ConnectivityTest_Set(Test, CHUNK_SIZE, 1, 4, BLOCK_TYPE_AIR);
+    ConnectivityTest_Set(Test, CHUNK_SIZE - 1, 1, 4, BLOCK_TYPE_AIR);
+
+    FConnectivityStats After;
+    Connectivity_GetStats(Test->Connectivity, &After);
+    CHECK(Connectivity_GetBatchCount(Test->Connectivity) == 0);
+    CHECK(After.FloatingStructures == Before.FloatingStructures);
+    for (I32 Y = 2; Y <= 4; Y++) {
+        CHECK(!(ConnectivityTest_GetBlock(Test, CHUNK_SIZE, Y, 4)->Flags & BLOCK_FLAG_FLOATING));
+    }
+    ConnectivityTest_CheckHierarchy(Test);
+}
+
+void ConnectivityTest_Platform(FConnectivityTest* Test) {
+    const I32 Center = CHUNK_SIZE;
+    for (I32 Y = 1; Y <= CONNECTIVITY_TEST_PILLAR_HEIGHT; Y++) {
+        ConnectivityTest_Set(Test, Center, Y, Center, BLOCK_TYPE_STONE);
+    }
+
+    // Platform blocks placed before the one over the pillar float until it joins them to the pillar.
+    const I32 Begin = Center - CONNECTIVITY_TEST_PLATFORM_SIZE / 2;
+    const I32 PlatformY = CONNECTIVITY_TEST_PILLAR_HEIGHT + 1;
+    for (I32 Z = Begin; Z < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; Z++) {
+        for (I32 X = Begin; X < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; X++) {
+            ConnectivityTest_Set(Test, X, PlatformY, Z, BLOCK_TYPE_STONE);
+        }
+    }
+    Connectivity_ClearBatches(Test->Connectivity);
+    ConnectivityTest_CheckHierarchy(Test);
+    for (I32 Z = Begin; Z < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; Z++) {
+        for (I32 X = Begin; X < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; X++) {
+            CHECK(!(ConnectivityTest_GetBlock(Test, X, PlatformY, Z)->Flags & BLOCK_FLAG_FLOATING));
+        }
+    }
+
+    // Removing the top of the pillar cuts the whole platform off as one floating structure.
+    FConnectivityStats Before;
+    Connectivity_GetStats(Test->Connectivity, &Before);
+    ConnectivityTest_Set(Test, Center, CONNECTIVITY_TEST_PILLAR_HEIGHT, Center, BLOCK_TYPE_AIR);
+
+    FConnectivityStats After;
+    Connectivity_GetStats(Test->Connectivity, &After);
+    CHECK(After.FloatingStructures == Before.FloatingStructures + 1);
+    CHECK(Connectivity_GetBatchCount(Test->Connectivity) == 1);
+
+    U32 Count = 0;
+    const FConnectivityBlock* Batch = Connectivity_GetBatch(Test->Connectivity, 0, &Count);
+    CHECK(Batch != NULL && Count == CONNECTIVITY_TEST_PLATFORM_SIZE * CONNECTIVITY_TEST_PLATFORM_SIZE);
+    for (U32 Index = 0; Index < Count; Index++) {
+        CHECK(Batch[Index].Y == PlatformY);
+        CHECK(Batch[Index].X >= Begin && Batch[Index].X < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE);
+        CHECK(Batch[Index].Z >= Begin && Batch[Index].Z < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE);
+        CHECK(ConnectivityTest_GetBlock(Test, Batch[Index].X, Batch[Index].Y, Batch[Index].Z)->Flags & BLOCK_FLAG_FLOATING);
+        for (U32 Other = 0; Other < Index; Other++) {
+            CHECK(Batch[Other].X != Batch[Index].X || Batch[Other].Z != Batch[Index].Z);
+        }
+    }
+
+    // The rest of the pillar and the wall stay supported.
+    for (I32 Y = 1; Y < CONNECTIVITY_TEST_PILLAR_HEIGHT; Y++) {
+        CHECK(!(ConnectivityTest_GetBlock(Test, Center, Y, Center)->Flags & BLOCK_FLAG_FLOATING));
+    }
+    ConnectivityTest_CheckHierarchy(Test);
+    Connectivity_ClearBatches(Test->Connectivity);
+
+    // Removing a floating block only unlinks it.
+    ConnectivityTest_Set(Test, Begin, PlatformY, Begin, BLOCK_TYPE_AIR);
+    CHECK(Connectivity_GetBatchCount(Test->Connectivity) == 0);
+
+    // Replacing the support joins the platform to the pillar again.
+    ConnectivityTest_Set(Test, Center, CONNECTIVITY_TEST_PILLAR_HEIGHT, Center, BLOCK_TYPE_STONE);
+    CHECK(Connectivity_GetBatchCount(Test->Connectivity) == 0);
+    for (I32 Z = Begin; Z < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; Z++) {
+        for (I32 X = Begin; X < Begin + CONNECTIVITY_TEST_PLATFORM_SIZE; X++) {
+            const FBlock* Block = ConnectivityTest_GetBlock(Test, X, PlatformY, Z);
+            CHECK(!Block_IsSolid(Block->Type) || !(Block->Flags & BLOCK_FLAG_FLOATING));
+        }
+    }
+    ConnectivityTest_CheckHierarchy(Test);
+}
+#pragma endregion
@@ -106,6 +106,29 @@
 		}                                                                     \
 	} while (0)
 
+/**
+ * @brief FVector_Reserve - ensures that the vector can hold at least <count> elements without reallocation
+ * @param vec - the vector
+ * @param count - the minimum capacity
+ * @return void
+ */
+#define FVector_Reserve(vec, count)                  \
+	do {                                             \
+		if (FVector_GetCapacity(vec) < (size_t)(count)) { \
+			FVector_Grow((vec), (count));            \
+		}                                            \
+	} while (0)
+
+/**
+ * @brief FVector_Clear - removes all elements from the vector keeping its capacity
+ * @param vec - the vector
+ * @return void
+ */
+#define FVector_Clear(vec)          \
+	do {                            \
+		FVector_SetSize((vec), 0);  \
+	} while (0)
+
 /**
  * @brief FVector_PopBack - removes the last element from the vector
  * @param vec - the vector
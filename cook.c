@@ -0,0 +1,617 @@
+#include "cook.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "bcn.h"
+#include "containers/vector.h"
+#include "dds.h"
+#include "file.h"
+#include "hash.h"
+#include "image.h"
+#include "shader_source.h"
+#include "thread.h"
+
+#pragma region Settings
+/** Manifest of the last run, in the output directory. */
+static const pStr ManifestName = "cook.manifest";
+#define COOK_MANIFEST_HEADER "shquarkz-cook %d\n"
+#define COOK_ERROR_LENGTH 256
+#pragma endregion
+
+#pragma region Private Types
+/** Manifest entry of a cooked asset. */
+typedef struct {
+    pStr SourcePath;
+    /** Hash of the inputs the output was cooked from. */
+    U64 Key;
+    U64 OutputHash;
+    /** Set if the source still exists, the outputs of the others are deleted. */
+    Bool bVisited;
+} FCookRecord;
+
+typedef enum {
+    COOK_RESULT_COOKED = 0,
+    COOK_RESULT_SKIPPED,
+    COOK_RESULT_FAILED,
+} ECookResult;
+
+typedef struct {
+    pStr SourcePath;
+    char OutputPath[COOK_PATH_LENGTH];
+    /** Source contents, flattened source for shaders, hashed into the key. */
+    U8* Data;
+    U64 Length;
+    U64 Key;
+    U64 OutputHash;
+    U64 OutputLength;
+    /** Record of the previous run, NULL for new assets. */
+    const FCookRecord* Previous;
+    ECookResult Result;
+    char Error[COOK_ERROR_LENGTH];
+} FCookJob;
+
+typedef struct {
+    /** Extension of the source including the dot. */
+    pStr Extension;
+    /** Extension of the output, the source one if NULL. */
+    pStr OutputExtension;
+    /** Loads the data of the job, NULL reads the source file. */
+    Bool (*Load)(FCookJob* Job);
+    /** Writes the output of the job to the path. */
+    Bool (*Cook)(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+} FCookHandler;
+
+/** Jobs shared by the cooking threads, taken in order. */
+typedef struct {
+    const FCookSettings* Settings;
+    FCookJob* Jobs;
+    U32 JobCount;
+    U32 NextJob;
+    /** Hash of the cooker version and settings, the seed of every key. */
+    U64 Seed;
+    FMutex* Mutex;
+} FCookContext;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static Bool Cook_LoadShader(FCookJob* Job);
+
+static Bool Cook_Tga(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+static Bool Cook_Dds(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+static Bool Cook_Shader(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+static Bool Cook_Font(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+static Bool Cook_Copy(const FCookSettings* Settings, FCookJob* Job, pStr Path);
+
+/** Compresses the image and the mip levels downsampled from it into a DDS file. */
+static Bool Cook_WriteTexture(const FImage* Image, EDdsFormat Format, FCookJob* Job, pStr Path);
+
+static Bool Cook_WriteFile(pStr Path, const void* Data, U64 Length, FCookJob* Job);
+
+/** Returns the handler of the source extension, the copying one for unknown files. */
+static const FCookHandler* Cook_FindHandler(pStr SourcePath);
+
+/** Reads the manifest of the previous run into records sorted by path. Returns an empty vector without one. */
+static FVector(FCookRecord) Cook_ReadManifest(const FCookSettings* Settings);
+
+static Bool Cook_WriteManifest(const FCookSettings* Settings, const FCookJob* Jobs, U32 JobCount);
+
+static int Cook_CompareRecords(const void* A, const void* B);
+static int Cook_ComparePaths(const void* A, const void* B);
+
+static void Cook_AddPath(pStr Path, void* UserData);
+
+/** Cooking thread, takes jobs until there are none left. */
+static int Cook_Work(void* UserData);
+
+static void Cook_ProcessJob(const FCookContext* Context, FCookJob* Job);
+#pragma endregion
+
+#pragma region Private Variables
+static const FCookHandler Handlers[] = {
+    {".tga", ".dds", NULL, Cook_Tga},
+    {".dds", NULL, NULL, Cook_Dds},
+    {".glsl", NULL, Cook_LoadShader, Cook_Shader},
+    {".ttf", ".sdf", NULL, Cook_Font},
+};
+static const FCookHandler CopyHandler = {NULL, NULL, NULL, Cook_Copy};
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Cook_GetDefaultSettings(FCookSettings* OutSettings) {
+    memset(OutSettings, 0, sizeof *OutSettings);
+    OutSettings->SourceDirectory = "assets";
+    OutSettings->OutputDirectory = "cooked";
+    FontAtlas_GetDefaultSettings(&OutSettings->FontAtlasSettings);
+}
+
+Bool Cook_Run(const FCookSettings* Settings, FCookStats* OutStats) {
+    memset(OutStats, 0, sizeof *OutStats);
+
+    // Cooking into the source tree would overwrite the sources.
+    char SourceOutput[COOK_PATH_LENGTH];
+    snprintf(SourceOutput, sizeof SourceOutput, "%s/%s", Settings->OutputDirectory, Settings->SourceDirectory);
+    struct stat SourceStat, OutputStat;
+    if (stat(Settings->SourceDirectory, &SourceStat) == 0 && stat(SourceOutput, &OutputStat) == 0 && SourceStat.st_ino != 0 &&
+        SourceStat.st_dev == OutputStat.st_dev && SourceStat.st_ino == OutputStat.st_ino) {
+        fprintf(stderr, "Output directory %s would overwrite the sources\n", Settings->OutputDirectory);
+        return False;
+    }
+
+    FVector(pStr) Paths = NULL;
+    if (!File_VisitDirectory(Settings->SourceDirectory, Cook_AddPath, &Paths)) {
+        fprintf(stderr, "Failed to open directory %s\n", Settings->SourceDirectory);
+        return False;
+    }
+
+    // Sorted paths keep the manifest stable between runs.
+    const U32 PathCount = (U32)FVector_GetSize(Paths);
+    if (PathCount > 0) {
+        qsort(Paths, PathCount, sizeof(pStr), Cook_ComparePaths);
+    }
+
+    FVector(FCookRecord) Records = Cook_ReadManifest(Settings);
+    const U32 RecordCount = (U32)FVector_GetSize(Records);
+
+    FCookJob* Jobs = calloc(PathCount > 0 ? PathCount : 1, sizeof *Jobs);
+    if (Jobs == NULL) {
+        FVector_Free(Paths);
+        return False;
+    }
+
+    for (U32 Index = 0; Index < PathCount; Index++) {
+        FCookJob* Job = &Jobs[Index];
+        Job->SourcePath = Paths[Index];
+        Cook_GetOutputPath(Settings, Job->SourcePath, Job->OutputPath, sizeof Job->OutputPath);
+
+        const FCookRecord Key = {Job->SourcePath};
+        FCookRecord* Record = RecordCount > 0 ? bsearch(&Key, Records, RecordCount, sizeof(FCookRecord), Cook_CompareRecords) : NULL;
+        if (Record != NULL) {
+            Record->bVisited = True;
+            Job->Previous = Record;
+        }
+    }
+
+    FCookContext Context = {0};
+    Context.Settings = Settings;
+    Context.Jobs = Jobs;
+    Context.JobCount = PathCount;
+    Context.Seed = Hash_Compute(&Settings->FontAtlasSettings, sizeof Settings->FontAtlasSettings, COOK_VERSION);
+    Context.Mutex = Mutex_Create();
+
+    // The calling thread cooks too, the others only start if there are jobs for them.
+    U32 ThreadCount = Settings->JobCount > 0 ? Settings->JobCount : Thread_GetProcessorCount();
+    ThreadCount = ThreadCount < PathCount ? ThreadCount : PathCount;
+    FVector(FThread*) Threads = NULL;
+    for (U32 Index = 1; Index < ThreadCount && Context.Mutex != NULL; Index++) {
+        FThread* Thread = Thread_Create(Cook_Work, "Cook", &Context);
+        if (Thread != NULL) {
+            FVector_Add(Threads, Thread);
+        }
+    }
+
+    Cook_Work(&Context);
+    for (U32 Index = 0; Index < FVector_GetSize(Threads); Index++) {
+        Thread_Join(Threads[Index]);
+    }
+    FVector_Free(Threads);
+    if (Context.Mutex != NULL) {
+        Mutex_Destroy(Context.Mutex);
+    }
+
+    for (U32 Index = 0; Index < PathCount; Index++) {
+        const FCookJob* Job = &Jobs[Index];
+        OutStats->Cooked += Job->Result == COOK_RESULT_COOKED;
+        OutStats->Skipped += Job->Result == COOK_RESULT_SKIPPED;
+        OutStats->Failed += Job->Result == COOK_RESULT_FAILED;
+        OutStats->Bytes += Job->Result == COOK_RESULT_COOKED ? Job->OutputLength : 0;
+    }
+
+    for (U32 Index = 0; Index < RecordCount; Index++) {
+        if (Records[Index].bVisited) {
+            continue;
+        }
+
+        char OutputPath[COOK_PATH_LENGTH];
+        Cook_GetOutputPath(Settings, Records[Index].SourcePath, OutputPath, sizeof OutputPath);
+        if (remove(OutputPath) == 0) {
+            printf("removed %s\n", OutputPath);
+            OutStats->Removed++;
+        }
+    }
+
+    const Bool bManifestWritten = Cook_WriteManifest(Settings, Jobs, PathCount);
+
+    for (U32 Index = 0; Index < PathCount; Index++) {
+        free(Paths[Index]);
+    }
+    for (U32 Index = 0; Index < RecordCount; Index++) {
+        free(Records[Index].SourcePath);
+    }
+    FVector_Free(Paths);
+    FVector_Free(Records);
+    free(Jobs);
+
+    return bManifestWritten && OutStats->Failed == 0;
+}
+
+void Cook_GetOutputPath(const FCookSettings* Settings, const pStr SourcePath, char* OutPath, const size_t Size) {
+    const FCookHandler* Handler = Cook_FindHandler(SourcePath);
+    const size_t Length = strlen(SourcePath);
+    const size_t StemLength = Handler->OutputExtension != NULL ? Length - strlen(Handler->Extension) : Length;
+
+    snprintf(OutPath, Size, "%s/%.*s%s", Settings->OutputDirectory, (int)StemLength, SourcePath, Handler->OutputExtension != NULL ? Handler->OutputExtension : "");
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+Bool Cook_LoadShader(FCookJob* Job) {
+    // Includes are resolved here, so a change to an included file changes the key.
+    I64 Length = 0;
+    Job->Data = (U8*)ShaderSource_Load(Job->SourcePath, NULL, 0, &Length);
+    if (Job->Data == NULL) {
+        snprintf(Job->Error, sizeof Job->Error, "can't read the shader or its includes");
+        return False;
+    }
+
+    Job->Length = (U64)Length;
+    return True;
+}
+
+Bool Cook_Tga(const FCookSettings* Settings, FCookJob* Job, const pStr Path) {
+    FImage Image;
+    if (!Image_ReadTga(Job->Data, Job->Length, &Image)) {
+        snprintf(Job->Error, sizeof Job->Error, "not a true color or grayscale TGA image");
+        return False;
+    }
+
+    const Bool bWritten = Cook_WriteTexture(&Image, Image_HasAlpha(&Image) ? DDS_FORMAT_DXT5 : DDS_FORMAT_DXT1, Job, Path);
+    Image_Free(&Image);
+    return bWritten;
+}
+
+Bool Cook_Dds(const FCookSettings* Settings, FCookJob* Job, const pStr Path) {
+    FDdsImage Dds;
+    if (!Dds_Parse(Job->Data, Job->Length, &Dds)) {
+        snprintf(Job->Error, sizeof Job->Error, "not a DXT1, DXT3 or DXT5 DDS image");
+        return False;
+    }
+
+    // Complete chains are upload ready, trailing bytes are dropped.
+    const FDdsMipLevel* LastLevel = &Dds.MipLevels[Dds.MipLevelCount - 1];
+    if (Dds.MipLevelCount == Dds_GetFullMipLevelCount(Dds.Width, Dds.Height)) {
+        return Cook_WriteFile(Path, Job->Data, (U64)LastLevel->Offset + LastLevel->Size, Job);
+    }
+
+    FImage Image;
+    if (!Bcn_DecodeImage(Job->Data + Dds.MipLevels[0].Offset, Dds.Format, Dds.Width, Dds.Height, &Image)) {
+        snprintf(Job->Error, sizeof Job->Error, "can't decode the first mip level");
+        return False;
+    }
+
+    const Bool bWritten = Cook_WriteTexture(&Image, Dds.Format, Job, Path);
+    Image_Free(&Image);
+    return bWritten;
+}
+
+Bool Cook_Shader(const FCookSettings* Settings, FCookJob* Job, const pStr Path) {
+    char Error[COOK_ERROR_LENGTH];
+    if (!ShaderSource_Validate((const char*)Job->Data, (I64)Job->Length, Error, sizeof Error)) {
+        snprintf(Job->Error, sizeof Job->Error, "%s", Error);
+        return False;
+    }
+
+    return Cook_WriteFile(Path, Job->Data, Job->Length, Job);
+}
+
+Bool Cook_Font(const FCookSettings* Settings, FCookJob* Job, const pStr Path) {
+    FFontAtlas Atlas;
+    if (!FontAtlas_Build(Job->Data, Job->Length, &Settings->FontAtlasSettings, &Atlas)) {
+        snprintf(Job->Error, sizeof Job->Error, "can't read the TrueType outlines");
+        return False;
+    }
+
+    const Bool bWritten = FontAtlas_Write(&Atlas, Path);
+    FontAtlas_Free(&Atlas);
+    if (!bWritten) {
+        snprintf(Job->Error, sizeof Job->Error, "can't write the atlas");
+    }
+
+    return bWritten;
+}
+
+Bool Cook_Copy(const FCookSettings* Settings, FCookJob* Job, const pStr Path) {
+    return Cook_WriteFile(Path, Job->Data, Job->Length, Job);
+}
+
+Bool Cook_WriteTexture(const FImage* Image, const EDdsFormat Format, FCookJob* Job, const pStr Path) {
+    const U32 LevelCount = Dds_GetFullMipLevelCount(Image->Width, Image->Height);
+    const U32 BlockSize = Dds_GetBlockSize(Format);
+
+    U64 Size = DDS_HEADER_SIZE;
+    for (U32 Level = 0, Width = Image->Width, Height = Image->Height; Level < LevelCount; Level++) {
+        Size += (U64)(Width + 3) / 4 * ((Height + 3) / 4) * BlockSize;
+        Width = Width > 1 ? Width / 2 : 1;
+        Height = Height > 1 ? Height / 2 : 1;
+    }
+
+    U8* Data = malloc(Size);
+    if (Data == NULL) {
+        snprintf(Job->Error, sizeof Job->Error, "out of memory");
+        return False;
+    }
+
+    Dds_WriteHeader(Format, Image->Width, Image->Height, LevelCount, Data);
+
+    // Every level is downsampled from the one above it, the source image is only borrowed.
+    U64 Offset = DDS_HEADER_SIZE;
+    FImage LevelImage = *Image;
+    Bool bSucceeded = True;
+    for (U32 Level = 0; Level < LevelCount && bSucceeded; Level++) {
+        Offset += Bcn_EncodeImage(&LevelImage, Format, Data + Offset);
+        if (Level + 1 == LevelCount) {
+            break;
+        }
+
+        FImage NextImage;
+        bSucceeded = Image_Downsample(&LevelImage, &NextImage);
+        if (Level > 0) {
+            Image_Free(&LevelImage);
+        }
+        LevelImage = NextImage;
+    }
+    if (LevelImage.Pixels != Image->Pixels) {
+        Image_Free(&LevelImage);
+    }
+
+    if (!bSucceeded) {
+        snprintf(Job->Error, sizeof Job->Error, "out of memory");
+        free(Data);
+        return False;
+    }
+
+    const Bool bWritten = Cook_WriteFile(Path, Data, Size, Job);
+    free(Data);
+    return bWritten;
+}
+
+Bool Cook_WriteFile(const pStr Path, const void* Data, const U64 Length, FCookJob* Job) {
+    FILE* File = fopen(Path, "wb");
+    if (File == NULL) {
+        snprintf(Job->Error, sizeof Job->Error, "can't open the output");
+        return False;
+    }
+
+    const Bool bWritten = Length == 0 || fwrite(Data, (size_t)Length, 1, File) == 1;
+    if (fclose(File) != 0 || !bWritten) {
+        snprintf(Job->Error, sizeof Job->Error, "can't write the output");
+        return False;
+    }
+
+    return True;
+}
+
+const FCookHandler* Cook_FindHandler(const pStr SourcePath) {
+    const size_t Length = strlen(SourcePath);
+    for (U32 Index = 0; Index < sizeof Handlers / sizeof Handlers[0]; Index++) {
+        const size_t ExtensionLength = strlen(Handlers[Index].Extension);
+        if (Length > ExtensionLength && strcmp(SourcePath + Length - ExtensionLength, Handlers[Index].Extension) == 0) {
+            return &Handlers[Index];
+        }
+    }
+
+    return &CopyHandler;
+}
+
+FVector(FCookRecord) Cook_ReadManifest(const FCookSettings* Settings) {
+    char ManifestPath[COOK_PATH_LENGTH];
+    snprintf(ManifestPath, sizeof ManifestPath, "%s/%s", Settings->OutputDirectory, ManifestName);
+
+    I64 Length = 0;
+    const pStr Manifest = File_ReadText(ManifestPath, &Length);
+    if (Manifest == NULL) {
+        return NULL;
+    }
+
+    // Manifests of other versions are ignored, every asset is cooked again.
+    char Header[64];
+    snprintf(Header, sizeof Header, COOK_MANIFEST_HEADER, COOK_VERSION);
+    const size_t HeaderLength = strlen(Header);
+    if ((size_t)Length < HeaderLength || strncmp(Manifest, Header, HeaderLength) != 0) {
+        free(Manifest);
+        return NULL;
+    }
+
+    // Each line holds the key, the output hash and the source path.
+    FVector(FCookRecord) Records = NULL;
+    for (char* Line = Manifest + HeaderLength; *Line != '\0';) {
+        char* LineEnd = strchr(Line, '\n');
+        if (LineEnd != NULL) {
+            *LineEnd = '\0';
+        }
+
+        unsigned long long Key, OutputHash;
+        int PathOffset = 0;
+        if (sscanf(Line, "%llx %llx %n", &Key, &OutputHash, &PathOffset) == 2 && PathOffset > 0 && Line[PathOffset] != '\0') {
+            const size_t PathLength = strlen(Line + PathOffset);
+            FCookRecord Record = {malloc(PathLength + 1), Key, OutputHash, False};
+            if (Record.SourcePath != NULL) {
+                memcpy(Record.SourcePath, Line + PathOffset, PathLength + 1);
+                FVector_Add(Records, Record);
+            }
+        }
+
+        if (LineEnd == NULL) {
+            break;
+        }
+        Line = LineEnd + 1;
+    }
+    free(Manifest);
+
+    if (FVector_GetSize(Records) > 0) {
+        qsort(Records, FVector_GetSize(Records), sizeof(FCookRecord), Cook_CompareRecords);
+    }
+    return Records;
+}
+
+Bool Cook_WriteManifest(const FCookSettings* Settings, const FCookJob* Jobs, const U32 JobCount) {
+    char ManifestPath[COOK_PATH_LENGTH], TemporaryPath[COOK_PATH_LENGTH + 4];
+    snprintf(ManifestPath, sizeof ManifestPath, "%s/%s", Settings->OutputDirectory, ManifestName);
+    snprintf(TemporaryPath, sizeof TemporaryPath, "%s.tmp", ManifestPath);
+
+    if (!File_CreateDirectories(ManifestPath)) {
+        return False;
+    }
+
+    FILE* File = fopen(TemporaryPath, "w");
+    if (File == NULL) {
+        fprintf(stderr, "Failed to write the manifest %s\n", ManifestPath);
+        return False;
+    }
+
+    // Failed assets keep the record of their last output, which is still on disk.
+    fprintf(File, COOK_MANIFEST_HEADER, COOK_VERSION);
+    for (U32 Index = 0; Index < JobCount; Index++) {
+        const FCookJob* Job = &Jobs[Index];
+        if (Job->Result != COOK_RESULT_FAILED) {
+            fprintf(File, "%016llx %016llx %s\n", (unsigned long long)Job->Key, (unsigned long long)Job->OutputHash, Job->SourcePath);
+        } else if (Job->Previous != NULL) {
+            fprintf(File, "%016llx %016llx %s\n", (unsigned long long)Job->Previous->Key, (unsigned long long)Job->Previous->OutputHash, Job->SourcePath);
+        }
+    }
+
+    const Bool bWritten = fclose(File) == 0;
+#if OS_WINDOWS
+    remove(ManifestPath);
+#endif
+    if (!bWritten || rename(TemporaryPath, ManifestPath) != 0) {
+        fprintf(stderr, "Failed to write the manifest %s\n", ManifestPath);
+        remove(TemporaryPath);
+        return False;
+    }
+
+    return True;
+}
+
+int Cook_CompareRecords(const void* A, const void* B) {
+    return strcmp(((const FCookRecord*)A)->SourcePath, ((const FCookRecord*)B)->SourcePath);
+}
+
+int Cook_ComparePaths(const void* A, const void* B) {
+    return strcmp(*(const pStr*)A, *(const pStr*)B);
+}
+
+void Cook_AddPath(const pStr Path, void* UserData) {
+    FVector(pStr)* OutPaths = UserData;
+    FVector(pStr) Paths = *OutPaths;
+
+    const size_t Length = strlen(Path);
+    const pStr Copy = malloc(Length + 1);
+    if (Copy != NULL) {
+        memcpy(Copy, Path, Length + 1);
+        FVector_Add(Paths, Copy);
+    }
+
+    *OutPaths = Paths;
+}
+
+int Cook_Work(void* UserData) {
+    FCookContext* Context = UserData;
+    for (;;) {
+        if (Context->Mutex != NULL) {
+            Mutex_Lock(Context->Mutex);
+        }
+        const U32 Index = Context->NextJob < Context->JobCount ? Context->NextJob++ : Context->JobCount;
+        if (Context->Mutex != NULL) {
+            Mutex_Unlock(Context->Mutex);
+        }
+
+        if (Index == Context->JobCount) {
+            return 0;
+        }
+
+        FCookJob* Job = &Context->Jobs[Index];
+        Cook_ProcessJob(Context, Job);
+
+        // Lines of one asset stay together.
+        if (Context->Mutex != NULL) {
+            Mutex_Lock(Context->Mutex);
+        }
+        if (Job->Result == COOK_RESULT_COOKED) {
+            printf("cooked %s -> %s\n", Job->SourcePath, Job->OutputPath);
+        } else if (Job->Result == COOK_RESULT_FAILED) {
+            fprintf(stderr, "FAIL %s: %s\n", Job->SourcePath, Job->Error);
+        }
+        if (Context->Mutex != NULL) {
+            Mutex_Unlock(Context->Mutex);
+        }
+    }
+}
+
+void Cook_ProcessJob(const FCookContext* Context, FCookJob* Job) {
+    const FCookSettings* Settings = Context->Settings;
+    const FCookHandler* Handler = Cook_FindHandler(Job->SourcePath);
+
+    Job->Result = COOK_RESULT_FAILED;
+    if (Handler->Load != NULL) {
+        if (!Handler->Load(Job)) {
+            return;
+        }
+    } else {
+        I64 Length = 0;
+        Job->Data = (U8*)File_ReadText(Job->SourcePath, &Length);
+        if (Job->Data == NULL) {
+            snprintf(Job->Error, sizeof Job->Error, "can't read the source");
+            return;
+        }
+        Job->Length = (U64)Length;
+    }
+
+    Job->Key = Hash_Compute(Job->Data, Job->Length, Context->Seed);
+
+    // Unchanged inputs skip the work if the output is still the one cooked from them.
+    if (!Settings->bForce && Job->Previous != NULL && Job->Previous->Key == Job->Key) {
+        I64 Length = 0;
+        const pStr Output = File_ReadText(Job->OutputPath, &Length);
+        if (Output != NULL && Hash_Compute(Output, (U64)Length, 0) == Job->Previous->OutputHash) {
+            Job->OutputHash = Job->Previous->OutputHash;
+            Job->Result = COOK_RESULT_SKIPPED;
+        }
+        free(Output);
+    }
+
+    // Outputs are written next to their final path and renamed, an interrupted cook never leaves a partial file.
+    char TemporaryPath[COOK_PATH_LENGTH + 4];
+    snprintf(TemporaryPath, sizeof TemporaryPath, "%s.tmp", Job->OutputPath);
+    if (Job->Result != COOK_RESULT_SKIPPED && File_CreateDirectories(Job->OutputPath) && Handler->Cook(Settings, Job, TemporaryPath)) {
+        I64 Length = 0;
+        const pStr Output = File_ReadText(TemporaryPath, &Length);
+        if (Output != NULL) {
+            Job->OutputHash = Hash_Compute(Output, (U64)Length, 0);
+            Job->OutputLength = (U64)Length;
+            free(Output);
+#if OS_WINDOWS
+            remove(Job->OutputPath);
+#endif
+            if (rename(TemporaryPath, Job->OutputPath) == 0) {
+                Job->Result = COOK_RESULT_COOKED;
+            } else {
+                snprintf(Job->Error, sizeof Job->Error, "can't replace the output");
+            }
+        } else {
+            snprintf(Job->Error, sizeof Job->Error, "can't read the output back");
+        }
+    } else if (Job->Result != COOK_RESULT_SKIPPED && Job->Error[0] == '\0') {
+        snprintf(Job->Error, sizeof Job->Error, "can't create the output directory");
+    }
+
+    if (Job->Result == COOK_RESULT_FAILED) {
+        remove(TemporaryPath);
+    }
+
+    free(Job->Data);
+    Job->Data = NULL;
+}
+#pragma endregion
@@ -0,0 +1,49 @@
+#pragma once
+#include <stddef.h>
+
+#include "font_atlas.h"
+#include "typedefs.h"
+
+/**
+ * Offline conversion of the source asset tree into the data the game uploads as is. TGA images and DDS files without a
+ * full mip chain become DXT1 or DXT5 textures with every mip level, shaders are flattened and checked, TrueType fonts
+ * are baked into distance field atlases and other files are copied. The content hash of each input is recorded in a
+ * manifest next to the outputs, later runs only cook the assets whose inputs or outputs changed and delete the outputs
+ * of removed sources. Assets are cooked in parallel.
+ */
+
+/** Maximum length of a source or output path. */
+#define COOK_PATH_LENGTH 1024
+/** Version of the cooked formats, recorded in the manifest so a new cooker rebuilds every asset. */
+#define COOK_VERSION 1
+
+typedef struct {
+    /** Directory of the source assets, relative to the game working directory. */
+    pStr SourceDirectory;
+    /** Directory the outputs are written to with the source paths, a working directory for the game or the packer. */
+    pStr OutputDirectory;
+    /** Threads cooking assets, 0 for one per logical processor. */
+    U32 JobCount;
+    /** Cooks every asset, ignoring the manifest. */
+    Bool bForce;
+    FFontAtlasSettings FontAtlasSettings;
+} FCookSettings;
+
+typedef struct {
+    U32 Cooked;
+    /** Assets whose inputs and outputs match the manifest. */
+    U32 Skipped;
+    U32 Failed;
+    /** Outputs deleted because their source is gone. */
+    U32 Removed;
+    /** Bytes of the outputs written. */
+    U64 Bytes;
+} FCookStats;
+
+void Cook_GetDefaultSettings(FCookSettings* OutSettings);
+
+/** Cooks the source directory. Returns False if it can't be read or any asset failed, the other assets are still cooked. */
+Bool Cook_Run(const FCookSettings* Settings, FCookStats* OutStats);
+
+/** Writes the output path of a source file, under the output directory with the extension of its cooked format. */
+void Cook_GetOutputPath(const FCookSettings* Settings, pStr SourcePath, char* OutPath, size_t Size);
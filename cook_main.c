@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock.h"
+#include "cook.h"
+
+#pragma region Private Function Declarations
+static void Cooker_PrintUsage(pStr Program);
+#pragma endregion
+
+int main(int argc, char* argv[]) {
+    FCookSettings Settings;
+    Cook_GetDefaultSettings(&Settings);
+
+    int Argument = 1;
+    for (; Argument < argc && strncmp(argv[Argument], "--", 2) == 0; Argument++) {
+        if (strcmp(argv[Argument], "--force") == 0) {
+            Settings.bForce = True;
+        } else if (strcmp(argv[Argument], "--jobs") == 0 && Argument + 1 < argc) {
+            Settings.JobCount = (U32)strtoul(argv[++Argument], NULL, 10);
+        } else {
+            Cooker_PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (argc - Argument != 2) {
+        Cooker_PrintUsage(argv[0]);
+        return 2;
+    }
+    Settings.SourceDirectory = argv[Argument];
+    Settings.OutputDirectory = argv[Argument + 1];
+
+    const U64 Start = Clock_GetNanoseconds();
+    FCookStats Stats;
+    const Bool bSucceeded = Cook_Run(&Settings, &Stats);
+
+    printf("%s: %u cooked, %u up to date, %u removed, %u failed, %llu bytes written in %.1f ms\n", Settings.OutputDirectory, Stats.Cooked, Stats.Skipped,
+           Stats.Removed, Stats.Failed, (unsigned long long)Stats.Bytes, (double)(Clock_GetNanoseconds() - Start) / 1e6);
+
+    return bSucceeded ? 0 : 1;
+}
+
+#pragma region Private Function Definitions
+void Cooker_PrintUsage(const pStr Program) {
+    fprintf(stderr,
+            "Usage: %s [--force] [--jobs N] SOURCE OUTPUT   cook every file under SOURCE into OUTPUT\n"
+            "  --force    cook every asset, even those the manifest says are up to date\n"
+            "  --jobs N   threads cooking assets (default one per logical processor)\n"
+            "Outputs keep the SOURCE prefix, run from the game working directory: %s assets cooked\n",
+            Program, Program);
+}
+#pragma endregion
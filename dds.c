@@ -0,0 +1,178 @@
+#include "dds.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/** Four-character codes. */
+#define FOURCC_DXT1 0x31545844
+#define FOURCC_DXT3 0x33545844
+#define FOURCC_DXT5 0x35545844
+
+/** Header flags written for compressed images. */
+#define DDSD_CAPS 0x1
+#define DDSD_HEIGHT 0x2
+#define DDSD_WIDTH 0x4
+#define DDSD_PIXELFORMAT 0x1000
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDSD_LINEARSIZE 0x80000
+#define DDPF_FOURCC 0x4
+#define DDSCAPS_COMPLEX 0x8
+#define DDSCAPS_TEXTURE 0x1000
+#define DDSCAPS_MIPMAP 0x400000
+
+static U32 Dds_ReadU32(const U8* Data) {
+    return (U32)Data[0] | (U32)Data[1] << 8 | (U32)Data[2] << 16 | (U32)Data[3] << 24;
+}
+
+static void Dds_WriteU32(U8* Data, const U32 Value) {
+    Data[0] = (U8)Value;
+    Data[1] = (U8)(Value >> 8);
+    Data[2] = (U8)(Value >> 16);
+    Data[3] = (U8)(Value >> 24);
+}
+
+Bool Dds_Parse(const U8* Data, const U64 Length, FDdsImage* OutImage) {
+    if (Data == NULL || OutImage == NULL || Length < DDS_HEADER_SIZE) {
+        return False;
+    }
+
+    /** Check the file type. */
+    if (strncmp((const char*)Data, "DDS ", 4) != 0) {
+        printf("Bad file type %.4s, DDS expected\n", (const char*)Data);
+        return False;
+    }
+
+    /** Surface header follows the magic. */
+    const U8* Header = Data + 4;
+
+    U32 Height = Dds_ReadU32(&Header[8]);
+    U32 Width = Dds_ReadU32(&Header[12]);
+    U32 MipMapCount = Dds_ReadU32(&Header[24]);
+    const U32 FourCC = Dds_ReadU32(&Header[80]);
+
+    memset(OutImage, 0, sizeof *OutImage);
+
+    switch (FourCC) {
+    case FOURCC_DXT1:
+        OutImage->Format = DDS_FORMAT_DXT1;
+        OutImage->BlockSize = 8;
+        break;
+    case FOURCC_DXT3:
+        OutImage->Format = DDS_FORMAT_DXT3;
+        OutImage->BlockSize = 16;
+        break;
+    case FOURCC_DXT5:
+        OutImage->Format = DDS_FORMAT_DXT5;
+        OutImage->BlockSize = 16;
+        break;
+    default:
+        printf("Bad file code %#x, expected DXT1, DXT3 or DXT5\n", FourCC);
+        return False;
+    }
+
+    if (MipMapCount == 0) {
+        MipMapCount = 1;
+    }
+
+    OutImage->Width = Width;
+    OutImage->Height = Height;
+
+    U64 Offset = DDS_HEADER_SIZE;
+    for (U32 Level = 0; Level < MipMapCount && Level < DDS_MAX_MIP_LEVELS && (Width || Height); ++Level) {
+        const U32 LevelWidth = Width ? Width : 1;
+        const U32 LevelHeight = Height ? Height : 1;
+        const U32 Size = (LevelWidth + 3) / 4 * ((LevelHeight + 3) / 4) * OutImage->BlockSize;
+        if (Offset + Size > Length) {
+            break;
+        }
+
+        FDdsMipLevel* MipLevel = &OutImage->MipLevels[OutImage->MipLevelCount++];
+        MipLevel->Width = LevelWidth;
+        MipLevel->Height = LevelHeight;
+        MipLevel->Offset = (U32)Offset;
+        MipLevel->Size = Size;
+
+        Offset += Size;
+        Width /= 2;
+        Height /= 2;
+    }
+
+    return OutImage->MipLevelCount > 0;
+}
+
+U32 Dds_GetTileMipLevelCount(const FDdsImage* Image, const U32 Columns, const U32 Rows) {
+    if (Columns == 0 || Rows == 0 || Image->Width % Columns != 0 || Image->Height % Rows != 0) {
+        return 0;
+    }
+
+    // Tiles of a level must be whole blocks, past that the blocks mix neighbouring tiles.
+    U32 LevelCount = 0;
+    for (; LevelCount < Image->MipLevelCount; LevelCount++) {
+        const FDdsMipLevel* MipLevel = &Image->MipLevels[LevelCount];
+        if (MipLevel->Width % (Columns * 4) != 0 || MipLevel->Height % (Rows * 4) != 0) {
+            break;
+        }
+    }
+
+    return LevelCount;
+}
+
+U32 Dds_CopyTile(const U8* Data, const FDdsImage* Image, const U32 Level, const U32 Columns, const U32 Rows, const U32 Tile, U8* OutBlocks) {
+    const FDdsMipLevel* MipLevel = &Image->MipLevels[Level];
+    const U32 BlockColumns = MipLevel->Width / 4;
+    const U32 TileBlockColumns = BlockColumns / Columns;
+    const U32 TileBlockRows = MipLevel->Height / 4 / Rows;
+    const U32 FirstBlock = Tile / Columns * TileBlockRows * BlockColumns + Tile % Columns * TileBlockColumns;
+    const U32 RowSize = TileBlockColumns * Image->BlockSize;
+
+    for (U32 BlockRow = 0; BlockRow < TileBlockRows; BlockRow++) {
+        memcpy(OutBlocks + BlockRow * RowSize, Data + MipLevel->Offset + (FirstBlock + BlockRow * BlockColumns) * Image->BlockSize, RowSize);
+    }
+
+    return TileBlockRows * RowSize;
+}
+
+U32 Dds_GetBlockSize(const EDdsFormat Format) {
+    switch (Format) {
+    case DDS_FORMAT_DXT1:
+        return 8;
+    case DDS_FORMAT_DXT3:
+    case DDS_FORMAT_DXT5:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+U32 Dds_GetFullMipLevelCount(U32 Width, U32 Height) {
+    U32 LevelCount = 1;
+    while ((Width > 1 || Height > 1) && LevelCount < DDS_MAX_MIP_LEVELS) {
+        Width = Width > 1 ? Width / 2 : 1;
+        Height = Height > 1 ? Height / 2 : 1;
+        LevelCount++;
+    }
+
+    return LevelCount;
+}
+
+void Dds_WriteHeader(const EDdsFormat Format, const U32 Width, const U32 Height, const U32 MipLevelCount, U8* OutHeader) {
+    static const U32 FourCCs[] = {0, FOURCC_DXT1, FOURCC_DXT3, FOURCC_DXT5};
+
+    memset(OutHeader, 0, DDS_HEADER_SIZE);
+    memcpy(OutHeader, "DDS ", 4);
+
+    U8* Header = OutHeader + 4;
+    Dds_WriteU32(&Header[0], 124);
+    Dds_WriteU32(&Header[4], DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+    Dds_WriteU32(&Header[8], Height);
+    Dds_WriteU32(&Header[12], Width);
+    Dds_WriteU32(&Header[16], (Width + 3) / 4 * ((Height + 3) / 4) * Dds_GetBlockSize(Format));
+    Dds_WriteU32(&Header[24], MipLevelCount);
+
+    // Pixel format.
+    Dds_WriteU32(&Header[72], 32);
+    Dds_WriteU32(&Header[76], DDPF_FOURCC);
+    Dds_WriteU32(&Header[80], FourCCs[Format]);
+
+    Dds_WriteU32(&Header[104], MipLevelCount > 1 ? DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : DDSCAPS_TEXTURE);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "typedefs.h"
+
+/** Maximum number of mip levels a DDS image can describe (a 65536 px side). */
+#define DDS_MAX_MIP_LEVELS 17
+/** Magic + surface header, the first mip level follows. */
+#define DDS_HEADER_SIZE (4 + 124)
+
+/** Block compressed formats supported by the DDS parser. */
+typedef enum {
+    DDS_FORMAT_UNKNOWN = 0,
+    DDS_FORMAT_DXT1,
+    DDS_FORMAT_DXT3,
+    DDS_FORMAT_DXT5,
+} EDdsFormat;
+
+/** Single mip level view into the DDS data. */
+typedef struct {
+    U32 Width;
+    U32 Height;
+    /** Offset of the level data from the start of the DDS data. */
+    U32 Offset;
+    U32 Size;
+} FDdsMipLevel;
+
+/** Parsed DDS image, mip levels point into the parsed data which is not copied. */
+typedef struct {
+    EDdsFormat Format;
+    U32 Width;
+    U32 Height;
+    /** Bytes per 4x4 block: 8 for DXT1, 16 for DXT3 and DXT5. */
+    U32 BlockSize;
+    U32 MipLevelCount;
+    FDdsMipLevel MipLevels[DDS_MAX_MIP_LEVELS];
+} FDdsImage;
+
+/** Parses the DDS header and computes mip level offsets. Returns False if the data is not a supported or complete DDS image. */
+Bool Dds_Parse(const U8* Data, U64 Length, FDdsImage* OutImage);
+
+/**
+ * Returns the mip levels at which an atlas of Columns x Rows equal tiles splits into whole 4x4 blocks per tile, 0 if
+ * the image doesn't split into the tiles.
+ */
+U32 Dds_GetTileMipLevelCount(const FDdsImage* Image, U32 Columns, U32 Rows);
+
+/**
+ * Copies the blocks of a tile of the atlas at a mip level, which must be below Dds_GetTileMipLevelCount. Tiles are
+ * numbered row by row in the order the rows are stored. Returns the bytes written.
+ */
+U32 Dds_CopyTile(const U8* Data, const FDdsImage* Image, U32 Level, U32 Columns, U32 Rows, U32 Tile, U8* OutBlocks);
+
+/** Returns the bytes per 4x4 block of the format, 0 if unknown. */
+U32 Dds_GetBlockSize(EDdsFormat Format);
+
+/** Returns the mip levels of a full chain down to 1x1. */
+U32 Dds_GetFullMipLevelCount(U32 Width, U32 Height);
+
+/** Writes the DDS_HEADER_SIZE bytes of the header of an image, the mip levels follow it largest first. */
+void Dds_WriteHeader(EDdsFormat Format, U32 Width, U32 Height, U32 MipLevelCount, U8* OutHeader);
@@ -1,16 +1,22 @@
 ﻿#include "file.h"
 
-#include <SDL_rwops.h>
-
 #include "typedefs.h"
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 
 #if OS_WINDOWS
+#include <direct.h>
 #include <windows.h>
-#include <sys/stat.h>
+#else
+#include <dirent.h>
 #endif
 
+/** Maximum length of a visited path. */
+#define FILE_PATH_LENGTH 1024
+
 I64 File_GetSize(const pStr FileName) {
     struct stat Stat;
 
@@ -24,23 +30,35 @@ I64 File_GetSize(const pStr FileName) {
 }
 
 pStr File_ReadText(const pStr Path, I64* OutLength) {
-    SDL_RWops* Context = SDL_RWFromFile(Path, "rb");
-    if (Context == NULL) {
+    FILE* pFile = fopen(Path, "rb");
+    if (pFile == NULL) {
+        return NULL;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    const I64 Size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    if (Size < 0) {
+        fclose(pFile);
         return NULL;
     }
 
-    const I64 Size = SDL_RWsize(Context);
     const pStr Result = (pStr)malloc(Size + 1);
+    if (Result == NULL) {
+        fclose(pFile);
+        return NULL;
+    }
 
     I64 TotalBytesRead = 0, BytesRead = 1;
     pStr Buffer = Result;
     while (TotalBytesRead < Size && BytesRead != 0) {
-        BytesRead = SDL_RWread(Context, Buffer, 1, (Size - TotalBytesRead));
+        BytesRead = (I64)fread(Buffer, 1, (size_t)(Size - TotalBytesRead), pFile);
         TotalBytesRead += BytesRead;
         Buffer += BytesRead;
     }
 
-    SDL_RWclose(Context);
+    fclose(pFile);
     if (TotalBytesRead != Size) {
         free(Result);
         return NULL;
@@ -54,3 +72,91 @@ pStr File_ReadText(const pStr Path, I64* OutLength) {
 
     return Result;
 }
+
+Bool File_VisitDirectory(const pStr Directory, const FileVisitor Visitor, void* UserData) {
+    char Path[FILE_PATH_LENGTH];
+
+#if OS_WINDOWS
+    WIN32_FIND_DATAA FindData;
+    snprintf(Path, sizeof Path, "%s/*", Directory);
+    const HANDLE Find = FindFirstFileA(Path, &FindData);
+    if (Find == INVALID_HANDLE_VALUE) {
+        return False;
+    }
+
+    do {
+        if (strcmp(FindData.cFileName, ".") == 0 || strcmp(FindData.cFileName, "..") == 0) {
+            continue;
+        }
+
+        snprintf(Path, sizeof Path, "%s/%s", Directory, FindData.cFileName);
+        if (FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            File_VisitDirectory(Path, Visitor, UserData);
+        } else {
+            Visitor(Path, UserData);
+        }
+    } while (FindNextFileA(Find, &FindData));
+
+    FindClose(Find);
+#else
+    DIR* Dir = opendir(Directory);
+    if (Dir == NULL) {
+        return False;
+    }
+
+    const struct dirent* Entry;
+    while ((Entry = readdir(Dir)) != NULL) {
+        if (strcmp(Entry->d_name, ".") == 0 || strcmp(Entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        snprintf(Path, sizeof Path, "%s/%s", Directory, Entry->d_name);
+
+        struct stat Stat;
+        if (stat(Path, &Stat) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(Stat.st_mode)) {
+            File_VisitDirectory(Path, Visitor, UserData);
+        } else if (S_ISREG(Stat.st_mode)) {
+            Visitor(Path, UserData);
+        }
+    }
+
+    closedir(Dir);
+#endif
+
+    return True;
+}
+
+Bool File_CreateDirectories(const pStr Path) {
+    char Directory[FILE_PATH_LENGTH];
+    const size_t Length = strlen(Path);
+    if (Length >= sizeof Directory) {
+        return False;
+    }
+    memcpy(Directory, Path, Length + 1);
+
+    // Create every parent in turn, a leading separator is the root and exists already.
+    for (size_t Index = 1; Index < Length; Index++) {
+        if (Directory[Index] != '/' && Directory[Index] != '\\') {
+            continue;
+        }
+
+        Directory[Index] = '\0';
+#if OS_WINDOWS
+        const Bool bCreated = _mkdir(Directory) == 0 || errno == EEXIST;
+#else
+        const Bool bCreated = mkdir(Directory, 0755) == 0 || errno == EEXIST;
+#endif
+        Directory[Index] = Path[Index];
+
+        if (!bCreated) {
+            fprintf(stderr, "Can't create directory %.*s\n", (int)Index, Path);
+            return False;
+        }
+    }
+
+    return True;
+}
@@ -2,4 +2,17 @@
 
 #include "typedefs.h"
 
+/** Returns the file size in bytes or -1 if the file can't be accessed. */
+I64 File_GetSize(pStr FileName);
+
+/** Reads the whole file into a null-terminated buffer, caller frees the result. */
 pStr File_ReadText(pStr Path, I64* OutLength);
+
+/** Called for every regular file found by File_VisitDirectory with its path joined by forward slashes. */
+typedef void (*FileVisitor)(pStr Path, void* UserData);
+
+/** Recursively visits the files under the directory. Returns False if the directory can't be opened. */
+Bool File_VisitDirectory(pStr Directory, FileVisitor Visitor, void* UserData);
+
+/** Creates the missing directories of the file path, up to its last separator. Returns False on failure. */
+Bool File_CreateDirectories(pStr Path);
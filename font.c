@@ -1,47 +1,69 @@
 ﻿#include "font.h"
-#include <SDL_ttf.h>
+#include <SDL_log.h>
+#include <stdlib.h>
 
-TTF_Font* Font = NULL;
+#include "file.h"
+#include "io.h"
 
-const pStr DefaultFont = "assets/fonts/ttf/DejaVuLGCSansMono.ttf";
-const I32 DefaultFontSize = 16;
+#pragma region Settings
+/** Atlas of the default font, baked from DejaVuLGCSansMono.ttf by ShquarkzCooker. */
+static const pStr DefaultFontAtlas = "assets/fonts/ttf/DejaVuLGCSansMono.sdf";
+#pragma endregion
+
+#pragma region Private Variables
+static FFontAtlas Atlas;
+static Bool bAtlasReady = False;
+#pragma endregion
 
 #pragma region Private Function Declarations
-TTF_Font* Font_LoadFont(pStr FontPath, I32 FontSize);
-void Font_UnloadFont();
+static Bool Font_OnFileLoaded(const FIoResult* Result);
+
+static void Font_LoadAtlas(const U8* Data, U64 Length);
 #pragma endregion
 
 #pragma region Public Function Definitions
 Bool Font_Initialize() {
-    TTF_Init();
+    FIoReadRequest Request = {0};
+    Request.Path = DefaultFontAtlas;
+    Request.Priority = IO_PRIORITY_HIGH;
+    Request.Handler = Font_OnFileLoaded;
+    if (Io_Read(&Request) != InvalidId) {
+        return True;
+    }
 
-    Font_LoadFont(DefaultFont, DefaultFontSize);
+    // The io service is not running, fall back to a blocking read.
+    I64 Length = 0;
+    U8* Data = (U8*)File_ReadText(DefaultFontAtlas, &Length);
+    Font_LoadAtlas(Data, Data != NULL ? (U64)Length : 0);
+    free(Data);
 
-    return Font != NULL;
+    return bAtlasReady;
 }
 
-TTF_Font* Font_GetFont() {
-    return Font;
+const FFontAtlas* Font_GetAtlas() {
+    return bAtlasReady ? &Atlas : NULL;
 }
 
 void Font_Shutdown() {
-    Font_UnloadFont();
-
-    TTF_Quit();
+    FontAtlas_Free(&Atlas);
+    bAtlasReady = False;
 }
 #pragma endregion
 
 #pragma region Private Function Definitions
-TTF_Font* Font_LoadFont(const pStr FontPath, const I32 FontSize) {
-    Font = TTF_OpenFont(FontPath, FontSize);
-    if (Font == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL failed to open font %s, %d: %s", FontPath, FontSize, SDL_GetError());
+Bool Font_OnFileLoaded(const FIoResult* Result) {
+    if (Result->Status != IO_STATUS_CANCELLED) {
+        Font_LoadAtlas(Result->Status == IO_STATUS_COMPLETED ? Result->Data : NULL, Result->Length);
     }
 
-    return Font;
+    return False;
 }
 
-void Font_UnloadFont() {
-    TTF_CloseFont(Font);
+void Font_LoadAtlas(const U8* Data, const U64 Length) {
+    // The atlas is whatever the cooker baked, the font itself isn't shipped to check it against.
+    bAtlasReady = Data != NULL && FontAtlas_Read(Data, Length, 0, &Atlas);
+    if (!bAtlasReady) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load font atlas %s, cook the assets with ShquarkzCooker", DefaultFontAtlas);
+    }
 }
 #pragma endregion
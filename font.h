@@ -1,9 +1,11 @@
 ﻿#pragma once
-
-#include <SDL_ttf.h>
-
+#include "font_atlas.h"
 #include "typedefs.h"
 
+/** Starts loading the atlas of the default font through the io service, baked by the asset cooker. */
 Bool Font_Initialize();
 
-TTF_Font* Font_GetFont();
+void Font_Shutdown();
+
+/** Returns the atlas of the default font once it is loaded, NULL before or if it failed. Called on the thread updating the io service. */
+const FFontAtlas* Font_GetAtlas();
@@ -0,0 +1,721 @@
+#include "font_atlas.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+#include "hash.h"
+
+#pragma region Settings
+/** "SQFA" in little-endian. */
+#define FONT_ATLAS_MAGIC 0x41465153
+#define FONT_ATLAS_VERSION 1
+
+/** Nesting of composite glyphs followed, deeper parts are dropped. */
+#define FONT_ATLAS_MAX_COMPOSITE_DEPTH 8
+/** Lines a quadratic curve is flattened into at most, fewer for short curves. */
+#define FONT_ATLAS_MAX_CURVE_LINES 16
+/** Empty texels between glyphs, so filtering never reaches a neighbour. */
+#define FONT_ATLAS_GLYPH_GAP 1
+#pragma endregion
+
+#pragma region Private Types
+/** Header of an atlas file, followed by the glyphs and the texels. */
+typedef struct {
+    U32 Magic;
+    U32 Version;
+    U64 Key;
+    FFontAtlasSettings Settings;
+    U32 Width;
+    U32 Height;
+    F32 Ascent;
+    F32 Descent;
+    F32 LineGap;
+    U32 GlyphCount;
+} FFontAtlasHeader;
+
+/** Tables of a TrueType font used by the atlas. */
+typedef struct {
+    const U8* Data;
+    U64 Length;
+    U32 Glyf;
+    U32 Loca;
+    U32 Hmtx;
+    /** Format 4 character map subtable. */
+    U32 Cmap;
+    U32 GlyphCount;
+    U32 HMetricCount;
+    U32 UnitsPerEm;
+    Bool bLongLoca;
+} FFontAtlasFont;
+
+typedef struct {
+    F32 X0;
+    F32 Y0;
+    F32 X1;
+    F32 Y1;
+} FFontAtlasLine;
+
+/** Outline of a glyph flattened into lines, in font units until it is scaled to pixels. */
+typedef struct {
+    FVector(FFontAtlasLine) Lines;
+    F32 Current[2];
+} FFontAtlasOutline;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static inline U16 FontAtlas_ReadU16(const U8* Data) {
+    return (U16)(Data[0] << 8 | Data[1]);
+}
+
+static inline I16 FontAtlas_ReadI16(const U8* Data) {
+    return (I16)FontAtlas_ReadU16(Data);
+}
+
+static inline U32 FontAtlas_ReadU32(const U8* Data) {
+    return (U32)Data[0] << 24 | (U32)Data[1] << 16 | (U32)Data[2] << 8 | Data[3];
+}
+
+/** Returns True if the bytes lie within the font file. */
+static inline Bool FontAtlas_IsInside(const FFontAtlasFont* Font, const U64 Offset, const U64 Size) {
+    return Offset <= Font->Length && Size <= Font->Length - Offset;
+}
+
+/** Finds the tables of the font. Returns False if one is missing or the font isn't TrueType. */
+static Bool FontAtlas_OpenFont(const U8* Data, U64 Length, FFontAtlasFont* OutFont);
+
+/** Returns the offset of the table with the tag, zero if the font lacks it. */
+static U32 FontAtlas_FindTable(const FFontAtlasFont* Font, pStr Tag, U32 MinLength);
+
+/** Returns the glyph of the character, zero for the missing glyph. */
+static U32 FontAtlas_GetGlyphIndex(const FFontAtlasFont* Font, U32 Character);
+
+static F32 FontAtlas_GetAdvance(const FFontAtlasFont* Font, U32 Glyph);
+
+/** Adds the contours of the glyph to the outline, moved by the transform, a 2x2 matrix followed by an offset. */
+static Bool FontAtlas_AddGlyph(const FFontAtlasFont* Font, U32 Glyph, const F32 Transform[6], U32 Depth, FFontAtlasOutline* Outline);
+
+static void FontAtlas_AddLine(FFontAtlasOutline* Outline, F32 X, F32 Y);
+
+static void FontAtlas_AddCurve(FFontAtlasOutline* Outline, F32 ControlX, F32 ControlY, F32 X, F32 Y, F32 UnitsPerPixel);
+
+/** Samples the distance to the outline, in pixels, into the texels of a glyph, the top row first. */
+static void FontAtlas_SampleGlyph(const FFontAtlasOutline* Outline, I32 Left, I32 Top, U32 Width, U32 Height, U32 Spread, U8* Texels, U32 Stride);
+
+static inline const FFontGlyph* FontAtlas_GetGlyph(const FFontAtlas* Atlas, const U8 Character) {
+    const U32 Index = Character >= FONT_ATLAS_FIRST_GLYPH && Character < FONT_ATLAS_FIRST_GLYPH + FONT_ATLAS_GLYPH_COUNT ? Character : '?';
+    return &Atlas->Glyphs[Index - FONT_ATLAS_FIRST_GLYPH];
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+void FontAtlas_GetDefaultSettings(FFontAtlasSettings* OutSettings) {
+    OutSettings->GlyphSize = 32;
+    OutSettings->Spread = 4;
+    OutSettings->Width = 512;
+}
+
+U64 FontAtlas_GetKey(const U8* FontData, const U64 Length, const FFontAtlasSettings* Settings) {
+    const U64 Seed = Hash_Compute(Settings, sizeof *Settings, FONT_ATLAS_VERSION);
+    return Hash_Compute(FontData, Length, Seed);
+}
+
+Bool FontAtlas_Build(const U8* FontData, const U64 Length, const FFontAtlasSettings* Settings, FFontAtlas* OutAtlas) {
+    memset(OutAtlas, 0, sizeof *OutAtlas);
+
+    FFontAtlasFont Font;
+    if (!FontAtlas_OpenFont(FontData, Length, &Font)) {
+        return False;
+    }
+
+    const U32 Hhea = FontAtlas_FindTable(&Font, "hhea", 36);
+    const F32 EmScale = 1.f / (F32)Font.UnitsPerEm;
+    OutAtlas->Key = FontAtlas_GetKey(FontData, Length, Settings);
+    OutAtlas->Settings = *Settings;
+    OutAtlas->Ascent = (F32)FontAtlas_ReadI16(FontData + Hhea + 4) * EmScale;
+    OutAtlas->Descent = (F32)FontAtlas_ReadI16(FontData + Hhea + 6) * EmScale;
+    OutAtlas->LineGap = (F32)FontAtlas_ReadI16(FontData + Hhea + 8) * EmScale;
+
+    // Outlines are flattened in pixels, so curves get as many lines as the glyph size needs.
+    const F32 PixelScale = (F32)Settings->GlyphSize * EmScale;
+    const I32 Spread = (I32)Settings->Spread;
+    const F32 Transform[6] = {PixelScale, 0.f, 0.f, PixelScale, 0.f, 0.f};
+    FFontAtlasOutline Outlines[FONT_ATLAS_GLYPH_COUNT];
+    I32 Boxes[FONT_ATLAS_GLYPH_COUNT][4];
+    U32 Positions[FONT_ATLAS_GLYPH_COUNT][2];
+    memset(Outlines, 0, sizeof Outlines);
+
+    // Glyphs are packed into shelves in character order, the height grows to fit.
+    U32 ShelfX = 0;
+    U32 ShelfY = 0;
+    U32 ShelfHeight = 0;
+    Bool bSuccess = True;
+    for (U32 Index = 0; Index < FONT_ATLAS_GLYPH_COUNT && bSuccess; Index++) {
+        const U32 Glyph = FontAtlas_GetGlyphIndex(&Font, FONT_ATLAS_FIRST_GLYPH + Index);
+        FFontGlyph* AtlasGlyph = &OutAtlas->Glyphs[Index];
+        AtlasGlyph->Advance = FontAtlas_GetAdvance(&Font, Glyph);
+
+        bSuccess = FontAtlas_AddGlyph(&Font, Glyph, Transform, 0, &Outlines[Index]);
+        const U32 LineCount = (U32)FVector_GetSize(Outlines[Index].Lines);
+        if (!bSuccess || LineCount == 0) {
+            Boxes[Index][0] = Boxes[Index][1] = Boxes[Index][2] = Boxes[Index][3] = 0;
+            continue;
+        }
+
+        F32 Min[2] = {INFINITY, INFINITY};
+        F32 Max[2] = {-INFINITY, -INFINITY};
+        for (U32 LineIndex = 0; LineIndex < LineCount; LineIndex++) {
+            const FFontAtlasLine* Line = &Outlines[Index].Lines[LineIndex];
+            Min[0] = fminf(Min[0], fminf(Line->X0, Line->X1));
+            Min[1] = fminf(Min[1], fminf(Line->Y0, Line->Y1));
+            Max[0] = fmaxf(Max[0], fmaxf(Line->X0, Line->X1));
+            Max[1] = fmaxf(Max[1], fmaxf(Line->Y0, Line->Y1));
+        }
+
+        // Left, bottom, right and top texel edges around the pen, y up.
+        I32* Box = Boxes[Index];
+        Box[0] = (I32)floorf(Min[0]) - Spread;
+        Box[1] = (I32)floorf(Min[1]) - Spread;
+        Box[2] = (I32)ceilf(Max[0]) + Spread;
+        Box[3] = (I32)ceilf(Max[1]) + Spread;
+        const U32 Width = (U32)(Box[2] - Box[0]);
+        const U32 Height = (U32)(Box[3] - Box[1]);
+        if (Width + FONT_ATLAS_GLYPH_GAP > Settings->Width) {
+            bSuccess = False;
+            continue;
+        }
+
+        if (ShelfX + Width + FONT_ATLAS_GLYPH_GAP > Settings->Width) {
+            ShelfX = 0;
+            ShelfY += ShelfHeight;
+            ShelfHeight = 0;
+        }
+        Positions[Index][0] = ShelfX + FONT_ATLAS_GLYPH_GAP;
+        Positions[Index][1] = ShelfY + FONT_ATLAS_GLYPH_GAP;
+        ShelfX += Width + FONT_ATLAS_GLYPH_GAP;
+        ShelfHeight = Height + FONT_ATLAS_GLYPH_GAP > ShelfHeight ? Height + FONT_ATLAS_GLYPH_GAP : ShelfHeight;
+    }
+
+    if (bSuccess) {
+        OutAtlas->Width = Settings->Width;
+        OutAtlas->Height = (ShelfY + ShelfHeight + FONT_ATLAS_GLYPH_GAP + 3) & ~3u;
+        OutAtlas->Pixels = calloc((size_t)OutAtlas->Width * OutAtlas->Height, 1);
+        bSuccess = OutAtlas->Pixels != NULL;
+    }
+
+    const F32 InverseSize = 1.f / (F32)Settings->GlyphSize;
+    for (U32 Index = 0; Index < FONT_ATLAS_GLYPH_COUNT && bSuccess; Index++) {
+        const I32* Box = Boxes[Index];
+        if (Box[2] == Box[0]) {
+            continue;
+        }
+
+        const U32 Width = (U32)(Box[2] - Box[0]);
+        const U32 Height = (U32)(Box[3] - Box[1]);
+        U8* Texels = OutAtlas->Pixels + (size_t)Positions[Index][1] * OutAtlas->Width + Positions[Index][0];
+        FontAtlas_SampleGlyph(&Outlines[Index], Box[0], Box[3], Width, Height, Settings->Spread, Texels, OutAtlas->Width);
+
+        FFontGlyph* Glyph = &OutAtlas->Glyphs[Index];
+        Glyph->Left = (F32)Box[0] * InverseSize;
+        Glyph->Bottom = (F32)Box[1] * InverseSize;
+        Glyph->Right = (F32)Box[2] * InverseSize;
+        Glyph->Top = (F32)Box[3] * InverseSize;
+        Glyph->U0 = (F32)Positions[Index][0] / (F32)OutAtlas->Width;
+        Glyph->V0 = (F32)Positions[Index][1] / (F32)OutAtlas->Height;
+        Glyph->U1 = (F32)(Positions[Index][0] + Width) / (F32)OutAtlas->Width;
+        Glyph->V1 = (F32)(Positions[Index][1] + Height) / (F32)OutAtlas->Height;
+    }
+
+    for (U32 Index = 0; Index < FONT_ATLAS_GLYPH_COUNT; Index++) {
+        FVector_Free(Outlines[Index].Lines);
+    }
+
+    if (!bSuccess) {
+        FontAtlas_Free(OutAtlas);
+    }
+    return bSuccess;
+}
+
+Bool FontAtlas_Write(const FFontAtlas* Atlas, const pStr Path) {
+    FILE* File = fopen(Path, "wb");
+    if (File == NULL) {
+        return False;
+    }
+
+    FFontAtlasHeader Header;
+    memset(&Header, 0, sizeof Header);
+    Header.Magic = FONT_ATLAS_MAGIC;
+    Header.Version = FONT_ATLAS_VERSION;
+    Header.Key = Atlas->Key;
+    Header.Settings = Atlas->Settings;
+    Header.Width = Atlas->Width;
+    Header.Height = Atlas->Height;
+    Header.Ascent = Atlas->Ascent;
+    Header.Descent = Atlas->Descent;
+    Header.LineGap = Atlas->LineGap;
+    Header.GlyphCount = FONT_ATLAS_GLYPH_COUNT;
+
+    const size_t PixelCount = (size_t)Atlas->Width * Atlas->Height;
+    const Bool bWritten = fwrite(&Header, sizeof Header, 1, File) == 1 && fwrite(Atlas->Glyphs, sizeof Atlas->Glyphs, 1, File) == 1 &&
+                          fwrite(Atlas->Pixels, 1, PixelCount, File) == PixelCount;
+    return fclose(File) == 0 && bWritten;
+}
+
+Bool FontAtlas_Read(const U8* Data, const U64 Length, const U64 Key, FFontAtlas* OutAtlas) {
+    memset(OutAtlas, 0, sizeof *OutAtlas);
+
+    FFontAtlasHeader Header;
+    if (Length < sizeof Header) {
+        return False;
+    }
+    memcpy(&Header, Data, sizeof Header);
+
+    const U64 PixelCount = (U64)Header.Width * Header.Height;
+    if (Header.Magic != FONT_ATLAS_MAGIC || Header.Version != FONT_ATLAS_VERSION || (Key != 0 && Header.Key != Key) ||
+        Header.GlyphCount != FONT_ATLAS_GLYPH_COUNT || Length != sizeof Header + sizeof OutAtlas->Glyphs + PixelCount) {
+        return False;
+    }
+
+    OutAtlas->Pixels = malloc(PixelCount > 0 ? PixelCount : 1);
+    if (OutAtlas->Pixels == NULL) {
+        return False;
+    }
+    memcpy(OutAtlas->Glyphs, Data + sizeof Header, sizeof OutAtlas->Glyphs);
+    memcpy(OutAtlas->Pixels, Data + sizeof Header + sizeof OutAtlas->Glyphs, PixelCount);
+
+    OutAtlas->Key = Header.Key;
+    OutAtlas->Settings = Header.Settings;
+    OutAtlas->Ascent = Header.Ascent;
+    OutAtlas->Descent = Header.Descent;
+    OutAtlas->LineGap = Header.LineGap;
+    OutAtlas->Width = Header.Width;
+    OutAtlas->Height = Header.Height;
+    return True;
+}
+
+void FontAtlas_Free(FFontAtlas* Atlas) {
+    free(Atlas->Pixels);
+    Atlas->Pixels = NULL;
+    Atlas->Width = 0;
+    Atlas->Height = 0;
+}
+
+U32 FontAtlas_LayoutText(const FFontAtlas* Atlas, const F32 X, const F32 Y, const F32 Size, const pStr Text, const U32 Color, FFontVertex* OutVertices,
+                         const U32 MaxVertices) {
+    const F32 Baseline = Y + Atlas->Ascent * Size;
+    F32 Pen = X;
+    U32 Count = 0;
+    for (const char* Character = Text; *Character != '\0'; Character++) {
+        const FFontGlyph* Glyph = FontAtlas_GetGlyph(Atlas, (U8)*Character);
+        if (Glyph->Right > Glyph->Left) {
+            if (Count + 6 > MaxVertices) {
+                break;
+            }
+
+            const F32 Left = Pen + Glyph->Left * Size;
+            const F32 Right = Pen + Glyph->Right * Size;
+            const F32 Top = Baseline - Glyph->Top * Size;
+            const F32 Bottom = Baseline - Glyph->Bottom * Size;
+            FFontVertex* Vertex = OutVertices + Count;
+            Vertex[0] = (FFontVertex){Left, Top, Glyph->U0, Glyph->V0, Color};
+            Vertex[1] = (FFontVertex){Left, Bottom, Glyph->U0, Glyph->V1, Color};
+            Vertex[2] = (FFontVertex){Right, Bottom, Glyph->U1, Glyph->V1, Color};
+            Vertex[3] = Vertex[0];
+            Vertex[4] = Vertex[2];
+            Vertex[5] = (FFontVertex){Right, Top, Glyph->U1, Glyph->V0, Color};
+            Count += 6;
+        }
+        Pen += Glyph->Advance * Size;
+    }
+
+    return Count;
+}
+
+F32 FontAtlas_GetTextWidth(const FFontAtlas* Atlas, const F32 Size, const pStr Text) {
+    F32 Width = 0.f;
+    for (const char* Character = Text; *Character != '\0'; Character++) {
+        Width += FontAtlas_GetGlyph(Atlas, (U8)*Character)->Advance * Size;
+    }
+
+    return Width;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+Bool FontAtlas_OpenFont(const U8* Data, const U64 Length, FFontAtlasFont* OutFont) {
+    memset(OutFont, 0, sizeof *OutFont);
+    OutFont->Data = Data;
+    OutFont->Length = Length;
+    if (Length < 12 || (FontAtlas_ReadU32(Data) != 0x00010000 && FontAtlas_ReadU32(Data) != 0x74727565)) {
+        return False;
+    }
+
+    const U32 Head = FontAtlas_FindTable(OutFont, "head", 54);
+    const U32 Hhea = FontAtlas_FindTable(OutFont, "hhea", 36);
+    const U32 Maxp = FontAtlas_FindTable(OutFont, "maxp", 6);
+    const U32 Cmap = FontAtlas_FindTable(OutFont, "cmap", 4);
+    OutFont->Glyf = FontAtlas_FindTable(OutFont, "glyf", 0);
+    OutFont->Loca = FontAtlas_FindTable(OutFont, "loca", 0);
+    OutFont->Hmtx = FontAtlas_FindTable(OutFont, "hmtx", 0);
+    if (Head == 0 || Hhea == 0 || Maxp == 0 || Cmap == 0 || OutFont->Glyf == 0 || OutFont->Loca == 0 || OutFont->Hmtx == 0) {
+        return False;
+    }
+
+    OutFont->UnitsPerEm = FontAtlas_ReadU16(Data + Head + 18);
+    OutFont->bLongLoca = FontAtlas_ReadI16(Data + Head + 50) != 0;
+    OutFont->GlyphCount = FontAtlas_ReadU16(Data + Maxp + 4);
+    OutFont->HMetricCount = FontAtlas_ReadU16(Data + Hhea + 34);
+    if (OutFont->UnitsPerEm == 0 || OutFont->HMetricCount == 0 ||
+        !FontAtlas_IsInside(OutFont, OutFont->Loca, ((U64)OutFont->GlyphCount + 1) * (OutFont->bLongLoca ? 4 : 2)) ||
+        !FontAtlas_IsInside(OutFont, OutFont->Hmtx, (U64)OutFont->HMetricCount * 4)) {
+        return False;
+    }
+
+    // Unicode BMP maps of the Windows or the Unicode platform, both in format 4.
+    const U32 CmapCount = FontAtlas_ReadU16(Data + Cmap + 2);
+    for (U32 Index = 0; Index < CmapCount && OutFont->Cmap == 0; Index++) {
+        const U32 Record = Cmap + 4 + Index * 8;
+        if (!FontAtlas_IsInside(OutFont, Record, 8)) {
+            break;
+        }
+
+        const U16 Platform = FontAtlas_ReadU16(Data + Record);
+        const U16 Encoding = FontAtlas_ReadU16(Data + Record + 2);
+        const U32 Subtable = Cmap + FontAtlas_ReadU32(Data + Record + 4);
+        if ((Platform == 0 || (Platform == 3 && Encoding == 1)) && FontAtlas_IsInside(OutFont, Subtable, 14) && FontAtlas_ReadU16(Data + Subtable) == 4 &&
+            FontAtlas_IsInside(OutFont, Subtable, FontAtlas_ReadU16(Data + Subtable + 2))) {
+            OutFont->Cmap = Subtable;
+        }
+    }
+
+    return OutFont->Cmap != 0;
+}
+
+U32 FontAtlas_FindTable(const FFontAtlasFont* Font, const pStr Tag, const U32 MinLength) {
+    const U32 TableCount = FontAtlas_ReadU16(Font->Data + 4);
+    for (U32 Index = 0; Index < TableCount; Index++) {
+        const U32 Record = 12 + Index * 16;
+        if (!FontAtlas_IsInside(Font, Record, 16)) {
+            return 0;
+        }
+
+        if (memcmp(Font->Data + Record, Tag, 4) == 0) {
+            const U32 Offset = FontAtlas_ReadU32(Font->Data + Record + 8);
+            const U32 Length = FontAtlas_ReadU32(Font->Data + Record + 12);
+            return Length >= MinLength && FontAtlas_IsInside(Font, Offset, Length) ? Offset : 0;
+        }
+    }
+
+    return 0;
+}
+
+U32 FontAtlas_GetGlyphIndex(const FFontAtlasFont* Font, const U32 Character) {
+    const U8* Subtable = Font->Data + Font->Cmap;
+    const U32 SegmentCount = FontAtlas_ReadU16(Subtable + 6) / 2;
+    const U32 Ends = Font->Cmap + 14;
+    const U32 Starts = Ends + SegmentCount * 2 + 2;
+    const U32 Deltas = Starts + SegmentCount * 2;
+    const U32 RangeOffsets = Deltas + SegmentCount * 2;
+    if (!FontAtlas_IsInside(Font, Ends, (U64)SegmentCount * 8 + 2)) {
+        return 0;
+    }
+
+    // Segments are sorted by their last character, the first ending at or after the character holds it if any.
+    for (U32 Segment = 0; Segment < SegmentCount; Segment++) {
+        if (Character > FontAtlas_ReadU16(Font->Data + Ends + Segment * 2)) {
+            continue;
+        }
+
+        const U32 Start = FontAtlas_ReadU16(Font->Data + Starts + Segment * 2);
+        if (Character < Start) {
+            return 0;
+        }
+
+        const U16 Delta = FontAtlas_ReadU16(Font->Data + Deltas + Segment * 2);
+        const U32 RangeOffset = FontAtlas_ReadU16(Font->Data + RangeOffsets + Segment * 2);
+        if (RangeOffset == 0) {
+            return (U16)(Character + Delta);
+        }
+
+        const U64 Address = (U64)RangeOffsets + Segment * 2 + RangeOffset + (Character - Start) * 2;
+        if (!FontAtlas_IsInside(Font, Address, 2)) {
+            return 0;
+        }
+        const U16 Glyph = FontAtlas_ReadU16(Font->Data + Address);
+        return Glyph != 0 ? (U16)(Glyph + Delta) : 0;
+    }
+
+    return 0;
+}
+
+F32 FontAtlas_GetAdvance(const FFontAtlasFont* Font, const U32 Glyph) {
+    // Glyphs past the last metric share its advance, as in monospaced fonts.
+    const U32 Metric = Glyph < Font->HMetricCount ? Glyph : Font->HMetricCount - 1;
+    return (F32)FontAtlas_ReadU16(Font->Data + Font->Hmtx + Metric * 4) / (F32)Font->UnitsPerEm;
+}
+
+Bool FontAtlas_AddGlyph(const FFontAtlasFont* Font, const U32 Glyph, const F32 Transform[6], const U32 Depth, FFontAtlasOutline* Outline) {
+    if (Glyph >= Font->GlyphCount) {
+        return True;
+    }
+
+    const U8* Loca = Font->Data + Font->Loca;
+    const U64 Start = Font->bLongLoca ? FontAtlas_ReadU32(Loca + Glyph * 4) : FontAtlas_ReadU16(Loca + Glyph * 2) * 2u;
+    const U64 End = Font->bLongLoca ? FontAtlas_ReadU32(Loca + Glyph * 4 + 4) : FontAtlas_ReadU16(Loca + Glyph * 2 + 2) * 2u;
+    if (End <= Start) {
+        return True;
+    }
+
+    const U64 Offset = Font->Glyf + Start;
+    const U64 Size = End - Start;
+    if (Size < 10 || !FontAtlas_IsInside(Font, Offset, Size)) {
+        return False;
+    }
+
+    const U8* Data = Font->Data + Offset;
+    const U8* DataEnd = Data + Size;
+    const I32 ContourCount = FontAtlas_ReadI16(Data);
+
+    if (ContourCount < 0) {
+        // Composite glyphs place transformed parts, offsets given as point numbers to match are not supported and ignored.
+        const U8* Part = Data + 10;
+        U16 Flags;
+        do {
+            if (Part + 4 > DataEnd || Depth >= FONT_ATLAS_MAX_COMPOSITE_DEPTH) {
+                return False;
+            }
+
+            Flags = FontAtlas_ReadU16(Part);
+            const U16 PartGlyph = FontAtlas_ReadU16(Part + 2);
+            Part += 4;
+
+            F32 Offsets[2] = {0.f, 0.f};
+            const U32 ArgumentSize = Flags & 1 ? 4 : 2;
+            if (Part + ArgumentSize > DataEnd) {
+                return False;
+            }
+            if (Flags & 2) {
+                Offsets[0] = Flags & 1 ? (F32)FontAtlas_ReadI16(Part) : (F32)(I8)Part[0];
+                Offsets[1] = Flags & 1 ? (F32)FontAtlas_ReadI16(Part + 2) : (F32)(I8)Part[1];
+            }
+            Part += ArgumentSize;
+
+            F32 Matrix[4] = {1.f, 0.f, 0.f, 1.f};
+            const U32 ScaleCount = Flags & 8 ? 1 : Flags & 0x40 ? 2 : Flags & 0x80 ? 4 : 0;
+            if (Part + ScaleCount * 2 > DataEnd) {
+                return False;
+            }
+            for (U32 Index = 0; Index < ScaleCount; Index++) {
+                const F32 Value = (F32)FontAtlas_ReadI16(Part + Index * 2) / 16384.f;
+                if (ScaleCount == 1) {
+                    Matrix[0] = Matrix[3] = Value;
+                } else if (ScaleCount == 2) {
+                    Matrix[Index * 3] = Value;
+                } else {
+                    Matrix[Index] = Value;
+                }
+            }
+            Part += ScaleCount * 2;
+
+            const F32 PartTransform[6] = {
+                Transform[0] * Matrix[0] + Transform[2] * Matrix[1],
+                Transform[1] * Matrix[0] + Transform[3] * Matrix[1],
+                Transform[0] * Matrix[2] + Transform[2] * Matrix[3],
+                Transform[1] * Matrix[2] + Transform[3] * Matrix[3],
+                Transform[0] * Offsets[0] + Transform[2] * Offsets[1] + Transform[4],
+                Transform[1] * Offsets[0] + Transform[3] * Offsets[1] + Transform[5],
+            };
+            if (!FontAtlas_AddGlyph(Font, PartGlyph, PartTransform, Depth + 1, Outline)) {
+                return False;
+            }
+        } while (Flags & 0x20);
+
+        return True;
+    }
+
+    const U8* EndPoints = Data + 10;
+    if (EndPoints + ContourCount * 2 + 2 > DataEnd) {
+        return False;
+    }
+    const U32 PointCount = ContourCount > 0 ? FontAtlas_ReadU16(EndPoints + (ContourCount - 1) * 2) + 1u : 0;
+    const U8* Cursor = EndPoints + ContourCount * 2;
+    Cursor += 2 + FontAtlas_ReadU16(Cursor);
+
+    U8* Flags = malloc(PointCount + 1);
+    F32* Points = malloc(((size_t)PointCount + 1) * 2 * sizeof *Points);
+
+    // Flags may repeat, coordinates are deltas of one or two bytes or repeat the previous one.
+    Bool bValid = True;
+    for (U32 Point = 0; Point < PointCount && bValid;) {
+        bValid = Cursor < DataEnd;
+        const U8 Flag = bValid ? *Cursor++ : 0;
+        U32 Repeat = 1;
+        if (bValid && Flag & 8) {
+            bValid = Cursor < DataEnd;
+            Repeat += bValid ? *Cursor++ : 0;
+        }
+        for (; Repeat > 0 && Point < PointCount; Repeat--) {
+            Flags[Point++] = Flag;
+        }
+    }
+    for (U32 Axis = 0; Axis < 2 && bValid; Axis++) {
+        const U8 ShortFlag = Axis == 0 ? 2 : 4;
+        const U8 SameFlag = Axis == 0 ? 16 : 32;
+        I32 Value = 0;
+        for (U32 Point = 0; Point < PointCount && bValid; Point++) {
+            if (Flags[Point] & ShortFlag) {
+                bValid = Cursor + 1 <= DataEnd;
+                const I32 Delta = bValid ? *Cursor++ : 0;
+                Value += Flags[Point] & SameFlag ? Delta : -Delta;
+            } else if ((Flags[Point] & SameFlag) == 0) {
+                bValid = Cursor + 2 <= DataEnd;
+                Value += bValid ? FontAtlas_ReadI16(Cursor) : 0;
+                Cursor += 2;
+            }
+            Points[Point * 2 + Axis] = (F32)Value;
+        }
+    }
+
+    // Units of the font shrunk to a pixel by the transform, for the flattening of the curves.
+    const F32 UnitsPerPixel = 1.f / sqrtf(fabsf(Transform[0] * Transform[3] - Transform[1] * Transform[2]));
+    for (U32 Point = 0; Point < PointCount && bValid; Point++) {
+        const F32 X = Points[Point * 2];
+        const F32 Y = Points[Point * 2 + 1];
+        Points[Point * 2] = Transform[0] * X + Transform[2] * Y + Transform[4];
+        Points[Point * 2 + 1] = Transform[1] * X + Transform[3] * Y + Transform[5];
+    }
+
+    // Off-curve points are quadratic controls, two in a row imply an on-curve point between them.
+    U32 First = 0;
+    for (I32 Contour = 0; Contour < ContourCount && bValid; Contour++) {
+        const U32 Last = FontAtlas_ReadU16(EndPoints + Contour * 2);
+        if (Last < First || Last >= PointCount) {
+            bValid = False;
+            break;
+        }
+
+        const U32 Count = Last - First + 1;
+        const F32* P = Points + First * 2;
+        const U8* F = Flags + First;
+        F32 Start[2];
+        U32 Begin = 0;
+        U32 Steps = Count;
+        if (F[0] & 1) {
+            Start[0] = P[0], Start[1] = P[1];
+            Begin = 1;
+            Steps = Count - 1;
+        } else if (F[Count - 1] & 1) {
+            Start[0] = P[(Count - 1) * 2], Start[1] = P[(Count - 1) * 2 + 1];
+            Steps = Count - 1;
+        } else {
+            Start[0] = (P[0] + P[(Count - 1) * 2]) * 0.5f;
+            Start[1] = (P[1] + P[(Count - 1) * 2 + 1]) * 0.5f;
+        }
+
+        Outline->Current[0] = Start[0];
+        Outline->Current[1] = Start[1];
+        Bool bControl = False;
+        F32 Control[2] = {0.f, 0.f};
+        for (U32 Step = 0; Step < Steps; Step++) {
+            const U32 Index = (Begin + Step) % Count;
+            const F32 X = P[Index * 2];
+            const F32 Y = P[Index * 2 + 1];
+            if (F[Index] & 1) {
+                if (bControl) {
+                    FontAtlas_AddCurve(Outline, Control[0], Control[1], X, Y, UnitsPerPixel);
+                } else {
+                    FontAtlas_AddLine(Outline, X, Y);
+                }
+                bControl = False;
+            } else {
+                if (bControl) {
+                    FontAtlas_AddCurve(Outline, Control[0], Control[1], (Control[0] + X) * 0.5f, (Control[1] + Y) * 0.5f, UnitsPerPixel);
+                }
+                Control[0] = X;
+                Control[1] = Y;
+                bControl = True;
+            }
+        }
+        if (bControl) {
+            FontAtlas_AddCurve(Outline, Control[0], Control[1], Start[0], Start[1], UnitsPerPixel);
+        } else {
+            FontAtlas_AddLine(Outline, Start[0], Start[1]);
+        }
+
+        First = Last + 1;
+    }
+
+    free(Points);
+    free(Flags);
+    return bValid;
+}
+
+void FontAtlas_AddLine(FFontAtlasOutline* Outline, const F32 X, const F32 Y) {
+    if (X == Outline->Current[0] && Y == Outline->Current[1]) {
+        return;
+    }
+
+    if (FVector_GetSize(Outline->Lines) == FVector_GetCapacity(Outline->Lines)) {
+        const size_t Capacity = FVector_GetCapacity(Outline->Lines) * 2 + 64;
+        FVector_Reserve(Outline->Lines, Capacity);
+    }
+    FVector_Add(Outline->Lines, ((FFontAtlasLine){Outline->Current[0], Outline->Current[1], X, Y}));
+    Outline->Current[0] = X;
+    Outline->Current[1] = Y;
+}
+
+void FontAtlas_AddCurve(FFontAtlasOutline* Outline, const F32 ControlX, const F32 ControlY, const F32 X, const F32 Y, const F32 UnitsPerPixel) {
+    // A line per two pixels of the control polygon keeps the flattening error far under the texel size.
+    const F32 StartX = Outline->Current[0];
+    const F32 StartY = Outline->Current[1];
+    const F32 Length = hypotf(ControlX - StartX, ControlY - StartY) + hypotf(X - ControlX, Y - ControlY);
+    U32 Count = 1 + (U32)(Length / (UnitsPerPixel * 2.f));
+    Count = Count < FONT_ATLAS_MAX_CURVE_LINES ? Count : FONT_ATLAS_MAX_CURVE_LINES;
+
+    for (U32 Step = 1; Step <= Count; Step++) {
+        const F32 T = (F32)Step / (F32)Count;
+        const F32 S = 1.f - T;
+        FontAtlas_AddLine(Outline, S * S * StartX + 2.f * S * T * ControlX + T * T * X, S * S * StartY + 2.f * S * T * ControlY + T * T * Y);
+    }
+}
+
+void FontAtlas_SampleGlyph(const FFontAtlasOutline* Outline, const I32 Left, const I32 Top, const U32 Width, const U32 Height, const U32 Spread, U8* Texels,
+                           const U32 Stride) {
+    const FFontAtlasLine* Lines = Outline->Lines;
+    const U32 LineCount = (U32)FVector_GetSize(Outline->Lines);
+    const F32 Scale = 0.5f / (F32)Spread;
+
+    for (U32 Row = 0; Row < Height; Row++) {
+        const F32 Y = (F32)Top - (F32)Row - 0.5f;
+        for (U32 Column = 0; Column < Width; Column++) {
+            const F32 X = (F32)Left + (F32)Column + 0.5f;
+
+            // Nearest point of the outline, and the nonzero winding of the outline around the texel for the side.
+            F32 MinDistance = INFINITY;
+            I32 Winding = 0;
+            for (U32 Index = 0; Index < LineCount; Index++) {
+                const FFontAtlasLine* Line = &Lines[Index];
+                const F32 DX = Line->X1 - Line->X0;
+                const F32 DY = Line->Y1 - Line->Y0;
+                const F32 PX = X - Line->X0;
+                const F32 PY = Y - Line->Y0;
+                F32 T = (PX * DX + PY * DY) / (DX * DX + DY * DY);
+                T = T < 0.f ? 0.f : T > 1.f ? 1.f : T;
+                const F32 EX = PX - DX * T;
+                const F32 EY = PY - DY * T;
+                MinDistance = fminf(MinDistance, EX * EX + EY * EY);
+
+                if ((Line->Y0 <= Y) != (Line->Y1 <= Y) && (PX * DY - PY * DX < 0.f) == (DY > 0.f)) {
+                    Winding += DY > 0.f ? 1 : -1;
+                }
+            }
+
+            const F32 Distance = Winding != 0 ? sqrtf(MinDistance) : -sqrtf(MinDistance);
+            const F32 Value = 0.5f + Distance * Scale;
+            Texels[(size_t)Row * Stride + Column] = (U8)(Value <= 0.f ? 0 : Value >= 1.f ? 255 : (I32)(Value * 255.f + 0.5f));
+        }
+    }
+}
+#pragma endregion
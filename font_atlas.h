@@ -0,0 +1,88 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Signed distance field glyph atlas of the printable ASCII characters. Glyph outlines are read straight from the
+ * TrueType tables and the distance to them is sampled into an 8-bit texture, 0.5 on the outline and growing inwards,
+ * so one texture draws sharp text at any size. Atlases are saved with their metrics and the key of the font and
+ * settings they were built from, later launches read them back without touching the font.
+ */
+#define FONT_ATLAS_FIRST_GLYPH 32
+#define FONT_ATLAS_GLYPH_COUNT 95
+
+typedef struct {
+    /** Pixels per em the distances are sampled at. */
+    U32 GlyphSize;
+    /** Distance in pixels from the outline to the ends of the value range, glyphs are padded by it. */
+    U32 Spread;
+    /** Atlas width in pixels, the height fits the glyphs. */
+    U32 Width;
+} FFontAtlasSettings;
+
+typedef struct {
+    /** Quad of the glyph around the pen on the baseline, in ems with y up, empty for blank glyphs. */
+    F32 Left;
+    F32 Bottom;
+    F32 Right;
+    F32 Top;
+    /** Texture coordinates of the top left and bottom right corners of the quad. */
+    F32 U0;
+    F32 V0;
+    F32 U1;
+    F32 V1;
+    /** Pen advance in ems. */
+    F32 Advance;
+} FFontGlyph;
+
+typedef struct {
+    /** FontAtlas_GetKey of the font and settings the atlas was built from. */
+    U64 Key;
+    FFontAtlasSettings Settings;
+    /** Font metrics in ems, the descent is negative. */
+    F32 Ascent;
+    F32 Descent;
+    F32 LineGap;
+    FFontGlyph Glyphs[FONT_ATLAS_GLYPH_COUNT];
+    U32 Width;
+    U32 Height;
+    /** Distances of Width * Height texels, the top row first. */
+    U8* Pixels;
+} FFontAtlas;
+
+/** Text vertex, positions in pixels from the top left corner. */
+typedef struct {
+    F32 X;
+    F32 Y;
+    F32 U;
+    F32 V;
+    /** Color in the byte order of the vertex color attribute, see OVERLAY_COLOR. */
+    U32 Color;
+} FFontVertex;
+
+void FontAtlas_GetDefaultSettings(FFontAtlasSettings* OutSettings);
+
+/** Returns the cache key of an atlas of the font file built with the settings. */
+U64 FontAtlas_GetKey(const U8* FontData, U64 Length, const FFontAtlasSettings* Settings);
+
+/** Builds the atlas from a TrueType font file. Returns False if the font can't be read. */
+Bool FontAtlas_Build(const U8* FontData, U64 Length, const FFontAtlasSettings* Settings, FFontAtlas* OutAtlas);
+
+/** Writes the atlas to a file. Returns False on failure. */
+Bool FontAtlas_Write(const FFontAtlas* Atlas, pStr Path);
+
+/**
+ * Reads an atlas written by FontAtlas_Write, copying its texels. Returns False if the data is damaged or was built
+ * from another font or other settings than the key says, zero accepts any.
+ */
+Bool FontAtlas_Read(const U8* Data, U64 Length, U64 Key, FFontAtlas* OutAtlas);
+
+void FontAtlas_Free(FFontAtlas* Atlas);
+
+/**
+ * Lays out a line of text with its top left corner at the position and Size pixels per em. Characters the atlas lacks
+ * are drawn as question marks. Writes two triangles per visible glyph while they fit, returns the vertices written.
+ */
+U32 FontAtlas_LayoutText(const FFontAtlas* Atlas, F32 X, F32 Y, F32 Size, pStr Text, U32 Color, FFontVertex* OutVertices, U32 MaxVertices);
+
+/** Returns the width in pixels of a line of text at Size pixels per em. */
+F32 FontAtlas_GetTextWidth(const FFontAtlas* Atlas, F32 Size, pStr Text);
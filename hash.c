@@ -0,0 +1,113 @@
+#include "hash.h"
+
+#include <string.h>
+
+#pragma region Settings
+static const U64 Prime1 = 0x9E3779B185EBCA87ULL;
+static const U64 Prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const U64 Prime3 = 0x165667B19E3779F9ULL;
+static const U64 Prime4 = 0x85EBCA77C2B2AE63ULL;
+static const U64 Prime5 = 0x27D4EB2F165667C5ULL;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static U64 Hash_Rotate(U64 Value, U32 Bits);
+static U64 Hash_Read64(const U8* Data);
+static U32 Hash_Read32(const U8* Data);
+static U64 Hash_Round(U64 Accumulator, U64 Lane);
+static U64 Hash_MergeRound(U64 Accumulator, U64 Value);
+#pragma endregion
+
+#pragma region Public Function Definitions
+U64 Hash_Compute(const void* Data, const U64 Length, const U64 Seed) {
+    const U8* Input = Data;
+    const U8* const End = Input + Length;
+    U64 Result;
+
+    if (Length >= 32) {
+        const U8* const Limit = End - 32;
+        U64 V1 = Seed + Prime1 + Prime2;
+        U64 V2 = Seed + Prime2;
+        U64 V3 = Seed;
+        U64 V4 = Seed - Prime1;
+
+        do {
+            V1 = Hash_Round(V1, Hash_Read64(Input));
+            V2 = Hash_Round(V2, Hash_Read64(Input + 8));
+            V3 = Hash_Round(V3, Hash_Read64(Input + 16));
+            V4 = Hash_Round(V4, Hash_Read64(Input + 24));
+            Input += 32;
+        } while (Input <= Limit);
+
+        Result = Hash_Rotate(V1, 1) + Hash_Rotate(V2, 7) + Hash_Rotate(V3, 12) + Hash_Rotate(V4, 18);
+        Result = Hash_MergeRound(Result, V1);
+        Result = Hash_MergeRound(Result, V2);
+        Result = Hash_MergeRound(Result, V3);
+        Result = Hash_MergeRound(Result, V4);
+    } else {
+        Result = Seed + Prime5;
+    }
+
+    Result += Length;
+
+    while (Input + 8 <= End) {
+        Result ^= Hash_Round(0, Hash_Read64(Input));
+        Result = Hash_Rotate(Result, 27) * Prime1 + Prime4;
+        Input += 8;
+    }
+
+    if (Input + 4 <= End) {
+        Result ^= (U64)Hash_Read32(Input) * Prime1;
+        Result = Hash_Rotate(Result, 23) * Prime2 + Prime3;
+        Input += 4;
+    }
+
+    while (Input < End) {
+        Result ^= *Input * Prime5;
+        Result = Hash_Rotate(Result, 11) * Prime1;
+        Input++;
+    }
+
+    Result ^= Result >> 33;
+    Result *= Prime2;
+    Result ^= Result >> 29;
+    Result *= Prime3;
+    Result ^= Result >> 32;
+
+    return Result;
+}
+
+U64 Hash_String(const pStr String) {
+    return Hash_Compute(String, strlen(String), 0);
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+U64 Hash_Rotate(const U64 Value, const U32 Bits) {
+    return (Value << Bits) | (Value >> (64 - Bits));
+}
+
+// Unaligned little-endian loads, compilers turn the memcpy into a single move.
+U64 Hash_Read64(const U8* Data) {
+    U64 Value;
+    memcpy(&Value, Data, sizeof Value);
+    return Value;
+}
+
+U32 Hash_Read32(const U8* Data) {
+    U32 Value;
+    memcpy(&Value, Data, sizeof Value);
+    return Value;
+}
+
+U64 Hash_Round(U64 Accumulator, const U64 Lane) {
+    Accumulator += Lane * Prime2;
+    Accumulator = Hash_Rotate(Accumulator, 31);
+    return Accumulator * Prime1;
+}
+
+U64 Hash_MergeRound(U64 Accumulator, const U64 Value) {
+    Accumulator ^= Hash_Round(0, Value);
+    return Accumulator * Prime1 + Prime4;
+}
+#pragma endregion
@@ -0,0 +1,8 @@
+#pragma once
+#include "typedefs.h"
+
+/** 64-bit content hash (xxHash64) of the data. */
+U64 Hash_Compute(const void* Data, U64 Length, U64 Seed);
+
+/** 64-bit hash of the null-terminated string. */
+U64 Hash_String(pStr String);
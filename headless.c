@@ -0,0 +1,164 @@
+#include "headless.h"
+
+#include <string.h>
+
+#include <SDL_log.h>
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define HEADLESS_EGL_SUPPORTED 1
+#else
+#define HEADLESS_EGL_SUPPORTED 0
+#endif
+
+#pragma region Private Variables
+#if HEADLESS_EGL_SUPPORTED
+static EGLDisplay HeadlessDisplay = EGL_NO_DISPLAY;
+static EGLContext HeadlessContext = EGL_NO_CONTEXT;
+/** Pbuffer of drivers without surfaceless contexts, EGL_NO_SURFACE otherwise. */
+static EGLSurface HeadlessSurface = EGL_NO_SURFACE;
+#endif
+#pragma endregion
+
+#pragma region Private Function Declarations
+#if HEADLESS_EGL_SUPPORTED
+/** Returns True if the space separated extension list has the extension. */
+static Bool Headless_HasExtension(const char* Extensions, pStr Extension);
+
+/** Returns the surfaceless platform display when the client supports it, the default display otherwise. */
+static EGLDisplay Headless_GetDisplay();
+#endif
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Headless_Initialize(const I32 MajorVersion, const I32 MinorVersion) {
+#if HEADLESS_EGL_SUPPORTED
+    HeadlessDisplay = Headless_GetDisplay();
+    EGLint Major = 0;
+    EGLint Minor = 0;
+    if (HeadlessDisplay == EGL_NO_DISPLAY || !eglInitialize(HeadlessDisplay, &Major, &Minor)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize an EGL display: 0x%x.", eglGetError());
+        HeadlessDisplay = EGL_NO_DISPLAY;
+        return False;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "EGL display has no desktop OpenGL.");
+        Headless_Shutdown();
+        return False;
+    }
+
+    const char* Extensions = eglQueryString(HeadlessDisplay, EGL_EXTENSIONS);
+    const Bool bSurfaceless = Headless_HasExtension(Extensions, "EGL_KHR_surfaceless_context");
+
+    const EGLint ConfigAttributes[] = {EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+    EGLConfig Config = NULL;
+    EGLint ConfigCount = 0;
+    eglChooseConfig(HeadlessDisplay, ConfigAttributes, &Config, 1, &ConfigCount);
+
+    // Surfaceless platforms have no pbuffer configs, contexts without a config render to framebuffer objects only.
+    if (ConfigCount == 0 && !(bSurfaceless && Headless_HasExtension(Extensions, "EGL_KHR_no_config_context"))) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "EGL display has no config for offscreen OpenGL rendering.");
+        Headless_Shutdown();
+        return False;
+    }
+
+    const EGLint ContextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION, MajorVersion, EGL_CONTEXT_MINOR_VERSION, MinorVersion,
+                                        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+    HeadlessContext = eglCreateContext(HeadlessDisplay, ConfigCount > 0 ? Config : (EGLConfig)0, EGL_NO_CONTEXT, ContextAttributes);
+    if (HeadlessContext == EGL_NO_CONTEXT) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to create an OpenGL %d.%d core context: 0x%x.", MajorVersion, MinorVersion, eglGetError());
+        Headless_Shutdown();
+        return False;
+    }
+
+    if (!bSurfaceless) {
+        const EGLint SurfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        HeadlessSurface = eglCreatePbufferSurface(HeadlessDisplay, Config, SurfaceAttributes);
+        if (HeadlessSurface == EGL_NO_SURFACE) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to create an EGL pbuffer: 0x%x.", eglGetError());
+            Headless_Shutdown();
+            return False;
+        }
+    }
+
+    if (!Headless_MakeCurrent(True)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to make the offscreen context current: 0x%x.", eglGetError());
+        Headless_Shutdown();
+        return False;
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Rendering offscreen on EGL %d.%d%s", Major, Minor, bSurfaceless ? ", surfaceless" : "");
+
+    return True;
+#else
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Headless rendering needs EGL, which is not supported on this platform.");
+    return False;
+#endif
+}
+
+void Headless_Shutdown() {
+#if HEADLESS_EGL_SUPPORTED
+    if (HeadlessDisplay == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    eglMakeCurrent(HeadlessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (HeadlessSurface != EGL_NO_SURFACE) {
+        eglDestroySurface(HeadlessDisplay, HeadlessSurface);
+    }
+    if (HeadlessContext != EGL_NO_CONTEXT) {
+        eglDestroyContext(HeadlessDisplay, HeadlessContext);
+    }
+    eglTerminate(HeadlessDisplay);
+
+    HeadlessDisplay = EGL_NO_DISPLAY;
+    HeadlessContext = EGL_NO_CONTEXT;
+    HeadlessSurface = EGL_NO_SURFACE;
+#endif
+}
+
+Bool Headless_MakeCurrent(const Bool bCurrent) {
+#if HEADLESS_EGL_SUPPORTED
+    if (!bCurrent) {
+        return eglMakeCurrent(HeadlessDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) == EGL_TRUE;
+    }
+
+    return eglMakeCurrent(HeadlessDisplay, HeadlessSurface, HeadlessSurface, HeadlessContext) == EGL_TRUE;
+#else
+    return False;
+#endif
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+#if HEADLESS_EGL_SUPPORTED
+Bool Headless_HasExtension(const char* Extensions, const pStr Extension) {
+    const size_t Length = strlen(Extension);
+    for (const char* Found = Extensions != NULL ? strstr(Extensions, Extension) : NULL; Found != NULL; Found = strstr(Found + Length, Extension)) {
+        if ((Found == Extensions || Found[-1] == ' ') && (Found[Length] == ' ' || Found[Length] == '\0')) {
+            return True;
+        }
+    }
+
+    return False;
+}
+
+EGLDisplay Headless_GetDisplay() {
+    // Client extensions are queried without a display.
+    const char* ClientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (Headless_HasExtension(ClientExtensions, "EGL_MESA_platform_surfaceless") && Headless_HasExtension(ClientExtensions, "EGL_EXT_platform_base")) {
+        const PFNEGLGETPLATFORMDISPLAYEXTPROC GetPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (GetPlatformDisplay != NULL) {
+            const EGLDisplay Display = GetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            if (Display != EGL_NO_DISPLAY) {
+                return Display;
+            }
+        }
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+#endif
+#pragma endregion
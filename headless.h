@@ -0,0 +1,17 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Offscreen GL context without a window or a display server, for rendering on build machines. The context is created
+ * through EGL, surfaceless when the driver allows it and on a 1x1 pbuffer otherwise, so the caller renders into its own
+ * framebuffer. Mesa's llvmpipe provides it on machines without a GPU.
+ */
+
+/** Creates the context of the core profile version and makes it current on the calling thread. Returns False on failure. */
+Bool Headless_Initialize(I32 MajorVersion, I32 MinorVersion);
+
+/** Destroys the context, it must not be current on another thread. */
+void Headless_Shutdown();
+
+/** Makes the context current on the calling thread, or releases it from the thread. */
+Bool Headless_MakeCurrent(Bool bCurrent);
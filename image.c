@@ -0,0 +1,183 @@
+#include "image.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#pragma region Settings
+#define TGA_HEADER_SIZE 18
+/** Image types of the TGA header. */
+#define TGA_TYPE_TRUE_COLOR 2
+#define TGA_TYPE_GRAYSCALE 3
+#define TGA_TYPE_RLE_TRUE_COLOR 10
+#define TGA_TYPE_RLE_GRAYSCALE 11
+/** Descriptor bits of the origin corner, the bottom left one when both are clear. */
+#define TGA_DESCRIPTOR_RIGHT 0x10
+#define TGA_DESCRIPTOR_TOP 0x20
+#pragma endregion
+
+#pragma region Private Function Declarations
+/** Converts a texel of a TGA file, stored blue first, into RGBA. */
+static inline void Image_ConvertTgaTexel(const U8* Texel, const U32 BytesPerTexel, U8* OutTexel) {
+    if (BytesPerTexel == 1) {
+        OutTexel[0] = OutTexel[1] = OutTexel[2] = Texel[0];
+        OutTexel[3] = 255;
+        return;
+    }
+
+    OutTexel[0] = Texel[2];
+    OutTexel[1] = Texel[1];
+    OutTexel[2] = Texel[0];
+    OutTexel[3] = BytesPerTexel == 4 ? Texel[3] : 255;
+}
+
+static inline F32 Image_LinearToSrgb(const F32 Value) {
+    const F32 Srgb = Value <= 0.0031308f ? Value * 12.92f : 1.055f * powf(Value, 1.f / 2.4f) - 0.055f;
+    return Srgb * 255.f + 0.5f;
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Image_Create(const U32 Width, const U32 Height, FImage* OutImage) {
+    memset(OutImage, 0, sizeof *OutImage);
+    if (Width == 0 || Height == 0) {
+        return False;
+    }
+
+    OutImage->Pixels = malloc((size_t)Width * Height * 4);
+    if (OutImage->Pixels == NULL) {
+        return False;
+    }
+
+    OutImage->Width = Width;
+    OutImage->Height = Height;
+    return True;
+}
+
+Bool Image_ReadTga(const U8* Data, const U64 Length, FImage* OutImage) {
+    memset(OutImage, 0, sizeof *OutImage);
+    if (Length < TGA_HEADER_SIZE) {
+        return False;
+    }
+
+    const U32 IdLength = Data[0];
+    const U32 ColorMapType = Data[1];
+    const U32 ImageType = Data[2];
+    const U32 Width = Data[12] | Data[13] << 8;
+    const U32 Height = Data[14] | Data[15] << 8;
+    const U32 Depth = Data[16];
+    const U32 Descriptor = Data[17];
+
+    // Color mapped images aren't used for textures.
+    const Bool bGrayscale = ImageType == TGA_TYPE_GRAYSCALE || ImageType == TGA_TYPE_RLE_GRAYSCALE;
+    const Bool bTrueColor = ImageType == TGA_TYPE_TRUE_COLOR || ImageType == TGA_TYPE_RLE_TRUE_COLOR;
+    if (ColorMapType != 0 || (!(bGrayscale && Depth == 8) && !(bTrueColor && (Depth == 24 || Depth == 32)))) {
+        return False;
+    }
+
+    if (!Image_Create(Width, Height, OutImage)) {
+        return False;
+    }
+
+    const Bool bEncoded = ImageType == TGA_TYPE_RLE_TRUE_COLOR || ImageType == TGA_TYPE_RLE_GRAYSCALE;
+    const U32 BytesPerTexel = Depth / 8;
+    const U8* Input = Data + TGA_HEADER_SIZE + IdLength;
+    const U8* const End = Data + Length;
+
+    // Texels are stored row by row from the origin corner, runs may continue on the next row.
+    const U32 TexelCount = Width * Height;
+    U32 RunLength = 0;
+    Bool bRepeat = False;
+    for (U32 Index = 0; Index < TexelCount; Index++) {
+        if (bEncoded && RunLength == 0) {
+            if (Input >= End) {
+                Image_Free(OutImage);
+                return False;
+            }
+            RunLength = (*Input & 0x7F) + 1;
+            bRepeat = (*Input & 0x80) != 0;
+            Input++;
+        }
+
+        if (Input + BytesPerTexel > End) {
+            Image_Free(OutImage);
+            return False;
+        }
+
+        const U32 Row = Index / Width, Column = Index % Width;
+        const U32 Y = Descriptor & TGA_DESCRIPTOR_TOP ? Row : Height - 1 - Row;
+        const U32 X = Descriptor & TGA_DESCRIPTOR_RIGHT ? Width - 1 - Column : Column;
+        Image_ConvertTgaTexel(Input, BytesPerTexel, &OutImage->Pixels[((size_t)Y * Width + X) * 4]);
+
+        // A repeated texel is read again until its run ends.
+        if (bEncoded) {
+            RunLength--;
+            if (!bRepeat || RunLength == 0) {
+                Input += BytesPerTexel;
+            }
+        } else {
+            Input += BytesPerTexel;
+        }
+    }
+
+    return True;
+}
+
+Bool Image_Downsample(const FImage* Image, FImage* OutImage) {
+    const U32 Width = Image->Width > 1 ? Image->Width / 2 : 1;
+    const U32 Height = Image->Height > 1 ? Image->Height / 2 : 1;
+    if (!Image_Create(Width, Height, OutImage)) {
+        return False;
+    }
+
+    F32 SrgbToLinear[256];
+    for (U32 Value = 0; Value < 256; Value++) {
+        const F32 Srgb = (F32)Value / 255.f;
+        SrgbToLinear[Value] = Srgb <= 0.04045f ? Srgb / 12.92f : powf((Srgb + 0.055f) / 1.055f, 2.4f);
+    }
+
+    // Each texel averages the 2x2 texels below it, edges of odd sizes are clamped.
+    for (U32 Y = 0; Y < Height; Y++) {
+        const U32 Rows[2] = {Y * 2 < Image->Height ? Y * 2 : Image->Height - 1, Y * 2 + 1 < Image->Height ? Y * 2 + 1 : Image->Height - 1};
+        for (U32 X = 0; X < Width; X++) {
+            const U32 Columns[2] = {X * 2 < Image->Width ? X * 2 : Image->Width - 1, X * 2 + 1 < Image->Width ? X * 2 + 1 : Image->Width - 1};
+
+            F32 Color[3] = {0.f, 0.f, 0.f}, Plain[3] = {0.f, 0.f, 0.f};
+            U32 AlphaSum = 0;
+            for (U32 Sample = 0; Sample < 4; Sample++) {
+                const U8* Texel = &Image->Pixels[((size_t)Rows[Sample / 2] * Image->Width + Columns[Sample % 2]) * 4];
+                for (U32 Channel = 0; Channel < 3; Channel++) {
+                    Color[Channel] += SrgbToLinear[Texel[Channel]] * Texel[3];
+                    Plain[Channel] += SrgbToLinear[Texel[Channel]];
+                }
+                AlphaSum += Texel[3];
+            }
+
+            U8* OutTexel = &OutImage->Pixels[((size_t)Y * Width + X) * 4];
+            for (U32 Channel = 0; Channel < 3; Channel++) {
+                const F32 Linear = AlphaSum > 0 ? Color[Channel] / (F32)AlphaSum : Plain[Channel] / 4.f;
+                OutTexel[Channel] = (U8)Image_LinearToSrgb(Linear > 1.f ? 1.f : Linear);
+            }
+            OutTexel[3] = (U8)((AlphaSum + 2) / 4);
+        }
+    }
+
+    return True;
+}
+
+Bool Image_HasAlpha(const FImage* Image) {
+    const size_t TexelCount = (size_t)Image->Width * Image->Height;
+    for (size_t Index = 0; Index < TexelCount; Index++) {
+        if (Image->Pixels[Index * 4 + 3] != 255) {
+            return True;
+        }
+    }
+
+    return False;
+}
+
+void Image_Free(FImage* Image) {
+    free(Image->Pixels);
+    memset(Image, 0, sizeof *Image);
+}
+#pragma endregion
@@ -0,0 +1,27 @@
+#pragma once
+#include "typedefs.h"
+
+/** Uncompressed image of RGBA texels, the source of the compressed textures the cooker writes. */
+typedef struct {
+    U32 Width;
+    U32 Height;
+    /** Four bytes per texel, the top row first. */
+    U8* Pixels;
+} FImage;
+
+/** Allocates an image of the size with undefined texels. Returns False on failure. */
+Bool Image_Create(U32 Width, U32 Height, FImage* OutImage);
+
+/** Reads a Truevision TGA file, true color or grayscale, raw or run-length encoded. Returns False if the data isn't one. */
+Bool Image_ReadTga(const U8* Data, U64 Length, FImage* OutImage);
+
+/**
+ * Writes the next mip level of the image, half its size rounded down and at least a texel. Colors are averaged in
+ * linear space and weighted by alpha, so mips neither darken nor bleed the color of transparent texels.
+ */
+Bool Image_Downsample(const FImage* Image, FImage* OutImage);
+
+/** Returns True if any texel isn't fully opaque. */
+Bool Image_HasAlpha(const FImage* Image);
+
+void Image_Free(FImage* Image);
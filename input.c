@@ -4,78 +4,313 @@
 #include <SDL.h>
 #include <SDL_log.h>
 
-#include "application.h"
+#include "clock.h"
+#include "containers/vector.h"
 
-#pragma region Defaults
+#pragma region Settings
+/** Events queued between steps, a power of two. When full the oldest event is applied early, to the next snapshot. */
+#define INPUT_EVENT_CAPACITY 1024
 #pragma endregion
 
-/** Input action bindings. */
-static FInputActionBinding InputActionBindings[8];
+typedef enum {
+    INPUT_EVENT_KEY_DOWN = 0,
+    INPUT_EVENT_KEY_UP,
+    INPUT_EVENT_MOUSE_MOTION,
+} EInputEventType;
 
-/** Input axis bindings. */
-static FInputAxisBinding InputAxisBindings[8];
+/** Event queued until the step it belongs to is built. */
+typedef struct {
+    U64 Timestamp;
+    I32 X;
+    I32 Y;
+    U16 Key;
+    Byte Type;
+} FInputEvent;
+
+/** Action binding, the bindings of a key or an axis are chained through Next. */
+typedef struct {
+    EInputAction Action;
+    F32 Scale;
+    U32 Next;
+} FInputBinding;
+
+#pragma region Private Variables
+/** Ring of events not applied to a snapshot yet. */
+static FInputEvent InputEvents[INPUT_EVENT_CAPACITY];
+static U32 InputEventHead = 0;
+static U32 InputEventCount = 0;
+
+static FVector(FInputBinding) InputBindings = NULL;
+
+/** First binding of each key and each axis, InvalidId if unbound. */
+static U32 InputKeyBindings[INPUT_KEY_COUNT];
+static U32 InputAxisBindings[INPUT_AXIS_COUNT];
+
+/** Snapshot of the next step, built while its events are applied. */
+static FInputSnapshot InputPending;
+
+/** Action values of the keys down, kept across steps. */
+static F32 InputKeyActions[INPUT_ACTION_COUNT];
+
+/** Times of the events applied to the pending snapshot and of the ones of the last snapshot built. */
+static FVector(U64) InputPendingTimestamps = NULL;
+static FVector(U64) InputSnapshotTimestamps = NULL;
+
+/** Log the queued events are recorded to, NULL when not recording. */
+static FReplay* InputRecorder = NULL;
+#pragma endregion
 
 #pragma region Private Function Declarations
-static void DefaultInputHandler(const SDL_Event* Event);
-static void DefaultAxisHandler(const SDL_Event* Event, EInputAxis Axis, I32 Value);
-static void DefaultApplicationExitHandler(const SDL_Event* Event);
+/** Queues the event, merging mouse motion into the last queued event when it is mouse motion too. */
+static void Input_PushEvent(FInputEvent Event);
+
+/** Applies the event to the pending snapshot. */
+static void Input_ApplyEvent(const FInputEvent* Event);
+
+static void Input_AddBinding(U32* First, EInputAction Action, F32 Scale);
 #pragma endregion
 
 #pragma region Public Function Definitions
 void Input_Initialize() {
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
-    InputActionBindings[0] = (FInputActionBinding){SDLK_ESCAPE, DefaultApplicationExitHandler};
-    InputActionBindings[1] = (FInputActionBinding){SDLK_w, DefaultInputHandler};
-    InputActionBindings[2] = (FInputActionBinding){SDLK_a, DefaultInputHandler};
-    InputActionBindings[3] = (FInputActionBinding){SDLK_s, DefaultInputHandler};
-    InputActionBindings[4] = (FInputActionBinding){SDLK_d, DefaultInputHandler};
+    for (U32 Key = 0; Key < INPUT_KEY_COUNT; Key++) {
+        InputKeyBindings[Key] = InvalidId;
+    }
+    for (U32 Axis = 0; Axis < INPUT_AXIS_COUNT; Axis++) {
+        InputAxisBindings[Axis] = InvalidId;
+    }
+
+    Input_BindKey(SDL_SCANCODE_ESCAPE, INPUT_ACTION_EXIT, 1.f);
+    Input_BindKey(SDL_SCANCODE_W, INPUT_ACTION_MOVE_FORWARD, 1.f);
+    Input_BindKey(SDL_SCANCODE_S, INPUT_ACTION_MOVE_FORWARD, -1.f);
+    Input_BindKey(SDL_SCANCODE_D, INPUT_ACTION_MOVE_RIGHT, 1.f);
+    Input_BindKey(SDL_SCANCODE_A, INPUT_ACTION_MOVE_RIGHT, -1.f);
+    Input_BindKey(SDL_SCANCODE_SPACE, INPUT_ACTION_MOVE_UP, 1.f);
+    Input_BindKey(SDL_SCANCODE_LCTRL, INPUT_ACTION_MOVE_UP, -1.f);
+    Input_BindKey(SDL_SCANCODE_F3, INPUT_ACTION_TOGGLE_OVERLAY, 1.f);
+    Input_BindKey(Input_GetMouseButtonKey(SDL_BUTTON_LEFT), INPUT_ACTION_PRIMARY, 1.f);
+    Input_BindKey(Input_GetMouseButtonKey(SDL_BUTTON_RIGHT), INPUT_ACTION_SECONDARY, 1.f);
+
+    Input_BindAxis(INPUT_AXIS_MOUSE_X, INPUT_ACTION_LOOK_YAW, 1.f);
+    Input_BindAxis(INPUT_AXIS_MOUSE_Y, INPUT_ACTION_LOOK_PITCH, -1.f);
+}
 
-    InputAxisBindings[0] = (FInputAxisBinding){INPUT_AXIS_MOUSE_X, DefaultAxisHandler};
-    InputAxisBindings[1] = (FInputAxisBinding){INPUT_AXIS_MOUSE_Y, DefaultAxisHandler};
+void Input_Shutdown() {
+    FVector_Free(InputBindings);
+    InputBindings = NULL;
+    FVector_Free(InputPendingTimestamps);
+    InputPendingTimestamps = NULL;
+    FVector_Free(InputSnapshotTimestamps);
+    InputSnapshotTimestamps = NULL;
+    InputEventHead = 0;
+    InputEventCount = 0;
+    SDL_memset(&InputPending, 0, sizeof InputPending);
+    SDL_memset(InputKeyActions, 0, sizeof InputKeyActions);
+}
+
+U32 Input_GetMouseButtonKey(const U8 Button) {
+    return SDL_NUM_SCANCODES + Button - 1;
+}
+
+void Input_BindKey(const U32 Key, const EInputAction Action, const F32 Scale) {
+    if (Key < INPUT_KEY_COUNT) {
+        Input_AddBinding(&InputKeyBindings[Key], Action, Scale);
+    }
+}
+
+void Input_BindAxis(const EInputAxis Axis, const EInputAction Action, const F32 Scale) {
+    if (Axis != INPUT_AXIS_UNKNOWN && Axis < INPUT_AXIS_COUNT) {
+        Input_AddBinding(&InputAxisBindings[Axis], Action, Scale);
+    }
 }
 
 void Input_HandleEvent(const SDL_Event* Event) {
-    if (Event->type == SDL_KEYDOWN || Event->type == SDL_KEYUP || Event->type == SDL_MOUSEBUTTONDOWN || Event->type == SDL_MOUSEBUTTONUP) {
-        const int BindingsCount = sizeof InputActionBindings / sizeof InputActionBindings[0];
-        for (int Index = 0; Index < BindingsCount; Index++) {
-            const FInputActionBinding InputKeyBinding = InputActionBindings[Index];
-
-            if (InputKeyBinding.Keycode != SDLK_UNKNOWN && InputKeyBinding.Keycode == Event->key.keysym.sym) {
-                InputKeyBinding.Handler(Event);
-            }
+    const U64 Timestamp = Clock_GetNanoseconds();
+
+    switch (Event->type) {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        // Held keys repeat, only the first press is an edge.
+        if (!Event->key.repeat && Event->key.keysym.scancode < SDL_NUM_SCANCODES) {
+            const Byte Type = Event->type == SDL_KEYDOWN ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+            Input_PushEvent((FInputEvent){Timestamp, 0, 0, (U16)Event->key.keysym.scancode, Type});
+        }
+        break;
+
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        if (Event->button.button >= 1 && Event->button.button <= INPUT_MOUSE_BUTTON_COUNT) {
+            const Byte Type = Event->type == SDL_MOUSEBUTTONDOWN ? INPUT_EVENT_KEY_DOWN : INPUT_EVENT_KEY_UP;
+            Input_PushEvent((FInputEvent){Timestamp, 0, 0, (U16)Input_GetMouseButtonKey(Event->button.button), Type});
+        }
+        break;
+
+    case SDL_MOUSEMOTION:
+        Input_PushEvent((FInputEvent){Timestamp, Event->motion.xrel, Event->motion.yrel, 0, INPUT_EVENT_MOUSE_MOTION});
+        break;
+
+    default:
+        break;
+    }
+}
+
+void Input_SetRecorder(FReplay* Replay) {
+    InputRecorder = Replay;
+}
+
+Bool Input_GetReplayEvent(const FReplayRecord* Record, SDL_Event* OutEvent) {
+    SDL_memset(OutEvent, 0, sizeof *OutEvent);
+
+    switch (Record->Type) {
+    case REPLAY_RECORD_KEY_DOWN:
+    case REPLAY_RECORD_KEY_UP:
+        if (Record->Key < SDL_NUM_SCANCODES) {
+            OutEvent->type = Record->Type == REPLAY_RECORD_KEY_DOWN ? SDL_KEYDOWN : SDL_KEYUP;
+            OutEvent->key.keysym.scancode = (SDL_Scancode)Record->Key;
+        } else if (Record->Key < INPUT_KEY_COUNT) {
+            OutEvent->type = Record->Type == REPLAY_RECORD_KEY_DOWN ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+            OutEvent->button.button = (U8)(Record->Key - SDL_NUM_SCANCODES + 1);
+        } else {
+            return False;
         }
-    } else if (Event->type == SDL_MOUSEMOTION) {
-        const int BindingsCount = sizeof InputAxisBindings / sizeof InputAxisBindings[0];
+        return True;
 
-        for (int Index = 0; Index < BindingsCount; Index++) {
-            const FInputAxisBinding InputAxisBinding = InputAxisBindings[Index];
+    case REPLAY_RECORD_MOUSE_MOTION:
+        OutEvent->type = SDL_MOUSEMOTION;
+        OutEvent->motion.xrel = Record->X;
+        OutEvent->motion.yrel = Record->Y;
+        return True;
 
-            if (InputAxisBinding.Axis == INPUT_AXIS_UNKNOWN) {
-                continue;
-            }
+    default:
+        return False;
+    }
+}
+
+void Input_BuildSnapshot(const U64 Timestamp, FInputSnapshot* OutSnapshot) {
+    while (InputEventCount > 0 && InputEvents[InputEventHead].Timestamp <= Timestamp) {
+        Input_ApplyEvent(&InputEvents[InputEventHead]);
+        InputEventHead = (InputEventHead + 1) & (INPUT_EVENT_CAPACITY - 1);
+        InputEventCount--;
+    }
+
+    InputPending.Timestamp = Timestamp;
+    for (U32 Action = 0; Action < INPUT_ACTION_COUNT; Action++) {
+        InputPending.Actions[Action] = InputKeyActions[Action];
+    }
 
-            if (InputAxisBinding.Axis == INPUT_AXIS_MOUSE_X) {
-                InputAxisBinding.Handler(Event, INPUT_AXIS_MOUSE_X, Event->motion.xrel);
-            } else if (InputAxisBinding.Axis == INPUT_AXIS_MOUSE_Y) {
-                InputAxisBinding.Handler(Event, INPUT_AXIS_MOUSE_Y, Event->motion.yrel);
-            }
+    const I32 AxisDeltas[INPUT_AXIS_COUNT] = {[INPUT_AXIS_MOUSE_X] = InputPending.MouseDeltaX, [INPUT_AXIS_MOUSE_Y] = InputPending.MouseDeltaY};
+    for (U32 Axis = 0; Axis < INPUT_AXIS_COUNT; Axis++) {
+        for (U32 Binding = InputAxisBindings[Axis]; Binding != InvalidId; Binding = InputBindings[Binding].Next) {
+            InputPending.Actions[InputBindings[Binding].Action] += InputBindings[Binding].Scale * (F32)AxisDeltas[Axis];
         }
     }
+
+    // The timestamps of this snapshot stay valid until the next one is built.
+    FVector(U64) Timestamps = InputSnapshotTimestamps;
+    InputSnapshotTimestamps = InputPendingTimestamps;
+    InputPendingTimestamps = Timestamps;
+    FVector_Clear(InputPendingTimestamps);
+    InputPending.EventTimestamps = InputSnapshotTimestamps;
+
+    *OutSnapshot = InputPending;
+
+    // Key states carry over, edges and motion start over.
+    InputPending.Step++;
+    SDL_memset(InputPending.Pressed, 0, sizeof InputPending.Pressed);
+    SDL_memset(InputPending.Released, 0, sizeof InputPending.Released);
+    InputPending.MouseDeltaX = 0;
+    InputPending.MouseDeltaY = 0;
+    InputPending.ActionsPressed = 0;
+    InputPending.ActionsReleased = 0;
+    InputPending.EventCount = 0;
 }
 #pragma endregion
 
 #pragma region Private Function Definitions
-void DefaultInputHandler(const SDL_Event* Event) {
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Input Action: %x: %d", Event->key.keysym.sym, Event->type == SDL_KEYDOWN ? 1 : 0);
+void Input_PushEvent(const FInputEvent Event) {
+    // Recorded before motion is merged, the replay merges it the same way.
+    if (InputRecorder != NULL) {
+        static const EReplayRecordType RecordTypes[] = {
+            [INPUT_EVENT_KEY_DOWN] = REPLAY_RECORD_KEY_DOWN, [INPUT_EVENT_KEY_UP] = REPLAY_RECORD_KEY_UP, [INPUT_EVENT_MOUSE_MOTION] = REPLAY_RECORD_MOUSE_MOTION};
+        const FReplayRecord Record = {RecordTypes[Event.Type], Event.Timestamp, Event.Key, Event.X, Event.Y, 0};
+        if (!Replay_Write(InputRecorder, &Record)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to record input, recording stopped.");
+            InputRecorder = NULL;
+        }
+    }
+
+    if (Event.Type == INPUT_EVENT_MOUSE_MOTION && InputEventCount > 0) {
+        FInputEvent* Last = &InputEvents[(InputEventHead + InputEventCount - 1) & (INPUT_EVENT_CAPACITY - 1)];
+        if (Last->Type == INPUT_EVENT_MOUSE_MOTION) {
+            // The merged event keeps the time of the first motion, its latency is the one of the oldest motion.
+            Last->X += Event.X;
+            Last->Y += Event.Y;
+            return;
+        }
+    }
+
+    if (InputEventCount == INPUT_EVENT_CAPACITY) {
+        Input_ApplyEvent(&InputEvents[InputEventHead]);
+        InputEventHead = (InputEventHead + 1) & (INPUT_EVENT_CAPACITY - 1);
+        InputEventCount--;
+    }
+
+    InputEvents[(InputEventHead + InputEventCount) & (INPUT_EVENT_CAPACITY - 1)] = Event;
+    InputEventCount++;
 }
 
-void DefaultAxisHandler(const SDL_Event* Event, const EInputAxis Axis, const I32 Value) {
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Input Axis: %x: %d", Axis, Value);
+void Input_ApplyEvent(const FInputEvent* Event) {
+    if (FVector_GetSize(InputPendingTimestamps) == FVector_GetCapacity(InputPendingTimestamps)) {
+        const size_t Capacity = FVector_GetCapacity(InputPendingTimestamps) * 2 + 64;
+        FVector_Reserve(InputPendingTimestamps, Capacity);
+    }
+    FVector_Add(InputPendingTimestamps, Event->Timestamp);
+    InputPending.EventCount++;
+
+    if (Event->Type == INPUT_EVENT_MOUSE_MOTION) {
+        InputPending.MouseDeltaX += Event->X;
+        InputPending.MouseDeltaY += Event->Y;
+        return;
+    }
+
+    const U32 Key = Event->Key;
+    const U64 Bit = 1ull << (Key % 64);
+    const Bool bDown = Event->Type == INPUT_EVENT_KEY_DOWN;
+
+    // Focus changes can drop the matching event, a key is only pressed or released once.
+    if (((InputPending.Down[Key / 64] & Bit) != 0) == bDown) {
+        return;
+    }
+
+    if (bDown) {
+        InputPending.Down[Key / 64] |= Bit;
+        InputPending.Pressed[Key / 64] |= Bit;
+    } else {
+        InputPending.Down[Key / 64] &= ~Bit;
+        InputPending.Released[Key / 64] |= Bit;
+    }
+
+    for (U32 Binding = InputKeyBindings[Key]; Binding != InvalidId; Binding = InputBindings[Binding].Next) {
+        const FInputBinding* Item = &InputBindings[Binding];
+        if (bDown) {
+            InputKeyActions[Item->Action] += Item->Scale;
+            InputPending.ActionsPressed |= 1u << Item->Action;
+        } else {
+            InputKeyActions[Item->Action] -= Item->Scale;
+            InputPending.ActionsReleased |= 1u << Item->Action;
+        }
+    }
 }
 
-void DefaultApplicationExitHandler(const SDL_Event* Event) {
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Requested application exit.");
-    Application_RequestShutdown();
+void Input_AddBinding(U32* First, const EInputAction Action, const F32 Scale) {
+    if (FVector_GetSize(InputBindings) == FVector_GetCapacity(InputBindings)) {
+        const size_t Capacity = FVector_GetCapacity(InputBindings) * 2 + 64;
+        FVector_Reserve(InputBindings, Capacity);
+    }
+
+    const FInputBinding Binding = {Action, Scale, *First};
+    *First = (U32)FVector_GetSize(InputBindings);
+    FVector_Add(InputBindings, Binding);
 }
 #pragma endregion
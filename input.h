@@ -1,35 +1,106 @@
 #pragma once
 #include <SDL_events.h>
-#include <SDL_keycode.h>
+#include <SDL_scancode.h>
+#include "replay.h"
 #include "typedefs.h"
 
+/** Mouse buttons follow the scancodes in the key index, SDL numbers them from 1. */
+#define INPUT_MOUSE_BUTTON_COUNT 8
+#define INPUT_KEY_COUNT (SDL_NUM_SCANCODES + INPUT_MOUSE_BUTTON_COUNT)
+#define INPUT_KEY_WORDS ((INPUT_KEY_COUNT + 63) / 64)
+
+/** Gameplay actions, keys and mouse axes are bound to them. */
+typedef enum {
+    INPUT_ACTION_EXIT = 0,
+    INPUT_ACTION_MOVE_FORWARD,
+    INPUT_ACTION_MOVE_RIGHT,
+    INPUT_ACTION_MOVE_UP,
+    INPUT_ACTION_LOOK_YAW,
+    INPUT_ACTION_LOOK_PITCH,
+    INPUT_ACTION_PRIMARY,
+    INPUT_ACTION_SECONDARY,
+    INPUT_ACTION_TOGGLE_OVERLAY,
+    INPUT_ACTION_COUNT
+} EInputAction;
+
 /** Input axis types. */
 typedef enum {
     INPUT_AXIS_UNKNOWN = 0,
     INPUT_AXIS_MOUSE_X,
     INPUT_AXIS_MOUSE_Y,
+    INPUT_AXIS_COUNT
 } EInputAxis;
 
-/** Input action handler. */
-typedef void (*InputActionHandler)(const SDL_Event* Event);
-
-/** Input axis handler. */
-typedef void (*InputAxisHandler)(const SDL_Event* Event, EInputAxis Axis, I32 Value);
-
-/** Input action binding. */
+/**
+ * Input of one simulation step, built from the events received up to its timestamp. Pressed and released keep the
+ * edges of keys tapped within the step, while down only has the state at its end.
+ */
 typedef struct {
-    SDL_Keycode Keycode;
-    InputActionHandler Handler;
-} FInputActionBinding;
-
-/** Input axis binding. */
-typedef struct {
-    EInputAxis Axis;
-    InputAxisHandler Handler;
-} FInputAxisBinding;
+    U64 Step;
+    U64 Timestamp;
+    U64 Down[INPUT_KEY_WORDS];
+    U64 Pressed[INPUT_KEY_WORDS];
+    U64 Released[INPUT_KEY_WORDS];
+    /** Relative mouse motion accumulated over the step. */
+    I32 MouseDeltaX;
+    I32 MouseDeltaY;
+    /** Sum of the scales of the bound keys down and of the bound axes times their motion. */
+    F32 Actions[INPUT_ACTION_COUNT];
+    /** Bits of the actions with a bound key pressed or released within the step. */
+    U32 ActionsPressed;
+    U32 ActionsReleased;
+    /** Events received within the step, mouse motion between other events counts once. */
+    U32 EventCount;
+    /** Times the events were received, valid until the next snapshot is built. */
+    const U64* EventTimestamps;
+} FInputSnapshot;
 
 /** Initializes the input service. Configures key and mouse bindings. */
 void Input_Initialize();
 
-/** Processes key events received from the SDL. */
+/** Frees the bindings and the queued events. */
+void Input_Shutdown();
+
+/** Returns the key index of a mouse button. */
+U32 Input_GetMouseButtonKey(U8 Button);
+
+/** Binds a scancode or a mouse button key to an action, adding its scale to the action value while down. Keys take any number of bindings. */
+void Input_BindKey(U32 Key, EInputAction Action, F32 Scale);
+
+/** Binds a mouse axis to an action, adding its motion times the scale to the action value of each step. */
+void Input_BindAxis(EInputAxis Axis, EInputAction Action, F32 Scale);
+
+/** Queues key, mouse button and mouse motion events received from the SDL with the time they were received. */
 void Input_HandleEvent(const SDL_Event* Event);
+
+/** Records the queued events to the log from now on, NULL stops recording. */
+void Input_SetRecorder(FReplay* Replay);
+
+/** Makes the SDL event of an event record, for Input_HandleEvent. Returns False for the other records. */
+Bool Input_GetReplayEvent(const FReplayRecord* Record, SDL_Event* OutEvent);
+
+/**
+ * Builds the snapshot of the next simulation step from the events received up to the timestamp, later events are left
+ * for the next step.
+ */
+void Input_BuildSnapshot(U64 Timestamp, FInputSnapshot* OutSnapshot);
+
+static inline Bool Input_IsKeyDown(const FInputSnapshot* Snapshot, const U32 Key) {
+    return (Snapshot->Down[Key / 64] >> (Key % 64) & 1) != 0;
+}
+
+static inline Bool Input_IsKeyPressed(const FInputSnapshot* Snapshot, const U32 Key) {
+    return (Snapshot->Pressed[Key / 64] >> (Key % 64) & 1) != 0;
+}
+
+static inline Bool Input_IsKeyReleased(const FInputSnapshot* Snapshot, const U32 Key) {
+    return (Snapshot->Released[Key / 64] >> (Key % 64) & 1) != 0;
+}
+
+static inline Bool Input_IsActionPressed(const FInputSnapshot* Snapshot, const EInputAction Action) {
+    return (Snapshot->ActionsPressed >> Action & 1) != 0;
+}
+
+static inline Bool Input_IsActionReleased(const FInputSnapshot* Snapshot, const EInputAction Action) {
+    return (Snapshot->ActionsReleased >> Action & 1) != 0;
+}
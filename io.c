@@ -0,0 +1,1219 @@
+#define _GNU_SOURCE
+
+#include "io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pack.h"
+#include "thread.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#define IO_URING_SUPPORTED 1
+#else
+#define IO_URING_SUPPORTED 0
+#endif
+
+#pragma region Settings
+/** Maximum number of worker threads of the threads backend. */
+#define IO_MAX_WORKERS 4
+/** Number of reads submitted to io_uring at once. */
+#define IO_URING_DEPTH 64
+/** Pooled buffer size classes, powers of two from 4 KiB to 64 MiB. */
+#define IO_POOL_MIN_CLASS 12
+#define IO_POOL_CLASS_COUNT 15
+/** Free buffers kept per size class. */
+#define IO_POOL_MAX_FREE 8
+/** Pooled buffer header size, keeps the data 16-byte aligned. */
+#define IO_POOL_HEADER_SIZE 16
+#pragma endregion
+
+/** Read request slot. */
+typedef struct {
+    U32 Generation;
+    EIoStatus Status;
+    EIoPriority Priority;
+    char* Path;
+    U64 Offset;
+    U64 Length;
+    U8* Buffer;
+    U64 BufferSize;
+    Bool bPooled;
+    Bool bCancelled;
+    IoCompletionHandler Handler;
+    void* UserData;
+    /** Next request in the queue, completion or free list. */
+    U32 Next;
+    /** Slot of the request performing the read for this one, InvalidId for leaders. */
+    U32 Leader;
+    /** First follower for leaders, next follower for followers. */
+    U32 Follower;
+    /** Read result. */
+    U8* Data;
+    U64 ResultLength;
+    /** io_uring read state. */
+    int FileDescriptor;
+    U64 BytesDone;
+    U64 ReadLength;
+    /** Entry of the mounted pack read by the io threads, NULL for files. */
+    const FPack* Pack;
+    const FPackEntry* PackEntry;
+} FIoRequest;
+
+/** Intrusive request list. */
+typedef struct {
+    U32 Head;
+    U32 Tail;
+} FIoList;
+
+/** Pooled buffer header stored in front of the data. */
+typedef struct {
+    U64 Capacity;
+    U32 References;
+    U32 Class;
+} FIoBufferHeader;
+
+#pragma region Private Variables
+static Bool bInitialized = False;
+static Bool bShutdownRequested = False;
+static EIoBackend Backend;
+
+static FMutex* Mutex;
+/** Signalled when requests are queued or the service shuts down. */
+static FCondition* WorkCondition;
+/** Signalled when requests finish. */
+static FCondition* DoneCondition;
+
+static FIoRequest Requests[IO_MAX_REQUESTS];
+static FIoList Queues[IO_PRIORITY_COUNT];
+static FIoList CompletedList;
+static U32 FreeHead;
+
+static FThread* Workers[IO_MAX_WORKERS];
+static U32 WorkerCount;
+
+static U8* FreeBuffers[IO_POOL_CLASS_COUNT][IO_POOL_MAX_FREE];
+static U32 FreeBufferCounts[IO_POOL_CLASS_COUNT];
+
+static FIoStats Stats;
+
+/** Archive whose entries are served from memory instead of the disk. */
+static const FPack* MountedPack;
+
+#if IO_URING_SUPPORTED
+/** io_uring instance and its mapped rings. */
+static struct {
+    int FileDescriptor;
+    void* SqRing;
+    void* CqRing;
+    size_t SqRingSize;
+    size_t CqRingSize;
+    struct io_uring_sqe* Sqes;
+    size_t SqesSize;
+    U32* SqHead;
+    U32* SqTail;
+    U32* SqMask;
+    U32* SqArray;
+    U32* CqHead;
+    U32* CqTail;
+    U32* CqMask;
+    struct io_uring_cqe* Cqes;
+} Ring;
+#endif
+#pragma endregion
+
+#pragma region Private Function Declarations
+static FIoRequest* Io_GetRequest(U32 Id);
+static U32 Io_GetId(U32 Slot);
+
+static void Io_ListPush(FIoList* List, U32 Slot);
+static U32 Io_ListPop(FIoList* List);
+static Bool Io_ListRemove(FIoList* List, U32 Slot);
+
+/** Pops the highest priority queued request, InvalidId if none. Called with the mutex locked. */
+static U32 Io_PopQueued();
+
+/** Finishes the request and its followers. Called with the mutex locked. */
+static void Io_Finish(U32 Slot, EIoStatus Status, U64 Length);
+
+/** Moves a finished request to the completion list or wakes pollers. Called with the mutex locked. */
+static void Io_Publish(U32 Slot);
+
+/** Returns the slot to the free list. Called with the mutex locked. */
+static void Io_FreeSlot(U32 Slot);
+
+/** Pooled buffer management. Called with the mutex locked. */
+static U8* Io_AcquireBuffer(U64 Size);
+static void Io_ReleaseBuffer(U8* Data);
+
+/** Gets the destination buffer for the read length. Called with the mutex locked. */
+static U8* Io_PrepareBuffer(FIoRequest* Request, U64 ReadLength);
+
+/** Serves the request as a view of a stored entry of the mounted pack. Called with the mutex locked. */
+static void Io_ReadPack(U32 Slot, const FPackEntry* Entry);
+
+/** Copies or decompresses a pack entry on an io thread. */
+static EIoStatus Io_ReadPackBlocking(U32 Slot, U64* OutLength);
+
+/** Blocking read of a request on a worker thread. */
+static EIoStatus Io_ReadBlocking(U32 Slot, U64* OutLength);
+
+static int Io_WorkerMain(void* UserData);
+
+#if IO_URING_SUPPORTED
+static Bool Io_UringInitialize();
+static void Io_UringShutdown();
+static int Io_UringMain(void* UserData);
+static Bool Io_UringStart(U32 Slot);
+static void Io_UringSubmitRead(U32 Slot);
+/** Closes a ring that stopped working, fails its reads and starts worker threads for the queue. */
+static void Io_UringAbandon();
+#endif
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Io_Initialize(const EIoBackend PreferredBackend) {
+    if (bInitialized) {
+        return bInitialized;
+    }
+
+    Mutex = Mutex_Create();
+    WorkCondition = Condition_Create();
+    DoneCondition = Condition_Create();
+    if (Mutex == NULL || WorkCondition == NULL || DoneCondition == NULL) {
+        fprintf(stderr, "Failed to create io service synchronization primitives\n");
+        return False;
+    }
+
+    memset(Requests, 0, sizeof Requests);
+    memset(&Stats, 0, sizeof Stats);
+    for (U32 Slot = 0; Slot < IO_MAX_REQUESTS; Slot++) {
+        Requests[Slot].Generation = 1;
+        Requests[Slot].Next = Slot + 1 < IO_MAX_REQUESTS ? Slot + 1 : InvalidId;
+    }
+    FreeHead = 0;
+
+    for (U32 Priority = 0; Priority < IO_PRIORITY_COUNT; Priority++) {
+        Queues[Priority] = (FIoList){InvalidId, InvalidId};
+    }
+    CompletedList = (FIoList){InvalidId, InvalidId};
+
+    bShutdownRequested = False;
+    Backend = IO_BACKEND_THREADS;
+
+#if IO_URING_SUPPORTED
+    if (PreferredBackend != IO_BACKEND_THREADS && Io_UringInitialize()) {
+        Backend = IO_BACKEND_URING;
+        Workers[0] = Thread_Create(Io_UringMain, "IoUring", NULL);
+        WorkerCount = Workers[0] != NULL ? 1 : 0;
+        if (WorkerCount == 0) {
+            Io_UringShutdown();
+            Backend = IO_BACKEND_THREADS;
+        }
+    }
+#endif
+
+    if (Backend == IO_BACKEND_THREADS) {
+        const U32 ProcessorCount = Thread_GetProcessorCount();
+        const U32 Count = ProcessorCount < IO_MAX_WORKERS ? ProcessorCount : IO_MAX_WORKERS;
+
+        WorkerCount = 0;
+        for (U32 Index = 0; Index < Count; Index++) {
+            Workers[WorkerCount] = Thread_Create(Io_WorkerMain, "IoWorker", NULL);
+            if (Workers[WorkerCount] != NULL) {
+                WorkerCount++;
+            }
+        }
+    }
+
+    if (WorkerCount == 0) {
+        fprintf(stderr, "Failed to start io service threads\n");
+        return False;
+    }
+
+    bInitialized = True;
+
+    return bInitialized;
+}
+
+void Io_Shutdown() {
+    if (!bInitialized) {
+        return;
+    }
+
+    Mutex_Lock(Mutex);
+    bShutdownRequested = True;
+
+    // Queued requests are never started.
+    U32 Slot;
+    while ((Slot = Io_PopQueued()) != InvalidId) {
+        Requests[Slot].bCancelled = True;
+        Io_Finish(Slot, IO_STATUS_CANCELLED, 0);
+    }
+
+    Condition_Broadcast(WorkCondition);
+    Mutex_Unlock(Mutex);
+
+    // Workers finish reads in flight before they exit.
+    for (U32 Index = 0; Index < WorkerCount; Index++) {
+        Thread_Join(Workers[Index]);
+        Workers[Index] = NULL;
+    }
+    WorkerCount = 0;
+
+#if IO_URING_SUPPORTED
+    if (Backend == IO_BACKEND_URING) {
+        Io_UringShutdown();
+    }
+#endif
+
+    for (Slot = 0; Slot < IO_MAX_REQUESTS; Slot++) {
+        FIoRequest* Request = &Requests[Slot];
+        if (Request->Status != IO_STATUS_INVALID) {
+            if (Request->bPooled && Request->Data != NULL) {
+                Io_ReleaseBuffer(Request->Data);
+            }
+            free(Request->Path);
+        }
+    }
+
+    for (U32 Class = 0; Class < IO_POOL_CLASS_COUNT; Class++) {
+        for (U32 Index = 0; Index < FreeBufferCounts[Class]; Index++) {
+            free(FreeBuffers[Class][Index]);
+        }
+        FreeBufferCounts[Class] = 0;
+    }
+
+    Condition_Destroy(DoneCondition);
+    Condition_Destroy(WorkCondition);
+    Mutex_Destroy(Mutex);
+
+    bInitialized = False;
+}
+
+EIoBackend Io_GetBackend() {
+    return Backend;
+}
+
+U32 Io_Read(const FIoReadRequest* ReadRequest) {
+    if (!bInitialized || ReadRequest == NULL || ReadRequest->Path == NULL) {
+        return InvalidId;
+    }
+
+    if (ReadRequest->Buffer != NULL && ReadRequest->Length > ReadRequest->BufferSize) {
+        fprintf(stderr, "Io read of %s doesn't fit the buffer\n", ReadRequest->Path);
+        return InvalidId;
+    }
+
+    const size_t PathLength = strlen(ReadRequest->Path);
+    char* Path = malloc(PathLength + 1);
+    if (Path == NULL) {
+        return InvalidId;
+    }
+    memcpy(Path, ReadRequest->Path, PathLength + 1);
+
+    const EIoPriority Priority = ReadRequest->Priority < IO_PRIORITY_COUNT ? ReadRequest->Priority : IO_PRIORITY_CRITICAL;
+
+    Mutex_Lock(Mutex);
+
+    if (bShutdownRequested || FreeHead == InvalidId) {
+        Mutex_Unlock(Mutex);
+        free(Path);
+        return InvalidId;
+    }
+
+    const U32 Slot = FreeHead;
+    FIoRequest* Request = &Requests[Slot];
+    FreeHead = Request->Next;
+
+    Request->Status = IO_STATUS_QUEUED;
+    Request->Priority = Priority;
+    Request->Path = Path;
+    Request->Offset = ReadRequest->Offset;
+    Request->Length = ReadRequest->Length;
+    Request->Buffer = ReadRequest->Buffer;
+    Request->BufferSize = ReadRequest->BufferSize;
+    Request->bPooled = ReadRequest->Buffer == NULL;
+    Request->bCancelled = False;
+    Request->Handler = ReadRequest->Handler;
+    Request->UserData = ReadRequest->UserData;
+    Request->Next = InvalidId;
+    Request->Leader = InvalidId;
+    Request->Follower = InvalidId;
+    Request->Data = NULL;
+    Request->ResultLength = 0;
+    Request->FileDescriptor = -1;
+    Request->BytesDone = 0;
+    Request->ReadLength = 0;
+
+    // Stored entries of the mounted pack are handed out as views right away. Copies and decompression are queued like file reads.
+    const FPackEntry* PackEntry = MountedPack != NULL ? Pack_FindEntry(MountedPack, Request->Path) : NULL;
+    Request->Pack = PackEntry != NULL ? MountedPack : NULL;
+    Request->PackEntry = PackEntry;
+    if (PackEntry != NULL) {
+        Stats.PackReads++;
+    }
+
+    if (PackEntry != NULL && PackEntry->Compression == PACK_COMPRESSION_NONE && Request->bPooled) {
+        Io_ReadPack(Slot, PackEntry);
+
+        const U32 Id = Io_GetId(Slot);
+        Mutex_Unlock(Mutex);
+
+        return Id;
+    }
+
+    // Coalesce with a pending pooled read of the same range.
+    U32 LeaderSlot = InvalidId;
+    if (Request->bPooled) {
+        for (U32 Index = 0; Index < IO_MAX_REQUESTS; Index++) {
+            const FIoRequest* Candidate = &Requests[Index];
+            if (Index != Slot && Candidate->Leader == InvalidId && Candidate->bPooled && !Candidate->bCancelled &&
+                (Candidate->Status == IO_STATUS_QUEUED || Candidate->Status == IO_STATUS_IN_FLIGHT) && Candidate->Offset == Request->Offset &&
+                Candidate->Length == Request->Length && strcmp(Candidate->Path, Request->Path) == 0) {
+                LeaderSlot = Index;
+                break;
+            }
+        }
+    }
+
+    if (LeaderSlot != InvalidId) {
+        FIoRequest* Leader = &Requests[LeaderSlot];
+        Request->Status = Leader->Status;
+        Request->Leader = LeaderSlot;
+        Request->Follower = Leader->Follower;
+        Leader->Follower = Slot;
+        Stats.Coalesced++;
+
+        // The shared read inherits the most urgent priority.
+        if (Leader->Status == IO_STATUS_QUEUED && Priority > Leader->Priority) {
+            Io_ListRemove(&Queues[Leader->Priority], LeaderSlot);
+            Leader->Priority = Priority;
+            Io_ListPush(&Queues[Priority], LeaderSlot);
+        }
+    } else {
+        Io_ListPush(&Queues[Priority], Slot);
+        Stats.Queued++;
+        Condition_Signal(WorkCondition);
+    }
+
+    const U32 Id = Io_GetId(Slot);
+    Mutex_Unlock(Mutex);
+
+    return Id;
+}
+
+Bool Io_Cancel(const U32 Id) {
+    if (!bInitialized) {
+        return False;
+    }
+
+    Mutex_Lock(Mutex);
+
+    FIoRequest* Request = Io_GetRequest(Id);
+    if (Request == NULL || Request->bCancelled || (Request->Status != IO_STATUS_QUEUED && Request->Status != IO_STATUS_IN_FLIGHT)) {
+        Mutex_Unlock(Mutex);
+        return False;
+    }
+
+    const U32 Slot = Id % IO_MAX_REQUESTS;
+    Request->bCancelled = True;
+
+    U32 LeaderSlot = Slot;
+    if (Request->Leader != InvalidId) {
+        // Followers leave the shared read right away.
+        LeaderSlot = Request->Leader;
+        FIoRequest* Leader = &Requests[LeaderSlot];
+        U32* Link = &Leader->Follower;
+        while (*Link != InvalidId && *Link != Slot) {
+            Link = &Requests[*Link].Follower;
+        }
+        if (*Link == Slot) {
+            *Link = Request->Follower;
+        }
+
+        Request->Leader = InvalidId;
+        Request->Follower = InvalidId;
+        Request->Status = IO_STATUS_CANCELLED;
+        Stats.Cancelled++;
+        Io_Publish(Slot);
+        Condition_Broadcast(DoneCondition);
+    }
+
+    // A queued read nobody waits for anymore is dropped.
+    FIoRequest* Leader = &Requests[LeaderSlot];
+    if (Leader->Status == IO_STATUS_QUEUED && Leader->bCancelled && Leader->Follower == InvalidId) {
+        Io_ListRemove(&Queues[Leader->Priority], LeaderSlot);
+        Stats.Queued--;
+        Io_Finish(LeaderSlot, IO_STATUS_CANCELLED, 0);
+    }
+
+    Mutex_Unlock(Mutex);
+
+    return True;
+}
+
+EIoStatus Io_GetResult(const U32 Id, FIoResult* OutResult) {
+    if (!bInitialized) {
+        return IO_STATUS_INVALID;
+    }
+
+    Mutex_Lock(Mutex);
+
+    const FIoRequest* Request = Io_GetRequest(Id);
+    if (Request == NULL) {
+        Mutex_Unlock(Mutex);
+        return IO_STATUS_INVALID;
+    }
+
+    const EIoStatus Status = Request->Status;
+    if (OutResult != NULL) {
+        OutResult->Id = Id;
+        OutResult->Status = Status;
+        OutResult->Path = Request->Path;
+        OutResult->Data = Request->Data;
+        OutResult->Length = Request->ResultLength;
+        OutResult->UserData = Request->UserData;
+    }
+
+    Mutex_Unlock(Mutex);
+
+    return Status;
+}
+
+EIoStatus Io_Wait(const U32 Id, FIoResult* OutResult) {
+    if (!bInitialized) {
+        return IO_STATUS_INVALID;
+    }
+
+    Mutex_Lock(Mutex);
+
+    const FIoRequest* Request;
+    while ((Request = Io_GetRequest(Id)) != NULL && (Request->Status == IO_STATUS_QUEUED || Request->Status == IO_STATUS_IN_FLIGHT)) {
+        Condition_Wait(DoneCondition, Mutex);
+    }
+
+    Mutex_Unlock(Mutex);
+
+    return Io_GetResult(Id, OutResult);
+}
+
+void Io_Release(const U32 Id) {
+    if (!bInitialized) {
+        return;
+    }
+
+    Mutex_Lock(Mutex);
+
+    FIoRequest* Request = Io_GetRequest(Id);
+    if (Request != NULL && Request->Status != IO_STATUS_QUEUED && Request->Status != IO_STATUS_IN_FLIGHT) {
+        Io_FreeSlot(Id % IO_MAX_REQUESTS);
+    }
+
+    Mutex_Unlock(Mutex);
+}
+
+U32 Io_Update(const U32 MaxCompletions) {
+    if (!bInitialized) {
+        return 0;
+    }
+
+    U32 Count = 0;
+    while (MaxCompletions == 0 || Count < MaxCompletions) {
+        Mutex_Lock(Mutex);
+        const U32 Slot = Io_ListPop(&CompletedList);
+        if (Slot == InvalidId) {
+            Mutex_Unlock(Mutex);
+            break;
+        }
+
+        const FIoRequest* Request = &Requests[Slot];
+        const U32 Id = Io_GetId(Slot);
+        const IoCompletionHandler Handler = Request->Handler;
+        const FIoResult Result = {Id, Request->Status, Request->Path, Request->Data, Request->ResultLength, Request->UserData};
+        Mutex_Unlock(Mutex);
+
+        // The handler runs unlocked so it may queue new reads.
+        if (!Handler(&Result)) {
+            Io_Release(Id);
+        }
+
+        Count++;
+    }
+
+    return Count;
+}
+
+void Io_MountPack(const FPack* Pack) {
+    if (!bInitialized) {
+        return;
+    }
+
+    Mutex_Lock(Mutex);
+    MountedPack = Pack;
+    Mutex_Unlock(Mutex);
+}
+
+FIoStats Io_GetStats() {
+    if (!bInitialized) {
+        return (FIoStats){0};
+    }
+
+    Mutex_Lock(Mutex);
+    const FIoStats Result = Stats;
+    Mutex_Unlock(Mutex);
+
+    return Result;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+FIoRequest* Io_GetRequest(const U32 Id) {
+    if (Id == InvalidId) {
+        return NULL;
+    }
+
+    FIoRequest* Request = &Requests[Id % IO_MAX_REQUESTS];
+    if (Request->Status == IO_STATUS_INVALID || Request->Generation != Id / IO_MAX_REQUESTS) {
+        return NULL;
+    }
+
+    return Request;
+}
+
+U32 Io_GetId(const U32 Slot) {
+    return Requests[Slot].Generation * IO_MAX_REQUESTS + Slot;
+}
+
+void Io_ListPush(FIoList* List, const U32 Slot) {
+    Requests[Slot].Next = InvalidId;
+    if (List->Tail == InvalidId) {
+        List->Head = Slot;
+    } else {
+        Requests[List->Tail].Next = Slot;
+    }
+    List->Tail = Slot;
+}
+
+U32 Io_ListPop(FIoList* List) {
+    const U32 Slot = List->Head;
+    if (Slot != InvalidId) {
+        List->Head = Requests[Slot].Next;
+        if (List->Head == InvalidId) {
+            List->Tail = InvalidId;
+        }
+        Requests[Slot].Next = InvalidId;
+    }
+
+    return Slot;
+}
+
+Bool Io_ListRemove(FIoList* List, const U32 Slot) {
+    U32 Previous = InvalidId;
+    for (U32 Current = List->Head; Current != InvalidId; Previous = Current, Current = Requests[Current].Next) {
+        if (Current != Slot) {
+            continue;
+        }
+
+        if (Previous == InvalidId) {
+            List->Head = Requests[Current].Next;
+        } else {
+            Requests[Previous].Next = Requests[Current].Next;
+        }
+        if (List->Tail == Current) {
+            List->Tail = Previous;
+        }
+        Requests[Current].Next = InvalidId;
+
+        return True;
+    }
+
+    return False;
+}
+
+U32 Io_PopQueued() {
+    for (I32 Priority = IO_PRIORITY_COUNT - 1; Priority >= 0; Priority--) {
+        const U32 Slot = Io_ListPop(&Queues[Priority]);
+        if (Slot != InvalidId) {
+            Stats.Queued--;
+            return Slot;
+        }
+    }
+
+    return InvalidId;
+}
+
+void Io_Finish(const U32 Slot, const EIoStatus Status, const U64 Length) {
+    FIoRequest* Leader = &Requests[Slot];
+    U8* Data = Leader->Data;
+
+    // Count everyone sharing the pooled buffer before handing it out.
+    U32 References = 0;
+    if (Status == IO_STATUS_COMPLETED) {
+        References += !Leader->bCancelled;
+        for (U32 Follower = Leader->Follower; Follower != InvalidId; Follower = Requests[Follower].Follower) {
+            References++;
+        }
+        Stats.BytesRead += Length;
+    }
+
+    if (Leader->bPooled && Data != NULL) {
+        FIoBufferHeader* Header = (FIoBufferHeader*)(Data - IO_POOL_HEADER_SIZE);
+        Header->References = References;
+        if (References == 0) {
+            Io_ReleaseBuffer(Data);
+            Data = NULL;
+        }
+    }
+
+    if (Status != IO_STATUS_COMPLETED) {
+        Data = Leader->bPooled ? NULL : Leader->Data;
+    }
+
+    U32 Current = Slot;
+    while (Current != InvalidId) {
+        FIoRequest* Request = &Requests[Current];
+        const U32 Next = Request->Follower;
+
+        Request->Status = Request->bCancelled ? IO_STATUS_CANCELLED : Status;
+        Request->Data = Request->Status == IO_STATUS_COMPLETED ? Data : NULL;
+        Request->ResultLength = Request->Status == IO_STATUS_COMPLETED ? Length : 0;
+        Request->Leader = InvalidId;
+        Request->Follower = InvalidId;
+
+        switch (Request->Status) {
+        case IO_STATUS_COMPLETED:
+            Stats.Completed++;
+            break;
+        case IO_STATUS_FAILED:
+            Stats.Failed++;
+            break;
+        default:
+            Stats.Cancelled++;
+            break;
+        }
+
+        Io_Publish(Current);
+        Current = Next;
+    }
+
+    Condition_Broadcast(DoneCondition);
+}
+
+void Io_Publish(const U32 Slot) {
+    if (Requests[Slot].Handler != NULL) {
+        Io_ListPush(&CompletedList, Slot);
+    }
+}
+
+void Io_FreeSlot(const U32 Slot) {
+    FIoRequest* Request = &Requests[Slot];
+
+    if (Request->bPooled && Request->Data != NULL) {
+        Io_ReleaseBuffer(Request->Data);
+    }
+    free(Request->Path);
+
+    Request->Path = NULL;
+    Request->Data = NULL;
+    Request->Status = IO_STATUS_INVALID;
+    Request->Generation++;
+    if (Request->Generation >= InvalidId / IO_MAX_REQUESTS) {
+        Request->Generation = 1;
+    }
+
+    Request->Next = FreeHead;
+    FreeHead = Slot;
+}
+
+U8* Io_AcquireBuffer(const U64 Size) {
+    // One extra byte keeps pooled data null-terminated.
+    const U64 Required = Size + 1;
+
+    U32 Class = 0;
+    while (Class < IO_POOL_CLASS_COUNT && ((U64)1 << (IO_POOL_MIN_CLASS + Class)) < Required) {
+        Class++;
+    }
+
+    U8* Memory;
+    U64 Capacity;
+    if (Class < IO_POOL_CLASS_COUNT && FreeBufferCounts[Class] > 0) {
+        Memory = FreeBuffers[Class][--FreeBufferCounts[Class]];
+        Capacity = (U64)1 << (IO_POOL_MIN_CLASS + Class);
+    } else {
+        Capacity = Class < IO_POOL_CLASS_COUNT ? (U64)1 << (IO_POOL_MIN_CLASS + Class) : Required;
+        Memory = malloc(IO_POOL_HEADER_SIZE + Capacity);
+        if (Memory == NULL) {
+            return NULL;
+        }
+    }
+
+    FIoBufferHeader* Header = (FIoBufferHeader*)Memory;
+    Header->Capacity = Capacity;
+    Header->References = 1;
+    Header->Class = Class;
+
+    return Memory + IO_POOL_HEADER_SIZE;
+}
+
+void Io_ReleaseBuffer(U8* Data) {
+    U8* Memory = Data - IO_POOL_HEADER_SIZE;
+    FIoBufferHeader* Header = (FIoBufferHeader*)Memory;
+
+    if (Header->References > 1) {
+        Header->References--;
+        return;
+    }
+
+    if (Header->Class < IO_POOL_CLASS_COUNT && FreeBufferCounts[Header->Class] < IO_POOL_MAX_FREE) {
+        FreeBuffers[Header->Class][FreeBufferCounts[Header->Class]++] = Memory;
+    } else {
+        free(Memory);
+    }
+}
+
+U8* Io_PrepareBuffer(FIoRequest* Request, const U64 ReadLength) {
+    if (!Request->bPooled) {
+        return ReadLength <= Request->BufferSize ? Request->Buffer : NULL;
+    }
+
+    U8* Data = Io_AcquireBuffer(ReadLength);
+    if (Data != NULL) {
+        Data[ReadLength] = '\0';
+    }
+
+    return Data;
+}
+
+void Io_ReadPack(const U32 Slot, const FPackEntry* Entry) {
+    FIoRequest* Request = &Requests[Slot];
+    Request->Status = IO_STATUS_IN_FLIGHT;
+
+    if (Request->Offset > Entry->Size) {
+        Io_Finish(Slot, IO_STATUS_FAILED, 0);
+        return;
+    }
+
+    const U64 Available = Entry->Size - Request->Offset;
+    const U64 Length = Request->Length == 0 || Request->Length > Available ? Available : Request->Length;
+
+    // The view of the mapping needs no copy and nothing to release.
+    Request->bPooled = False;
+    Request->Data = (U8*)Pack_GetEntryData(Request->Pack, Entry) + Request->Offset;
+    Io_Finish(Slot, IO_STATUS_COMPLETED, Length);
+}
+
+EIoStatus Io_ReadPackBlocking(const U32 Slot, U64* OutLength) {
+    FIoRequest* Request = &Requests[Slot];
+    const FPackEntry* Entry = Request->PackEntry;
+
+    if (Request->Offset > Entry->Size) {
+        return IO_STATUS_FAILED;
+    }
+
+    const U64 Available = Entry->Size - Request->Offset;
+    const U64 Length = Request->Length == 0 || Request->Length > Available ? Available : Request->Length;
+    const Bool bCompressed = Entry->Compression != PACK_COMPRESSION_NONE;
+
+    // A whole compressed entry is decompressed straight into the destination, parts of it go through a temporary buffer.
+    const Bool bWhole = Request->Offset == 0 && Length == Entry->Size;
+
+    Mutex_Lock(Mutex);
+    U8* Data = Io_PrepareBuffer(Request, Length);
+    Request->Data = Data;
+    U8* Decompressed = bCompressed && !bWhole && Data != NULL ? Io_AcquireBuffer(Entry->Size) : NULL;
+    Mutex_Unlock(Mutex);
+
+    Bool bRead = False;
+    if (Data != NULL && !bCompressed) {
+        memcpy(Data, Pack_GetEntryData(Request->Pack, Entry) + Request->Offset, Length);
+        bRead = True;
+    } else if (Data != NULL && bWhole) {
+        bRead = Pack_ReadEntry(Request->Pack, Entry, Data, Entry->Size);
+    } else if (Decompressed != NULL && Pack_ReadEntry(Request->Pack, Entry, Decompressed, Entry->Size)) {
+        memcpy(Data, Decompressed + Request->Offset, Length);
+        bRead = True;
+    }
+
+    if (Decompressed != NULL) {
+        Mutex_Lock(Mutex);
+        Io_ReleaseBuffer(Decompressed);
+        Mutex_Unlock(Mutex);
+    }
+
+    *OutLength = Length;
+
+    return bRead ? IO_STATUS_COMPLETED : IO_STATUS_FAILED;
+}
+
+EIoStatus Io_ReadBlocking(const U32 Slot, U64* OutLength) {
+    FIoRequest* Request = &Requests[Slot];
+    if (Request->PackEntry != NULL) {
+        return Io_ReadPackBlocking(Slot, OutLength);
+    }
+
+    FILE* pFile = fopen(Request->Path, "rb");
+    if (pFile == NULL) {
+        return IO_STATUS_FAILED;
+    }
+
+#if OS_WINDOWS
+    _fseeki64(pFile, 0, SEEK_END);
+    const I64 FileSize = _ftelli64(pFile);
+    _fseeki64(pFile, (I64)Request->Offset, SEEK_SET);
+#else
+    fseeko(pFile, 0, SEEK_END);
+    const I64 FileSize = ftello(pFile);
+    fseeko(pFile, (off_t)Request->Offset, SEEK_SET);
+#endif
+
+    if (FileSize < 0 || Request->Offset > (U64)FileSize || (Request->Length > 0 && Request->Offset + Request->Length > (U64)FileSize)) {
+        fclose(pFile);
+        return IO_STATUS_FAILED;
+    }
+
+    const U64 ReadLength = Request->Length > 0 ? Request->Length : (U64)FileSize - Request->Offset;
+
+    Mutex_Lock(Mutex);
+    U8* Data = Io_PrepareBuffer(Request, ReadLength);
+    Request->Data = Data;
+    Mutex_Unlock(Mutex);
+
+    if (Data == NULL) {
+        fclose(pFile);
+        return IO_STATUS_FAILED;
+    }
+
+    const U64 BytesRead = fread(Data, 1, (size_t)ReadLength, pFile);
+    fclose(pFile);
+
+    *OutLength = BytesRead;
+
+    return BytesRead == ReadLength ? IO_STATUS_COMPLETED : IO_STATUS_FAILED;
+}
+
+int Io_WorkerMain(void* UserData) {
+    Mutex_Lock(Mutex);
+
+    while (True) {
+        U32 Slot;
+        while (!bShutdownRequested && (Slot = Io_PopQueued()) == InvalidId) {
+            Condition_Wait(WorkCondition, Mutex);
+        }
+
+        if (bShutdownRequested) {
+            break;
+        }
+
+        Requests[Slot].Status = IO_STATUS_IN_FLIGHT;
+        for (U32 Follower = Requests[Slot].Follower; Follower != InvalidId; Follower = Requests[Follower].Follower) {
+            Requests[Follower].Status = IO_STATUS_IN_FLIGHT;
+        }
+        Mutex_Unlock(Mutex);
+
+        U64 Length = 0;
+        const EIoStatus Status = Io_ReadBlocking(Slot, &Length);
+
+        Mutex_Lock(Mutex);
+        Io_Finish(Slot, Status, Length);
+    }
+
+    Mutex_Unlock(Mutex);
+
+    return 0;
+}
+
+#if IO_URING_SUPPORTED
+Bool Io_UringInitialize() {
+    struct io_uring_params Params;
+    memset(&Params, 0, sizeof Params);
+
+    const int FileDescriptor = (int)syscall(__NR_io_uring_setup, IO_URING_DEPTH, &Params);
+    if (FileDescriptor < 0) {
+        return False;
+    }
+
+    // IORING_OP_READ needs Linux 5.6, which also introduced this feature bit.
+    if (!(Params.features & IORING_FEAT_RW_CUR_POS)) {
+        close(FileDescriptor);
+        return False;
+    }
+
+    memset(&Ring, 0, sizeof Ring);
+    Ring.FileDescriptor = FileDescriptor;
+    Ring.SqRingSize = Params.sq_off.array + Params.sq_entries * sizeof(U32);
+    Ring.CqRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(struct io_uring_cqe);
+
+    const Bool bSingleMap = (Params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (bSingleMap) {
+        if (Ring.CqRingSize > Ring.SqRingSize) {
+            Ring.SqRingSize = Ring.CqRingSize;
+        }
+        Ring.CqRingSize = Ring.SqRingSize;
+    }
+
+    Ring.SqRing = mmap(NULL, Ring.SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, FileDescriptor, IORING_OFF_SQ_RING);
+    if (Ring.SqRing == MAP_FAILED) {
+        close(FileDescriptor);
+        return False;
+    }
+
+    if (bSingleMap) {
+        Ring.CqRing = Ring.SqRing;
+    } else {
+        Ring.CqRing = mmap(NULL, Ring.CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, FileDescriptor, IORING_OFF_CQ_RING);
+        if (Ring.CqRing == MAP_FAILED) {
+            munmap(Ring.SqRing, Ring.SqRingSize);
+            close(FileDescriptor);
+            return False;
+        }
+    }
+
+    Ring.SqesSize = Params.sq_entries * sizeof(struct io_uring_sqe);
+    Ring.Sqes = mmap(NULL, Ring.SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, FileDescriptor, IORING_OFF_SQES);
+    if (Ring.Sqes == MAP_FAILED) {
+        if (!bSingleMap) {
+            munmap(Ring.CqRing, Ring.CqRingSize);
+        }
+        munmap(Ring.SqRing, Ring.SqRingSize);
+        close(FileDescriptor);
+        return False;
+    }
+
+    U8* SqRing = Ring.SqRing;
+    U8* CqRing = Ring.CqRing;
+    Ring.SqHead = (U32*)(SqRing + Params.sq_off.head);
+    Ring.SqTail = (U32*)(SqRing + Params.sq_off.tail);
+    Ring.SqMask = (U32*)(SqRing + Params.sq_off.ring_mask);
+    Ring.SqArray = (U32*)(SqRing + Params.sq_off.array);
+    Ring.CqHead = (U32*)(CqRing + Params.cq_off.head);
+    Ring.CqTail = (U32*)(CqRing + Params.cq_off.tail);
+    Ring.CqMask = (U32*)(CqRing + Params.cq_off.ring_mask);
+    Ring.Cqes = (struct io_uring_cqe*)(CqRing + Params.cq_off.cqes);
+
+    return True;
+}
+
+void Io_UringShutdown() {
+    munmap(Ring.Sqes, Ring.SqesSize);
+    if (Ring.CqRing != Ring.SqRing) {
+        munmap(Ring.CqRing, Ring.CqRingSize);
+    }
+    munmap(Ring.SqRing, Ring.SqRingSize);
+    close(Ring.FileDescriptor);
+}
+
+Bool Io_UringStart(const U32 Slot) {
+    FIoRequest* Request = &Requests[Slot];
+
+    // Opening and sizing the file stays synchronous on the submission thread, it never blocks callers.
+    Request->FileDescriptor = open(Request->Path, O_RDONLY | O_CLOEXEC);
+    if (Request->FileDescriptor < 0) {
+        return False;
+    }
+
+    struct stat Stat;
+    if (fstat(Request->FileDescriptor, &Stat) != 0 || Request->Offset > (U64)Stat.st_size ||
+        (Request->Length > 0 && Request->Offset + Request->Length > (U64)Stat.st_size)) {
+        return False;
+    }
+
+    Request->ReadLength = Request->Length > 0 ? Request->Length : (U64)Stat.st_size - Request->Offset;
+    Request->BytesDone = 0;
+
+    Mutex_Lock(Mutex);
+    Request->Data = Io_PrepareBuffer(Request, Request->ReadLength);
+    Mutex_Unlock(Mutex);
+
+    return Request->Data != NULL;
+}
+
+void Io_UringSubmitRead(const U32 Slot) {
+    const FIoRequest* Request = &Requests[Slot];
+
+    const U32 Tail = *Ring.SqTail;
+    const U32 Index = Tail & *Ring.SqMask;
+    struct io_uring_sqe* Sqe = &Ring.Sqes[Index];
+
+    memset(Sqe, 0, sizeof *Sqe);
+    Sqe->opcode = IORING_OP_READ;
+    Sqe->fd = Request->FileDescriptor;
+    Sqe->addr = (U64)(size_t)(Request->Data + Request->BytesDone);
+    Sqe->len = (U32)(Request->ReadLength - Request->BytesDone > 0x7FFFF000 ? 0x7FFFF000 : Request->ReadLength - Request->BytesDone);
+    Sqe->off = Request->Offset + Request->BytesDone;
+    Sqe->user_data = Slot;
+
+    Ring.SqArray[Index] = Index;
+    __atomic_store_n(Ring.SqTail, Tail + 1, __ATOMIC_RELEASE);
+}
+
+void Io_UringAbandon() {
+    // Closing the ring cancels the reads the kernel still holds.
+    Io_UringShutdown();
+
+    Mutex_Lock(Mutex);
+    Backend = IO_BACKEND_THREADS;
+
+    for (U32 Slot = 0; Slot < IO_MAX_REQUESTS; Slot++) {
+        FIoRequest* Request = &Requests[Slot];
+        if (Request->Status != IO_STATUS_IN_FLIGHT || Request->Leader != InvalidId) {
+            continue;
+        }
+
+        close(Request->FileDescriptor);
+        Request->FileDescriptor = -1;
+
+        // The cancellation may still be writing, the pooled buffer is leaked instead of reused.
+        if (Request->bPooled) {
+            Request->Data = NULL;
+        }
+        Io_Finish(Slot, IO_STATUS_FAILED, 0);
+    }
+
+    // This thread becomes the first worker, no more are started once shutdown began.
+    if (!bShutdownRequested) {
+        const U32 ProcessorCount = Thread_GetProcessorCount();
+        const U32 Count = ProcessorCount < IO_MAX_WORKERS ? ProcessorCount : IO_MAX_WORKERS;
+        while (WorkerCount < Count) {
+            Workers[WorkerCount] = Thread_Create(Io_WorkerMain, "IoWorker", NULL);
+            if (Workers[WorkerCount] == NULL) {
+                break;
+            }
+            WorkerCount++;
+        }
+    }
+
+    Mutex_Unlock(Mutex);
+}
+
+int Io_UringMain(void* UserData) {
+    U32 InFlight = 0;
+    U32 Pending = 0;
+
+    while (True) {
+        U32 Started[IO_URING_DEPTH];
+        U32 StartedCount = 0;
+        Bool bStopping;
+
+        Mutex_Lock(Mutex);
+        while (!bShutdownRequested && InFlight == 0 && Queues[IO_PRIORITY_LOW].Head == InvalidId && Queues[IO_PRIORITY_NORMAL].Head == InvalidId &&
+               Queues[IO_PRIORITY_HIGH].Head == InvalidId && Queues[IO_PRIORITY_CRITICAL].Head == InvalidId) {
+            Condition_Wait(WorkCondition, Mutex);
+        }
+
+        bStopping = bShutdownRequested;
+        if (bStopping && InFlight == 0) {
+            Mutex_Unlock(Mutex);
+            break;
+        }
+
+        U32 Slot;
+        while (!bStopping && InFlight + StartedCount < IO_URING_DEPTH && (Slot = Io_PopQueued()) != InvalidId) {
+            Requests[Slot].Status = IO_STATUS_IN_FLIGHT;
+            for (U32 Follower = Requests[Slot].Follower; Follower != InvalidId; Follower = Requests[Follower].Follower) {
+                Requests[Follower].Status = IO_STATUS_IN_FLIGHT;
+            }
+            Started[StartedCount++] = Slot;
+        }
+        Mutex_Unlock(Mutex);
+
+        for (U32 Index = 0; Index < StartedCount; Index++) {
+            Slot = Started[Index];
+
+            // Pack entries are already in memory, they are copied or decompressed on this thread.
+            if (Requests[Slot].PackEntry != NULL) {
+                U64 Length = 0;
+                const EIoStatus Status = Io_ReadPackBlocking(Slot, &Length);
+                Mutex_Lock(Mutex);
+                Io_Finish(Slot, Status, Length);
+                Mutex_Unlock(Mutex);
+                continue;
+            }
+
+            if (!Io_UringStart(Slot)) {
+                if (Requests[Slot].FileDescriptor >= 0) {
+                    close(Requests[Slot].FileDescriptor);
+                    Requests[Slot].FileDescriptor = -1;
+                }
+                Mutex_Lock(Mutex);
+                Io_Finish(Slot, IO_STATUS_FAILED, 0);
+                Mutex_Unlock(Mutex);
+                continue;
+            }
+
+            if (Requests[Slot].ReadLength == 0) {
+                close(Requests[Slot].FileDescriptor);
+                Requests[Slot].FileDescriptor = -1;
+                Mutex_Lock(Mutex);
+                Io_Finish(Slot, IO_STATUS_COMPLETED, 0);
+                Mutex_Unlock(Mutex);
+                continue;
+            }
+
+            Io_UringSubmitRead(Slot);
+            Pending++;
+            InFlight++;
+        }
+
+        if (InFlight == 0) {
+            continue;
+        }
+
+        // Submit new reads and wait for at least one completion. Requests queued meanwhile are picked up after it.
+        const int Submitted = (int)syscall(__NR_io_uring_enter, Ring.FileDescriptor, Pending, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (Submitted < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            // Busy rings are retried once the completions below are reaped, other errors are persistent.
+            if (errno != EAGAIN && errno != EBUSY) {
+                fprintf(stderr, "io_uring_enter failed, falling back to worker threads: %s\n", strerror(errno));
+                Io_UringAbandon();
+                return Io_WorkerMain(NULL);
+            }
+        } else {
+            Pending -= (U32)Submitted < Pending ? (U32)Submitted : Pending;
+        }
+
+        U32 Head = *Ring.CqHead;
+        while (Head != __atomic_load_n(Ring.CqTail, __ATOMIC_ACQUIRE)) {
+            const struct io_uring_cqe* Cqe = &Ring.Cqes[Head & *Ring.CqMask];
+            const U32 CompletedSlot = (U32)Cqe->user_data;
+            const I32 Result = Cqe->res;
+            Head++;
+
+            FIoRequest* Request = &Requests[CompletedSlot];
+            if (Result > 0) {
+                Request->BytesDone += (U64)Result;
+            }
+
+            // Short reads are resumed from where they stopped.
+            if (Result > 0 && Request->BytesDone < Request->ReadLength && !bStopping) {
+                Io_UringSubmitRead(CompletedSlot);
+                Pending++;
+                continue;
+            }
+
+            close(Request->FileDescriptor);
+            Request->FileDescriptor = -1;
+            InFlight--;
+
+            Mutex_Lock(Mutex);
+            Io_Finish(CompletedSlot, Request->BytesDone == Request->ReadLength ? IO_STATUS_COMPLETED : IO_STATUS_FAILED, Request->BytesDone);
+            Mutex_Unlock(Mutex);
+        }
+        __atomic_store_n(Ring.CqHead, Head, __ATOMIC_RELEASE);
+    }
+
+    return 0;
+}
+#endif
+#pragma endregion
@@ -0,0 +1,120 @@
+#pragma once
+#include "pack.h"
+#include "typedefs.h"
+
+/** Maximum number of requests alive at once. */
+#define IO_MAX_REQUESTS 1024
+
+/** Read request priorities, higher priorities are started first. */
+typedef enum {
+    IO_PRIORITY_LOW = 0,
+    IO_PRIORITY_NORMAL,
+    IO_PRIORITY_HIGH,
+    IO_PRIORITY_CRITICAL,
+    IO_PRIORITY_COUNT
+} EIoPriority;
+
+typedef enum {
+    IO_STATUS_INVALID = 0,
+    IO_STATUS_QUEUED,
+    IO_STATUS_IN_FLIGHT,
+    IO_STATUS_COMPLETED,
+    IO_STATUS_FAILED,
+    IO_STATUS_CANCELLED
+} EIoStatus;
+
+typedef enum {
+    /** io_uring when the kernel supports it, worker threads otherwise. */
+    IO_BACKEND_DEFAULT = 0,
+    /** Blocking reads on worker threads. */
+    IO_BACKEND_THREADS,
+    /** Linux io_uring driven by a single submission thread. */
+    IO_BACKEND_URING
+} EIoBackend;
+
+/** Read request result. */
+typedef struct {
+    U32 Id;
+    EIoStatus Status;
+    pStr Path;
+    /** Read data, pooled buffers are null-terminated, views of a mounted pack are not. Valid until the request is released. */
+    U8* Data;
+    U64 Length;
+    void* UserData;
+} FIoResult;
+
+/**
+ * Completion handler, called by Io_Update for completed, failed and cancelled requests. Return True to keep the request and its data,
+ * the request must be released with Io_Release then. Requests are released after the handler otherwise.
+ */
+typedef Bool (*IoCompletionHandler)(const FIoResult* Result);
+
+/** Read request description. */
+typedef struct {
+    /** File path, copied by the service. */
+    pStr Path;
+    /** Offset of the first byte to read. */
+    U64 Offset;
+    /** Number of bytes to read, zero reads to the end of the file. */
+    U64 Length;
+    /** Caller provided destination buffer, NULL reads into a pooled buffer. */
+    U8* Buffer;
+    U64 BufferSize;
+    EIoPriority Priority;
+    /** Completion handler, NULL if the caller polls the request with Io_GetResult. */
+    IoCompletionHandler Handler;
+    void* UserData;
+} FIoReadRequest;
+
+/** Io service counters. */
+typedef struct {
+    U32 Queued;
+    U32 InFlight;
+    U64 Completed;
+    U64 Failed;
+    U64 Cancelled;
+    /** Requests served by an identical pending read. */
+    U64 Coalesced;
+    /** Requests served from the mounted pack. */
+    U64 PackReads;
+    U64 BytesRead;
+} FIoStats;
+
+/** Initializes the io service with the backend. Falls back to worker threads if io_uring is unavailable or its ring fails later. */
+Bool Io_Initialize(EIoBackend Backend);
+
+/** Cancels pending requests, waits for reads in flight and frees memory. */
+void Io_Shutdown();
+
+/** Returns the backend in use. */
+EIoBackend Io_GetBackend();
+
+/**
+ * Queues an asynchronous read. Pooled reads of the same range of a file that is not read yet are coalesced into one read.
+ * Returns the request id or InvalidId if the request can't be queued.
+ */
+U32 Io_Read(const FIoReadRequest* Request);
+
+/** Cancels the request. Returns False if the request is already finished. */
+Bool Io_Cancel(U32 Id);
+
+/** Returns the request status and fills the result once the request is finished. */
+EIoStatus Io_GetResult(U32 Id, FIoResult* OutResult);
+
+/** Blocks until the request is finished. Meant for loading screens and tools, not for frames. */
+EIoStatus Io_Wait(U32 Id, FIoResult* OutResult);
+
+/** Releases a finished request, returning its pooled buffer. */
+void Io_Release(U32 Id);
+
+/** Calls completion handlers of finished requests on the calling thread. Returns the number of handled requests. Zero MaxCompletions handles all. */
+U32 Io_Update(U32 MaxCompletions);
+
+/**
+ * Serves reads of paths found in the pack from its mapping. Pooled reads of uncompressed entries finish right away without a copy, the
+ * io threads copy and decompress the rest in priority order. NULL unmounts. The pack must stay open until requests served from it are released.
+ */
+void Io_MountPack(const FPack* Pack);
+
+/** Returns the io service counters. */
+FIoStats Io_GetStats();
@@ -0,0 +1,207 @@
+#include "latency.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "containers/vector.h"
+
+/** Latencies of one stage, the last bucket holds everything beyond the others. */
+typedef struct {
+    U32 Buckets[LATENCY_BUCKET_COUNT + 1];
+    U64 Count;
+    U64 Sum;
+    U64 Min;
+    U64 Max;
+} FLatencyHistogram;
+
+/** Frame swapped and not finished yet, its events end at EventEnd in LatencyEvents. */
+typedef struct {
+    U32 Id;
+    U32 EventEnd;
+} FLatencyFrame;
+
+#pragma region Private Variables
+static FLatencyHistogram LatencyHistograms[LATENCY_STAGE_COUNT];
+
+/** Event times of the frames in flight, in submit order, then the ones of the frame being built. */
+static FVector(U64) LatencyEvents = NULL;
+
+static FLatencyFrame LatencyFrames[LATENCY_MAX_FRAMES_IN_FLIGHT];
+static U32 LatencyFrameHead = 0;
+static U32 LatencyFrameCount = 0;
+static U32 LatencyNextFrame = 0;
+static U32 LatencyDroppedFrames = 0;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static void Latency_Record(ELatencyStage Stage, const U64* Timestamps, U32 Count, U64 Timestamp);
+
+/** Removes the oldest frame in flight with its events. */
+static void Latency_PopFrame();
+
+static void Latency_GetDistribution(const FLatencyHistogram* Histogram, FLatencyDistribution* OutDistribution);
+
+/** Returns the upper bound of the bucket the percentile of the samples falls into. */
+static U64 Latency_GetPercentile(const FLatencyHistogram* Histogram, F64 Percentile);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Latency_Initialize() {
+    Latency_Reset();
+    FVector_Reserve(LatencyEvents, 256);
+}
+
+void Latency_Shutdown() {
+    FVector_Free(LatencyEvents);
+    LatencyEvents = NULL;
+    LatencyFrameHead = 0;
+    LatencyFrameCount = 0;
+}
+
+void Latency_Reset() {
+    memset(LatencyHistograms, 0, sizeof LatencyHistograms);
+    LatencyDroppedFrames = 0;
+}
+
+void Latency_AddEvents(const U64* Timestamps, const U32 Count) {
+    for (U32 Index = 0; Index < Count; Index++) {
+        if (FVector_GetSize(LatencyEvents) == FVector_GetCapacity(LatencyEvents)) {
+            const size_t Capacity = FVector_GetCapacity(LatencyEvents) * 2 + 64;
+            FVector_Reserve(LatencyEvents, Capacity);
+        }
+        FVector_Add(LatencyEvents, Timestamps[Index]);
+    }
+}
+
+U32 Latency_SubmitFrame(const U64 Timestamp) {
+    // A frame whose fence never signals would keep its events forever.
+    if (LatencyFrameCount == LATENCY_MAX_FRAMES_IN_FLIGHT) {
+        Latency_PopFrame();
+        LatencyDroppedFrames++;
+    }
+
+    const U32 EventBegin = LatencyFrameCount > 0 ? LatencyFrames[(LatencyFrameHead + LatencyFrameCount - 1) % LATENCY_MAX_FRAMES_IN_FLIGHT].EventEnd : 0;
+    const U32 EventEnd = (U32)FVector_GetSize(LatencyEvents);
+    Latency_Record(LATENCY_STAGE_SWAP, LatencyEvents + EventBegin, EventEnd - EventBegin, Timestamp);
+
+    const U32 Id = LatencyNextFrame++;
+    LatencyFrames[(LatencyFrameHead + LatencyFrameCount) % LATENCY_MAX_FRAMES_IN_FLIGHT] = (FLatencyFrame){Id, EventEnd};
+    LatencyFrameCount++;
+
+    return Id;
+}
+
+void Latency_CompleteFrame(const U32 Frame, const U64 Timestamp) {
+    // Frames before it finished too, at the latest now.
+    while (LatencyFrameCount > 0 && (I32)(LatencyFrames[LatencyFrameHead].Id - Frame) <= 0) {
+        Latency_Record(LATENCY_STAGE_COMPLETE, LatencyEvents, LatencyFrames[LatencyFrameHead].EventEnd, Timestamp);
+        Latency_PopFrame();
+    }
+}
+
+void Latency_GetStats(FLatencyStats* OutStats) {
+    for (U32 Stage = 0; Stage < LATENCY_STAGE_COUNT; Stage++) {
+        Latency_GetDistribution(&LatencyHistograms[Stage], &OutStats->Stages[Stage]);
+    }
+
+    OutStats->FramesInFlight = LatencyFrameCount;
+    OutStats->DroppedFrames = LatencyDroppedFrames;
+}
+
+Bool Latency_Write(const pStr Path) {
+    FILE* pFile = fopen(Path, "w");
+    if (pFile == NULL) {
+        fprintf(stderr, "Unable to open latency file %s\n", Path);
+        return False;
+    }
+
+    static const char* StageNames[LATENCY_STAGE_COUNT] = {"swap", "complete"};
+
+    fprintf(pFile, "{\n  \"bucket_ns\": %llu,\n  \"dropped_frames\": %u,\n  \"stages\": [\n", LATENCY_BUCKET_NANOSECONDS, LatencyDroppedFrames);
+    for (U32 Stage = 0; Stage < LATENCY_STAGE_COUNT; Stage++) {
+        const FLatencyHistogram* Histogram = &LatencyHistograms[Stage];
+        FLatencyDistribution Distribution;
+        Latency_GetDistribution(Histogram, &Distribution);
+
+        fprintf(pFile,
+                "    {\"name\": \"%s\", \"count\": %llu, \"min_ns\": %llu, \"mean_ns\": %llu, \"max_ns\": %llu, \"p50_ns\": %llu, \"p90_ns\": %llu, "
+                "\"p99_ns\": %llu, \"buckets\": [",
+                StageNames[Stage], (unsigned long long)Distribution.Count, (unsigned long long)Distribution.MinNanoseconds,
+                (unsigned long long)Distribution.MeanNanoseconds, (unsigned long long)Distribution.MaxNanoseconds,
+                (unsigned long long)Distribution.P50Nanoseconds, (unsigned long long)Distribution.P90Nanoseconds,
+                (unsigned long long)Distribution.P99Nanoseconds);
+
+        // Pairs of bucket index and count, most buckets are empty.
+        U32 Written = 0;
+        for (U32 Bucket = 0; Bucket <= LATENCY_BUCKET_COUNT; Bucket++) {
+            if (Histogram->Buckets[Bucket] > 0) {
+                fprintf(pFile, "%s[%u, %u]", Written > 0 ? ", " : "", Bucket, Histogram->Buckets[Bucket]);
+                Written++;
+            }
+        }
+
+        fprintf(pFile, "]}%s\n", Stage + 1 < LATENCY_STAGE_COUNT ? "," : "");
+    }
+    fprintf(pFile, "  ]\n}\n");
+
+    fclose(pFile);
+
+    return True;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void Latency_Record(const ELatencyStage Stage, const U64* Timestamps, const U32 Count, const U64 Timestamp) {
+    FLatencyHistogram* Histogram = &LatencyHistograms[Stage];
+    for (U32 Index = 0; Index < Count; Index++) {
+        const U64 Latency = Timestamp > Timestamps[Index] ? Timestamp - Timestamps[Index] : 0;
+        const U64 Bucket = Latency / LATENCY_BUCKET_NANOSECONDS;
+        Histogram->Buckets[Bucket < LATENCY_BUCKET_COUNT ? Bucket : LATENCY_BUCKET_COUNT]++;
+        Histogram->Min = Histogram->Count == 0 || Latency < Histogram->Min ? Latency : Histogram->Min;
+        Histogram->Max = Latency > Histogram->Max ? Latency : Histogram->Max;
+        Histogram->Sum += Latency;
+        Histogram->Count++;
+    }
+}
+
+void Latency_PopFrame() {
+    const U32 EventEnd = LatencyFrames[LatencyFrameHead].EventEnd;
+    const size_t Remaining = FVector_GetSize(LatencyEvents) - EventEnd;
+    memmove(LatencyEvents, LatencyEvents + EventEnd, Remaining * sizeof(U64));
+    FVector_SetSize(LatencyEvents, Remaining);
+
+    LatencyFrameHead = (LatencyFrameHead + 1) % LATENCY_MAX_FRAMES_IN_FLIGHT;
+    LatencyFrameCount--;
+    for (U32 Index = 0; Index < LatencyFrameCount; Index++) {
+        LatencyFrames[(LatencyFrameHead + Index) % LATENCY_MAX_FRAMES_IN_FLIGHT].EventEnd -= EventEnd;
+    }
+}
+
+void Latency_GetDistribution(const FLatencyHistogram* Histogram, FLatencyDistribution* OutDistribution) {
+    OutDistribution->Count = Histogram->Count;
+    OutDistribution->MinNanoseconds = Histogram->Min;
+    OutDistribution->MeanNanoseconds = Histogram->Count > 0 ? Histogram->Sum / Histogram->Count : 0;
+    OutDistribution->MaxNanoseconds = Histogram->Max;
+    OutDistribution->P50Nanoseconds = Latency_GetPercentile(Histogram, 0.5);
+    OutDistribution->P90Nanoseconds = Latency_GetPercentile(Histogram, 0.9);
+    OutDistribution->P99Nanoseconds = Latency_GetPercentile(Histogram, 0.99);
+}
+
+U64 Latency_GetPercentile(const FLatencyHistogram* Histogram, const F64 Percentile) {
+    if (Histogram->Count == 0) {
+        return 0;
+    }
+
+    const U64 Target = (U64)(Percentile * (F64)(Histogram->Count - 1)) + 1;
+    U64 Seen = 0;
+    for (U32 Bucket = 0; Bucket < LATENCY_BUCKET_COUNT; Bucket++) {
+        Seen += Histogram->Buckets[Bucket];
+        if (Seen >= Target) {
+            const U64 Bound = (Bucket + 1) * LATENCY_BUCKET_NANOSECONDS;
+            return Bound < Histogram->Max ? Bound : Histogram->Max;
+        }
+    }
+
+    return Histogram->Max;
+}
+#pragma endregion
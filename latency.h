@@ -0,0 +1,60 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Latency from input events to the frames that consumed them. Events are tagged with the time they were received,
+ * frames are timed when their swap returns and when the GPU finished them. Latencies are kept in histograms of
+ * LATENCY_BUCKET_NANOSECONDS buckets, so percentiles are exact to a bucket.
+ */
+#define LATENCY_BUCKET_NANOSECONDS 100000ull
+#define LATENCY_BUCKET_COUNT 2000
+#define LATENCY_MAX_FRAMES_IN_FLIGHT 8
+
+typedef enum {
+    /** Until the swap of the frame returned. */
+    LATENCY_STAGE_SWAP = 0,
+    /** Until the GPU finished the frame, observed when its fence was polled. */
+    LATENCY_STAGE_COMPLETE,
+    LATENCY_STAGE_COUNT
+} ELatencyStage;
+
+typedef struct {
+    U64 Count;
+    U64 MinNanoseconds;
+    U64 MeanNanoseconds;
+    U64 MaxNanoseconds;
+    /** Upper bounds of the buckets holding the percentiles. */
+    U64 P50Nanoseconds;
+    U64 P90Nanoseconds;
+    U64 P99Nanoseconds;
+} FLatencyDistribution;
+
+typedef struct {
+    FLatencyDistribution Stages[LATENCY_STAGE_COUNT];
+    /** Frames swapped and not finished by the GPU yet. */
+    U32 FramesInFlight;
+    /** Frames given up on, their fence didn't signal before LATENCY_MAX_FRAMES_IN_FLIGHT frames followed. */
+    U32 DroppedFrames;
+} FLatencyStats;
+
+void Latency_Initialize();
+
+/** Frees the frames in flight. */
+void Latency_Shutdown();
+
+/** Clears the histograms, the frames in flight are kept. */
+void Latency_Reset();
+
+/** Tags the events consumed by the frame being built with the times they were received. */
+void Latency_AddEvents(const U64* Timestamps, U32 Count);
+
+/** Closes the frame being built after its swap returned, returns its id for Latency_CompleteFrame. */
+U32 Latency_SubmitFrame(U64 Timestamp);
+
+/** Records the time the GPU finished the frame, frames finish in submit order. */
+void Latency_CompleteFrame(U32 Frame, U64 Timestamp);
+
+void Latency_GetStats(FLatencyStats* OutStats);
+
+/** Writes the distributions and the non empty buckets of the histograms as JSON. */
+Bool Latency_Write(pStr Path);
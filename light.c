@@ -0,0 +1,846 @@
+#include "light.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "block.h"
+#include "clock.h"
+#include "containers/vector.h"
+#include "thread.h"
+
+#pragma region Settings
+/** Maximum number of worker threads. */
+#define LIGHT_MAX_WORKERS 16
+/** Chunk lookups remembered by a context, a power of two. */
+#define LIGHT_CACHE_SIZE 16
+/**
+ * Changes of chunk columns this close on both horizontal axes are propagated together. Light spreads less than a
+ * chunk sideways, so a change reaches the neighbouring columns at most and islands further apart never meet.
+ */
+#define LIGHT_ISLAND_DISTANCE 2
+#pragma endregion
+
+typedef enum {
+    LIGHT_CHANNEL_SUN = 0,
+    LIGHT_CHANNEL_BLOCK,
+    LIGHT_CHANNEL_COUNT
+} ELightChannel;
+
+typedef enum {
+    /** Block whose type changed, at a world block position. */
+    LIGHT_ITEM_BLOCK = 0,
+    /** Chunk added to the world, at a chunk position. */
+    LIGHT_ITEM_CHUNK
+} ELightItemType;
+
+typedef struct {
+    ELightItemType Type;
+    I32 X;
+    I32 Y;
+    I32 Z;
+} FLightItem;
+
+/** Chunk column with queued items, linked into islands. */
+typedef struct {
+    I32 X;
+    I32 Z;
+    U32 Parent;
+    U32 Island;
+} FLightColumn;
+
+/** Range of the sorted items propagated by one thread. */
+typedef struct {
+    U32 Begin;
+    U32 End;
+} FLightJob;
+
+/** Block in a propagation queue at a world block position, with its level before removal. */
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Byte Level;
+} FLightNode;
+
+typedef struct {
+    FVector(FLightNode) Nodes;
+    U32 Head;
+} FLightQueue;
+
+/** Box of blocks whose light changed in a chunk, local to the chunk. */
+typedef struct {
+    FChunk* Chunk;
+    I32 Min[3];
+    I32 Max[3];
+} FLightChange;
+
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Bool bValid;
+    FChunk* Chunk;
+} FLightCacheEntry;
+
+/** Propagation state of one thread. Without a world it lights the single chunk. */
+typedef struct {
+    const FWorld* World;
+    FChunk* Chunk;
+    FLightCacheEntry Cache[LIGHT_CACHE_SIZE];
+    FLightQueue Additions[LIGHT_CHANNEL_COUNT];
+    FLightQueue Removals[LIGHT_CHANNEL_COUNT];
+    FVector(FLightChange) Changes;
+    U32 LastChange;
+    U32 RemovedBlocks;
+    U32 LitBlocks;
+} FLightContext;
+
+typedef struct {
+    FLight* Light;
+    FThread* Thread;
+    U32 Index;
+} FLightWorker;
+
+struct FLight {
+    FWorld* World;
+    LightChunkHandler OnChunkChanged;
+    void* UserData;
+
+    FVector(FLightItem) Items;
+    FVector(U32) ItemColumns;
+    FVector(FLightColumn) Columns;
+    FVector(FLightItem) SortedItems;
+    FVector(FLightJob) Jobs;
+
+    /** Context of the updating thread first, then one per worker. */
+    FLightContext Contexts[LIGHT_MAX_WORKERS + 1];
+    FLightWorker Workers[LIGHT_MAX_WORKERS];
+    U32 WorkerCount;
+    FMutex* Mutex;
+    FCondition* WorkStarted;
+    FCondition* WorkFinished;
+    /** Started updates count up so workers tell them apart. */
+    U32 Generation;
+    /** Jobs of the running update, workers waking late only see the update they were woken for as finished. */
+    U32 JobCount;
+    U32 NextJob;
+    U32 FinishedJobs;
+    Bool bStopping;
+
+    FLightStats Stats;
+};
+
+#pragma region Private Function Declarations
+static int Light_WorkerMain(void* UserData);
+
+/** Runs jobs of the running update until none are left. */
+static void Light_WorkJobs(FLight* Light, FLightContext* Context);
+
+/** Seeds the items of the job and propagates them. */
+static void Light_RunJob(FLight* Light, FLightContext* Context, const FLightJob* Job);
+
+/** Groups the queued items into islands of nearby chunk columns, one job each. */
+static void Light_BuildJobs(FLight* Light);
+
+static U32 Light_FindColumn(FLight* Light, U32 Column);
+
+static void Light_FreeContext(FLightContext* Context);
+
+static FChunk* Light_GetChunk(FLightContext* Context, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns the chunk of the world block position and the block index in it, NULL if the chunk is missing. */
+static FChunk* Light_Locate(FLightContext* Context, I32 X, I32 Y, I32 Z, U32* OutIndex);
+
+static inline Byte Light_GetLevel(const FChunk* Chunk, const U32 Index, const ELightChannel Channel) {
+    return Channel == LIGHT_CHANNEL_SUN ? Chunk_GetSunLight(Chunk, Index) : Chunk_GetBlockLight(Chunk, Index);
+}
+
+/** Sets the level of the block at the world block position and records the change. */
+static void Light_SetLevel(FLightContext* Context, FChunk* Chunk, U32 Index, I32 X, I32 Y, I32 Z, ELightChannel Channel, Byte Level);
+
+static void Light_Push(FLightQueue* Queue, I32 X, I32 Y, I32 Z, Byte Level);
+
+/** Clears the level of the block and queues its removal. */
+static void Light_Remove(FLightContext* Context, FChunk* Chunk, U32 Index, I32 X, I32 Y, I32 Z, ELightChannel Channel);
+
+/** Queues the block to spread its light in each channel it has light in. */
+static void Light_Spread(FLightContext* Context, const FChunk* Chunk, U32 Index, I32 X, I32 Y, I32 Z);
+
+/** Clears the light that came from removed blocks, blocks lit by other sources are queued to refill the gap. */
+static void Light_PropagateRemovals(FLightContext* Context, ELightChannel Channel);
+
+static void Light_PropagateAdditions(FLightContext* Context, ELightChannel Channel);
+
+static void Light_SeedBlock(FLightContext* Context, I32 X, I32 Y, I32 Z);
+
+static void Light_SeedChunk(FLightContext* Context, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns True if the block is air in full sunlight, passing it down without dimming. */
+static inline Bool Light_IsSky(const FChunk* Chunk, const U32 Index) {
+    return Chunk->Blocks[Index].Type == BLOCK_TYPE_AIR && Chunk_GetSunLight(Chunk, Index) == BLOCK_LIGHT_MAX;
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Light_ComputeChunk(FChunk* Chunk) {
+    if (Chunk->BlockCount == 0) {
+        memset(Chunk->Light, BLOCK_LIGHT_MAX << 4, sizeof Chunk->Light);
+        return;
+    }
+
+    memset(Chunk->Light, 0, sizeof Chunk->Light);
+
+    // Sunlight falls down each column until the first block that isn't air.
+    for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+        for (I32 X = 0; X < CHUNK_SIZE; X++) {
+            for (I32 Y = CHUNK_SIZE - 1; Y >= 0; Y--) {
+                const U32 Index = Chunk_GetBlockIndex(X, Y, Z);
+                if (Chunk->Blocks[Index].Type != BLOCK_TYPE_AIR) {
+                    break;
+                }
+                Chunk->Light[Index] = BLOCK_LIGHT_MAX << 4;
+            }
+        }
+    }
+
+    FLightContext Context;
+    memset(&Context, 0, sizeof Context);
+    Context.Chunk = Chunk;
+
+    const I32 OriginX = Chunk->X * CHUNK_SIZE;
+    const I32 OriginY = Chunk->Y * CHUNK_SIZE;
+    const I32 OriginZ = Chunk->Z * CHUNK_SIZE;
+    for (I32 Y = 0; Y < CHUNK_SIZE; Y++) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                const U32 Index = Chunk_GetBlockIndex(X, Y, Z);
+                const Byte Emission = Block_GetEmission(Chunk->Blocks[Index].Type);
+                if (Emission > 0) {
+                    Chunk->Light[Index] |= Emission;
+                    Light_Push(&Context.Additions[LIGHT_CHANNEL_BLOCK], OriginX + X, OriginY + Y, OriginZ + Z, Emission);
+                }
+
+                if (!Light_IsSky(Chunk, Index)) {
+                    continue;
+                }
+
+                // Only sky next to darker open blocks spreads, the sky around it is lit already.
+                for (U32 Direction = 0; Direction < 6; Direction++) {
+                    const I32 NeighbourX = X + BlockDirectionOffsets[Direction][0];
+                    const I32 NeighbourY = Y + BlockDirectionOffsets[Direction][1];
+                    const I32 NeighbourZ = Z + BlockDirectionOffsets[Direction][2];
+                    if (!Chunk_IsInside(NeighbourX, NeighbourY, NeighbourZ)) {
+                        continue;
+                    }
+
+                    const U32 NeighbourIndex = Chunk_GetBlockIndex(NeighbourX, NeighbourY, NeighbourZ);
+                    if (!Block_IsSolid(Chunk->Blocks[NeighbourIndex].Type) && !Light_IsSky(Chunk, NeighbourIndex)) {
+                        Light_Push(&Context.Additions[LIGHT_CHANNEL_SUN], OriginX + X, OriginY + Y, OriginZ + Z, BLOCK_LIGHT_MAX);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    Light_PropagateAdditions(&Context, LIGHT_CHANNEL_SUN);
+    Light_PropagateAdditions(&Context, LIGHT_CHANNEL_BLOCK);
+    Light_FreeContext(&Context);
+}
+
+FLight* Light_Create(FWorld* World, U32 WorkerCount, const LightChunkHandler OnChunkChanged, void* UserData) {
+    FLight* Light = calloc(1, sizeof(FLight));
+    if (Light == NULL) {
+        return NULL;
+    }
+
+    Light->World = World;
+    Light->OnChunkChanged = OnChunkChanged;
+    Light->UserData = UserData;
+    for (U32 Index = 0; Index <= LIGHT_MAX_WORKERS; Index++) {
+        Light->Contexts[Index].World = World;
+    }
+
+    Light->Mutex = Mutex_Create();
+    Light->WorkStarted = Condition_Create();
+    Light->WorkFinished = Condition_Create();
+    if (Light->Mutex == NULL || Light->WorkStarted == NULL || Light->WorkFinished == NULL) {
+        Light_Destroy(Light);
+        return NULL;
+    }
+
+    if (WorkerCount > LIGHT_MAX_WORKERS) {
+        WorkerCount = LIGHT_MAX_WORKERS;
+    }
+
+    for (U32 Index = 0; Index < WorkerCount; Index++) {
+        FLightWorker* Worker = &Light->Workers[Index];
+        Worker->Light = Light;
+        Worker->Index = Index + 1;
+        Worker->Thread = Thread_Create(Light_WorkerMain, "Light", Worker);
+        if (Worker->Thread == NULL) {
+            fprintf(stderr, "Failed to start light worker %u\n", Index);
+            break;
+        }
+        Light->WorkerCount++;
+    }
+
+    return Light;
+}
+
+void Light_Destroy(FLight* Light) {
+    if (Light == NULL) {
+        return;
+    }
+
+    if (Light->Mutex != NULL && Light->WorkStarted != NULL) {
+        Mutex_Lock(Light->Mutex);
+        Light->bStopping = True;
+        Condition_Broadcast(Light->WorkStarted);
+        Mutex_Unlock(Light->Mutex);
+    }
+
+    for (U32 Index = 0; Index < Light->WorkerCount; Index++) {
+        Thread_Join(Light->Workers[Index].Thread);
+    }
+
+    for (U32 Index = 0; Index <= LIGHT_MAX_WORKERS; Index++) {
+        Light_FreeContext(&Light->Contexts[Index]);
+    }
+
+    Condition_Destroy(Light->WorkFinished);
+    Condition_Destroy(Light->WorkStarted);
+    Mutex_Destroy(Light->Mutex);
+    FVector_Free(Light->Jobs);
+    FVector_Free(Light->SortedItems);
+    FVector_Free(Light->Columns);
+    FVector_Free(Light->ItemColumns);
+    FVector_Free(Light->Items);
+    free(Light);
+}
+
+void Light_AddChunk(FLight* Light, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    FLightItem Item = {LIGHT_ITEM_CHUNK, ChunkX, ChunkY, ChunkZ};
+    if (FVector_GetSize(Light->Items) == FVector_GetCapacity(Light->Items)) {
+        const size_t Capacity = FVector_GetCapacity(Light->Items) * 2 + 64;
+        FVector_Reserve(Light->Items, Capacity);
+    }
+    FVector_Add(Light->Items, Item);
+}
+
+void Light_UpdateBlock(FLight* Light, const I32 X, const I32 Y, const I32 Z) {
+    FLightItem Item = {LIGHT_ITEM_BLOCK, X, Y, Z};
+    if (FVector_GetSize(Light->Items) == FVector_GetCapacity(Light->Items)) {
+        const size_t Capacity = FVector_GetCapacity(Light->Items) * 2 + 64;
+        FVector_Reserve(Light->Items, Capacity);
+    }
+    FVector_Add(Light->Items, Item);
+}
+
+Bool Light_IsPending(const FLight* Light) {
+    return !FVector_IsEmpty(Light->Items);
+}
+
+void Light_Update(FLight* Light) {
+    memset(&Light->Stats, 0, sizeof Light->Stats);
+    if (FVector_IsEmpty(Light->Items)) {
+        return;
+    }
+
+    const U64 Start = Clock_GetNanoseconds();
+    Light_BuildJobs(Light);
+    const U32 JobCount = (U32)FVector_GetSize(Light->Jobs);
+
+    if (Light->WorkerCount == 0 || JobCount <= 1) {
+        for (U32 Index = 0; Index < JobCount; Index++) {
+            Light_RunJob(Light, &Light->Contexts[0], &Light->Jobs[Index]);
+        }
+    } else {
+        Mutex_Lock(Light->Mutex);
+        Light->JobCount = JobCount;
+        Light->NextJob = 0;
+        Light->FinishedJobs = 0;
+        Light->Generation++;
+        Condition_Broadcast(Light->WorkStarted);
+        Mutex_Unlock(Light->Mutex);
+
+        Light_WorkJobs(Light, &Light->Contexts[0]);
+
+        Mutex_Lock(Light->Mutex);
+        while (Light->FinishedJobs < Light->JobCount) {
+            Condition_Wait(Light->WorkFinished, Light->Mutex);
+        }
+        Mutex_Unlock(Light->Mutex);
+    }
+
+    // Islands never share chunks, so each chunk appears in one context at most.
+    for (U32 Index = 0; Index <= Light->WorkerCount; Index++) {
+        FLightContext* Context = &Light->Contexts[Index];
+        for (size_t Change = 0; Change < FVector_GetSize(Context->Changes); Change++) {
+            if (Light->OnChunkChanged != NULL) {
+                Light->OnChunkChanged(Context->Changes[Change].Chunk, Context->Changes[Change].Min, Context->Changes[Change].Max, Light->UserData);
+            }
+        }
+        FVector_Clear(Context->Changes);
+
+        Light->Stats.RemovedBlocks += Context->RemovedBlocks;
+        Light->Stats.LitBlocks += Context->LitBlocks;
+        Context->RemovedBlocks = 0;
+        Context->LitBlocks = 0;
+    }
+
+    FVector_Clear(Light->Items);
+    Light->Stats.Islands = JobCount;
+    Light->Stats.Nanoseconds = Clock_GetNanoseconds() - Start;
+}
+
+void Light_GetStats(const FLight* Light, FLightStats* OutStats) {
+    *OutStats = Light->Stats;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+int Light_WorkerMain(void* UserData) {
+    FLightWorker* Worker = UserData;
+    FLight* Light = Worker->Light;
+
+    U32 Generation = 0;
+    Mutex_Lock(Light->Mutex);
+    for (;;) {
+        while (Light->Generation == Generation && !Light->bStopping) {
+            Condition_Wait(Light->WorkStarted, Light->Mutex);
+        }
+
+        if (Light->bStopping) {
+            break;
+        }
+
+        Generation = Light->Generation;
+        Mutex_Unlock(Light->Mutex);
+        Light_WorkJobs(Light, &Light->Contexts[Worker->Index]);
+        Mutex_Lock(Light->Mutex);
+    }
+    Mutex_Unlock(Light->Mutex);
+
+    return 0;
+}
+
+void Light_WorkJobs(FLight* Light, FLightContext* Context) {
+    Mutex_Lock(Light->Mutex);
+    while (Light->NextJob < Light->JobCount) {
+        const FLightJob* Job = &Light->Jobs[Light->NextJob++];
+        Mutex_Unlock(Light->Mutex);
+
+        Light_RunJob(Light, Context, Job);
+
+        Mutex_Lock(Light->Mutex);
+        if (++Light->FinishedJobs == Light->JobCount) {
+            Condition_Signal(Light->WorkFinished);
+        }
+    }
+    Mutex_Unlock(Light->Mutex);
+}
+
+void Light_RunJob(FLight* Light, FLightContext* Context, const FLightJob* Job) {
+    // Chunks come and go between updates.
+    memset(Context->Cache, 0, sizeof Context->Cache);
+
+    for (U32 Index = Job->Begin; Index < Job->End; Index++) {
+        const FLightItem* Item = &Light->SortedItems[Index];
+        if (Item->Type == LIGHT_ITEM_CHUNK) {
+            Light_SeedChunk(Context, Item->X, Item->Y, Item->Z);
+        } else {
+            Light_SeedBlock(Context, Item->X, Item->Y, Item->Z);
+        }
+    }
+
+    // All removals finish before any addition, so no light is spread from a source that is going away.
+    for (U32 Channel = 0; Channel < LIGHT_CHANNEL_COUNT; Channel++) {
+        Light_PropagateRemovals(Context, (ELightChannel)Channel);
+    }
+    for (U32 Channel = 0; Channel < LIGHT_CHANNEL_COUNT; Channel++) {
+        Light_PropagateAdditions(Context, (ELightChannel)Channel);
+    }
+}
+
+void Light_BuildJobs(FLight* Light) {
+    const U32 ItemCount = (U32)FVector_GetSize(Light->Items);
+    FVector_Clear(Light->Columns);
+    FVector_Clear(Light->Jobs);
+    FVector_Reserve(Light->ItemColumns, ItemCount);
+    FVector_Reserve(Light->SortedItems, ItemCount);
+    FVector_SetSize(Light->ItemColumns, ItemCount);
+    FVector_SetSize(Light->SortedItems, ItemCount);
+
+    // Items mostly come in runs from the same column.
+    U32 Column = InvalidId;
+    for (U32 Index = 0; Index < ItemCount; Index++) {
+        const FLightItem* Item = &Light->Items[Index];
+        const I32 ColumnX = Item->Type == LIGHT_ITEM_CHUNK ? Item->X : World_GetChunkCoordinate(Item->X);
+        const I32 ColumnZ = Item->Type == LIGHT_ITEM_CHUNK ? Item->Z : World_GetChunkCoordinate(Item->Z);
+        if (Column == InvalidId || Light->Columns[Column].X != ColumnX || Light->Columns[Column].Z != ColumnZ) {
+            const U32 ColumnCount = (U32)FVector_GetSize(Light->Columns);
+            for (Column = 0; Column < ColumnCount; Column++) {
+                if (Light->Columns[Column].X == ColumnX && Light->Columns[Column].Z == ColumnZ) {
+                    break;
+                }
+            }
+
+            if (Column == ColumnCount) {
+                FLightColumn NewColumn = {ColumnX, ColumnZ, Column, InvalidId};
+                if (FVector_GetSize(Light->Columns) == FVector_GetCapacity(Light->Columns)) {
+                    const size_t Capacity = FVector_GetCapacity(Light->Columns) * 2 + 64;
+                    FVector_Reserve(Light->Columns, Capacity);
+                }
+                FVector_Add(Light->Columns, NewColumn);
+            }
+        }
+        Light->ItemColumns[Index] = Column;
+    }
+
+    const U32 ColumnCount = (U32)FVector_GetSize(Light->Columns);
+    for (U32 First = 0; First < ColumnCount; First++) {
+        for (U32 Second = First + 1; Second < ColumnCount; Second++) {
+            const I32 DX = Light->Columns[First].X - Light->Columns[Second].X;
+            const I32 DZ = Light->Columns[First].Z - Light->Columns[Second].Z;
+            if (DX >= -LIGHT_ISLAND_DISTANCE && DX <= LIGHT_ISLAND_DISTANCE && DZ >= -LIGHT_ISLAND_DISTANCE && DZ <= LIGHT_ISLAND_DISTANCE) {
+                Light->Columns[Light_FindColumn(Light, First)].Parent = Light_FindColumn(Light, Second);
+            }
+        }
+    }
+
+    // Counting sort of the items by island, keeping their order within an island.
+    U32 IslandCount = 0;
+    for (U32 Index = 0; Index < ColumnCount; Index++) {
+        FLightColumn* Root = &Light->Columns[Light_FindColumn(Light, Index)];
+        if (Root->Island == InvalidId) {
+            Root->Island = IslandCount++;
+            FLightJob Job = {0, 0};
+            if (FVector_GetSize(Light->Jobs) == FVector_GetCapacity(Light->Jobs)) {
+                const size_t Capacity = FVector_GetCapacity(Light->Jobs) * 2 + 64;
+                FVector_Reserve(Light->Jobs, Capacity);
+            }
+            FVector_Add(Light->Jobs, Job);
+        }
+        Light->Columns[Index].Island = Root->Island;
+    }
+
+    for (U32 Index = 0; Index < ItemCount; Index++) {
+        Light->Jobs[Light->Columns[Light->ItemColumns[Index]].Island].End++;
+    }
+    U32 Offset = 0;
+    for (U32 Island = 0; Island < IslandCount; Island++) {
+        const U32 Size = Light->Jobs[Island].End;
+        Light->Jobs[Island].Begin = Offset;
+        Light->Jobs[Island].End = Offset;
+        Offset += Size;
+    }
+    for (U32 Index = 0; Index < ItemCount; Index++) {
+        FLightJob* Job = &Light->Jobs[Light->Columns[Light->ItemColumns[Index]].Island];
+        Light->SortedItems[Job->End++] = Light->Items[Index];
+    }
+}
+
+U32 Light_FindColumn(FLight* Light, U32 Column) {
+    while (Light->Columns[Column].Parent != Column) {
+        Light->Columns[Column].Parent = Light->Columns[Light->Columns[Column].Parent].Parent;
+        Column = Light->Columns[Column].Parent;
+    }
+
+    return Column;
+}
+
+void Light_FreeContext(FLightContext* Context) {
+    for (U32 Channel = 0; Channel < LIGHT_CHANNEL_COUNT; Channel++) {
+        FVector_Free(Context->Additions[Channel].Nodes);
+        FVector_Free(Context->Removals[Channel].Nodes);
+    }
+    FVector_Free(Context->Changes);
+}
+
+FChunk* Light_GetChunk(FLightContext* Context, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    if (Context->World == NULL) {
+        FChunk* Chunk = Context->Chunk;
+        return Chunk->X == ChunkX && Chunk->Y == ChunkY && Chunk->Z == ChunkZ ? Chunk : NULL;
+    }
+
+    const U32 Slot = ((U32)ChunkX * 0x8DA6B343u ^ (U32)ChunkY * 0xD8163841u ^ (U32)ChunkZ * 0xCB1AB31Fu) >> 28 & (LIGHT_CACHE_SIZE - 1);
+    FLightCacheEntry* Entry = &Context->Cache[Slot];
+    if (!Entry->bValid || Entry->X != ChunkX || Entry->Y != ChunkY || Entry->Z != ChunkZ) {
+        *Entry = (FLightCacheEntry){ChunkX, ChunkY, ChunkZ, True, World_GetChunk(Context->World, ChunkX, ChunkY, ChunkZ)};
+    }
+
+    return Entry->Chunk;
+}
+
+FChunk* Light_Locate(FLightContext* Context, const I32 X, const I32 Y, const I32 Z, U32* OutIndex) {
+    const I32 ChunkX = World_GetChunkCoordinate(X);
+    const I32 ChunkY = World_GetChunkCoordinate(Y);
+    const I32 ChunkZ = World_GetChunkCoordinate(Z);
+    FChunk* Chunk = Light_GetChunk(Context, ChunkX, ChunkY, ChunkZ);
+    if (Chunk != NULL) {
+        *OutIndex = Chunk_GetBlockIndex(X - ChunkX * CHUNK_SIZE, Y - ChunkY * CHUNK_SIZE, Z - ChunkZ * CHUNK_SIZE);
+    }
+
+    return Chunk;
+}
+
+void Light_SetLevel(FLightContext* Context, FChunk* Chunk, const U32 Index, const I32 X, const I32 Y, const I32 Z, const ELightChannel Channel, const Byte Level) {
+    Chunk->Light[Index] = Channel == LIGHT_CHANNEL_SUN ? (Byte)((Chunk->Light[Index] & 0x0F) | Level << 4) : (Byte)((Chunk->Light[Index] & 0xF0) | Level);
+
+    if (Context->World == NULL) {
+        return;
+    }
+
+    const I32 Local[3] = {X - Chunk->X * CHUNK_SIZE, Y - Chunk->Y * CHUNK_SIZE, Z - Chunk->Z * CHUNK_SIZE};
+    const U32 ChangeCount = (U32)FVector_GetSize(Context->Changes);
+    if (Context->LastChange >= ChangeCount || Context->Changes[Context->LastChange].Chunk != Chunk) {
+        for (Context->LastChange = 0; Context->LastChange < ChangeCount; Context->LastChange++) {
+            if (Context->Changes[Context->LastChange].Chunk == Chunk) {
+                break;
+            }
+        }
+
+        if (Context->LastChange == ChangeCount) {
+            FLightChange Change = {Chunk, {Local[0], Local[1], Local[2]}, {Local[0], Local[1], Local[2]}};
+            if (FVector_GetSize(Context->Changes) == FVector_GetCapacity(Context->Changes)) {
+                const size_t Capacity = FVector_GetCapacity(Context->Changes) * 2 + 64;
+                FVector_Reserve(Context->Changes, Capacity);
+            }
+            FVector_Add(Context->Changes, Change);
+            return;
+        }
+    }
+
+    FLightChange* Change = &Context->Changes[Context->LastChange];
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Change->Min[Axis] = Local[Axis] < Change->Min[Axis] ? Local[Axis] : Change->Min[Axis];
+        Change->Max[Axis] = Local[Axis] > Change->Max[Axis] ? Local[Axis] : Change->Max[Axis];
+    }
+}
+
+void Light_Push(FLightQueue* Queue, const I32 X, const I32 Y, const I32 Z, const Byte Level) {
+    FLightNode Node = {X, Y, Z, Level};
+    if (FVector_GetSize(Queue->Nodes) == FVector_GetCapacity(Queue->Nodes)) {
+        const size_t Capacity = FVector_GetCapacity(Queue->Nodes) * 2 + 64;
+        FVector_Reserve(Queue->Nodes, Capacity);
+    }
+    FVector_Add(Queue->Nodes, Node);
+}
+
+void Light_Remove(FLightContext* Context, FChunk* Chunk, const U32 Index, const I32 X, const I32 Y, const I32 Z, const ELightChannel Channel) {
+    const Byte Level = Light_GetLevel(Chunk, Index, Channel);
+    if (Level == 0) {
+        return;
+    }
+
+    Light_SetLevel(Context, Chunk, Index, X, Y, Z, Channel, 0);
+    Light_Push(&Context->Removals[Channel], X, Y, Z, Level);
+    Context->RemovedBlocks++;
+}
+
+void Light_Spread(FLightContext* Context, const FChunk* Chunk, const U32 Index, const I32 X, const I32 Y, const I32 Z) {
+    for (U32 Channel = 0; Channel < LIGHT_CHANNEL_COUNT; Channel++) {
+        const Byte Level = Light_GetLevel(Chunk, Index, (ELightChannel)Channel);
+        if (Level > 1) {
+            Light_Push(&Context->Additions[Channel], X, Y, Z, Level);
+        }
+    }
+}
+
+void Light_PropagateRemovals(FLightContext* Context, const ELightChannel Channel) {
+    FLightQueue* Queue = &Context->Removals[Channel];
+    while (Queue->Head < FVector_GetSize(Queue->Nodes)) {
+        const FLightNode Node = Queue->Nodes[Queue->Head++];
+
+        for (U32 Direction = 0; Direction < 6; Direction++) {
+            const I32 X = Node.X + BlockDirectionOffsets[Direction][0];
+            const I32 Y = Node.Y + BlockDirectionOffsets[Direction][1];
+            const I32 Z = Node.Z + BlockDirectionOffsets[Direction][2];
+            U32 Index;
+            FChunk* Chunk = Light_Locate(Context, X, Y, Z, &Index);
+            if (Chunk == NULL) {
+                continue;
+            }
+
+            const Byte Level = Light_GetLevel(Chunk, Index, Channel);
+            if (Level == 0) {
+                continue;
+            }
+
+            // Solid blocks only hold the light they emit, which stays and refills the gap.
+            if (Block_IsSolid(Chunk->Blocks[Index].Type)) {
+                Light_Push(&Context->Additions[Channel], X, Y, Z, Level);
+                continue;
+            }
+
+            // Dimmer neighbours and sunlight passed straight down got their light from the removed block.
+            const Bool bFromSky = Channel == LIGHT_CHANNEL_SUN && Direction == YNegative && Node.Level == BLOCK_LIGHT_MAX && Level == BLOCK_LIGHT_MAX;
+            if (Level < Node.Level || bFromSky) {
+                Light_SetLevel(Context, Chunk, Index, X, Y, Z, Channel, 0);
+                Light_Push(Queue, X, Y, Z, Level);
+                Context->RemovedBlocks++;
+            } else {
+                Light_Push(&Context->Additions[Channel], X, Y, Z, Level);
+            }
+        }
+    }
+
+    Queue->Head = 0;
+    FVector_Clear(Queue->Nodes);
+}
+
+void Light_PropagateAdditions(FLightContext* Context, const ELightChannel Channel) {
+    FLightQueue* Queue = &Context->Additions[Channel];
+    while (Queue->Head < FVector_GetSize(Queue->Nodes)) {
+        const FLightNode Node = Queue->Nodes[Queue->Head++];
+
+        // The level may have grown since the block was queued, it is spread as it is now.
+        U32 NodeIndex;
+        const FChunk* NodeChunk = Light_Locate(Context, Node.X, Node.Y, Node.Z, &NodeIndex);
+        if (NodeChunk == NULL) {
+            continue;
+        }
+
+        const Byte Level = Light_GetLevel(NodeChunk, NodeIndex, Channel);
+        if (Level <= 1) {
+            continue;
+        }
+
+        for (U32 Direction = 0; Direction < 6; Direction++) {
+            const I32 X = Node.X + BlockDirectionOffsets[Direction][0];
+            const I32 Y = Node.Y + BlockDirectionOffsets[Direction][1];
+            const I32 Z = Node.Z + BlockDirectionOffsets[Direction][2];
+            U32 Index;
+            FChunk* Chunk = Light_Locate(Context, X, Y, Z, &Index);
+            if (Chunk == NULL) {
+                continue;
+            }
+
+            const Byte Type = Chunk->Blocks[Index].Type;
+            if (Block_IsSolid(Type)) {
+                continue;
+            }
+
+            const Bool bSky = Channel == LIGHT_CHANNEL_SUN && Direction == YNegative && Level == BLOCK_LIGHT_MAX && Type == BLOCK_TYPE_AIR;
+            const Byte NextLevel = bSky ? BLOCK_LIGHT_MAX : (Byte)(Level - 1);
+            if (Light_GetLevel(Chunk, Index, Channel) >= NextLevel) {
+                continue;
+            }
+
+            Light_SetLevel(Context, Chunk, Index, X, Y, Z, Channel, NextLevel);
+            Light_Push(Queue, X, Y, Z, NextLevel);
+            Context->LitBlocks++;
+        }
+    }
+
+    Queue->Head = 0;
+    FVector_Clear(Queue->Nodes);
+}
+
+void Light_SeedBlock(FLightContext* Context, const I32 X, const I32 Y, const I32 Z) {
+    U32 Index;
+    FChunk* Chunk = Light_Locate(Context, X, Y, Z, &Index);
+    if (Chunk == NULL) {
+        return;
+    }
+
+    // The block loses the light it had, then takes what it emits and what its neighbours spread into it.
+    Light_Remove(Context, Chunk, Index, X, Y, Z, LIGHT_CHANNEL_SUN);
+    Light_Remove(Context, Chunk, Index, X, Y, Z, LIGHT_CHANNEL_BLOCK);
+
+    const Byte Emission = Block_GetEmission(Chunk->Blocks[Index].Type);
+    if (Emission > 0) {
+        Light_SetLevel(Context, Chunk, Index, X, Y, Z, LIGHT_CHANNEL_BLOCK, Emission);
+        Light_Push(&Context->Additions[LIGHT_CHANNEL_BLOCK], X, Y, Z, Emission);
+    }
+
+    // Air at the top of a chunk with nothing above it is open to the sky, as in Light_ComputeChunk.
+    if (Chunk->Blocks[Index].Type == BLOCK_TYPE_AIR && Y == Chunk->Y * CHUNK_SIZE + CHUNK_SIZE - 1 && Light_GetChunk(Context, Chunk->X, Chunk->Y + 1, Chunk->Z) == NULL) {
+        Light_SetLevel(Context, Chunk, Index, X, Y, Z, LIGHT_CHANNEL_SUN, BLOCK_LIGHT_MAX);
+        Light_Push(&Context->Additions[LIGHT_CHANNEL_SUN], X, Y, Z, BLOCK_LIGHT_MAX);
+    }
+
+    for (U32 Direction = 0; Direction < 6; Direction++) {
+        const I32 NeighbourX = X + BlockDirectionOffsets[Direction][0];
+        const I32 NeighbourY = Y + BlockDirectionOffsets[Direction][1];
+        const I32 NeighbourZ = Z + BlockDirectionOffsets[Direction][2];
+        U32 NeighbourIndex;
+        const FChunk* Neighbour = Light_Locate(Context, NeighbourX, NeighbourY, NeighbourZ, &NeighbourIndex);
+        if (Neighbour != NULL) {
+            Light_Spread(Context, Neighbour, NeighbourIndex, NeighbourX, NeighbourY, NeighbourZ);
+        }
+    }
+}
+
+void Light_SeedChunk(FLightContext* Context, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    FChunk* Chunk = Light_GetChunk(Context, ChunkX, ChunkY, ChunkZ);
+    if (Chunk == NULL) {
+        return;
+    }
+
+    const I32 OriginX = ChunkX * CHUNK_SIZE;
+    const I32 OriginY = ChunkY * CHUNK_SIZE;
+    const I32 OriginZ = ChunkZ * CHUNK_SIZE;
+
+    // The chunk was lit under the open sky, sunlight its top doesn't get from the chunk above is taken back.
+    const FChunk* Above = Light_GetChunk(Context, ChunkX, ChunkY + 1, ChunkZ);
+    if (Above != NULL) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                const U32 Top = Chunk_GetBlockIndex(X, CHUNK_SIZE - 1, Z);
+                if (Chunk_GetSunLight(Chunk, Top) == BLOCK_LIGHT_MAX && !Light_IsSky(Above, Chunk_GetBlockIndex(X, 0, Z))) {
+                    Light_Remove(Context, Chunk, Top, OriginX + X, OriginY + CHUNK_SIZE - 1, OriginZ + Z, LIGHT_CHANNEL_SUN);
+                }
+            }
+        }
+        Light_PropagateRemovals(Context, LIGHT_CHANNEL_SUN);
+    }
+
+    // The chunk below may have been lit under the open sky as well, before this chunk covered it.
+    FChunk* Below = Light_GetChunk(Context, ChunkX, ChunkY - 1, ChunkZ);
+    if (Below != NULL) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                const U32 Top = Chunk_GetBlockIndex(X, CHUNK_SIZE - 1, Z);
+                if (Chunk_GetSunLight(Below, Top) == BLOCK_LIGHT_MAX && !Light_IsSky(Chunk, Chunk_GetBlockIndex(X, 0, Z))) {
+                    Light_Remove(Context, Below, Top, OriginX + X, OriginY - 1, OriginZ + Z, LIGHT_CHANNEL_SUN);
+                }
+            }
+        }
+        Light_PropagateRemovals(Context, LIGHT_CHANNEL_SUN);
+    }
+
+    // Light crosses the faces both ways, from the border blocks of the chunk and those of its neighbours.
+    for (U32 Direction = 0; Direction < 6; Direction++) {
+        const U32 Axis = Direction / 2;
+        const U32 AxisU = (Axis + 1) % 3;
+        const U32 AxisV = (Axis + 2) % 3;
+        const I32 Border = BlockDirectionOffsets[Direction][Axis] > 0 ? CHUNK_SIZE - 1 : 0;
+
+        for (I32 V = 0; V < CHUNK_SIZE; V++) {
+            for (I32 U = 0; U < CHUNK_SIZE; U++) {
+                I32 Local[3];
+                Local[Axis] = Border;
+                Local[AxisU] = U;
+                Local[AxisV] = V;
+
+                const I32 X = OriginX + Local[0];
+                const I32 Y = OriginY + Local[1];
+                const I32 Z = OriginZ + Local[2];
+                Light_Spread(Context, Chunk, Chunk_GetBlockIndex(Local[0], Local[1], Local[2]), X, Y, Z);
+
+                const I32 NeighbourX = X + BlockDirectionOffsets[Direction][0];
+                const I32 NeighbourY = Y + BlockDirectionOffsets[Direction][1];
+                const I32 NeighbourZ = Z + BlockDirectionOffsets[Direction][2];
+                U32 NeighbourIndex;
+                const FChunk* Neighbour = Light_Locate(Context, NeighbourX, NeighbourY, NeighbourZ, &NeighbourIndex);
+                if (Neighbour != NULL) {
+                    Light_Spread(Context, Neighbour, NeighbourIndex, NeighbourX, NeighbourY, NeighbourZ);
+                }
+            }
+        }
+    }
+}
+#pragma endregion
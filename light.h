@@ -0,0 +1,52 @@
+#pragma once
+#include "typedefs.h"
+#include "world.h"
+
+/**
+ * Flood fill sunlight and block light of the blocks of a world, stored as nibbles in FChunk::Light. Sunlight enters
+ * chunks with nothing above them and goes straight down through air without dimming, otherwise both lights dim by one
+ * level per block. Solid blocks stop light and lamps emit it. Changes spread from the edited blocks and added chunks
+ * only, light taken away is removed breadth first before the remaining light refills the gap.
+ */
+typedef struct FLight FLight;
+
+/** Called on the updating thread for each chunk whose light changed, with the box of changed blocks local to the chunk. */
+typedef void (*LightChunkHandler)(FChunk* Chunk, const I32 Min[3], const I32 Max[3], void* UserData);
+
+typedef struct {
+    /** Groups of chunk columns propagated separately by the last update, each by one thread. */
+    U32 Islands;
+    /** Block light levels cleared and set by the last update. */
+    U32 RemovedBlocks;
+    U32 LitBlocks;
+    U64 Nanoseconds;
+} FLightStats;
+
+/**
+ * Lights the chunk as if it was alone under the open sky. Run before the chunk is added to the world, then
+ * Light_AddChunk exchanges light with its neighbours. Safe on any thread.
+ */
+void Light_ComputeChunk(FChunk* Chunk);
+
+/** Creates the light of the world and starts its workers, 0 propagates on the updating thread only. Returns NULL on failure. */
+FLight* Light_Create(FWorld* World, U32 WorkerCount, LightChunkHandler OnChunkChanged, void* UserData);
+
+/** Stops the workers and frees the queued changes. */
+void Light_Destroy(FLight* Light);
+
+/** Queues the light exchange of a chunk lit by Light_ComputeChunk and added to the world with its neighbours. */
+void Light_AddChunk(FLight* Light, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Queues the light update of a block whose type changed, at the world block position. */
+void Light_UpdateBlock(FLight* Light, I32 X, I32 Y, I32 Z);
+
+/** Returns True when changes are queued. */
+Bool Light_IsPending(const FLight* Light);
+
+/**
+ * Propagates the queued changes. Changes far enough apart to not reach the same chunks are propagated in parallel.
+ * The light of the chunks must not be read by other threads meanwhile.
+ */
+void Light_Update(FLight* Light);
+
+void Light_GetStats(const FLight* Light, FLightStats* OutStats);
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+#include "light.h"
+#include "terrain.h"
+
+#pragma region Settings
+/** 3x3x3 chunks around the chunk of the terrain surface above the origin. */
+#define LIGHT_TEST_CHUNKS 27
+#define LIGHT_TEST_SEED 1337
+#define LIGHT_TEST_WORKERS 2
+#pragma endregion
+
+typedef struct {
+    FChunk* Chunks[LIGHT_TEST_CHUNKS];
+    FWorld* World;
+    FLight* Light;
+} FLightTestWorld;
+
+#pragma region Private Function Declarations
+static void LightTest_Create(FLightTestWorld* Test, I32 SurfaceChunkY, const FLightTestWorld* Source);
+static void LightTest_Destroy(FLightTestWorld* Test);
+static void LightTest_Set(FLightTestWorld* Test, I32 X, I32 Y, I32 Z, Byte Type);
+static Byte LightTest_GetSunLight(const FLightTestWorld* Test, I32 X, I32 Y, I32 Z);
+static Byte LightTest_GetBlockLight(const FLightTestWorld* Test, I32 X, I32 Y, I32 Z);
+static void LightTest_CheckRecompute(const FLightTestWorld* Test, I32 SurfaceChunkY);
+#pragma endregion
+
+int main() {
+    const I32 Surface = Terrain_GetHeight(0, 0, LIGHT_TEST_SEED);
+    const I32 SurfaceChunkY = World_GetChunkCoordinate(Surface);
+
+    FLightTestWorld Test;
+    LightTest_Create(&Test, SurfaceChunkY, NULL);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    // The block above the surface is lit by the open sky.
+    CHECK(LightTest_GetSunLight(&Test, 0, Surface, 0) == BLOCK_LIGHT_MAX);
+    CHECK(LightTest_GetSunLight(&Test, 0, Surface - 1, 0) == 0);
+
+    // A lamp lights its surroundings one level less per block.
+    LightTest_Set(&Test, 0, Surface + 2, 0, BLOCK_TYPE_LAMP);
+    CHECK(LightTest_GetBlockLight(&Test, 0, Surface + 2, 0) == Block_GetEmission(BLOCK_TYPE_LAMP));
+    CHECK(LightTest_GetBlockLight(&Test, 1, Surface + 2, 0) == Block_GetEmission(BLOCK_TYPE_LAMP) - 1);
+    CHECK(LightTest_GetBlockLight(&Test, 2, Surface + 3, 1) == Block_GetEmission(BLOCK_TYPE_LAMP) - 4);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    // A shaft dug into the ground lets the sunlight straight down without dimming.
+    const I32 Bottom = Surface - 6;
+    for (I32 Y = Surface - 1; Y >= Bottom; Y--) {
+        LightTest_Set(&Test, 5, Y, 5, BLOCK_TYPE_AIR);
+    }
+    CHECK(LightTest_GetSunLight(&Test, 5, Bottom, 5) == BLOCK_LIGHT_MAX);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    // Covering it removes the direct sunlight, the shaft is only lit sideways from the open air around the cover.
+    LightTest_Set(&Test, 5, Surface + 1, 5, BLOCK_TYPE_STONE);
+    CHECK(LightTest_GetSunLight(&Test, 5, Bottom, 5) < BLOCK_LIGHT_MAX);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    // Removing the lamp takes its light away again.
+    LightTest_Set(&Test, 0, Surface + 2, 0, BLOCK_TYPE_AIR);
+    CHECK(LightTest_GetBlockLight(&Test, 0, Surface + 2, 0) == 0);
+    CHECK(LightTest_GetBlockLight(&Test, 2, Surface + 3, 1) == 0);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    // Edits across a chunk border.
+    LightTest_Set(&Test, -1, Surface + 1, -1, BLOCK_TYPE_LAMP);
+    LightTest_Set(&Test, -1, Surface - 1, -1, BLOCK_TYPE_AIR);
+    LightTest_Set(&Test, 0, Surface - 1, -1, BLOCK_TYPE_LAMP);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+    LightTest_Set(&Test, -1, Surface + 1, -1, BLOCK_TYPE_AIR);
+    LightTest_CheckRecompute(&Test, SurfaceChunkY);
+
+    LightTest_Destroy(&Test);
+
+    printf("light_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void LightTest_Create(FLightTestWorld* Test, const I32 SurfaceChunkY, const FLightTestWorld* Source) {
+    Test->World = World_Create();
+    CHECK(Test->World != NULL);
+    Test->Light = Light_Create(Test->World, LIGHT_TEST_WORKERS, NULL, NULL);
+    CHECK(Test->Light != NULL);
+
+    // Chunks are lit alone before they join the world, then exchange light with their neighbours as the stream does.
+    for (I32 Index = 0; Index < LIGHT_TEST_CHUNKS; Index++) {
+        FChunk* Chunk = Chunk_Create(Index % 3 - 1, SurfaceChunkY + 1 - Index / 9, Index / 3 % 3 - 1);
+        CHECK(Chunk != NULL);
+        if (Source != NULL) {
+            memcpy(Chunk->Blocks, Source->Chunks[Index]->Blocks, sizeof Chunk->Blocks);
+            Chunk_UpdateBlockCount(Chunk);
+        } else {
+            Terrain_Generate(Chunk, LIGHT_TEST_SEED);
+        }
+        Light_ComputeChunk(Chunk);
+        World_AddChunk(Test->World, Chunk);
+        Light_AddChunk(Test->Light, Chunk->X, Chunk->Y, Chunk->Z);
+        Test->Chunks[Index] = Chunk;
+    }
+    Light_Update(Test->Light);
+    CHECK(!Light_IsPending(Test->Light));
+}
+
+void LightTest_Destroy(FLightTestWorld* Test) {
+    Light_Destroy(Test->Light);
+    World_Destroy(Test->World);
+    for (I32 Index = 0; Index < LIGHT_TEST_CHUNKS; Index++) {
+        Chunk_Destroy(Test->Chunks[Index]);
+    }
+}
+
+void LightTest_Set(FLightTestWorld* Test, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+    Light_UpdateBlock(Test->Light, X, Y, Z);
+    Light_Update(Test->Light);
+}
+
+Byte LightTest_GetSunLight(const FLightTestWorld* Test, const I32 X, const I32 Y, const I32 Z) {
+    const FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    return Chunk_GetSunLight(Chunk, Chunk_GetBlockIndex(World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z)));
+}
+
+Byte LightTest_GetBlockLight(const FLightTestWorld* Test, const I32 X, const I32 Y, const I32 Z) {
+    const FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    return Chunk_GetBlockLight(Chunk, Chunk_GetBlockIndex(World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z)));
+}
+
+void LightTest_CheckRecompute(const FLightTestWorld* Test, const I32 SurfaceChunkY) {
+    // Lighting the edited blocks from scratch gives the light the edits propagated.
+    FLightTestWorld Reference;
+    LightTest_Create(&Reference, SurfaceChunkY, Test);
+    for (I32 Index = 0; Index < LIGHT_TEST_CHUNKS; Index++) {
+        CHECK(memcmp(Test->Chunks[Index]->Light, Reference.Chunks[Index]->Light, CHUNK_VOLUME) == 0);
+    }
+    LightTest_Destroy(&Reference);
+}
+#pragma endregion
@@ -0,0 +1,341 @@
+#include "lz4.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#pragma region Settings
+/** Shortest match the format can encode. */
+#define LZ4_MIN_MATCH 4
+/** The last literals of a block, a match can't extend into them. */
+#define LZ4_LAST_LITERALS 5
+/** A match can't start closer to the end of the block. */
+#define LZ4_MATCH_FIND_LIMIT 12
+/** Largest offset the format can encode. */
+#define LZ4_MAX_DISTANCE 65535
+/** Match finder hash table size, 2^12 entries fit in L1. */
+#define LZ4_HASH_BITS 12
+/** High compression hash table size. */
+#define LZ4_HIGH_HASH_BITS 15
+/** High compression chain positions searched per match. */
+#define LZ4_HIGH_MAX_ATTEMPTS 64
+#pragma endregion
+
+#pragma region Private Function Declarations
+static U32 Lz4_Read32(const U8* Data);
+static U32 Lz4_Hash(U32 Sequence);
+/** Writes the 255-byte extension of a length that didn't fit the token nibble. */
+static U8* Lz4_WriteLength(U8* Output, U64 Length);
+/** Writes a sequence of literals followed by a match of at least LZ4_MIN_MATCH bytes. */
+static U8* Lz4_WriteSequence(U8* Output, const U8* Literals, U64 LiteralLength, U64 Offset, U64 MatchLength);
+/** Writes the trailing literals that end every block. */
+static U8* Lz4_WriteLastLiterals(U8* Output, const U8* Literals, U64 LiteralLength);
+/** Returns the length of the common prefix, stopping at the limit. */
+static U64 Lz4_CountMatch(const U8* Input, const U8* Match, const U8* Limit);
+static U32 Lz4_HashHigh(U32 Sequence);
+/** Indexes positions up to Input and searches the hash chain for the longest match at Input. */
+static void Lz4_FindLongestMatch(const U8* Source, U32* HashTable, U16* ChainTable, U64* Indexed, const U8* Input, const U8* MatchLimit,
+                                 const U8** OutMatch, U64* OutLength);
+#pragma endregion
+
+#pragma region Public Function Definitions
+U64 Lz4_GetMaxCompressedSize(const U64 Size) {
+    return Size + Size / 255 + 16;
+}
+
+U64 Lz4_Compress(const U8* Source, const U64 SourceSize, U8* Destination, const U64 DestinationCapacity) {
+    if (DestinationCapacity < Lz4_GetMaxCompressedSize(SourceSize)) {
+        return 0;
+    }
+
+    U32 HashTable[1 << LZ4_HASH_BITS];
+    memset(HashTable, 0, sizeof HashTable);
+
+    const U8* Input = Source;
+    const U8* Anchor = Source;
+    const U8* const End = Source + SourceSize;
+    U8* Output = Destination;
+
+    if (SourceSize > LZ4_MATCH_FIND_LIMIT) {
+        const U8* const MatchLimit = End - LZ4_LAST_LITERALS;
+        const U8* const FindLimit = End - LZ4_MATCH_FIND_LIMIT;
+
+        // Position zero marks an empty hash slot, the first byte is never referenced.
+        Input++;
+        while (Input < FindLimit) {
+            const U32 Sequence = Lz4_Read32(Input);
+            const U32 Hash = Lz4_Hash(Sequence);
+            const U8* Match = Source + HashTable[Hash];
+            HashTable[Hash] = (U32)(Input - Source);
+
+            if (Match == Source || Input - Match > LZ4_MAX_DISTANCE || Lz4_Read32(Match) != Sequence) {
+                // Skip faster through incompressible data.
+                Input += 1 + ((Input - Anchor) >> 6);
+                continue;
+            }
+
+            // Extend the match backwards over pending literals.
+            while (Input > Anchor && Match > Source && Input[-1] == Match[-1]) {
+                Input--;
+                Match--;
+            }
+
+            const U8* MatchEnd = Input + LZ4_MIN_MATCH + Lz4_CountMatch(Input + LZ4_MIN_MATCH, Match + LZ4_MIN_MATCH, MatchLimit);
+            Output = Lz4_WriteSequence(Output, Anchor, (U64)(Input - Anchor), (U64)(Input - Match), (U64)(MatchEnd - Input));
+
+            Input = MatchEnd;
+            Anchor = Input;
+
+            // Index a position inside the match so the next search finds repeats.
+            if (Input - 2 > Source) {
+                HashTable[Lz4_Hash(Lz4_Read32(Input - 2))] = (U32)(Input - 2 - Source);
+            }
+        }
+    }
+
+    // The rest of the block goes out as literals.
+    Output = Lz4_WriteLastLiterals(Output, Anchor, (U64)(End - Anchor));
+
+    return (U64)(Output - Destination);
+}
+
+U64 Lz4_CompressHigh(const U8* Source, const U64 SourceSize, U8* Destination, const U64 DestinationCapacity) {
+    if (DestinationCapacity < Lz4_GetMaxCompressedSize(SourceSize)) {
+        return 0;
+    }
+
+    // Hash chains over the 64 KiB window, every position is indexed and searched.
+    U32* HashTable = calloc((size_t)1 << LZ4_HIGH_HASH_BITS, sizeof(U32));
+    U16* ChainTable = malloc((LZ4_MAX_DISTANCE + 1) * sizeof(U16));
+    if (HashTable == NULL || ChainTable == NULL) {
+        free(HashTable);
+        free(ChainTable);
+        return 0;
+    }
+
+    const U8* Input = Source;
+    const U8* Anchor = Source;
+    const U8* const End = Source + SourceSize;
+    U8* Output = Destination;
+
+    if (SourceSize > LZ4_MATCH_FIND_LIMIT) {
+        const U8* const MatchLimit = End - LZ4_LAST_LITERALS;
+        const U8* const FindLimit = End - LZ4_MATCH_FIND_LIMIT;
+        U64 Indexed = 0;
+
+        while (Input < FindLimit) {
+            U64 BestLength = 0;
+            const U8* BestMatch = NULL;
+            Lz4_FindLongestMatch(Source, HashTable, ChainTable, &Indexed, Input, MatchLimit, &BestMatch, &BestLength);
+
+            if (BestLength < LZ4_MIN_MATCH) {
+                Input++;
+                continue;
+            }
+
+            // Lazy matching, a longer match one byte later is worth a literal.
+            if (Input + 1 < FindLimit) {
+                U64 NextLength = 0;
+                const U8* NextMatch = NULL;
+                Lz4_FindLongestMatch(Source, HashTable, ChainTable, &Indexed, Input + 1, MatchLimit, &NextMatch, &NextLength);
+                if (NextLength > BestLength + 1) {
+                    Input++;
+                    continue;
+                }
+            }
+
+            Output = Lz4_WriteSequence(Output, Anchor, (U64)(Input - Anchor), (U64)(Input - BestMatch), BestLength);
+            Input += BestLength;
+            Anchor = Input;
+        }
+    }
+
+    Output = Lz4_WriteLastLiterals(Output, Anchor, (U64)(End - Anchor));
+
+    free(HashTable);
+    free(ChainTable);
+
+    return (U64)(Output - Destination);
+}
+
+I64 Lz4_Decompress(const U8* Source, const U64 SourceSize, U8* Destination, const U64 DestinationCapacity) {
+    const U8* Input = Source;
+    const U8* const InputEnd = Source + SourceSize;
+    U8* Output = Destination;
+    U8* const OutputEnd = Destination + DestinationCapacity;
+
+    while (Input < InputEnd) {
+        const U8 Token = *Input++;
+
+        U64 LiteralLength = Token >> 4;
+        if (LiteralLength == 15) {
+            U8 Byte;
+            do {
+                if (Input >= InputEnd) {
+                    return -1;
+                }
+                Byte = *Input++;
+                LiteralLength += Byte;
+            } while (Byte == 255);
+        }
+
+        if (LiteralLength > (U64)(InputEnd - Input) || LiteralLength > (U64)(OutputEnd - Output)) {
+            return -1;
+        }
+        memcpy(Output, Input, LiteralLength);
+        Input += LiteralLength;
+        Output += LiteralLength;
+
+        // The last sequence has no match.
+        if (Input == InputEnd) {
+            break;
+        }
+
+        if (InputEnd - Input < 2) {
+            return -1;
+        }
+        const U64 Offset = (U64)Input[0] | (U64)Input[1] << 8;
+        Input += 2;
+        if (Offset == 0 || Offset > (U64)(Output - Destination)) {
+            return -1;
+        }
+
+        U64 MatchLength = Token & 0x0F;
+        if (MatchLength == 15) {
+            U8 Byte;
+            do {
+                if (Input >= InputEnd) {
+                    return -1;
+                }
+                Byte = *Input++;
+                MatchLength += Byte;
+            } while (Byte == 255);
+        }
+        MatchLength += LZ4_MIN_MATCH;
+
+        if (MatchLength > (U64)(OutputEnd - Output)) {
+            return -1;
+        }
+
+        // Matches may overlap their own output, copy bytewise when they do.
+        const U8* Match = Output - Offset;
+        if (Offset >= MatchLength) {
+            memcpy(Output, Match, MatchLength);
+            Output += MatchLength;
+        } else {
+            for (U64 Index = 0; Index < MatchLength; Index++) {
+                *Output++ = *Match++;
+            }
+        }
+    }
+
+    return (I64)(Output - Destination);
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+U32 Lz4_Read32(const U8* Data) {
+    U32 Value;
+    memcpy(&Value, Data, sizeof Value);
+    return Value;
+}
+
+U32 Lz4_Hash(const U32 Sequence) {
+    return (Sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+void Lz4_FindLongestMatch(const U8* Source, U32* HashTable, U16* ChainTable, U64* Indexed, const U8* Input, const U8* MatchLimit,
+                          const U8** OutMatch, U64* OutLength) {
+    const U64 Position = (U64)(Input - Source);
+
+    // Index every position up to the current one, the chains link positions of equal hash.
+    for (; *Indexed < Position; (*Indexed)++) {
+        const U32 Hash = Lz4_HashHigh(Lz4_Read32(Source + *Indexed));
+        const U64 Previous = HashTable[Hash];
+        const U64 Delta = Previous == 0 ? 0 : *Indexed + 1 - Previous;
+        ChainTable[*Indexed & LZ4_MAX_DISTANCE] = (U16)(Delta > LZ4_MAX_DISTANCE ? 0 : Delta);
+        HashTable[Hash] = (U32)(*Indexed + 1);
+    }
+
+    *OutLength = 0;
+    *OutMatch = NULL;
+
+    const U32 Sequence = Lz4_Read32(Input);
+    U64 Candidate = HashTable[Lz4_HashHigh(Sequence)];
+    if (Candidate == 0) {
+        return;
+    }
+    Candidate--;
+
+    for (U32 Attempt = 0; Attempt < LZ4_HIGH_MAX_ATTEMPTS && Position - Candidate <= LZ4_MAX_DISTANCE; Attempt++) {
+        const U8* Match = Source + Candidate;
+        if (Lz4_Read32(Match) == Sequence) {
+            const U64 Length = LZ4_MIN_MATCH + Lz4_CountMatch(Input + LZ4_MIN_MATCH, Match + LZ4_MIN_MATCH, MatchLimit);
+            if (Length > *OutLength) {
+                *OutLength = Length;
+                *OutMatch = Match;
+            }
+        }
+
+        const U16 Delta = ChainTable[Candidate & LZ4_MAX_DISTANCE];
+        if (Delta == 0 || Delta > Candidate) {
+            break;
+        }
+        Candidate -= Delta;
+    }
+}
+
+U32 Lz4_HashHigh(const U32 Sequence) {
+    return (Sequence * 2654435761U) >> (32 - LZ4_HIGH_HASH_BITS);
+}
+
+U64 Lz4_CountMatch(const U8* Input, const U8* Match, const U8* Limit) {
+    const U8* const Start = Input;
+    while (Input < Limit && *Input == *Match) {
+        Input++;
+        Match++;
+    }
+
+    return (U64)(Input - Start);
+}
+
+U8* Lz4_WriteSequence(U8* Output, const U8* Literals, const U64 LiteralLength, const U64 Offset, const U64 MatchLength) {
+    const U64 EncodedMatchLength = MatchLength - LZ4_MIN_MATCH;
+
+    U8* Token = Output++;
+    *Token = (U8)((LiteralLength >= 15 ? 15 : LiteralLength) << 4 | (EncodedMatchLength >= 15 ? 15 : EncodedMatchLength));
+    if (LiteralLength >= 15) {
+        Output = Lz4_WriteLength(Output, LiteralLength - 15);
+    }
+    memcpy(Output, Literals, LiteralLength);
+    Output += LiteralLength;
+
+    *Output++ = (U8)(Offset & 0xFF);
+    *Output++ = (U8)(Offset >> 8);
+
+    if (EncodedMatchLength >= 15) {
+        Output = Lz4_WriteLength(Output, EncodedMatchLength - 15);
+    }
+
+    return Output;
+}
+
+U8* Lz4_WriteLastLiterals(U8* Output, const U8* Literals, const U64 LiteralLength) {
+    *Output++ = (U8)((LiteralLength >= 15 ? 15 : LiteralLength) << 4);
+    if (LiteralLength >= 15) {
+        Output = Lz4_WriteLength(Output, LiteralLength - 15);
+    }
+    memcpy(Output, Literals, LiteralLength);
+
+    return Output + LiteralLength;
+}
+
+U8* Lz4_WriteLength(U8* Output, U64 Length) {
+    while (Length >= 255) {
+        *Output++ = 255;
+        Length -= 255;
+    }
+    *Output++ = (U8)Length;
+
+    return Output;
+}
+#pragma endregion
@@ -0,0 +1,17 @@
+#pragma once
+#include "typedefs.h"
+
+/** Returns the worst case compressed size of the input size. */
+U64 Lz4_GetMaxCompressedSize(U64 Size);
+
+/**
+ * Compresses the data into the LZ4 block format, readable by any LZ4 block decoder. Returns the compressed size or 0 if the destination
+ * is too small.
+ */
+U64 Lz4_Compress(const U8* Source, U64 SourceSize, U8* Destination, U64 DestinationCapacity);
+
+/** Compresses slower with a hash chain match finder and lazy matching, for archival data. Same format as Lz4_Compress. */
+U64 Lz4_CompressHigh(const U8* Source, U64 SourceSize, U8* Destination, U64 DestinationCapacity);
+
+/** Decompresses the LZ4 block into the destination. Returns the decompressed size or -1 if the block is malformed or doesn't fit. */
+I64 Lz4_Decompress(const U8* Source, U64 SourceSize, U8* Destination, U64 DestinationCapacity);
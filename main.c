@@ -1,7 +1,14 @@
 #include "application.h"
 
 int main(int argc, char* argv[]) {
-    Application_Initialize();
+    if (!Application_ParseOptions(argc, argv)) {
+        return 2;
+    }
+
+    if (!Application_Initialize()) {
+        return 1;
+    }
+
     Application_Run();
     Application_Shutdown();
     return 0;
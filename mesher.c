@@ -0,0 +1,370 @@
+#include "mesher.h"
+
+#include <string.h>
+
+/** Section size including the one block border taken from the neighbours. */
+#define MESHER_PADDED_SIZE (CHUNK_SECTION_SIZE + 2)
+#define MESHER_PADDED_VOLUME (MESHER_PADDED_SIZE * MESHER_PADDED_SIZE * MESHER_PADDED_SIZE)
+
+#pragma region Private Variables
+/** Face corners for each EDirection, counter-clockwise when looking at the face from outside. */
+static const F32 FaceCorners[6][4][3] = {
+    {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}},
+    {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}},
+    {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}},
+    {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}},
+    {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}},
+    {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}},
+};
+
+/**
+ * Blocks around the block in front of each face, in the plane of the face. Corner C of the face is occluded by ring
+ * blocks 2C and 2C + 2 along its edges and 2C + 1 diagonally, wrapping around after the eighth.
+ */
+static const I32 FaceRings[6][8][3] = {
+    {{1, -1, 0}, {1, -1, -1}, {1, 0, -1}, {1, 1, -1}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}, {1, -1, 1}},
+    {{-1, 0, -1}, {-1, -1, -1}, {-1, -1, 0}, {-1, -1, 1}, {-1, 0, 1}, {-1, 1, 1}, {-1, 1, 0}, {-1, 1, -1}},
+    {{0, 1, -1}, {-1, 1, -1}, {-1, 1, 0}, {-1, 1, 1}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {1, 1, -1}},
+    {{-1, -1, 0}, {-1, -1, -1}, {0, -1, -1}, {1, -1, -1}, {1, -1, 0}, {1, -1, 1}, {0, -1, 1}, {-1, -1, 1}},
+    {{-1, 0, 1}, {-1, -1, 1}, {0, -1, 1}, {1, -1, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}, {-1, 1, 1}},
+    {{0, -1, -1}, {-1, -1, -1}, {-1, 0, -1}, {-1, 1, -1}, {0, 1, -1}, {1, 1, -1}, {1, 0, -1}, {1, -1, -1}},
+};
+
+/** Ring blocks in front of the -u, +u, -v and +v edges of a face, the blocks across the edges are behind them. */
+static const U32 FaceEdgeRings[4] = {0, 4, 2, 6};
+
+/**
+ * Corner occlusion by the solid bits of its edge, diagonal and other edge block, 3 for an open corner down to 0. Two
+ * solid edges close the corner whatever the diagonal is.
+ */
+static const Byte CornerOcclusion[8] = {3, 2, 2, 1, 2, 0, 1, 0};
+
+/** Padded array strides for each EDirection. */
+static const I32 DirectionStrides[6] = {1, -1, MESHER_PADDED_SIZE * MESHER_PADDED_SIZE, -MESHER_PADDED_SIZE * MESHER_PADDED_SIZE, MESHER_PADDED_SIZE, -MESHER_PADDED_SIZE};
+
+/** Brightness of the corner by its occlusion. */
+static const F32 OcclusionCurve[4] = {0.45f, 0.65f, 0.82f, 1.f};
+
+/** Face texture coordinates. */
+static const F32 FaceTexCoords[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+/** Material layers of the chunk texture array by EBlockType, tiles of the texture atlas row by row. */
+static const F32 BlockMaterials[BLOCK_TYPE_COUNT] = {0.f, 3.f, 1.f, 8.f, 6.f, 9.f, 2.f};
+
+/** Block colors by EBlockType. */
+static const F32 BlockColors[BLOCK_TYPE_COUNT][3] = {
+    {0.f, 0.f, 0.f},
+    {0.50f, 0.50f, 0.50f},
+    {0.45f, 0.30f, 0.15f},
+    {0.30f, 0.60f, 0.20f},
+    {0.85f, 0.80f, 0.55f},
+    {0.20f, 0.35f, 0.80f},
+    {1.00f, 0.85f, 0.45f},
+};
+
+/** Face brightness by light level, each level dims by a fifth. Level 0 keeps a little so unlit caves aren't black. */
+static const F32 LightCurve[BLOCK_LIGHT_MAX + 1] = {
+    0.035f, 0.044f, 0.055f, 0.069f, 0.086f, 0.107f, 0.134f, 0.168f, 0.210f, 0.262f, 0.328f, 0.410f, 0.512f, 0.640f, 0.800f, 1.000f,
+};
+#pragma endregion
+
+/** Padded blocks of a section and the strides to walk them, shared by the mesh and the face record builders. */
+typedef struct {
+    I32 BaseX;
+    I32 BaseY;
+    I32 BaseZ;
+    Byte Types[MESHER_PADDED_VOLUME];
+    Byte Lights[MESHER_PADDED_VOLUME];
+    /** Solid bits of the padded blocks, read eight times per face by the occlusion. */
+    Byte Solid[MESHER_PADDED_VOLUME];
+    /** Padded array strides for the face rings of each EDirection. */
+    I32 RingStrides[6][8];
+} FMesherSection;
+
+#pragma region Private Function Declarations
+/** Copies section block types and light with a one block border into the padded arrays. */
+static void Mesher_GatherSection(const FChunkNeighbourhood* Neighbourhood, I32 BaseX, I32 BaseY, I32 BaseZ, Byte* OutTypes, Byte* OutLights);
+
+/** Gathers the section and its strides. Returns False if the center chunk has no blocks. */
+static inline Bool Mesher_PrepareSection(const FChunkNeighbourhood* Neighbourhood, const U32 Section, FMesherSection* OutSection) {
+    const FChunk* Chunk = Neighbourhood->Chunks[CHUNK_NEIGHBOURHOOD_CENTER];
+    if (Chunk == NULL || Chunk->BlockCount == 0) {
+        return False;
+    }
+
+    Mesher_GetSectionOrigin(Section, &OutSection->BaseX, &OutSection->BaseY, &OutSection->BaseZ);
+    Mesher_GatherSection(Neighbourhood, OutSection->BaseX, OutSection->BaseY, OutSection->BaseZ, OutSection->Types, OutSection->Lights);
+
+    for (U32 Direction = 0; Direction < 6; Direction++) {
+        for (U32 Ring = 0; Ring < 8; Ring++) {
+            const I32* Offset = FaceRings[Direction][Ring];
+            OutSection->RingStrides[Direction][Ring] = (Offset[1] * MESHER_PADDED_SIZE + Offset[2]) * MESHER_PADDED_SIZE + Offset[0];
+        }
+    }
+
+    for (I32 Index = 0; Index < MESHER_PADDED_VOLUME; Index++) {
+        OutSection->Solid[Index] = Block_IsSolid(OutSection->Types[Index]);
+    }
+
+    return True;
+}
+
+/** Returns the number of visible faces of the section. */
+static U32 Mesher_CountFaces(const FMesherSection* Section);
+
+/** Returns the occlusion of the four face corners packed in 2 bits each, from the solid bits of the face ring. */
+static inline Byte Mesher_GetFaceOcclusion(const U32 RingMask) {
+    // Doubling the mask lets the window of the last corner wrap around to the first ring block.
+    const U32 Wrapped = RingMask | RingMask << 8;
+    return (Byte)(CornerOcclusion[Wrapped & 7] | CornerOcclusion[Wrapped >> 2 & 7] << 2 | CornerOcclusion[Wrapped >> 4 & 7] << 4 |
+                  CornerOcclusion[Wrapped >> 6 & 7] << 6);
+}
+
+/** Returns the occlusion of the face of the padded block with the ring strides of the face direction. */
+static inline Byte Mesher_GetOcclusion(const Byte* Solid, const I32* Ring, const I32 Index) {
+    const U32 RingMask = Solid[Index + Ring[0]] | Solid[Index + Ring[1]] << 1 | Solid[Index + Ring[2]] << 2 | Solid[Index + Ring[3]] << 3 |
+                         Solid[Index + Ring[4]] << 4 | Solid[Index + Ring[5]] << 5 | Solid[Index + Ring[6]] << 6 | Solid[Index + Ring[7]] << 7;
+    return Mesher_GetFaceOcclusion(RingMask);
+}
+
+/** Returns the light level of the face, the brighter of sunlight and block light of the block in front of it. */
+static inline Byte Mesher_GetLightLevel(const Byte Light) {
+    return (Light >> 4) > (Light & 0x0F) ? Light >> 4 : Light & 0x0F;
+}
+
+/** Returns True if the face of the block towards the neighbour is visible. */
+static inline Bool Mesher_IsFaceVisible(const Byte Type, const Byte NeighbourType) {
+    return !Block_IsSolid(NeighbourType) && NeighbourType != Type;
+}
+
+/**
+ * Returns the material layers the face smudges into across its -u, +u, -v and +v edges, 6 bits each in a float that
+ * holds them exactly. A block across an edge lends its layer when its face in the same direction is visible.
+ */
+static inline F32 Mesher_GetSmudgeLayers(const Byte* Types, const I32* Ring, const I32 Stride, const I32 Index, const F32 Material) {
+    U32 Packed = 0;
+    for (U32 Edge = 0; Edge < 4; Edge++) {
+        const I32 Front = Index + Ring[FaceEdgeRings[Edge]];
+        const Byte Type = Types[Front - Stride];
+        const Bool bLends = Type != BLOCK_TYPE_AIR && Type < BLOCK_TYPE_COUNT && Mesher_IsFaceVisible(Type, Types[Front]);
+        Packed |= (U32)(bLends ? BlockMaterials[Type] : Material) << Edge * 6;
+    }
+    return (F32)Packed;
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Mesher_BuildSection(const FChunkNeighbourhood* Neighbourhood, const U32 Section, FShape* OutShape) {
+    Shape_Clear(OutShape);
+
+    FMesherSection Padded;
+    if (!Mesher_PrepareSection(Neighbourhood, Section, &Padded)) {
+        return;
+    }
+
+    // Count visible faces first so the shape buffers are allocated once.
+    const U32 FaceCount = Mesher_CountFaces(&Padded);
+    if (FaceCount == 0) {
+        return;
+    }
+
+    FVector_Reserve(OutShape->Vertices, FaceCount * 4 * 3);
+    FVector_Reserve(OutShape->Colors, FaceCount * 4 * 3);
+    FVector_Reserve(OutShape->TexCoords, FaceCount * 4 * SHAPE_TEXCOORD_COMPONENTS);
+    FVector_Reserve(OutShape->Normals, FaceCount * 4 * 3);
+    FVector_Reserve(OutShape->Indices, FaceCount * 6);
+
+    F32* Vertices = OutShape->Vertices;
+    F32* Colors = OutShape->Colors;
+    F32* TexCoords = OutShape->TexCoords;
+    F32* Normals = OutShape->Normals;
+    U16* Indices = OutShape->Indices;
+    U32 VertexCount = 0;
+
+    const Byte* Types = Padded.Types;
+    const Byte* Lights = Padded.Lights;
+    for (I32 Y = 1; Y <= CHUNK_SECTION_SIZE; Y++) {
+        for (I32 Z = 1; Z <= CHUNK_SECTION_SIZE; Z++) {
+            I32 Index = (Y * MESHER_PADDED_SIZE + Z) * MESHER_PADDED_SIZE + 1;
+            for (I32 X = 1; X <= CHUNK_SECTION_SIZE; X++, Index++) {
+                const Byte Type = Types[Index];
+                if (Type == BLOCK_TYPE_AIR) {
+                    continue;
+                }
+
+                const F32 BlockX = (F32)(Padded.BaseX + X - 1);
+                const F32 BlockY = (F32)(Padded.BaseY + Y - 1);
+                const F32 BlockZ = (F32)(Padded.BaseZ + Z - 1);
+                const F32* Color = BlockColors[Type < BLOCK_TYPE_COUNT ? Type : BLOCK_TYPE_STONE];
+                const F32 Material = BlockMaterials[Type < BLOCK_TYPE_COUNT ? Type : BLOCK_TYPE_STONE];
+
+                for (U32 Direction = 0; Direction < 6; Direction++) {
+                    if (!Mesher_IsFaceVisible(Type, Types[Index + DirectionStrides[Direction]])) {
+                        continue;
+                    }
+
+                    // Faces are lit by the block in front of them.
+                    const F32 Brightness = LightCurve[Mesher_GetLightLevel(Lights[Index + DirectionStrides[Direction]])];
+                    const Byte Occlusion = Mesher_GetOcclusion(Padded.Solid, Padded.RingStrides[Direction], Index);
+                    const F32 SmudgeLayers = Mesher_GetSmudgeLayers(Types, Padded.RingStrides[Direction], DirectionStrides[Direction], Index, Material);
+
+                    for (U32 Corner = 0; Corner < 4; Corner++) {
+                        *Vertices++ = BlockX + FaceCorners[Direction][Corner][0];
+                        *Vertices++ = BlockY + FaceCorners[Direction][Corner][1];
+                        *Vertices++ = BlockZ + FaceCorners[Direction][Corner][2];
+
+                        const F32 CornerBrightness = Brightness * OcclusionCurve[Occlusion >> Corner * 2 & 3];
+                        *Colors++ = Color[0] * CornerBrightness;
+                        *Colors++ = Color[1] * CornerBrightness;
+                        *Colors++ = Color[2] * CornerBrightness;
+
+                        *TexCoords++ = FaceTexCoords[Corner][0];
+                        *TexCoords++ = FaceTexCoords[Corner][1];
+                        *TexCoords++ = Material;
+                        *TexCoords++ = SmudgeLayers;
+
+                        *Normals++ = (F32)BlockDirectionOffsets[Direction][0];
+                        *Normals++ = (F32)BlockDirectionOffsets[Direction][1];
+                        *Normals++ = (F32)BlockDirectionOffsets[Direction][2];
+                    }
+
+                    // The quad is split along its brighter diagonal, so the occlusion of a single corner doesn't streak across it.
+                    // The face shader splits face records the same way.
+                    const U32 First = (Occlusion & 3) + (Occlusion >> 4 & 3) < (Occlusion >> 2 & 3) + (Occlusion >> 6) ? 1 : 0;
+                    *Indices++ = (U16)(VertexCount + First);
+                    *Indices++ = (U16)(VertexCount + First + 1);
+                    *Indices++ = (U16)(VertexCount + First + 2);
+                    *Indices++ = (U16)(VertexCount + First);
+                    *Indices++ = (U16)(VertexCount + (First + 2) % 4);
+                    *Indices++ = (U16)(VertexCount + (First + 3) % 4);
+                    VertexCount += 4;
+                }
+            }
+        }
+    }
+
+    FVector_SetSize(OutShape->Vertices, FaceCount * 4 * 3);
+    FVector_SetSize(OutShape->Colors, FaceCount * 4 * 3);
+    FVector_SetSize(OutShape->TexCoords, FaceCount * 4 * SHAPE_TEXCOORD_COMPONENTS);
+    FVector_SetSize(OutShape->Normals, FaceCount * 4 * 3);
+    FVector_SetSize(OutShape->Indices, FaceCount * 6);
+}
+
+void Mesher_BuildChunk(const FChunkNeighbourhood* Neighbourhood, FShape OutShapes[CHUNK_SECTION_COUNT]) {
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Mesher_BuildSection(Neighbourhood, Section, &OutShapes[Section]);
+    }
+}
+
+void Mesher_BuildSectionFaces(const FChunkNeighbourhood* Neighbourhood, const U32 Section, FShape* OutShape) {
+    Shape_Clear(OutShape);
+
+    FMesherSection Padded;
+    if (!Mesher_PrepareSection(Neighbourhood, Section, &Padded)) {
+        return;
+    }
+
+    const U32 FaceCount = Mesher_CountFaces(&Padded);
+    if (FaceCount == 0) {
+        return;
+    }
+
+    FVector_Reserve(OutShape->Faces, FaceCount);
+    U32* Faces = OutShape->Faces;
+
+    const Byte* Types = Padded.Types;
+    const Byte* Lights = Padded.Lights;
+    for (I32 Y = 1; Y <= CHUNK_SECTION_SIZE; Y++) {
+        for (I32 Z = 1; Z <= CHUNK_SECTION_SIZE; Z++) {
+            I32 Index = (Y * MESHER_PADDED_SIZE + Z) * MESHER_PADDED_SIZE + 1;
+            for (I32 X = 1; X <= CHUNK_SECTION_SIZE; X++, Index++) {
+                const Byte Type = Types[Index];
+                if (Type == BLOCK_TYPE_AIR) {
+                    continue;
+                }
+
+                const Byte FaceType = Type < BLOCK_TYPE_COUNT ? Type : BLOCK_TYPE_STONE;
+                for (U32 Direction = 0; Direction < 6; Direction++) {
+                    if (!Mesher_IsFaceVisible(Type, Types[Index + DirectionStrides[Direction]])) {
+                        continue;
+                    }
+
+                    const Byte Light = Mesher_GetLightLevel(Lights[Index + DirectionStrides[Direction]]);
+                    const Byte Occlusion = Mesher_GetOcclusion(Padded.Solid, Padded.RingStrides[Direction], Index);
+                    *Faces++ = MESHER_PACK_FACE(X - 1, Y - 1, Z - 1, Direction, FaceType, Occlusion, Light);
+                }
+            }
+        }
+    }
+
+    FVector_SetSize(OutShape->Faces, FaceCount);
+}
+
+void Mesher_BuildChunkFaces(const FChunkNeighbourhood* Neighbourhood, FShape OutShapes[CHUNK_SECTION_COUNT]) {
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Mesher_BuildSectionFaces(Neighbourhood, Section, &OutShapes[Section]);
+    }
+}
+
+void Mesher_GetFacePalette(FMesherFacePalette* OutPalette) {
+    memcpy(OutPalette->Colors, BlockColors, sizeof OutPalette->Colors);
+    memcpy(OutPalette->Materials, BlockMaterials, sizeof OutPalette->Materials);
+    memcpy(OutPalette->LightCurve, LightCurve, sizeof OutPalette->LightCurve);
+    memcpy(OutPalette->OcclusionCurve, OcclusionCurve, sizeof OutPalette->OcclusionCurve);
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+U32 Mesher_CountFaces(const FMesherSection* Section) {
+    U32 FaceCount = 0;
+    for (I32 Y = 1; Y <= CHUNK_SECTION_SIZE; Y++) {
+        for (I32 Z = 1; Z <= CHUNK_SECTION_SIZE; Z++) {
+            I32 Index = (Y * MESHER_PADDED_SIZE + Z) * MESHER_PADDED_SIZE + 1;
+            for (I32 X = 1; X <= CHUNK_SECTION_SIZE; X++, Index++) {
+                const Byte Type = Section->Types[Index];
+                if (Type == BLOCK_TYPE_AIR) {
+                    continue;
+                }
+
+                for (U32 Direction = 0; Direction < 6; Direction++) {
+                    FaceCount += Mesher_IsFaceVisible(Type, Section->Types[Index + DirectionStrides[Direction]]);
+                }
+            }
+        }
+    }
+
+    return FaceCount;
+}
+
+void Mesher_GatherSection(const FChunkNeighbourhood* Neighbourhood, const I32 BaseX, const I32 BaseY, const I32 BaseZ, Byte* OutTypes, Byte* OutLights) {
+    const FChunk* Chunk = Neighbourhood->Chunks[CHUNK_NEIGHBOURHOOD_CENTER];
+
+    for (I32 Y = 0; Y < MESHER_PADDED_SIZE; Y++) {
+        for (I32 Z = 0; Z < MESHER_PADDED_SIZE; Z++) {
+            Byte* Row = &OutTypes[(Y * MESHER_PADDED_SIZE + Z) * MESHER_PADDED_SIZE];
+            Byte* LightRow = &OutLights[(Y * MESHER_PADDED_SIZE + Z) * MESHER_PADDED_SIZE];
+            const I32 ChunkY = BaseY + Y - 1;
+            const I32 ChunkZ = BaseZ + Z - 1;
+
+            // Rows inside the center chunk are copied without neighbour lookups, only the border columns may cross.
+            if (Chunk_IsInside(0, ChunkY, ChunkZ)) {
+                const U32 RowIndex = Chunk_GetBlockIndex(0, ChunkY, ChunkZ);
+                const FBlock* Blocks = &Chunk->Blocks[RowIndex];
+                for (I32 X = 1; X <= CHUNK_SECTION_SIZE; X++) {
+                    Row[X] = Blocks[BaseX + X - 1].Type;
+                }
+                memcpy(&LightRow[1], &Chunk->Light[RowIndex + BaseX], CHUNK_SECTION_SIZE);
+                Row[0] = Chunk_GetNeighbourhoodBlockType(Neighbourhood, BaseX - 1, ChunkY, ChunkZ);
+                Row[MESHER_PADDED_SIZE - 1] = Chunk_GetNeighbourhoodBlockType(Neighbourhood, BaseX + CHUNK_SECTION_SIZE, ChunkY, ChunkZ);
+                LightRow[0] = Chunk_GetNeighbourhoodLight(Neighbourhood, BaseX - 1, ChunkY, ChunkZ);
+                LightRow[MESHER_PADDED_SIZE - 1] = Chunk_GetNeighbourhoodLight(Neighbourhood, BaseX + CHUNK_SECTION_SIZE, ChunkY, ChunkZ);
+            } else {
+                for (I32 X = 0; X < MESHER_PADDED_SIZE; X++) {
+                    Row[X] = Chunk_GetNeighbourhoodBlockType(Neighbourhood, BaseX + X - 1, ChunkY, ChunkZ);
+                    LightRow[X] = Chunk_GetNeighbourhoodLight(Neighbourhood, BaseX + X - 1, ChunkY, ChunkZ);
+                }
+            }
+        }
+    }
+}
+#pragma endregion
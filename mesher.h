@@ -0,0 +1,56 @@
+#pragma once
+#include "typedefs.h"
+#include "chunk.h"
+#include "shape.h"
+
+/**
+ * Visible face packed into 32 bits for the vertex pulling renderer, see Mesher_BuildSectionFaces. Bits 0-11 are the x,
+ * y and z of the block within its section, 4 bits each, bits 12-14 the EDirection of the face and bits 15-19 the
+ * EBlockType. Bits 20-27 are the occlusion of the four face corners, 2 bits each as in the mesh colors, and bits 28-31
+ * the light level of the block in front of the face.
+ */
+#define MESHER_PACK_FACE(X, Y, Z, Direction, Type, Occlusion, Light)                                                                     \
+    ((U32)(X) | (U32)(Y) << 4 | (U32)(Z) << 8 | (U32)(Direction) << 12 | (U32)(Type) << 15 | (U32)(Occlusion) << 20 | (U32)(Light) << 28)
+
+/** Values the face shader needs to turn face records into the colors Mesher_BuildSection bakes into vertices. */
+typedef struct {
+    /** Block colors and material layers by EBlockType. */
+    F32 Colors[BLOCK_TYPE_COUNT][3];
+    F32 Materials[BLOCK_TYPE_COUNT];
+    /** Brightness by light level and by corner occlusion. */
+    F32 LightCurve[BLOCK_LIGHT_MAX + 1];
+    F32 OcclusionCurve[4];
+} FMesherFacePalette;
+
+/** Returns the index of the section containing the local block position. */
+static inline U32 Mesher_GetSectionIndex(const I32 X, const I32 Y, const I32 Z) {
+    return ((U32)(Y / CHUNK_SECTION_SIZE) * CHUNK_SECTIONS_PER_AXIS + (U32)(Z / CHUNK_SECTION_SIZE)) * CHUNK_SECTIONS_PER_AXIS + (U32)(X / CHUNK_SECTION_SIZE);
+}
+
+/**
+ * Builds the mesh of a single section of the neighbourhood center chunk into the shape, the shape is cleared first.
+ * Faces hidden by solid blocks are culled, across chunk borders too. Vertex positions are local to the chunk. Vertex
+ * colors are the block color lit by the block in front of the face and darkened by the solid blocks around the corner.
+ */
+void Mesher_BuildSection(const FChunkNeighbourhood* Neighbourhood, U32 Section, FShape* OutShape);
+
+/** Builds meshes of all sections of the neighbourhood center chunk. */
+void Mesher_BuildChunk(const FChunkNeighbourhood* Neighbourhood, FShape OutShapes[CHUNK_SECTION_COUNT]);
+
+/**
+ * Builds the face records of a single section into the shape faces, the shape is cleared first. Faces are culled and
+ * lit as by Mesher_BuildSection, each record replaces the four vertices and six indices of its quad.
+ */
+void Mesher_BuildSectionFaces(const FChunkNeighbourhood* Neighbourhood, U32 Section, FShape* OutShape);
+
+/** Builds face records of all sections of the neighbourhood center chunk. */
+void Mesher_BuildChunkFaces(const FChunkNeighbourhood* Neighbourhood, FShape OutShapes[CHUNK_SECTION_COUNT]);
+
+/** Returns the origin of the section within its chunk, which the face record positions are relative to. */
+static inline void Mesher_GetSectionOrigin(const U32 Section, I32* OutX, I32* OutY, I32* OutZ) {
+    *OutX = (I32)(Section % CHUNK_SECTIONS_PER_AXIS) * CHUNK_SECTION_SIZE;
+    *OutZ = (I32)(Section / CHUNK_SECTIONS_PER_AXIS % CHUNK_SECTIONS_PER_AXIS) * CHUNK_SECTION_SIZE;
+    *OutY = (I32)(Section / (CHUNK_SECTIONS_PER_AXIS * CHUNK_SECTIONS_PER_AXIS)) * CHUNK_SECTION_SIZE;
+}
+
+void Mesher_GetFacePalette(FMesherFacePalette* OutPalette);
@@ -0,0 +1,117 @@
+#include "overlay.h"
+
+#include "containers/vector.h"
+
+#pragma region Settings
+/** Glyphs of the printable ASCII characters, 3x5 bits from the top left, the top row in the highest bits. */
+#define OVERLAY_GLYPH_FIRST 32
+#define OVERLAY_GLYPH_COUNT 96
+static const U16 OverlayGlyphs[OVERLAY_GLYPH_COUNT] = {
+    ['%' - 32] = 0x52A5, ['(' - 32] = 0x1491, [')' - 32] = 0x4494, ['+' - 32] = 0x05D0, [',' - 32] = 0x0014,
+    ['-' - 32] = 0x01C0, ['.' - 32] = 0x0002, ['/' - 32] = 0x12A4, ['0' - 32] = 0x7B6F, ['1' - 32] = 0x2C97,
+    ['2' - 32] = 0x73E7, ['3' - 32] = 0x72CF, ['4' - 32] = 0x5BC9, ['5' - 32] = 0x79CF, ['6' - 32] = 0x79EF,
+    ['7' - 32] = 0x7249, ['8' - 32] = 0x7BEF, ['9' - 32] = 0x7BCF, [':' - 32] = 0x0410, ['=' - 32] = 0x0E38,
+    ['A' - 32] = 0x2BED, ['B' - 32] = 0x6BAE, ['C' - 32] = 0x3923, ['D' - 32] = 0x6B6E, ['E' - 32] = 0x79A7,
+    ['F' - 32] = 0x79A4, ['G' - 32] = 0x396B, ['H' - 32] = 0x5BED, ['I' - 32] = 0x7497, ['J' - 32] = 0x126A,
+    ['K' - 32] = 0x5BAD, ['L' - 32] = 0x4927, ['M' - 32] = 0x5FED, ['N' - 32] = 0x6B6D, ['O' - 32] = 0x2B6A,
+    ['P' - 32] = 0x6BA4, ['Q' - 32] = 0x2B73, ['R' - 32] = 0x6BAD, ['S' - 32] = 0x388E, ['T' - 32] = 0x7492,
+    ['U' - 32] = 0x5B6F, ['V' - 32] = 0x5B52, ['W' - 32] = 0x5BFD, ['X' - 32] = 0x5AAD, ['Y' - 32] = 0x5A92,
+    ['Z' - 32] = 0x72A7, ['|' - 32] = 0x2492,
+};
+#pragma endregion
+
+#pragma region Private Variables
+static FVector(FOverlayVertex) OverlayVertices = NULL;
+#pragma endregion
+
+#pragma region Private Function Declarations
+static void Overlay_AddVertex(F32 X, F32 Y, U32 Color);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Overlay_Clear() {
+    FVector_Clear(OverlayVertices);
+}
+
+void Overlay_Shutdown() {
+    FVector_Free(OverlayVertices);
+    OverlayVertices = NULL;
+}
+
+void Overlay_AddRect(const F32 X, const F32 Y, const F32 Width, const F32 Height, const U32 Color) {
+    Overlay_AddVertex(X, Y, Color);
+    Overlay_AddVertex(X, Y + Height, Color);
+    Overlay_AddVertex(X + Width, Y + Height, Color);
+    Overlay_AddVertex(X, Y, Color);
+    Overlay_AddVertex(X + Width, Y + Height, Color);
+    Overlay_AddVertex(X + Width, Y, Color);
+}
+
+F32 Overlay_AddText(const F32 X, const F32 Y, const F32 Scale, const pStr Text, const U32 Color) {
+    F32 Left = X;
+    for (const char* Character = Text; *Character != '\0'; Character++) {
+        U32 Code = (U8)*Character;
+        if (Code >= 'a' && Code <= 'z') {
+            Code -= 'a' - 'A';
+        }
+
+        const U16 Glyph = Code >= OVERLAY_GLYPH_FIRST && Code < OVERLAY_GLYPH_FIRST + OVERLAY_GLYPH_COUNT ? OverlayGlyphs[Code - OVERLAY_GLYPH_FIRST] : 0;
+
+        // Runs of set pixels in a row are one rectangle.
+        for (U32 Row = 0; Row < OVERLAY_GLYPH_HEIGHT; Row++) {
+            for (U32 Column = 0; Column < OVERLAY_GLYPH_WIDTH;) {
+                const U32 Bit = OVERLAY_GLYPH_WIDTH * OVERLAY_GLYPH_HEIGHT - 1 - (Row * OVERLAY_GLYPH_WIDTH + Column);
+                if ((Glyph >> Bit & 1) == 0) {
+                    Column++;
+                    continue;
+                }
+
+                U32 End = Column + 1;
+                while (End < OVERLAY_GLYPH_WIDTH && (Glyph >> (Bit - (End - Column)) & 1) != 0) {
+                    End++;
+                }
+
+                Overlay_AddRect(Left + (F32)Column * Scale, Y + (F32)Row * Scale, (F32)(End - Column) * Scale, Scale, Color);
+                Column = End;
+            }
+        }
+
+        Left += (OVERLAY_GLYPH_WIDTH + 1) * Scale;
+    }
+
+    return Left - X;
+}
+
+void Overlay_AddGraph(const F32 X, const F32 Y, const F32 Width, const F32 Height, const F32* Values, const U32 Count, const F32 Max, const F32 Limit,
+                      const U32 Color, const U32 OverColor) {
+    if (Count == 0 || Max <= 0.f) {
+        return;
+    }
+
+    const F32 BarWidth = Width / (F32)Count;
+    for (U32 Index = 0; Index < Count; Index++) {
+        const F32 Value = Values[Index] < Max ? Values[Index] : Max;
+        const F32 BarHeight = Value > 0.f ? Value / Max * Height : 0.f;
+        Overlay_AddRect(X + (F32)Index * BarWidth, Y + Height - BarHeight, BarWidth, BarHeight, Values[Index] > Limit ? OverColor : Color);
+    }
+
+    if (Limit > 0.f && Limit < Max) {
+        Overlay_AddRect(X, Y + Height - Limit / Max * Height, Width, 1.f, OverColor);
+    }
+}
+
+const FOverlayVertex* Overlay_GetVertices(U32* OutCount) {
+    *OutCount = (U32)FVector_GetSize(OverlayVertices);
+    return OverlayVertices;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void Overlay_AddVertex(const F32 X, const F32 Y, const U32 Color) {
+    if (FVector_GetSize(OverlayVertices) == FVector_GetCapacity(OverlayVertices)) {
+        const size_t Capacity = FVector_GetCapacity(OverlayVertices) * 2 + 1024;
+        FVector_Reserve(OverlayVertices, Capacity);
+    }
+    FVector_Add(OverlayVertices, ((FOverlayVertex){X, Y, Color}));
+}
+#pragma endregion
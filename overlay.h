@@ -0,0 +1,41 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Geometry of the performance overlay: rectangles, text in a built-in 3x5 pixel font and bar graphs, all as colored
+ * triangles in one vertex list so the overlay is a single draw. Positions are in pixels from the top left corner.
+ */
+#define OVERLAY_GLYPH_WIDTH 3
+#define OVERLAY_GLYPH_HEIGHT 5
+
+/** Packs a color in the byte order of the vertex color attribute. */
+#define OVERLAY_COLOR(R, G, B, A) ((U32)(R) | (U32)(G) << 8 | (U32)(B) << 16 | (U32)(A) << 24)
+
+typedef struct {
+    F32 X;
+    F32 Y;
+    U32 Color;
+} FOverlayVertex;
+
+/** Starts a new overlay, keeping the memory of the vertices. */
+void Overlay_Clear();
+
+/** Frees the vertices. */
+void Overlay_Shutdown();
+
+void Overlay_AddRect(F32 X, F32 Y, F32 Width, F32 Height, U32 Color);
+
+/**
+ * Adds a line of text with glyphs scaled to Scale pixels per font pixel, lower case letters are drawn upper case and
+ * characters the font lacks as spaces. Returns the width of the line.
+ */
+F32 Overlay_AddText(F32 X, F32 Y, F32 Scale, pStr Text, U32 Color);
+
+/**
+ * Adds a bar for each value, growing up from the bottom of the box, with Max at the top. Bars over the limit take the
+ * over color, and the limit is marked by a line.
+ */
+void Overlay_AddGraph(F32 X, F32 Y, F32 Width, F32 Height, const F32* Values, U32 Count, F32 Max, F32 Limit, U32 Color, U32 OverColor);
+
+/** Returns the triangles added since Overlay_Clear, three vertices each. */
+const FOverlayVertex* Overlay_GetVertices(U32* OutCount);
@@ -0,0 +1,185 @@
+#include "pace.h"
+
+#include <math.h>
+
+#include "clock.h"
+
+#pragma region Settings
+/** Frames the statistics are taken over. */
+#define PACE_WINDOW 120
+/** Swaps a swap control window takes, and the late swaps in a window switching vsync to adaptive. */
+#define PACE_SWAP_WINDOW 60
+#define PACE_SWAP_LATE_FRAMES 6
+#pragma endregion
+
+#pragma region Private Variables
+static FPaceSettings PaceSettings;
+static Bool bPaceIdle = False;
+static U64 PaceDeadline = 0;
+static U64 PaceFrameStart = 0;
+static U64 PaceSpinNanoseconds = 0;
+
+/** Rings of the last work and frame times, and whether the frames started late. */
+static U64 PaceWorkTimes[PACE_WINDOW];
+static U64 PaceFrameTimes[PACE_WINDOW];
+static Bool PaceLateFrames[PACE_WINDOW];
+static U32 PaceWorkCount = 0;
+static U32 PaceFrameCount = 0;
+#pragma endregion
+
+#pragma region Private Function Declarations
+/** Returns the frame time in use, 0 when uncapped. */
+static U64 Pace_GetFrameNanoseconds();
+
+static void Pace_GetDistribution(const U64* Times, U32 Count, F64* OutMean, F64* OutDeviation);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Pace_GetDefaultSettings(FPaceSettings* OutSettings) {
+    OutSettings->FrameNanoseconds = 16666667;
+    OutSettings->IdleFrameNanoseconds = 100000000;
+    OutSettings->MinSpinNanoseconds = 500000;
+    OutSettings->MaxSpinNanoseconds = 4000000;
+}
+
+void Pace_Initialize(const FPaceSettings* Settings) {
+    PaceSettings = *Settings;
+    bPaceIdle = False;
+    PaceSpinNanoseconds = Settings->MinSpinNanoseconds;
+    PaceFrameStart = 0;
+    PaceWorkCount = 0;
+    PaceFrameCount = 0;
+    PaceDeadline = Clock_GetNanoseconds();
+}
+
+void Pace_SetFrameNanoseconds(const U64 FrameNanoseconds) {
+    PaceSettings.FrameNanoseconds = FrameNanoseconds;
+}
+
+void Pace_SetIdle(const Bool bIdle) {
+    bPaceIdle = bIdle;
+}
+
+U64 Pace_GetSleepNanoseconds() {
+    const U64 Now = Clock_GetNanoseconds();
+    if (Pace_GetFrameNanoseconds() == 0 || Now >= PaceDeadline) {
+        return 0;
+    }
+
+    // Idle frames needn't start on time, they sleep to the deadline.
+    const U64 Remaining = PaceDeadline - Now;
+    const U64 Spin = bPaceIdle ? 0 : PaceSpinNanoseconds;
+    return Remaining > Spin ? Remaining - Spin : 0;
+}
+
+void Pace_OnSlept(const U64 RequestedNanoseconds, const U64 SleptNanoseconds) {
+    // The margin jumps up to a long oversleep and slowly comes back down.
+    const U64 Overshoot = SleptNanoseconds > RequestedNanoseconds ? SleptNanoseconds - RequestedNanoseconds : 0;
+    U64 Spin = Overshoot > PaceSpinNanoseconds ? Overshoot : PaceSpinNanoseconds - (PaceSpinNanoseconds - Overshoot) / 16;
+    Spin = Spin < PaceSettings.MinSpinNanoseconds ? PaceSettings.MinSpinNanoseconds : Spin;
+    PaceSpinNanoseconds = Spin > PaceSettings.MaxSpinNanoseconds ? PaceSettings.MaxSpinNanoseconds : Spin;
+}
+
+void Pace_BeginFrame() {
+    const U64 FrameNanoseconds = Pace_GetFrameNanoseconds();
+    U64 Now = Clock_GetNanoseconds();
+    const Bool bLate = FrameNanoseconds > 0 && !bPaceIdle && Now > PaceDeadline + PaceSettings.MinSpinNanoseconds;
+
+    if (FrameNanoseconds > 0 && !bPaceIdle) {
+        while (Now < PaceDeadline) {
+            Now = Clock_GetNanoseconds();
+        }
+    }
+
+    // Deadlines follow each other so frames don't drift, a frame too late to catch up restarts the schedule.
+    PaceDeadline += FrameNanoseconds;
+    if (PaceDeadline <= Now) {
+        PaceDeadline = Now + FrameNanoseconds;
+    }
+
+    if (PaceFrameStart != 0) {
+        PaceFrameTimes[PaceFrameCount % PACE_WINDOW] = Now - PaceFrameStart;
+        PaceLateFrames[PaceFrameCount % PACE_WINDOW] = bLate;
+        PaceFrameCount++;
+    }
+    PaceFrameStart = Now;
+}
+
+void Pace_EndFrame() {
+    if (PaceFrameStart != 0) {
+        PaceWorkTimes[PaceWorkCount % PACE_WINDOW] = Clock_GetNanoseconds() - PaceFrameStart;
+        PaceWorkCount++;
+    }
+}
+
+void Pace_GetStats(FPaceStats* OutStats) {
+    const U32 WorkCount = PaceWorkCount < PACE_WINDOW ? PaceWorkCount : PACE_WINDOW;
+    const U32 FrameCount = PaceFrameCount < PACE_WINDOW ? PaceFrameCount : PACE_WINDOW;
+    Pace_GetDistribution(PaceWorkTimes, WorkCount, &OutStats->WorkMeanNanoseconds, &OutStats->WorkDeviationNanoseconds);
+    Pace_GetDistribution(PaceFrameTimes, FrameCount, &OutStats->FrameMeanNanoseconds, &OutStats->FrameDeviationNanoseconds);
+
+    OutStats->LateFrames = 0;
+    for (U32 Index = 0; Index < FrameCount; Index++) {
+        OutStats->LateFrames += PaceLateFrames[Index];
+    }
+
+    OutStats->SpinNanoseconds = PaceSpinNanoseconds;
+    OutStats->bIdle = bPaceIdle;
+}
+
+void Pace_InitSwapControl(FSwapControl* Control, const U64 RefreshNanoseconds, const Bool bAdaptiveSupported) {
+    *Control = (FSwapControl){0};
+    Control->SwapInterval = 1;
+    Control->RefreshNanoseconds = RefreshNanoseconds;
+    Control->bAdaptiveSupported = bAdaptiveSupported;
+}
+
+I32 Pace_UpdateSwapControl(FSwapControl* Control, const U64 Timestamp) {
+    if (Control->LastSwap != 0 && Control->RefreshNanoseconds > 0) {
+        // A late swap waited for the next vblank with vsync, adaptive vsync presents it at once with a tear.
+        const U64 Interval = Timestamp - Control->LastSwap;
+        if (Interval > Control->RefreshNanoseconds + Control->RefreshNanoseconds / 4) {
+            Control->LateFrames++;
+            Control->Tears += Control->SwapInterval == -1;
+        }
+        Control->Frames++;
+    }
+    Control->LastSwap = Timestamp;
+
+    if (Control->Frames >= PACE_SWAP_WINDOW) {
+        // Missing vblanks halves the frame rate with vsync, a tear is less visible. Vsync comes back once frames are on time.
+        if (Control->SwapInterval == 1 && Control->bAdaptiveSupported && Control->LateFrames >= PACE_SWAP_LATE_FRAMES) {
+            Control->SwapInterval = -1;
+        } else if (Control->SwapInterval == -1 && Control->LateFrames == 0) {
+            Control->SwapInterval = 1;
+        }
+
+        Control->Frames = 0;
+        Control->LateFrames = 0;
+    }
+
+    return Control->SwapInterval;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+U64 Pace_GetFrameNanoseconds() {
+    return bPaceIdle ? PaceSettings.IdleFrameNanoseconds : PaceSettings.FrameNanoseconds;
+}
+
+void Pace_GetDistribution(const U64* Times, const U32 Count, F64* OutMean, F64* OutDeviation) {
+    F64 Sum = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        Sum += (F64)Times[Index];
+    }
+
+    const F64 Mean = Count > 0 ? Sum / Count : 0.0;
+    F64 Variance = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        Variance += ((F64)Times[Index] - Mean) * ((F64)Times[Index] - Mean);
+    }
+
+    *OutMean = Mean;
+    *OutDeviation = Count > 1 ? sqrt(Variance / (Count - 1)) : 0.0;
+}
+#pragma endregion
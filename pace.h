@@ -0,0 +1,74 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Frame pacing of the main loop. Frames are due at a fixed interval from the previous deadline, the caller sleeps until
+ * the spin margin before the deadline and Pace_BeginFrame spins the rest. The margin follows the observed oversleep, so
+ * the sleep gives the processor away for most of the wait while frames still start on time.
+ */
+typedef struct {
+    /** Frame time target, 0 runs uncapped. */
+    U64 FrameNanoseconds;
+    /** Frame time while the window is idle, sleeping only. */
+    U64 IdleFrameNanoseconds;
+    /** Spin margin bounds, the margin starts at the minimum. */
+    U64 MinSpinNanoseconds;
+    U64 MaxSpinNanoseconds;
+} FPaceSettings;
+
+typedef struct {
+    /** Mean and standard deviation of the work done in a frame, the frame times an uncapped loop would have. */
+    F64 WorkMeanNanoseconds;
+    F64 WorkDeviationNanoseconds;
+    /** Mean and standard deviation of the time between frame starts. */
+    F64 FrameMeanNanoseconds;
+    F64 FrameDeviationNanoseconds;
+    /** Frames started after their deadline, over the window. */
+    U32 LateFrames;
+    U64 SpinNanoseconds;
+    Bool bIdle;
+} FPaceStats;
+
+/** Tracks late swaps of a GL swap chain, switching vsync to adaptive while frames miss the refresh and back. */
+typedef struct {
+    /** Swap interval to use, 1 for vsync, -1 for adaptive vsync tearing late frames, 0 without vsync. */
+    I32 SwapInterval;
+    U64 RefreshNanoseconds;
+    Bool bAdaptiveSupported;
+    U64 LastSwap;
+    /** Frames and late frames of the current window. */
+    U32 Frames;
+    U32 LateFrames;
+    /** Late swaps with adaptive vsync, each presented with a tear. */
+    U32 Tears;
+} FSwapControl;
+
+void Pace_GetDefaultSettings(FPaceSettings* OutSettings);
+
+void Pace_Initialize(const FPaceSettings* Settings);
+
+/** Changes the frame time target, 0 runs uncapped. */
+void Pace_SetFrameNanoseconds(U64 FrameNanoseconds);
+
+/** Switches to the idle frame time, for minimized or unfocused windows. */
+void Pace_SetIdle(Bool bIdle);
+
+/** Returns how long the caller may sleep before the next frame is due, 0 once within the spin margin. */
+U64 Pace_GetSleepNanoseconds();
+
+/** Reports a sleep of Pace_GetSleepNanoseconds that ran to its end, the spin margin adapts to its overshoot. */
+void Pace_OnSlept(U64 RequestedNanoseconds, U64 SleptNanoseconds);
+
+/** Spins until the frame is due and starts it. */
+void Pace_BeginFrame();
+
+/** Ends the work of the frame, for the work time statistics. */
+void Pace_EndFrame();
+
+void Pace_GetStats(FPaceStats* OutStats);
+
+/** Starts with vsync, refresh is the display refresh period. */
+void Pace_InitSwapControl(FSwapControl* Control, U64 RefreshNanoseconds, Bool bAdaptiveSupported);
+
+/** Called after each swap returned, returns the swap interval for the next frames. */
+I32 Pace_UpdateSwapControl(FSwapControl* Control, U64 Timestamp);
@@ -0,0 +1,403 @@
+#include "pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "file.h"
+#include "hash.h"
+#include "lz4.h"
+
+#if OS_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct FPack {
+    const U8* Data;
+    U64 Size;
+    const FPackHeader* Header;
+    const FPackEntry* Entries;
+    const char* Names;
+#if OS_WINDOWS
+    HANDLE File;
+    HANDLE Mapping;
+#endif
+};
+
+#pragma region Private Function Declarations
+/** Maps the whole file read-only. */
+static Bool Pack_Map(FPack* Pack, pStr Path);
+static void Pack_Unmap(FPack* Pack);
+
+/** Checks that every section and entry lies inside the mapping. */
+static Bool Pack_Validate(FPack* Pack);
+
+static U64 Pack_Align(U64 Value);
+/** Hashes the path with forward slashes, the way it is looked up at runtime. */
+static U64 Pack_HashPath(pStr Path);
+static int Pack_CompareEntries(const void* A, const void* B);
+/** Writes zero bytes up to the aligned offset. */
+static Bool Pack_WritePadding(FILE* File, U64 Offset, U64 AlignedOffset);
+#pragma endregion
+
+#pragma region Public Function Definitions
+FPack* Pack_Open(const pStr Path) {
+    FPack* Pack = calloc(1, sizeof *Pack);
+    if (Pack == NULL) {
+        return NULL;
+    }
+
+    if (!Pack_Map(Pack, Path)) {
+        free(Pack);
+        return NULL;
+    }
+
+    if (!Pack_Validate(Pack)) {
+        fprintf(stderr, "Asset pack %s is malformed\n", Path);
+        Pack_Close(Pack);
+        return NULL;
+    }
+
+    return Pack;
+}
+
+void Pack_Close(FPack* Pack) {
+    if (Pack == NULL) {
+        return;
+    }
+
+    Pack_Unmap(Pack);
+    free(Pack);
+}
+
+U32 Pack_GetEntryCount(const FPack* Pack) {
+    return Pack->Header->EntryCount;
+}
+
+const FPackEntry* Pack_GetEntry(const FPack* Pack, const U32 Index) {
+    return Index < Pack->Header->EntryCount ? &Pack->Entries[Index] : NULL;
+}
+
+const FPackEntry* Pack_FindEntry(const FPack* Pack, const pStr Path) {
+    const U64 PathHash = Hash_String(Path);
+
+    // Binary search over the hash-sorted table in place, the mapping is never copied.
+    U32 Low = 0;
+    U32 High = Pack->Header->EntryCount;
+    while (Low < High) {
+        const U32 Middle = Low + (High - Low) / 2;
+        if (Pack->Entries[Middle].PathHash < PathHash) {
+            Low = Middle + 1;
+        } else {
+            High = Middle;
+        }
+    }
+
+    if (Low < Pack->Header->EntryCount && Pack->Entries[Low].PathHash == PathHash &&
+        strcmp(Pack->Names + Pack->Entries[Low].NameOffset, Path) == 0) {
+        return &Pack->Entries[Low];
+    }
+
+    return NULL;
+}
+
+pStr Pack_GetEntryPath(const FPack* Pack, const FPackEntry* Entry) {
+    return (pStr)(Pack->Names + Entry->NameOffset);
+}
+
+const U8* Pack_GetEntryData(const FPack* Pack, const FPackEntry* Entry) {
+    return Pack->Data + Entry->Offset;
+}
+
+Bool Pack_ReadEntry(const FPack* Pack, const FPackEntry* Entry, U8* Buffer, const U64 BufferSize) {
+    if (BufferSize < Entry->Size) {
+        return False;
+    }
+
+    const U8* Data = Pack_GetEntryData(Pack, Entry);
+    switch (Entry->Compression) {
+    case PACK_COMPRESSION_NONE:
+        memcpy(Buffer, Data, Entry->Size);
+        return True;
+
+    case PACK_COMPRESSION_LZ4:
+        return Lz4_Decompress(Data, Entry->StoredSize, Buffer, Entry->Size) == (I64)Entry->Size;
+
+    default:
+        return False;
+    }
+}
+
+Bool Pack_VerifyEntry(const FPack* Pack, const FPackEntry* Entry) {
+    if (Entry->Compression == PACK_COMPRESSION_NONE) {
+        return Hash_Compute(Pack_GetEntryData(Pack, Entry), Entry->Size, 0) == Entry->ContentHash;
+    }
+
+    U8* Buffer = malloc(Entry->Size > 0 ? Entry->Size : 1);
+    if (Buffer == NULL) {
+        return False;
+    }
+
+    const Bool bResult = Pack_ReadEntry(Pack, Entry, Buffer, Entry->Size) && Hash_Compute(Buffer, Entry->Size, 0) == Entry->ContentHash;
+    free(Buffer);
+
+    return bResult;
+}
+
+Bool Pack_Write(const pStr OutputPath, const pStr* Paths, const U32 PathCount, const Bool bCompress) {
+    FPackEntry* Entries = calloc(PathCount > 0 ? PathCount : 1, sizeof *Entries);
+    if (Entries == NULL) {
+        return False;
+    }
+
+    FPackHeader Header = {0};
+    Header.Magic = PACK_MAGIC;
+    Header.Version = PACK_VERSION;
+    Header.EntryCount = PathCount;
+    Header.TocOffset = Pack_Align(sizeof Header);
+    Header.NamesOffset = Header.TocOffset + (U64)PathCount * sizeof(FPackEntry);
+
+    for (U32 Index = 0; Index < PathCount; Index++) {
+        Entries[Index].NameOffset = (U32)Header.NamesSize;
+        Header.NamesSize += strlen(Paths[Index]) + 1;
+    }
+
+    FILE* File = fopen(OutputPath, "wb");
+    if (File == NULL) {
+        fprintf(stderr, "Failed to create asset pack %s\n", OutputPath);
+        free(Entries);
+        return False;
+    }
+
+    // Data goes first, the table of contents is written once every entry is placed.
+    Bool bSucceeded = fseek(File, (long)Pack_Align(Header.NamesOffset + Header.NamesSize), SEEK_SET) == 0;
+    U64 Offset = Pack_Align(Header.NamesOffset + Header.NamesSize);
+    U8* Compressed = NULL;
+    U64 CompressedCapacity = 0;
+
+    for (U32 Index = 0; Index < PathCount && bSucceeded; Index++) {
+        I64 Length;
+        const pStr Data = File_ReadText(Paths[Index], &Length);
+        if (Data == NULL) {
+            fprintf(stderr, "Failed to read %s\n", Paths[Index]);
+            bSucceeded = False;
+            break;
+        }
+
+        FPackEntry* Entry = &Entries[Index];
+        Entry->PathHash = Pack_HashPath(Paths[Index]);
+        Entry->ContentHash = Hash_Compute(Data, (U64)Length, 0);
+        Entry->Offset = Offset;
+        Entry->Size = (U64)Length;
+        Entry->StoredSize = (U64)Length;
+        Entry->Compression = PACK_COMPRESSION_NONE;
+
+        const U8* Stored = (const U8*)Data;
+        if (bCompress && Length > 0) {
+            const U64 Capacity = Lz4_GetMaxCompressedSize((U64)Length);
+            if (Capacity > CompressedCapacity) {
+                free(Compressed);
+                Compressed = malloc(Capacity);
+                CompressedCapacity = Compressed != NULL ? Capacity : 0;
+            }
+
+            const U64 CompressedSize = Compressed != NULL ? Lz4_Compress((const U8*)Data, (U64)Length, Compressed, CompressedCapacity) : 0;
+            if (CompressedSize > 0 && CompressedSize <= (U64)Length - (U64)Length / 8) {
+                Entry->StoredSize = CompressedSize;
+                Entry->Compression = PACK_COMPRESSION_LZ4;
+                Stored = Compressed;
+            }
+        }
+
+        bSucceeded = fwrite(Stored, 1, Entry->StoredSize, File) == Entry->StoredSize &&
+                     Pack_WritePadding(File, Offset + Entry->StoredSize, Pack_Align(Offset + Entry->StoredSize));
+        Offset = Pack_Align(Offset + Entry->StoredSize);
+        free(Data);
+    }
+    free(Compressed);
+
+    if (bSucceeded) {
+        qsort(Entries, PathCount, sizeof *Entries, Pack_CompareEntries);
+        for (U32 Index = 1; Index < PathCount; Index++) {
+            if (Entries[Index].PathHash == Entries[Index - 1].PathHash) {
+                fprintf(stderr, "Asset path hash collision, rename one of the entries\n");
+                bSucceeded = False;
+            }
+        }
+    }
+
+    if (bSucceeded) {
+        Header.FileSize = Offset;
+        bSucceeded = fseek(File, 0, SEEK_SET) == 0 && fwrite(&Header, sizeof Header, 1, File) == 1 &&
+                     Pack_WritePadding(File, sizeof Header, Header.TocOffset) &&
+                     fwrite(Entries, sizeof *Entries, PathCount, File) == PathCount;
+
+        for (U32 Index = 0; Index < PathCount && bSucceeded; Index++) {
+            // Paths are stored with forward slashes whatever the host separator.
+            const size_t Length = strlen(Paths[Index]);
+            for (size_t Character = 0; Character <= Length && bSucceeded; Character++) {
+                bSucceeded = fputc(Paths[Index][Character] == '\\' ? '/' : Paths[Index][Character], File) != EOF;
+            }
+        }
+
+        bSucceeded = bSucceeded && Pack_WritePadding(File, Header.NamesOffset + Header.NamesSize, Pack_Align(Header.NamesOffset + Header.NamesSize));
+    }
+
+    bSucceeded = fclose(File) == 0 && bSucceeded;
+    free(Entries);
+
+    if (!bSucceeded) {
+        fprintf(stderr, "Failed to write asset pack %s\n", OutputPath);
+        remove(OutputPath);
+    }
+
+    return bSucceeded;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+#if OS_WINDOWS
+Bool Pack_Map(FPack* Pack, const pStr Path) {
+    Pack->File = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (Pack->File == INVALID_HANDLE_VALUE) {
+        return False;
+    }
+
+    LARGE_INTEGER Size;
+    if (!GetFileSizeEx(Pack->File, &Size) || Size.QuadPart == 0) {
+        CloseHandle(Pack->File);
+        return False;
+    }
+
+    Pack->Mapping = CreateFileMappingA(Pack->File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (Pack->Mapping == NULL) {
+        CloseHandle(Pack->File);
+        return False;
+    }
+
+    Pack->Data = MapViewOfFile(Pack->Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (Pack->Data == NULL) {
+        CloseHandle(Pack->Mapping);
+        CloseHandle(Pack->File);
+        return False;
+    }
+
+    Pack->Size = (U64)Size.QuadPart;
+
+    return True;
+}
+
+void Pack_Unmap(FPack* Pack) {
+    UnmapViewOfFile(Pack->Data);
+    CloseHandle(Pack->Mapping);
+    CloseHandle(Pack->File);
+}
+#else
+Bool Pack_Map(FPack* Pack, const pStr Path) {
+    const int FileDescriptor = open(Path, O_RDONLY);
+    if (FileDescriptor < 0) {
+        return False;
+    }
+
+    struct stat Stat;
+    if (fstat(FileDescriptor, &Stat) != 0 || Stat.st_size == 0) {
+        close(FileDescriptor);
+        return False;
+    }
+
+    void* Data = mmap(NULL, (size_t)Stat.st_size, PROT_READ, MAP_SHARED, FileDescriptor, 0);
+    // The mapping keeps the file alive.
+    close(FileDescriptor);
+    if (Data == MAP_FAILED) {
+        return False;
+    }
+
+    // Small archives are read whole on startup, let the kernel read ahead.
+    madvise(Data, (size_t)Stat.st_size, MADV_WILLNEED);
+
+    Pack->Data = Data;
+    Pack->Size = (U64)Stat.st_size;
+
+    return True;
+}
+
+void Pack_Unmap(FPack* Pack) {
+    munmap((void*)Pack->Data, (size_t)Pack->Size);
+}
+#endif
+
+Bool Pack_Validate(FPack* Pack) {
+    if (Pack->Size < sizeof(FPackHeader)) {
+        return False;
+    }
+
+    const FPackHeader* Header = (const FPackHeader*)Pack->Data;
+    if (Header->Magic != PACK_MAGIC || Header->Version != PACK_VERSION || Header->FileSize != Pack->Size) {
+        return False;
+    }
+
+    if (Header->TocOffset % sizeof(U64) != 0 || Header->TocOffset > Pack->Size ||
+        (Pack->Size - Header->TocOffset) / sizeof(FPackEntry) < Header->EntryCount || Header->NamesOffset > Pack->Size ||
+        Header->NamesSize > Pack->Size - Header->NamesOffset || (Header->NamesSize > 0 && Pack->Data[Header->NamesOffset + Header->NamesSize - 1] != '\0')) {
+        return False;
+    }
+
+    Pack->Header = Header;
+    Pack->Entries = (const FPackEntry*)(Pack->Data + Header->TocOffset);
+    Pack->Names = (const char*)(Pack->Data + Header->NamesOffset);
+
+    for (U32 Index = 0; Index < Header->EntryCount; Index++) {
+        const FPackEntry* Entry = &Pack->Entries[Index];
+        if (Entry->Offset > Pack->Size || Entry->StoredSize > Pack->Size - Entry->Offset || Entry->NameOffset >= Header->NamesSize ||
+            (Entry->Compression == PACK_COMPRESSION_NONE && Entry->StoredSize != Entry->Size) ||
+            (Index > 0 && Entry->PathHash < Pack->Entries[Index - 1].PathHash)) {
+            return False;
+        }
+    }
+
+    return True;
+}
+
+U64 Pack_HashPath(const pStr Path) {
+    const size_t Length = strlen(Path);
+    char* Normalized = malloc(Length + 1);
+    if (Normalized == NULL) {
+        return Hash_String(Path);
+    }
+
+    for (size_t Character = 0; Character <= Length; Character++) {
+        Normalized[Character] = Path[Character] == '\\' ? '/' : Path[Character];
+    }
+
+    const U64 Result = Hash_String(Normalized);
+    free(Normalized);
+
+    return Result;
+}
+
+U64 Pack_Align(const U64 Value) {
+    return (Value + PACK_ALIGNMENT - 1) & ~(U64)(PACK_ALIGNMENT - 1);
+}
+
+int Pack_CompareEntries(const void* A, const void* B) {
+    const U64 HashA = ((const FPackEntry*)A)->PathHash;
+    const U64 HashB = ((const FPackEntry*)B)->PathHash;
+
+    return HashA < HashB ? -1 : HashA > HashB;
+}
+
+Bool Pack_WritePadding(FILE* File, U64 Offset, const U64 AlignedOffset) {
+    for (; Offset < AlignedOffset; Offset++) {
+        if (fputc(0, File) == EOF) {
+            return False;
+        }
+    }
+
+    return True;
+}
+#pragma endregion
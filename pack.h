@@ -0,0 +1,79 @@
+#pragma once
+#include "typedefs.h"
+
+/** "SQPK" in little-endian. */
+#define PACK_MAGIC 0x4B505153
+#define PACK_VERSION 1
+/** Alignment of the table of contents and of every entry's data. */
+#define PACK_ALIGNMENT 64
+
+typedef enum {
+    PACK_COMPRESSION_NONE = 0,
+    PACK_COMPRESSION_LZ4
+} EPackCompression;
+
+/** Archive header at offset zero. All sections are little-endian and read in place. */
+typedef struct {
+    U32 Magic;
+    U32 Version;
+    U32 EntryCount;
+    U32 Reserved;
+    /** Table of contents, EntryCount entries sorted by PathHash. */
+    U64 TocOffset;
+    /** Null-terminated entry paths. */
+    U64 NamesOffset;
+    U64 NamesSize;
+    /** Total archive size, used to detect truncated files. */
+    U64 FileSize;
+} FPackHeader;
+
+/** Table of contents entry. */
+typedef struct {
+    /** Hash_String of the path, the table is sorted by it. */
+    U64 PathHash;
+    /** Hash_Compute of the uncompressed content. */
+    U64 ContentHash;
+    /** Stored data offset from the archive start. */
+    U64 Offset;
+    /** Stored data size, compressed size for compressed entries. */
+    U64 StoredSize;
+    /** Uncompressed size. */
+    U64 Size;
+    /** Path offset in the names section. */
+    U32 NameOffset;
+    /** EPackCompression. */
+    U32 Compression;
+} FPackEntry;
+
+/** Memory-mapped archive. */
+typedef struct FPack FPack;
+
+/** Maps the archive and validates its table of contents. Returns NULL on failure. */
+FPack* Pack_Open(pStr Path);
+
+/** Unmaps the archive, views into it become invalid. */
+void Pack_Close(FPack* Pack);
+
+U32 Pack_GetEntryCount(const FPack* Pack);
+
+const FPackEntry* Pack_GetEntry(const FPack* Pack, U32 Index);
+
+/** Finds the entry by its path, "assets/shaders/vs.glsl" style. Returns NULL if the archive has no such entry. */
+const FPackEntry* Pack_FindEntry(const FPack* Pack, pStr Path);
+
+pStr Pack_GetEntryPath(const FPack* Pack, const FPackEntry* Entry);
+
+/** Returns a view of the stored entry data inside the mapping, the content itself for uncompressed entries. */
+const U8* Pack_GetEntryData(const FPack* Pack, const FPackEntry* Entry);
+
+/** Copies or decompresses the entry content into the buffer of at least Entry->Size bytes. */
+Bool Pack_ReadEntry(const FPack* Pack, const FPackEntry* Entry, U8* Buffer, U64 BufferSize);
+
+/** Checks the entry content against its content hash. */
+Bool Pack_VerifyEntry(const FPack* Pack, const FPackEntry* Entry);
+
+/**
+ * Writes an archive of the files. Entries are stored with their paths as given, each one LZ4 compressed if bCompress is set and the
+ * compression saves at least an eighth of its size.
+ */
+Bool Pack_Write(pStr OutputPath, const pStr* Paths, U32 PathCount, Bool bCompress);
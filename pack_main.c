@@ -0,0 +1,128 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+#include "file.h"
+#include "pack.h"
+
+#pragma region Private Function Declarations
+static void Packer_PrintUsage(pStr Program);
+static void Packer_AddPath(pStr Path, void* UserData);
+static int Packer_ComparePaths(const void* A, const void* B);
+static int Packer_Build(pStr Directory, pStr OutputPath, Bool bCompress);
+static int Packer_Verify(pStr PackPath);
+#pragma endregion
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--verify") == 0) {
+        return Packer_Verify(argv[2]);
+    }
+
+    if (argc == 3) {
+        return Packer_Build(argv[1], argv[2], True);
+    }
+
+    if (argc == 4 && strcmp(argv[1], "--store") == 0) {
+        return Packer_Build(argv[2], argv[3], False);
+    }
+
+    Packer_PrintUsage(argv[0]);
+    return 2;
+}
+
+#pragma region Private Function Definitions
+void Packer_PrintUsage(const pStr Program) {
+    fprintf(stderr,
+            "Usage: %s [--store] DIRECTORY OUTPUT   pack every file under DIRECTORY, --store disables compression\n"
+            "       %s --verify PACK                check every entry against its content hash\n"
+            "Entries keep the DIRECTORY prefix, run from the game working directory: %s assets assets.pak\n",
+            Program, Program, Program);
+}
+
+void Packer_AddPath(const pStr Path, void* UserData) {
+    FVector(pStr)* OutPaths = UserData;
+    FVector(pStr) Paths = *OutPaths;
+
+    const size_t Length = strlen(Path);
+    const pStr Copy = malloc(Length + 1);
+    if (Copy != NULL) {
+        memcpy(Copy, Path, Length + 1);
+        FVector_Add(Paths, Copy);
+    }
+
+    *OutPaths = Paths;
+}
+
+int Packer_ComparePaths(const void* A, const void* B) {
+    return strcmp(*(const pStr*)A, *(const pStr*)B);
+}
+
+int Packer_Build(const pStr Directory, const pStr OutputPath, const Bool bCompress) {
+    FVector(pStr) Paths = NULL;
+    if (!File_VisitDirectory(Directory, Packer_AddPath, &Paths)) {
+        fprintf(stderr, "Failed to open directory %s\n", Directory);
+        return 1;
+    }
+
+    // Sorted paths keep the archive reproducible and files of one directory next to each other.
+    const U32 PathCount = (U32)FVector_GetSize(Paths);
+    if (PathCount > 0) {
+        qsort(Paths, PathCount, sizeof(pStr), Packer_ComparePaths);
+    }
+
+    const Bool bSucceeded = Pack_Write(OutputPath, Paths, PathCount, bCompress);
+
+    for (U32 Index = 0; Index < PathCount; Index++) {
+        free(Paths[Index]);
+    }
+    FVector_Free(Paths);
+
+    if (!bSucceeded) {
+        return 1;
+    }
+
+    FPack* Pack = Pack_Open(OutputPath);
+    if (Pack == NULL) {
+        return 1;
+    }
+
+    U64 Size = 0, StoredSize = 0;
+    U32 CompressedCount = 0;
+    for (U32 Index = 0; Index < Pack_GetEntryCount(Pack); Index++) {
+        const FPackEntry* Entry = Pack_GetEntry(Pack, Index);
+        Size += Entry->Size;
+        StoredSize += Entry->StoredSize;
+        CompressedCount += Entry->Compression != PACK_COMPRESSION_NONE;
+    }
+
+    printf("%s: %u entries, %u compressed, %llu bytes stored as %llu\n", OutputPath, Pack_GetEntryCount(Pack), CompressedCount,
+           (unsigned long long)Size, (unsigned long long)StoredSize);
+    Pack_Close(Pack);
+
+    return 0;
+}
+
+int Packer_Verify(const pStr PackPath) {
+    FPack* Pack = Pack_Open(PackPath);
+    if (Pack == NULL) {
+        fprintf(stderr, "Failed to open asset pack %s\n", PackPath);
+        return 1;
+    }
+
+    U32 FailedCount = 0;
+    for (U32 Index = 0; Index < Pack_GetEntryCount(Pack); Index++) {
+        const FPackEntry* Entry = Pack_GetEntry(Pack, Index);
+        const pStr Path = Pack_GetEntryPath(Pack, Entry);
+        const Bool bValid = Pack_VerifyEntry(Pack, Entry) && Pack_FindEntry(Pack, Path) == Entry;
+
+        printf("%s %016llx %10llu %10llu %s\n", bValid ? "ok  " : "FAIL", (unsigned long long)Entry->ContentHash, (unsigned long long)Entry->Size,
+               (unsigned long long)Entry->StoredSize, Path);
+        FailedCount += !bValid;
+    }
+
+    Pack_Close(Pack);
+
+    return FailedCount == 0 ? 0 : 1;
+}
+#pragma endregion
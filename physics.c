@@ -0,0 +1,826 @@
+#include "physics.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "block.h"
+#include "clock.h"
+#include "thread.h"
+
+#pragma region Settings
+/** Maximum number of worker threads. */
+#define PHYSICS_MAX_WORKERS 16
+/** Bodies stepped by a job at least, regions are grouped until they reach it. */
+#define PHYSICS_JOB_BODIES 64
+/** Buckets the regions are sorted into, a power of two. Bounds the number of jobs of a step. */
+#define PHYSICS_REGION_BUCKETS 256
+/** Size of the broadphase cells in blocks. */
+#define PHYSICS_CELL_SIZE 2.f
+/** Faces closer than this are touching and not overlapping, in blocks. Bodies stop half of it away from blocks. */
+#define PHYSICS_SKIN 1e-3f
+/** Speed limit in blocks per second, keeps the blocks crossed by a step few. */
+#define PHYSICS_MAX_SPEED 64.f
+/** Chunk lookups remembered by a job, a power of two. */
+#define PHYSICS_CACHE_SIZE 16
+#pragma endregion
+
+typedef enum {
+    /** Integrates the awake bodies and moves them through the blocks. */
+    PHYSICS_PHASE_MOVE = 0,
+    /** Gathers the separation of the bodies from the bodies they overlap. */
+    PHYSICS_PHASE_CONTACTS,
+    /** Applies the separation and puts resting bodies to sleep. */
+    PHYSICS_PHASE_RESOLVE
+} EPhysicsPhase;
+
+typedef struct {
+    F32 Position[3];
+    F32 PreviousPosition[3];
+    F32 Velocity[3];
+    F32 HalfExtents[3];
+    /** Gathered by the contacts phase, each body only writes its own, and applied by the resolve phase. */
+    F32 Correction[3];
+    F32 VelocityCorrection[3];
+    U32 QuietSteps;
+    Bool bActive;
+    Bool bSleeping;
+    Bool bGrounded;
+    /** Pushed sideways by an awake body while asleep, woken by the resolve phase. */
+    Bool bWoken;
+} FPhysicsBody;
+
+/** Range of the body order stepped by one thread, a group of whole regions. */
+typedef struct {
+    U32 Begin;
+    U32 End;
+    U32 Contacts;
+} FPhysicsJob;
+
+/** Body overlapping a broadphase cell. */
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    U32 Body;
+} FPhysicsCellEntry;
+
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Bool bValid;
+    const FChunk* Chunk;
+} FPhysicsCacheEntry;
+
+/** Direct mapped chunk lookups of a job, bodies of a region mostly touch the same chunks. */
+typedef struct {
+    const FWorld* World;
+    FPhysicsCacheEntry Entries[PHYSICS_CACHE_SIZE];
+} FPhysicsCache;
+
+struct FPhysics {
+    FPhysicsSettings Settings;
+
+    FPhysicsBody* Bodies;
+    /** Removed body ids, reused before new ones. */
+    U32* FreeBodies;
+    U32 FreeBodyCount;
+    /** Ids below it have been handed out. */
+    U32 UsedBodyCount;
+
+    /** Active bodies sorted by region, the jobs are ranges of it. */
+    U32* Order;
+    U32 OrderCount;
+    /** Region bucket of each active body while they are sorted. */
+    U32* OrderBuckets;
+    U32 RegionBucketStarts[PHYSICS_REGION_BUCKETS + 1];
+    FPhysicsJob Jobs[PHYSICS_REGION_BUCKETS];
+    U32 JobCount;
+
+    /** Broadphase entries sorted by bucket of their cell, BucketStarts has CellBucketCount + 1 offsets. */
+    FPhysicsCellEntry* Entries;
+    U32 EntryCount;
+    U32 EntryCapacity;
+    U32* CellBucketStarts;
+    U32 CellBucketCount;
+
+    FThread* Workers[PHYSICS_MAX_WORKERS];
+    U32 WorkerCount;
+    FMutex* Mutex;
+    FCondition* PhaseStarted;
+    FCondition* PhaseFinished;
+    /** Phase run by the threads, started phases count up so workers tell them apart. */
+    EPhysicsPhase Phase;
+    U32 PhaseGeneration;
+    /** Jobs of the running phase, workers waking late only see the phase they were woken for as finished. */
+    U32 PhaseJobCount;
+    U32 NextJob;
+    U32 FinishedJobs;
+    Bool bStopping;
+
+    /** Time not simulated yet, less than a step after an update. */
+    F64 Accumulator;
+    FPhysicsStats Stats;
+};
+
+#pragma region Private Function Declarations
+static int Physics_WorkerMain(void* UserData);
+
+/** Runs the phase over every job, on the workers and the calling thread, and returns once all are finished. */
+static void Physics_RunPhase(FPhysics* Physics, EPhysicsPhase Phase);
+
+/** Claims and runs jobs of the current phase until none are left. */
+static void Physics_WorkJobs(FPhysics* Physics);
+
+static void Physics_RunJob(FPhysics* Physics, EPhysicsPhase Phase, FPhysicsJob* Job);
+
+static void Physics_Step(FPhysics* Physics);
+
+/** Sorts the active bodies by region and groups the regions into jobs. */
+static void Physics_SortRegions(FPhysics* Physics);
+
+/** Inserts the bodies into the broadphase cells they overlap. Returns False when out of memory. */
+static Bool Physics_BuildBroadphase(FPhysics* Physics);
+
+static void Physics_MoveBody(FPhysics* Physics, FPhysicsBody* Body, FPhysicsCache* Cache);
+
+static U32 Physics_GatherContacts(FPhysics* Physics, U32 BodyIndex);
+
+static void Physics_ResolveBody(FPhysics* Physics, FPhysicsBody* Body, FPhysicsCache* Cache);
+
+/** Returns how far the body can move along the axis before it touches a solid block, the sign of the move kept. */
+static F32 Physics_SweepAxis(FPhysicsCache* Cache, const FPhysicsBody* Body, U32 Axis, F32 Move);
+
+static Bool Physics_IsSolid(FPhysicsCache* Cache, I32 X, I32 Y, I32 Z);
+
+static U32 Physics_HashCell(I32 X, I32 Y, I32 Z);
+
+static I32 Physics_GetCell(F32 Coordinate);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Physics_GetDefaultSettings(FPhysicsSettings* OutSettings) {
+    *OutSettings = (FPhysicsSettings){0};
+    OutSettings->Gravity = -25.f;
+    OutSettings->Friction = 20.f;
+    OutSettings->StepSeconds = 1.f / 60.f;
+    OutSettings->MaxStepsPerUpdate = 4;
+    OutSettings->MaxBodies = 8192;
+    OutSettings->SleepSpeed = 0.05f;
+    OutSettings->SleepSteps = 30;
+    OutSettings->RegionSize = 16;
+}
+
+FPhysics* Physics_Create(const FPhysicsSettings* Settings) {
+    FPhysics* Physics = calloc(1, sizeof *Physics);
+    if (Physics == NULL) {
+        return NULL;
+    }
+
+    Physics->Settings = *Settings;
+    if (Physics->Settings.RegionSize == 0) {
+        Physics->Settings.RegionSize = 1;
+    }
+
+    const U32 MaxBodies = Physics->Settings.MaxBodies;
+    Physics->Bodies = calloc(MaxBodies > 0 ? MaxBodies : 1, sizeof(FPhysicsBody));
+    Physics->FreeBodies = calloc(MaxBodies > 0 ? MaxBodies : 1, sizeof(U32));
+    Physics->Order = calloc(MaxBodies > 0 ? MaxBodies : 1, sizeof(U32));
+    Physics->OrderBuckets = calloc(MaxBodies > 0 ? MaxBodies : 1, sizeof(U32));
+    Physics->Mutex = Mutex_Create();
+    Physics->PhaseStarted = Condition_Create();
+    Physics->PhaseFinished = Condition_Create();
+    if (Physics->Bodies == NULL || Physics->FreeBodies == NULL || Physics->Order == NULL || Physics->OrderBuckets == NULL || Physics->Mutex == NULL ||
+        Physics->PhaseStarted == NULL || Physics->PhaseFinished == NULL) {
+        Physics_Destroy(Physics);
+        return NULL;
+    }
+
+    U32 WorkerCount = Physics->Settings.WorkerCount;
+    if (WorkerCount == 0) {
+        WorkerCount = Thread_GetProcessorCount() - 1;
+    }
+    if (WorkerCount > PHYSICS_MAX_WORKERS) {
+        WorkerCount = PHYSICS_MAX_WORKERS;
+    }
+
+    // Without workers the updating thread steps every region itself.
+    for (U32 Index = 0; Index < WorkerCount; Index++) {
+        Physics->Workers[Index] = Thread_Create(Physics_WorkerMain, "Physics", Physics);
+        if (Physics->Workers[Index] == NULL) {
+            fprintf(stderr, "Failed to start physics worker %u\n", Index);
+            break;
+        }
+        Physics->WorkerCount++;
+    }
+
+    return Physics;
+}
+
+void Physics_Destroy(FPhysics* Physics) {
+    if (Physics == NULL) {
+        return;
+    }
+
+    if (Physics->Mutex != NULL && Physics->PhaseStarted != NULL) {
+        Mutex_Lock(Physics->Mutex);
+        Physics->bStopping = True;
+        Condition_Broadcast(Physics->PhaseStarted);
+        Mutex_Unlock(Physics->Mutex);
+    }
+
+    for (U32 Index = 0; Index < Physics->WorkerCount; Index++) {
+        Thread_Join(Physics->Workers[Index]);
+    }
+
+    Condition_Destroy(Physics->PhaseFinished);
+    Condition_Destroy(Physics->PhaseStarted);
+    Mutex_Destroy(Physics->Mutex);
+    free(Physics->CellBucketStarts);
+    free(Physics->Entries);
+    free(Physics->OrderBuckets);
+    free(Physics->Order);
+    free(Physics->FreeBodies);
+    free(Physics->Bodies);
+    free(Physics);
+}
+
+U32 Physics_AddBody(FPhysics* Physics, const F32 Position[3], const F32 HalfExtents[3]) {
+    U32 Id;
+    if (Physics->FreeBodyCount > 0) {
+        Id = Physics->FreeBodies[--Physics->FreeBodyCount];
+    } else if (Physics->UsedBodyCount < Physics->Settings.MaxBodies) {
+        Id = Physics->UsedBodyCount++;
+    } else {
+        return InvalidId;
+    }
+
+    FPhysicsBody* Body = &Physics->Bodies[Id];
+    *Body = (FPhysicsBody){0};
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Body->Position[Axis] = Position[Axis];
+        Body->PreviousPosition[Axis] = Position[Axis];
+        Body->HalfExtents[Axis] = HalfExtents[Axis];
+    }
+    Body->bActive = True;
+    Physics->Stats.Bodies++;
+
+    return Id;
+}
+
+void Physics_RemoveBody(FPhysics* Physics, const U32 Body) {
+    if (Body >= Physics->UsedBodyCount || !Physics->Bodies[Body].bActive) {
+        return;
+    }
+
+    Physics->Bodies[Body].bActive = False;
+    Physics->FreeBodies[Physics->FreeBodyCount++] = Body;
+    Physics->Stats.Bodies--;
+}
+
+void Physics_SetVelocity(FPhysics* Physics, const U32 Body, const F32 Velocity[3]) {
+    FPhysicsBody* PhysicsBody = &Physics->Bodies[Body];
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        PhysicsBody->Velocity[Axis] = Velocity[Axis];
+    }
+    PhysicsBody->bSleeping = False;
+    PhysicsBody->QuietSteps = 0;
+}
+
+void Physics_GetVelocity(const FPhysics* Physics, const U32 Body, F32 OutVelocity[3]) {
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        OutVelocity[Axis] = Physics->Bodies[Body].Velocity[Axis];
+    }
+}
+
+void Physics_GetPosition(const FPhysics* Physics, const U32 Body, F32 OutPosition[3]) {
+    const FPhysicsBody* PhysicsBody = &Physics->Bodies[Body];
+    const F32 Alpha = (F32)(Physics->Accumulator / Physics->Settings.StepSeconds);
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        OutPosition[Axis] = PhysicsBody->PreviousPosition[Axis] + (PhysicsBody->Position[Axis] - PhysicsBody->PreviousPosition[Axis]) * Alpha;
+    }
+}
+
+Bool Physics_IsGrounded(const FPhysics* Physics, const U32 Body) {
+    return Physics->Bodies[Body].bGrounded;
+}
+
+Bool Physics_IsSleeping(const FPhysics* Physics, const U32 Body) {
+    return Physics->Bodies[Body].bSleeping;
+}
+
+void Physics_WakeBlocks(FPhysics* Physics, const I32 Min[3], const I32 Max[3]) {
+    for (U32 Index = 0; Index < Physics->UsedBodyCount; Index++) {
+        FPhysicsBody* Body = &Physics->Bodies[Index];
+        if (!Body->bActive || !Body->bSleeping) {
+            continue;
+        }
+
+        // Touching counts, a body resting on a removed block is exactly on its face.
+        Bool bTouching = True;
+        for (U32 Axis = 0; Axis < 3; Axis++) {
+            bTouching = bTouching && Body->Position[Axis] + Body->HalfExtents[Axis] + PHYSICS_SKIN >= (F32)Min[Axis] &&
+                        Body->Position[Axis] - Body->HalfExtents[Axis] - PHYSICS_SKIN <= (F32)(Max[Axis] + 1);
+        }
+        if (bTouching) {
+            Body->bSleeping = False;
+            Body->QuietSteps = 0;
+        }
+    }
+}
+
+U32 Physics_Update(FPhysics* Physics, const F64 DeltaSeconds) {
+    const U64 Start = Clock_GetNanoseconds();
+
+    Physics->Accumulator += DeltaSeconds;
+    U32 Steps = 0;
+    while (Physics->Accumulator >= Physics->Settings.StepSeconds && Steps < Physics->Settings.MaxStepsPerUpdate) {
+        Physics_Step(Physics);
+        Physics->Accumulator -= Physics->Settings.StepSeconds;
+        Steps++;
+    }
+
+    if (Physics->Accumulator >= Physics->Settings.StepSeconds) {
+        const F64 Dropped = Physics->Accumulator - fmod(Physics->Accumulator, Physics->Settings.StepSeconds);
+        Physics->Stats.DroppedSeconds += Dropped;
+        Physics->Accumulator -= Dropped;
+    }
+
+    Physics->Stats.Steps = Steps;
+    Physics->Stats.StepNanoseconds = Steps > 0 ? Clock_GetNanoseconds() - Start : 0;
+
+    return Steps;
+}
+
+void Physics_GetStats(const FPhysics* Physics, FPhysicsStats* OutStats) {
+    *OutStats = Physics->Stats;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+int Physics_WorkerMain(void* UserData) {
+    FPhysics* Physics = UserData;
+
+    U32 Generation = 0;
+    Mutex_Lock(Physics->Mutex);
+    for (;;) {
+        while (Physics->PhaseGeneration == Generation && !Physics->bStopping) {
+            Condition_Wait(Physics->PhaseStarted, Physics->Mutex);
+        }
+
+        if (Physics->bStopping) {
+            break;
+        }
+
+        Generation = Physics->PhaseGeneration;
+        Mutex_Unlock(Physics->Mutex);
+        Physics_WorkJobs(Physics);
+        Mutex_Lock(Physics->Mutex);
+    }
+    Mutex_Unlock(Physics->Mutex);
+
+    return 0;
+}
+
+void Physics_RunPhase(FPhysics* Physics, const EPhysicsPhase Phase) {
+    if (Physics->WorkerCount == 0 || Physics->JobCount <= 1) {
+        for (U32 Index = 0; Index < Physics->JobCount; Index++) {
+            Physics_RunJob(Physics, Phase, &Physics->Jobs[Index]);
+        }
+        return;
+    }
+
+    Mutex_Lock(Physics->Mutex);
+    Physics->Phase = Phase;
+    Physics->PhaseJobCount = Physics->JobCount;
+    Physics->NextJob = 0;
+    Physics->FinishedJobs = 0;
+    Physics->PhaseGeneration++;
+    Condition_Broadcast(Physics->PhaseStarted);
+    Mutex_Unlock(Physics->Mutex);
+
+    Physics_WorkJobs(Physics);
+
+    Mutex_Lock(Physics->Mutex);
+    while (Physics->FinishedJobs < Physics->PhaseJobCount) {
+        Condition_Wait(Physics->PhaseFinished, Physics->Mutex);
+    }
+    Mutex_Unlock(Physics->Mutex);
+}
+
+void Physics_WorkJobs(FPhysics* Physics) {
+    Mutex_Lock(Physics->Mutex);
+    while (Physics->NextJob < Physics->PhaseJobCount) {
+        FPhysicsJob* Job = &Physics->Jobs[Physics->NextJob++];
+        const EPhysicsPhase Phase = Physics->Phase;
+        Mutex_Unlock(Physics->Mutex);
+
+        Physics_RunJob(Physics, Phase, Job);
+
+        Mutex_Lock(Physics->Mutex);
+        if (++Physics->FinishedJobs == Physics->PhaseJobCount) {
+            Condition_Signal(Physics->PhaseFinished);
+        }
+    }
+    Mutex_Unlock(Physics->Mutex);
+}
+
+void Physics_RunJob(FPhysics* Physics, const EPhysicsPhase Phase, FPhysicsJob* Job) {
+    FPhysicsCache Cache;
+    memset(&Cache, 0, sizeof Cache);
+    Cache.World = Physics->Settings.World;
+
+    for (U32 Index = Job->Begin; Index < Job->End; Index++) {
+        const U32 BodyIndex = Physics->Order[Index];
+        FPhysicsBody* Body = &Physics->Bodies[BodyIndex];
+        switch (Phase) {
+        case PHYSICS_PHASE_MOVE:
+            Physics_MoveBody(Physics, Body, &Cache);
+            break;
+        case PHYSICS_PHASE_CONTACTS:
+            Job->Contacts += Physics_GatherContacts(Physics, BodyIndex);
+            break;
+        case PHYSICS_PHASE_RESOLVE:
+            Physics_ResolveBody(Physics, Body, &Cache);
+            break;
+        }
+    }
+}
+
+void Physics_Step(FPhysics* Physics) {
+    Physics_SortRegions(Physics);
+    Physics_RunPhase(Physics, PHYSICS_PHASE_MOVE);
+
+    // Without room for the broadphase the bodies still move through the blocks, they only pass through each other.
+    if (Physics_BuildBroadphase(Physics)) {
+        for (U32 Index = 0; Index < Physics->JobCount; Index++) {
+            Physics->Jobs[Index].Contacts = 0;
+        }
+        Physics_RunPhase(Physics, PHYSICS_PHASE_CONTACTS);
+        Physics_RunPhase(Physics, PHYSICS_PHASE_RESOLVE);
+    }
+
+    Physics->Stats.Contacts = 0;
+    Physics->Stats.AwakeBodies = 0;
+    for (U32 Index = 0; Index < Physics->JobCount; Index++) {
+        Physics->Stats.Contacts += Physics->Jobs[Index].Contacts;
+    }
+    for (U32 Index = 0; Index < Physics->OrderCount; Index++) {
+        Physics->Stats.AwakeBodies += !Physics->Bodies[Physics->Order[Index]].bSleeping;
+    }
+    Physics->Stats.Jobs = Physics->JobCount;
+}
+
+void Physics_SortRegions(FPhysics* Physics) {
+    U32* Starts = Physics->RegionBucketStarts;
+    memset(Starts, 0, sizeof Physics->RegionBucketStarts);
+
+    // Counting sort by region bucket, the bodies keep their id order within a bucket.
+    const F32 RegionSize = (F32)Physics->Settings.RegionSize;
+    U32 Count = 0;
+    for (U32 Index = 0; Index < Physics->UsedBodyCount; Index++) {
+        const FPhysicsBody* Body = &Physics->Bodies[Index];
+        if (!Body->bActive) {
+            continue;
+        }
+
+        const U32 Bucket = Physics_HashCell((I32)floorf(Body->Position[0] / RegionSize), (I32)floorf(Body->Position[1] / RegionSize),
+                                            (I32)floorf(Body->Position[2] / RegionSize)) &
+                           (PHYSICS_REGION_BUCKETS - 1);
+        Physics->OrderBuckets[Count++] = Bucket;
+        Starts[Bucket + 1]++;
+    }
+
+    for (U32 Bucket = 0; Bucket < PHYSICS_REGION_BUCKETS; Bucket++) {
+        Starts[Bucket + 1] += Starts[Bucket];
+    }
+
+    U32 Cursors[PHYSICS_REGION_BUCKETS];
+    memcpy(Cursors, Starts, sizeof Cursors);
+    U32 Active = 0;
+    for (U32 Index = 0; Index < Physics->UsedBodyCount; Index++) {
+        if (Physics->Bodies[Index].bActive) {
+            Physics->Order[Cursors[Physics->OrderBuckets[Active++]]++] = Index;
+        }
+    }
+    Physics->OrderCount = Count;
+
+    // Whole buckets are grouped until a job has enough bodies to outweigh handing it to a thread.
+    Physics->JobCount = 0;
+    U32 Begin = 0;
+    for (U32 Bucket = 0; Bucket < PHYSICS_REGION_BUCKETS; Bucket++) {
+        const U32 End = Starts[Bucket + 1];
+        if (End - Begin >= PHYSICS_JOB_BODIES || (Bucket + 1 == PHYSICS_REGION_BUCKETS && End > Begin)) {
+            Physics->Jobs[Physics->JobCount++] = (FPhysicsJob){Begin, End, 0};
+            Begin = End;
+        }
+    }
+}
+
+Bool Physics_BuildBroadphase(FPhysics* Physics) {
+    U32 EntryCount = 0;
+    for (U32 Index = 0; Index < Physics->OrderCount; Index++) {
+        const FPhysicsBody* Body = &Physics->Bodies[Physics->Order[Index]];
+        U32 Cells = 1;
+        for (U32 Axis = 0; Axis < 3; Axis++) {
+            Cells *= (U32)(Physics_GetCell(Body->Position[Axis] + Body->HalfExtents[Axis]) - Physics_GetCell(Body->Position[Axis] - Body->HalfExtents[Axis]) + 1);
+        }
+        EntryCount += Cells;
+    }
+
+    // Twice as many buckets as entries keeps the buckets short.
+    U32 BucketCount = 64;
+    while (BucketCount < EntryCount * 2) {
+        BucketCount *= 2;
+    }
+
+    if (EntryCount > Physics->EntryCapacity) {
+        const U32 Capacity = EntryCount + EntryCount / 2;
+        FPhysicsCellEntry* Entries = realloc(Physics->Entries, Capacity * sizeof(FPhysicsCellEntry));
+        if (Entries == NULL) {
+            return False;
+        }
+        Physics->Entries = Entries;
+        Physics->EntryCapacity = Capacity;
+    }
+
+    if (BucketCount != Physics->CellBucketCount) {
+        U32* Starts = realloc(Physics->CellBucketStarts, (BucketCount + 1) * sizeof(U32));
+        if (Starts == NULL) {
+            return False;
+        }
+        Physics->CellBucketStarts = Starts;
+        Physics->CellBucketCount = BucketCount;
+    }
+
+    U32* Starts = Physics->CellBucketStarts;
+    memset(Starts, 0, (BucketCount + 1) * sizeof(U32));
+    for (U32 Pass = 0; Pass < 2; Pass++) {
+        for (U32 Index = 0; Index < Physics->OrderCount; Index++) {
+            const U32 BodyIndex = Physics->Order[Index];
+            const FPhysicsBody* Body = &Physics->Bodies[BodyIndex];
+            I32 Min[3];
+            I32 Max[3];
+            for (U32 Axis = 0; Axis < 3; Axis++) {
+                Min[Axis] = Physics_GetCell(Body->Position[Axis] - Body->HalfExtents[Axis]);
+                Max[Axis] = Physics_GetCell(Body->Position[Axis] + Body->HalfExtents[Axis]);
+            }
+
+            for (I32 Y = Min[1]; Y <= Max[1]; Y++) {
+                for (I32 Z = Min[2]; Z <= Max[2]; Z++) {
+                    for (I32 X = Min[0]; X <= Max[0]; X++) {
+                        const U32 Bucket = Physics_HashCell(X, Y, Z) & (BucketCount - 1);
+                        // The first pass counts the entries of each bucket, the second one places them.
+                        if (Pass == 0) {
+                            Starts[Bucket + 1]++;
+                        } else {
+                            Physics->Entries[Starts[Bucket]++] = (FPhysicsCellEntry){X, Y, Z, BodyIndex};
+                        }
+                    }
+                }
+            }
+        }
+
+        if (Pass == 0) {
+            for (U32 Bucket = 0; Bucket < BucketCount; Bucket++) {
+                Starts[Bucket + 1] += Starts[Bucket];
+            }
+        }
+    }
+
+    // Placing advanced each start to the next bucket, shifting them back restores the offsets.
+    for (U32 Bucket = BucketCount; Bucket > 0; Bucket--) {
+        Starts[Bucket] = Starts[Bucket - 1];
+    }
+    Starts[0] = 0;
+    Physics->EntryCount = EntryCount;
+
+    return True;
+}
+
+void Physics_MoveBody(FPhysics* Physics, FPhysicsBody* Body, FPhysicsCache* Cache) {
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Body->PreviousPosition[Axis] = Body->Position[Axis];
+    }
+
+    if (Body->bSleeping) {
+        return;
+    }
+
+    const F32 StepSeconds = Physics->Settings.StepSeconds;
+    Body->Velocity[1] += Physics->Settings.Gravity * StepSeconds;
+    if (Body->bGrounded) {
+        const F32 Speed = sqrtf(Body->Velocity[0] * Body->Velocity[0] + Body->Velocity[2] * Body->Velocity[2]);
+        const F32 Slowed = Speed - Physics->Settings.Friction * StepSeconds;
+        const F32 Scale = Slowed > 0.f ? Slowed / Speed : 0.f;
+        Body->Velocity[0] *= Scale;
+        Body->Velocity[2] *= Scale;
+    }
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Body->Velocity[Axis] = Body->Velocity[Axis] > PHYSICS_MAX_SPEED ? PHYSICS_MAX_SPEED : Body->Velocity[Axis];
+        Body->Velocity[Axis] = Body->Velocity[Axis] < -PHYSICS_MAX_SPEED ? -PHYSICS_MAX_SPEED : Body->Velocity[Axis];
+    }
+
+    // Axes are moved one after another so a body blocked on one axis keeps sliding along the others.
+    static const U32 AxisOrder[3] = {1, 0, 2};
+    Body->bGrounded = False;
+    for (U32 Index = 0; Index < 3; Index++) {
+        const U32 Axis = AxisOrder[Index];
+        const F32 Move = Body->Velocity[Axis] * StepSeconds;
+        const F32 Allowed = Physics_SweepAxis(Cache, Body, Axis, Move);
+        Body->Position[Axis] += Allowed;
+        if (Allowed != Move) {
+            Body->bGrounded = Body->bGrounded || (Axis == 1 && Move < 0.f);
+            Body->Velocity[Axis] = 0.f;
+        }
+    }
+}
+
+U32 Physics_GatherContacts(FPhysics* Physics, const U32 BodyIndex) {
+    FPhysicsBody* Body = &Physics->Bodies[BodyIndex];
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Body->Correction[Axis] = 0.f;
+        Body->VelocityCorrection[Axis] = 0.f;
+    }
+    Body->bWoken = False;
+
+    I32 Min[3];
+    I32 Max[3];
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Min[Axis] = Physics_GetCell(Body->Position[Axis] - Body->HalfExtents[Axis]);
+        Max[Axis] = Physics_GetCell(Body->Position[Axis] + Body->HalfExtents[Axis]);
+    }
+
+    U32 Contacts = 0;
+    const U32 BucketMask = Physics->CellBucketCount - 1;
+    for (I32 Y = Min[1]; Y <= Max[1]; Y++) {
+        for (I32 Z = Min[2]; Z <= Max[2]; Z++) {
+            for (I32 X = Min[0]; X <= Max[0]; X++) {
+                const U32 Bucket = Physics_HashCell(X, Y, Z) & BucketMask;
+                for (U32 Entry = Physics->CellBucketStarts[Bucket]; Entry < Physics->CellBucketStarts[Bucket + 1]; Entry++) {
+                    const FPhysicsCellEntry* CellEntry = &Physics->Entries[Entry];
+                    if (CellEntry->Body == BodyIndex || CellEntry->X != X || CellEntry->Y != Y || CellEntry->Z != Z) {
+                        continue;
+                    }
+
+                    const FPhysicsBody* Other = &Physics->Bodies[CellEntry->Body];
+                    if (Body->bSleeping && Other->bSleeping) {
+                        continue;
+                    }
+
+                    F32 Offset[3];
+                    F32 Penetration[3];
+                    Bool bOverlapping = True;
+                    for (U32 Axis = 0; Axis < 3; Axis++) {
+                        Offset[Axis] = Body->Position[Axis] - Other->Position[Axis];
+                        Penetration[Axis] = Body->HalfExtents[Axis] + Other->HalfExtents[Axis] - fabsf(Offset[Axis]);
+                        bOverlapping = bOverlapping && Penetration[Axis] > PHYSICS_SKIN;
+                    }
+                    if (!bOverlapping) {
+                        continue;
+                    }
+
+                    // Pairs sharing several cells are only handled in the cell of the corner where their overlap starts.
+                    Bool bFirstCell = True;
+                    const I32 Cell[3] = {X, Y, Z};
+                    for (U32 Axis = 0; Axis < 3; Axis++) {
+                        const F32 BodyMin = Body->Position[Axis] - Body->HalfExtents[Axis];
+                        const F32 OtherMin = Other->Position[Axis] - Other->HalfExtents[Axis];
+                        bFirstCell = bFirstCell && Physics_GetCell(BodyMin > OtherMin ? BodyMin : OtherMin) == Cell[Axis];
+                    }
+                    if (!bFirstCell) {
+                        continue;
+                    }
+
+                    const U32 Axis = Penetration[0] < Penetration[1] ? (Penetration[0] < Penetration[2] ? 0 : 2) : (Penetration[1] < Penetration[2] ? 1 : 2);
+                    const F32 Sign = Offset[Axis] > 0.f ? 1.f : Offset[Axis] < 0.f ? -1.f : BodyIndex < CellEntry->Body ? -1.f : 1.f;
+                    Contacts += BodyIndex < CellEntry->Body;
+
+                    // Sleeping bodies hold up the bodies stacked on them, sideways pushes wake them.
+                    F32 Share = 0.5f;
+                    if (Axis == 1 && Body->bSleeping) {
+                        continue;
+                    }
+                    if (Axis == 1 && Other->bSleeping) {
+                        Share = 1.f;
+                    }
+                    if (Body->bSleeping) {
+                        Body->bWoken = True;
+                    }
+
+                    Body->Correction[Axis] += Sign * Penetration[Axis] * Share;
+                    const F32 Approach = Body->Velocity[Axis] - Other->Velocity[Axis];
+                    if (Sign * Approach < 0.f) {
+                        Body->VelocityCorrection[Axis] -= Approach * Share;
+                    }
+                    if (Axis == 1 && Sign > 0.f) {
+                        Body->bGrounded = True;
+                    }
+                }
+            }
+        }
+    }
+
+    return Contacts;
+}
+
+void Physics_ResolveBody(FPhysics* Physics, FPhysicsBody* Body, FPhysicsCache* Cache) {
+    if (Body->bWoken) {
+        Body->bSleeping = False;
+        Body->QuietSteps = 0;
+    }
+
+    if (Body->bSleeping) {
+        return;
+    }
+
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        if (Body->Correction[Axis] != 0.f) {
+            Body->Position[Axis] += Physics_SweepAxis(Cache, Body, Axis, Body->Correction[Axis]);
+        }
+        Body->Velocity[Axis] += Body->VelocityCorrection[Axis];
+    }
+
+    const F32 SpeedSquared = Body->Velocity[0] * Body->Velocity[0] + Body->Velocity[1] * Body->Velocity[1] + Body->Velocity[2] * Body->Velocity[2];
+    if (Body->bGrounded && SpeedSquared < Physics->Settings.SleepSpeed * Physics->Settings.SleepSpeed) {
+        if (++Body->QuietSteps >= Physics->Settings.SleepSteps) {
+            Body->bSleeping = True;
+            memset(Body->Velocity, 0, sizeof Body->Velocity);
+        }
+    } else {
+        Body->QuietSteps = 0;
+    }
+}
+
+F32 Physics_SweepAxis(FPhysicsCache* Cache, const FPhysicsBody* Body, const U32 Axis, const F32 Move) {
+    if (Move == 0.f) {
+        return 0.f;
+    }
+
+    // Blocks the box spans on the other axes, faces only touching a block don't span it.
+    const U32 AxisA = (Axis + 1) % 3;
+    const U32 AxisB = (Axis + 2) % 3;
+    const I32 MinA = (I32)floorf(Body->Position[AxisA] - Body->HalfExtents[AxisA] + PHYSICS_SKIN);
+    const I32 MaxA = (I32)floorf(Body->Position[AxisA] + Body->HalfExtents[AxisA] - PHYSICS_SKIN);
+    const I32 MinB = (I32)floorf(Body->Position[AxisB] - Body->HalfExtents[AxisB] + PHYSICS_SKIN);
+    const I32 MaxB = (I32)floorf(Body->Position[AxisB] + Body->HalfExtents[AxisB] - PHYSICS_SKIN);
+
+    // Layers of blocks ahead of the leading face are checked in order, the first one with a solid block stops the box.
+    const F32 Leading = Move > 0.f ? Body->Position[Axis] + Body->HalfExtents[Axis] : Body->Position[Axis] - Body->HalfExtents[Axis];
+    const I32 Step = Move > 0.f ? 1 : -1;
+    const I32 First = Move > 0.f ? (I32)ceilf(Leading - PHYSICS_SKIN) : (I32)floorf(Leading + PHYSICS_SKIN) - 1;
+    const I32 Last = Move > 0.f ? (I32)ceilf(Leading + Move) - 1 : (I32)floorf(Leading + Move);
+    for (I32 Layer = First; Move > 0.f ? Layer <= Last : Layer >= Last; Layer += Step) {
+        for (I32 A = MinA; A <= MaxA; A++) {
+            for (I32 B = MinB; B <= MaxB; B++) {
+                I32 Block[3];
+                Block[Axis] = Layer;
+                Block[AxisA] = A;
+                Block[AxisB] = B;
+                if (!Physics_IsSolid(Cache, Block[0], Block[1], Block[2])) {
+                    continue;
+                }
+
+                if (Move > 0.f) {
+                    const F32 Allowed = (F32)Layer - PHYSICS_SKIN * 0.5f - Leading;
+                    return Allowed > 0.f ? Allowed : 0.f;
+                }
+
+                const F32 Allowed = (F32)(Layer + 1) + PHYSICS_SKIN * 0.5f - Leading;
+                return Allowed < 0.f ? Allowed : 0.f;
+            }
+        }
+    }
+
+    return Move;
+}
+
+Bool Physics_IsSolid(FPhysicsCache* Cache, const I32 X, const I32 Y, const I32 Z) {
+    const I32 ChunkX = World_GetChunkCoordinate(X);
+    const I32 ChunkY = World_GetChunkCoordinate(Y);
+    const I32 ChunkZ = World_GetChunkCoordinate(Z);
+    FPhysicsCacheEntry* Entry = &Cache->Entries[Physics_HashCell(ChunkX, ChunkY, ChunkZ) & (PHYSICS_CACHE_SIZE - 1)];
+    if (!Entry->bValid || Entry->X != ChunkX || Entry->Y != ChunkY || Entry->Z != ChunkZ) {
+        *Entry = (FPhysicsCacheEntry){ChunkX, ChunkY, ChunkZ, True, World_GetChunk(Cache->World, ChunkX, ChunkY, ChunkZ)};
+    }
+
+    // Bodies wait at the border of the loaded world instead of falling out of it.
+    if (Entry->Chunk == NULL) {
+        return True;
+    }
+
+    return Block_IsSolid(Chunk_GetBlockType(Entry->Chunk, X - ChunkX * CHUNK_SIZE, Y - ChunkY * CHUNK_SIZE, Z - ChunkZ * CHUNK_SIZE));
+}
+
+U32 Physics_HashCell(const I32 X, const I32 Y, const I32 Z) {
+    // The high bits mix all three coordinates, they are folded down so masks of any size see them.
+    const U32 Hash = (U32)X * 0x8DA6B343u ^ (U32)Y * 0xD8163841u ^ (U32)Z * 0xCB1AB31Fu;
+    return Hash ^ Hash >> 16;
+}
+
+I32 Physics_GetCell(const F32 Coordinate) {
+    return (I32)floorf(Coordinate / PHYSICS_CELL_SIZE);
+}
+#pragma endregion
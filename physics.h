@@ -1 +1,81 @@
 #pragma once
+#include "typedefs.h"
+#include "world.h"
+
+/**
+ * Moves axis aligned boxes through the blocks of a world on a fixed step. Bodies slide along the blocks they hit, push
+ * each other apart and fall asleep once they rest on the ground.
+ */
+typedef struct FPhysics FPhysics;
+
+typedef struct {
+    /** World the bodies collide with, read during updates. Blocks of chunks that aren't loaded are solid. */
+    const FWorld* World;
+    /** Vertical acceleration in blocks per second squared. */
+    F32 Gravity;
+    /** Horizontal deceleration of grounded bodies in blocks per second squared. */
+    F32 Friction;
+    /** Simulated time per step in seconds. */
+    F32 StepSeconds;
+    /** Steps an update runs at most, time beyond them is dropped so a slow frame doesn't slow down the next ones. */
+    U32 MaxStepsPerUpdate;
+    /** Bodies that can exist at once. */
+    U32 MaxBodies;
+    /** Supported bodies slower than the speed in blocks per second for the number of steps fall asleep. */
+    F32 SleepSpeed;
+    U32 SleepSteps;
+    /** Size of the regions in blocks, the bodies of a region are stepped together by one thread. */
+    U32 RegionSize;
+    /** Worker threads, 0 uses all processors but one. The updating thread steps regions too. */
+    U32 WorkerCount;
+} FPhysicsSettings;
+
+typedef struct {
+    /** Bodies that exist and bodies among them that are awake. */
+    U32 Bodies;
+    U32 AwakeBodies;
+    /** Steps run by the last update and the time they took. */
+    U32 Steps;
+    U64 StepNanoseconds;
+    /** Overlapping body pairs found by the last step, each pair is counted once. */
+    U32 Contacts;
+    /** Groups of regions stepped by the threads in the last step. */
+    U32 Jobs;
+    /** Seconds dropped since the physics was created because updates ran out of steps. */
+    F64 DroppedSeconds;
+} FPhysicsStats;
+
+/** Fills the settings with defaults, the world is left NULL. */
+void Physics_GetDefaultSettings(FPhysicsSettings* OutSettings);
+
+/** Creates the physics and starts its workers. Returns NULL on failure. */
+FPhysics* Physics_Create(const FPhysicsSettings* Settings);
+
+/** Stops the workers and frees the bodies. */
+void Physics_Destroy(FPhysics* Physics);
+
+/** Adds an awake body centered at the position. Returns the body id, InvalidId when there is no room for it. */
+U32 Physics_AddBody(FPhysics* Physics, const F32 Position[3], const F32 HalfExtents[3]);
+
+void Physics_RemoveBody(FPhysics* Physics, U32 Body);
+
+/** Sets the velocity in blocks per second and wakes the body. */
+void Physics_SetVelocity(FPhysics* Physics, U32 Body, const F32 Velocity[3]);
+
+void Physics_GetVelocity(const FPhysics* Physics, U32 Body, F32 OutVelocity[3]);
+
+/** Returns the center of the body interpolated between the last two steps by the time left over from the last update. */
+void Physics_GetPosition(const FPhysics* Physics, U32 Body, F32 OutPosition[3]);
+
+/** Returns True when the body stands on a block or another body. */
+Bool Physics_IsGrounded(const FPhysics* Physics, U32 Body);
+
+Bool Physics_IsSleeping(const FPhysics* Physics, U32 Body);
+
+/** Wakes the bodies touching the box of world blocks, sleeping bodies don't notice blocks changing under them. */
+void Physics_WakeBlocks(FPhysics* Physics, const I32 Min[3], const I32 Max[3]);
+
+/** Runs the steps the elapsed time adds up to. Returns the number of steps run. */
+U32 Physics_Update(FPhysics* Physics, F64 DeltaSeconds);
+
+void Physics_GetStats(const FPhysics* Physics, FPhysicsStats* OutStats);
@@ -0,0 +1,142 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "check.h"
+#include "physics.h"
+
+#pragma region Settings
+/** Ground chunks, 3x3 around the chunk at the origin. */
+#define PHYSICS_TEST_CHUNKS 9
+/** Wall along Z at this X, one block thick and a few blocks high. */
+#define PHYSICS_TEST_WALL_X 20
+#define PHYSICS_TEST_WALL_HEIGHT 4
+#define PHYSICS_TEST_TOLERANCE 1e-3f
+#pragma endregion
+
+typedef struct {
+    FChunk* Chunks[PHYSICS_TEST_CHUNKS];
+    FWorld* World;
+    FPhysicsSettings Settings;
+    FPhysics* Physics;
+} FPhysicsTest;
+
+static const F32 PhysicsTestHalfExtents[3] = {0.3f, 0.9f, 0.3f};
+
+#pragma region Private Function Declarations
+static void PhysicsTest_Create(FPhysicsTest* Test);
+static void PhysicsTest_Destroy(FPhysicsTest* Test);
+static void PhysicsTest_Step(FPhysicsTest* Test, U32 StepCount);
+static void PhysicsTest_Slide(FPhysicsTest* Test, F32 SpeedX);
+static void PhysicsTest_Land(FPhysicsTest* Test);
+#pragma endregion
+
+int main() {
+    FPhysicsTest Test;
+    PhysicsTest_Create(&Test);
+
+    PhysicsTest_Land(&Test);
+    PhysicsTest_Slide(&Test, 5.f);
+
+    // Fast enough to cross the wall within one step without the sweep.
+    PhysicsTest_Slide(&Test, 90.f);
+
+    PhysicsTest_Destroy(&Test);
+
+    printf("physics_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void PhysicsTest_Create(FPhysicsTest* Test) {
+    Test->World = World_Create();
+    CHECK(Test->World != NULL);
+
+    for (I32 Index = 0; Index < PHYSICS_TEST_CHUNKS; Index++) {
+        FChunk* Chunk = Chunk_Create(Index % 3 - 1, 0, Index / 3 - 1);
+        CHECK(Chunk != NULL);
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            for (I32 X = 0; X < CHUNK_SIZE; X++) {
+                Chunk_SetBlockType(Chunk, X, 0, Z, BLOCK_TYPE_STONE);
+            }
+        }
+        World_AddChunk(Test->World, Chunk);
+        Test->Chunks[Index] = Chunk;
+    }
+
+    FChunk* Chunk = World_GetChunk(Test->World, 0, 0, 0);
+    for (I32 Y = 1; Y <= PHYSICS_TEST_WALL_HEIGHT; Y++) {
+        for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+            Chunk_SetBlockType(Chunk, PHYSICS_TEST_WALL_X, Y, Z, BLOCK_TYPE_STONE);
+        }
+    }
+
+    Physics_GetDefaultSettings(&Test->Settings);
+    Test->Settings.World = Test->World;
+    Test->Settings.Friction = 0.f;
+    Test->Settings.WorkerCount = 1;
+    Test->Physics = Physics_Create(&Test->Settings);
+    CHECK(Test->Physics != NULL);
+}
+
+void PhysicsTest_Destroy(FPhysicsTest* Test) {
+    Physics_Destroy(Test->Physics);
+    World_Destroy(Test->World);
+    for (I32 Index = 0; Index < PHYSICS_TEST_CHUNKS; Index++) {
+        Chunk_Destroy(Test->Chunks[Index]);
+    }
+}
+
+void PhysicsTest_Step(FPhysicsTest* Test, const U32 StepCount) {
+    U32 Steps = 0;
+    for (U32 Index = 0; Index < StepCount; Index++) {
+        Steps += Physics_Update(Test->Physics, Test->Settings.StepSeconds);
+    }
+    CHECK(Steps + 1 >= StepCount && Steps <= StepCount + 1);
+}
+
+void PhysicsTest_Land(FPhysicsTest* Test) {
+    const F32 Position[3] = {10.5f, 8.f, 10.5f};
+    const U32 Body = Physics_AddBody(Test->Physics, Position, PhysicsTestHalfExtents);
+    CHECK(Body != InvalidId);
+
+    // A dropped body comes to rest on the ground and falls asleep.
+    PhysicsTest_Step(Test, 120);
+    F32 Landed[3];
+    Physics_GetPosition(Test->Physics, Body, Landed);
+    CHECK(fabsf(Landed[1] - (1.f + PhysicsTestHalfExtents[1])) < PHYSICS_TEST_TOLERANCE);
+    CHECK(fabsf(Landed[0] - Position[0]) < PHYSICS_TEST_TOLERANCE && fabsf(Landed[2] - Position[2]) < PHYSICS_TEST_TOLERANCE);
+    CHECK(Physics_IsGrounded(Test->Physics, Body));
+    CHECK(Physics_IsSleeping(Test->Physics, Body));
+
+    Physics_RemoveBody(Test->Physics, Body);
+}
+
+void PhysicsTest_Slide(FPhysicsTest* Test, const F32 SpeedX) {
+    const F32 Position[3] = {12.5f, 1.f + PhysicsTestHalfExtents[1], 4.5f};
+    const U32 Body = Physics_AddBody(Test->Physics, Position, PhysicsTestHalfExtents);
+    CHECK(Body != InvalidId);
+    PhysicsTest_Step(Test, 2);
+
+    // Moving diagonally into the wall stops the motion into it and keeps the motion along it.
+    const F32 SpeedZ = 3.f;
+    const F32 Velocity[3] = {SpeedX, 0.f, SpeedZ};
+    Physics_SetVelocity(Test->Physics, Body, Velocity);
+
+    const U32 StepCount = 120;
+    PhysicsTest_Step(Test, StepCount);
+
+    F32 Moved[3];
+    Physics_GetPosition(Test->Physics, Body, Moved);
+    CHECK(fabsf(Moved[0] - ((F32)PHYSICS_TEST_WALL_X - PhysicsTestHalfExtents[0])) < PHYSICS_TEST_TOLERANCE);
+    CHECK(fabsf(Moved[1] - Position[1]) < PHYSICS_TEST_TOLERANCE);
+    CHECK(fabsf(Moved[2] - (Position[2] + SpeedZ * (F32)StepCount * Test->Settings.StepSeconds)) < 0.1f);
+
+    F32 Slid[3];
+    Physics_GetVelocity(Test->Physics, Body, Slid);
+    CHECK(Slid[0] == 0.f);
+    CHECK(fabsf(Slid[2] - SpeedZ) < PHYSICS_TEST_TOLERANCE);
+    CHECK(Physics_IsGrounded(Test->Physics, Body));
+
+    Physics_RemoveBody(Test->Physics, Body);
+}
+#pragma endregion
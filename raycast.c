@@ -0,0 +1,228 @@
+#include "raycast.h"
+
+#include <math.h>
+#include <string.h>
+
+#pragma region Settings
+/** Rays a batch prepares at once, the preparation loops run over whole arrays so they vectorize. */
+#define RAYCAST_BATCH_SIZE 64
+/** Chunk lookups remembered by a cast, a power of two. Rays of a batch mostly cross the same chunks. */
+#define RAYCAST_CACHE_SIZE 16
+#pragma endregion
+
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Bool bValid;
+    const FChunk* Chunk;
+} FRaycastCacheEntry;
+
+/** Direct mapped chunk lookups, missing chunks are remembered too. */
+typedef struct {
+    FRaycastCacheEntry Entries[RAYCAST_CACHE_SIZE];
+} FRaycastCache;
+
+/** Ray with a normalized direction. */
+typedef struct {
+    F32 Origin[3];
+    F32 Direction[3];
+    F32 InverseDirection[3];
+    F32 MaxDistance;
+} FRaycastRay;
+
+#pragma region Private Function Declarations
+/** Walks the blocks of the ray, Amanatides and Woo traversal with empty chunks and cells crossed in one step. */
+static Bool Raycast_Traverse(const FWorld* World, FRaycastCache* Cache, const FRaycastRay* Ray, FRaycastHit* OutHit);
+
+static const FChunk* Raycast_GetChunk(const FWorld* World, FRaycastCache* Cache, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns the face of the block entered by a step along the axis. */
+static EDirection Raycast_GetEnteredFace(U32 Axis, I32 Step);
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Raycast_Cast(const FWorld* World, const F32 Origin[3], const F32 Direction[3], const F32 MaxDistance, FRaycastHit* OutHit) {
+    const F32 Length = sqrtf(Direction[0] * Direction[0] + Direction[1] * Direction[1] + Direction[2] * Direction[2]);
+    if (Length == 0.f) {
+        memset(OutHit, 0, sizeof *OutHit);
+        return False;
+    }
+
+    FRaycastRay Ray;
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Ray.Origin[Axis] = Origin[Axis];
+        Ray.Direction[Axis] = Direction[Axis] / Length;
+        Ray.InverseDirection[Axis] = 1.f / Ray.Direction[Axis];
+    }
+    Ray.MaxDistance = MaxDistance;
+
+    FRaycastCache Cache;
+    memset(&Cache, 0, sizeof Cache);
+
+    return Raycast_Traverse(World, &Cache, &Ray, OutHit);
+}
+
+U32 Raycast_CastBatch(const FWorld* World, const FRaycastRays* Rays, const U32 Count, FRaycastHit* OutHits) {
+    FRaycastCache Cache;
+    memset(&Cache, 0, sizeof Cache);
+
+    F32 DirectionX[RAYCAST_BATCH_SIZE];
+    F32 DirectionY[RAYCAST_BATCH_SIZE];
+    F32 DirectionZ[RAYCAST_BATCH_SIZE];
+
+    U32 HitCount = 0;
+    for (U32 Begin = 0; Begin < Count; Begin += RAYCAST_BATCH_SIZE) {
+        const U32 Size = Count - Begin < RAYCAST_BATCH_SIZE ? Count - Begin : RAYCAST_BATCH_SIZE;
+
+        // Branch free over the component arrays, zero directions come out as NaN and are skipped below.
+        for (U32 Index = 0; Index < Size; Index++) {
+            const F32 X = Rays->DirectionX[Begin + Index];
+            const F32 Y = Rays->DirectionY[Begin + Index];
+            const F32 Z = Rays->DirectionZ[Begin + Index];
+            const F32 Length = sqrtf(X * X + Y * Y + Z * Z);
+            DirectionX[Index] = X / Length;
+            DirectionY[Index] = Y / Length;
+            DirectionZ[Index] = Z / Length;
+        }
+
+        for (U32 Index = 0; Index < Size; Index++) {
+            FRaycastHit* Hit = &OutHits[Begin + Index];
+            if (isnan(DirectionX[Index])) {
+                memset(Hit, 0, sizeof *Hit);
+                continue;
+            }
+
+            const FRaycastRay Ray = {
+                {Rays->OriginX[Begin + Index], Rays->OriginY[Begin + Index], Rays->OriginZ[Begin + Index]},
+                {DirectionX[Index], DirectionY[Index], DirectionZ[Index]},
+                {1.f / DirectionX[Index], 1.f / DirectionY[Index], 1.f / DirectionZ[Index]},
+                Rays->MaxDistance[Begin + Index],
+            };
+            HitCount += Raycast_Traverse(World, &Cache, &Ray, Hit);
+        }
+    }
+
+    return HitCount;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+Bool Raycast_Traverse(const FWorld* World, FRaycastCache* Cache, const FRaycastRay* Ray, FRaycastHit* OutHit) {
+    I32 Block[3];
+    I32 Step[3];
+    F32 Next[3];
+    F32 Delta[3];
+    U32 MajorAxis = 0;
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Block[Axis] = (I32)floorf(Ray->Origin[Axis]);
+        Step[Axis] = Ray->Direction[Axis] > 0.f ? 1 : Ray->Direction[Axis] < 0.f ? -1 : 0;
+        Delta[Axis] = Step[Axis] != 0 ? fabsf(Ray->InverseDirection[Axis]) : INFINITY;
+        Next[Axis] = Step[Axis] > 0   ? ((F32)Block[Axis] + 1.f - Ray->Origin[Axis]) * Ray->InverseDirection[Axis]
+                     : Step[Axis] < 0 ? ((F32)Block[Axis] - Ray->Origin[Axis]) * Ray->InverseDirection[Axis]
+                                      : INFINITY;
+        if (fabsf(Ray->Direction[Axis]) > fabsf(Ray->Direction[MajorAxis])) {
+            MajorAxis = Axis;
+        }
+    }
+
+    F32 Distance = 0.f;
+    EDirection Face = Raycast_GetEnteredFace(MajorAxis, Step[MajorAxis]);
+    for (;;) {
+        const I32 ChunkX = World_GetChunkCoordinate(Block[0]);
+        const I32 ChunkY = World_GetChunkCoordinate(Block[1]);
+        const I32 ChunkZ = World_GetChunkCoordinate(Block[2]);
+        const FChunk* Chunk = Raycast_GetChunk(World, Cache, ChunkX, ChunkY, ChunkZ);
+
+        // Empty chunks and cells are left through their nearest exit face instead of block by block.
+        I32 EmptySize = 0;
+        if (Chunk == NULL || Chunk->BlockCount == 0) {
+            EmptySize = CHUNK_SIZE;
+        } else {
+            const I32 LocalX = Block[0] - ChunkX * CHUNK_SIZE;
+            const I32 LocalY = Block[1] - ChunkY * CHUNK_SIZE;
+            const I32 LocalZ = Block[2] - ChunkZ * CHUNK_SIZE;
+            if (!(Chunk->OccupiedCells & Chunk_GetCellBit(LocalX, LocalY, LocalZ))) {
+                EmptySize = CHUNK_CELL_SIZE;
+            } else {
+                const Byte Type = Chunk_GetBlockType(Chunk, LocalX, LocalY, LocalZ);
+                if (Block_IsSolid(Type)) {
+                    *OutHit = (FRaycastHit){Block[0], Block[1], Block[2], Type, Face, Distance};
+                    return True;
+                }
+            }
+        }
+
+        if (EmptySize > 0) {
+            I32 Low[3];
+            F32 Exit = INFINITY;
+            U32 ExitAxis = 0;
+            for (U32 Axis = 0; Axis < 3; Axis++) {
+                // Sizes are powers of two, masking floors negative coordinates too.
+                Low[Axis] = Block[Axis] & ~(EmptySize - 1);
+                if (Step[Axis] == 0) {
+                    continue;
+                }
+
+                const I32 Bound = Step[Axis] > 0 ? Low[Axis] + EmptySize : Low[Axis];
+                const F32 AxisExit = ((F32)Bound - Ray->Origin[Axis]) * Ray->InverseDirection[Axis];
+                if (AxisExit < Exit) {
+                    Exit = AxisExit;
+                    ExitAxis = Axis;
+                }
+            }
+
+            if (Exit > Ray->MaxDistance) {
+                break;
+            }
+
+            Distance = Exit > Distance ? Exit : Distance;
+            for (U32 Axis = 0; Axis < 3; Axis++) {
+                if (Axis == ExitAxis) {
+                    Block[Axis] = Step[Axis] > 0 ? Low[Axis] + EmptySize : Low[Axis] - 1;
+                } else {
+                    // The other axes are still inside the box at the exit, clamping only absorbs rounding.
+                    I32 Coordinate = (I32)floorf(Ray->Origin[Axis] + Ray->Direction[Axis] * Distance);
+                    Coordinate = Coordinate < Low[Axis] ? Low[Axis] : Coordinate;
+                    Coordinate = Coordinate > Low[Axis] + EmptySize - 1 ? Low[Axis] + EmptySize - 1 : Coordinate;
+                    Block[Axis] = Coordinate;
+                }
+
+                Next[Axis] = Step[Axis] > 0   ? ((F32)Block[Axis] + 1.f - Ray->Origin[Axis]) * Ray->InverseDirection[Axis]
+                             : Step[Axis] < 0 ? ((F32)Block[Axis] - Ray->Origin[Axis]) * Ray->InverseDirection[Axis]
+                                              : INFINITY;
+            }
+            Face = Raycast_GetEnteredFace(ExitAxis, Step[ExitAxis]);
+            continue;
+        }
+
+        const U32 Axis = Next[0] < Next[1] ? (Next[0] < Next[2] ? 0 : 2) : (Next[1] < Next[2] ? 1 : 2);
+        if (Next[Axis] > Ray->MaxDistance) {
+            break;
+        }
+
+        Distance = Next[Axis];
+        Block[Axis] += Step[Axis];
+        Next[Axis] += Delta[Axis];
+        Face = Raycast_GetEnteredFace(Axis, Step[Axis]);
+    }
+
+    *OutHit = (FRaycastHit){Block[0], Block[1], Block[2], BLOCK_TYPE_AIR, Face, Ray->MaxDistance};
+    return False;
+}
+
+const FChunk* Raycast_GetChunk(const FWorld* World, FRaycastCache* Cache, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    const U32 Slot = ((U32)ChunkX * 0x8DA6B343u ^ (U32)ChunkY * 0xD8163841u ^ (U32)ChunkZ * 0xCB1AB31Fu) >> 28 & (RAYCAST_CACHE_SIZE - 1);
+    FRaycastCacheEntry* Entry = &Cache->Entries[Slot];
+    if (!Entry->bValid || Entry->X != ChunkX || Entry->Y != ChunkY || Entry->Z != ChunkZ) {
+        *Entry = (FRaycastCacheEntry){ChunkX, ChunkY, ChunkZ, True, World_GetChunk(World, ChunkX, ChunkY, ChunkZ)};
+    }
+
+    return Entry->Chunk;
+}
+
+EDirection Raycast_GetEnteredFace(const U32 Axis, const I32 Step) {
+    // Stepping toward positive coordinates enters the block through its negative face.
+    return (EDirection)(Axis * 2 + (Step > 0 ? 1 : 0));
+}
+#pragma endregion
@@ -0,0 +1,36 @@
+#pragma once
+#include "typedefs.h"
+#include "world.h"
+
+/** Block hit by a ray. Rays that hit nothing have an air hit. */
+typedef struct {
+    /** Hit block position in world blocks. */
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Byte Type;
+    /** Face of the block the ray entered through. */
+    EDirection Face;
+    /** Distance from the ray origin to the face, in blocks. Zero when the origin is inside the block. */
+    F32 Distance;
+} FRaycastHit;
+
+/** Rays stored as arrays of components, directions don't need to be normalized. */
+typedef struct {
+    const F32* OriginX;
+    const F32* OriginY;
+    const F32* OriginZ;
+    const F32* DirectionX;
+    const F32* DirectionY;
+    const F32* DirectionZ;
+    const F32* MaxDistance;
+} FRaycastRays;
+
+/**
+ * Traverses the blocks along the ray until the first solid block within the distance, across chunk borders. Chunks
+ * that aren't loaded or are empty, and empty cells of chunks, are crossed in one step. Returns True on a hit.
+ */
+Bool Raycast_Cast(const FWorld* World, const F32 Origin[3], const F32 Direction[3], F32 MaxDistance, FRaycastHit* OutHit);
+
+/** Casts the rays, for line of sight and occlusion queries of many rays. Returns the number of hits. */
+U32 Raycast_CastBatch(const FWorld* World, const FRaycastRays* Rays, U32 Count, FRaycastHit* OutHits);
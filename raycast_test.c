@@ -0,0 +1,244 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "check.h"
+#include "raycast.h"
+
+#pragma region Settings
+/** Chunks along X from -1 to 3. Chunk 1 is loaded but empty and chunk 2 isn't loaded. */
+#define RAYCAST_TEST_FIRST_CHUNK -1
+#define RAYCAST_TEST_CHUNK_COUNT 5
+#define RAYCAST_TEST_EMPTY_CHUNK 1
+#define RAYCAST_TEST_MISSING_CHUNK 2
+/** Random rays compared against block by block traversal. */
+#define RAYCAST_TEST_RAYS 4096
+#define RAYCAST_TEST_MAX_DISTANCE 160.f
+#define RAYCAST_TEST_TOLERANCE 1e-3f
+#pragma endregion
+
+typedef struct {
+    FChunk* Chunks[RAYCAST_TEST_CHUNK_COUNT];
+    FWorld* World;
+    U32 Random;
+} FRaycastTest;
+
+#pragma region Private Function Declarations
+static void RaycastTest_Create(FRaycastTest* Test);
+static void RaycastTest_Destroy(FRaycastTest* Test);
+static F32 RaycastTest_Random(FRaycastTest* Test);
+static void RaycastTest_Set(FRaycastTest* Test, I32 X, I32 Y, I32 Z, Byte Type);
+static Bool RaycastTest_Reference(const FRaycastTest* Test, const F32 Origin[3], const F32 Direction[3], F32 MaxDistance, FRaycastHit* OutHit);
+static void RaycastTest_CheckHit(const FRaycastTest* Test, F32 OriginX, F32 OriginY, F32 OriginZ, F32 DirectionX, F32 DirectionY, F32 DirectionZ,
+                                 F32 MaxDistance, I32 X, I32 Y, I32 Z, EDirection Face, F32 Distance);
+static void RaycastTest_Cases(FRaycastTest* Test);
+static void RaycastTest_RandomRays(FRaycastTest* Test);
+#pragma endregion
+
+int main() {
+    FRaycastTest Test;
+    RaycastTest_Create(&Test);
+
+    RaycastTest_Cases(&Test);
+    RaycastTest_RandomRays(&Test);
+
+    RaycastTest_Destroy(&Test);
+
+    printf("raycast_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void RaycastTest_Create(FRaycastTest* Test) {
+    Test->World = World_Create();
+    CHECK(Test->World != NULL);
+    Test->Random = 0x2545F491u;
+
+    for (I32 Index = 0; Index < RAYCAST_TEST_CHUNK_COUNT; Index++) {
+        Test->Chunks[Index] = NULL;
+        if (RAYCAST_TEST_FIRST_CHUNK + Index == RAYCAST_TEST_MISSING_CHUNK) {
+            continue;
+        }
+
+        Test->Chunks[Index] = Chunk_Create(RAYCAST_TEST_FIRST_CHUNK + Index, 0, 0);
+        CHECK(Test->Chunks[Index] != NULL);
+        World_AddChunk(Test->World, Test->Chunks[Index]);
+    }
+
+    // Sparse blocks above the rows of the fixed cases leave most cells empty, water is crossed like air.
+    for (I32 Index = 0; Index < 1500; Index++) {
+        const I32 X = RAYCAST_TEST_FIRST_CHUNK * CHUNK_SIZE + (I32)(RaycastTest_Random(Test) * RAYCAST_TEST_CHUNK_COUNT * CHUNK_SIZE);
+        const I32 Y = CHUNK_SIZE / 2 + (I32)(RaycastTest_Random(Test) * CHUNK_SIZE / 2);
+        const I32 Z = (I32)(RaycastTest_Random(Test) * CHUNK_SIZE);
+        const I32 ChunkX = World_GetChunkCoordinate(X);
+        if (ChunkX != RAYCAST_TEST_EMPTY_CHUNK && ChunkX != RAYCAST_TEST_MISSING_CHUNK) {
+            RaycastTest_Set(Test, X, Y, Z, Index % 5 == 0 ? BLOCK_TYPE_WATER : BLOCK_TYPE_STONE);
+        }
+    }
+
+    RaycastTest_Set(Test, 20, 5, 5, BLOCK_TYPE_WATER);
+    RaycastTest_Set(Test, 100, 5, 5, BLOCK_TYPE_STONE);
+    RaycastTest_Set(Test, -30, 9, 20, BLOCK_TYPE_DIRT);
+    RaycastTest_Set(Test, 3, 2, 3, BLOCK_TYPE_GRASS);
+}
+
+void RaycastTest_Destroy(FRaycastTest* Test) {
+    World_Destroy(Test->World);
+    for (I32 Index = 0; Index < RAYCAST_TEST_CHUNK_COUNT; Index++) {
+        Chunk_Destroy(Test->Chunks[Index]);
+    }
+}
+
+F32 RaycastTest_Random(FRaycastTest* Test) {
+    Test->Random = Test->Random * 1664525u + 1013904223u;
+    return (F32)(Test->Random >> 8) / (F32)(1u << 24);
+}
+
+void RaycastTest_Set(FRaycastTest* Test, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FChunk* Chunk = World_GetChunk(Test->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    CHECK(Chunk != NULL);
+    Chunk_SetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z), Type);
+}
+
+Bool RaycastTest_Reference(const FRaycastTest* Test, const F32 Origin[3], const F32 Direction[3], const F32 MaxDistance, FRaycastHit* OutHit) {
+    const F64 Length = sqrt((F64)Direction[0] * Direction[0] + (F64)Direction[1] * Direction[1] + (F64)Direction[2] * Direction[2]);
+
+    // Plain block by block traversal in double precision, without any skipping.
+    I32 Block[3];
+    I32 Step[3];
+    F64 Next[3];
+    F64 Delta[3];
+    U32 MajorAxis = 0;
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        if (fabsf(Direction[Axis]) > fabsf(Direction[MajorAxis])) {
+            MajorAxis = Axis;
+        }
+
+        const F64 AxisDirection = Direction[Axis] / Length;
+        Block[Axis] = (I32)floor(Origin[Axis]);
+        Step[Axis] = AxisDirection > 0.0 ? 1 : AxisDirection < 0.0 ? -1 : 0;
+        Delta[Axis] = Step[Axis] != 0 ? fabs(1.0 / AxisDirection) : INFINITY;
+        Next[Axis] = Step[Axis] > 0   ? (Block[Axis] + 1.0 - Origin[Axis]) / AxisDirection
+                     : Step[Axis] < 0 ? (Block[Axis] - Origin[Axis]) / AxisDirection
+                                      : INFINITY;
+    }
+
+    // An origin inside a block reports the face the major axis enters through.
+    F64 Distance = 0.0;
+    EDirection Face = (EDirection)(MajorAxis * 2 + (Step[MajorAxis] > 0 ? 1 : 0));
+    for (;;) {
+        const Byte Type = World_GetBlockType(Test->World, Block[0], Block[1], Block[2]);
+        if (Block_IsSolid(Type)) {
+            *OutHit = (FRaycastHit){Block[0], Block[1], Block[2], Type, Face, (F32)Distance};
+            return True;
+        }
+
+        const U32 Axis = Next[0] < Next[1] ? (Next[0] < Next[2] ? 0 : 2) : (Next[1] < Next[2] ? 1 : 2);
+        if (Next[Axis] > MaxDistance) {
+            *OutHit = (FRaycastHit){Block[0], Block[1], Block[2], BLOCK_TYPE_AIR, Face, MaxDistance};
+            return False;
+        }
+
+        Distance = Next[Axis];
+        Block[Axis] += Step[Axis];
+        Next[Axis] += Delta[Axis];
+        Face = (EDirection)(Axis * 2 + (Step[Axis] > 0 ? 1 : 0));
+    }
+}
+
+void RaycastTest_CheckHit(const FRaycastTest* Test, const F32 OriginX, const F32 OriginY, const F32 OriginZ, const F32 DirectionX,
+                          const F32 DirectionY, const F32 DirectionZ, const F32 MaxDistance, const I32 X, const I32 Y, const I32 Z,
+                          const EDirection Face, const F32 Distance) {
+    const F32 Origin[3] = {OriginX, OriginY, OriginZ};
+    const F32 Direction[3] = {DirectionX, DirectionY, DirectionZ};
+
+    FRaycastHit Hit;
+    CHECK(Raycast_Cast(Test->World, Origin, Direction, MaxDistance, &Hit));
+    CHECK(Hit.X == X && Hit.Y == Y && Hit.Z == Z);
+    CHECK(Block_IsSolid(Hit.Type));
+    CHECK(Hit.Face == Face);
+    CHECK(fabsf(Hit.Distance - Distance) < RAYCAST_TEST_TOLERANCE);
+}
+
+void RaycastTest_Cases(FRaycastTest* Test) {
+    // Along +X through the occupied cells of chunk -1, water, the empty chunk and the missing one.
+    RaycastTest_CheckHit(Test, -30.5f, 5.5f, 5.5f, 1.f, 0.f, 0.f, 200.f, 100, 5, 5, XNegative, 130.5f);
+
+    // Unnormalized directions measure the distance in blocks all the same.
+    RaycastTest_CheckHit(Test, -30.5f, 5.5f, 5.5f, 7.f, 0.f, 0.f, 200.f, 100, 5, 5, XNegative, 130.5f);
+
+    RaycastTest_CheckHit(Test, 120.5f, 5.5f, 5.5f, -1.f, 0.f, 0.f, 200.f, 100, 5, 5, XPositive, 19.5f);
+    RaycastTest_CheckHit(Test, 3.5f, 12.5f, 3.5f, 0.f, -1.f, 0.f, 50.f, 3, 2, 3, YPositive, 9.5f);
+
+    // Diagonal into a negative coordinate, entered through the face of the last crossed boundary.
+    RaycastTest_CheckHit(Test, -25.2f, 9.5f, 15.7f, -1.f, 0.f, 1.f, 50.f, -30, 9, 20, ZNegative, 4.3f * sqrtf(2.f));
+
+    // The origin inside a block hits it at zero distance.
+    RaycastTest_CheckHit(Test, 100.25f, 5.75f, 5.5f, 0.f, 1.f, 0.f, 10.f, 100, 5, 5, YNegative, 0.f);
+
+    // Stopping short of the block is a miss with an air hit.
+    const F32 Origin[3] = {-30.5f, 5.5f, 5.5f};
+    const F32 Direction[3] = {1.f, 0.f, 0.f};
+    FRaycastHit Hit;
+    CHECK(!Raycast_Cast(Test->World, Origin, Direction, 130.f, &Hit));
+    CHECK(Hit.Type == BLOCK_TYPE_AIR);
+
+    // Rays leaving the loaded chunks miss.
+    const F32 Up[3] = {0.f, 1.f, 0.f};
+    const F32 Above[3] = {50.5f, 20.5f, 3.5f};
+    CHECK(!Raycast_Cast(Test->World, Above, Up, 100.f, &Hit));
+}
+
+void RaycastTest_RandomRays(FRaycastTest* Test) {
+    static F32 OriginX[RAYCAST_TEST_RAYS];
+    static F32 OriginY[RAYCAST_TEST_RAYS];
+    static F32 OriginZ[RAYCAST_TEST_RAYS];
+    static F32 DirectionX[RAYCAST_TEST_RAYS];
+    static F32 DirectionY[RAYCAST_TEST_RAYS];
+    static F32 DirectionZ[RAYCAST_TEST_RAYS];
+    static F32 MaxDistance[RAYCAST_TEST_RAYS];
+    static FRaycastHit Hits[RAYCAST_TEST_RAYS];
+
+    for (U32 Index = 0; Index < RAYCAST_TEST_RAYS; Index++) {
+        OriginX[Index] = (F32)(RAYCAST_TEST_FIRST_CHUNK * CHUNK_SIZE) + RaycastTest_Random(Test) * RAYCAST_TEST_CHUNK_COUNT * CHUNK_SIZE;
+        OriginY[Index] = CHUNK_SIZE / 2 + RaycastTest_Random(Test) * CHUNK_SIZE / 2;
+        OriginZ[Index] = RaycastTest_Random(Test) * CHUNK_SIZE;
+        DirectionX[Index] = RaycastTest_Random(Test) * 2.f - 1.f;
+        DirectionY[Index] = (RaycastTest_Random(Test) * 2.f - 1.f) * 0.25f;
+        DirectionZ[Index] = (RaycastTest_Random(Test) * 2.f - 1.f) * 0.5f;
+        MaxDistance[Index] = RaycastTest_Random(Test) * RAYCAST_TEST_MAX_DISTANCE;
+    }
+
+    const FRaycastRays Rays = {OriginX, OriginY, OriginZ, DirectionX, DirectionY, DirectionZ, MaxDistance};
+    const U32 HitCount = Raycast_CastBatch(Test->World, &Rays, RAYCAST_TEST_RAYS, Hits);
+
+    U32 ReferenceHitCount = 0;
+    for (U32 Index = 0; Index < RAYCAST_TEST_RAYS; Index++) {
+        const F32 Origin[3] = {OriginX[Index], OriginY[Index], OriginZ[Index]};
+        const F32 Direction[3] = {DirectionX[Index], DirectionY[Index], DirectionZ[Index]};
+
+        FRaycastHit Hit;
+        FRaycastHit Reference;
+        const Bool bHit = Raycast_Cast(Test->World, Origin, Direction, MaxDistance[Index], &Hit);
+        const Bool bReference = RaycastTest_Reference(Test, Origin, Direction, MaxDistance[Index], &Reference);
+        ReferenceHitCount += bReference;
+
+        // Single and batched casts agree exactly.
+        CHECK(bHit == (Hits[Index].Type != BLOCK_TYPE_AIR));
+        CHECK(Hit.X == Hits[Index].X && Hit.Y == Hits[Index].Y && Hit.Z == Hits[Index].Z && Hit.Face == Hits[Index].Face);
+
+        // Skipping empty cells and chunks finds the block the full traversal finds, rounding only decides rays ending at a face.
+        if (bHit != bReference) {
+            CHECK(fabsf((bHit ? Hit.Distance : Reference.Distance) - MaxDistance[Index]) < RAYCAST_TEST_TOLERANCE);
+            continue;
+        }
+        if (bHit) {
+            CHECK(fabsf(Hit.Distance - Reference.Distance) < RAYCAST_TEST_TOLERANCE);
+            CHECK(Hit.X == Reference.X && Hit.Y == Reference.Y && Hit.Z == Reference.Z && Hit.Face == Reference.Face);
+        }
+    }
+
+    CHECK(HitCount > RAYCAST_TEST_RAYS / 8);
+    CHECK(HitCount + 8 > ReferenceHitCount && ReferenceHitCount + 8 > HitCount);
+}
+#pragma endregion
@@ -0,0 +1,448 @@
+#include "region.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+#include "hash.h"
+#include "lz4.h"
+
+#if OS_WINDOWS
+#include <io.h>
+#else
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#pragma region Settings
+/** "SQCK" in little-endian, starts every stored chunk. */
+#define REGION_CHUNK_MAGIC 0x4B435153
+/** Size of a chunk as stored before compression. */
+#define REGION_RAW_CHUNK_SIZE (CHUNK_VOLUME * sizeof(FBlock))
+/** Largest stored chunk rounded up to whole sectors. */
+#define REGION_MAX_STORED_SIZE                                                                                                             \
+    ((sizeof(FRegionChunkHeader) + REGION_RAW_CHUNK_SIZE + REGION_RAW_CHUNK_SIZE / 255 + 16 + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE * \
+     REGION_SECTOR_SIZE)
+
+/** Sector referenced by the in-memory offset table. */
+#define REGION_SECTOR_MEMORY 0x1
+/** Sector referenced by the offset table on disk, it can't be reused until the table stops pointing to it. */
+#define REGION_SECTOR_DISK 0x2
+#pragma endregion
+
+/** Header in the first sector. */
+typedef struct {
+    U32 Magic;
+    U32 Version;
+    I32 X;
+    I32 Y;
+    I32 Z;
+    U32 Size;
+    U32 SectorSize;
+    U32 Reserved;
+} FRegionHeader;
+
+/** Offset table entry, zero sectors mark a missing chunk. */
+typedef struct {
+    U32 Sector;
+    U32 SectorCount;
+} FRegionOffset;
+
+/** Header in front of every stored chunk. */
+typedef struct {
+    U32 Magic;
+    I32 X;
+    I32 Y;
+    I32 Z;
+    /** Stored codec, REGION_COMPRESSION_NONE or REGION_COMPRESSION_FAST. */
+    U16 Compression;
+    /** sizeof(FBlock) of the writer, chunks of another block layout are rejected. */
+    U16 BlockSize;
+    U32 StoredSize;
+    U32 RawSize;
+    U32 Reserved;
+    /** Hash_Compute of the stored data, detects torn writes. */
+    U64 Hash;
+} FRegionChunkHeader;
+
+struct FRegion {
+    FILE* File;
+    I32 X;
+    I32 Y;
+    I32 Z;
+    /** Offsets of the latest saves. */
+    FRegionOffset Offsets[REGION_CHUNK_COUNT];
+    /** Offsets as stored on disk. */
+    FRegionOffset DiskOffsets[REGION_CHUNK_COUNT];
+    /** REGION_SECTOR_* flags of every file sector. */
+    FVector(U8) Sectors;
+    Bool bDirty;
+    /** Scratch buffers, planar blocks and stored chunk data. */
+    U8* Raw;
+    U8* Stored;
+};
+
+#pragma region Private Function Declarations
+static Bool Region_Seek(FILE* File, U64 Offset);
+static Bool Region_Sync(FILE* File);
+
+/** Sets or clears the flag on the sectors of the offset. */
+static void Region_MarkSectors(FRegion* Region, FRegionOffset Offset, U8 Flag, Bool bSet);
+
+/** Finds a run of free sectors, growing the file if there is none. */
+static U32 Region_AllocateSectors(FRegion* Region, U32 Count);
+
+/** Splits the blocks into planes of their bytes, each plane compresses much better than interleaved blocks. */
+static void Region_SplitPlanes(const FChunk* Chunk, U8* OutRaw);
+static void Region_MergePlanes(const U8* Raw, FChunk* OutChunk);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Region_GetPath(const pStr Directory, const I32 RegionX, const I32 RegionY, const I32 RegionZ, char* OutPath, const size_t Size) {
+    snprintf(OutPath, Size, "%s/r.%d.%d.%d.sqr", Directory, RegionX, RegionY, RegionZ);
+}
+
+FRegion* Region_Open(const pStr Path, const I32 RegionX, const I32 RegionY, const I32 RegionZ) {
+    FRegion* Region = calloc(1, sizeof *Region);
+    if (Region == NULL) {
+        return NULL;
+    }
+
+    Region->X = RegionX;
+    Region->Y = RegionY;
+    Region->Z = RegionZ;
+    Region->Raw = malloc(REGION_RAW_CHUNK_SIZE);
+    Region->Stored = malloc(REGION_MAX_STORED_SIZE);
+    if (Region->Raw == NULL || Region->Stored == NULL) {
+        Region_Close(Region);
+        return NULL;
+    }
+
+    Region->File = fopen(Path, "r+b");
+    if (Region->File == NULL) {
+        // A new region starts with the header and an empty offset table.
+        Region->File = fopen(Path, "w+b");
+        if (Region->File == NULL) {
+            fprintf(stderr, "Failed to create region file %s\n", Path);
+            Region_Close(Region);
+            return NULL;
+        }
+
+        U8 Sector[REGION_SECTOR_SIZE] = {0};
+        const FRegionHeader Header = {REGION_MAGIC, REGION_VERSION, RegionX, RegionY, RegionZ, REGION_SIZE, REGION_SECTOR_SIZE, 0};
+        memcpy(Sector, &Header, sizeof Header);
+
+        Bool bWritten = fwrite(Sector, sizeof Sector, 1, Region->File) == 1;
+        memset(Sector, 0, sizeof Sector);
+        bWritten = bWritten && fwrite(Sector, sizeof Sector, 1, Region->File) == 1 && Region_Sync(Region->File);
+        if (!bWritten) {
+            fprintf(stderr, "Failed to write region file %s\n", Path);
+            Region_Close(Region);
+            return NULL;
+        }
+    } else {
+        FRegionHeader Header;
+        if (fread(&Header, sizeof Header, 1, Region->File) != 1 || Header.Magic != REGION_MAGIC || Header.Version != REGION_VERSION ||
+            Header.Size != REGION_SIZE || Header.SectorSize != REGION_SECTOR_SIZE || Header.X != RegionX || Header.Y != RegionY ||
+            Header.Z != RegionZ) {
+            fprintf(stderr, "Region file %s is malformed or belongs to another region\n", Path);
+            Region_Close(Region);
+            return NULL;
+        }
+
+        if (!Region_Seek(Region->File, REGION_SECTOR_SIZE) || fread(Region->DiskOffsets, sizeof Region->DiskOffsets, 1, Region->File) != 1) {
+            fprintf(stderr, "Failed to read region offsets of %s\n", Path);
+            Region_Close(Region);
+            return NULL;
+        }
+    }
+
+    FVector_Reserve(Region->Sectors, REGION_HEADER_SECTORS * 2);
+    FVector_SetSize(Region->Sectors, REGION_HEADER_SECTORS);
+    memset(Region->Sectors, REGION_SECTOR_MEMORY | REGION_SECTOR_DISK, REGION_HEADER_SECTORS);
+
+    for (U32 Index = 0; Index < REGION_CHUNK_COUNT; Index++) {
+        FRegionOffset* Offset = &Region->DiskOffsets[Index];
+        if (Offset->SectorCount > 0 && Offset->Sector < REGION_HEADER_SECTORS) {
+            // Never let a damaged entry claim the header.
+            *Offset = (FRegionOffset){0, 0};
+        }
+
+        Region->Offsets[Index] = *Offset;
+        Region_MarkSectors(Region, *Offset, REGION_SECTOR_MEMORY | REGION_SECTOR_DISK, True);
+    }
+
+    return Region;
+}
+
+void Region_Close(FRegion* Region) {
+    if (Region == NULL) {
+        return;
+    }
+
+    if (Region->File != NULL) {
+        Region_Flush(Region);
+        fclose(Region->File);
+    }
+
+    FVector_Free(Region->Sectors);
+    free(Region->Raw);
+    free(Region->Stored);
+    free(Region);
+}
+
+Bool Region_HasChunk(const FRegion* Region, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    return Region->Offsets[Region_GetChunkIndex(ChunkX, ChunkY, ChunkZ)].SectorCount > 0;
+}
+
+Bool Region_SaveChunk(FRegion* Region, const FChunk* Chunk, const ERegionCompression Compression) {
+    if (Region_GetCoordinate(Chunk->X) != Region->X || Region_GetCoordinate(Chunk->Y) != Region->Y || Region_GetCoordinate(Chunk->Z) != Region->Z) {
+        fprintf(stderr, "Chunk %d %d %d doesn't belong to region %d %d %d\n", Chunk->X, Chunk->Y, Chunk->Z, Region->X, Region->Y, Region->Z);
+        return False;
+    }
+
+    Region_SplitPlanes(Chunk, Region->Raw);
+
+    FRegionChunkHeader Header = {0};
+    Header.Magic = REGION_CHUNK_MAGIC;
+    Header.X = Chunk->X;
+    Header.Y = Chunk->Y;
+    Header.Z = Chunk->Z;
+    Header.BlockSize = sizeof(FBlock);
+    Header.RawSize = REGION_RAW_CHUNK_SIZE;
+
+    U8* Data = Region->Stored + sizeof Header;
+    const U64 Capacity = Lz4_GetMaxCompressedSize(REGION_RAW_CHUNK_SIZE);
+    U64 StoredSize = 0;
+    switch (Compression) {
+    case REGION_COMPRESSION_FAST:
+        StoredSize = Lz4_Compress(Region->Raw, REGION_RAW_CHUNK_SIZE, Data, Capacity);
+        break;
+    case REGION_COMPRESSION_ARCHIVAL:
+        StoredSize = Lz4_CompressHigh(Region->Raw, REGION_RAW_CHUNK_SIZE, Data, Capacity);
+        break;
+    default:
+        break;
+    }
+
+    if (StoredSize > 0 && StoredSize < REGION_RAW_CHUNK_SIZE) {
+        Header.Compression = REGION_COMPRESSION_FAST;
+    } else {
+        StoredSize = REGION_RAW_CHUNK_SIZE;
+        memcpy(Data, Region->Raw, REGION_RAW_CHUNK_SIZE);
+        Header.Compression = REGION_COMPRESSION_NONE;
+    }
+
+    Header.StoredSize = (U32)StoredSize;
+    Header.Hash = Hash_Compute(Data, StoredSize, 0);
+    memcpy(Region->Stored, &Header, sizeof Header);
+
+    const U64 Size = sizeof Header + StoredSize;
+    const U32 SectorCount = (U32)((Size + REGION_SECTOR_SIZE - 1) / REGION_SECTOR_SIZE);
+
+    // The previous unflushed version is dropped, the version on disk stays until the next flush.
+    const U32 Index = Region_GetChunkIndex(Chunk->X, Chunk->Y, Chunk->Z);
+    Region_MarkSectors(Region, Region->Offsets[Index], REGION_SECTOR_MEMORY, False);
+
+    const U32 Sector = Region_AllocateSectors(Region, SectorCount);
+    const FRegionOffset Offset = {Sector, SectorCount};
+
+    // Pad the last sector so the file always ends on a sector boundary.
+    const U64 Padding = (U64)SectorCount * REGION_SECTOR_SIZE - Size;
+    memset(Region->Stored + Size, 0, (size_t)Padding);
+
+    if (!Region_Seek(Region->File, (U64)Sector * REGION_SECTOR_SIZE) || fwrite(Region->Stored, (size_t)(Size + Padding), 1, Region->File) != 1) {
+        fprintf(stderr, "Failed to write chunk %d %d %d\n", Chunk->X, Chunk->Y, Chunk->Z);
+        Region_MarkSectors(Region, Offset, REGION_SECTOR_MEMORY, False);
+        Region_MarkSectors(Region, Region->Offsets[Index], REGION_SECTOR_MEMORY, True);
+        return False;
+    }
+
+    Region->Offsets[Index] = Offset;
+    Region_MarkSectors(Region, Offset, REGION_SECTOR_MEMORY, True);
+    Region->bDirty = True;
+
+    return True;
+}
+
+Bool Region_LoadChunk(FRegion* Region, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ, FChunk* OutChunk) {
+    const FRegionOffset Offset = Region->Offsets[Region_GetChunkIndex(ChunkX, ChunkY, ChunkZ)];
+    if (Offset.SectorCount == 0) {
+        return False;
+    }
+
+    if ((U64)Offset.SectorCount * REGION_SECTOR_SIZE > REGION_MAX_STORED_SIZE) {
+        fprintf(stderr, "Chunk %d %d %d has a damaged offset\n", ChunkX, ChunkY, ChunkZ);
+        return False;
+    }
+
+    FRegionChunkHeader Header;
+    if (!Region_Seek(Region->File, (U64)Offset.Sector * REGION_SECTOR_SIZE) || fread(&Header, sizeof Header, 1, Region->File) != 1 ||
+        Header.Magic != REGION_CHUNK_MAGIC || Header.X != ChunkX || Header.Y != ChunkY || Header.Z != ChunkZ || Header.BlockSize != sizeof(FBlock) ||
+        Header.RawSize != REGION_RAW_CHUNK_SIZE || sizeof Header + (U64)Header.StoredSize > (U64)Offset.SectorCount * REGION_SECTOR_SIZE) {
+        fprintf(stderr, "Chunk %d %d %d has a damaged header\n", ChunkX, ChunkY, ChunkZ);
+        return False;
+    }
+
+    U8* Data = Region->Stored;
+    if (fread(Data, Header.StoredSize, 1, Region->File) != 1 || Hash_Compute(Data, Header.StoredSize, 0) != Header.Hash) {
+        fprintf(stderr, "Chunk %d %d %d has damaged data\n", ChunkX, ChunkY, ChunkZ);
+        return False;
+    }
+
+    switch (Header.Compression) {
+    case REGION_COMPRESSION_NONE:
+        if (Header.StoredSize != REGION_RAW_CHUNK_SIZE) {
+            return False;
+        }
+        Region_MergePlanes(Data, OutChunk);
+        break;
+
+    case REGION_COMPRESSION_FAST:
+        if (Lz4_Decompress(Data, Header.StoredSize, Region->Raw, REGION_RAW_CHUNK_SIZE) != REGION_RAW_CHUNK_SIZE) {
+            fprintf(stderr, "Chunk %d %d %d failed to decompress\n", ChunkX, ChunkY, ChunkZ);
+            return False;
+        }
+        Region_MergePlanes(Region->Raw, OutChunk);
+        break;
+
+    default:
+        fprintf(stderr, "Chunk %d %d %d has an unknown compression %u\n", ChunkX, ChunkY, ChunkZ, Header.Compression);
+        return False;
+    }
+
+    // Chunks loaded in place keep their position untouched, other threads may be looking them up by it.
+    if (OutChunk->X != ChunkX || OutChunk->Y != ChunkY || OutChunk->Z != ChunkZ) {
+        OutChunk->X = ChunkX;
+        OutChunk->Y = ChunkY;
+        OutChunk->Z = ChunkZ;
+    }
+    Chunk_UpdateBlockCount(OutChunk);
+
+    return True;
+}
+
+Bool Region_Flush(FRegion* Region) {
+    if (!Region->bDirty) {
+        return True;
+    }
+
+    // Chunk data must be durable before the table points to it.
+    if (!Region_Sync(Region->File)) {
+        return False;
+    }
+
+    if (!Region_Seek(Region->File, REGION_SECTOR_SIZE) || fwrite(Region->Offsets, sizeof Region->Offsets, 1, Region->File) != 1 ||
+        !Region_Sync(Region->File)) {
+        fprintf(stderr, "Failed to write region offsets\n");
+        return False;
+    }
+
+    // Sectors of replaced versions become free once the table on disk no longer points to them.
+    for (U32 Index = 0; Index < REGION_CHUNK_COUNT; Index++) {
+        if (Region->DiskOffsets[Index].Sector != Region->Offsets[Index].Sector ||
+            Region->DiskOffsets[Index].SectorCount != Region->Offsets[Index].SectorCount) {
+            Region_MarkSectors(Region, Region->DiskOffsets[Index], REGION_SECTOR_DISK, False);
+            Region_MarkSectors(Region, Region->Offsets[Index], REGION_SECTOR_DISK, True);
+            Region->DiskOffsets[Index] = Region->Offsets[Index];
+        }
+    }
+
+    Region->bDirty = False;
+
+    return True;
+}
+
+U64 Region_GetFileSize(const FRegion* Region) {
+    return (U64)FVector_GetSize(Region->Sectors) * REGION_SECTOR_SIZE;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+Bool Region_Seek(FILE* File, const U64 Offset) {
+#if OS_WINDOWS
+    return _fseeki64(File, (I64)Offset, SEEK_SET) == 0;
+#else
+    return fseeko(File, (off_t)Offset, SEEK_SET) == 0;
+#endif
+}
+
+Bool Region_Sync(FILE* File) {
+    if (fflush(File) != 0) {
+        return False;
+    }
+
+#if OS_WINDOWS
+    return _commit(_fileno(File)) == 0;
+#else
+    return fsync(fileno(File)) == 0;
+#endif
+}
+
+void Region_MarkSectors(FRegion* Region, const FRegionOffset Offset, const U8 Flag, const Bool bSet) {
+    const U32 SectorCount = (U32)FVector_GetSize(Region->Sectors);
+    if (Offset.SectorCount == 0) {
+        return;
+    }
+
+    // Sectors past the end of a truncated file are appended as free first.
+    const U64 End = (U64)Offset.Sector + Offset.SectorCount;
+    if (End > SectorCount) {
+        FVector_Reserve(Region->Sectors, End);
+        memset(Region->Sectors + SectorCount, 0, (size_t)(End - SectorCount));
+        FVector_SetSize(Region->Sectors, End);
+    }
+
+    for (U64 Sector = Offset.Sector; Sector < End; Sector++) {
+        if (bSet) {
+            Region->Sectors[Sector] |= Flag;
+        } else {
+            Region->Sectors[Sector] &= (U8)~Flag;
+        }
+    }
+}
+
+U32 Region_AllocateSectors(FRegion* Region, const U32 Count) {
+    const U32 SectorCount = (U32)FVector_GetSize(Region->Sectors);
+
+    U32 RunStart = REGION_HEADER_SECTORS;
+    for (U32 Sector = REGION_HEADER_SECTORS; Sector < SectorCount; Sector++) {
+        if (Region->Sectors[Sector] != 0) {
+            RunStart = Sector + 1;
+        } else if (Sector + 1 - RunStart == Count) {
+            return RunStart;
+        }
+    }
+
+    // A free run at the end of the file is extended, the file grows geometrically in memory only.
+    const U32 End = RunStart + Count;
+    if (End > FVector_GetCapacity(Region->Sectors)) {
+        FVector_Grow(Region->Sectors, End * 2);
+    }
+    memset(Region->Sectors + SectorCount, 0, End - SectorCount);
+    FVector_SetSize(Region->Sectors, End);
+
+    return RunStart;
+}
+
+void Region_SplitPlanes(const FChunk* Chunk, U8* OutRaw) {
+    const U8* Blocks = (const U8*)Chunk->Blocks;
+    for (U32 Plane = 0; Plane < sizeof(FBlock); Plane++) {
+        U8* Output = OutRaw + (size_t)Plane * CHUNK_VOLUME;
+        for (U32 Index = 0; Index < CHUNK_VOLUME; Index++) {
+            Output[Index] = Blocks[Index * sizeof(FBlock) + Plane];
+        }
+    }
+}
+
+void Region_MergePlanes(const U8* Raw, FChunk* OutChunk) {
+    U8* Blocks = (U8*)OutChunk->Blocks;
+    for (U32 Plane = 0; Plane < sizeof(FBlock); Plane++) {
+        const U8* Input = Raw + (size_t)Plane * CHUNK_VOLUME;
+        for (U32 Index = 0; Index < CHUNK_VOLUME; Index++) {
+            Blocks[Index * sizeof(FBlock) + Plane] = Input[Index];
+        }
+    }
+}
+#pragma endregion
@@ -0,0 +1,70 @@
+#pragma once
+#include <stddef.h>
+
+#include "chunk.h"
+#include "typedefs.h"
+
+/** Number of chunks along each region axis. */
+#define REGION_SIZE 8
+/** Number of chunks in a region. */
+#define REGION_CHUNK_COUNT (REGION_SIZE * REGION_SIZE * REGION_SIZE)
+/** Allocation unit of the region file. */
+#define REGION_SECTOR_SIZE 4096
+/** Header and offset table sectors in front of the chunk data. */
+#define REGION_HEADER_SECTORS 2
+/** "SQRG" in little-endian. */
+#define REGION_MAGIC 0x47525153
+#define REGION_VERSION 1
+
+typedef enum {
+    /** Blocks stored as they are. */
+    REGION_COMPRESSION_NONE = 0,
+    /** LZ4 with the fast match finder, for saves during play. */
+    REGION_COMPRESSION_FAST,
+    /** LZ4 with the high compression match finder, for archived worlds. Loads as fast as REGION_COMPRESSION_FAST. */
+    REGION_COMPRESSION_ARCHIVAL
+} ERegionCompression;
+
+/** Open region file. */
+typedef struct FRegion FRegion;
+
+/** Returns the region coordinate of a chunk coordinate. */
+static inline I32 Region_GetCoordinate(const I32 ChunkCoordinate) {
+    return ChunkCoordinate >= 0 ? ChunkCoordinate / REGION_SIZE : (ChunkCoordinate + 1) / REGION_SIZE - 1;
+}
+
+/** Returns the index of the chunk in its region, Y-major like the blocks of a chunk. */
+static inline U32 Region_GetChunkIndex(const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    const I32 X = ChunkX - Region_GetCoordinate(ChunkX) * REGION_SIZE;
+    const I32 Y = ChunkY - Region_GetCoordinate(ChunkY) * REGION_SIZE;
+    const I32 Z = ChunkZ - Region_GetCoordinate(ChunkZ) * REGION_SIZE;
+
+    return (U32)((Y * REGION_SIZE + Z) * REGION_SIZE + X);
+}
+
+/** Writes the path of the region file, "Directory/r.X.Y.Z.sqr". */
+void Region_GetPath(pStr Directory, I32 RegionX, I32 RegionY, I32 RegionZ, char* OutPath, size_t Size);
+
+/** Opens the region file, creating it if it doesn't exist. Returns NULL on failure or if the file belongs to another region. */
+FRegion* Region_Open(pStr Path, I32 RegionX, I32 RegionY, I32 RegionZ);
+
+/** Flushes and closes the region file. */
+void Region_Close(FRegion* Region);
+
+/** Returns True if the region has the chunk saved. */
+Bool Region_HasChunk(const FRegion* Region, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/**
+ * Saves the chunk of this region. The data is written to free sectors and the offset table only points to it once Region_Flush made it
+ * durable, a crash never damages the previous version or other chunks.
+ */
+Bool Region_SaveChunk(FRegion* Region, const FChunk* Chunk, ERegionCompression Compression);
+
+/** Loads the chunk at the chunk position into OutChunk. Returns False if the chunk is not saved or its data is damaged. */
+Bool Region_LoadChunk(FRegion* Region, I32 ChunkX, I32 ChunkY, I32 ChunkZ, FChunk* OutChunk);
+
+/** Makes saved chunks durable: syncs their data, then relinks the offset table and syncs it. */
+Bool Region_Flush(FRegion* Region);
+
+/** Returns the region file size in bytes. */
+U64 Region_GetFileSize(const FRegion* Region);
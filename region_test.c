@@ -0,0 +1,160 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "lz4.h"
+#include "region.h"
+#include "terrain.h"
+
+#pragma region Settings
+/** Region file written and removed by the test. */
+#define REGION_TEST_PATH "region_test.sqr"
+#define REGION_TEST_SEED 1337
+#define REGION_TEST_CHUNKS 6
+#pragma endregion
+
+#pragma region Private Function Declarations
+static FChunk* RegionTest_CreateChunk(I32 Index);
+static void RegionTest_CheckLoad(FRegion* Region, const FChunk* Chunk);
+static void RegionTest_SaveReopen();
+static void RegionTest_Lz4RoundTrip(const U8* Source, U64 Size);
+static void RegionTest_Lz4();
+#pragma endregion
+
+int main() {
+    RegionTest_SaveReopen();
+    RegionTest_Lz4();
+
+    printf("region_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+FChunk* RegionTest_CreateChunk(const I32 Index) {
+    FChunk* Chunk = Chunk_Create(Index % 3, Index / 3, -1);
+    CHECK(Chunk != NULL);
+    Terrain_Generate(Chunk, REGION_TEST_SEED);
+
+    // Flags and hierarchy bits are stored too, not only the types.
+    for (U32 Block = (U32)Index; Block < CHUNK_VOLUME; Block += 97) {
+        Chunk->Blocks[Block].Flags = (Byte)Block;
+        Chunk->Blocks[Block].ChildBits = (Byte)(Block >> 8);
+    }
+    Chunk_UpdateBlockCount(Chunk);
+
+    return Chunk;
+}
+
+void RegionTest_CheckLoad(FRegion* Region, const FChunk* Chunk) {
+    FChunk* Loaded = Chunk_Create(0, 0, 0);
+    CHECK(Loaded != NULL);
+    CHECK(Region_HasChunk(Region, Chunk->X, Chunk->Y, Chunk->Z));
+    CHECK(Region_LoadChunk(Region, Chunk->X, Chunk->Y, Chunk->Z, Loaded));
+    CHECK(Loaded->X == Chunk->X && Loaded->Y == Chunk->Y && Loaded->Z == Chunk->Z);
+    CHECK(Loaded->BlockCount == Chunk->BlockCount);
+    CHECK(memcmp(Loaded->Blocks, Chunk->Blocks, sizeof Chunk->Blocks) == 0);
+    Chunk_Destroy(Loaded);
+}
+
+void RegionTest_SaveReopen() {
+    remove(REGION_TEST_PATH);
+
+    FChunk* Chunks[REGION_TEST_CHUNKS];
+    for (I32 Index = 0; Index < REGION_TEST_CHUNKS; Index++) {
+        Chunks[Index] = RegionTest_CreateChunk(Index);
+    }
+
+    FRegion* Region = Region_Open(REGION_TEST_PATH, 0, 0, -1);
+    CHECK(Region != NULL);
+    for (I32 Index = 0; Index < REGION_TEST_CHUNKS; Index++) {
+        CHECK(Region_SaveChunk(Region, Chunks[Index], (ERegionCompression)(Index % 3)));
+    }
+    CHECK(Region_Flush(Region));
+    Region_Close(Region);
+
+    // A region file belongs to a single region.
+    CHECK(Region_Open(REGION_TEST_PATH, 1, 0, -1) == NULL);
+
+    Region = Region_Open(REGION_TEST_PATH, 0, 0, -1);
+    CHECK(Region != NULL);
+    for (I32 Index = 0; Index < REGION_TEST_CHUNKS; Index++) {
+        RegionTest_CheckLoad(Region, Chunks[Index]);
+    }
+    CHECK(!Region_HasChunk(Region, 7, 7, -8));
+
+    // A replaced chunk loads in its new version after the flush, the others stay untouched.
+    Chunk_SetBlockType(Chunks[1], 5, 20, 9, BLOCK_TYPE_LAMP);
+    Chunk_SetBlockType(Chunks[1], 6, 2, 9, BLOCK_TYPE_AIR);
+    CHECK(Region_SaveChunk(Region, Chunks[1], REGION_COMPRESSION_FAST));
+    CHECK(Region_Flush(Region));
+    Region_Close(Region);
+
+    Region = Region_Open(REGION_TEST_PATH, 0, 0, -1);
+    CHECK(Region != NULL);
+    for (I32 Index = 0; Index < REGION_TEST_CHUNKS; Index++) {
+        RegionTest_CheckLoad(Region, Chunks[Index]);
+    }
+    Region_Close(Region);
+
+    for (I32 Index = 0; Index < REGION_TEST_CHUNKS; Index++) {
+        Chunk_Destroy(Chunks[Index]);
+    }
+    remove(REGION_TEST_PATH);
+}
+
+void RegionTest_Lz4RoundTrip(const U8* Source, const U64 Size) {
+    const U64 Capacity = Lz4_GetMaxCompressedSize(Size);
+    U8* Compressed = malloc(Capacity);
+    U8* Decompressed = malloc(Size + 1);
+    CHECK(Compressed != NULL && Decompressed != NULL);
+
+    for (U32 bHigh = 0; bHigh < 2; bHigh++) {
+        const U64 CompressedSize = bHigh ? Lz4_CompressHigh(Source, Size, Compressed, Capacity) : Lz4_Compress(Source, Size, Compressed, Capacity);
+        CHECK(CompressedSize > 0 && CompressedSize <= Capacity);
+        CHECK(Lz4_Decompress(Compressed, CompressedSize, Decompressed, Size) == (I64)Size);
+        CHECK(memcmp(Decompressed, Source, Size) == 0);
+
+        // Destinations one byte short are rejected instead of overrun.
+        if (Size > 0) {
+            CHECK(Lz4_Decompress(Compressed, CompressedSize, Decompressed, Size - 1) < 0);
+        }
+    }
+
+    free(Compressed);
+    free(Decompressed);
+}
+
+void RegionTest_Lz4() {
+    const U64 Size = 1 << 17;
+    U8* Data = malloc(Size);
+    CHECK(Data != NULL);
+
+    // Runs, repeated phrases and noise, with matches overlapping their own output.
+    U32 State = 0x9E3779B9u;
+    for (U64 Index = 0; Index < Size; Index++) {
+        State = State * 1664525u + 1013904223u;
+        if (Index < Size / 4) {
+            Data[Index] = (U8)(Index / 300);
+        } else if (Index < Size / 2) {
+            Data[Index] = "stone dirt grass sand "[Index % 22];
+        } else {
+            Data[Index] = (U8)(State >> 24);
+        }
+    }
+
+    const U64 Sizes[] = {0, 1, 5, 12, 13, 64, 4096, Size / 4, Size};
+    for (U32 Index = 0; Index < sizeof Sizes / sizeof Sizes[0]; Index++) {
+        RegionTest_Lz4RoundTrip(Data, Sizes[Index]);
+        RegionTest_Lz4RoundTrip(Data + Size - Sizes[Index], Sizes[Index]);
+    }
+
+    // Compressible data shrinks.
+    U8* Compressed = malloc(Lz4_GetMaxCompressedSize(Size / 2));
+    CHECK(Compressed != NULL);
+    CHECK(Lz4_Compress(Data, Size / 2, Compressed, Lz4_GetMaxCompressedSize(Size / 2)) < Size / 16);
+    free(Compressed);
+
+    free(Data);
+}
+#pragma endregion
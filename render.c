@@ -1,4 +1,6 @@
 ﻿#include <SDL.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <GL/glew.h>
@@ -6,37 +8,157 @@
 #include <cglm/cglm.h>
 #include <SDL_log.h>
 #include <SDL_video.h>
-#include <SDL_ttf.h>
 
 #include "typedefs.h"
 #include "render.h"
 #include "shader.h"
+#include "stream.h"
+#include "raycast.h"
 #include "font.h"
+#include "hash.h"
+#include "headless.h"
+#include "io.h"
+#include "clock.h"
+#include "latency.h"
+#include "mesher.h"
+#include "overlay.h"
+#include "pace.h"
+#include "render_stats.h"
+#include "shape_optimizer.h"
 #include "texture.h"
+#include "thread.h"
 #include "time.h"
+#include "watch.h"
 
 #pragma region Settings
 #define SHADER_PROGRAM_ID_FONT 0
 #define SHADER_PROGRAM_ID_CHUNK 1
+#define SHADER_PROGRAM_ID_OVERLAY 2
 
-static const pStr FontVertexShaderPath = "assets/shaders/font_vs.glsl";
-static const pStr FontFragmentShaderPath = "assets/shaders/font_fs.glsl";
-
-static const pStr ChunkVertexShaderPath = "assets/shaders/vs.glsl";
-static const pStr ChunkFragmentShaderPath = "assets/shaders/fs.glsl";
 static const pStr ChunkTexturePath = "assets/textures/texture.dds";
+/** Tiles of the chunk texture atlas, the layers of the material array. */
+#define CHUNK_ATLAS_COLUMNS 8
+#define CHUNK_ATLAS_ROWS 8
 
-static const pStr TextureUniformName = "texture";
+static const pStr TextureUniformName = "materials";
 static const pStr TransformMatrixUniformName = "MVP";
 static const pStr ModelMatrixUniformName = "M";
 static const pStr CameraPositionUniformName = "eyePosition";
+static const pStr OverlayScreenSizeUniformName = "screenSize";
+static const pStr FontTextureUniformName = "sTexture";
+static const pStr SectionOriginUniformName = "sectionOrigin";
+
+/** Shader program sources, reloaded when one of their files changes. */
+typedef struct {
+    U32 ProgramIndex;
+    pStr VertexShaderPath;
+    pStr FragmentShaderPath;
+} FRenderProgramSource;
+
+static const FRenderProgramSource ProgramSources[] = {
+    {SHADER_PROGRAM_ID_FONT, "assets/shaders/font_vs.glsl", "assets/shaders/font_fs.glsl"},
+    {SHADER_PROGRAM_ID_CHUNK, "assets/shaders/vs.glsl", "assets/shaders/fs.glsl"},
+    {SHADER_PROGRAM_ID_OVERLAY, "assets/shaders/overlay_vs.glsl", "assets/shaders/overlay_fs.glsl"},
+};
+#define PROGRAM_SOURCE_COUNT (sizeof ProgramSources / sizeof ProgramSources[0])
+
+/** Chunk program source replacing the one of ProgramSources when the render settings pull faces. */
+static const FRenderProgramSource ChunkFaceProgramSource = {SHADER_PROGRAM_ID_CHUNK, "assets/shaders/faces_vs.glsl", "assets/shaders/fs.glsl"};
 
 static const char* DefaultWindowTitle = "Shquarkz Game Engine";
+
+/** Distance in blocks at which the camera targets blocks. */
+static const F32 CameraReach = 8.f;
+
+/** Frame packets, one rendered, one queued and one being built. */
+#define RENDER_PACKET_COUNT 3
+#define RENDER_HUD_SIZE 1024
+
+/** Frames whose GPU timer queries are in flight, a frame's pass times are read up to this many frames later. */
+#define RENDER_QUERY_FRAMES 4
+
+/** Overlay layout in pixels, the font is scaled up from its 3x5 glyphs. */
+#define RENDER_OVERLAY_MARGIN 8.f
+#define RENDER_OVERLAY_SCALE 2.f
+#define RENDER_OVERLAY_WIDTH 480.f
+#define RENDER_OVERLAY_GRAPH_HEIGHT 64.f
+
+/** HUD text size and its distance from the bottom left corner, in pixels. */
+#define RENDER_TEXT_SIZE 16.f
+#define RENDER_TEXT_MARGIN 8.f
+
+/** Replaces the elements of a vector with the ones of another, keeping its memory when they fit. */
+#define RENDER_COPY_VECTOR(From, To)                                \
+    do {                                                            \
+        const size_t CopySize = FVector_GetSize(From);              \
+        FVector_Reserve(To, CopySize);                              \
+        if (CopySize > 0) {                                         \
+            memcpy((To), (From), CopySize * sizeof *(From));        \
+        }                                                           \
+        FVector_SetSize(To, CopySize);                              \
+    } while (0)
+
 const int DefaultWindowWidth = 1140;
 const int DefaultWindowHeight = 855;
 
 #pragma endregion
 
+/** GPU buffers of a streamed chunk, sections without faces have none. */
+typedef struct {
+    U32 VertexArrays[CHUNK_SECTION_COUNT];
+    /** Index, vertex, color, texture coordinate and normal buffers, see Shape_Buffer. Only the face buffer when pulling faces. */
+    U32 Buffers[CHUNK_SECTION_COUNT][5];
+    /** Indices to draw, or vertices pulled from the face records, six per face. */
+    U32 IndexCounts[CHUNK_SECTION_COUNT];
+    /** GL type of the section indices, see Shape_GetIndexType. */
+    U32 IndexTypes[CHUNK_SECTION_COUNT];
+    /** Bytes allocated for the section buffers. */
+    U64 SectionSizes[CHUNK_SECTION_COUNT];
+} FRenderChunk;
+
+typedef enum {
+    RENDER_COMMAND_UPLOAD_SECTION = 0,
+    RENDER_COMMAND_RELEASE,
+} ERenderCommandType;
+
+/** Buffer change of a chunk, the section mesh is copied into the shapes of the packet. */
+typedef struct {
+    ERenderCommandType Type;
+    FRenderChunk* Chunk;
+    U32 Section;
+    U32 Shape;
+} FRenderCommand;
+
+/** Uploaded chunk to draw at its world block position. */
+typedef struct {
+    const FRenderChunk* Chunk;
+    I32 X;
+    I32 Y;
+    I32 Z;
+} FRenderDraw;
+
+/**
+ * Everything the render thread needs for a frame, built by the main thread and not changed until rendered. Commands
+ * run before the draws, in the order Stream_Update issued them.
+ */
+typedef struct {
+    mat4 ViewProjection;
+    vec3 CameraPosition;
+    Bool bDrawScene;
+    FVector(FRenderCommand) Commands;
+    /** Shapes of the commands, the ones past ShapeCount keep their memory for the next packets. */
+    FVector(FShape) Shapes;
+    U32 ShapeCount;
+    FVector(FRenderDraw) Draws;
+    FVector(U64) EventTimestamps;
+    char Hud[RENDER_HUD_SIZE];
+    /** Time the main thread waited for the packet to be free. */
+    U64 MainWaitNanoseconds;
+    /** Draws the render stats overlay, see Render_ToggleOverlay. */
+    Bool bOverlay;
+    Bool bQuit;
+} FRenderPacket;
+
 #pragma region Private Fields
 /** Window title. */
 const pStr* WindowTitle;
@@ -48,16 +170,16 @@ SDL_GLContext pSDL_GlContext;
 /** SDL Renderer for simple drawing. */
 SDL_Renderer* pSDL_Renderer;
 
-SDL_Rect TextRect = {0, 0, 0, 0};
-pStr TextLine = "";
-SDL_Texture* TextTexture = NULL;
-
 /** Render service initialization flag. */
 Bool bInitialized;
 
 /** Shader programs. */
 U32 ShaderPrograms[8] = {0};
 
+/** Defines of the chunk program variant picked by the render settings. */
+pStr ChunkDefines[5];
+U32 ChunkDefineCount;
+
 /** Texture Id. */
 U32 ChunkTextureId;
 
@@ -89,15 +211,189 @@ F32 CameraNearClipDistance;
 F32 CameraFarClipDistance;
 /** Camera uniform. */
 U32 CameraUniformId;
+/** Section origin uniform of the face pulling chunk program. */
+U32 SectionOriginUniformId;
 
 /** Vertex array. */
 U32 DefaultVertexArrayId;
+
+/** Chunks streamed around the camera. */
+FStream* Stream;
+
+/** Block the camera looks at, air when none is within reach. */
+FRaycastHit CameraTarget;
+
+/** Fences of the swapped frames in flight with their latency frame ids, oldest first. */
+GLsync FrameFences[LATENCY_MAX_FRAMES_IN_FLIGHT];
+U32 FrameFenceIds[LATENCY_MAX_FRAMES_IN_FLIGHT];
+U32 FrameFenceHead;
+U32 FrameFenceCount;
+
+/** Frame packets handed from the main thread to the render thread in order, the semaphores count free and ready ones. */
+FRenderPacket Packets[RENDER_PACKET_COUNT];
+U32 PacketHead;
+U32 PacketTail;
+SDL_sem* FreePackets;
+SDL_sem* ReadyPackets;
+FThread* RenderThread;
+
+/** Packet the main thread is building, stream callbacks add to it. */
+FRenderPacket* BuildingPacket;
+
+/** Set once the chunk program is loaded, until then chunks aren't streamed. */
+SDL_atomic_t bChunkProgramReady;
+
+/** Time the render thread waited for the last packet. */
+U64 RenderWaitNanoseconds;
+
+/** Display refresh period, 0 when unknown. */
+U64 RefreshNanoseconds;
+
+/** Vsync mode of the render thread and the swap interval set on its context. */
+FSwapControl SwapControl;
+I32 SwapInterval;
+
+FRenderSettings RenderSettings;
+
+/** Framebuffer of headless rendering with its color and depth renderbuffers. */
+U32 OffscreenFramebufferId;
+U32 OffscreenRenderbufferIds[2];
+
+/** Frames rendered by the render thread. */
+U64 RenderedFrames;
+
+/** Last frame read back and its pixels, locked while the render thread reads a frame back. */
+FMutex* ReadbackMutex;
+FRenderReadback Readback;
+Byte* ReadbackPixels;
+
+/** Overlay visibility toggled by the main thread, copied into each packet. */
+Bool bOverlayVisible;
+
+/** Overlay vertices, refilled each frame the overlay is drawn. */
+U32 OverlayVertexArrayId;
+U32 OverlayBufferId;
+U32 OverlayScreenSizeUniformId;
+
+/** Text quads of the frame drawn in one call from the font atlas texture, uploaded once the font is ready. */
+FVector(FFontVertex) TextVertices;
+U32 TextVertexArrayId;
+U32 TextBufferId;
+U32 FontTextureId;
+U32 FontScreenSizeUniformId;
+U32 FontTextureUniformId;
+
+/**
+ * GPU timer queries of the passes of the frames in flight, a frame uses the slot of its number modulo the count. Each
+ * slot has the frame it timed, 0 once read, and the bits of the passes that ran.
+ */
+U32 PassQueries[RENDER_QUERY_FRAMES][RENDER_PASS_COUNT];
+U64 PassQueryFrames[RENDER_QUERY_FRAMES];
+U32 PassQueryMasks[RENDER_QUERY_FRAMES];
+
+/** Time the last frame was swapped, frame times of the render stats are measured between swaps. */
+U64 LastSwapTimestamp;
 #pragma endregion
 
 #pragma region Private Function Declarations
 /** Clears memory. */
 static void Render_Cleanup();
 
+/** Creates the window and its GL context. */
+static Bool Render_CreateWindow();
+
+/** Makes the window or the offscreen context current on the calling thread, or releases it. */
+static void Render_MakeCurrent(Bool bCurrent);
+
+/** Creates the offscreen framebuffer of headless rendering and binds it. Returns False if it isn't complete. */
+static Bool Render_CreateOffscreenFramebuffer();
+
+/** Reads the rendered frame back and hashes it. */
+static void Render_ReadFrame();
+
+/** Reports the frames the GPU finished to the latency service, without waiting for the others. */
+static void Render_PollFrameFences();
+
+/** Starts the timer query of a pass of the frame being rendered, passes don't nest. */
+static void Render_BeginPass(ERenderPass Pass);
+
+static void Render_EndPass();
+
+/** Reads the pass times of the past frames the GPU finished to the render stats, oldest first, without waiting. */
+static void Render_ResolvePassQueries();
+
+/** Creates the vertex array of the overlay vertices. */
+static void Render_CreateOverlay();
+
+/** Builds the overlay of the last frame's render stats and draws it in one call. */
+static void Render_DrawOverlay();
+
+/** Creates the vertex array of the text vertices. */
+static void Render_CreateText();
+
+/** Adds a line of text with its top left corner at the position, in pixels, to the text drawn by Render_DrawText. */
+static void Render_AddText(const FFontAtlas* Atlas, F32 X, F32 Y, F32 Size, pStr Text, U32 Color);
+
+/** Draws the text added since the last call in one call, uploading the font atlas the first time. */
+static void Render_DrawText(const FFontAtlas* Atlas);
+
+/** Streams chunks around the camera and fills the packet with the chunk buffer changes and the chunks to draw. */
+static void Render_BuildScene(FRenderPacket* Packet);
+
+static void Render_BuildHUD(FRenderPacket* Packet);
+
+/** Render thread loop, renders the ready packets until a packet asks it to quit. */
+static int Render_RunThread(void* UserData);
+
+/** Renders the packet and swaps, on the thread owning the GL context. */
+static void Render_Frame(FRenderPacket* Packet);
+
+static void Render_RunCommands(FRenderPacket* Packet);
+
+/** Copies the mesh into the next shape of the packet, returns its index. */
+static U32 Render_CopyShape(FRenderPacket* Packet, const FShape* Shape);
+
+static void Render_AddCommand(FRenderPacket* Packet, FRenderCommand Command);
+
+/** Adds an uploaded chunk to the draws of the packet being built. */
+static void Render_OnChunkVisited(const FChunk* Chunk, void* RenderData, void* UserData);
+
+/** Swaps the loaded program of the FRenderProgramSource in, a failed load keeps the previous program. */
+static void Render_OnProgramLoaded(U32 ProgramId, void* UserData);
+
+/** Returns the program source at the index, with the chunk source picked by the render settings. */
+static const FRenderProgramSource* Render_GetProgramSource(U32 Index);
+
+/** Loads the program of the source, the chunk program as the variant of the render settings. */
+static Bool Render_LoadProgram(const FRenderProgramSource* Source);
+
+/** Loads the chunk texture, as a material array when the render settings ask for one. */
+static void Render_LoadChunkTexture(pStr Path);
+
+/** Looks up the chunk program uniforms, and sets the mesher palette of the face pulling program. */
+static void Render_LoadChunkUniforms(U32 ProgramId);
+
+/** Swaps the chunk texture in, a failed load keeps the previous texture. */
+static void Render_OnChunkTextureLoaded(U32 TextureId, void* UserData);
+
+/** Reloads the programs using the changed shader file. */
+static void Render_OnShaderChanged(pStr Path, void* UserData);
+
+/** Reloads the changed chunk texture. */
+static void Render_OnTextureChanged(pStr Path, void* UserData);
+
+/** Queues the upload of the section meshes of a streamed chunk, called by Stream_Update. */
+static void* Render_OnChunkUpload(const FChunk* Chunk, const FShape Shapes[CHUNK_SECTION_COUNT], U64* OutSize, void* UserData);
+
+/** Queues the replacement of the mesh of a section after block edits. */
+static void Render_OnChunkSectionUpload(const FChunk* Chunk, U32 Section, const FShape* Shape, void* RenderData, U64* InOutSize, void* UserData);
+
+/** Queues the deletion of the buffers of an evicted chunk. */
+static void Render_OnChunkRelease(const FChunk* Chunk, void* RenderData, void* UserData);
+
+/** Draws the sections of an uploaded chunk. */
+static void Render_DrawChunk(const FRenderDraw* Draw, vec4* ViewProjection);
+
 #if _DEBUG
 static void GLAPIENTRY Render_OpenGlMessageCallback(const GLenum Source, const GLenum Type, const GLuint Id, GLenum Severity, GLsizei Length, const GLchar* Message,
                                                     const void* UserParam) {
@@ -110,46 +406,39 @@ static void GLAPIENTRY Render_OpenGlMessageCallback(const GLenum Source, const G
 
 #pragma region Public Function Definitions
 
-void Render_Initialize() {
-    // Initialize SDL video.
-    if (SDL_Init(0) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL.");
-        return;
-    }
-
-    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL video.");
-        return;
-    }
-
-    // Configure OpenGL.
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
-    SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
+void Render_GetDefaultSettings(FRenderSettings* OutSettings) {
+    FStreamSettings StreamSettings;
+    Stream_GetDefaultSettings(&StreamSettings);
+
+    OutSettings->Seed = StreamSettings.Seed;
+    OutSettings->bHeadless = False;
+    OutSettings->bReadback = False;
+    OutSettings->Width = DefaultWindowWidth;
+    OutSettings->Height = DefaultWindowHeight;
+    OutSettings->bMaterialArray = True;
+    OutSettings->bFacePulling = False;
+    OutSettings->ChunkFeatures = RENDER_CHUNK_DETAIL | RENDER_CHUNK_FOG;
+    OutSettings->TextSize = RENDER_TEXT_SIZE;
+    OutSettings->bSingleThread = False;
+}
 
-    // Create SDL window.
-    const U32 ContextFlags = SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL;
-    pSDL_Window = SDL_CreateWindow(DefaultWindowTitle, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, DefaultWindowWidth, DefaultWindowHeight, ContextFlags);
+void Render_Initialize(const FRenderSettings* Settings) {
+    RenderSettings = *Settings;
+    RenderStats_Reset();
 
-    pSDL_Renderer = SDL_CreateRenderer(pSDL_Window, -1, SDL_RENDERER_ACCELERATED);
-    if (pSDL_Renderer == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL renderer.");
+    if (RenderSettings.bHeadless) {
+        // Build machines have no display, the context renders to an offscreen framebuffer.
+        if (!Headless_Initialize(4, 5)) {
+            return;
+        }
+    } else if (!Render_CreateWindow()) {
         return;
     }
 
-    // Create OpenGL context.
-    pSDL_GlContext = SDL_GL_CreateContext(pSDL_Window);
-    if (pSDL_GlContext == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render service SDL GL context was null @ %s", __FUNCTION__);
-        return;
-    }
-
-    // Initialize GLEW.
+    // Initialize GLEW. A GLEW built for GLX has no display to query under EGL, the GL functions are loaded regardless.
     glewExperimental = GL_TRUE;
-    if (glewInit() != GLEW_OK) {
+    const GLenum GlewStatus = glewInit();
+    if (GlewStatus != GLEW_OK && !(RenderSettings.bHeadless && GlewStatus == GLEW_ERROR_NO_GLX_DISPLAY)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize GLEW");
         return;
     }
@@ -162,6 +451,25 @@ void Render_Initialize() {
 
     SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "%s", glGetString(GL_VERSION));
 
+    if (RenderSettings.bHeadless) {
+        if (!Render_CreateOffscreenFramebuffer()) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create the offscreen framebuffer.");
+            return;
+        }
+
+        if (RenderSettings.bReadback) {
+            ReadbackMutex = Mutex_Create();
+            ReadbackPixels = malloc((size_t)RenderSettings.Width * RenderSettings.Height * 4);
+        }
+    } else {
+        // Vsync, switched to adaptive vsync by the swap control while frames miss the refresh when the driver has it.
+        SDL_DisplayMode DisplayMode;
+        RefreshNanoseconds = SDL_GetWindowDisplayMode(pSDL_Window, &DisplayMode) == 0 && DisplayMode.refresh_rate > 0 ? 1000000000ull / DisplayMode.refresh_rate : 0;
+        const Bool bAdaptiveSupported = SDL_GL_SetSwapInterval(-1) == 0;
+        SwapInterval = SDL_GL_SetSwapInterval(1) == 0 ? 1 : 0;
+        Pace_InitSwapControl(&SwapControl, SwapInterval == 1 ? RefreshNanoseconds : 0, bAdaptiveSupported);
+    }
+
     // Setup camera.
     glm_vec3_zero(CameraPosition);
     glm_vec3_copy((vec3){0, 0, -1}, CameraForward);
@@ -169,7 +477,7 @@ void Render_Initialize() {
     glm_vec3_copy((vec3){0, 1, 0}, CameraUp);
 
     // Define perspective camera view matrix.
-    glm_perspective(45.0f, 4.0f / 3.0f, 0.1f, 1000.f, Projection);
+    glm_perspective(45.0f, (F32)RenderSettings.Width / (F32)RenderSettings.Height, 0.1f, 1000.f, Projection);
 
     // Define camera look at matrix.
     glm_lookat(CameraPosition, CameraForward, CameraUp, View);
@@ -184,57 +492,103 @@ void Render_Initialize() {
     // Cull triangles which normals are not facing the camera.
     glEnable(GL_CULL_FACE);
 
-    ShaderPrograms[SHADER_PROGRAM_ID_FONT] = Shader_LoadProgram(FontVertexShaderPath, FontFragmentShaderPath, StrEmpty);
-    if (ShaderPrograms[SHADER_PROGRAM_ID_FONT] == InvalidId) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders.");
-        return;
+    // The chunk shader variant has only the features asked for, the common case samples one texture.
+    ChunkDefineCount = 0;
+    if (RenderSettings.bMaterialArray) {
+        ChunkDefines[ChunkDefineCount++] = "MATERIAL_ARRAY";
+    }
+    if (RenderSettings.ChunkFeatures & RENDER_CHUNK_DETAIL) {
+        ChunkDefines[ChunkDefineCount++] = "DETAIL";
+    }
+    if (RenderSettings.ChunkFeatures & RENDER_CHUNK_FOG) {
+        ChunkDefines[ChunkDefineCount++] = "FOG";
+    }
+    if (RenderSettings.ChunkFeatures & RENDER_CHUNK_SMUDGE) {
+        ChunkDefines[ChunkDefineCount++] = "SMUDGE";
+    }
+    if (RenderSettings.ChunkFeatures & RENDER_CHUNK_RIM) {
+        ChunkDefines[ChunkDefineCount++] = "RIM";
     }
 
-    ShaderPrograms[SHADER_PROGRAM_ID_CHUNK] = Shader_LoadProgram(ChunkVertexShaderPath, ChunkFragmentShaderPath, StrEmpty);
-    if (ShaderPrograms[SHADER_PROGRAM_ID_CHUNK] == InvalidId) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders.");
-        return;
+    // Shaders and textures arrive through the io service, the scene is skipped until they are ready.
+    for (U32 Index = 0; Index < PROGRAM_SOURCE_COUNT; Index++) {
+        const FRenderProgramSource* Source = Render_GetProgramSource(Index);
+        if (!Render_LoadProgram(Source)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders.");
+            return;
+        }
+
+        // Watches are only active in development builds, see Watch_Initialize.
+        Watch_AddFile(Source->VertexShaderPath, Render_OnShaderChanged, NULL);
+        Watch_AddFile(Source->FragmentShaderPath, Render_OnShaderChanged, NULL);
     }
 
-    ChunkTextureId = Texture_LoadDDS(ChunkTexturePath);
+    Render_LoadChunkTexture(ChunkTexturePath);
+    Watch_AddFile(ChunkTexturePath, Render_OnTextureChanged, NULL);
+
+    Render_CreateOverlay();
+    Render_CreateText();
+    glGenQueries(RENDER_QUERY_FRAMES * RENDER_PASS_COUNT, PassQueries[0]);
+    RenderStats_AddObjects(RENDER_OBJECT_QUERY, RENDER_QUERY_FRAMES * RENDER_PASS_COUNT);
 
     glGenVertexArrays(1, &DefaultVertexArrayId);
     glBindVertexArray(DefaultVertexArrayId);
+    RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, 1);
+
+    FStreamSettings StreamSettings;
+    Stream_GetDefaultSettings(&StreamSettings);
+    StreamSettings.Seed = RenderSettings.Seed;
+    StreamSettings.bFaceRecords = RenderSettings.bFacePulling;
+    StreamSettings.Upload = Render_OnChunkUpload;
+    StreamSettings.UploadSection = Render_OnChunkSectionUpload;
+    StreamSettings.Release = Render_OnChunkRelease;
+    Stream = Stream_Create(&StreamSettings);
+    if (Stream == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to start chunk streaming.");
+        return;
+    }
 
-    // todo load chunks
+    FreePackets = SDL_CreateSemaphore(RENDER_PACKET_COUNT);
+    ReadyPackets = SDL_CreateSemaphore(0);
+    if (FreePackets == NULL || ReadyPackets == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create frame packet semaphores: %s", SDL_GetError());
+        return;
+    }
 
-    glUseProgram(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK]);
+    bInitialized = True;
 
-    ModelMatrixUniformId = glGetUniformLocation(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK], ModelMatrixUniformName);
-    if (ModelMatrixUniformId == -1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", TextureUniformName);
-        return;
+    // The render thread takes the context over, without it the packets are rendered by Render_Tick.
+    if (!RenderSettings.bSingleThread) {
+        Render_MakeCurrent(False);
+        RenderThread = Thread_Create(Render_RunThread, "Render", NULL);
+        if (RenderThread == NULL) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to start the render thread, rendering on the main thread.");
+            Render_MakeCurrent(True);
+        }
     }
+}
 
-    TransformMatrixUniformId = glGetUniformLocation(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK], TransformMatrixUniformName);
-    if (TransformMatrixUniformId == -1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", TransformMatrixUniformName);
-        return;
+void Render_Shutdown() {
+    // The render thread renders the queued packets, then the context comes back to this thread for the cleanup.
+    if (RenderThread != NULL) {
+        SDL_SemWait(FreePackets);
+        Packets[PacketHead % RENDER_PACKET_COUNT].bQuit = True;
+        SDL_SemPost(ReadyPackets);
+        Thread_Join(RenderThread);
+        RenderThread = NULL;
+        Render_MakeCurrent(True);
     }
 
-    CameraUniformId = glGetUniformLocation(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK], CameraPositionUniformName);
-    if (CameraUniformId == -1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", CameraUniformId);
-        return;
+    if (bInitialized) {
+        Render_Cleanup();
     }
 
-    TextureUniformId = glGetUniformLocation(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK], TextureUniformName);
-    if (TextureUniformId == -1) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", TextureUniformName);
+    if (RenderSettings.bHeadless) {
+        Headless_Shutdown();
         return;
     }
 
-    bInitialized = True;
-}
-
-void Render_Shutdown() {
     SDL_DestroyWindow(pSDL_Window);
-    Render_Cleanup();
 
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
@@ -243,137 +597,964 @@ SDL_Window* Render_GetSDLWindow() {
     return pSDL_Window;
 }
 
-void Render_DrawText(const pStr Text) {
-    TextLine = Text;
+Bool Render_GetReadback(FRenderReadback* OutReadback, Byte* OutPixels) {
+    if (ReadbackMutex != NULL) {
+        Mutex_Lock(ReadbackMutex);
+    }
 
-    const SDL_Color TextColor = {1, 0, 0, 1};
+    *OutReadback = Readback;
+    if (OutPixels != NULL && ReadbackPixels != NULL && Readback.Frame > 0) {
+        memcpy(OutPixels, ReadbackPixels, (size_t)Readback.Width * Readback.Height * 4);
+    }
 
-    TTF_Font* Font = Font_GetFont();
-    if (Font == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get a font!");
+    if (ReadbackMutex != NULL) {
+        Mutex_Unlock(ReadbackMutex);
+    }
+
+    return Readback.Frame > 0;
+}
+
+U64 Render_GetRefreshNanoseconds() {
+    return RefreshNanoseconds;
+}
+
+void Render_ToggleOverlay() {
+    bOverlayVisible = !bOverlayVisible;
+}
+
+void Render_Tick(const U64* EventTimestamps, const U32 EventCount) {
+    if (!bInitialized) {
         return;
     }
 
-    SDL_Texture* pTexture = Render_RenderTextToTexture(Text, TextColor, 0, 0, Font);
+    const U64 WaitStart = Clock_GetNanoseconds();
+    if (RenderThread != NULL) {
+        SDL_SemWait(FreePackets);
+    }
 
-    U32 VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(F32) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(F32), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    FRenderPacket* Packet = &Packets[PacketHead % RENDER_PACKET_COUNT];
+    Packet->MainWaitNanoseconds = Clock_GetNanoseconds() - WaitStart;
+    FVector_Clear(Packet->Commands);
+    FVector_Clear(Packet->Draws);
+    FVector_Clear(Packet->EventTimestamps);
+    Packet->ShapeCount = 0;
+    Packet->bOverlay = bOverlayVisible;
+
+    for (U32 Index = 0; Index < EventCount; Index++) {
+        if (FVector_GetSize(Packet->EventTimestamps) == FVector_GetCapacity(Packet->EventTimestamps)) {
+            const size_t Capacity = FVector_GetCapacity(Packet->EventTimestamps) * 2 + 64;
+            FVector_Reserve(Packet->EventTimestamps, Capacity);
+        }
+        FVector_Add(Packet->EventTimestamps, EventTimestamps[Index]);
+    }
+
+    Render_BuildScene(Packet);
+    Render_BuildHUD(Packet);
+    PacketHead++;
+
+    // Simulation of the next frame overlaps with the submission of this one.
+    if (RenderThread != NULL) {
+        SDL_SemPost(ReadyPackets);
+    } else {
+        Render_Frame(Packet);
+        PacketTail++;
+    }
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void Render_Cleanup() {
+    // Chunk buffers are released through Render_OnChunkRelease, its commands run here while the context is alive.
+    FRenderPacket* Packet = &Packets[PacketHead % RENDER_PACKET_COUNT];
+    FVector_Clear(Packet->Commands);
+    Packet->ShapeCount = 0;
+    BuildingPacket = Packet;
+    Stream_Destroy(Stream);
+    Stream = NULL;
+    Render_RunCommands(Packet);
+
+    for (; FrameFenceCount > 0; FrameFenceCount--) {
+        glDeleteSync(FrameFences[FrameFenceHead]);
+        FrameFenceHead = (FrameFenceHead + 1) % LATENCY_MAX_FRAMES_IN_FLIGHT;
+        RenderStats_AddObjects(RENDER_OBJECT_SYNC, -1);
+    }
+
+    for (U32 Index = 0; Index < RENDER_PACKET_COUNT; Index++) {
+        FRenderPacket* Freed = &Packets[Index];
+        for (size_t Shape = 0; Shape < FVector_GetSize(Freed->Shapes); Shape++) {
+            Shape_Free(&Freed->Shapes[Shape]);
+        }
+        FVector_Free(Freed->Shapes);
+        FVector_Free(Freed->Commands);
+        FVector_Free(Freed->Draws);
+        FVector_Free(Freed->EventTimestamps);
+        *Freed = (FRenderPacket){0};
+    }
+
+    SDL_DestroySemaphore(FreePackets);
+    SDL_DestroySemaphore(ReadyPackets);
+    FreePackets = NULL;
+    ReadyPackets = NULL;
+
+    glDeleteVertexArrays(1, &DefaultVertexArrayId);
+    glDeleteVertexArrays(1, &OverlayVertexArrayId);
+    glDeleteBuffers(1, &OverlayBufferId);
+    glDeleteVertexArrays(1, &TextVertexArrayId);
+    glDeleteBuffers(1, &TextBufferId);
     glBindVertexArray(0);
+    RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, -3);
+    RenderStats_AddObjects(RENDER_OBJECT_BUFFER, -2);
+    Overlay_Shutdown();
+    FVector_Free(TextVertices);
+    TextVertices = NULL;
+
+    if (FontTextureId != 0) {
+        glDeleteTextures(1, &FontTextureId);
+        FontTextureId = 0;
+        RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, -1);
+    }
+
+    glDeleteQueries(RENDER_QUERY_FRAMES * RENDER_PASS_COUNT, PassQueries[0]);
+    RenderStats_AddObjects(RENDER_OBJECT_QUERY, -RENDER_QUERY_FRAMES * RENDER_PASS_COUNT);
 
-    F32 OutWidth, OutHeight;
-    SDL_GL_BindTexture(pTexture, &OutWidth, &OutHeight);
+    for (U32 Index = 0; Index < PROGRAM_SOURCE_COUNT; Index++) {
+        const U32 ProgramId = ShaderPrograms[ProgramSources[Index].ProgramIndex];
+        if (ProgramId != 0 && ProgramId != InvalidId) {
+            glDeleteProgram(ProgramId);
+            RenderStats_AddObjects(RENDER_OBJECT_PROGRAM, -1);
+        }
+    }
+
+    if (ChunkTextureId != 0) {
+        glDeleteTextures(1, &ChunkTextureId);
+        RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, -1);
+    }
+
+    if (RenderSettings.bHeadless) {
+        // The offscreen context itself goes with Headless_Shutdown.
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &OffscreenFramebufferId);
+        glDeleteRenderbuffers(2, OffscreenRenderbufferIds);
+        OffscreenFramebufferId = 0;
+        RenderStats_AddObjects(RENDER_OBJECT_FRAMEBUFFER, -3);
+
+        Mutex_Destroy(ReadbackMutex);
+        ReadbackMutex = NULL;
+        free(ReadbackPixels);
+        ReadbackPixels = NULL;
+        return;
+    }
+
+    SDL_GL_DeleteContext(pSDL_GlContext);
 }
 
-SDL_Texture* Render_RenderTextToTexture(const pStr Text, const SDL_Color Color, const I32 X, const I32 Y, TTF_Font* Font) {
-    // Render the text.
-    SDL_Surface* pSurface = TTF_RenderText_Blended(Font, Text, Color);
-    if (pSurface == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "TTF_RenderText");
-        return NULL;
+Bool Render_CreateWindow() {
+    // Initialize SDL video.
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL.");
+        return False;
+    }
+
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL video.");
+        return False;
     }
 
-    // Create a texture.
-    SDL_Texture* pTexture = SDL_CreateTextureFromSurface(pSDL_Renderer, pSurface);
-    if (pTexture == NULL) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "CreateTexture");
+    // Configure OpenGL.
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+    SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
+
+    // Create SDL window.
+    const U32 ContextFlags = SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL;
+    pSDL_Window = SDL_CreateWindow(DefaultWindowTitle, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, RenderSettings.Width, RenderSettings.Height, ContextFlags);
+
+    pSDL_Renderer = SDL_CreateRenderer(pSDL_Window, -1, SDL_RENDERER_ACCELERATED);
+    if (pSDL_Renderer == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unable to initialize SDL renderer.");
+        return False;
     }
 
-    SDL_FreeSurface(pSurface);
+    // Create OpenGL context.
+    pSDL_GlContext = SDL_GL_CreateContext(pSDL_Window);
+    if (pSDL_GlContext == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render service SDL GL context was null @ %s", __FUNCTION__);
+        return False;
+    }
 
-    return pTexture;
+    return True;
 }
 
-void Render_Scene() {
-    if (!bInitialized) {
-        return;
+void Render_MakeCurrent(const Bool bCurrent) {
+    if (RenderSettings.bHeadless) {
+        Headless_MakeCurrent(bCurrent);
+    } else {
+        SDL_GL_MakeCurrent(pSDL_Window, bCurrent ? pSDL_GlContext : NULL);
     }
+}
 
-    /** Use the shader program. */
-    glUseProgram(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK]);
+Bool Render_CreateOffscreenFramebuffer() {
+    glGenRenderbuffers(2, OffscreenRenderbufferIds);
+    glBindRenderbuffer(GL_RENDERBUFFER, OffscreenRenderbufferIds[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, RenderSettings.Width, RenderSettings.Height);
+    glBindRenderbuffer(GL_RENDERBUFFER, OffscreenRenderbufferIds[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, RenderSettings.Width, RenderSettings.Height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // Stays bound, everything is drawn into it.
+    glGenFramebuffers(1, &OffscreenFramebufferId);
+    glBindFramebuffer(GL_FRAMEBUFFER, OffscreenFramebufferId);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, OffscreenRenderbufferIds[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, OffscreenRenderbufferIds[1]);
+    glViewport(0, 0, RenderSettings.Width, RenderSettings.Height);
+    RenderStats_AddObjects(RENDER_OBJECT_FRAMEBUFFER, 3);
+
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
 
-    // // 0. copy our vertices array in a buffer for OpenGL to use
-    // glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    // // 1. then set the vertex attributes pointers
-    // glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    // glEnableVertexAttribArray(0);  
-    // // 2. use our shader program when we want to render an object
-    // glUseProgram(shaderProgram);
-    // // 3. now draw the object 
-    // someOpenGLFunctionThatDrawsOurTriangle();   
+void Render_ReadFrame() {
+    Mutex_Lock(ReadbackMutex);
 
-    float TriangleVertices[] = {
-        -0.5f, -0.5f, 0.0f,
-        0.5f, -0.5f, 0.0f,
-        0.0f, 0.5f, 0.0f
-    };
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, RenderSettings.Width, RenderSettings.Height, GL_RGBA, GL_UNSIGNED_BYTE, ReadbackPixels);
 
-    U32 VertexBuffer;
-    glGenBuffers(1, &VertexBuffer);
-    glBindBuffer(GL_ARRAY_BUFFER, VertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, sizeof TriangleVertices, TriangleVertices, GL_STATIC_DRAW);
+    const U64 Size = (U64)RenderSettings.Width * RenderSettings.Height * 4;
+    Readback.Frame = RenderedFrames;
+    Readback.Width = (U32)RenderSettings.Width;
+    Readback.Height = (U32)RenderSettings.Height;
+    Readback.Checksum = Hash_Compute(ReadbackPixels, Size, 0);
 
-    // glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof F32, 0);
-    // glEnableVertexAttribArray(0);
+    Mutex_Unlock(ReadbackMutex);
+}
 
-    /** Send information to the shader program. */
-    // glUniform3f(CameraUniformId, CameraPosition[0], CameraPosition[1], CameraPosition[2]);
+void Render_PollFrameFences() {
+    while (FrameFenceCount > 0) {
+        const GLenum Status = glClientWaitSync(FrameFences[FrameFenceHead], 0, 0);
+        if (Status != GL_ALREADY_SIGNALED && Status != GL_CONDITION_SATISFIED) {
+            break;
+        }
+
+        Latency_CompleteFrame(FrameFenceIds[FrameFenceHead], Clock_GetNanoseconds());
+        glDeleteSync(FrameFences[FrameFenceHead]);
+        FrameFenceHead = (FrameFenceHead + 1) % LATENCY_MAX_FRAMES_IN_FLIGHT;
+        FrameFenceCount--;
+        RenderStats_AddObjects(RENDER_OBJECT_SYNC, -1);
+    }
+}
 
-    /** Bind texture to the texture unit 0. */
-    // glActiveTexture(GL_TEXTURE0);
-    // glBindTexture(TextureUniformId, TextureId);
+void Render_BeginPass(const ERenderPass Pass) {
+    const U64 Frame = RenderStats_GetFrame();
+    const U32 Slot = (U32)(Frame % RENDER_QUERY_FRAMES);
+    if (PassQueryFrames[Slot] != Frame) {
+        // Queries of a frame the GPU hasn't finished by now are dropped, their results are replaced.
+        PassQueryFrames[Slot] = Frame;
+        PassQueryMasks[Slot] = 0;
+    }
 
-    /** Set texture sampler to texture unit 0. */
-    // glUniform1i(TextureUniformId, 0);
+    PassQueryMasks[Slot] |= 1u << Pass;
+    glBeginQuery(GL_TIME_ELAPSED, PassQueries[Slot][Pass]);
+}
 
-    // if (pSDL_Renderer != NULL && TextTexture != NULL) {
-    // SDL_RenderCopy(pSDL_Renderer, TextTexture, NULL, &TextRect);
-    // }
+void Render_EndPass() {
+    glEndQuery(GL_TIME_ELAPSED);
 }
 
-void Render_HUD() {
-    if (!bInitialized) {
+void Render_ResolvePassQueries() {
+    const U64 Frame = RenderStats_GetFrame();
+    for (U64 Past = Frame > RENDER_QUERY_FRAMES ? Frame - RENDER_QUERY_FRAMES + 1 : 1; Past < Frame; Past++) {
+        const U32 Slot = (U32)(Past % RENDER_QUERY_FRAMES);
+        if (PassQueryFrames[Slot] != Past || PassQueryMasks[Slot] == 0) {
+            continue;
+        }
+
+        // The GPU finishes queries in order, once the last pass of a frame is available the others are too.
+        U32 LastPass = 0;
+        for (U32 Pass = 0; Pass < RENDER_PASS_COUNT; Pass++) {
+            if (PassQueryMasks[Slot] >> Pass & 1) {
+                LastPass = Pass;
+            }
+        }
+
+        GLint bAvailable = GL_FALSE;
+        glGetQueryObjectiv(PassQueries[Slot][LastPass], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+        if (!bAvailable) {
+            break;
+        }
+
+        for (U32 Pass = 0; Pass < RENDER_PASS_COUNT; Pass++) {
+            if (PassQueryMasks[Slot] >> Pass & 1) {
+                GLuint64 Nanoseconds = 0;
+                glGetQueryObjectui64v(PassQueries[Slot][Pass], GL_QUERY_RESULT, &Nanoseconds);
+                RenderStats_SetPassTime(Past, (ERenderPass)Pass, Nanoseconds);
+            }
+        }
+        PassQueryFrames[Slot] = 0;
+    }
+}
+
+void Render_CreateOverlay() {
+    glGenVertexArrays(1, &OverlayVertexArrayId);
+    glGenBuffers(1, &OverlayBufferId);
+    glBindVertexArray(OverlayVertexArrayId);
+    glBindBuffer(GL_ARRAY_BUFFER, OverlayBufferId);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FOverlayVertex), (const void*)offsetof(FOverlayVertex, X));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(FOverlayVertex), (const void*)offsetof(FOverlayVertex, Color));
+    glEnableVertexAttribArray(1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, 1);
+    RenderStats_AddObjects(RENDER_OBJECT_BUFFER, 1);
+}
+
+void Render_DrawOverlay() {
+    const U32 OverlayProgramId = ShaderPrograms[SHADER_PROGRAM_ID_OVERLAY];
+    if (OverlayProgramId == 0 || OverlayProgramId == InvalidId) {
         return;
     }
 
-    char Buffer[1024] = {0};
+    FRenderStats Stats;
+    RenderStats_Get(&Stats);
+
+    const U32 TextColor = OVERLAY_COLOR(255, 255, 255, 255);
+    const F32 LineHeight = (OVERLAY_GLYPH_HEIGHT + 2) * RENDER_OVERLAY_SCALE;
+    const F32 X = RENDER_OVERLAY_MARGIN * 2.f;
+    F32 Y = RENDER_OVERLAY_MARGIN * 2.f;
+
+    char Lines[6][128];
+    const U64* Counters = Stats.Counters;
+    const I64* Objects = Stats.Objects;
+    SDL_snprintf(Lines[0], sizeof Lines[0], "frame %llu, %.2f ms", (unsigned long long)Stats.Frames,
+                 Stats.HistoryCount > 0 ? Stats.FrameMilliseconds[Stats.HistoryCount - 1] : 0.f);
+    SDL_snprintf(Lines[1], sizeof Lines[1], "draws %llu, triangles %llu", (unsigned long long)Counters[RENDER_COUNTER_DRAW_CALLS],
+                 (unsigned long long)Counters[RENDER_COUNTER_TRIANGLES]);
+    SDL_snprintf(Lines[2], sizeof Lines[2], "state changes %llu, programs %llu", (unsigned long long)Counters[RENDER_COUNTER_STATE_CHANGES],
+                 (unsigned long long)Counters[RENDER_COUNTER_PROGRAM_BINDS]);
+    SDL_snprintf(Lines[3], sizeof Lines[3], "uploads buffers %llu kb, textures %llu kb", (unsigned long long)(Counters[RENDER_COUNTER_BUFFER_BYTES] >> 10),
+                 (unsigned long long)(Counters[RENDER_COUNTER_TEXTURE_BYTES] >> 10));
+    SDL_snprintf(Lines[4], sizeof Lines[4], "objects buf %lld vao %lld tex %lld prog %lld fbo %lld query %lld sync %lld",
+                 (long long)Objects[RENDER_OBJECT_BUFFER], (long long)Objects[RENDER_OBJECT_VERTEX_ARRAY], (long long)Objects[RENDER_OBJECT_TEXTURE],
+                 (long long)Objects[RENDER_OBJECT_PROGRAM], (long long)Objects[RENDER_OBJECT_FRAMEBUFFER], (long long)Objects[RENDER_OBJECT_QUERY],
+                 (long long)Objects[RENDER_OBJECT_SYNC]);
+    SDL_snprintf(Lines[5], sizeof Lines[5], "gpu scene %.2f ms, overlay %.2f ms, %llu frames ago", Stats.PassNanoseconds[RENDER_PASS_SCENE] * 1e-6,
+                 Stats.PassNanoseconds[RENDER_PASS_OVERLAY] * 1e-6, (unsigned long long)(Stats.PassFrame > 0 ? Stats.Frames + 1 - Stats.PassFrame : 0));
+
+    // Frames over the refresh period stand out in the graph, which spans two periods.
+    const F32 Limit = RefreshNanoseconds > 0 ? (F32)(RefreshNanoseconds * 1e-6) : 1000.f / 60.f;
+    const F32 Height = LineHeight * 6 + RENDER_OVERLAY_MARGIN + RENDER_OVERLAY_GRAPH_HEIGHT;
+
+    Overlay_Clear();
+    Overlay_AddRect(RENDER_OVERLAY_MARGIN, RENDER_OVERLAY_MARGIN, RENDER_OVERLAY_WIDTH, Height + RENDER_OVERLAY_MARGIN * 2.f, OVERLAY_COLOR(0, 0, 0, 160));
+    for (U32 Line = 0; Line < 6; Line++) {
+        Overlay_AddText(X, Y, RENDER_OVERLAY_SCALE, Lines[Line], TextColor);
+        Y += LineHeight;
+    }
+    Overlay_AddGraph(X, Y + RENDER_OVERLAY_MARGIN, RENDER_OVERLAY_WIDTH - RENDER_OVERLAY_MARGIN * 2.f, RENDER_OVERLAY_GRAPH_HEIGHT, Stats.FrameMilliseconds,
+                     Stats.HistoryCount, Limit * 2.f, Limit, OVERLAY_COLOR(80, 200, 120, 255), OVERLAY_COLOR(230, 70, 60, 255));
+
+    U32 VertexCount = 0;
+    const FOverlayVertex* Vertices = Overlay_GetVertices(&VertexCount);
+    const U64 Size = (U64)VertexCount * sizeof *Vertices;
+
+    glBindVertexArray(OverlayVertexArrayId);
+    glBindBuffer(GL_ARRAY_BUFFER, OverlayBufferId);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)Size, Vertices, GL_STREAM_DRAW);
+    glUseProgram(OverlayProgramId);
+    glUniform2f(OverlayScreenSizeUniformId, (F32)RenderSettings.Width, (F32)RenderSettings.Height);
+
+    // Drawn over the scene with alpha blending, the pixel space flips the winding.
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)VertexCount);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
 
-    SDL_snprintf(Buffer, 1024, "%.3f", Time_GetFramesPerSecond());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(DefaultVertexArrayId);
 
-    Render_DrawText(Buffer);
+    RenderStats_Count(RENDER_COUNTER_DRAW_CALLS, 1);
+    RenderStats_Count(RENDER_COUNTER_TRIANGLES, VertexCount / 3);
+    RenderStats_Count(RENDER_COUNTER_BUFFER_BYTES, Size);
+    RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 11);
 }
 
-void Render_Tick() {
-    if (!bInitialized) {
+void Render_BuildScene(FRenderPacket* Packet) {
+    glm_mat4_mul(Projection, View, Packet->ViewProjection);
+    glm_vec3_copy(CameraPosition, Packet->CameraPosition);
+    Packet->bDrawScene = SDL_AtomicGet(&bChunkProgramReady) != 0;
+    if (!Packet->bDrawScene) {
         return;
     }
 
+    BuildingPacket = Packet;
+    Stream_Update(Stream, CameraPosition, CameraForward);
+    Raycast_Cast(Stream_GetWorld(Stream), CameraPosition, CameraForward, CameraReach, &CameraTarget);
+    Stream_VisitUploaded(Stream, Render_OnChunkVisited, Packet);
+}
+
+void Render_BuildHUD(FRenderPacket* Packet) {
+    FStreamStats StreamStats = {0};
+    if (Stream != NULL) {
+        Stream_GetStats(Stream, &StreamStats);
+    }
+
+    I32 Length = SDL_snprintf(Packet->Hud, RENDER_HUD_SIZE, "%.3f | chunks %u, queues %u/%u/%u, memory %llu/%llu MiB", Time_GetFramesPerSecond(),
+                              StreamStats.ResidentChunks, StreamStats.LoadQueueDepth, StreamStats.MeshQueueDepth, StreamStats.UploadQueueDepth,
+                              (unsigned long long)(StreamStats.MemoryUsed >> 20), (unsigned long long)(StreamStats.MemoryBudget >> 20));
+
+    FPaceStats PaceStats;
+    Pace_GetStats(&PaceStats);
+    if (Length > 0 && Length < RENDER_HUD_SIZE) {
+        Length += SDL_snprintf(Packet->Hud + Length, RENDER_HUD_SIZE - Length, " | frame %.2f/%.2f ms, work %.2f/%.2f ms, late %u%s",
+                               PaceStats.FrameMeanNanoseconds * 1e-6, PaceStats.FrameDeviationNanoseconds * 1e-6, PaceStats.WorkMeanNanoseconds * 1e-6,
+                               PaceStats.WorkDeviationNanoseconds * 1e-6, PaceStats.LateFrames, PaceStats.bIdle ? ", idle" : "");
+    }
+
+    if (CameraTarget.Type != BLOCK_TYPE_AIR && Length > 0 && Length < RENDER_HUD_SIZE) {
+        SDL_snprintf(Packet->Hud + Length, RENDER_HUD_SIZE - Length, " | target %d %d %d, face %d", CameraTarget.X, CameraTarget.Y, CameraTarget.Z,
+                     CameraTarget.Face);
+    }
+}
+
+int Render_RunThread(void* UserData) {
+    Render_MakeCurrent(True);
+
+    for (;;) {
+        const U64 WaitStart = Clock_GetNanoseconds();
+        SDL_SemWait(ReadyPackets);
+        RenderWaitNanoseconds = Clock_GetNanoseconds() - WaitStart;
+
+        FRenderPacket* Packet = &Packets[PacketTail % RENDER_PACKET_COUNT];
+        if (Packet->bQuit) {
+            break;
+        }
+
+        Render_Frame(Packet);
+        PacketTail++;
+        SDL_SemPost(FreePackets);
+    }
+
+    Render_MakeCurrent(False);
+    return 0;
+}
+
+void Render_Frame(FRenderPacket* Packet) {
+    // Asset reads finish here, their handlers create GL objects on the thread owning the context.
+    Watch_Update();
+    Io_Update(0);
+    Render_PollFrameFences();
+    Render_ResolvePassQueries();
+    Latency_AddEvents(Packet->EventTimestamps, (U32)FVector_GetSize(Packet->EventTimestamps));
+
+    Render_BeginPass(RENDER_PASS_SCENE);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glClearColor(COLOR_BYTE(10), COLOR_BYTE(9), COLOR_BYTE(80), COLOR_BYTE(255));
 
-    Render_Scene();
-    Render_HUD();
+    Render_RunCommands(Packet);
+
+    const U32 ChunkProgramId = ShaderPrograms[SHADER_PROGRAM_ID_CHUNK];
+    if (Packet->bDrawScene && ChunkProgramId != 0 && ChunkProgramId != InvalidId) {
+        glUseProgram(ChunkProgramId);
+        RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
 
-    SDL_GL_SwapWindow(pSDL_Window);
+        /** Send information to the shader program. */
+        glUniform3f(CameraUniformId, Packet->CameraPosition[0], Packet->CameraPosition[1], Packet->CameraPosition[2]);
+
+        /** Bind texture to the texture unit 0. */
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(RenderSettings.bMaterialArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, ChunkTextureId);
+        RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 2);
+
+        /** Set texture sampler to texture unit 0. */
+        glUniform1i(TextureUniformId, 0);
+
+        for (size_t Index = 0; Index < FVector_GetSize(Packet->Draws); Index++) {
+            Render_DrawChunk(&Packet->Draws[Index], Packet->ViewProjection);
+        }
+
+        glBindVertexArray(DefaultVertexArrayId);
+        RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
+    }
+    Render_EndPass();
+
+    // Headless frames have no HUD, its timings would change the pixels of every frame.
+    const FFontAtlas* FontAtlas = Font_GetAtlas();
+    if (!RenderSettings.bHeadless && FontAtlas != NULL) {
+        FLatencyStats LatencyStats;
+        Latency_GetStats(&LatencyStats);
+        const FLatencyDistribution* Swap = &LatencyStats.Stages[LATENCY_STAGE_SWAP];
+        const FLatencyDistribution* Complete = &LatencyStats.Stages[LATENCY_STAGE_COMPLETE];
+
+        char Buffer[RENDER_HUD_SIZE + 256];
+        I32 Length = SDL_snprintf(Buffer, sizeof Buffer, "%s | wait main %.2f ms, render %.2f ms | vsync %d, tears %u", Packet->Hud,
+                                  Packet->MainWaitNanoseconds * 1e-6, RenderWaitNanoseconds * 1e-6, SwapInterval, SwapControl.Tears);
+        if (Swap->Count > 0 && Length > 0 && Length < (I32)sizeof Buffer) {
+            SDL_snprintf(Buffer + Length, sizeof Buffer - Length, " | input latency p50/p99 swap %.1f/%.1f ms, gpu %.1f/%.1f ms", Swap->P50Nanoseconds * 1e-6,
+                         Swap->P99Nanoseconds * 1e-6, Complete->P50Nanoseconds * 1e-6, Complete->P99Nanoseconds * 1e-6);
+        }
+
+        // A shadow one pixel per 16 of size behind the line keeps it readable over bright terrain, in the same draw.
+        const F32 Size = RenderSettings.TextSize;
+        const F32 Shadow = Size > 16.f ? Size / 16.f : 1.f;
+        const F32 X = RENDER_TEXT_MARGIN;
+        const F32 Y = (F32)RenderSettings.Height - RENDER_TEXT_MARGIN - (FontAtlas->Ascent - FontAtlas->Descent) * Size;
+        Render_AddText(FontAtlas, X + Shadow, Y + Shadow, Size, Buffer, OVERLAY_COLOR(0, 0, 0, 200));
+        Render_AddText(FontAtlas, X, Y, Size, Buffer, OVERLAY_COLOR(255, 255, 255, 255));
+        Render_DrawText(FontAtlas);
+    }
+
+    if (Packet->bOverlay) {
+        Render_BeginPass(RENDER_PASS_OVERLAY);
+        Render_DrawOverlay();
+        Render_EndPass();
+    }
+
+    RenderedFrames++;
+
+    // Headless frames stay in the offscreen framebuffer, the readback takes the place of the swap.
+    if (RenderSettings.bHeadless) {
+        if (RenderSettings.bReadback) {
+            Render_ReadFrame();
+        }
+    } else {
+        SDL_GL_SwapWindow(pSDL_Window);
+    }
+    const U64 SwapTimestamp = Clock_GetNanoseconds();
+
+    RenderStats_EndFrame(LastSwapTimestamp != 0 ? SwapTimestamp - LastSwapTimestamp : 0);
+    LastSwapTimestamp = SwapTimestamp;
+
+    const I32 NextSwapInterval = RenderSettings.bHeadless ? SwapInterval : Pace_UpdateSwapControl(&SwapControl, SwapTimestamp);
+    if (NextSwapInterval != SwapInterval && SDL_GL_SetSwapInterval(NextSwapInterval) == 0) {
+        SwapInterval = NextSwapInterval;
+    }
+
+    // Input consumed by this frame is timed from here and again once the GPU finished the frame.
+    const U32 Frame = Latency_SubmitFrame(SwapTimestamp);
+    if (FrameFenceCount == LATENCY_MAX_FRAMES_IN_FLIGHT) {
+        glDeleteSync(FrameFences[FrameFenceHead]);
+        FrameFenceHead = (FrameFenceHead + 1) % LATENCY_MAX_FRAMES_IN_FLIGHT;
+        FrameFenceCount--;
+        RenderStats_AddObjects(RENDER_OBJECT_SYNC, -1);
+    }
+
+    const U32 Slot = (FrameFenceHead + FrameFenceCount) % LATENCY_MAX_FRAMES_IN_FLIGHT;
+    FrameFences[Slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    FrameFenceIds[Slot] = Frame;
+    FrameFenceCount++;
+    RenderStats_AddObjects(RENDER_OBJECT_SYNC, 1);
+    glFlush();
 }
-#pragma endregion
 
-#pragma region Private Function Definitions
-void Render_Cleanup() {
-    SDL_GL_DeleteContext(pSDL_GlContext);
+void Render_RunCommands(FRenderPacket* Packet) {
+    // Meshes are uploaded with the chunk program in use, Shape_Buffer sets its material uniforms.
+    const U32 ChunkProgramId = ShaderPrograms[SHADER_PROGRAM_ID_CHUNK];
+    if (ChunkProgramId != 0 && ChunkProgramId != InvalidId) {
+        glUseProgram(ChunkProgramId);
+        RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
+    }
 
-    // todo clean chunks
-    glDeleteVertexArrays(1, &DefaultVertexArrayId);
-    glBindVertexArray(0);
-    glDeleteProgram(ShaderPrograms[SHADER_PROGRAM_ID_FONT]);
-    glDeleteProgram(ShaderPrograms[SHADER_PROGRAM_ID_CHUNK]);
-    glDeleteTextures(1, &TextureUniformId);
+    for (size_t Index = 0; Index < FVector_GetSize(Packet->Commands); Index++) {
+        const FRenderCommand* Command = &Packet->Commands[Index];
+        FRenderChunk* RenderChunk = Command->Chunk;
+
+        if (Command->Type == RENDER_COMMAND_RELEASE) {
+            for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+                if (RenderChunk->VertexArrays[Section] != 0) {
+                    glDeleteVertexArrays(1, &RenderChunk->VertexArrays[Section]);
+                    glDeleteBuffers(5, RenderChunk->Buffers[Section]);
+                    RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, -1);
+                    RenderStats_AddObjects(RENDER_OBJECT_BUFFER, -5);
+                } else if (RenderChunk->Buffers[Section][0] != 0) {
+                    glDeleteBuffers(1, RenderChunk->Buffers[Section]);
+                    RenderStats_AddObjects(RENDER_OBJECT_BUFFER, -1);
+                }
+            }
+
+            free(RenderChunk);
+            continue;
+        }
+
+        const U32 Section = Command->Section;
+        const FShape* Shape = &Packet->Shapes[Command->Shape];
+        U32* Buffers = RenderChunk->Buffers[Section];
+        if (RenderSettings.bFacePulling) {
+            // Face records need no vertex array, the face shader reads them from the storage buffer.
+            if (Buffers[0] == 0) {
+                if (FVector_IsEmpty(Shape->Faces)) {
+                    continue;
+                }
+
+                glGenBuffers(1, Buffers);
+                RenderStats_AddObjects(RENDER_OBJECT_BUFFER, 1);
+            }
+
+            Shape_UpdateFaceBuffer(*Shape, Buffers[0]);
+            RenderChunk->IndexCounts[Section] = (U32)FVector_GetSize(Shape->Faces) * 6;
+            continue;
+        }
+
+        if (RenderChunk->VertexArrays[Section] == 0) {
+            if (Shape_GetIndexCount(Shape) == 0) {
+                continue;
+            }
+
+            glGenVertexArrays(1, &RenderChunk->VertexArrays[Section]);
+            glBindVertexArray(RenderChunk->VertexArrays[Section]);
+            glGenBuffers(5, Buffers);
+            RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, 1);
+            RenderStats_AddObjects(RENDER_OBJECT_BUFFER, 5);
+            Shape_Buffer(*Shape, &Buffers[0], &Buffers[1], &Buffers[2], &Buffers[3], &Buffers[4], ChunkProgramId);
+        } else {
+            // Emptied sections keep their buffers, edits often refill them.
+            glBindVertexArray(RenderChunk->VertexArrays[Section]);
+            Shape_UpdateBuffers(*Shape, Buffers[0], Buffers[1], Buffers[2], Buffers[3], Buffers[4]);
+        }
+
+        RenderChunk->IndexCounts[Section] = Shape_GetIndexCount(Shape);
+        RenderChunk->IndexTypes[Section] = Shape_GetIndexType(Shape);
+        RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
+    }
+
+    glBindVertexArray(DefaultVertexArrayId);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
+}
+
+U32 Render_CopyShape(FRenderPacket* Packet, const FShape* Shape) {
+    if (Packet->ShapeCount == FVector_GetSize(Packet->Shapes)) {
+        if (FVector_GetSize(Packet->Shapes) == FVector_GetCapacity(Packet->Shapes)) {
+            const size_t Capacity = FVector_GetCapacity(Packet->Shapes) * 2 + 16;
+            FVector_Reserve(Packet->Shapes, Capacity);
+        }
+        FVector_Add(Packet->Shapes, (FShape){0});
+    }
+
+    FShape* Copy = &Packet->Shapes[Packet->ShapeCount];
+    RENDER_COPY_VECTOR(Shape->Vertices, Copy->Vertices);
+    RENDER_COPY_VECTOR(Shape->Colors, Copy->Colors);
+    RENDER_COPY_VECTOR(Shape->TexCoords, Copy->TexCoords);
+    RENDER_COPY_VECTOR(Shape->Normals, Copy->Normals);
+    RENDER_COPY_VECTOR(Shape->Indices, Copy->Indices);
+    RENDER_COPY_VECTOR(Shape->Indices32, Copy->Indices32);
+    RENDER_COPY_VECTOR(Shape->Faces, Copy->Faces);
+
+    // Shapes with 32-bit indices are narrowed to 16-bit ones when their vertices fit, the triangle order is kept.
+    if (!FVector_IsEmpty(Copy->Indices32)) {
+        FShapeOptimizerSettings Settings;
+        ShapeOptimizer_GetDefaultSettings(&Settings);
+        Settings.bWeld = False;
+        Settings.bReorderTriangles = False;
+        Settings.bReorderVertices = False;
+        ShapeOptimizer_Optimize(Copy, &Settings, NULL);
+    }
+
+    return Packet->ShapeCount++;
+}
+
+void Render_CreateText() {
+    glGenVertexArrays(1, &TextVertexArrayId);
+    glGenBuffers(1, &TextBufferId);
+    glBindVertexArray(TextVertexArrayId);
+    glBindBuffer(GL_ARRAY_BUFFER, TextBufferId);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(FFontVertex), (const void*)offsetof(FFontVertex, X));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(FFontVertex), (const void*)offsetof(FFontVertex, U));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(FFontVertex), (const void*)offsetof(FFontVertex, Color));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats_AddObjects(RENDER_OBJECT_VERTEX_ARRAY, 1);
+    RenderStats_AddObjects(RENDER_OBJECT_BUFFER, 1);
+}
+
+void Render_AddText(const FFontAtlas* Atlas, const F32 X, const F32 Y, const F32 Size, const pStr Text, const U32 Color) {
+    const size_t Count = FVector_GetSize(TextVertices);
+    const size_t MaxCount = SDL_strlen(Text) * 6;
+    if (Count + MaxCount > FVector_GetCapacity(TextVertices)) {
+        const size_t Capacity = (Count + MaxCount) * 2 + 1024;
+        FVector_Reserve(TextVertices, Capacity);
+    }
+
+    const U32 Added = FontAtlas_LayoutText(Atlas, X, Y, Size, Text, Color, TextVertices + Count, (U32)MaxCount);
+    FVector_SetSize(TextVertices, Count + Added);
+}
+
+void Render_DrawText(const FFontAtlas* Atlas) {
+    const U32 FontProgramId = ShaderPrograms[SHADER_PROGRAM_ID_FONT];
+    const U32 VertexCount = (U32)FVector_GetSize(TextVertices);
+    FVector_Clear(TextVertices);
+    if (FontProgramId == 0 || FontProgramId == InvalidId || VertexCount == 0) {
+        return;
+    }
+
+    // Filtering interpolates the distances, the shader cuts them at the outline at whatever size the quads are.
+    if (FontTextureId == 0) {
+        glGenTextures(1, &FontTextureId);
+        glBindTexture(GL_TEXTURE_2D, FontTextureId);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, (GLsizei)Atlas->Width, (GLsizei)Atlas->Height, 0, GL_RED, GL_UNSIGNED_BYTE, Atlas->Pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, 1);
+        RenderStats_Count(RENDER_COUNTER_TEXTURE_BYTES, (U64)Atlas->Width * Atlas->Height);
+    }
+
+    const U64 Size = (U64)VertexCount * sizeof(FFontVertex);
+    glBindVertexArray(TextVertexArrayId);
+    glBindBuffer(GL_ARRAY_BUFFER, TextBufferId);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)Size, TextVertices, GL_STREAM_DRAW);
+    glUseProgram(FontProgramId);
+    glUniform2f(FontScreenSizeUniformId, (F32)RenderSettings.Width, (F32)RenderSettings.Height);
+    glUniform1i(FontTextureUniformId, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, FontTextureId);
+
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)VertexCount);
+    glDisable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(DefaultVertexArrayId);
+
+    RenderStats_Count(RENDER_COUNTER_DRAW_CALLS, 1);
+    RenderStats_Count(RENDER_COUNTER_TRIANGLES, VertexCount / 3);
+    RenderStats_Count(RENDER_COUNTER_BUFFER_BYTES, Size);
+    RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 13);
+}
+
+void Render_AddCommand(FRenderPacket* Packet, const FRenderCommand Command) {
+    if (FVector_GetSize(Packet->Commands) == FVector_GetCapacity(Packet->Commands)) {
+        const size_t Capacity = FVector_GetCapacity(Packet->Commands) * 2 + 64;
+        FVector_Reserve(Packet->Commands, Capacity);
+    }
+    FVector_Add(Packet->Commands, Command);
+}
+
+void Render_OnProgramLoaded(const U32 ProgramId, void* UserData) {
+    const FRenderProgramSource* Source = UserData;
+
+    if (ProgramId == InvalidId) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shaders %s, %s.", Source->VertexShaderPath, Source->FragmentShaderPath);
+        return;
+    }
+
+    // Frames only read ShaderPrograms between io updates on the render thread, so the swap is atomic for them.
+    const U32 PreviousProgramId = ShaderPrograms[Source->ProgramIndex];
+    ShaderPrograms[Source->ProgramIndex] = ProgramId;
+    if (PreviousProgramId != 0 && PreviousProgramId != InvalidId) {
+        glDeleteProgram(PreviousProgramId);
+        RenderStats_AddObjects(RENDER_OBJECT_PROGRAM, -1);
+    }
+
+    if (Source->ProgramIndex == SHADER_PROGRAM_ID_CHUNK) {
+        Render_LoadChunkUniforms(ProgramId);
+        SDL_AtomicSet(&bChunkProgramReady, 1);
+    } else if (Source->ProgramIndex == SHADER_PROGRAM_ID_OVERLAY) {
+        OverlayScreenSizeUniformId = glGetUniformLocation(ProgramId, OverlayScreenSizeUniformName);
+    } else if (Source->ProgramIndex == SHADER_PROGRAM_ID_FONT) {
+        FontScreenSizeUniformId = glGetUniformLocation(ProgramId, OverlayScreenSizeUniformName);
+        FontTextureUniformId = glGetUniformLocation(ProgramId, FontTextureUniformName);
+    }
+}
+
+const FRenderProgramSource* Render_GetProgramSource(const U32 Index) {
+    const FRenderProgramSource* Source = &ProgramSources[Index];
+    if (Source->ProgramIndex == SHADER_PROGRAM_ID_CHUNK && RenderSettings.bFacePulling) {
+        return &ChunkFaceProgramSource;
+    }
+
+    return Source;
+}
+
+Bool Render_LoadProgram(const FRenderProgramSource* Source) {
+    if (Source->ProgramIndex == SHADER_PROGRAM_ID_CHUNK) {
+        return Shader_LoadProgramVariantAsync(Source->VertexShaderPath, Source->FragmentShaderPath, StrEmpty, (const pStr*)ChunkDefines, ChunkDefineCount,
+                                              Render_OnProgramLoaded, (void*)Source);
+    }
+
+    return Shader_LoadProgramAsync(Source->VertexShaderPath, Source->FragmentShaderPath, StrEmpty, Render_OnProgramLoaded, (void*)Source);
+}
+
+void Render_LoadChunkTexture(const pStr Path) {
+    if (RenderSettings.bMaterialArray) {
+        Texture_LoadDDSArrayAsync(Path, CHUNK_ATLAS_COLUMNS, CHUNK_ATLAS_ROWS, Render_OnChunkTextureLoaded, NULL);
+    } else {
+        Texture_LoadDDSAsync(Path, Render_OnChunkTextureLoaded, NULL);
+    }
+}
+
+void Render_LoadChunkUniforms(const U32 ProgramId) {
+    glUseProgram(ProgramId);
+    RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
+
+    ModelMatrixUniformId = glGetUniformLocation(ProgramId, ModelMatrixUniformName);
+    if (ModelMatrixUniformId == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", ModelMatrixUniformName);
+    }
+
+    TransformMatrixUniformId = glGetUniformLocation(ProgramId, TransformMatrixUniformName);
+    if (TransformMatrixUniformId == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", TransformMatrixUniformName);
+    }
+
+    CameraUniformId = glGetUniformLocation(ProgramId, CameraPositionUniformName);
+    if (CameraUniformId == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", CameraPositionUniformName);
+    }
+
+    TextureUniformId = glGetUniformLocation(ProgramId, TextureUniformName);
+    if (TextureUniformId == -1) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", TextureUniformName);
+    }
+
+    if (RenderSettings.bFacePulling) {
+        SectionOriginUniformId = glGetUniformLocation(ProgramId, SectionOriginUniformName);
+        if (SectionOriginUniformId == -1) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load uniform by name: %s", SectionOriginUniformName);
+        }
+
+        // Face records carry palette indices, the colors and curves stay with the mesher.
+        FMesherFacePalette Palette;
+        Mesher_GetFacePalette(&Palette);
+        glUniform3fv(glGetUniformLocation(ProgramId, "blockColors"), BLOCK_TYPE_COUNT, Palette.Colors[0]);
+        glUniform1fv(glGetUniformLocation(ProgramId, "blockMaterials"), BLOCK_TYPE_COUNT, Palette.Materials);
+        glUniform1fv(glGetUniformLocation(ProgramId, "lightCurve"), BLOCK_LIGHT_MAX + 1, Palette.LightCurve);
+        glUniform1fv(glGetUniformLocation(ProgramId, "occlusionCurve"), 4, Palette.OcclusionCurve);
+    }
+}
+
+void Render_OnChunkTextureLoaded(const U32 TextureId, void* UserData) {
+    if (TextureId == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load texture %s.", ChunkTexturePath);
+        return;
+    }
+
+    const GLuint PreviousTextureId = ChunkTextureId;
+    ChunkTextureId = TextureId;
+    if (PreviousTextureId != 0) {
+        glDeleteTextures(1, &PreviousTextureId);
+        RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, -1);
+    }
+}
+
+void Render_OnShaderChanged(const pStr Path, void* UserData) {
+    for (U32 Index = 0; Index < PROGRAM_SOURCE_COUNT; Index++) {
+        const FRenderProgramSource* Source = Render_GetProgramSource(Index);
+        if (SDL_strcmp(Source->VertexShaderPath, Path) == 0 || SDL_strcmp(Source->FragmentShaderPath, Path) == 0) {
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Reloading shaders %s, %s", Source->VertexShaderPath, Source->FragmentShaderPath);
+            Render_LoadProgram(Source);
+        }
+    }
+}
+
+void Render_OnTextureChanged(const pStr Path, void* UserData) {
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Reloading texture %s", Path);
+    Render_LoadChunkTexture(Path);
+}
+
+void* Render_OnChunkUpload(const FChunk* Chunk, const FShape Shapes[CHUNK_SECTION_COUNT], U64* OutSize, void* UserData) {
+    FRenderChunk* RenderChunk = calloc(1, sizeof *RenderChunk);
+    if (RenderChunk == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate chunk %d %d %d buffers.", Chunk->X, Chunk->Y, Chunk->Z);
+        return NULL;
+    }
+
+    // The buffers are created by the render thread, sizes are counted here for the stream memory budget.
+    U64 Size = 0;
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        if (Shape_IsEmpty(&Shapes[Section])) {
+            continue;
+        }
+
+        const U32 Shape = Render_CopyShape(BuildingPacket, &Shapes[Section]);
+        Render_AddCommand(BuildingPacket, (FRenderCommand){RENDER_COMMAND_UPLOAD_SECTION, RenderChunk, Section, Shape});
+        RenderChunk->SectionSizes[Section] = Shape_GetSize(&BuildingPacket->Shapes[Shape]);
+        Size += RenderChunk->SectionSizes[Section];
+    }
+
+    *OutSize = Size;
+    return RenderChunk;
+}
+
+void Render_OnChunkSectionUpload(const FChunk* Chunk, const U32 Section, const FShape* Shape, void* RenderData, U64* InOutSize, void* UserData) {
+    FRenderChunk* RenderChunk = RenderData;
+    if (RenderChunk == NULL) {
+        return;
+    }
+
+    const U32 ShapeIndex = Render_CopyShape(BuildingPacket, Shape);
+    Render_AddCommand(BuildingPacket, (FRenderCommand){RENDER_COMMAND_UPLOAD_SECTION, RenderChunk, Section, ShapeIndex});
+
+    const U64 Size = Shape_GetSize(&BuildingPacket->Shapes[ShapeIndex]);
+    *InOutSize = *InOutSize - RenderChunk->SectionSizes[Section] + Size;
+    RenderChunk->SectionSizes[Section] = Size;
+}
+
+void Render_OnChunkRelease(const FChunk* Chunk, void* RenderData, void* UserData) {
+    if (RenderData != NULL) {
+        Render_AddCommand(BuildingPacket, (FRenderCommand){RENDER_COMMAND_RELEASE, RenderData, 0, InvalidId});
+    }
+}
+
+void Render_OnChunkVisited(const FChunk* Chunk, void* RenderData, void* UserData) {
+    FRenderPacket* Packet = UserData;
+    if (RenderData == NULL) {
+        return;
+    }
+
+    if (FVector_GetSize(Packet->Draws) == FVector_GetCapacity(Packet->Draws)) {
+        const size_t Capacity = FVector_GetCapacity(Packet->Draws) * 2 + 64;
+        FVector_Reserve(Packet->Draws, Capacity);
+    }
+
+    const FRenderDraw Draw = {RenderData, Chunk->X * CHUNK_SIZE, Chunk->Y * CHUNK_SIZE, Chunk->Z * CHUNK_SIZE};
+    FVector_Add(Packet->Draws, Draw);
+}
+
+void Render_DrawChunk(const FRenderDraw* Draw, vec4* ViewProjection) {
+    const FRenderChunk* RenderChunk = Draw->Chunk;
+
+    mat4 Model;
+    glm_translate_make(Model, (vec3){(F32)Draw->X, (F32)Draw->Y, (F32)Draw->Z});
+    mat4 Transform;
+    glm_mat4_mul(ViewProjection, Model, Transform);
+
+    glUniformMatrix4fv(ModelMatrixUniformId, 1, GL_FALSE, Model[0]);
+    glUniformMatrix4fv(TransformMatrixUniformId, 1, GL_FALSE, Transform[0]);
+
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        if (RenderChunk->IndexCounts[Section] == 0) {
+            continue;
+        }
+
+        if (RenderSettings.bFacePulling) {
+            I32 OriginX, OriginY, OriginZ;
+            Mesher_GetSectionOrigin(Section, &OriginX, &OriginY, &OriginZ);
+            glUniform3f(SectionOriginUniformId, (F32)OriginX, (F32)OriginY, (F32)OriginZ);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, RenderChunk->Buffers[Section][0]);
+            glDrawArrays(GL_TRIANGLES, 0, (GLsizei)RenderChunk->IndexCounts[Section]);
+        } else {
+            glBindVertexArray(RenderChunk->VertexArrays[Section]);
+            glDrawElements(GL_TRIANGLES, (GLsizei)RenderChunk->IndexCounts[Section], RenderChunk->IndexTypes[Section], NULL);
+        }
+        RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
+        RenderStats_Count(RENDER_COUNTER_DRAW_CALLS, 1);
+        RenderStats_Count(RENDER_COUNTER_TRIANGLES, RenderChunk->IndexCounts[Section] / 3);
+    }
 }
 #pragma endregion
@@ -1,20 +1,79 @@
-#pragma once
-#include <SDL_ttf.h>
+﻿#pragma once
 #include <SDL_video.h>
 #include "typedefs.h"
 
-/** Initializes the render service. Loads and compiles shaders, loads textures, initializes camera and matrices, creates vertex arrays. */
-void Render_Initialize();
+/** Optional features of the chunk fragment shader, each compiled into the chunk program through a define. */
+typedef enum {
+    /** Modulates the block color by its material texture, the only texture fetch of the shader. */
+    RENDER_CHUNK_DETAIL = 1 << 0,
+    /** Fades distant faces into the clear color. */
+    RENDER_CHUNK_FOG = 1 << 1,
+    /** Blends the material into the materials across the face edges, two more texture fetches. Needs the detail. */
+    RENDER_CHUNK_SMUDGE = 1 << 2,
+    /** Looks up the reflective material along the view direction and makes the polished one glint. Needs the detail. */
+    RENDER_CHUNK_RIM = 1 << 3,
+} ERenderChunkFeature;
 
-/** Updates the render service frame. */
-void Render_Tick();
+typedef struct {
+    /** World seed of the streamed chunks. */
+    U32 Seed;
+    /** Renders into an offscreen framebuffer of an EGL context instead of a window, nothing is presented. */
+    Bool bHeadless;
+    /** Reads back each headless frame for Render_GetReadback, stalling until the GPU finished it. */
+    Bool bReadback;
+    /** Size of the window or of the offscreen framebuffer. */
+    I32 Width;
+    I32 Height;
+    /** Samples chunk materials from a texture array sliced out of the atlas, from the atlas tiles otherwise. */
+    Bool bMaterialArray;
+    /** Chunk shader features, see ERenderChunkFeature. */
+    U32 ChunkFeatures;
+    /** Draws chunks from 32-bit face records in storage buffers expanded by the vertex shader, instead of indexed meshes. */
+    Bool bFacePulling;
+    /** Pixels per em of the HUD text, any size is drawn from the one distance field atlas of the font. */
+    F32 TextSize;
+    /** Renders each frame packet on the main thread instead of a render thread owning the GL context, for debugging. */
+    Bool bSingleThread;
+} FRenderSettings;
+
+/** Frame read back in headless mode. */
+typedef struct {
+    /** Frames rendered up to this one, 0 before the first read back. */
+    U64 Frame;
+    U32 Width;
+    U32 Height;
+    /** Hash of the RGBA pixels, see Hash_Compute. */
+    U64 Checksum;
+} FRenderReadback;
+
+void Render_GetDefaultSettings(FRenderSettings* OutSettings);
+
+/**
+ * Initializes the render service. Loads and compiles shaders, loads textures, initializes camera and matrices, creates
+ * vertex arrays. Streams the world generated from the seed.
+ */
+void Render_Initialize(const FRenderSettings* Settings);
+
+/**
+ * Builds the frame packet, streaming chunks around the camera, and hands it to the render thread, waiting while all
+ * packets are in use. Takes the receive times of the input events the frame consumed.
+ */
+void Render_Tick(const U64* EventTimestamps, U32 EventCount);
 
 /** Clears the initialized buffers, shaders, textures and frees memory. */
 void Render_Shutdown();
 
-/** SDL window getter. */
+/** SDL window getter, NULL in headless mode. */
 SDL_Window* Render_GetSDLWindow();
 
-void Render_DrawText(pStr Text);
+/**
+ * Returns the last frame read back, False if none was. Copies its RGBA pixels, bottom row first, when the pixels aren't
+ * NULL, Width * Height * 4 bytes. Pixels are kept until Render_Shutdown, the readback itself after it.
+ */
+Bool Render_GetReadback(FRenderReadback* OutReadback, Byte* OutPixels);
+
+/** Returns the refresh period of the display showing the window, 0 when unknown. */
+U64 Render_GetRefreshNanoseconds();
 
-SDL_Texture* Render_RenderTextToTexture(pStr Text, SDL_Color Color, I32 X, I32 Y, TTF_Font* Font);
\ No newline at end of file
+/** Shows or hides the overlay of the render stats, from the next frame packet on. */
+void Render_ToggleOverlay();
\ No newline at end of file
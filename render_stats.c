@@ -0,0 +1,80 @@
+#include "render_stats.h"
+
+#include <string.h>
+
+#pragma region Private Variables
+/** Counters of the frame being rendered and of the last one ended. */
+static U64 RenderStatsCounters[RENDER_COUNTER_COUNT];
+static U64 RenderStatsLastCounters[RENDER_COUNTER_COUNT];
+static U64 RenderStatsFrames = 0;
+
+static I64 RenderStatsObjects[RENDER_OBJECT_COUNT];
+
+static U64 RenderStatsPassFrame = 0;
+static U64 RenderStatsPassTimes[RENDER_PASS_COUNT];
+
+/** Ring of frame times, the next one goes to RenderStatsHistoryHead. */
+static F32 RenderStatsHistory[RENDER_STATS_HISTORY];
+static U32 RenderStatsHistoryHead = 0;
+static U32 RenderStatsHistoryCount = 0;
+#pragma endregion
+
+#pragma region Public Function Definitions
+void RenderStats_Reset() {
+    memset(RenderStatsCounters, 0, sizeof RenderStatsCounters);
+    memset(RenderStatsLastCounters, 0, sizeof RenderStatsLastCounters);
+    memset(RenderStatsObjects, 0, sizeof RenderStatsObjects);
+    memset(RenderStatsPassTimes, 0, sizeof RenderStatsPassTimes);
+    RenderStatsFrames = 0;
+    RenderStatsPassFrame = 0;
+    RenderStatsHistoryHead = 0;
+    RenderStatsHistoryCount = 0;
+}
+
+void RenderStats_Count(const ERenderCounter Counter, const U64 Amount) {
+    RenderStatsCounters[Counter] += Amount;
+}
+
+void RenderStats_AddObjects(const ERenderObject Object, const I32 Count) {
+    RenderStatsObjects[Object] += Count;
+}
+
+U64 RenderStats_GetFrame() {
+    return RenderStatsFrames + 1;
+}
+
+void RenderStats_EndFrame(const U64 FrameNanoseconds) {
+    memcpy(RenderStatsLastCounters, RenderStatsCounters, sizeof RenderStatsLastCounters);
+    memset(RenderStatsCounters, 0, sizeof RenderStatsCounters);
+    RenderStatsFrames++;
+
+    RenderStatsHistory[RenderStatsHistoryHead] = (F32)((F64)FrameNanoseconds * 1e-6);
+    RenderStatsHistoryHead = (RenderStatsHistoryHead + 1) % RENDER_STATS_HISTORY;
+    if (RenderStatsHistoryCount < RENDER_STATS_HISTORY) {
+        RenderStatsHistoryCount++;
+    }
+}
+
+void RenderStats_SetPassTime(const U64 Frame, const ERenderPass Pass, const U64 Nanoseconds) {
+    // Passes of a frame are read together, a newer frame starts over.
+    if (Frame != RenderStatsPassFrame) {
+        memset(RenderStatsPassTimes, 0, sizeof RenderStatsPassTimes);
+        RenderStatsPassFrame = Frame;
+    }
+    RenderStatsPassTimes[Pass] = Nanoseconds;
+}
+
+void RenderStats_Get(FRenderStats* OutStats) {
+    OutStats->Frames = RenderStatsFrames;
+    memcpy(OutStats->Counters, RenderStatsLastCounters, sizeof OutStats->Counters);
+    memcpy(OutStats->Objects, RenderStatsObjects, sizeof OutStats->Objects);
+    OutStats->PassFrame = RenderStatsPassFrame;
+    memcpy(OutStats->PassNanoseconds, RenderStatsPassTimes, sizeof OutStats->PassNanoseconds);
+
+    OutStats->HistoryCount = RenderStatsHistoryCount;
+    const U32 First = (RenderStatsHistoryHead + RENDER_STATS_HISTORY - RenderStatsHistoryCount) % RENDER_STATS_HISTORY;
+    for (U32 Index = 0; Index < RenderStatsHistoryCount; Index++) {
+        OutStats->FrameMilliseconds[Index] = RenderStatsHistory[(First + Index) % RENDER_STATS_HISTORY];
+    }
+}
+#pragma endregion
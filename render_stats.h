@@ -0,0 +1,74 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Counters of the GL work of each frame, kept by the thread owning the GL context. Counts go to the frame being
+ * rendered and are published when it ends. GPU pass times come from timer queries read a few frames later, so they
+ * are tagged with the frame they measured.
+ */
+/** Frame times kept for the frame time graph. */
+#define RENDER_STATS_HISTORY 240
+
+typedef enum {
+    RENDER_COUNTER_DRAW_CALLS = 0,
+    RENDER_COUNTER_TRIANGLES,
+    /** Binds of vertex arrays, buffers, textures and framebuffers and other state changes, programs are counted apart. */
+    RENDER_COUNTER_STATE_CHANGES,
+    /** Bytes uploaded to buffers and to textures. */
+    RENDER_COUNTER_BUFFER_BYTES,
+    RENDER_COUNTER_TEXTURE_BYTES,
+    RENDER_COUNTER_PROGRAM_BINDS,
+    RENDER_COUNTER_COUNT
+} ERenderCounter;
+
+typedef enum {
+    RENDER_OBJECT_BUFFER = 0,
+    RENDER_OBJECT_VERTEX_ARRAY,
+    RENDER_OBJECT_TEXTURE,
+    RENDER_OBJECT_PROGRAM,
+    /** Framebuffers and renderbuffers. */
+    RENDER_OBJECT_FRAMEBUFFER,
+    RENDER_OBJECT_QUERY,
+    RENDER_OBJECT_SYNC,
+    RENDER_OBJECT_COUNT
+} ERenderObject;
+
+typedef enum {
+    RENDER_PASS_SCENE = 0,
+    RENDER_PASS_OVERLAY,
+    RENDER_PASS_COUNT
+} ERenderPass;
+
+typedef struct {
+    /** Frames ended so far, the counters are the ones of the last. */
+    U64 Frames;
+    U64 Counters[RENDER_COUNTER_COUNT];
+    /** GL objects alive now. */
+    I64 Objects[RENDER_OBJECT_COUNT];
+    /** GPU times of the passes of the last frame measured, 0 before the first. */
+    U64 PassFrame;
+    U64 PassNanoseconds[RENDER_PASS_COUNT];
+    /** Times between the ends of the last frames, oldest first. */
+    U32 HistoryCount;
+    F32 FrameMilliseconds[RENDER_STATS_HISTORY];
+} FRenderStats;
+
+/** Clears the counters, the history and the objects alive. */
+void RenderStats_Reset();
+
+/** Adds to a counter of the frame being rendered. */
+void RenderStats_Count(ERenderCounter Counter, U64 Amount);
+
+/** Adds created GL objects, or removes deleted ones with a negative count. */
+void RenderStats_AddObjects(ERenderObject Object, I32 Count);
+
+/** Returns the number of the frame being rendered, for tagging its timer queries. Frames are numbered from 1. */
+U64 RenderStats_GetFrame();
+
+/** Ends the frame being rendered, publishing its counters and the time since the previous frame ended. */
+void RenderStats_EndFrame(U64 FrameNanoseconds);
+
+/** Sets the GPU time of a pass of a past frame once its query was read. */
+void RenderStats_SetPassTime(U64 Frame, ERenderPass Pass, U64 Nanoseconds);
+
+void RenderStats_Get(FRenderStats* OutStats);
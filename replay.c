@@ -0,0 +1,308 @@
+#include "replay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+#include "file.h"
+
+#pragma region Settings
+/** Bytes buffered by a recording before they are written. */
+#define REPLAY_BUFFER_SIZE 65536
+/** Longest varint of a 64-bit value. */
+#define REPLAY_MAX_VARINT_SIZE 10
+/** Longest record, the type and three varints of 32-bit values or the timestamp. */
+#define REPLAY_MAX_RECORD_SIZE (1 + REPLAY_MAX_VARINT_SIZE * 4)
+#pragma endregion
+
+struct FReplay {
+    /** Recorded log, NULL when replaying. */
+    FILE* File;
+    /** Recorded bytes not written yet, or the whole log when replaying. */
+    Byte* Data;
+    size_t Size;
+    size_t Offset;
+    U32 Seed;
+    /** Microseconds of the previous record, from the first record when replaying. */
+    U64 LastTimestamp;
+    Bool bStarted;
+
+    /** Timestamp of the last frame record read, the times the replay spent in the frames and the replay time at the last. */
+    U64 LastFrameTimestamp;
+    FVector(U64) FrameTimes;
+    U64 ReplayNanoseconds;
+};
+
+#pragma region Private Function Declarations
+static size_t Replay_PutVarint(Byte* Buffer, U64 Value);
+
+/** Reads a varint at the offset, returns False if the data ends first. */
+static Bool Replay_GetVarint(FReplay* Replay, U64* OutValue);
+
+/** Maps signed values to small varints, zig-zagging around zero. */
+static U64 Replay_Encode(I32 Value);
+static I32 Replay_Decode(U64 Value);
+
+static Bool Replay_Flush(FReplay* Replay);
+
+static int Replay_CompareTimes(const void* A, const void* B);
+#pragma endregion
+
+#pragma region Public Function Definitions
+FReplay* Replay_Create(const pStr Path, const U32 Seed) {
+    FILE* File = fopen(Path, "wb");
+    if (File == NULL) {
+        return NULL;
+    }
+
+    FReplay* Replay = calloc(1, sizeof *Replay);
+    Replay->File = File;
+    Replay->Data = malloc(REPLAY_BUFFER_SIZE);
+    Replay->Seed = Seed;
+
+    const U32 Magic = REPLAY_MAGIC;
+    const Byte Header[4] = {(Byte)Magic, (Byte)(Magic >> 8), (Byte)(Magic >> 16), (Byte)(Magic >> 24)};
+    memcpy(Replay->Data, Header, sizeof Header);
+    Replay->Size = sizeof Header;
+    Replay->Size += Replay_PutVarint(Replay->Data + Replay->Size, REPLAY_VERSION);
+    Replay->Size += Replay_PutVarint(Replay->Data + Replay->Size, Seed);
+
+    return Replay;
+}
+
+FReplay* Replay_Open(const pStr Path) {
+    const I64 Size = File_GetSize(Path);
+    if (Size < 4) {
+        return NULL;
+    }
+
+    FILE* File = fopen(Path, "rb");
+    if (File == NULL) {
+        return NULL;
+    }
+
+    FReplay* Replay = calloc(1, sizeof *Replay);
+    Replay->Data = malloc((size_t)Size);
+    Replay->Size = (size_t)Size;
+    const Bool bRead = fread(Replay->Data, 1, Replay->Size, File) == Replay->Size;
+    fclose(File);
+
+    const Byte* Header = Replay->Data;
+    const U32 Magic = (U32)Header[0] | (U32)Header[1] << 8 | (U32)Header[2] << 16 | (U32)Header[3] << 24;
+    Replay->Offset = 4;
+
+    U64 Version = 0;
+    U64 Seed = 0;
+    if (!bRead || Magic != REPLAY_MAGIC || !Replay_GetVarint(Replay, &Version) || Version != REPLAY_VERSION || !Replay_GetVarint(Replay, &Seed)) {
+        Replay_Close(Replay);
+        return NULL;
+    }
+
+    Replay->Seed = (U32)Seed;
+
+    return Replay;
+}
+
+void Replay_Close(FReplay* Replay) {
+    if (Replay == NULL) {
+        return;
+    }
+
+    if (Replay->File != NULL) {
+        Replay_Flush(Replay);
+        fclose(Replay->File);
+    }
+
+    FVector_Free(Replay->FrameTimes);
+    free(Replay->Data);
+    free(Replay);
+}
+
+U32 Replay_GetSeed(const FReplay* Replay) {
+    return Replay->Seed;
+}
+
+Bool Replay_Write(FReplay* Replay, const FReplayRecord* Record) {
+    if (Replay->Size + REPLAY_MAX_RECORD_SIZE > REPLAY_BUFFER_SIZE && !Replay_Flush(Replay)) {
+        return False;
+    }
+
+    const U64 Timestamp = Record->Timestamp / 1000;
+    if (!Replay->bStarted) {
+        Replay->LastTimestamp = Timestamp;
+        Replay->bStarted = True;
+    }
+
+    Byte* Buffer = Replay->Data + Replay->Size;
+    size_t Size = 0;
+    Buffer[Size++] = (Byte)Record->Type;
+    Size += Replay_PutVarint(Buffer + Size, Timestamp > Replay->LastTimestamp ? Timestamp - Replay->LastTimestamp : 0);
+    Replay->LastTimestamp = Timestamp > Replay->LastTimestamp ? Timestamp : Replay->LastTimestamp;
+
+    switch (Record->Type) {
+    case REPLAY_RECORD_FRAME:
+        Size += Replay_PutVarint(Buffer + Size, Record->DeltaTime);
+        break;
+
+    case REPLAY_RECORD_KEY_DOWN:
+    case REPLAY_RECORD_KEY_UP:
+        Size += Replay_PutVarint(Buffer + Size, Record->Key);
+        break;
+
+    case REPLAY_RECORD_MOUSE_MOTION:
+        Size += Replay_PutVarint(Buffer + Size, Replay_Encode(Record->X));
+        Size += Replay_PutVarint(Buffer + Size, Replay_Encode(Record->Y));
+        break;
+
+    default:
+        return False;
+    }
+
+    Replay->Size += Size;
+
+    return True;
+}
+
+Bool Replay_Read(FReplay* Replay, FReplayRecord* OutRecord) {
+    if (Replay->File != NULL || Replay->Offset >= Replay->Size) {
+        return False;
+    }
+
+    memset(OutRecord, 0, sizeof *OutRecord);
+    OutRecord->Type = (EReplayRecordType)Replay->Data[Replay->Offset++];
+
+    U64 Delta = 0;
+    if (!Replay_GetVarint(Replay, &Delta)) {
+        return False;
+    }
+    Replay->LastTimestamp += Delta;
+    OutRecord->Timestamp = Replay->LastTimestamp * 1000;
+
+    U64 First = 0;
+    U64 Second = 0;
+    switch (OutRecord->Type) {
+    case REPLAY_RECORD_FRAME:
+        if (!Replay_GetVarint(Replay, &First)) {
+            return False;
+        }
+        OutRecord->DeltaTime = (U32)First;
+        Replay->LastFrameTimestamp = OutRecord->Timestamp;
+        return True;
+
+    case REPLAY_RECORD_KEY_DOWN:
+    case REPLAY_RECORD_KEY_UP:
+        if (!Replay_GetVarint(Replay, &First)) {
+            return False;
+        }
+        OutRecord->Key = (U32)First;
+        return True;
+
+    case REPLAY_RECORD_MOUSE_MOTION:
+        if (!Replay_GetVarint(Replay, &First) || !Replay_GetVarint(Replay, &Second)) {
+            return False;
+        }
+        OutRecord->X = Replay_Decode(First);
+        OutRecord->Y = Replay_Decode(Second);
+        return True;
+
+    default:
+        // Unknown records can't be skipped, their size is unknown.
+        Replay->Offset = Replay->Size;
+        return False;
+    }
+}
+
+void Replay_AddFrame(FReplay* Replay, const U64 FrameNanoseconds, const U64 ReplayNanoseconds) {
+    if (FVector_GetSize(Replay->FrameTimes) == FVector_GetCapacity(Replay->FrameTimes)) {
+        const size_t Capacity = FVector_GetCapacity(Replay->FrameTimes) * 2 + 64;
+        FVector_Reserve(Replay->FrameTimes, Capacity);
+    }
+    FVector_Add(Replay->FrameTimes, FrameNanoseconds);
+    Replay->ReplayNanoseconds = ReplayNanoseconds;
+}
+
+void Replay_GetStats(FReplay* Replay, FReplayStats* OutStats) {
+    memset(OutStats, 0, sizeof *OutStats);
+
+    const U32 Count = (U32)FVector_GetSize(Replay->FrameTimes);
+    if (Count == 0) {
+        return;
+    }
+
+    U64* Times = Replay->FrameTimes;
+    qsort(Times, Count, sizeof *Times, Replay_CompareTimes);
+
+    F64 Sum = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        Sum += (F64)Times[Index];
+    }
+
+    F64 Variance = 0.0;
+    for (U32 Index = 0; Index < Count; Index++) {
+        const F64 Delta = (F64)Times[Index] - Sum / Count;
+        Variance += Delta * Delta;
+    }
+
+    OutStats->Frames = Count;
+    OutStats->RecordedNanoseconds = Replay->LastFrameTimestamp;
+    OutStats->ReplayNanoseconds = Replay->ReplayNanoseconds;
+    OutStats->MinNanoseconds = Times[0];
+    OutStats->MeanNanoseconds = Sum / Count;
+    OutStats->DeviationNanoseconds = Count > 1 ? sqrt(Variance / (Count - 1)) : 0.0;
+    OutStats->P50Nanoseconds = Times[(Count - 1) * 50 / 100];
+    OutStats->P90Nanoseconds = Times[(Count - 1) * 90 / 100];
+    OutStats->P99Nanoseconds = Times[(Count - 1) * 99 / 100];
+    OutStats->MaxNanoseconds = Times[Count - 1];
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+size_t Replay_PutVarint(Byte* Buffer, U64 Value) {
+    size_t Size = 0;
+    while (Value >= 0x80) {
+        Buffer[Size++] = (Byte)(Value | 0x80);
+        Value >>= 7;
+    }
+    Buffer[Size++] = (Byte)Value;
+
+    return Size;
+}
+
+Bool Replay_GetVarint(FReplay* Replay, U64* OutValue) {
+    U64 Value = 0;
+    for (U32 Shift = 0; Shift < 64 && Replay->Offset < Replay->Size; Shift += 7) {
+        const Byte Part = Replay->Data[Replay->Offset++];
+        Value |= (U64)(Part & 0x7F) << Shift;
+        if ((Part & 0x80) == 0) {
+            *OutValue = Value;
+            return True;
+        }
+    }
+
+    Replay->Offset = Replay->Size;
+    return False;
+}
+
+U64 Replay_Encode(const I32 Value) {
+    return (U64)(((U32)Value << 1) ^ (U32)(Value >> 31));
+}
+
+I32 Replay_Decode(const U64 Value) {
+    return (I32)((U32)(Value >> 1) ^ (U32)-(I32)(Value & 1));
+}
+
+Bool Replay_Flush(FReplay* Replay) {
+    const Bool bWritten = fwrite(Replay->Data, 1, Replay->Size, Replay->File) == Replay->Size;
+    Replay->Size = 0;
+
+    return bWritten;
+}
+
+int Replay_CompareTimes(const void* A, const void* B) {
+    const U64 TimeA = *(const U64*)A;
+    const U64 TimeB = *(const U64*)B;
+    return TimeA < TimeB ? -1 : TimeA > TimeB ? 1 : 0;
+}
+#pragma endregion
@@ -0,0 +1,75 @@
+#pragma once
+#include "typedefs.h"
+
+/**
+ * Input and frame log of a session, replayed to reproduce it. The log starts with the world seed, then has the input
+ * events in the order they were received and a frame record after the events each frame consumed. Records are a type
+ * byte followed by varints, the timestamp as the delta from the previous record in microseconds, so a frame with a few
+ * events takes a handful of bytes.
+ */
+/** "SQRP" in little-endian. */
+#define REPLAY_MAGIC 0x50525153
+#define REPLAY_VERSION 1
+
+typedef enum {
+    /** End of the frame consuming the events before it, with the frame delta. */
+    REPLAY_RECORD_FRAME = 0,
+    /** Key index of a scancode or a mouse button, see Input_GetMouseButtonKey. */
+    REPLAY_RECORD_KEY_DOWN,
+    REPLAY_RECORD_KEY_UP,
+    /** Relative mouse motion. */
+    REPLAY_RECORD_MOUSE_MOTION,
+    REPLAY_RECORD_COUNT
+} EReplayRecordType;
+
+typedef struct {
+    EReplayRecordType Type;
+    /** Nanoseconds, read back as the time from the first record in microsecond steps. */
+    U64 Timestamp;
+    U32 Key;
+    I32 X;
+    I32 Y;
+    /** Frame delta in milliseconds. */
+    U32 DeltaTime;
+} FReplayRecord;
+
+typedef struct {
+    U32 Frames;
+    /** Duration of the frames when recorded and when replayed. */
+    U64 RecordedNanoseconds;
+    U64 ReplayNanoseconds;
+    /** Time spent in the replayed frames. */
+    U64 MinNanoseconds;
+    F64 MeanNanoseconds;
+    F64 DeviationNanoseconds;
+    U64 P50Nanoseconds;
+    U64 P90Nanoseconds;
+    U64 P99Nanoseconds;
+    U64 MaxNanoseconds;
+} FReplayStats;
+
+/** Log opened for recording or replay. */
+typedef struct FReplay FReplay;
+
+/** Creates the log for recording the session of the world seed. Returns NULL on failure. */
+FReplay* Replay_Create(pStr Path, U32 Seed);
+
+/** Opens the log for replay, reading it whole. Returns NULL on failure or if the file is not a log of this version. */
+FReplay* Replay_Open(pStr Path);
+
+/** Flushes a recorded log and closes it. */
+void Replay_Close(FReplay* Replay);
+
+U32 Replay_GetSeed(const FReplay* Replay);
+
+/** Appends the record, timestamps are in nanoseconds on any clock and must not decrease. Returns False on a write error. */
+Bool Replay_Write(FReplay* Replay, const FReplayRecord* Record);
+
+/** Reads the next record. Returns False at the end of the log, a record cut short by a crash ends it too. */
+Bool Replay_Read(FReplay* Replay, FReplayRecord* OutRecord);
+
+/** Adds the time spent in the frame of the last frame record read, and the time from the start of the replay to its end. */
+void Replay_AddFrame(FReplay* Replay, U64 FrameNanoseconds, U64 ReplayNanoseconds);
+
+/** Returns the statistics of the frames added so far, sorting their times. */
+void Replay_GetStats(FReplay* Replay, FReplayStats* OutStats);
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "check.h"
+#include "file.h"
+#include "replay.h"
+
+#pragma region Settings
+/** Log written and removed by the test. */
+#define REPLAY_TEST_PATH "replay_test.sqrp"
+#define REPLAY_TEST_SEED 0xDEADBEEFu
+/** Records of the long log, several write buffers worth. */
+#define REPLAY_TEST_LONG_RECORDS 100000
+#pragma endregion
+
+#pragma region Private Function Declarations
+static U64 ReplayTest_GetVarintSize(U64 Value);
+static U64 ReplayTest_GetZigZag(I32 Value);
+static void ReplayTest_CheckRecord(const FReplayRecord* Read, const FReplayRecord* Written, U64 FirstTimestamp);
+static void ReplayTest_Boundaries();
+static void ReplayTest_Truncated();
+static void ReplayTest_Long();
+#pragma endregion
+
+int main() {
+    ReplayTest_Boundaries();
+    ReplayTest_Truncated();
+    ReplayTest_Long();
+
+    remove(REPLAY_TEST_PATH);
+
+    printf("replay_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+U64 ReplayTest_GetVarintSize(U64 Value) {
+    U64 Size = 1;
+    while (Value >= 0x80) {
+        Value >>= 7;
+        Size++;
+    }
+
+    return Size;
+}
+
+U64 ReplayTest_GetZigZag(const I32 Value) {
+    return Value >= 0 ? (U64)Value * 2 : (U64)(-(I64)Value) * 2 - 1;
+}
+
+void ReplayTest_CheckRecord(const FReplayRecord* Read, const FReplayRecord* Written, const U64 FirstTimestamp) {
+    CHECK(Read->Type == Written->Type);
+
+    // Timestamps come back relative to the first record, in whole microseconds.
+    CHECK(Read->Timestamp == (Written->Timestamp / 1000 - FirstTimestamp / 1000) * 1000);
+    switch (Written->Type) {
+    case REPLAY_RECORD_FRAME:
+        CHECK(Read->DeltaTime == Written->DeltaTime);
+        break;
+    case REPLAY_RECORD_KEY_DOWN:
+    case REPLAY_RECORD_KEY_UP:
+        CHECK(Read->Key == Written->Key);
+        break;
+    default:
+        CHECK(Read->X == Written->X && Read->Y == Written->Y);
+        break;
+    }
+}
+
+void ReplayTest_Boundaries() {
+    // Values on both sides of every varint length step, and the extremes of the zigzag mouse deltas.
+    static const U32 Keys[] = {0, 1, 127, 128, 16383, 16384, (1u << 21) - 1, 1u << 21, (1u << 28) - 1, 1u << 28, 0xFFFFFFFFu};
+    static const I32 Motions[] = {0, -1, 1, -64, 63, 64, -65, -8192, 8191, 8192, 0x7FFFFFFF, (I32)0x80000000};
+    static const U64 Deltas[] = {0, 127, 128, 16383, 16384, 1ull << 32, (1ull << 35) + 5};
+    const U32 KeyCount = sizeof Keys / sizeof Keys[0];
+    const U32 MotionCount = sizeof Motions / sizeof Motions[0];
+    const U32 DeltaCount = sizeof Deltas / sizeof Deltas[0];
+    const U32 RecordCount = KeyCount + MotionCount + DeltaCount;
+
+    FReplayRecord Records[64];
+    U64 Timestamp = 5000000123ull;
+    U64 Microseconds = Timestamp / 1000;
+    U64 ExpectedSize = 4 + ReplayTest_GetVarintSize(REPLAY_VERSION) + ReplayTest_GetVarintSize(REPLAY_TEST_SEED);
+    for (U32 Index = 0; Index < RecordCount; Index++) {
+        FReplayRecord* Record = &Records[Index];
+        memset(Record, 0, sizeof *Record);
+
+        // Timestamps step by the deltas in microseconds, plus nanoseconds the log drops.
+        const U64 Delta = Index < DeltaCount ? Deltas[Index] : Index % 3;
+        Microseconds += Delta;
+        Timestamp = Microseconds * 1000 + Index % 1000;
+        Record->Timestamp = Timestamp;
+        ExpectedSize += 1 + ReplayTest_GetVarintSize(Index == 0 ? 0 : Delta);
+
+        if (Index < DeltaCount) {
+            Record->Type = REPLAY_RECORD_FRAME;
+            Record->DeltaTime = (U32)Deltas[Index];
+            ExpectedSize += ReplayTest_GetVarintSize(Record->DeltaTime);
+        } else if (Index < DeltaCount + KeyCount) {
+            Record->Type = Index % 2 ? REPLAY_RECORD_KEY_DOWN : REPLAY_RECORD_KEY_UP;
+            Record->Key = Keys[Index - DeltaCount];
+            ExpectedSize += ReplayTest_GetVarintSize(Record->Key);
+        } else {
+            Record->Type = REPLAY_RECORD_MOUSE_MOTION;
+            Record->X = Motions[Index - DeltaCount - KeyCount];
+            Record->Y = Motions[MotionCount - 1 - (Index - DeltaCount - KeyCount)];
+            ExpectedSize += ReplayTest_GetVarintSize(ReplayTest_GetZigZag(Record->X)) + ReplayTest_GetVarintSize(ReplayTest_GetZigZag(Record->Y));
+        }
+    }
+
+    FReplay* Replay = Replay_Create(REPLAY_TEST_PATH, REPLAY_TEST_SEED);
+    CHECK(Replay != NULL);
+    for (U32 Index = 0; Index < RecordCount; Index++) {
+        CHECK(Replay_Write(Replay, &Records[Index]));
+    }
+    Replay_Close(Replay);
+
+    // Every value takes the fewest bytes its varint needs.
+    CHECK(File_GetSize(REPLAY_TEST_PATH) == (I64)ExpectedSize);
+
+    Replay = Replay_Open(REPLAY_TEST_PATH);
+    CHECK(Replay != NULL);
+    CHECK(Replay_GetSeed(Replay) == REPLAY_TEST_SEED);
+    FReplayRecord Read;
+    for (U32 Index = 0; Index < RecordCount; Index++) {
+        CHECK(Replay_Read(Replay, &Read));
+        ReplayTest_CheckRecord(&Read, &Records[Index], Records[0].Timestamp);
+    }
+    CHECK(!Replay_Read(Replay, &Read));
+    Replay_Close(Replay);
+}
+
+void ReplayTest_Truncated() {
+    FReplay* Replay = Replay_Create(REPLAY_TEST_PATH, 7);
+    CHECK(Replay != NULL);
+
+    const FReplayRecord Records[3] = {
+        {REPLAY_RECORD_KEY_DOWN, 1000000, 44, 0, 0, 0},
+        {REPLAY_RECORD_MOUSE_MOTION, 2000000, 0, -300, 300, 0},
+        {REPLAY_RECORD_FRAME, 3000000, 0, 0, 0, 16},
+    };
+    for (U32 Index = 0; Index < 3; Index++) {
+        CHECK(Replay_Write(Replay, &Records[Index]));
+    }
+    Replay_Close(Replay);
+
+    // A record cut short by a crash ends the log after the complete ones.
+    const I64 Size = File_GetSize(REPLAY_TEST_PATH);
+    CHECK(Size > 0);
+    FILE* File = fopen(REPLAY_TEST_PATH, "rb");
+    CHECK(File != NULL);
+    Byte* Data = malloc((size_t)Size);
+    CHECK(Data != NULL && fread(Data, 1, (size_t)Size, File) == (size_t)Size);
+    fclose(File);
+
+    // The frame record ends in a one byte delta time, cutting it leaves the motion record whole.
+    File = fopen(REPLAY_TEST_PATH, "wb");
+    CHECK(File != NULL && fwrite(Data, 1, (size_t)Size - 1, File) == (size_t)Size - 1);
+    fclose(File);
+    free(Data);
+
+    Replay = Replay_Open(REPLAY_TEST_PATH);
+    CHECK(Replay != NULL);
+    FReplayRecord Read;
+    CHECK(Replay_Read(Replay, &Read));
+    ReplayTest_CheckRecord(&Read, &Records[0], Records[0].Timestamp);
+    CHECK(Replay_Read(Replay, &Read));
+    ReplayTest_CheckRecord(&Read, &Records[1], Records[0].Timestamp);
+    CHECK(!Replay_Read(Replay, &Read));
+    CHECK(!Replay_Read(Replay, &Read));
+    Replay_Close(Replay);
+}
+
+void ReplayTest_Long() {
+    FReplay* Replay = Replay_Create(REPLAY_TEST_PATH, REPLAY_TEST_SEED);
+    CHECK(Replay != NULL);
+
+    // Records written across several buffer flushes read back in order.
+    U32 Random = 12345;
+    U64 Timestamp = 0;
+    for (U32 Index = 0; Index < REPLAY_TEST_LONG_RECORDS; Index++) {
+        Random = Random * 1664525u + 1013904223u;
+        const FReplayRecord Record = {(EReplayRecordType)(Index % REPLAY_RECORD_COUNT), Timestamp, Random, (I32)Random >> 7, -(I32)(Random >> 9),
+                                      Random >> 12};
+        Timestamp += (Random >> 20) * 1000;
+        CHECK(Replay_Write(Replay, &Record));
+    }
+    Replay_Close(Replay);
+
+    Replay = Replay_Open(REPLAY_TEST_PATH);
+    CHECK(Replay != NULL);
+    Random = 12345;
+    Timestamp = 0;
+    FReplayRecord Read;
+    for (U32 Index = 0; Index < REPLAY_TEST_LONG_RECORDS; Index++) {
+        Random = Random * 1664525u + 1013904223u;
+        const FReplayRecord Record = {(EReplayRecordType)(Index % REPLAY_RECORD_COUNT), Timestamp, Random, (I32)Random >> 7, -(I32)(Random >> 9),
+                                      Random >> 12};
+        Timestamp += (Random >> 20) * 1000;
+        CHECK(Replay_Read(Replay, &Read));
+        ReplayTest_CheckRecord(&Read, &Record, 0);
+    }
+    CHECK(!Replay_Read(Replay, &Read));
+    Replay_Close(Replay);
+}
+#pragma endregion
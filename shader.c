@@ -2,10 +2,38 @@
 #include <GL/glew.h>
 #include <SDL_log.h>
 #include <cglm/vec2.h>
+#include <stdlib.h>
 
-#include "file.h"
+#include "io.h"
+#include "render_stats.h"
+#include "shader_source.h"
 
 #define SHADER_LOG_LENGTH 1024
+#define SHADER_STAGE_COUNT 3
+
+struct FShaderProgramLoad;
+
+/** Single stage of an asynchronous program load. */
+typedef struct FShaderStageLoad {
+    struct FShaderProgramLoad* Load;
+    EShaderType Type;
+    pStr Code;
+} FShaderStageLoad;
+
+/** Asynchronous program load, compiled and linked once every stage source has arrived. */
+typedef struct FShaderProgramLoad {
+    FShaderStageLoad Stages[SHADER_STAGE_COUNT];
+    ShaderProgramHandler Handler;
+    void* UserData;
+    /** Copies of the variant defines. */
+    pStr Defines[SHADER_MAX_DEFINES];
+    U32 DefineCount;
+    U32 PendingCount;
+    Bool bFailed;
+} FShaderProgramLoad;
+
+static Bool Shader_OnSourceLoaded(const FIoResult* Result);
+static void Shader_FinishProgramLoad(FShaderProgramLoad* Load);
 
 static pStr Shader_GetShaderTypeString(const EShaderType ShaderType) {
     static const pStr ShaderTypeUnknown = "Unknown";
@@ -53,7 +81,7 @@ static Bool Shader_CheckLinkSucceeded(const U32 Id) {
     return LinkStatus;
 }
 
-U32 Shader_LoadShader(const pStr ShaderPath, const EShaderType ShaderType) {
+U32 Shader_CompileShader(const char* Code, const EShaderType ShaderType) {
     U32 Id;
 
     switch (ShaderType) {
@@ -70,24 +98,55 @@ U32 Shader_LoadShader(const pStr ShaderPath, const EShaderType ShaderType) {
         return InvalidId;
     }
 
+    glShaderSource(Id, 1, (const GLchar* const*)&Code, NULL);
+    glCompileShader(Id);
+
+    if (Shader_CheckCompileSucceeded(Id, ShaderType)) {
+        return Id;
+    }
+
+    glDeleteShader(Id);
+
+    return InvalidId;
+}
+
+U32 Shader_LoadShader(const pStr ShaderPath, const EShaderType ShaderType) {
     I64 CodeLength;
-    const pStr Code = File_ReadText(ShaderPath, &CodeLength);
+    const pStr Code = ShaderSource_Load(ShaderPath, NULL, 0, &CodeLength);
     if (Code == NULL) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load shader code");
         return InvalidId;
     }
 
-    glShaderSource(Id, 1, &Code, NULL);
-    glCompileShader(Id);
+    const U32 Id = Shader_CompileShader(Code, ShaderType);
+    free(Code);
 
-    I32 CompileStatus = GL_FALSE;
-    glGetShaderiv(Id, GL_COMPILE_STATUS, &CompileStatus);
+    return Id;
+}
 
-    if (Shader_CheckCompileSucceeded(Id, ShaderType)) {
+U32 Shader_LinkProgram(const U32 VertexShaderId, const U32 FragmentShaderId, const U32 GeometryShaderId) {
+    const U32 Id = glCreateProgram();
+
+    glAttachShader(Id, VertexShaderId);
+    glAttachShader(Id, FragmentShaderId);
+    if (GeometryShaderId != InvalidId) {
+        glAttachShader(Id, GeometryShaderId);
+    }
+
+    glLinkProgram(Id);
+
+    glDeleteShader(VertexShaderId);
+    glDeleteShader(FragmentShaderId);
+    if (GeometryShaderId != InvalidId) {
+        glDeleteShader(GeometryShaderId);
+    }
+
+    if (Shader_CheckLinkSucceeded(Id)) {
+        RenderStats_AddObjects(RENDER_OBJECT_PROGRAM, 1);
         return Id;
     }
 
-    glDeleteShader(Id);
+    glDeleteProgram(Id);
 
     return InvalidId;
 }
@@ -118,6 +177,7 @@ U32 Shader_LoadProgram(const pStr VertexShaderPath, const pStr FragmentShaderPat
 #pragma region Fragment Shader
     const U32 FragmentShaderId = Shader_LoadShader(FragmentShaderPath, Shader_Fragment);
     if (FragmentShaderId == InvalidId) {
+        glDeleteShader(VertexShaderId);
         return InvalidId;
     }
 #pragma endregion
@@ -127,44 +187,85 @@ U32 Shader_LoadProgram(const pStr VertexShaderPath, const pStr FragmentShaderPat
     if (bCompilingGeometryShader) {
         GeometryShaderId = Shader_LoadShader(GeometryShaderPath, Shader_Geometry);
         if (GeometryShaderId == InvalidId) {
+            glDeleteShader(VertexShaderId);
+            glDeleteShader(FragmentShaderId);
             return InvalidId;
         }
     }
 #pragma endregion
 
-    const U32 Id = glCreateProgram();
+    return Shader_LinkProgram(VertexShaderId, FragmentShaderId, GeometryShaderId);
+}
 
-    glAttachShader(Id, VertexShaderId);
-    glAttachShader(Id, FragmentShaderId);
-    if (bCompilingGeometryShader) {
-        glAttachShader(Id, GeometryShaderId);
-    }
+Bool Shader_LoadProgramAsync(const pStr VertexShaderPath, const pStr FragmentShaderPath, const pStr GeometryShaderPath, const ShaderProgramHandler Handler,
+                             void* UserData) {
+    return Shader_LoadProgramVariantAsync(VertexShaderPath, FragmentShaderPath, GeometryShaderPath, NULL, 0, Handler, UserData);
+}
 
-    glLinkProgram(Id);
+Bool Shader_LoadProgramVariantAsync(const pStr VertexShaderPath, const pStr FragmentShaderPath, const pStr GeometryShaderPath, const pStr* Defines,
+                                    const U32 DefineCount, const ShaderProgramHandler Handler, void* UserData) {
+    if (DefineCount > SHADER_MAX_DEFINES) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Too many shader defines: %u", DefineCount);
+        return False;
+    }
 
-    if (VertexShaderId != InvalidId) {
-        glDeleteShader(VertexShaderId);
+    if (VertexShaderPath == NULL || SDL_strcmp(VertexShaderPath, StrEmpty) == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Vertex shader path is empty");
+        return False;
     }
 
-    if (FragmentShaderId != InvalidId) {
-        glDeleteShader(FragmentShaderId);
+    if (FragmentShaderPath == NULL || SDL_strcmp(FragmentShaderPath, StrEmpty) == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Fragment shader path is empty");
+        return False;
     }
 
-    if (bCompilingGeometryShader && GeometryShaderId != InvalidId) {
-        glDeleteShader(GeometryShaderId);
+    FShaderProgramLoad* Load = calloc(1, sizeof *Load);
+    if (Load == NULL) {
+        return False;
     }
 
-    if (Shader_CheckLinkSucceeded(Id)) {
-        return Id;
+    const pStr Paths[SHADER_STAGE_COUNT] = {VertexShaderPath, FragmentShaderPath, GeometryShaderPath};
+
+    Load->Handler = Handler;
+    Load->UserData = UserData;
+    for (U32 Index = 0; Index < DefineCount; Index++) {
+        Load->Defines[Load->DefineCount++] = SDL_strdup(Defines[Index]);
+    }
+    for (U32 Stage = 0; Stage < SHADER_STAGE_COUNT; Stage++) {
+        Load->Stages[Stage].Load = Load;
+        Load->Stages[Stage].Type = (EShaderType)Stage;
+        if (Paths[Stage] != NULL && SDL_strcmp(Paths[Stage], StrEmpty) != 0) {
+            Load->PendingCount++;
+        }
     }
 
-    glDeleteProgram(Id);
+    // Completions are dispatched from Io_Update, so every stage is counted before any of them can finish.
+    for (U32 Stage = 0; Stage < SHADER_STAGE_COUNT; Stage++) {
+        if (Paths[Stage] == NULL || SDL_strcmp(Paths[Stage], StrEmpty) == 0) {
+            continue;
+        }
 
-    return InvalidId;
+        FIoReadRequest Request = {0};
+        Request.Path = Paths[Stage];
+        Request.Priority = IO_PRIORITY_HIGH;
+        Request.Handler = Shader_OnSourceLoaded;
+        Request.UserData = &Load->Stages[Stage];
+
+        if (Io_Read(&Request) == InvalidId) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to queue shader read %s", Paths[Stage]);
+            Load->bFailed = True;
+            if (--Load->PendingCount == 0) {
+                Shader_FinishProgramLoad(Load);
+            }
+        }
+    }
+
+    return True;
 }
 
 void Shader_Use(const U32 Id) {
     glUseProgram(Id);
+    RenderStats_Count(RENDER_COUNTER_PROGRAM_BINDS, 1);
 }
 
 void Shader_SetBool(const U32 Id, const pStr Name, const Bool Value) {
@@ -214,3 +315,68 @@ void Shader_SetMatrix3(const U32 Id, const pStr Name, const mat3 Matrix) {
 void Shader_SetMatrix4(const U32 Id, const pStr Name, const mat4 Matrix) {
     glUniformMatrix4fv(glGetUniformLocation(Id, Name), 1, GL_FALSE, &Matrix[0][0]);
 }
+
+static Bool Shader_OnSourceLoaded(const FIoResult* Result) {
+    FShaderStageLoad* Stage = Result->UserData;
+    FShaderProgramLoad* Load = Stage->Load;
+
+    if (Result->Status == IO_STATUS_COMPLETED) {
+        char Directory[SHADER_SOURCE_PATH_LENGTH];
+        ShaderSource_GetDirectory(Result->Path, Directory, sizeof Directory);
+        Stage->Code = ShaderSource_Preprocess((const char*)Result->Data, (I64)Result->Length, Directory, (const pStr*)Load->Defines, Load->DefineCount, NULL);
+    } else {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read shader %s", Result->Path);
+    }
+
+    if (Stage->Code == NULL) {
+        Load->bFailed = True;
+    }
+
+    if (--Load->PendingCount == 0) {
+        Shader_FinishProgramLoad(Load);
+    }
+
+    return False;
+}
+
+static void Shader_FinishProgramLoad(FShaderProgramLoad* Load) {
+    U32 ShaderIds[SHADER_STAGE_COUNT] = {InvalidId, InvalidId, InvalidId};
+    U32 ProgramId = InvalidId;
+
+    if (!Load->bFailed) {
+        Bool bCompiled = True;
+        for (U32 Stage = 0; Stage < SHADER_STAGE_COUNT; Stage++) {
+            if (Load->Stages[Stage].Code == NULL) {
+                continue;
+            }
+
+            ShaderIds[Stage] = Shader_CompileShader(Load->Stages[Stage].Code, Load->Stages[Stage].Type);
+            if (ShaderIds[Stage] == InvalidId) {
+                bCompiled = False;
+            }
+        }
+
+        if (bCompiled) {
+            ProgramId = Shader_LinkProgram(ShaderIds[Shader_Vertex], ShaderIds[Shader_Fragment], ShaderIds[Shader_Geometry]);
+        } else {
+            for (U32 Stage = 0; Stage < SHADER_STAGE_COUNT; Stage++) {
+                if (ShaderIds[Stage] != InvalidId) {
+                    glDeleteShader(ShaderIds[Stage]);
+                }
+            }
+        }
+    }
+
+    for (U32 Stage = 0; Stage < SHADER_STAGE_COUNT; Stage++) {
+        free(Load->Stages[Stage].Code);
+    }
+    for (U32 Index = 0; Index < Load->DefineCount; Index++) {
+        SDL_free(Load->Defines[Index]);
+    }
+
+    if (Load->Handler != NULL) {
+        Load->Handler(ProgramId, Load->UserData);
+    }
+
+    free(Load);
+}
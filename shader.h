@@ -3,6 +3,9 @@
 
 #include "typedefs.h"
 
+/** Defines of a program variant, see Shader_LoadProgramVariantAsync. */
+#define SHADER_MAX_DEFINES 16
+
 typedef enum {
     Shader_Unknown = -1,
     Shader_Vertex,
@@ -10,8 +13,26 @@ typedef enum {
     Shader_Geometry
 } EShaderType;
 
+/** Called on the main thread with the linked program or InvalidId if any stage failed. */
+typedef void (*ShaderProgramHandler)(U32 ProgramId, void* UserData);
+
+/** Compiles preprocessed shader source, returns InvalidId on failure. */
+U32 Shader_CompileShader(const char* Code, EShaderType ShaderType);
+/** Loads and compiles a single shader stage. */
+U32 Shader_LoadShader(pStr ShaderPath, EShaderType ShaderType);
+/** Links compiled stages into a program and deletes the stages, geometry stage is optional (InvalidId). */
+U32 Shader_LinkProgram(U32 VertexShaderId, U32 FragmentShaderId, U32 GeometryShaderId);
 /** Loads and compiles shaders. */
 U32 Shader_LoadProgram(pStr VertexShaderPath, pStr FragmentShaderPath, pStr GeometryShaderPath);
+/** Reads shader sources through the io service and compiles them once all stages arrive, see Io_Update. */
+Bool Shader_LoadProgramAsync(pStr VertexShaderPath, pStr FragmentShaderPath, pStr GeometryShaderPath, ShaderProgramHandler Handler, void* UserData);
+
+/**
+ * Loads a variant of the program, with a #define for each of the Defines ("NAME" or "NAME VALUE") injected into every
+ * stage, see ShaderSource_Preprocess. The defines are copied, at most SHADER_MAX_DEFINES.
+ */
+Bool Shader_LoadProgramVariantAsync(pStr VertexShaderPath, pStr FragmentShaderPath, pStr GeometryShaderPath, const pStr* Defines, U32 DefineCount,
+                                    ShaderProgramHandler Handler, void* UserData);
 /** Use the shader. */
 void Shader_Use(U32 Id);
 /** Set the shader uniform value. */
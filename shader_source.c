@@ -0,0 +1,328 @@
+#include "shader_source.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "containers/vector.h"
+#include "file.h"
+
+#pragma region Private Function Declarations
+/** Appends bytes to the output, grows the output geometrically. */
+static void ShaderSource_Append(FVector(char)* Output, const char* Data, size_t Length);
+
+/** Appends a formatted line to the output. */
+static void ShaderSource_AppendLine(FVector(char)* Output, const char* Format, ...);
+
+/** Preprocesses the source into the output, recursing into included files. */
+static Bool ShaderSource_PreprocessInto(FVector(char)* Output, const char* Source, I64 Length, pStr Directory, const pStr* Defines, U32 DefineCount, U32 Depth);
+
+/** Returns the rest of the line if it starts with the directive, ignoring leading whitespace, NULL otherwise. */
+static const char* ShaderSource_MatchDirective(const char* Line, const char* LineEnd, const char* Directive);
+
+static inline Bool ShaderSource_IsIdentifier(const char Character) {
+    return Character == '_' || (Character >= 'a' && Character <= 'z') || (Character >= 'A' && Character <= 'Z') || (Character >= '0' && Character <= '9');
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+pStr ShaderSource_Preprocess(const char* Source, const I64 Length, const pStr Directory, const pStr* Defines, const U32 DefineCount, I64* OutLength) {
+    if (Source == NULL) {
+        return NULL;
+    }
+
+    FVector(char) Output = NULL;
+    FVector_Reserve(Output, (size_t)Length + 256);
+
+    if (!ShaderSource_PreprocessInto(&Output, Source, Length, Directory, Defines, DefineCount, 0)) {
+        FVector_Free(Output);
+        return NULL;
+    }
+
+    const size_t OutputLength = FVector_GetSize(Output);
+    const pStr Result = (pStr)malloc(OutputLength + 1);
+    if (Result == NULL) {
+        FVector_Free(Output);
+        return NULL;
+    }
+
+    memcpy(Result, Output, OutputLength);
+    Result[OutputLength] = '\0';
+    FVector_Free(Output);
+
+    if (OutLength != NULL) {
+        *OutLength = (I64)OutputLength;
+    }
+
+    return Result;
+}
+
+pStr ShaderSource_Load(const pStr Path, const pStr* Defines, const U32 DefineCount, I64* OutLength) {
+    I64 Length;
+    const pStr Source = File_ReadText(Path, &Length);
+    if (Source == NULL) {
+        fprintf(stderr, "Failed to read shader source %s\n", Path);
+        return NULL;
+    }
+
+    char Directory[SHADER_SOURCE_PATH_LENGTH];
+    ShaderSource_GetDirectory(Path, Directory, sizeof Directory);
+
+    const pStr Result = ShaderSource_Preprocess(Source, Length, Directory, Defines, DefineCount, OutLength);
+    free(Source);
+
+    return Result;
+}
+
+void ShaderSource_GetDirectory(const pStr Path, char* OutDirectory, const size_t Size) {
+    const char* Separator = strrchr(Path, '/');
+    const char* BackSeparator = strrchr(Path, '\\');
+    if (BackSeparator > Separator) {
+        Separator = BackSeparator;
+    }
+
+    if (Separator == NULL) {
+        OutDirectory[0] = '\0';
+        return;
+    }
+
+    snprintf(OutDirectory, Size, "%.*s", (int)(Separator - Path + 1), Path);
+}
+
+Bool ShaderSource_Validate(const char* Source, const I64 Length, char* OutError, const size_t Size) {
+    static const char Openers[] = "({[";
+    static const char Closers[] = ")}]";
+
+    char Brackets[SHADER_SOURCE_MAX_BRACKET_DEPTH];
+    I64 BracketLines[SHADER_SOURCE_MAX_BRACKET_DEPTH];
+    U32 Depth = 0;
+    Bool bCode = False, bMain = False, bComment = False;
+
+    const char* SourceEnd = Source + Length;
+    const char* Line = Source;
+    I64 LineNumber = 1;
+    while (Line < SourceEnd) {
+        const char* LineEnd = memchr(Line, '\n', (size_t)(SourceEnd - Line));
+        const char* NextLine = LineEnd != NULL ? LineEnd + 1 : SourceEnd;
+        if (LineEnd == NULL) {
+            LineEnd = SourceEnd;
+        }
+
+        // Directives take the whole line, #line renumbers the lines after it the way the compiler reports them.
+        const char* Arguments;
+        if (!bComment && (Arguments = ShaderSource_MatchDirective(Line, LineEnd, "#")) != NULL) {
+            if (ShaderSource_MatchDirective(Arguments, LineEnd, "version") != NULL && bCode) {
+                snprintf(OutError, Size, "line %lld: #version must come first", LineNumber);
+                return False;
+            }
+            bCode = True;
+
+            if ((Arguments = ShaderSource_MatchDirective(Arguments, LineEnd, "line")) != NULL) {
+                LineNumber = strtoll(Arguments, NULL, 10) - 1;
+            }
+
+            Line = NextLine;
+            LineNumber++;
+            continue;
+        }
+
+        for (const char* Character = Line; Character < LineEnd; Character++) {
+            if (bComment) {
+                if (Character + 1 < LineEnd && Character[0] == '*' && Character[1] == '/') {
+                    bComment = False;
+                    Character++;
+                }
+                continue;
+            }
+
+            if (Character + 1 < LineEnd && Character[0] == '/' && Character[1] == '/') {
+                break;
+            }
+            if (Character + 1 < LineEnd && Character[0] == '/' && Character[1] == '*') {
+                bComment = True;
+                Character++;
+                continue;
+            }
+
+            if (*Character == ' ' || *Character == '\t' || *Character == '\r') {
+                continue;
+            }
+            bCode = True;
+
+            if (strchr(Openers, *Character) != NULL) {
+                if (Depth == SHADER_SOURCE_MAX_BRACKET_DEPTH) {
+                    snprintf(OutError, Size, "line %lld: brackets nest deeper than %d", LineNumber, SHADER_SOURCE_MAX_BRACKET_DEPTH);
+                    return False;
+                }
+                Brackets[Depth] = *Character;
+                BracketLines[Depth++] = LineNumber;
+            } else if (strchr(Closers, *Character) != NULL) {
+                const char Expected = Depth > 0 ? Closers[strchr(Openers, Brackets[Depth - 1]) - Openers] : '\0';
+                if (*Character != Expected && Depth > 0) {
+                    snprintf(OutError, Size, "line %lld: unexpected '%c', '%c' of line %lld is open", LineNumber, *Character, Brackets[Depth - 1], BracketLines[Depth - 1]);
+                    return False;
+                }
+                if (*Character != Expected) {
+                    snprintf(OutError, Size, "line %lld: unexpected '%c'", LineNumber, *Character);
+                    return False;
+                }
+                Depth--;
+            } else if (Depth == 0 && LineEnd - Character >= 4 && strncmp(Character, "main", 4) == 0 &&
+                       (Character == Line || !ShaderSource_IsIdentifier(Character[-1])) && (Character + 4 == LineEnd || !ShaderSource_IsIdentifier(Character[4]))) {
+                bMain = True;
+            }
+        }
+
+        Line = NextLine;
+        LineNumber++;
+    }
+
+    if (bComment) {
+        snprintf(OutError, Size, "unterminated comment");
+        return False;
+    }
+    if (Depth > 0) {
+        snprintf(OutError, Size, "line %lld: '%c' is never closed", BracketLines[Depth - 1], Brackets[Depth - 1]);
+        return False;
+    }
+    if (!bMain) {
+        snprintf(OutError, Size, "no main function");
+        return False;
+    }
+
+    return True;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void ShaderSource_Append(FVector(char)* Output, const char* Data, const size_t Length) {
+    FVector(char) Vector = *Output;
+
+    const size_t Size = FVector_GetSize(Vector);
+    const size_t Capacity = FVector_GetCapacity(Vector);
+    if (Size + Length > Capacity) {
+        const size_t NewCapacity = Capacity * 2 > Size + Length ? Capacity * 2 : Size + Length;
+        FVector_Grow(Vector, NewCapacity);
+    }
+
+    memcpy(Vector + Size, Data, Length);
+    FVector_SetSize(Vector, Size + Length);
+
+    *Output = Vector;
+}
+
+void ShaderSource_AppendLine(FVector(char)* Output, const char* Format, ...) {
+    char Line[SHADER_SOURCE_PATH_LENGTH];
+
+    va_list Arguments;
+    va_start(Arguments, Format);
+    const int Length = vsnprintf(Line, sizeof Line, Format, Arguments);
+    va_end(Arguments);
+
+    if (Length > 0) {
+        ShaderSource_Append(Output, Line, (size_t)Length < sizeof Line ? (size_t)Length : sizeof Line - 1);
+    }
+}
+
+Bool ShaderSource_PreprocessInto(FVector(char)* Output, const char* Source, const I64 Length, const pStr Directory, const pStr* Defines,
+                                 const U32 DefineCount, const U32 Depth) {
+    if (Depth > SHADER_SOURCE_MAX_INCLUDE_DEPTH) {
+        fprintf(stderr, "Shader include depth exceeds %d\n", SHADER_SOURCE_MAX_INCLUDE_DEPTH);
+        return False;
+    }
+
+    Bool bDefinesInjected = DefineCount == 0;
+    const char* SourceEnd = Source + Length;
+    const char* Line = Source;
+    I64 LineNumber = 1;
+
+    // Skip the byte order mark, GLSL compilers reject it.
+    if (Length >= 3 && (U8)Source[0] == 0xEF && (U8)Source[1] == 0xBB && (U8)Source[2] == 0xBF) {
+        Line += 3;
+    }
+
+    while (Line < SourceEnd) {
+        const char* LineEnd = memchr(Line, '\n', (size_t)(SourceEnd - Line));
+        const char* NextLine = LineEnd != NULL ? LineEnd + 1 : SourceEnd;
+        if (LineEnd == NULL) {
+            LineEnd = SourceEnd;
+        }
+
+        const char* Arguments;
+        if (!bDefinesInjected && ShaderSource_MatchDirective(Line, LineEnd, "#version") != NULL) {
+            ShaderSource_Append(Output, Line, (size_t)(NextLine - Line));
+            if (NextLine == SourceEnd) {
+                ShaderSource_Append(Output, "\n", 1);
+            }
+
+            for (U32 Index = 0; Index < DefineCount; Index++) {
+                ShaderSource_AppendLine(Output, "#define %s\n", Defines[Index]);
+            }
+            ShaderSource_AppendLine(Output, "#line %lld\n", LineNumber + 1);
+
+            bDefinesInjected = True;
+        } else if ((Arguments = ShaderSource_MatchDirective(Line, LineEnd, "#include")) != NULL) {
+            const char* PathStart = memchr(Arguments, '"', (size_t)(LineEnd - Arguments));
+            const char* PathEnd = PathStart != NULL ? memchr(PathStart + 1, '"', (size_t)(LineEnd - PathStart - 1)) : NULL;
+            if (PathEnd == NULL) {
+                fprintf(stderr, "Malformed shader include at line %lld\n", LineNumber);
+                return False;
+            }
+
+            char IncludePath[SHADER_SOURCE_PATH_LENGTH];
+            snprintf(IncludePath, sizeof IncludePath, "%s%.*s", Directory != NULL ? Directory : "", (int)(PathEnd - PathStart - 1), PathStart + 1);
+
+            I64 IncludeLength;
+            const pStr Include = File_ReadText(IncludePath, &IncludeLength);
+            if (Include == NULL) {
+                fprintf(stderr, "Failed to read shader include %s\n", IncludePath);
+                return False;
+            }
+
+            char IncludeDirectory[SHADER_SOURCE_PATH_LENGTH];
+            ShaderSource_GetDirectory(IncludePath, IncludeDirectory, sizeof IncludeDirectory);
+
+            const Bool bIncluded = ShaderSource_PreprocessInto(Output, Include, IncludeLength, IncludeDirectory, NULL, 0, Depth + 1);
+            free(Include);
+            if (!bIncluded) {
+                return False;
+            }
+
+            ShaderSource_AppendLine(Output, "\n#line %lld\n", LineNumber + 1);
+        } else {
+            ShaderSource_Append(Output, Line, (size_t)(NextLine - Line));
+        }
+
+        Line = NextLine;
+        LineNumber++;
+    }
+
+    // No #version directive, the defines go on top.
+    if (!bDefinesInjected) {
+        FVector(char) Body = *Output;
+        *Output = NULL;
+        for (U32 Index = 0; Index < DefineCount; Index++) {
+            ShaderSource_AppendLine(Output, "#define %s\n", Defines[Index]);
+        }
+        ShaderSource_Append(Output, "#line 1\n", 8);
+        ShaderSource_Append(Output, Body, FVector_GetSize(Body));
+        FVector_Free(Body);
+    }
+
+    return True;
+}
+
+const char* ShaderSource_MatchDirective(const char* Line, const char* LineEnd, const char* Directive) {
+    while (Line < LineEnd && (*Line == ' ' || *Line == '\t')) {
+        Line++;
+    }
+
+    const size_t DirectiveLength = strlen(Directive);
+    if ((size_t)(LineEnd - Line) < DirectiveLength || strncmp(Line, Directive, DirectiveLength) != 0) {
+        return NULL;
+    }
+
+    return Line + DirectiveLength;
+}
+#pragma endregion
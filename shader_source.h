@@ -0,0 +1,29 @@
+#pragma once
+#include <stddef.h>
+
+#include "typedefs.h"
+
+/** Maximum nesting depth of #include directives. */
+#define SHADER_SOURCE_MAX_INCLUDE_DEPTH 8
+/** Maximum length of a shader path. */
+#define SHADER_SOURCE_PATH_LENGTH 512
+/** Maximum nesting of brackets ShaderSource_Validate follows. */
+#define SHADER_SOURCE_MAX_BRACKET_DEPTH 64
+
+/**
+ * Preprocesses GLSL source code. Resolves #include "file" directives relative to the Directory and injects a #define line for each of the
+ * Defines ("NAME" or "NAME VALUE") right after the #version directive. Returns a new null-terminated buffer, caller frees the result.
+ */
+pStr ShaderSource_Preprocess(const char* Source, I64 Length, pStr Directory, const pStr* Defines, U32 DefineCount, I64* OutLength);
+
+/** Reads and preprocesses the shader file, see ShaderSource_Preprocess. */
+pStr ShaderSource_Load(pStr Path, const pStr* Defines, U32 DefineCount, I64* OutLength);
+
+/** Writes the directory part of the Path including the trailing separator, empty if the Path has no directory. */
+void ShaderSource_GetDirectory(pStr Path, char* OutDirectory, size_t Size);
+
+/**
+ * Checks preprocessed GLSL for the mistakes found without a compiler: a #version directive that isn't first, unbalanced
+ * brackets and a missing main function. Returns False and describes the first mistake with its line in OutError.
+ */
+Bool ShaderSource_Validate(const char* Source, I64 Length, char* OutError, size_t Size);
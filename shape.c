@@ -1,8 +1,15 @@
 ﻿#include "shape.h"
+#include <GL/glew.h>
+
+#include "render_stats.h"
 
 void Shape_Buffer(const FShape Shape, U32* IndexBuffer, U32* VertexBuffer, U32* ColorBuffer, U32* TexCoordBuffer, U32* NormalBuffer, const U32 ShaderProgram) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *IndexBuffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, FVector_GetSize(Shape.Indices) * SIZE_INDEX, FVector_Begin(Shape.Indices), GL_STATIC_DRAW);
+    if (FVector_IsEmpty(Shape.Indices32)) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, FVector_GetSize(Shape.Indices) * SIZE_INDEX, FVector_Begin(Shape.Indices), GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, FVector_GetSize(Shape.Indices32) * SIZE_INDEX32, FVector_Begin(Shape.Indices32), GL_STATIC_DRAW);
+    }
 
     glBindBuffer(GL_ARRAY_BUFFER, *VertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, FVector_GetSize(Shape.Vertices) * SIZE_VERTEX, FVector_Begin(Shape.Vertices), GL_STATIC_DRAW);
@@ -16,7 +23,7 @@ void Shape_Buffer(const FShape Shape, U32* IndexBuffer, U32* VertexBuffer, U32*
 
     glBindBuffer(GL_ARRAY_BUFFER, *TexCoordBuffer);
     glBufferData(GL_ARRAY_BUFFER, SIZE_TEXCOORD * FVector_GetSize(Shape.TexCoords), FVector_Begin(Shape.TexCoords), GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, 0);
+    glVertexAttribPointer(2, SHAPE_TEXCOORD_COMPONENTS, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(2);
 
     glBindBuffer(GL_ARRAY_BUFFER, *NormalBuffer);
@@ -29,4 +36,69 @@ void Shape_Buffer(const FShape Shape, U32* IndexBuffer, U32* VertexBuffer, U32*
     glUniform1f(glGetUniformLocation(ShaderProgram, "mat.shininess"), 0.5f);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats_Count(RENDER_COUNTER_BUFFER_BYTES, Shape_GetSize(&Shape));
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 6);
+}
+
+U64 Shape_UpdateBuffers(const FShape Shape, const U32 IndexBuffer, const U32 VertexBuffer, const U32 ColorBuffer, const U32 TexCoordBuffer, const U32 NormalBuffer) {
+    const U32 Buffers[5] = {IndexBuffer, VertexBuffer, ColorBuffer, TexCoordBuffer, NormalBuffer};
+    const GLenum Targets[5] = {GL_ELEMENT_ARRAY_BUFFER, GL_ARRAY_BUFFER, GL_ARRAY_BUFFER, GL_ARRAY_BUFFER, GL_ARRAY_BUFFER};
+    const Bool bWide = !FVector_IsEmpty(Shape.Indices32);
+    const void* Data[5] = {bWide ? (const void*)FVector_Begin(Shape.Indices32) : (const void*)FVector_Begin(Shape.Indices), FVector_Begin(Shape.Vertices),
+                           FVector_Begin(Shape.Colors), FVector_Begin(Shape.TexCoords), FVector_Begin(Shape.Normals)};
+    const GLsizeiptr Sizes[5] = {
+        (GLsizeiptr)(bWide ? FVector_GetSize(Shape.Indices32) * SIZE_INDEX32 : FVector_GetSize(Shape.Indices) * SIZE_INDEX),
+        (GLsizeiptr)(FVector_GetSize(Shape.Vertices) * SIZE_VERTEX),    (GLsizeiptr)(FVector_GetSize(Shape.Colors) * SIZE_COLOR),
+        (GLsizeiptr)(FVector_GetSize(Shape.TexCoords) * SIZE_TEXCOORD), (GLsizeiptr)(FVector_GetSize(Shape.Normals) * SIZE_NORMAL),
+    };
+
+    U64 AllocatedSize = 0;
+    for (U32 Index = 0; Index < 5; Index++) {
+        glBindBuffer(Targets[Index], Buffers[Index]);
+
+        GLint Capacity = 0;
+        glGetBufferParameteriv(Targets[Index], GL_BUFFER_SIZE, &Capacity);
+        if (Sizes[Index] > Capacity) {
+            // Leave room for the shape to grow further, vertex array bindings stay valid across the reallocation.
+            Capacity = (GLint)(Sizes[Index] + Sizes[Index] / 2);
+            glBufferData(Targets[Index], Capacity, NULL, GL_DYNAMIC_DRAW);
+        }
+
+        if (Sizes[Index] > 0) {
+            glBufferSubData(Targets[Index], 0, Sizes[Index], Data[Index]);
+            RenderStats_Count(RENDER_COUNTER_BUFFER_BYTES, (U64)Sizes[Index]);
+        }
+        AllocatedSize += (U64)Capacity;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 6);
+
+    return AllocatedSize;
+}
+
+U32 Shape_GetIndexType(const FShape* Shape) {
+    return FVector_IsEmpty(Shape->Indices32) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+U64 Shape_UpdateFaceBuffer(const FShape Shape, const U32 FaceBuffer) {
+    const GLsizeiptr Size = (GLsizeiptr)(FVector_GetSize(Shape.Faces) * SIZE_FACE);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, FaceBuffer);
+
+    GLint Capacity = 0;
+    glGetBufferParameteriv(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &Capacity);
+    if (Size > Capacity) {
+        Capacity = (GLint)(Size + Size / 2);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, Capacity, NULL, GL_DYNAMIC_DRAW);
+    }
+
+    if (Size > 0) {
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, Size, FVector_Begin(Shape.Faces));
+        RenderStats_Count(RENDER_COUNTER_BUFFER_BYTES, (U64)Size);
+    }
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 2);
+
+    return (U64)Capacity;
 }
@@ -1,6 +1,4 @@
 ﻿#pragma once
-#include <GL/glew.h>
-
 #include "typedefs.h"
 #include "containers/vector.h"
 
@@ -9,6 +7,17 @@
 #define SIZE_TEXCOORD (sizeof(F32))
 #define SIZE_NORMAL (sizeof(F32))
 #define SIZE_INDEX (sizeof(U16))
+#define SIZE_INDEX32 (sizeof(U32))
+#define SIZE_FACE (sizeof(U32))
+
+/**
+ * Texture coordinates are u, v, the layer of the material in the texture array and the layers the face smudges into
+ * across its edges, packed by the mesher.
+ */
+#define SHAPE_TEXCOORD_COMPONENTS 4
+
+/** Vertices addressable by 16-bit indices, larger shapes use Indices32. */
+#define SHAPE_MAX_SHORT_VERTICES 65536
 
 typedef struct FShape {
     FVector(F32) Vertices;
@@ -16,6 +25,70 @@ typedef struct FShape {
     FVector(F32) TexCoords;
     FVector(F32) Normals;
     FVector(U16) Indices;
+    /** Indices of shapes with more vertices than 16-bit indices address, used instead of Indices when not empty. */
+    FVector(U32) Indices32;
+    /** Face records for the vertex pulling renderer instead of the vertex data, see MESHER_PACK_FACE. */
+    FVector(U32) Faces;
 } FShape;
 
 void Shape_Buffer(FShape Shape, U32* IndexBuffer, U32* VertexBuffer, U32* ColorBuffer, U32* TexCoordBuffer, U32* NormalBuffer, U32 ShaderProgram);
+
+/**
+ * Writes the shape into buffers created by Shape_Buffer, in place when it fits. Buffers too small for the shape are
+ * reallocated with room to grow. The vertex array of the buffers must be bound. Returns the allocated size in bytes.
+ */
+U64 Shape_UpdateBuffers(FShape Shape, U32 IndexBuffer, U32 VertexBuffer, U32 ColorBuffer, U32 TexCoordBuffer, U32 NormalBuffer);
+
+/** Returns the GL type of the shape indices for drawing its index buffer. */
+U32 Shape_GetIndexType(const FShape* Shape);
+
+/**
+ * Writes the shape faces into a shader storage buffer, in place when they fit, reallocating with room to grow like
+ * Shape_UpdateBuffers. Returns the allocated size in bytes.
+ */
+U64 Shape_UpdateFaceBuffer(FShape Shape, U32 FaceBuffer);
+
+/** Removes all vertices and indices keeping the allocated memory for reuse. */
+static inline void Shape_Clear(FShape* Shape) {
+    FVector_Clear(Shape->Vertices);
+    FVector_Clear(Shape->Colors);
+    FVector_Clear(Shape->TexCoords);
+    FVector_Clear(Shape->Normals);
+    FVector_Clear(Shape->Indices);
+    FVector_Clear(Shape->Indices32);
+    FVector_Clear(Shape->Faces);
+}
+
+/** Frees the shape buffers. */
+static inline void Shape_Free(FShape* Shape) {
+    FVector_Free(Shape->Vertices);
+    FVector_Free(Shape->Colors);
+    FVector_Free(Shape->TexCoords);
+    FVector_Free(Shape->Normals);
+    FVector_Free(Shape->Indices);
+    FVector_Free(Shape->Indices32);
+    FVector_Free(Shape->Faces);
+    *Shape = (FShape){0};
+}
+
+/** Returns the size of the shape data in bytes. */
+static inline U64 Shape_GetSize(const FShape* Shape) {
+    return FVector_GetSize(Shape->Vertices) * SIZE_VERTEX + FVector_GetSize(Shape->Colors) * SIZE_COLOR + FVector_GetSize(Shape->TexCoords) * SIZE_TEXCOORD +
+           FVector_GetSize(Shape->Normals) * SIZE_NORMAL + FVector_GetSize(Shape->Indices) * SIZE_INDEX + FVector_GetSize(Shape->Indices32) * SIZE_INDEX32 +
+           FVector_GetSize(Shape->Faces) * SIZE_FACE;
+}
+
+/** Returns True if the shape has neither triangles nor face records. */
+static inline Bool Shape_IsEmpty(const FShape* Shape) {
+    return FVector_IsEmpty(Shape->Indices) && FVector_IsEmpty(Shape->Indices32) && FVector_IsEmpty(Shape->Faces);
+}
+
+/** Returns the number of indices in the shape, 16-bit or 32-bit. */
+static inline U32 Shape_GetIndexCount(const FShape* Shape) {
+    return (U32)(FVector_IsEmpty(Shape->Indices32) ? FVector_GetSize(Shape->Indices) : FVector_GetSize(Shape->Indices32));
+}
+
+/** Returns the number of vertices in the shape. */
+static inline U32 Shape_GetVertexCount(const FShape* Shape) {
+    return (U32)(FVector_GetSize(Shape->Vertices) / 3);
+}
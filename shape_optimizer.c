@@ -0,0 +1,480 @@
+#include "shape_optimizer.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hash.h"
+
+#pragma region Settings
+/** Entries of the LRU cache Forsyth's algorithm scores vertices with, larger than the FIFO caches of real GPUs. */
+#define SHAPE_OPTIMIZER_LRU_SIZE 32
+/** Valences past it score as it. */
+#define SHAPE_OPTIMIZER_MAX_VALENCE 32
+
+/** Score of the vertices of the last triangle, lower than the next few so the following triangle doesn't turn back. */
+static const F32 LastTriangleScore = 0.75f;
+/** Falloff of the score of the older cache entries. */
+static const F32 CacheDecayPower = 1.5f;
+/** Boost of vertices with few triangles left, so lone triangles don't get left behind. */
+static const F32 ValenceBoostScale = 2.f;
+static const F32 ValenceBoostPower = 0.5f;
+
+/** Vertex attributes of a shape, in the order of FShape. */
+#define SHAPE_OPTIMIZER_ATTRIBUTE_COUNT 4
+static const U32 AttributeComponents[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT] = {3, 3, SHAPE_TEXCOORD_COMPONENTS, 3};
+#pragma endregion
+
+#pragma region Private Function Declarations
+/** Returns the vertex attribute vectors of the shape, the ones not given for every vertex are NULL. */
+static void ShapeOptimizer_GetAttributes(FShape* Shape, U32 VertexCount, FVector(F32)* OutAttributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT]);
+
+/** Copies the 16-bit or 32-bit indices of the shape. */
+static void ShapeOptimizer_ReadIndices(const FShape* Shape, U32* OutIndices, U32 IndexCount);
+
+static F32 ShapeOptimizer_GetIndexAcmr(const U32* Indices, U32 IndexCount, U32 VertexCount, U32 CacheSize);
+
+/** Maps each vertex to the first vertex with equal attributes, numbered in order of appearance. Returns the unique vertices. */
+static U32 ShapeOptimizer_Weld(FVector(F32)* const Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT], U32 VertexCount, U32* OutRemap);
+
+/** Moves the vertices to their remapped places, dropping the ones mapped to InvalidId. */
+static void ShapeOptimizer_RemapVertices(FVector(F32)* const Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT], const U32* Remap, U32 VertexCount, U32 NewVertexCount);
+
+/** Reorders the triangles for the vertex cache with Forsyth's linear-speed vertex cache optimization. */
+static void ShapeOptimizer_ReorderTriangles(U32* Indices, U32 IndexCount, U32 VertexCount);
+
+/** Returns the score of a vertex by its position in the LRU cache, -1 outside, and the triangles left using it. */
+static inline F32 ShapeOptimizer_GetVertexScore(const F32* CacheScores, const F32* ValenceScores, const I32 CachePosition, const U32 Valence) {
+    if (Valence == 0) {
+        return -1.f;
+    }
+
+    return (CachePosition >= 0 ? CacheScores[CachePosition] : 0.f) + ValenceScores[Valence < SHAPE_OPTIMIZER_MAX_VALENCE ? Valence : SHAPE_OPTIMIZER_MAX_VALENCE];
+}
+#pragma endregion
+
+#pragma region Public Function Definitions
+void ShapeOptimizer_GetDefaultSettings(FShapeOptimizerSettings* OutSettings) {
+    OutSettings->bWeld = True;
+    OutSettings->bReorderTriangles = True;
+    OutSettings->bReorderVertices = True;
+    OutSettings->CacheSize = 16;
+}
+
+void ShapeOptimizer_Optimize(FShape* Shape, const FShapeOptimizerSettings* Settings, FShapeOptimizerStats* OutStats) {
+    const U32 IndexCount = Shape_GetIndexCount(Shape) / 3 * 3;
+    U32 VertexCount = Shape_GetVertexCount(Shape);
+
+    FShapeOptimizerStats Stats = {0};
+    Stats.Triangles = IndexCount / 3;
+    Stats.VerticesBefore = VertexCount;
+
+    U32* Indices = malloc(((size_t)IndexCount + 1) * sizeof *Indices);
+    U32* Remap = malloc(((size_t)VertexCount + 1) * sizeof *Remap);
+    ShapeOptimizer_ReadIndices(Shape, Indices, IndexCount);
+    Stats.AcmrBefore = ShapeOptimizer_GetIndexAcmr(Indices, IndexCount, VertexCount, Settings->CacheSize);
+
+    // Attributes not given for every vertex can't follow the vertices around, they are dropped.
+    FVector(F32)* Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT];
+    ShapeOptimizer_GetAttributes(Shape, VertexCount, Attributes);
+    FVector(F32)* const AllAttributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT] = {&Shape->Vertices, &Shape->Colors, &Shape->TexCoords, &Shape->Normals};
+    for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT; Attribute++) {
+        if (Attributes[Attribute] == NULL) {
+            FVector_Clear(*AllAttributes[Attribute]);
+        }
+    }
+
+    if (Settings->bWeld && VertexCount > 0) {
+        const U32 WeldedCount = ShapeOptimizer_Weld(Attributes, VertexCount, Remap);
+        ShapeOptimizer_RemapVertices(Attributes, Remap, VertexCount, WeldedCount);
+        for (U32 Index = 0; Index < IndexCount; Index++) {
+            Indices[Index] = Remap[Indices[Index]];
+        }
+        VertexCount = WeldedCount;
+    }
+
+    if (Settings->bReorderTriangles && IndexCount > 0) {
+        ShapeOptimizer_ReorderTriangles(Indices, IndexCount, VertexCount);
+    }
+
+    // Vertices are numbered by first use, so the vertex fetches of the reordered triangles walk memory forward.
+    if (Settings->bReorderVertices && VertexCount > 0) {
+        memset(Remap, 0xFF, (size_t)VertexCount * sizeof *Remap);
+        U32 UsedCount = 0;
+        for (U32 Index = 0; Index < IndexCount; Index++) {
+            if (Remap[Indices[Index]] == InvalidId) {
+                Remap[Indices[Index]] = UsedCount++;
+            }
+            Indices[Index] = Remap[Indices[Index]];
+        }
+        ShapeOptimizer_RemapVertices(Attributes, Remap, VertexCount, UsedCount);
+        VertexCount = UsedCount;
+    }
+
+    Stats.VerticesAfter = VertexCount;
+    Stats.AcmrAfter = ShapeOptimizer_GetIndexAcmr(Indices, IndexCount, VertexCount, Settings->CacheSize);
+    Stats.bWideIndices = VertexCount > SHAPE_MAX_SHORT_VERTICES;
+
+    // Indices go back as 16-bit whenever the vertices fit, halving the index buffer.
+    FVector_Clear(Shape->Indices);
+    FVector_Clear(Shape->Indices32);
+    if (Stats.bWideIndices) {
+        FVector_Reserve(Shape->Indices32, IndexCount);
+        memcpy(Shape->Indices32, Indices, (size_t)IndexCount * sizeof *Indices);
+        FVector_SetSize(Shape->Indices32, IndexCount);
+    } else if (IndexCount > 0) {
+        FVector_Reserve(Shape->Indices, IndexCount);
+        for (U32 Index = 0; Index < IndexCount; Index++) {
+            Shape->Indices[Index] = (U16)Indices[Index];
+        }
+        FVector_SetSize(Shape->Indices, IndexCount);
+    }
+
+    free(Remap);
+    free(Indices);
+
+    if (OutStats != NULL) {
+        *OutStats = Stats;
+    }
+}
+
+U32 ShapeOptimizer_Split(const FShape* Shape, FVector(FShape)* OutShapes) {
+    const U32 IndexCount = Shape_GetIndexCount(Shape) / 3 * 3;
+    const U32 VertexCount = Shape_GetVertexCount(Shape);
+    if (IndexCount == 0) {
+        return 0;
+    }
+
+    U32* Indices = malloc((size_t)IndexCount * sizeof *Indices);
+    ShapeOptimizer_ReadIndices(Shape, Indices, IndexCount);
+
+    FShape Source = *Shape;
+    FVector(F32)* Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT];
+    ShapeOptimizer_GetAttributes(&Source, VertexCount, Attributes);
+
+    // Vertices of the source in the part being built, reset through the used list when the part is full.
+    U32* Local = malloc(((size_t)VertexCount + 1) * sizeof *Local);
+    memset(Local, 0xFF, ((size_t)VertexCount + 1) * sizeof *Local);
+    U32* Used = malloc(SHAPE_MAX_SHORT_VERTICES * sizeof *Used);
+    U32 UsedCount = 0;
+
+    // The vector macros index their argument unparenthesized, so parts go to a copy written back at the end.
+    FVector(FShape) Shapes = *OutShapes;
+    U32 PartCount = 0;
+    FShape Part = {0};
+    FVector(F32)* const PartAttributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT] = {&Part.Vertices, &Part.Colors, &Part.TexCoords, &Part.Normals};
+    for (U32 Index = 0; Index < IndexCount; Index += 3) {
+        const U32* Triangle = &Indices[Index];
+        const U32 NewCount = (Local[Triangle[0]] == InvalidId) + (Local[Triangle[1]] == InvalidId && Triangle[1] != Triangle[0]) +
+                             (Local[Triangle[2]] == InvalidId && Triangle[2] != Triangle[0] && Triangle[2] != Triangle[1]);
+
+        if (UsedCount + NewCount > SHAPE_MAX_SHORT_VERTICES) {
+            if (FVector_GetSize(Shapes) == FVector_GetCapacity(Shapes)) {
+                const size_t Capacity = FVector_GetCapacity(Shapes) * 2 + 16;
+                FVector_Reserve(Shapes, Capacity);
+            }
+            FVector_Add(Shapes, Part);
+            PartCount++;
+
+            Part = (FShape){0};
+            for (U32 UsedIndex = 0; UsedIndex < UsedCount; UsedIndex++) {
+                Local[Used[UsedIndex]] = InvalidId;
+            }
+            UsedCount = 0;
+        }
+
+        if (FVector_GetSize(Part.Indices) + 3 > FVector_GetCapacity(Part.Indices)) {
+            const size_t Capacity = FVector_GetCapacity(Part.Indices) * 2 + 64;
+            FVector_Reserve(Part.Indices, Capacity);
+        }
+
+        for (U32 Corner = 0; Corner < 3; Corner++) {
+            const U32 Vertex = Triangle[Corner];
+            if (Local[Vertex] == InvalidId) {
+                Local[Vertex] = UsedCount;
+                Used[UsedCount++] = Vertex;
+
+                for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT; Attribute++) {
+                    if (Attributes[Attribute] == NULL) {
+                        continue;
+                    }
+
+                    const U32 Components = AttributeComponents[Attribute];
+                    FVector(F32)* Vector = PartAttributes[Attribute];
+                    const size_t Size = FVector_GetSize(*Vector);
+                    if (Size + Components > FVector_GetCapacity(*Vector)) {
+                        const size_t Capacity = FVector_GetCapacity(*Vector) * 2 + 64 * Components;
+                        FVector_Reserve(*Vector, Capacity);
+                    }
+                    memcpy(*Vector + Size, *Attributes[Attribute] + (size_t)Vertex * Components, Components * sizeof(F32));
+                    FVector_SetSize(*Vector, Size + Components);
+                }
+            }
+            FVector_Add(Part.Indices, (U16)Local[Vertex]);
+        }
+    }
+
+    if (FVector_GetSize(Shapes) == FVector_GetCapacity(Shapes)) {
+        const size_t Capacity = FVector_GetCapacity(Shapes) * 2 + 16;
+        FVector_Reserve(Shapes, Capacity);
+    }
+    FVector_Add(Shapes, Part);
+    PartCount++;
+    *OutShapes = Shapes;
+
+    free(Used);
+    free(Local);
+    free(Indices);
+
+    return PartCount;
+}
+
+F32 ShapeOptimizer_GetAcmr(const FShape* Shape, const U32 CacheSize) {
+    const U32 IndexCount = Shape_GetIndexCount(Shape) / 3 * 3;
+    U32* Indices = malloc(((size_t)IndexCount + 1) * sizeof *Indices);
+    ShapeOptimizer_ReadIndices(Shape, Indices, IndexCount);
+
+    const F32 Acmr = ShapeOptimizer_GetIndexAcmr(Indices, IndexCount, Shape_GetVertexCount(Shape), CacheSize);
+    free(Indices);
+
+    return Acmr;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+void ShapeOptimizer_GetAttributes(FShape* Shape, const U32 VertexCount, FVector(F32)* OutAttributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT]) {
+    FVector(F32)* const Vectors[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT] = {&Shape->Vertices, &Shape->Colors, &Shape->TexCoords, &Shape->Normals};
+    for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT; Attribute++) {
+        const Bool bComplete = VertexCount > 0 && FVector_GetSize(*Vectors[Attribute]) == (size_t)VertexCount * AttributeComponents[Attribute];
+        OutAttributes[Attribute] = bComplete ? Vectors[Attribute] : NULL;
+    }
+}
+
+void ShapeOptimizer_ReadIndices(const FShape* Shape, U32* OutIndices, const U32 IndexCount) {
+    if (!FVector_IsEmpty(Shape->Indices32)) {
+        memcpy(OutIndices, Shape->Indices32, (size_t)IndexCount * sizeof *OutIndices);
+        return;
+    }
+
+    for (U32 Index = 0; Index < IndexCount; Index++) {
+        OutIndices[Index] = Shape->Indices[Index];
+    }
+}
+
+F32 ShapeOptimizer_GetIndexAcmr(const U32* Indices, const U32 IndexCount, const U32 VertexCount, const U32 CacheSize) {
+    if (IndexCount < 3) {
+        return 0.f;
+    }
+
+    // A vertex is cached while fewer than CacheSize misses came after its own, the time counts the misses.
+    U32* Stamps = calloc((size_t)VertexCount + 1, sizeof *Stamps);
+    U32 Time = CacheSize + 1;
+    U32 Misses = 0;
+    for (U32 Index = 0; Index < IndexCount; Index++) {
+        const U32 Vertex = Indices[Index];
+        if (Time - Stamps[Vertex] > CacheSize) {
+            Stamps[Vertex] = Time++;
+            Misses++;
+        }
+    }
+    free(Stamps);
+
+    return (F32)Misses / (F32)(IndexCount / 3);
+}
+
+U32 ShapeOptimizer_Weld(FVector(F32)* const Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT], const U32 VertexCount, U32* OutRemap) {
+    // Open addressing table of the first vertex of each set of equal vertices, at most half full.
+    U32 TableSize = 64;
+    while (TableSize < VertexCount * 2) {
+        TableSize *= 2;
+    }
+    U32* Table = malloc(TableSize * sizeof *Table);
+    memset(Table, 0xFF, TableSize * sizeof *Table);
+
+    U32 UniqueCount = 0;
+    for (U32 Vertex = 0; Vertex < VertexCount; Vertex++) {
+        U64 Hash = 0;
+        for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT; Attribute++) {
+            if (Attributes[Attribute] != NULL) {
+                const U32 Components = AttributeComponents[Attribute];
+                Hash = Hash_Compute(*Attributes[Attribute] + (size_t)Vertex * Components, Components * sizeof(F32), Hash);
+            }
+        }
+
+        for (U32 Slot = (U32)Hash & (TableSize - 1);; Slot = (Slot + 1) & (TableSize - 1)) {
+            const U32 Other = Table[Slot];
+            if (Other == InvalidId) {
+                Table[Slot] = Vertex;
+                OutRemap[Vertex] = UniqueCount++;
+                break;
+            }
+
+            Bool bEqual = True;
+            for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT && bEqual; Attribute++) {
+                if (Attributes[Attribute] != NULL) {
+                    const U32 Components = AttributeComponents[Attribute];
+                    const F32* Data = *Attributes[Attribute];
+                    bEqual = memcmp(Data + (size_t)Vertex * Components, Data + (size_t)Other * Components, Components * sizeof(F32)) == 0;
+                }
+            }
+            if (bEqual) {
+                OutRemap[Vertex] = OutRemap[Other];
+                break;
+            }
+        }
+    }
+
+    free(Table);
+    return UniqueCount;
+}
+
+void ShapeOptimizer_RemapVertices(FVector(F32)* const Attributes[SHAPE_OPTIMIZER_ATTRIBUTE_COUNT], const U32* Remap, const U32 VertexCount, const U32 NewVertexCount) {
+    for (U32 Attribute = 0; Attribute < SHAPE_OPTIMIZER_ATTRIBUTE_COUNT; Attribute++) {
+        if (Attributes[Attribute] == NULL) {
+            continue;
+        }
+
+        const U32 Components = AttributeComponents[Attribute];
+        F32* Data = *Attributes[Attribute];
+        F32* Remapped = malloc(((size_t)NewVertexCount + 1) * Components * sizeof *Remapped);
+        for (U32 Vertex = 0; Vertex < VertexCount; Vertex++) {
+            if (Remap[Vertex] != InvalidId) {
+                memcpy(Remapped + (size_t)Remap[Vertex] * Components, Data + (size_t)Vertex * Components, Components * sizeof *Remapped);
+            }
+        }
+
+        memcpy(Data, Remapped, (size_t)NewVertexCount * Components * sizeof *Remapped);
+        FVector_SetSize(*Attributes[Attribute], (size_t)NewVertexCount * Components);
+        free(Remapped);
+    }
+}
+
+void ShapeOptimizer_ReorderTriangles(U32* Indices, const U32 IndexCount, const U32 VertexCount) {
+    const U32 TriangleCount = IndexCount / 3;
+
+    F32 CacheScores[SHAPE_OPTIMIZER_LRU_SIZE];
+    for (U32 Position = 0; Position < SHAPE_OPTIMIZER_LRU_SIZE; Position++) {
+        CacheScores[Position] = Position < 3 ? LastTriangleScore
+                                             : powf(1.f - (F32)(Position - 3) / (F32)(SHAPE_OPTIMIZER_LRU_SIZE - 3), CacheDecayPower);
+    }
+    F32 ValenceScores[SHAPE_OPTIMIZER_MAX_VALENCE + 1];
+    ValenceScores[0] = 0.f;
+    for (U32 Valence = 1; Valence <= SHAPE_OPTIMIZER_MAX_VALENCE; Valence++) {
+        ValenceScores[Valence] = ValenceBoostScale * powf((F32)Valence, -ValenceBoostPower);
+    }
+
+    // Triangles left of each vertex, the emitted ones are swapped out of the vertex ranges.
+    U32* Offsets = calloc((size_t)VertexCount + 1, sizeof *Offsets);
+    U32* Valences = calloc((size_t)VertexCount + 1, sizeof *Valences);
+    for (U32 Index = 0; Index < IndexCount; Index++) {
+        Valences[Indices[Index]]++;
+    }
+    for (U32 Vertex = 0; Vertex < VertexCount; Vertex++) {
+        Offsets[Vertex + 1] = Offsets[Vertex] + Valences[Vertex];
+        Valences[Vertex] = 0;
+    }
+    U32* Adjacency = malloc((size_t)IndexCount * sizeof *Adjacency);
+    for (U32 Index = 0; Index < IndexCount; Index++) {
+        const U32 Vertex = Indices[Index];
+        Adjacency[Offsets[Vertex] + Valences[Vertex]++] = Index / 3;
+    }
+
+    I32* CachePositions = malloc(((size_t)VertexCount + 1) * sizeof *CachePositions);
+    F32* VertexScores = malloc(((size_t)VertexCount + 1) * sizeof *VertexScores);
+    for (U32 Vertex = 0; Vertex < VertexCount; Vertex++) {
+        CachePositions[Vertex] = -1;
+        VertexScores[Vertex] = ShapeOptimizer_GetVertexScore(CacheScores, ValenceScores, -1, Valences[Vertex]);
+    }
+
+    F32* TriangleScores = malloc((size_t)TriangleCount * sizeof *TriangleScores);
+    Byte* Emitted = calloc(TriangleCount, sizeof *Emitted);
+    for (U32 Triangle = 0; Triangle < TriangleCount; Triangle++) {
+        const U32* Corners = &Indices[Triangle * 3];
+        TriangleScores[Triangle] = VertexScores[Corners[0]] + VertexScores[Corners[1]] + VertexScores[Corners[2]];
+    }
+
+    U32* Output = malloc((size_t)IndexCount * sizeof *Output);
+    U32 Cache[SHAPE_OPTIMIZER_LRU_SIZE + 3];
+    U32 CacheCount = 0;
+    U32 Cursor = 0;
+    U32 Best = InvalidId;
+
+    for (U32 Emit = 0; Emit < TriangleCount; Emit++) {
+        // Nothing left around the cache, continue with the first triangle left in the input order.
+        if (Best == InvalidId) {
+            while (Emitted[Cursor]) {
+                Cursor++;
+            }
+            Best = Cursor;
+        }
+
+        const U32* Corners = &Indices[Best * 3];
+        memcpy(&Output[Emit * 3], Corners, 3 * sizeof *Output);
+        Emitted[Best] = 1;
+
+        for (U32 Corner = 0; Corner < 3; Corner++) {
+            const U32 Vertex = Corners[Corner];
+            U32* Triangles = &Adjacency[Offsets[Vertex]];
+            for (U32 Slot = 0; Slot < Valences[Vertex]; Slot++) {
+                if (Triangles[Slot] == Best) {
+                    Triangles[Slot] = Triangles[--Valences[Vertex]];
+                    break;
+                }
+            }
+        }
+
+        // The triangle's vertices move to the front of the cache, the rest shift back and the last fall out.
+        U32 NewCache[SHAPE_OPTIMIZER_LRU_SIZE + 3];
+        U32 NewCount = 0;
+        for (U32 Corner = 0; Corner < 3; Corner++) {
+            const U32 Vertex = Corners[Corner];
+            if ((Corner < 1 || Vertex != Corners[0]) && (Corner < 2 || Vertex != Corners[1])) {
+                NewCache[NewCount++] = Vertex;
+            }
+        }
+        for (U32 Position = 0; Position < CacheCount; Position++) {
+            const U32 Vertex = Cache[Position];
+            if (Vertex != Corners[0] && Vertex != Corners[1] && Vertex != Corners[2]) {
+                NewCache[NewCount++] = Vertex;
+            }
+        }
+
+        // Rescore the vertices that moved and their triangles, the best of them is emitted next.
+        Best = InvalidId;
+        F32 BestScore = -1.f;
+        for (U32 Position = 0; Position < NewCount; Position++) {
+            const U32 Vertex = NewCache[Position];
+            const I32 CachePosition = Position < SHAPE_OPTIMIZER_LRU_SIZE ? (I32)Position : -1;
+            CachePositions[Vertex] = CachePosition;
+
+            const F32 Score = ShapeOptimizer_GetVertexScore(CacheScores, ValenceScores, CachePosition, Valences[Vertex]);
+            const F32 Delta = Score - VertexScores[Vertex];
+            VertexScores[Vertex] = Score;
+
+            const U32* Triangles = &Adjacency[Offsets[Vertex]];
+            for (U32 Slot = 0; Slot < Valences[Vertex]; Slot++) {
+                const U32 Triangle = Triangles[Slot];
+                TriangleScores[Triangle] += Delta;
+                if (CachePosition >= 0 && TriangleScores[Triangle] > BestScore) {
+                    BestScore = TriangleScores[Triangle];
+                    Best = Triangle;
+                }
+            }
+        }
+
+        CacheCount = NewCount < SHAPE_OPTIMIZER_LRU_SIZE ? NewCount : SHAPE_OPTIMIZER_LRU_SIZE;
+        memcpy(Cache, NewCache, CacheCount * sizeof *Cache);
+    }
+
+    memcpy(Indices, Output, (size_t)IndexCount * sizeof *Indices);
+
+    free(Output);
+    free(Emitted);
+    free(TriangleScores);
+    free(VertexScores);
+    free(CachePositions);
+    free(Adjacency);
+    free(Valences);
+    free(Offsets);
+}
+#pragma endregion
@@ -0,0 +1,48 @@
+#pragma once
+#include "typedefs.h"
+#include "containers/vector.h"
+#include "shape.h"
+
+/**
+ * Post-processing of triangle meshes before upload, for shapes that come from outside the mesher. Duplicate vertices are
+ * welded, triangles are reordered for the post-transform vertex cache (Forsyth's linear-speed optimization) and
+ * vertices are reordered into the order the triangles first use them, so vertex fetches walk memory forward. Shapes
+ * may come in with 16-bit or 32-bit indices, they go out with 16-bit indices whenever the vertices fit.
+ */
+
+typedef struct {
+    /** Merges vertices whose attributes are bitwise equal. */
+    Bool bWeld;
+    /** Reorders triangles for the vertex cache. */
+    Bool bReorderTriangles;
+    /** Reorders vertices by first use, dropping unused ones. */
+    Bool bReorderVertices;
+    /** Entries of the FIFO cache the ACMR is measured with. */
+    U32 CacheSize;
+} FShapeOptimizerSettings;
+
+typedef struct {
+    U32 Triangles;
+    U32 VerticesBefore;
+    U32 VerticesAfter;
+    /** Average cache miss ratio, vertices transformed per triangle, 0.5 at best for large grids and 3 at worst. */
+    F32 AcmrBefore;
+    F32 AcmrAfter;
+    /** True if the vertices didn't fit 16-bit indices. */
+    Bool bWideIndices;
+} FShapeOptimizerStats;
+
+void ShapeOptimizer_GetDefaultSettings(FShapeOptimizerSettings* OutSettings);
+
+/** Optimizes the triangle list of the shape in place. Stats are optional. */
+void ShapeOptimizer_Optimize(FShape* Shape, const FShapeOptimizerSettings* Settings, FShapeOptimizerStats* OutStats);
+
+/**
+ * Splits a shape with 32-bit indices into shapes with 16-bit indices, for targets without 32-bit index buffers. Shapes
+ * are appended to the vector, triangles keep their order so an optimized shape stays cache friendly. Vertices shared by
+ * triangles of two parts are duplicated. Returns the number of shapes appended.
+ */
+U32 ShapeOptimizer_Split(const FShape* Shape, FVector(FShape)* OutShapes);
+
+/** Returns the average cache miss ratio of drawing the shape through a FIFO vertex cache of the size. */
+F32 ShapeOptimizer_GetAcmr(const FShape* Shape, U32 CacheSize);
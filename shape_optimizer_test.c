@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "check.h"
+#include "shape_optimizer.h"
+
+#pragma region Private Function Declarations
+static void ShapeOptimizerTest_AddGrid(FShape* Shape, U32 Size, Bool bShareCorners);
+static void ShapeOptimizerTest_AddTriangle(FShape* Shape, U32 First, U32 Second, U32 Third);
+static U64 ShapeOptimizerTest_GetTriangleSum(const FShape* Shape);
+static void ShapeOptimizerTest_Check(FShape* Shape, Bool bWide, U32 VertexCount);
+#pragma endregion
+
+int main() {
+    // Welding the corners of every triangle brings 86400 vertices under the 16-bit limit.
+    FShape Shape = {0};
+    ShapeOptimizerTest_AddGrid(&Shape, 120, False);
+    CHECK(Shape_GetVertexCount(&Shape) > SHAPE_MAX_SHORT_VERTICES && !FVector_IsEmpty(Shape.Indices32));
+    ShapeOptimizerTest_Check(&Shape, False, 121 * 121);
+    Shape_Free(&Shape);
+
+    // Exactly as many vertices as 16-bit indices address still narrows.
+    ShapeOptimizerTest_AddGrid(&Shape, 255, True);
+    CHECK(Shape_GetVertexCount(&Shape) == SHAPE_MAX_SHORT_VERTICES);
+    ShapeOptimizerTest_Check(&Shape, False, SHAPE_MAX_SHORT_VERTICES);
+    Shape_Free(&Shape);
+
+    // One vertex more keeps the 32-bit indices.
+    ShapeOptimizerTest_AddGrid(&Shape, 255, True);
+    FVector_Add(Shape.Vertices, -1.f);
+    FVector_Add(Shape.Vertices, 0.f);
+    FVector_Add(Shape.Vertices, -1.f);
+    ShapeOptimizerTest_AddTriangle(&Shape, SHAPE_MAX_SHORT_VERTICES, 0, 256);
+    ShapeOptimizerTest_Check(&Shape, True, SHAPE_MAX_SHORT_VERTICES + 1);
+    Shape_Free(&Shape);
+
+    // Small shapes with 32-bit indices narrow without welding.
+    ShapeOptimizerTest_AddGrid(&Shape, 8, True);
+    ShapeOptimizerTest_Check(&Shape, False, 9 * 9);
+
+    // Shapes coming in with 16-bit indices stay 16-bit.
+    ShapeOptimizerTest_Check(&Shape, False, 9 * 9);
+    Shape_Free(&Shape);
+
+    printf("shape_optimizer_test passed\n");
+    return 0;
+}
+
+#pragma region Private Function Definitions
+void ShapeOptimizerTest_AddGrid(FShape* Shape, const U32 Size, const Bool bShareCorners) {
+    static const U32 QuadCorners[6][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 0}, {1, 1}, {0, 1}};
+
+    // Vectors grow by one element per add, the whole grid is reserved up front.
+    const U32 QuadCount = Size * Size;
+    FVector_Reserve(Shape->Vertices, (bShareCorners ? (Size + 1) * (Size + 1) : QuadCount * 6) * 3 + 3);
+    FVector_Reserve(Shape->Indices32, QuadCount * 6 + 3);
+
+    if (bShareCorners) {
+        for (U32 Z = 0; Z <= Size; Z++) {
+            for (U32 X = 0; X <= Size; X++) {
+                FVector_Add(Shape->Vertices, (F32)X);
+                FVector_Add(Shape->Vertices, (F32)((X * 7 + Z * 3) % 5));
+                FVector_Add(Shape->Vertices, (F32)Z);
+            }
+        }
+    }
+
+    // Quads in a scrambled order, so the cache reordering has work to do.
+    for (U32 Step = 0; Step < QuadCount; Step++) {
+        const U32 Quad = (U32)(((U64)Step * 7919u) % QuadCount);
+        for (U32 Triangle = 0; Triangle < 2; Triangle++) {
+            U32 Corners[3];
+            for (U32 Corner = 0; Corner < 3; Corner++) {
+                const U32 X = Quad % Size + QuadCorners[Triangle * 3 + Corner][0];
+                const U32 Z = Quad / Size + QuadCorners[Triangle * 3 + Corner][1];
+                if (bShareCorners) {
+                    Corners[Corner] = Z * (Size + 1) + X;
+                } else {
+                    Corners[Corner] = Shape_GetVertexCount(Shape);
+                    FVector_Add(Shape->Vertices, (F32)X);
+                    FVector_Add(Shape->Vertices, (F32)((X * 7 + Z * 3) % 5));
+                    FVector_Add(Shape->Vertices, (F32)Z);
+                }
+            }
+            ShapeOptimizerTest_AddTriangle(Shape, Corners[0], Corners[1], Corners[2]);
+        }
+    }
+}
+
+void ShapeOptimizerTest_AddTriangle(FShape* Shape, const U32 First, const U32 Second, const U32 Third) {
+    FVector_Add(Shape->Indices32, First);
+    FVector_Add(Shape->Indices32, Second);
+    FVector_Add(Shape->Indices32, Third);
+}
+
+U64 ShapeOptimizerTest_GetTriangleSum(const FShape* Shape) {
+    // Triangles hashed by their corner positions from the smallest corner on, so rotated corners and any triangle order sum the same.
+    const U32 IndexCount = Shape_GetIndexCount(Shape);
+    U64 Sum = 0;
+    for (U32 Index = 0; Index < IndexCount; Index += 3) {
+        U64 Keys[3];
+        for (U32 Corner = 0; Corner < 3; Corner++) {
+            const U32 Vertex = FVector_IsEmpty(Shape->Indices32) ? Shape->Indices[Index + Corner] : Shape->Indices32[Index + Corner];
+            CHECK(Vertex < Shape_GetVertexCount(Shape));
+            const F32* Position = &Shape->Vertices[Vertex * 3];
+            Keys[Corner] = (U64)(I64)(Position[0] + 1.f) << 40 | (U64)Position[1] << 20 | (U64)(I64)(Position[2] + 1.f);
+        }
+
+        const U32 Lowest = Keys[0] <= Keys[1] && Keys[0] <= Keys[2] ? 0 : Keys[1] <= Keys[2] ? 1 : 2;
+        U64 Hash = 0xCBF29CE484222325ull;
+        for (U32 Corner = 0; Corner < 3; Corner++) {
+            Hash = (Hash ^ Keys[(Lowest + Corner) % 3]) * 0x100000001B3ull;
+        }
+        Sum += Hash;
+    }
+
+    return Sum;
+}
+
+void ShapeOptimizerTest_Check(FShape* Shape, const Bool bWide, const U32 VertexCount) {
+    const U32 IndexCount = Shape_GetIndexCount(Shape);
+    const U64 TriangleSum = ShapeOptimizerTest_GetTriangleSum(Shape);
+
+    FShapeOptimizerSettings Settings;
+    ShapeOptimizer_GetDefaultSettings(&Settings);
+    FShapeOptimizerStats Stats;
+    ShapeOptimizer_Optimize(Shape, &Settings, &Stats);
+
+    // Indices are 16-bit exactly when the remaining vertices fit them, the other index vector is left empty.
+    CHECK(Stats.bWideIndices == bWide);
+    CHECK(Stats.VerticesAfter == VertexCount && Shape_GetVertexCount(Shape) == VertexCount);
+    CHECK(Stats.Triangles * 3 == IndexCount && Shape_GetIndexCount(Shape) == IndexCount);
+    if (bWide) {
+        CHECK(FVector_IsEmpty(Shape->Indices) && FVector_GetSize(Shape->Indices32) == IndexCount);
+    } else {
+        CHECK(FVector_IsEmpty(Shape->Indices32) && FVector_GetSize(Shape->Indices) == IndexCount);
+    }
+
+    // The narrowed indices draw the same triangles.
+    CHECK(ShapeOptimizerTest_GetTriangleSum(Shape) == TriangleSum);
+    CHECK(Stats.AcmrAfter <= Stats.AcmrBefore);
+}
+#pragma endregion
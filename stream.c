@@ -0,0 +1,1304 @@
+#include "stream.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cell.h"
+#include "clock.h"
+#include "connectivity.h"
+#include "containers/vector.h"
+#include "light.h"
+#include "mesher.h"
+#include "region.h"
+#include "terrain.h"
+#include "thread.h"
+
+#pragma region Settings
+/** Priority multiplier of chunks right behind the camera over chunks right in front of it at the same distance. */
+#define STREAM_BEHIND_PRIORITY_SCALE 3.f
+/** Queues are reprioritized when the camera turns further than this, as the cosine of the angle. */
+#define STREAM_REPRIORITIZE_COSINE 0.97f
+/** Region files kept open by the workers. */
+#define STREAM_MAX_OPEN_REGIONS 8
+/** Maximum number of worker threads. */
+#define STREAM_MAX_WORKERS 16
+#pragma endregion
+
+typedef enum {
+    STREAM_CHUNK_LOADING = 0,
+    STREAM_CHUNK_LOADED,
+    STREAM_CHUNK_MESHING,
+    STREAM_CHUNK_MESHED,
+    STREAM_CHUNK_UPLOADED,
+    STREAM_CHUNK_SAVING
+} EStreamChunkState;
+
+/** Streamed chunk. The chunk is the first member, so records are kept in the record map as chunks. */
+typedef struct {
+    FChunk Chunk;
+    EStreamChunkState State;
+    /** Mesh jobs reading the chunk, pinned chunks aren't evicted. */
+    U32 PinCount;
+    /** Index in FStream.RecordList. */
+    U32 Index;
+    /** Last update the chunk was in the loaded range, orders the eviction. */
+    U64 LastUsedUpdate;
+    /** The mesh is missing or older than the blocks. */
+    Bool bMeshOutdated;
+    /** The chunk is in the mesh queue, prevents duplicate entries. */
+    Bool bMeshQueued;
+    Bool bModified;
+    Bool bUploaded;
+    /** Sections to remesh after edits, a bit per section. */
+    U8 DirtySections;
+    /** Meshes built by a worker, kept until uploaded. */
+    FShape Shapes[CHUNK_SECTION_COUNT];
+    U64 MeshSize;
+    /** Render data and size returned by the upload handler. */
+    void* RenderData;
+    U64 RenderSize;
+} FStreamChunk;
+
+typedef struct {
+    F32 Priority;
+    I32 X;
+    I32 Y;
+    I32 Z;
+} FStreamQueueItem;
+
+/** Block edit waiting for the workers to release its chunk. */
+typedef struct {
+    I32 X;
+    I32 Y;
+    I32 Z;
+    Byte Type;
+} FStreamEdit;
+
+/** Binary min-heap of chunk positions by priority. Entries are validated when they reach the top. */
+typedef struct {
+    FVector(FStreamQueueItem) Items;
+} FStreamQueue;
+
+typedef enum {
+    STREAM_JOB_LOAD = 0,
+    STREAM_JOB_MESH,
+    STREAM_JOB_SAVE
+} EStreamJobType;
+
+typedef struct {
+    EStreamJobType Type;
+    FStreamChunk* Record;
+    /** Chunks read by a mesh job, pinned until the job is collected. */
+    FChunkNeighbourhood Neighbourhood;
+    Bool bSucceeded;
+} FStreamJob;
+
+/** Bounded job ring. */
+typedef struct {
+    FStreamJob* Jobs;
+    U32 Capacity;
+    U32 Head;
+    U32 Count;
+} FStreamRing;
+
+typedef struct {
+    FRegion* Region;
+    I32 X;
+    I32 Y;
+    I32 Z;
+    U64 LastUsed;
+} FStreamRegion;
+
+struct FStream {
+    FStreamSettings Settings;
+
+    /** Every record by position, stored as chunks. */
+    FWorld* Records;
+    /** Loaded chunks, records being loaded or saved are left out. */
+    FWorld* World;
+    /** Block hierarchy of the loaded chunks, kept up to date by the edits. */
+    FConnectivity* Connectivity;
+    /** Light of the loaded chunks, propagated while no mesh job reads it. */
+    FLight* Light;
+    /** Water and sand of the loaded chunks, ticked while no mesh job reads them. */
+    FCells* Cells;
+    /** Time of the next cell tick, mesh jobs are held back once it has come. */
+    U64 NextCellTick;
+    FVector(FStreamChunk*) RecordList;
+
+    FStreamQueue LoadQueue;
+    FStreamQueue MeshQueue;
+    FStreamQueue UploadQueue;
+    /** Chunks with dirty sections, closest first. */
+    FStreamQueue RemeshQueue;
+    FVector(FStreamEdit) DeferredEdits;
+    U32 DirtySectionCount;
+    /** Section mesh built by the update before it is uploaded. */
+    FShape RemeshShape;
+
+    /** Camera the queues are prioritized for, the position in chunks. */
+    I32 CameraX;
+    I32 CameraY;
+    I32 CameraZ;
+    F32 CameraPosition[3];
+    F32 CameraForward[3];
+    Bool bPrioritized;
+
+    U64 Update;
+    U32 JobsInFlight;
+    U32 MeshJobsInFlight;
+    /** Chunks being meshed or waiting for upload. */
+    U32 PendingUploads;
+    FStreamStats Stats;
+
+    /** Job rings shared with the workers, guarded by the mutex. */
+    FMutex* Mutex;
+    FCondition* JobAvailable;
+    FStreamRing Pending;
+    FStreamRing Finished;
+    Bool bStopping;
+    FThread* Workers[STREAM_MAX_WORKERS];
+    U32 WorkerCount;
+    /** Finished jobs copied out of the ring by the update. */
+    FStreamJob* Collected;
+
+    /** Open region files, guarded by the region mutex. */
+    FMutex* RegionMutex;
+    FStreamRegion Regions[STREAM_MAX_OPEN_REGIONS];
+    U64 RegionUses;
+};
+
+#pragma region Private Function Declarations
+/** Worker thread loop, runs jobs until the stream stops and the pending ring is empty. */
+static int Stream_WorkerMain(void* UserData);
+
+static void Stream_RunJob(FStream* Stream, FStreamJob* Job);
+
+/** Returns the open region of the chunk, opening it if needed. Called with the region mutex locked. */
+static FRegion* Stream_GetRegion(FStream* Stream, const FChunk* Chunk, Bool bCreate);
+
+/** Saves the chunk to its region and flushes the region. */
+static Bool Stream_SaveChunk(FStream* Stream, const FChunk* Chunk);
+
+/** Rebuilds the queues for the current camera. */
+static void Stream_Prioritize(FStream* Stream);
+
+static F32 Stream_GetPriority(const FStream* Stream, I32 X, I32 Y, I32 Z);
+
+/** Returns True if the chunk position is within the streamed range extended by the border. */
+static Bool Stream_IsInRange(const FStream* Stream, I32 X, I32 Y, I32 Z, I32 Border);
+
+/** Returns True if the chunk and all its neighbours are loaded. */
+static Bool Stream_IsNeighbourhoodLoaded(const FStream* Stream, I32 X, I32 Y, I32 Z);
+
+/** Queues the chunk for meshing if its mesh is outdated and it can be meshed. */
+static void Stream_QueueMesh(FStream* Stream, FStreamChunk* Record);
+
+/** Queues the mesh of the chunk and its neighbours, called when the chunk is loaded. */
+static void Stream_QueueNeighbourhoodMeshes(FStream* Stream, const FStreamChunk* Record);
+
+static void Stream_CollectJobs(FStream* Stream);
+
+/** Starts the highest priority load and mesh jobs until the job ring is full. */
+static void Stream_DispatchJobs(FStream* Stream);
+
+/** Returns the top valid load entry, NULL if there is none. */
+static const FStreamQueueItem* Stream_PeekLoad(FStream* Stream);
+
+/** Returns the top valid mesh entry, NULL if there is none or too many meshes wait for upload. */
+static const FStreamQueueItem* Stream_PeekMesh(FStream* Stream);
+
+/** Starts loading the top load entry. Returns False if the budget doesn't allow another chunk. */
+static Bool Stream_StartLoad(FStream* Stream);
+
+static void Stream_StartMesh(FStream* Stream);
+
+static void Stream_Submit(FStream* Stream, const FStreamJob* Job);
+
+/** Applies the block edit and activates the cells around it. */
+static void Stream_ApplyEdit(FStream* Stream, FStreamChunk* Record, const FStreamEdit* Edit);
+
+/** Relinks, relights and marks dirty the sections touching a block whose type changed. */
+static void Stream_OnBlockChanged(FStream* Stream, FStreamChunk* Record, I32 X, I32 Y, I32 Z, Byte PreviousType);
+
+/** Handles a block moved by the cells like an edit. */
+static void Stream_OnCellChanged(FChunk* Chunk, I32 X, I32 Y, I32 Z, Byte PreviousType, void* UserData);
+
+/** Returns True when active cells wait and the tick time has come. */
+static Bool Stream_IsCellTickDue(const FStream* Stream);
+
+/** Marks the chunk relinked by the connectivity as modified so it is saved. */
+static void Stream_OnConnectivityChanged(FChunk* Chunk, void* UserData);
+
+/** Marks the sections showing the changed light dirty. Light isn't saved, the chunk stays unmodified. */
+static void Stream_OnLightChanged(FChunk* Chunk, const I32 Min[3], const I32 Max[3], void* UserData);
+
+/** Applies the deferred edits of chunks no longer read by the workers. */
+static void Stream_ApplyDeferredEdits(FStream* Stream);
+
+/** Marks the sections touching the block box dirty, the box bounds are inclusive world block positions. */
+static void Stream_MarkDirty(FStream* Stream, I32 MinX, I32 MinY, I32 MinZ, I32 MaxX, I32 MaxY, I32 MaxZ);
+
+static void Stream_ClearDirtySections(FStream* Stream, FStreamChunk* Record);
+
+/** Remeshes dirty sections of uploaded chunks on the updating thread, closest chunks first. */
+static void Stream_RemeshSections(FStream* Stream);
+
+/** Uploads the highest priority meshes within the per update limits. */
+static void Stream_UploadMeshes(FStream* Stream);
+
+/** Evicts the least recently used chunk out of range. Returns False if no chunk can be evicted. */
+static Bool Stream_EvictOne(FStream* Stream);
+
+/** Releases the render data and meshes of the record. */
+static void Stream_ReleaseMeshes(FStream* Stream, FStreamChunk* Record);
+
+/** Removes the record and frees its memory. */
+static void Stream_FreeRecord(FStream* Stream, FStreamChunk* Record);
+
+static U64 Stream_GetMeshSize(const FShape Shapes[CHUNK_SECTION_COUNT]);
+
+static void Stream_PushQueue(FStreamQueue* Queue, FStreamQueueItem Item);
+
+static void Stream_PopQueue(FStreamQueue* Queue);
+
+static void Stream_PushRing(FStreamRing* Ring, const FStreamJob* Job);
+
+static void Stream_PopRing(FStreamRing* Ring, FStreamJob* OutJob);
+#pragma endregion
+
+#pragma region Public Function Definitions
+void Stream_GetDefaultSettings(FStreamSettings* OutSettings) {
+    *OutSettings = (FStreamSettings){0};
+    OutSettings->Radius = 4;
+    OutSettings->VerticalRadius = 2;
+    OutSettings->MemoryBudget = 256ull << 20;
+    OutSettings->MaxUploadsPerUpdate = 4;
+    OutSettings->MaxUploadBytesPerUpdate = 4ull << 20;
+    OutSettings->MaxRemeshSectionsPerUpdate = 32;
+    OutSettings->QueueCapacity = 32;
+    OutSettings->CellTickSeconds = 0.1f;
+    OutSettings->MaxCellsPerTick = 4096;
+}
+
+FStream* Stream_Create(const FStreamSettings* Settings) {
+    FStream* Stream = calloc(1, sizeof *Stream);
+    if (Stream == NULL) {
+        return NULL;
+    }
+
+    Stream->Settings = *Settings;
+    if (Stream->Settings.QueueCapacity == 0) {
+        Stream->Settings.QueueCapacity = 1;
+    }
+
+    const U32 Capacity = Stream->Settings.QueueCapacity;
+    Stream->Records = World_Create();
+    Stream->World = World_Create();
+    Stream->Connectivity = Connectivity_Create(Stream->World, Stream_OnConnectivityChanged, Stream);
+    Stream->Mutex = Mutex_Create();
+    Stream->JobAvailable = Condition_Create();
+    Stream->RegionMutex = Mutex_Create();
+    Stream->Pending = (FStreamRing){calloc(Capacity, sizeof(FStreamJob)), Capacity, 0, 0};
+    Stream->Finished = (FStreamRing){calloc(Capacity, sizeof(FStreamJob)), Capacity, 0, 0};
+    Stream->Collected = calloc(Capacity, sizeof(FStreamJob));
+    if (Stream->Records == NULL || Stream->World == NULL || Stream->Connectivity == NULL || Stream->Mutex == NULL || Stream->JobAvailable == NULL || Stream->RegionMutex == NULL ||
+        Stream->Pending.Jobs == NULL || Stream->Finished.Jobs == NULL || Stream->Collected == NULL) {
+        Stream_Destroy(Stream);
+        return NULL;
+    }
+
+    U32 WorkerCount = Stream->Settings.WorkerCount;
+    if (WorkerCount == 0) {
+        const U32 ProcessorCount = Thread_GetProcessorCount();
+        WorkerCount = ProcessorCount > 1 ? ProcessorCount - 1 : 1;
+    }
+    if (WorkerCount > STREAM_MAX_WORKERS) {
+        WorkerCount = STREAM_MAX_WORKERS;
+    }
+
+    for (U32 Index = 0; Index < WorkerCount; Index++) {
+        Stream->Workers[Index] = Thread_Create(Stream_WorkerMain, "Stream", Stream);
+        if (Stream->Workers[Index] == NULL) {
+            fprintf(stderr, "Failed to start stream worker %u\n", Index);
+            break;
+        }
+        Stream->WorkerCount++;
+    }
+
+    if (Stream->WorkerCount == 0) {
+        Stream_Destroy(Stream);
+        return NULL;
+    }
+
+    // Light is propagated while the stream workers are idle, it gets as many threads.
+    Stream->Light = Light_Create(Stream->World, Stream->WorkerCount, Stream_OnLightChanged, Stream);
+    if (Stream->Light == NULL) {
+        Stream_Destroy(Stream);
+        return NULL;
+    }
+
+    Stream->Cells = Cells_Create(Stream->World, Stream->Settings.MaxCellsPerTick, Stream->WorkerCount, Stream_OnCellChanged, Stream);
+    if (Stream->Cells == NULL) {
+        Stream_Destroy(Stream);
+        return NULL;
+    }
+
+    Stream->Stats.MemoryBudget = Stream->Settings.MemoryBudget;
+
+    return Stream;
+}
+
+void Stream_Destroy(FStream* Stream) {
+    if (Stream == NULL) {
+        return;
+    }
+
+    // Workers drain the pending ring before they exit, so every started job is finished after the join.
+    if (Stream->Mutex != NULL && Stream->JobAvailable != NULL) {
+        Mutex_Lock(Stream->Mutex);
+        Stream->bStopping = True;
+        Condition_Broadcast(Stream->JobAvailable);
+        Mutex_Unlock(Stream->Mutex);
+    }
+
+    for (U32 Index = 0; Index < Stream->WorkerCount; Index++) {
+        Thread_Join(Stream->Workers[Index]);
+    }
+
+    // No worker reads the chunks anymore, deferred edits are applied so they are saved.
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->DeferredEdits); Index++) {
+        const FStreamEdit* Edit = &Stream->DeferredEdits[Index];
+        FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, World_GetChunkCoordinate(Edit->X), World_GetChunkCoordinate(Edit->Y),
+                                                             World_GetChunkCoordinate(Edit->Z));
+        if (Record != NULL) {
+            Stream_ApplyEdit(Stream, Record, Edit);
+        }
+    }
+
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->RecordList); Index++) {
+        FStreamChunk* Record = Stream->RecordList[Index];
+        Stream_ReleaseMeshes(Stream, Record);
+
+        // Chunks in the saving state were saved by their finished job.
+        if (Record->bModified && Record->State != STREAM_CHUNK_SAVING && Stream->Settings.RegionDirectory != NULL) {
+            Stream_SaveChunk(Stream, &Record->Chunk);
+        }
+
+        free(Record);
+    }
+
+    for (U32 Index = 0; Index < STREAM_MAX_OPEN_REGIONS; Index++) {
+        Region_Close(Stream->Regions[Index].Region);
+    }
+
+    FVector_Free(Stream->RecordList);
+    FVector_Free(Stream->LoadQueue.Items);
+    FVector_Free(Stream->MeshQueue.Items);
+    FVector_Free(Stream->UploadQueue.Items);
+    FVector_Free(Stream->RemeshQueue.Items);
+    FVector_Free(Stream->DeferredEdits);
+    Shape_Free(&Stream->RemeshShape);
+    Cells_Destroy(Stream->Cells);
+    Light_Destroy(Stream->Light);
+    Connectivity_Destroy(Stream->Connectivity);
+    World_Destroy(Stream->Records);
+    World_Destroy(Stream->World);
+    free(Stream->Pending.Jobs);
+    free(Stream->Finished.Jobs);
+    free(Stream->Collected);
+    if (Stream->JobAvailable != NULL) {
+        Condition_Destroy(Stream->JobAvailable);
+    }
+    if (Stream->Mutex != NULL) {
+        Mutex_Destroy(Stream->Mutex);
+    }
+    if (Stream->RegionMutex != NULL) {
+        Mutex_Destroy(Stream->RegionMutex);
+    }
+    free(Stream);
+}
+
+void Stream_Update(FStream* Stream, const F32 CameraPosition[3], const F32 CameraForward[3]) {
+    Stream->Update++;
+    Stream->Stats.Uploads = 0;
+    Stream->Stats.UploadBytes = 0;
+    Stream->Stats.DeferredLoads = 0;
+
+    F32 Forward[3] = {CameraForward[0], CameraForward[1], CameraForward[2]};
+    const F32 Length = sqrtf(Forward[0] * Forward[0] + Forward[1] * Forward[1] + Forward[2] * Forward[2]);
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        Forward[Axis] = Length > 0.f ? Forward[Axis] / Length : 0.f;
+    }
+
+    const I32 CameraX = (I32)floorf(CameraPosition[0] / CHUNK_SIZE);
+    const I32 CameraY = (I32)floorf(CameraPosition[1] / CHUNK_SIZE);
+    const I32 CameraZ = (I32)floorf(CameraPosition[2] / CHUNK_SIZE);
+    const F32 Turn = Forward[0] * Stream->CameraForward[0] + Forward[1] * Stream->CameraForward[1] + Forward[2] * Stream->CameraForward[2];
+
+    // Queues are only rebuilt when the camera enters another chunk or turns, not every frame.
+    if (!Stream->bPrioritized || CameraX != Stream->CameraX || CameraY != Stream->CameraY || CameraZ != Stream->CameraZ ||
+        Turn < STREAM_REPRIORITIZE_COSINE) {
+        Stream->CameraX = CameraX;
+        Stream->CameraY = CameraY;
+        Stream->CameraZ = CameraZ;
+        for (U32 Axis = 0; Axis < 3; Axis++) {
+            Stream->CameraPosition[Axis] = CameraPosition[Axis] / CHUNK_SIZE;
+            Stream->CameraForward[Axis] = Forward[Axis];
+        }
+        Stream_Prioritize(Stream);
+        Stream->bPrioritized = True;
+    }
+
+    Stream_CollectJobs(Stream);
+    Stream_ApplyDeferredEdits(Stream);
+
+    // Mesh jobs read the blocks and light of their chunks, they change once the jobs are all collected. Cells tick first,
+    // the blocks they move are relit by the same update.
+    Stream->Stats.CellNanoseconds = 0;
+    if (Stream->MeshJobsInFlight == 0 && Stream_IsCellTickDue(Stream)) {
+        FCellStats CellStats;
+        Cells_Tick(Stream->Cells);
+        Cells_GetStats(Stream->Cells, &CellStats);
+        Stream->Stats.CellNanoseconds = CellStats.Nanoseconds;
+        Stream->NextCellTick = Clock_GetNanoseconds() + (U64)(Stream->Settings.CellTickSeconds * 1e9f);
+    }
+
+    Stream->Stats.LightNanoseconds = 0;
+    if (Stream->MeshJobsInFlight == 0 && Light_IsPending(Stream->Light)) {
+        FLightStats LightStats;
+        Light_Update(Stream->Light);
+        Light_GetStats(Stream->Light, &LightStats);
+        Stream->Stats.LightNanoseconds = LightStats.Nanoseconds;
+    }
+
+    // Meshes grow the memory after their chunks were admitted, trim back to the budget.
+    while (Stream->Stats.MemoryUsed > Stream->Settings.MemoryBudget && Stream_EvictOne(Stream)) {
+    }
+
+    Stream_DispatchJobs(Stream);
+    Stream_UploadMeshes(Stream);
+    Stream_RemeshSections(Stream);
+
+    Stream->Stats.ResidentChunks = (U32)FVector_GetSize(Stream->RecordList);
+    Stream->Stats.LoadQueueDepth = (U32)FVector_GetSize(Stream->LoadQueue.Items);
+    Stream->Stats.MeshQueueDepth = (U32)FVector_GetSize(Stream->MeshQueue.Items);
+    Stream->Stats.UploadQueueDepth = (U32)FVector_GetSize(Stream->UploadQueue.Items);
+    Stream->Stats.JobsInFlight = Stream->JobsInFlight;
+    Stream->Stats.DirtySections = Stream->DirtySectionCount;
+    Stream->Stats.DeferredEdits = (U32)FVector_GetSize(Stream->DeferredEdits);
+
+    FCellStats CellStats;
+    Cells_GetStats(Stream->Cells, &CellStats);
+    Stream->Stats.ActiveCells = CellStats.ActiveCells;
+}
+
+const FWorld* Stream_GetWorld(const FStream* Stream) {
+    return Stream->World;
+}
+
+FConnectivity* Stream_GetConnectivity(FStream* Stream) {
+    return Stream->Connectivity;
+}
+
+Bool Stream_SetBlockType(FStream* Stream, const I32 X, const I32 Y, const I32 Z, const Byte Type) {
+    FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    if (Record == NULL) {
+        return False;
+    }
+
+    const FStreamEdit Edit = {X, Y, Z, Type};
+
+    // Pinned chunks are read by mesh jobs, edits wait until the jobs are collected and keep their order.
+    if (Record->PinCount > 0) {
+        FVector(FStreamEdit) DeferredEdits = Stream->DeferredEdits;
+        FVector_Add(DeferredEdits, Edit);
+        Stream->DeferredEdits = DeferredEdits;
+        return True;
+    }
+
+    Stream_ApplyEdit(Stream, Record, &Edit);
+
+    return True;
+}
+
+void Stream_MarkModified(FStream* Stream, const FChunk* Chunk) {
+    FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, Chunk->X, Chunk->Y, Chunk->Z);
+    if (Record == NULL || &Record->Chunk != Chunk) {
+        return;
+    }
+
+    Record->bModified = True;
+
+    const I32 MinX = Chunk->X * CHUNK_SIZE;
+    const I32 MinY = Chunk->Y * CHUNK_SIZE;
+    const I32 MinZ = Chunk->Z * CHUNK_SIZE;
+    Stream_MarkDirty(Stream, MinX, MinY, MinZ, MinX + CHUNK_SIZE - 1, MinY + CHUNK_SIZE - 1, MinZ + CHUNK_SIZE - 1);
+}
+
+void Stream_VisitUploaded(const FStream* Stream, const StreamChunkVisitor Visitor, void* UserData) {
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->RecordList); Index++) {
+        const FStreamChunk* Record = Stream->RecordList[Index];
+        if (Record->bUploaded) {
+            Visitor(&Record->Chunk, Record->RenderData, UserData);
+        }
+    }
+}
+
+Bool Stream_IsIdle(const FStream* Stream) {
+    // An update starts every job it can, so nothing in flight after an update means nothing is left to start.
+    return Stream->bPrioritized && Stream->JobsInFlight == 0 && Stream->PendingUploads == 0;
+}
+
+void Stream_GetStats(const FStream* Stream, FStreamStats* OutStats) {
+    *OutStats = Stream->Stats;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+int Stream_WorkerMain(void* UserData) {
+    FStream* Stream = UserData;
+
+    Mutex_Lock(Stream->Mutex);
+    for (;;) {
+        while (Stream->Pending.Count == 0 && !Stream->bStopping) {
+            Condition_Wait(Stream->JobAvailable, Stream->Mutex);
+        }
+
+        if (Stream->Pending.Count == 0) {
+            break;
+        }
+
+        FStreamJob Job;
+        Stream_PopRing(&Stream->Pending, &Job);
+        Mutex_Unlock(Stream->Mutex);
+
+        Stream_RunJob(Stream, &Job);
+
+        Mutex_Lock(Stream->Mutex);
+        Stream_PushRing(&Stream->Finished, &Job);
+    }
+    Mutex_Unlock(Stream->Mutex);
+
+    return 0;
+}
+
+void Stream_RunJob(FStream* Stream, FStreamJob* Job) {
+    FChunk* Chunk = &Job->Record->Chunk;
+
+    switch (Job->Type) {
+    case STREAM_JOB_LOAD: {
+        Bool bLoaded = False;
+        if (Stream->Settings.RegionDirectory != NULL) {
+            Mutex_Lock(Stream->RegionMutex);
+            FRegion* Region = Stream_GetRegion(Stream, Chunk, False);
+            if (Region != NULL && Region_HasChunk(Region, Chunk->X, Chunk->Y, Chunk->Z)) {
+                bLoaded = Region_LoadChunk(Region, Chunk->X, Chunk->Y, Chunk->Z, Chunk);
+            }
+            Mutex_Unlock(Stream->RegionMutex);
+        }
+
+        // Chunks never saved, or saved chunks failing to load, are generated again.
+        if (!bLoaded) {
+            Terrain_Generate(Chunk, Stream->Settings.Seed);
+        }
+        Light_ComputeChunk(Chunk);
+        Job->bSucceeded = True;
+        break;
+    }
+
+    case STREAM_JOB_MESH:
+        if (Stream->Settings.bFaceRecords) {
+            Mesher_BuildChunkFaces(&Job->Neighbourhood, Job->Record->Shapes);
+        } else {
+            Mesher_BuildChunk(&Job->Neighbourhood, Job->Record->Shapes);
+        }
+        Job->bSucceeded = True;
+        break;
+
+    case STREAM_JOB_SAVE:
+        Job->bSucceeded = Stream_SaveChunk(Stream, Chunk);
+        break;
+    }
+}
+
+FRegion* Stream_GetRegion(FStream* Stream, const FChunk* Chunk, const Bool bCreate) {
+    const I32 RegionX = Region_GetCoordinate(Chunk->X);
+    const I32 RegionY = Region_GetCoordinate(Chunk->Y);
+    const I32 RegionZ = Region_GetCoordinate(Chunk->Z);
+
+    FStreamRegion* Slot = &Stream->Regions[0];
+    for (U32 Index = 0; Index < STREAM_MAX_OPEN_REGIONS; Index++) {
+        FStreamRegion* Open = &Stream->Regions[Index];
+        if (Open->Region != NULL && Open->X == RegionX && Open->Y == RegionY && Open->Z == RegionZ) {
+            Open->LastUsed = ++Stream->RegionUses;
+            return Open->Region;
+        }
+
+        // Reuse an empty slot or the least recently used region.
+        if (Slot->Region != NULL && (Open->Region == NULL || Open->LastUsed < Slot->LastUsed)) {
+            Slot = Open;
+        }
+    }
+
+    char Path[512];
+    Region_GetPath(Stream->Settings.RegionDirectory, RegionX, RegionY, RegionZ, Path, sizeof Path);
+
+    // Loads don't create files for regions nothing was saved to.
+    if (!bCreate) {
+        FILE* File = fopen(Path, "rb");
+        if (File == NULL) {
+            return NULL;
+        }
+        fclose(File);
+    }
+
+    FRegion* Region = Region_Open(Path, RegionX, RegionY, RegionZ);
+    if (Region == NULL) {
+        return NULL;
+    }
+
+    Region_Close(Slot->Region);
+    *Slot = (FStreamRegion){Region, RegionX, RegionY, RegionZ, ++Stream->RegionUses};
+
+    return Region;
+}
+
+Bool Stream_SaveChunk(FStream* Stream, const FChunk* Chunk) {
+    Mutex_Lock(Stream->RegionMutex);
+    FRegion* Region = Stream_GetRegion(Stream, Chunk, True);
+    const Bool bSaved = Region != NULL && Region_SaveChunk(Region, Chunk, REGION_COMPRESSION_FAST) && Region_Flush(Region);
+    Mutex_Unlock(Stream->RegionMutex);
+
+    if (!bSaved) {
+        fprintf(stderr, "Failed to save chunk %d %d %d\n", Chunk->X, Chunk->Y, Chunk->Z);
+    }
+
+    return bSaved;
+}
+
+void Stream_Prioritize(FStream* Stream) {
+    FVector_Clear(Stream->LoadQueue.Items);
+    FVector_Clear(Stream->MeshQueue.Items);
+    FVector_Clear(Stream->UploadQueue.Items);
+
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->RecordList); Index++) {
+        FStreamChunk* Record = Stream->RecordList[Index];
+        const FChunk* Chunk = &Record->Chunk;
+        if (Stream_IsInRange(Stream, Chunk->X, Chunk->Y, Chunk->Z, 1)) {
+            Record->LastUsedUpdate = Stream->Update;
+        }
+
+        Record->bMeshQueued = False;
+        if (Record->State == STREAM_CHUNK_MESHED) {
+            Stream_PushQueue(&Stream->UploadQueue, (FStreamQueueItem){Stream_GetPriority(Stream, Chunk->X, Chunk->Y, Chunk->Z), Chunk->X, Chunk->Y, Chunk->Z});
+        }
+    }
+
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->RecordList); Index++) {
+        Stream_QueueMesh(Stream, Stream->RecordList[Index]);
+    }
+
+    const I32 Radius = Stream->Settings.Radius + 1;
+    const I32 VerticalRadius = Stream->Settings.VerticalRadius + 1;
+    for (I32 Y = Stream->CameraY - VerticalRadius; Y <= Stream->CameraY + VerticalRadius; Y++) {
+        for (I32 Z = Stream->CameraZ - Radius; Z <= Stream->CameraZ + Radius; Z++) {
+            for (I32 X = Stream->CameraX - Radius; X <= Stream->CameraX + Radius; X++) {
+                if (World_GetChunk(Stream->Records, X, Y, Z) == NULL) {
+                    Stream_PushQueue(&Stream->LoadQueue, (FStreamQueueItem){Stream_GetPriority(Stream, X, Y, Z), X, Y, Z});
+                }
+            }
+        }
+    }
+}
+
+F32 Stream_GetPriority(const FStream* Stream, const I32 X, const I32 Y, const I32 Z) {
+    const F32 DX = (F32)X + 0.5f - Stream->CameraPosition[0];
+    const F32 DY = (F32)Y + 0.5f - Stream->CameraPosition[1];
+    const F32 DZ = (F32)Z + 0.5f - Stream->CameraPosition[2];
+    const F32 Distance = sqrtf(DX * DX + DY * DY + DZ * DZ);
+    if (Distance < 1.f) {
+        return Distance;
+    }
+
+    // Scale the distance from 1 in front of the camera up to STREAM_BEHIND_PRIORITY_SCALE behind it.
+    const F32* Forward = Stream->CameraForward;
+    const F32 Cosine = (DX * Forward[0] + DY * Forward[1] + DZ * Forward[2]) / Distance;
+
+    return Distance * (1.f + (STREAM_BEHIND_PRIORITY_SCALE - 1.f) * (1.f - Cosine) * 0.5f);
+}
+
+Bool Stream_IsInRange(const FStream* Stream, const I32 X, const I32 Y, const I32 Z, const I32 Border) {
+    return abs(X - Stream->CameraX) <= Stream->Settings.Radius + Border && abs(Z - Stream->CameraZ) <= Stream->Settings.Radius + Border &&
+           abs(Y - Stream->CameraY) <= Stream->Settings.VerticalRadius + Border;
+}
+
+Bool Stream_IsNeighbourhoodLoaded(const FStream* Stream, const I32 X, const I32 Y, const I32 Z) {
+    for (I32 Index = 0; Index < 27; Index++) {
+        if (World_GetChunk(Stream->World, X + Index % 3 - 1, Y + Index / 9 - 1, Z + Index / 3 % 3 - 1) == NULL) {
+            return False;
+        }
+    }
+
+    return True;
+}
+
+void Stream_QueueMesh(FStream* Stream, FStreamChunk* Record) {
+    const FChunk* Chunk = &Record->Chunk;
+    if (!Record->bMeshOutdated || Record->bMeshQueued || (Record->State != STREAM_CHUNK_LOADED && Record->State != STREAM_CHUNK_UPLOADED) ||
+        !Stream_IsInRange(Stream, Chunk->X, Chunk->Y, Chunk->Z, 0) || !Stream_IsNeighbourhoodLoaded(Stream, Chunk->X, Chunk->Y, Chunk->Z)) {
+        return;
+    }
+
+    Record->bMeshQueued = True;
+    Stream_PushQueue(&Stream->MeshQueue, (FStreamQueueItem){Stream_GetPriority(Stream, Chunk->X, Chunk->Y, Chunk->Z), Chunk->X, Chunk->Y, Chunk->Z});
+}
+
+void Stream_QueueNeighbourhoodMeshes(FStream* Stream, const FStreamChunk* Record) {
+    for (I32 Index = 0; Index < 27; Index++) {
+        FStreamChunk* Neighbour =
+            (FStreamChunk*)World_GetChunk(Stream->World, Record->Chunk.X + Index % 3 - 1, Record->Chunk.Y + Index / 9 - 1, Record->Chunk.Z + Index / 3 % 3 - 1);
+        if (Neighbour != NULL) {
+            Stream_QueueMesh(Stream, Neighbour);
+        }
+    }
+}
+
+void Stream_CollectJobs(FStream* Stream) {
+    Mutex_Lock(Stream->Mutex);
+    const U32 Count = Stream->Finished.Count;
+    for (U32 Index = 0; Index < Count; Index++) {
+        Stream_PopRing(&Stream->Finished, &Stream->Collected[Index]);
+    }
+    Mutex_Unlock(Stream->Mutex);
+
+    for (U32 Index = 0; Index < Count; Index++) {
+        FStreamJob* Job = &Stream->Collected[Index];
+        FStreamChunk* Record = Job->Record;
+        Stream->JobsInFlight--;
+
+        switch (Job->Type) {
+        case STREAM_JOB_LOAD:
+            Record->State = STREAM_CHUNK_LOADED;
+            Record->bMeshOutdated = True;
+            World_AddChunk(Stream->World, &Record->Chunk);
+            Light_AddChunk(Stream->Light, Record->Chunk.X, Record->Chunk.Y, Record->Chunk.Z);
+            Stream->Stats.LoadedChunks++;
+            Stream_QueueNeighbourhoodMeshes(Stream, Record);
+            break;
+
+        case STREAM_JOB_MESH: {
+            for (U32 Neighbour = 0; Neighbour < 27; Neighbour++) {
+                ((FStreamChunk*)Job->Neighbourhood.Chunks[Neighbour])->PinCount--;
+            }
+            Stream->MeshJobsInFlight--;
+
+            const FChunk* Chunk = &Record->Chunk;
+            Record->State = STREAM_CHUNK_MESHED;
+            Record->MeshSize = Stream_GetMeshSize(Record->Shapes);
+            Stream->Stats.MemoryUsed += Record->MeshSize;
+            Stream->Stats.MeshedChunks++;
+            Stream_PushQueue(&Stream->UploadQueue, (FStreamQueueItem){Stream_GetPriority(Stream, Chunk->X, Chunk->Y, Chunk->Z), Chunk->X, Chunk->Y, Chunk->Z});
+            break;
+        }
+
+        case STREAM_JOB_SAVE:
+            Stream_FreeRecord(Stream, Record);
+            break;
+        }
+    }
+}
+
+void Stream_DispatchJobs(FStream* Stream) {
+    while (Stream->JobsInFlight < Stream->Settings.QueueCapacity) {
+        const FStreamQueueItem* Mesh = Stream_PeekMesh(Stream);
+        const FStreamQueueItem* Load = Stream_PeekLoad(Stream);
+
+        if (Mesh != NULL && (Load == NULL || Mesh->Priority <= Load->Priority)) {
+            Stream_StartMesh(Stream);
+        } else if (Load == NULL || !Stream_StartLoad(Stream)) {
+            break;
+        }
+    }
+}
+
+const FStreamQueueItem* Stream_PeekLoad(FStream* Stream) {
+    FStreamQueue* Queue = &Stream->LoadQueue;
+    while (!FVector_IsEmpty(Queue->Items)) {
+        const FStreamQueueItem* Item = &Queue->Items[0];
+        if (World_GetChunk(Stream->Records, Item->X, Item->Y, Item->Z) == NULL && Stream_IsInRange(Stream, Item->X, Item->Y, Item->Z, 1)) {
+            return Item;
+        }
+        Stream_PopQueue(Queue);
+    }
+
+    return NULL;
+}
+
+const FStreamQueueItem* Stream_PeekMesh(FStream* Stream) {
+    // Meshes are built no faster than they are uploaded, and not before a due cell tick and the queued light changes.
+    if (Stream->PendingUploads >= Stream->Settings.QueueCapacity || Light_IsPending(Stream->Light) || Stream_IsCellTickDue(Stream)) {
+        return NULL;
+    }
+
+    FStreamQueue* Queue = &Stream->MeshQueue;
+    while (!FVector_IsEmpty(Queue->Items)) {
+        const FStreamQueueItem* Item = &Queue->Items[0];
+        FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, Item->X, Item->Y, Item->Z);
+        if (Record != NULL) {
+            // The chunk may have been meshed, left the range or lost a neighbour since it was queued.
+            if (Record->bMeshOutdated && (Record->State == STREAM_CHUNK_LOADED || Record->State == STREAM_CHUNK_UPLOADED) &&
+                Stream_IsInRange(Stream, Item->X, Item->Y, Item->Z, 0) && Stream_IsNeighbourhoodLoaded(Stream, Item->X, Item->Y, Item->Z)) {
+                return Item;
+            }
+            Record->bMeshQueued = False;
+        }
+        Stream_PopQueue(Queue);
+    }
+
+    return NULL;
+}
+
+Bool Stream_StartLoad(FStream* Stream) {
+    const FStreamQueueItem Item = Stream->LoadQueue.Items[0];
+
+    // Make room within the budget, the load waits while every resident chunk is in range or busy.
+    while (Stream->Stats.MemoryUsed + sizeof(FStreamChunk) > Stream->Settings.MemoryBudget) {
+        if (!Stream_EvictOne(Stream)) {
+            Stream->Stats.DeferredLoads = (U32)FVector_GetSize(Stream->LoadQueue.Items);
+            return False;
+        }
+    }
+
+    FStreamChunk* Record = calloc(1, sizeof *Record);
+    if (Record == NULL) {
+        return False;
+    }
+    Stream_PopQueue(&Stream->LoadQueue);
+
+    Record->Chunk.X = Item.X;
+    Record->Chunk.Y = Item.Y;
+    Record->Chunk.Z = Item.Z;
+    Record->State = STREAM_CHUNK_LOADING;
+    Record->LastUsedUpdate = Stream->Update;
+    Record->Index = (U32)FVector_GetSize(Stream->RecordList);
+
+    FVector(FStreamChunk*) RecordList = Stream->RecordList;
+    if (FVector_GetSize(RecordList) == FVector_GetCapacity(RecordList)) {
+        const size_t Capacity = FVector_GetCapacity(RecordList) * 2 + 64;
+        FVector_Reserve(RecordList, Capacity);
+    }
+    FVector_Add(RecordList, Record);
+    Stream->RecordList = RecordList;
+
+    World_AddChunk(Stream->Records, &Record->Chunk);
+    Stream->Stats.MemoryUsed += sizeof *Record;
+
+    const FStreamJob Job = {STREAM_JOB_LOAD, Record};
+    Stream_Submit(Stream, &Job);
+
+    return True;
+}
+
+void Stream_StartMesh(FStream* Stream) {
+    const FStreamQueueItem Item = Stream->MeshQueue.Items[0];
+    Stream_PopQueue(&Stream->MeshQueue);
+
+    FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, Item.X, Item.Y, Item.Z);
+    Record->State = STREAM_CHUNK_MESHING;
+    Record->bMeshQueued = False;
+    // Cleared before the job starts, so modifications during meshing queue another mesh.
+    Record->bMeshOutdated = False;
+    Stream->PendingUploads++;
+    Stream->MeshJobsInFlight++;
+
+    FStreamJob Job = {STREAM_JOB_MESH, Record};
+    World_GetNeighbourhood(Stream->World, Item.X, Item.Y, Item.Z, &Job.Neighbourhood);
+    for (U32 Index = 0; Index < 27; Index++) {
+        ((FStreamChunk*)Job.Neighbourhood.Chunks[Index])->PinCount++;
+    }
+
+    Stream_Submit(Stream, &Job);
+}
+
+void Stream_Submit(FStream* Stream, const FStreamJob* Job) {
+    Stream->JobsInFlight++;
+
+    Mutex_Lock(Stream->Mutex);
+    Stream_PushRing(&Stream->Pending, Job);
+    Condition_Signal(Stream->JobAvailable);
+    Mutex_Unlock(Stream->Mutex);
+}
+
+void Stream_UploadMeshes(FStream* Stream) {
+    FStreamQueue* Queue = &Stream->UploadQueue;
+    while (Stream->Stats.Uploads < Stream->Settings.MaxUploadsPerUpdate && !FVector_IsEmpty(Queue->Items)) {
+        const FStreamQueueItem Item = Queue->Items[0];
+        FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, Item.X, Item.Y, Item.Z);
+        if (Record == NULL || Record->State != STREAM_CHUNK_MESHED) {
+            Stream_PopQueue(Queue);
+            continue;
+        }
+
+        if (Stream->Stats.Uploads > 0 && Stream->Stats.UploadBytes + Record->MeshSize > Stream->Settings.MaxUploadBytesPerUpdate) {
+            break;
+        }
+        Stream_PopQueue(Queue);
+
+        // A rebuilt mesh replaces the uploaded one.
+        if (Record->bUploaded && Stream->Settings.Release != NULL) {
+            Stream->Settings.Release(&Record->Chunk, Record->RenderData, Stream->Settings.UserData);
+        }
+        Stream->Stats.MemoryUsed -= Record->RenderSize;
+
+        U64 RenderSize = Record->MeshSize;
+        void* RenderData = NULL;
+        if (Stream->Settings.Upload != NULL) {
+            RenderData = Stream->Settings.Upload(&Record->Chunk, Record->Shapes, &RenderSize, Stream->Settings.UserData);
+        }
+
+        Stream->Stats.Uploads++;
+        Stream->Stats.UploadBytes += Record->MeshSize;
+        Stream->Stats.MemoryUsed += RenderSize - Record->MeshSize;
+
+        for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+            Shape_Free(&Record->Shapes[Section]);
+        }
+        Record->MeshSize = 0;
+        Record->RenderData = RenderData;
+        Record->RenderSize = RenderSize;
+        Record->bUploaded = True;
+        Record->State = STREAM_CHUNK_UPLOADED;
+        Stream->PendingUploads--;
+
+        // Edits made while the chunk was meshed are patched in by the section remesh.
+        if (Record->DirtySections != 0) {
+            Stream_PushQueue(&Stream->RemeshQueue, Item);
+        }
+
+        Stream_QueueMesh(Stream, Record);
+    }
+}
+
+void Stream_ApplyEdit(FStream* Stream, FStreamChunk* Record, const FStreamEdit* Edit) {
+    FChunk* Chunk = &Record->Chunk;
+    const I32 LocalX = World_GetLocalCoordinate(Edit->X);
+    const I32 LocalY = World_GetLocalCoordinate(Edit->Y);
+    const I32 LocalZ = World_GetLocalCoordinate(Edit->Z);
+    if (Chunk_GetBlockType(Chunk, LocalX, LocalY, LocalZ) == Edit->Type) {
+        return;
+    }
+
+    const Byte PreviousType = Chunk_GetBlockType(Chunk, LocalX, LocalY, LocalZ);
+    Chunk_SetBlockType(Chunk, LocalX, LocalY, LocalZ, Edit->Type);
+    Stream_OnBlockChanged(Stream, Record, Edit->X, Edit->Y, Edit->Z, PreviousType);
+
+    // Water and sand around the block may flow or fall now.
+    Cells_ActivateBlock(Stream->Cells, Edit->X, Edit->Y, Edit->Z);
+}
+
+void Stream_OnBlockChanged(FStream* Stream, FStreamChunk* Record, const I32 X, const I32 Y, const I32 Z, const Byte PreviousType) {
+    const Byte Type = Chunk_GetBlockType(&Record->Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z));
+    Record->bModified = True;
+
+    // Hierarchy bits aren't read by the mesh jobs, neighbour chunks can be relinked while they are pinned.
+    if (Block_IsSolid(PreviousType) && !Block_IsSolid(Type)) {
+        Connectivity_RemoveBlock(Stream->Connectivity, X, Y, Z);
+    } else if (!Block_IsSolid(PreviousType) && Block_IsSolid(Type)) {
+        Connectivity_AddBlock(Stream->Connectivity, X, Y, Z);
+    }
+
+    Light_UpdateBlock(Stream->Light, X, Y, Z);
+    Stream_MarkDirty(Stream, X, Y, Z, X, Y, Z);
+}
+
+void Stream_OnCellChanged(FChunk* Chunk, const I32 X, const I32 Y, const I32 Z, const Byte PreviousType, void* UserData) {
+    // Cells only see the loaded chunks, which are all records.
+    Stream_OnBlockChanged(UserData, (FStreamChunk*)Chunk, X, Y, Z, PreviousType);
+}
+
+Bool Stream_IsCellTickDue(const FStream* Stream) {
+    return Cells_IsPending(Stream->Cells) && Clock_GetNanoseconds() >= Stream->NextCellTick;
+}
+
+void Stream_OnConnectivityChanged(FChunk* Chunk, void* UserData) {
+    // Connectivity only sees the loaded chunks, which are all records.
+    ((FStreamChunk*)Chunk)->bModified = True;
+}
+
+void Stream_OnLightChanged(FChunk* Chunk, const I32 Min[3], const I32 Max[3], void* UserData) {
+    const I32 OriginX = Chunk->X * CHUNK_SIZE;
+    const I32 OriginY = Chunk->Y * CHUNK_SIZE;
+    const I32 OriginZ = Chunk->Z * CHUNK_SIZE;
+    Stream_MarkDirty(UserData, OriginX + Min[0], OriginY + Min[1], OriginZ + Min[2], OriginX + Max[0], OriginY + Max[1], OriginZ + Max[2]);
+}
+
+void Stream_ApplyDeferredEdits(FStream* Stream) {
+    FStreamEdit* Edits = Stream->DeferredEdits;
+    size_t Kept = 0;
+    for (size_t Index = 0; Index < FVector_GetSize(Edits); Index++) {
+        const FStreamEdit* Edit = &Edits[Index];
+        FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, World_GetChunkCoordinate(Edit->X), World_GetChunkCoordinate(Edit->Y),
+                                                             World_GetChunkCoordinate(Edit->Z));
+        if (Record == NULL) {
+            continue;
+        }
+
+        if (Record->PinCount > 0) {
+            Edits[Kept++] = *Edit;
+        } else {
+            Stream_ApplyEdit(Stream, Record, Edit);
+        }
+    }
+
+    FVector_SetSize(Stream->DeferredEdits, Kept);
+}
+
+void Stream_MarkDirty(FStream* Stream, const I32 MinX, const I32 MinY, const I32 MinZ, const I32 MaxX, const I32 MaxY, const I32 MaxZ) {
+    // Blocks on a section border change the faces of the adjoining blocks, the box grows by one to reach them.
+    const I32 Min[3] = {MinX - 1, MinY - 1, MinZ - 1};
+    const I32 Max[3] = {MaxX + 1, MaxY + 1, MaxZ + 1};
+    I32 MinSection[3];
+    I32 MaxSection[3];
+    for (U32 Axis = 0; Axis < 3; Axis++) {
+        MinSection[Axis] = (Min[Axis] >= 0 ? Min[Axis] : Min[Axis] - CHUNK_SECTION_SIZE + 1) / CHUNK_SECTION_SIZE;
+        MaxSection[Axis] = (Max[Axis] >= 0 ? Max[Axis] : Max[Axis] - CHUNK_SECTION_SIZE + 1) / CHUNK_SECTION_SIZE;
+    }
+
+    for (I32 SectionY = MinSection[1]; SectionY <= MaxSection[1]; SectionY++) {
+        for (I32 SectionZ = MinSection[2]; SectionZ <= MaxSection[2]; SectionZ++) {
+            for (I32 SectionX = MinSection[0]; SectionX <= MaxSection[0]; SectionX++) {
+                const I32 ChunkX = World_GetChunkCoordinate(SectionX * CHUNK_SECTION_SIZE);
+                const I32 ChunkY = World_GetChunkCoordinate(SectionY * CHUNK_SECTION_SIZE);
+                const I32 ChunkZ = World_GetChunkCoordinate(SectionZ * CHUNK_SECTION_SIZE);
+                FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, ChunkX, ChunkY, ChunkZ);
+                if (Record == NULL) {
+                    continue;
+                }
+
+                const U32 Section = (U32)(((SectionY - ChunkY * CHUNK_SECTIONS_PER_AXIS) * CHUNK_SECTIONS_PER_AXIS + SectionZ - ChunkZ * CHUNK_SECTIONS_PER_AXIS) *
+                                              CHUNK_SECTIONS_PER_AXIS +
+                                          SectionX - ChunkX * CHUNK_SECTIONS_PER_AXIS);
+                const U8 Bit = (U8)(1u << Section);
+                if (Record->DirtySections & Bit) {
+                    continue;
+                }
+
+                if (Record->DirtySections == 0) {
+                    Stream_PushQueue(&Stream->RemeshQueue, (FStreamQueueItem){Stream_GetPriority(Stream, ChunkX, ChunkY, ChunkZ), ChunkX, ChunkY, ChunkZ});
+                }
+                Record->DirtySections |= Bit;
+                Stream->DirtySectionCount++;
+            }
+        }
+    }
+}
+
+void Stream_ClearDirtySections(FStream* Stream, FStreamChunk* Record) {
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Stream->DirtySectionCount -= (Record->DirtySections >> Section) & 1u;
+    }
+    Record->DirtySections = 0;
+}
+
+void Stream_RemeshSections(FStream* Stream) {
+    const U64 Start = Clock_GetNanoseconds();
+    U32 Remeshed = 0;
+
+    FStreamQueue* Queue = &Stream->RemeshQueue;
+    while (!FVector_IsEmpty(Queue->Items) && Remeshed < Stream->Settings.MaxRemeshSectionsPerUpdate) {
+        const FStreamQueueItem Item = Queue->Items[0];
+        FStreamChunk* Record = (FStreamChunk*)World_GetChunk(Stream->World, Item.X, Item.Y, Item.Z);
+        if (Record == NULL || Record->DirtySections == 0) {
+            Stream_PopQueue(Queue);
+            continue;
+        }
+
+        // Chunks never meshed get a full mesh with the edits, chunks being meshed or uploaded are queued again after the upload.
+        if (Record->State != STREAM_CHUNK_UPLOADED) {
+            if (Record->State == STREAM_CHUNK_LOADED) {
+                Stream_ClearDirtySections(Stream, Record);
+            }
+            Stream_PopQueue(Queue);
+            continue;
+        }
+
+        FChunkNeighbourhood Neighbourhood;
+        World_GetNeighbourhood(Stream->World, Item.X, Item.Y, Item.Z, &Neighbourhood);
+
+        for (U32 Section = 0; Section < CHUNK_SECTION_COUNT && Remeshed < Stream->Settings.MaxRemeshSectionsPerUpdate; Section++) {
+            const U8 Bit = (U8)(1u << Section);
+            if (!(Record->DirtySections & Bit)) {
+                continue;
+            }
+
+            if (Stream->Settings.bFaceRecords) {
+                Mesher_BuildSectionFaces(&Neighbourhood, Section, &Stream->RemeshShape);
+            } else {
+                Mesher_BuildSection(&Neighbourhood, Section, &Stream->RemeshShape);
+            }
+            if (Stream->Settings.UploadSection != NULL) {
+                U64 RenderSize = Record->RenderSize;
+                Stream->Settings.UploadSection(&Record->Chunk, Section, &Stream->RemeshShape, Record->RenderData, &RenderSize, Stream->Settings.UserData);
+                Stream->Stats.MemoryUsed += RenderSize - Record->RenderSize;
+                Record->RenderSize = RenderSize;
+            }
+
+            Record->DirtySections &= (U8)~Bit;
+            Stream->DirtySectionCount--;
+            Remeshed++;
+        }
+
+        if (Record->DirtySections == 0) {
+            Stream_PopQueue(Queue);
+        }
+    }
+
+    Stream->Stats.RemeshedSections = Remeshed;
+    Stream->Stats.RemeshNanoseconds = Remeshed > 0 ? Clock_GetNanoseconds() - Start : 0;
+}
+
+Bool Stream_EvictOne(FStream* Stream) {
+    const Bool bCanSave = Stream->Settings.RegionDirectory != NULL && Stream->JobsInFlight < Stream->Settings.QueueCapacity;
+
+    FStreamChunk* Evicted = NULL;
+    for (size_t Index = 0; Index < FVector_GetSize(Stream->RecordList); Index++) {
+        FStreamChunk* Record = Stream->RecordList[Index];
+        const FChunk* Chunk = &Record->Chunk;
+        if (Record->PinCount > 0 || Stream_IsInRange(Stream, Chunk->X, Chunk->Y, Chunk->Z, 1) || (Record->bModified && !bCanSave) ||
+            (Record->State != STREAM_CHUNK_LOADED && Record->State != STREAM_CHUNK_MESHED && Record->State != STREAM_CHUNK_UPLOADED)) {
+            continue;
+        }
+
+        if (Evicted == NULL || Record->LastUsedUpdate < Evicted->LastUsedUpdate) {
+            Evicted = Record;
+        }
+    }
+
+    if (Evicted == NULL) {
+        return False;
+    }
+
+    const FChunk* Chunk = &Evicted->Chunk;
+    World_RemoveChunk(Stream->World, Chunk->X, Chunk->Y, Chunk->Z);
+    if (Evicted->State == STREAM_CHUNK_MESHED) {
+        Stream->PendingUploads--;
+    }
+    Stream_ReleaseMeshes(Stream, Evicted);
+    Stream_ClearDirtySections(Stream, Evicted);
+    Stream->Stats.EvictedChunks++;
+
+    // Modified chunks stay allocated until the save job finishes.
+    if (Evicted->bModified && Stream->Settings.RegionDirectory != NULL) {
+        Evicted->State = STREAM_CHUNK_SAVING;
+        const FStreamJob Job = {STREAM_JOB_SAVE, Evicted};
+        Stream_Submit(Stream, &Job);
+    } else {
+        Stream_FreeRecord(Stream, Evicted);
+    }
+
+    return True;
+}
+
+void Stream_ReleaseMeshes(FStream* Stream, FStreamChunk* Record) {
+    if (Record->bUploaded && Stream->Settings.Release != NULL) {
+        Stream->Settings.Release(&Record->Chunk, Record->RenderData, Stream->Settings.UserData);
+    }
+
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Shape_Free(&Record->Shapes[Section]);
+    }
+
+    Stream->Stats.MemoryUsed -= Record->MeshSize + Record->RenderSize;
+    Record->MeshSize = 0;
+    Record->RenderSize = 0;
+    Record->RenderData = NULL;
+    Record->bUploaded = False;
+}
+
+void Stream_FreeRecord(FStream* Stream, FStreamChunk* Record) {
+    World_RemoveChunk(Stream->Records, Record->Chunk.X, Record->Chunk.Y, Record->Chunk.Z);
+
+    // Swap the last record into the freed index.
+    FVector(FStreamChunk*) RecordList = Stream->RecordList;
+    FStreamChunk* Last = RecordList[FVector_GetSize(RecordList) - 1];
+    RecordList[Record->Index] = Last;
+    Last->Index = Record->Index;
+    FVector_PopBack(RecordList);
+
+    Stream->Stats.MemoryUsed -= sizeof *Record;
+    free(Record);
+}
+
+U64 Stream_GetMeshSize(const FShape Shapes[CHUNK_SECTION_COUNT]) {
+    U64 Size = 0;
+    for (U32 Section = 0; Section < CHUNK_SECTION_COUNT; Section++) {
+        Size += Shape_GetSize(&Shapes[Section]);
+    }
+
+    return Size;
+}
+
+void Stream_PushQueue(FStreamQueue* Queue, const FStreamQueueItem Item) {
+    if (FVector_GetSize(Queue->Items) == FVector_GetCapacity(Queue->Items)) {
+        const size_t Capacity = FVector_GetCapacity(Queue->Items) * 2 + 64;
+        FVector_Reserve(Queue->Items, Capacity);
+    }
+    FVector_Add(Queue->Items, Item);
+
+    FStreamQueueItem* Items = Queue->Items;
+    size_t Index = FVector_GetSize(Items) - 1;
+    while (Index > 0) {
+        const size_t Parent = (Index - 1) / 2;
+        if (Items[Parent].Priority <= Items[Index].Priority) {
+            break;
+        }
+
+        const FStreamQueueItem Swap = Items[Parent];
+        Items[Parent] = Items[Index];
+        Items[Index] = Swap;
+        Index = Parent;
+    }
+}
+
+void Stream_PopQueue(FStreamQueue* Queue) {
+    FStreamQueueItem* Items = Queue->Items;
+    const size_t Size = FVector_GetSize(Items) - 1;
+    Items[0] = Items[Size];
+    FVector_PopBack(Queue->Items);
+
+    size_t Index = 0;
+    for (;;) {
+        const size_t Left = Index * 2 + 1;
+        const size_t Right = Left + 1;
+        size_t Smallest = Index;
+        if (Left < Size && Items[Left].Priority < Items[Smallest].Priority) {
+            Smallest = Left;
+        }
+        if (Right < Size && Items[Right].Priority < Items[Smallest].Priority) {
+            Smallest = Right;
+        }
+        if (Smallest == Index) {
+            break;
+        }
+
+        const FStreamQueueItem Swap = Items[Smallest];
+        Items[Smallest] = Items[Index];
+        Items[Index] = Swap;
+        Index = Smallest;
+    }
+}
+
+void Stream_PushRing(FStreamRing* Ring, const FStreamJob* Job) {
+    Ring->Jobs[(Ring->Head + Ring->Count) % Ring->Capacity] = *Job;
+    Ring->Count++;
+}
+
+void Stream_PopRing(FStreamRing* Ring, FStreamJob* OutJob) {
+    *OutJob = Ring->Jobs[Ring->Head];
+    Ring->Head = (Ring->Head + 1) % Ring->Capacity;
+    Ring->Count--;
+}
+#pragma endregion
@@ -0,0 +1,139 @@
+#pragma once
+#include "typedefs.h"
+#include "chunk.h"
+#include "connectivity.h"
+#include "shape.h"
+#include "world.h"
+
+/** Chunk streaming state around the camera. */
+typedef struct FStream FStream;
+
+/**
+ * Uploads the meshes of the chunk sections, called on the thread updating the stream. Returns the render data passed
+ * to the release handler and the visitor, and the uploaded size counted against the memory budget.
+ */
+typedef void* (*StreamUploadHandler)(const FChunk* Chunk, const FShape Shapes[CHUNK_SECTION_COUNT], U64* OutSize, void* UserData);
+
+/**
+ * Replaces the mesh of a single section of an uploaded chunk, called on the thread updating the stream. Updates the
+ * uploaded size of the chunk.
+ */
+typedef void (*StreamSectionUploadHandler)(const FChunk* Chunk, U32 Section, const FShape* Shape, void* RenderData, U64* InOutSize, void* UserData);
+
+/** Releases the render data of an uploaded chunk. */
+typedef void (*StreamReleaseHandler)(const FChunk* Chunk, void* RenderData, void* UserData);
+
+/** Visits an uploaded chunk. */
+typedef void (*StreamChunkVisitor)(const FChunk* Chunk, void* RenderData, void* UserData);
+
+typedef struct {
+    /** Chunks meshed around the camera chunk horizontally and vertically, one more ring is loaded for the mesh borders. */
+    I32 Radius;
+    I32 VerticalRadius;
+    /** Bytes of chunks and meshes kept resident, least recently used chunks out of range are evicted above it. */
+    U64 MemoryBudget;
+    /** Meshes uploaded per update, the first upload of an update ignores the byte limit. */
+    U32 MaxUploadsPerUpdate;
+    U64 MaxUploadBytesPerUpdate;
+    /** Sections remeshed per update after block edits, the rest is left for the next update. */
+    U32 MaxRemeshSectionsPerUpdate;
+    /** Load, mesh and save jobs in flight, also limits meshes waiting for upload. */
+    U32 QueueCapacity;
+    /** Worker threads, 0 uses all processors but one. */
+    U32 WorkerCount;
+    /** Seconds between ticks of the water and sand cells, and the active cells a tick steps at most. */
+    F32 CellTickSeconds;
+    U32 MaxCellsPerTick;
+    /** Meshes sections into face records for the vertex pulling renderer instead of vertices, see Mesher_BuildSectionFaces. */
+    Bool bFaceRecords;
+    /** Terrain seed of generated chunks. */
+    U32 Seed;
+    /** Region files directory, NULL generates every chunk and never saves. */
+    pStr RegionDirectory;
+    /** Mesh upload handlers, optional. Without them meshes are dropped once they are counted as uploaded. */
+    StreamUploadHandler Upload;
+    StreamSectionUploadHandler UploadSection;
+    StreamReleaseHandler Release;
+    void* UserData;
+} FStreamSettings;
+
+typedef struct {
+    /** Chunks with memory allocated, including chunks being loaded and saved. */
+    U32 ResidentChunks;
+    /** Chunks waiting to be loaded, meshed and uploaded. */
+    U32 LoadQueueDepth;
+    U32 MeshQueueDepth;
+    U32 UploadQueueDepth;
+    /** Jobs processed by the workers. */
+    U32 JobsInFlight;
+    /** Uploads done by the last update. */
+    U32 Uploads;
+    U64 UploadBytes;
+    /** Sections remeshed after edits by the last update and the time it took. */
+    U32 RemeshedSections;
+    U64 RemeshNanoseconds;
+    /** Light propagation time of the last update, zero while mesh jobs held it back. */
+    U64 LightNanoseconds;
+    /** Cell tick time of the last update, zero when no tick ran. */
+    U64 CellNanoseconds;
+    /** Water and sand cells waiting for a tick. */
+    U32 ActiveCells;
+    /** Sections still waiting for a remesh after edits. */
+    U32 DirtySections;
+    /** Edits waiting for a worker to finish reading their chunk. */
+    U32 DeferredEdits;
+    /** Loads the last update couldn't start because nothing could be evicted to stay within the budget. */
+    U32 DeferredLoads;
+    /** Memory counted against the budget. */
+    U64 MemoryUsed;
+    U64 MemoryBudget;
+    /** Totals since the stream was created. */
+    U64 LoadedChunks;
+    U64 MeshedChunks;
+    U64 EvictedChunks;
+} FStreamStats;
+
+/** Fills the settings with defaults. */
+void Stream_GetDefaultSettings(FStreamSettings* OutSettings);
+
+/** Creates a stream and starts its workers. Returns NULL on failure. */
+FStream* Stream_Create(const FStreamSettings* Settings);
+
+/** Stops the workers, saves modified chunks and frees all chunks. */
+void Stream_Destroy(FStream* Stream);
+
+/**
+ * Moves the streamed area to the camera. Finished jobs are collected, chunks closest to the camera and in its view
+ * direction are queued first and a capped number of meshes is uploaded. Never blocks on the workers.
+ */
+void Stream_Update(FStream* Stream, const F32 CameraPosition[3], const F32 CameraForward[3]);
+
+/** Returns the loaded chunks, valid until the next update. */
+const FWorld* Stream_GetWorld(const FStream* Stream);
+
+/**
+ * Sets the type of the block at the world block position. The sections touching the block, in neighbour chunks too,
+ * are remeshed by the next update, several edits of a section within one update are remeshed once. Edits of chunks
+ * read by a worker are applied by a later update. The block hierarchy is updated with the edit, structures it cuts
+ * off from the ground are reported by the connectivity. The light around the block is propagated by the next update
+ * no mesh job is running in. Water and sand around the block start moving with the next cell tick, their moves are
+ * handled like edits. Returns False if the chunk isn't loaded.
+ */
+Bool Stream_SetBlockType(FStream* Stream, I32 X, I32 Y, I32 Z, Byte Type);
+
+/** Returns the block hierarchy of the loaded chunks, floating structures are collected from it. */
+FConnectivity* Stream_GetConnectivity(FStream* Stream);
+
+/**
+ * Marks a loaded chunk as modified after its blocks were changed directly, it is remeshed and saved before eviction.
+ * Direct changes leave the block hierarchy to the caller and don't relight the chunk.
+ */
+void Stream_MarkModified(FStream* Stream, const FChunk* Chunk);
+
+/** Visits the chunks with uploaded meshes. */
+void Stream_VisitUploaded(const FStream* Stream, StreamChunkVisitor Visitor, void* UserData);
+
+/** Returns True if every chunk in range is uploaded or can't be loaded within the budget, and no job is in flight. */
+Bool Stream_IsIdle(const FStream* Stream);
+
+void Stream_GetStats(const FStream* Stream, FStreamStats* OutStats);
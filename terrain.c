@@ -0,0 +1,87 @@
+#include "terrain.h"
+
+#include <string.h>
+
+#pragma region Private Function Declarations
+/** Hashes integer lattice coordinates into [0, 1). */
+static F32 Terrain_Hash(I32 X, I32 Z, U32 Seed);
+
+/** Smoothly interpolated value noise in [0, 1). */
+static F32 Terrain_ValueNoise(I32 X, I32 Z, I32 Period, U32 Seed);
+#pragma endregion
+
+#pragma region Public Function Definitions
+I32 Terrain_GetHeight(const I32 WorldX, const I32 WorldZ, const U32 Seed) {
+    const F32 Hills = Terrain_ValueNoise(WorldX, WorldZ, 64, Seed);
+    const F32 Bumps = Terrain_ValueNoise(WorldX, WorldZ, 16, Seed * 31 + 7);
+
+    return 8 + (I32)(Hills * 40.f + Bumps * 6.f);
+}
+
+void Terrain_Generate(FChunk* Chunk, const U32 Seed) {
+    memset(Chunk->Blocks, 0, sizeof Chunk->Blocks);
+
+    const I32 BaseX = Chunk->X * CHUNK_SIZE;
+    const I32 BaseY = Chunk->Y * CHUNK_SIZE;
+    const I32 BaseZ = Chunk->Z * CHUNK_SIZE;
+
+    for (I32 Z = 0; Z < CHUNK_SIZE; Z++) {
+        for (I32 X = 0; X < CHUNK_SIZE; X++) {
+            const I32 Height = Terrain_GetHeight(BaseX + X, BaseZ + Z, Seed);
+
+            for (I32 Y = 0; Y < CHUNK_SIZE; Y++) {
+                const I32 WorldY = BaseY + Y;
+                Byte Type;
+
+                if (WorldY < Height - 4) {
+                    Type = BLOCK_TYPE_STONE;
+                } else if (WorldY < Height - 1) {
+                    Type = BLOCK_TYPE_DIRT;
+                } else if (WorldY < Height) {
+                    Type = Height <= TERRAIN_SEA_LEVEL + 1 ? BLOCK_TYPE_SAND : BLOCK_TYPE_GRASS;
+                } else if (WorldY < TERRAIN_SEA_LEVEL) {
+                    Type = BLOCK_TYPE_WATER;
+                } else {
+                    continue;
+                }
+
+                // Terrain is the ground built structures rest on, see Connectivity_AddBlock.
+                FBlock* Block = &Chunk->Blocks[Chunk_GetBlockIndex(X, Y, Z)];
+                Block->Type = Type;
+                Block->Flags = Block_IsSolid(Type) ? BLOCK_FLAG_ANCHORED : 0;
+            }
+        }
+    }
+
+    Chunk_UpdateBlockCount(Chunk);
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+F32 Terrain_Hash(const I32 X, const I32 Z, const U32 Seed) {
+    U32 Hash = (U32)X * 0x8DA6B343u ^ (U32)Z * 0xD8163841u ^ Seed * 0xCB1AB31Fu;
+    Hash ^= Hash >> 13;
+    Hash *= 0x5BD1E995u;
+    Hash ^= Hash >> 15;
+
+    return (F32)(Hash & 0xFFFFFF) / (F32)0x1000000;
+}
+
+F32 Terrain_ValueNoise(const I32 X, const I32 Z, const I32 Period, const U32 Seed) {
+    // Floor division so negative coordinates continue the lattice.
+    const I32 CellX = (X >= 0 ? X : X - Period + 1) / Period;
+    const I32 CellZ = (Z >= 0 ? Z : Z - Period + 1) / Period;
+
+    F32 U = (F32)(X - CellX * Period) / (F32)Period;
+    F32 V = (F32)(Z - CellZ * Period) / (F32)Period;
+    U = U * U * (3.f - 2.f * U);
+    V = V * V * (3.f - 2.f * V);
+
+    const F32 A = Terrain_Hash(CellX, CellZ, Seed);
+    const F32 B = Terrain_Hash(CellX + 1, CellZ, Seed);
+    const F32 C = Terrain_Hash(CellX, CellZ + 1, Seed);
+    const F32 D = Terrain_Hash(CellX + 1, CellZ + 1, Seed);
+
+    return (A + (B - A) * U) + ((C + (D - C) * U) - (A + (B - A) * U)) * V;
+}
+#pragma endregion
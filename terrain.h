@@ -0,0 +1,12 @@
+#pragma once
+#include "typedefs.h"
+#include "chunk.h"
+
+/** World height of the water surface in blocks. */
+#define TERRAIN_SEA_LEVEL 24
+
+/** Returns the terrain height in blocks for the world column. Deterministic for the seed. */
+I32 Terrain_GetHeight(I32 WorldX, I32 WorldZ, U32 Seed);
+
+/** Fills the chunk with terrain blocks for the seed, overwriting its previous content. */
+void Terrain_Generate(FChunk* Chunk, U32 Seed);
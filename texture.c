@@ -1,62 +1,81 @@
 ﻿#include "texture.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <GL/glew.h>
 
-/** Four-character codes. */
-#define FOURCC_DXT1 0x31545844
-#define FOURCC_DXT3 0x33545844
-#define FOURCC_DXT5 0x35545844
+#include "dds.h"
+#include "file.h"
+#include "io.h"
+#include "render_stats.h"
 
-U32 Texture_LoadDDS(const pStr TexturePath) {
-    U8 Header[124];
+/** Asynchronous texture load. */
+typedef struct {
+    TextureHandler Handler;
+    void* UserData;
+    /** Tiles of an atlas loaded as an array texture, 0 for a 2D texture. */
+    U32 Columns;
+    U32 Rows;
+} FTextureLoad;
+
+static Bool Texture_OnDataLoaded(const FIoResult* Result);
+
+/** Returns the GL format of the block compressed DDS format, 0 if there is none. */
+static U32 Texture_GetFormat(EDdsFormat Format);
 
-    /** Try to open the file. */
-    FILE* pFile = fopen(TexturePath, "rb");
-    if (pFile == NULL) {
+U32 Texture_LoadDDS(const pStr TexturePath) {
+    /** Try to read the file. */
+    I64 Length;
+    U8* Data = (U8*)File_ReadText(TexturePath, &Length);
+    if (Data == NULL) {
         printf("Unable to open file %s\n", TexturePath);
         return 0;
     }
 
-    /** Check the file type. */
-    char FileType[4];
+    const U32 TextureId = Texture_CreateDDS(Data, (U64)Length);
+    free(Data);
+
+    return TextureId;
+}
+
+Bool Texture_LoadDDSAsync(const pStr TexturePath, const TextureHandler Handler, void* UserData) {
+    return Texture_LoadDDSArrayAsync(TexturePath, 0, 0, Handler, UserData);
+}
+
+Bool Texture_LoadDDSArrayAsync(const pStr TexturePath, const U32 Columns, const U32 Rows, const TextureHandler Handler, void* UserData) {
+    FTextureLoad* Load = malloc(sizeof *Load);
+    if (Load == NULL) {
+        return False;
+    }
+
+    Load->Handler = Handler;
+    Load->UserData = UserData;
+    Load->Columns = Columns;
+    Load->Rows = Rows;
+
+    FIoReadRequest Request = {0};
+    Request.Path = TexturePath;
+    Request.Priority = IO_PRIORITY_NORMAL;
+    Request.Handler = Texture_OnDataLoaded;
+    Request.UserData = Load;
+
+    if (Io_Read(&Request) == InvalidId) {
+        printf("Unable to queue texture read %s\n", TexturePath);
+        free(Load);
+        return False;
+    }
+
+    return True;
+}
 
-    fread(FileType, 1, 4, pFile);
-    if (strncmp(FileType, "DDS ", 4) != 0) {
-        printf("Bad file type %s, DDS expected", FileType);
-        fclose(pFile);
+U32 Texture_CreateDDS(const U8* Data, const U64 Length) {
+    FDdsImage Image;
+    if (!Dds_Parse(Data, Length, &Image)) {
         return 0;
     }
 
-    /** Get the surface header. */
-    fread(&Header, 124, 1, pFile);
-
-    U32 Height = *(U32*)&Header[8];
-    U32 Width = *(U32*)&Header[12];
-    const U32 LinearSize = *(U32*)&Header[16];
-    const U32 MipMapCount = *(U32*)&Header[24];
-    const U32 FourCC = *(U32*)&Header[80];
-
-    const U32 BufferSize = MipMapCount > 1 ? LinearSize * 2 : LinearSize;
-    U8* Buffer = (U8*)malloc(BufferSize * sizeof(U8));
-    fread(Buffer, 1, BufferSize, pFile);
-
-    fclose(pFile);
-
-    U32 Format;
-    switch (FourCC) {
-    case FOURCC_DXT1:
-        Format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
-        break;
-    case FOURCC_DXT3:
-        Format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
-        break;
-    case FOURCC_DXT5:
-        Format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-        break;
-    default:
-        printf("Bad file code %#x, expected DXT1, DXT3 or DXT5", FourCC);
-        free(Buffer);
+    const U32 Format = Texture_GetFormat(Image.Format);
+    if (Format == 0) {
         return 0;
     }
 
@@ -68,21 +87,97 @@ U32 Texture_LoadDDS(const pStr TexturePath) {
     glBindTexture(GL_TEXTURE_2D, TextureId);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-    const U32 BlockSize = (Format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
-    U32 Offset = 0;
+    RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, 1);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
 
     // Load mipmaps.
-    for (U32 Level = 0; Level < MipMapCount && (Width || Height); ++Level) {
-        const U32 Size = (Width + 3) / 4 * ((Height + 3) / 4) * BlockSize;
-
-        Offset += Size;
-        Width /= 2;
-        Height /= 2;
+    for (U32 Level = 0; Level < Image.MipLevelCount; ++Level) {
+        const FDdsMipLevel* MipLevel = &Image.MipLevels[Level];
+        glCompressedTexImage2D(GL_TEXTURE_2D, Level, Format, MipLevel->Width, MipLevel->Height, 0, MipLevel->Size, Data + MipLevel->Offset);
+        RenderStats_Count(RENDER_COUNTER_TEXTURE_BYTES, MipLevel->Size);
     }
 
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, Image.MipLevelCount - 1);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-    free(Buffer);
 
     return TextureId;
 }
+
+U32 Texture_CreateDDSArray(const U8* Data, const U64 Length, const U32 Columns, const U32 Rows) {
+    FDdsImage Image;
+    if (!Dds_Parse(Data, Length, &Image)) {
+        return 0;
+    }
+
+    const U32 Format = Texture_GetFormat(Image.Format);
+    const U32 LevelCount = Dds_GetTileMipLevelCount(&Image, Columns, Rows);
+    if (Format == 0 || LevelCount == 0) {
+        printf("Texture atlas %ux%u doesn't split into %ux%u tiles of whole blocks\n", Image.Width, Image.Height, Columns, Rows);
+        return 0;
+    }
+
+    // Layers of a level are uploaded at once, the first level is the largest.
+    const U32 LayerCount = Columns * Rows;
+    U8* Blocks = malloc((size_t)Image.MipLevels[0].Size);
+    if (Blocks == NULL) {
+        return 0;
+    }
+
+    GLuint TextureId;
+    glGenTextures(1, &TextureId);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, TextureId);
+    RenderStats_AddObjects(RENDER_OBJECT_TEXTURE, 1);
+    RenderStats_Count(RENDER_COUNTER_STATE_CHANGES, 1);
+
+    for (U32 Level = 0; Level < LevelCount; Level++) {
+        U32 Size = 0;
+        for (U32 Layer = 0; Layer < LayerCount; Layer++) {
+            Size += Dds_CopyTile(Data, &Image, Level, Columns, Rows, Layer, Blocks + Size);
+        }
+
+        const FDdsMipLevel* MipLevel = &Image.MipLevels[Level];
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, Level, Format, MipLevel->Width / Columns, MipLevel->Height / Rows, LayerCount, 0, Size, Blocks);
+        RenderStats_Count(RENDER_COUNTER_TEXTURE_BYTES, Size);
+    }
+    free(Blocks);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, LevelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
+
+    return TextureId;
+}
+
+static Bool Texture_OnDataLoaded(const FIoResult* Result) {
+    FTextureLoad* Load = Result->UserData;
+
+    U32 TextureId = 0;
+    if (Result->Status == IO_STATUS_COMPLETED) {
+        TextureId = Load->Columns > 0 ? Texture_CreateDDSArray(Result->Data, Result->Length, Load->Columns, Load->Rows)
+                                      : Texture_CreateDDS(Result->Data, Result->Length);
+    } else {
+        printf("Unable to read file %s\n", Result->Path);
+    }
+
+    if (Load->Handler != NULL) {
+        Load->Handler(TextureId, Load->UserData);
+    }
+
+    free(Load);
+
+    return False;
+}
+
+static U32 Texture_GetFormat(const EDdsFormat Format) {
+    switch (Format) {
+    case DDS_FORMAT_DXT1:
+        return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+    case DDS_FORMAT_DXT3:
+        return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+    case DDS_FORMAT_DXT5:
+        return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    default:
+        return 0;
+    }
+}
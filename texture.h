@@ -1,5 +1,21 @@
 ﻿#pragma once
 #include "typedefs.h"
 
+/** Called on the main thread with the created texture or 0 if loading failed. */
+typedef void (*TextureHandler)(U32 TextureId, void* UserData);
+
 /** Loads DDS texture. */
 U32 Texture_LoadDDS(pStr TexturePath);
+/** Reads DDS texture through the io service and creates it on completion, see Io_Update. */
+Bool Texture_LoadDDSAsync(pStr TexturePath, TextureHandler Handler, void* UserData);
+/** Creates texture from DDS file contents. */
+U32 Texture_CreateDDS(const U8* Data, U64 Length);
+
+/**
+ * Creates a 2D array texture from the tiles of a DDS atlas of Columns x Rows tiles, one layer per tile numbered row by
+ * row from the first row stored. The compressed blocks are copied as they are, so the mip chain ends at 4x4 tiles.
+ */
+U32 Texture_CreateDDSArray(const U8* Data, U64 Length, U32 Columns, U32 Rows);
+
+/** Reads a DDS atlas through the io service and creates its array texture on completion, see Texture_CreateDDSArray. */
+Bool Texture_LoadDDSArrayAsync(pStr TexturePath, U32 Columns, U32 Rows, TextureHandler Handler, void* UserData);
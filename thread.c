@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+
+#include "thread.h"
+
+#include <stdlib.h>
+
+#if OS_WINDOWS
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+#if OS_WINDOWS
+struct FThread {
+    HANDLE Handle;
+    ThreadFunction Function;
+    void* UserData;
+    int Result;
+};
+
+struct FMutex {
+    SRWLOCK Lock;
+};
+
+struct FCondition {
+    CONDITION_VARIABLE Variable;
+};
+#else
+struct FThread {
+    pthread_t Handle;
+    ThreadFunction Function;
+    void* UserData;
+    int Result;
+};
+
+struct FMutex {
+    pthread_mutex_t Mutex;
+};
+
+struct FCondition {
+    pthread_cond_t Variable;
+};
+#endif
+
+#pragma region Private Function Declarations
+#if OS_WINDOWS
+static unsigned __stdcall Thread_Main(void* Argument);
+#else
+static void* Thread_Main(void* Argument);
+#endif
+#pragma endregion
+
+#pragma region Public Function Definitions
+FThread* Thread_Create(const ThreadFunction Function, const pStr Name, void* UserData) {
+    FThread* Thread = calloc(1, sizeof *Thread);
+    if (Thread == NULL) {
+        return NULL;
+    }
+
+    Thread->Function = Function;
+    Thread->UserData = UserData;
+
+#if OS_WINDOWS
+    Thread->Handle = (HANDLE)_beginthreadex(NULL, 0, Thread_Main, Thread, 0, NULL);
+    if (Thread->Handle == 0) {
+        free(Thread);
+        return NULL;
+    }
+#else
+    if (pthread_create(&Thread->Handle, NULL, Thread_Main, Thread) != 0) {
+        free(Thread);
+        return NULL;
+    }
+#if defined(__linux__)
+    if (Name != NULL) {
+        // Thread names are limited to 15 characters.
+        char ShortName[16] = {0};
+        for (U32 Index = 0; Index < 15 && Name[Index] != '\0'; Index++) {
+            ShortName[Index] = Name[Index];
+        }
+        pthread_setname_np(Thread->Handle, ShortName);
+    }
+#endif
+#endif
+
+    return Thread;
+}
+
+int Thread_Join(FThread* Thread) {
+    if (Thread == NULL) {
+        return 0;
+    }
+
+#if OS_WINDOWS
+    WaitForSingleObject(Thread->Handle, INFINITE);
+    CloseHandle(Thread->Handle);
+#else
+    pthread_join(Thread->Handle, NULL);
+#endif
+
+    const int Result = Thread->Result;
+    free(Thread);
+
+    return Result;
+}
+
+U32 Thread_GetProcessorCount() {
+#if OS_WINDOWS
+    SYSTEM_INFO Info;
+    GetSystemInfo(&Info);
+    return Info.dwNumberOfProcessors > 0 ? Info.dwNumberOfProcessors : 1;
+#else
+    const long Count = sysconf(_SC_NPROCESSORS_ONLN);
+    return Count > 0 ? (U32)Count : 1;
+#endif
+}
+
+FMutex* Mutex_Create() {
+    FMutex* Mutex = calloc(1, sizeof *Mutex);
+    if (Mutex == NULL) {
+        return NULL;
+    }
+
+#if OS_WINDOWS
+    InitializeSRWLock(&Mutex->Lock);
+#else
+    pthread_mutex_init(&Mutex->Mutex, NULL);
+#endif
+
+    return Mutex;
+}
+
+void Mutex_Destroy(FMutex* Mutex) {
+    if (Mutex == NULL) {
+        return;
+    }
+
+#if !OS_WINDOWS
+    pthread_mutex_destroy(&Mutex->Mutex);
+#endif
+    free(Mutex);
+}
+
+void Mutex_Lock(FMutex* Mutex) {
+#if OS_WINDOWS
+    AcquireSRWLockExclusive(&Mutex->Lock);
+#else
+    pthread_mutex_lock(&Mutex->Mutex);
+#endif
+}
+
+void Mutex_Unlock(FMutex* Mutex) {
+#if OS_WINDOWS
+    ReleaseSRWLockExclusive(&Mutex->Lock);
+#else
+    pthread_mutex_unlock(&Mutex->Mutex);
+#endif
+}
+
+FCondition* Condition_Create() {
+    FCondition* Condition = calloc(1, sizeof *Condition);
+    if (Condition == NULL) {
+        return NULL;
+    }
+
+#if OS_WINDOWS
+    InitializeConditionVariable(&Condition->Variable);
+#else
+    pthread_cond_init(&Condition->Variable, NULL);
+#endif
+
+    return Condition;
+}
+
+void Condition_Destroy(FCondition* Condition) {
+    if (Condition == NULL) {
+        return;
+    }
+
+#if !OS_WINDOWS
+    pthread_cond_destroy(&Condition->Variable);
+#endif
+    free(Condition);
+}
+
+void Condition_Wait(FCondition* Condition, FMutex* Mutex) {
+#if OS_WINDOWS
+    SleepConditionVariableSRW(&Condition->Variable, &Mutex->Lock, INFINITE, 0);
+#else
+    pthread_cond_wait(&Condition->Variable, &Mutex->Mutex);
+#endif
+}
+
+void Condition_Signal(FCondition* Condition) {
+#if OS_WINDOWS
+    WakeConditionVariable(&Condition->Variable);
+#else
+    pthread_cond_signal(&Condition->Variable);
+#endif
+}
+
+void Condition_Broadcast(FCondition* Condition) {
+#if OS_WINDOWS
+    WakeAllConditionVariable(&Condition->Variable);
+#else
+    pthread_cond_broadcast(&Condition->Variable);
+#endif
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+#if OS_WINDOWS
+unsigned __stdcall Thread_Main(void* Argument) {
+    FThread* Thread = Argument;
+    Thread->Result = Thread->Function(Thread->UserData);
+    return 0;
+}
+#else
+void* Thread_Main(void* Argument) {
+    FThread* Thread = Argument;
+    Thread->Result = Thread->Function(Thread->UserData);
+    return NULL;
+}
+#endif
+#pragma endregion
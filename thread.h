@@ -0,0 +1,48 @@
+#pragma once
+#include "typedefs.h"
+
+/** Thread handle. */
+typedef struct FThread FThread;
+
+/** Mutex handle. */
+typedef struct FMutex FMutex;
+
+/** Condition variable handle. */
+typedef struct FCondition FCondition;
+
+/** Thread entry point. */
+typedef int (*ThreadFunction)(void* UserData);
+
+/** Starts a new thread running the function. Returns NULL on failure. */
+FThread* Thread_Create(ThreadFunction Function, pStr Name, void* UserData);
+
+/** Waits for the thread to finish and frees the handle. Returns the thread function result. */
+int Thread_Join(FThread* Thread);
+
+/** Returns the number of logical processors. */
+U32 Thread_GetProcessorCount();
+
+/** Creates a mutex. Returns NULL on failure. */
+FMutex* Mutex_Create();
+
+/** Destroys the mutex. */
+void Mutex_Destroy(FMutex* Mutex);
+
+void Mutex_Lock(FMutex* Mutex);
+
+void Mutex_Unlock(FMutex* Mutex);
+
+/** Creates a condition variable. Returns NULL on failure. */
+FCondition* Condition_Create();
+
+/** Destroys the condition variable. */
+void Condition_Destroy(FCondition* Condition);
+
+/** Atomically unlocks the mutex and waits for the condition, the mutex is locked again on return. */
+void Condition_Wait(FCondition* Condition, FMutex* Mutex);
+
+/** Wakes one waiting thread. */
+void Condition_Signal(FCondition* Condition);
+
+/** Wakes all waiting threads. */
+void Condition_Broadcast(FCondition* Condition);
@@ -68,6 +68,10 @@ U32 Time_GetDeltaTime() {
     return DeltaTime;
 }
 
+void Time_SetDeltaTime(const U32 Value) {
+    DeltaTime = Value;
+}
+
 F32 Time_GetFramesPerSecond() {
     return FramesPerSecond;
 }
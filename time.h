@@ -13,5 +13,8 @@ void Time_Shutdown();
 /** Returns time passed from the last frame. */
 U32 Time_GetDeltaTime();
 
+/** Overrides the delta time of the current frame, replays set the recorded one. The frame rate stays measured. */
+void Time_SetDeltaTime(U32 DeltaTime);
+
 /** Returns current average FPS rate. */
 F32 Time_GetFramesPerSecond();
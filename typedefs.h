@@ -31,7 +31,7 @@ typedef enum {
 } EDirection;
 
 #ifdef __unix__
-#define OS_Windows 0
+#define OS_WINDOWS 0
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -53,10 +53,10 @@ inline int Is64BitWindows() {
 #endif
 }
 
+#endif
+
 #define COLOR_BYTE(Color) Color/255.f
 
 #ifndef OUT
 #define OUT
 #endif
-
-#endif
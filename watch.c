@@ -0,0 +1,283 @@
+#include "watch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "clock.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define WATCH_INOTIFY_SUPPORTED 1
+#else
+#define WATCH_INOTIFY_SUPPORTED 0
+#endif
+
+#pragma region Settings
+/** Maximum length of a watched path. */
+#define WATCH_PATH_LENGTH 512
+/** Interval between modification time checks of the polling fallback. */
+#define WATCH_POLL_INTERVAL_NS 250000000ULL
+/** Changes settle for this long before handlers run, editors often write a file in several steps. */
+#define WATCH_SETTLE_NS 50000000ULL
+#pragma endregion
+
+/** Watched file. */
+typedef struct {
+    Bool bUsed;
+    char Path[WATCH_PATH_LENGTH];
+    /** File name part of the path, matched against directory events. */
+    const char* Name;
+    WatchHandler Handler;
+    void* UserData;
+    /** inotify watch of the parent directory, -1 when polling. */
+    int DirectoryWatch;
+    /** Polling state. */
+    I64 ModifiedTime;
+    I64 Size;
+    /** Time of the last unhandled change, zero if the file hasn't changed. */
+    U64 ChangedTime;
+} FWatch;
+
+#pragma region Private Variables
+static Bool bInitialized = False;
+static FWatch Watches[WATCH_MAX_FILES];
+static U64 LastPollTime;
+
+#if WATCH_INOTIFY_SUPPORTED
+static int NotifyDescriptor = -1;
+#endif
+#pragma endregion
+
+#pragma region Private Function Declarations
+/** Reads the file modification time and size, returns False if the file can't be accessed. */
+static Bool Watch_GetFileState(pStr Path, I64* OutModifiedTime, I64* OutSize);
+
+/** Marks changed files by their modification time. */
+static void Watch_Poll(U64 Now);
+
+#if WATCH_INOTIFY_SUPPORTED
+/** Marks changed files from the pending inotify events. */
+static void Watch_ReadEvents(U64 Now);
+#endif
+#pragma endregion
+
+#pragma region Public Function Definitions
+Bool Watch_Initialize() {
+    if (bInitialized) {
+        return bInitialized;
+    }
+
+    memset(Watches, 0, sizeof Watches);
+    LastPollTime = 0;
+
+#if WATCH_INOTIFY_SUPPORTED
+    NotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (NotifyDescriptor < 0) {
+        fprintf(stderr, "inotify is unavailable, polling watched files\n");
+    }
+#endif
+
+    bInitialized = True;
+
+    return bInitialized;
+}
+
+void Watch_Shutdown() {
+    if (!bInitialized) {
+        return;
+    }
+
+    for (U32 Id = 0; Id < WATCH_MAX_FILES; Id++) {
+        Watch_Remove(Id);
+    }
+
+#if WATCH_INOTIFY_SUPPORTED
+    if (NotifyDescriptor >= 0) {
+        close(NotifyDescriptor);
+        NotifyDescriptor = -1;
+    }
+#endif
+
+    bInitialized = False;
+}
+
+U32 Watch_AddFile(const pStr Path, const WatchHandler Handler, void* UserData) {
+    if (!bInitialized || Path == NULL || Handler == NULL || strlen(Path) >= WATCH_PATH_LENGTH) {
+        return InvalidId;
+    }
+
+    U32 Id = 0;
+    while (Id < WATCH_MAX_FILES && Watches[Id].bUsed) {
+        Id++;
+    }
+
+    if (Id == WATCH_MAX_FILES) {
+        fprintf(stderr, "Too many watched files, %s is not watched\n", Path);
+        return InvalidId;
+    }
+
+    FWatch* Watch = &Watches[Id];
+    memset(Watch, 0, sizeof *Watch);
+    strcpy(Watch->Path, Path);
+    Watch->Handler = Handler;
+    Watch->UserData = UserData;
+    Watch->DirectoryWatch = -1;
+
+    const char* Slash = strrchr(Watch->Path, '/');
+    const char* Backslash = strrchr(Watch->Path, '\\');
+    if (Backslash > Slash) {
+        Slash = Backslash;
+    }
+    Watch->Name = Slash != NULL ? Slash + 1 : Watch->Path;
+
+    Watch_GetFileState(Watch->Path, &Watch->ModifiedTime, &Watch->Size);
+
+#if WATCH_INOTIFY_SUPPORTED
+    if (NotifyDescriptor >= 0) {
+        // The directory is watched since editors replace files, which drops a watch on the file itself.
+        char Directory[WATCH_PATH_LENGTH];
+        if (Slash != NULL) {
+            snprintf(Directory, sizeof Directory, "%.*s", (int)(Slash - Watch->Path), Watch->Path);
+        } else {
+            strcpy(Directory, ".");
+        }
+
+        // inotify returns the same descriptor for a directory that is already watched.
+        Watch->DirectoryWatch = inotify_add_watch(NotifyDescriptor, Directory, IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+        if (Watch->DirectoryWatch < 0) {
+            fprintf(stderr, "Failed to watch %s, polling it\n", Directory);
+        }
+    }
+#endif
+
+    Watch->bUsed = True;
+
+    return Id;
+}
+
+void Watch_Remove(const U32 Id) {
+    if (Id >= WATCH_MAX_FILES || !Watches[Id].bUsed) {
+        return;
+    }
+
+#if WATCH_INOTIFY_SUPPORTED
+    // The directory watch is shared, drop it with its last file.
+    const int DirectoryWatch = Watches[Id].DirectoryWatch;
+    Watches[Id].bUsed = False;
+
+    if (DirectoryWatch >= 0) {
+        Bool bShared = False;
+        for (U32 Index = 0; Index < WATCH_MAX_FILES; Index++) {
+            bShared |= Watches[Index].bUsed && Watches[Index].DirectoryWatch == DirectoryWatch;
+        }
+
+        if (!bShared) {
+            inotify_rm_watch(NotifyDescriptor, DirectoryWatch);
+        }
+    }
+#else
+    Watches[Id].bUsed = False;
+#endif
+}
+
+U32 Watch_Update() {
+    if (!bInitialized) {
+        return 0;
+    }
+
+    const U64 Now = Clock_GetNanoseconds();
+
+#if WATCH_INOTIFY_SUPPORTED
+    if (NotifyDescriptor >= 0) {
+        Watch_ReadEvents(Now);
+    }
+#endif
+
+    if (Now - LastPollTime >= WATCH_POLL_INTERVAL_NS) {
+        LastPollTime = Now;
+        Watch_Poll(Now);
+    }
+
+    U32 Count = 0;
+    for (U32 Id = 0; Id < WATCH_MAX_FILES; Id++) {
+        FWatch* Watch = &Watches[Id];
+        if (!Watch->bUsed || Watch->ChangedTime == 0 || Now - Watch->ChangedTime < WATCH_SETTLE_NS) {
+            continue;
+        }
+
+        Watch->ChangedTime = 0;
+        Watch_GetFileState(Watch->Path, &Watch->ModifiedTime, &Watch->Size);
+        Watch->Handler(Watch->Path, Watch->UserData);
+        Count++;
+    }
+
+    return Count;
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+Bool Watch_GetFileState(const pStr Path, I64* OutModifiedTime, I64* OutSize) {
+    struct stat Stat;
+    if (stat(Path, &Stat) != 0) {
+        return False;
+    }
+
+    *OutModifiedTime = (I64)Stat.st_mtime;
+    *OutSize = (I64)Stat.st_size;
+
+    return True;
+}
+
+void Watch_Poll(const U64 Now) {
+    for (U32 Id = 0; Id < WATCH_MAX_FILES; Id++) {
+        FWatch* Watch = &Watches[Id];
+        if (!Watch->bUsed || Watch->DirectoryWatch >= 0) {
+            continue;
+        }
+
+        I64 ModifiedTime, Size;
+        if (Watch_GetFileState(Watch->Path, &ModifiedTime, &Size) && (ModifiedTime != Watch->ModifiedTime || Size != Watch->Size)) {
+            Watch->ModifiedTime = ModifiedTime;
+            Watch->Size = Size;
+            Watch->ChangedTime = Now;
+        }
+    }
+}
+
+#if WATCH_INOTIFY_SUPPORTED
+void Watch_ReadEvents(const U64 Now) {
+    // Event buffer aligned for struct inotify_event.
+    U64 Buffer[4096 / sizeof(U64)];
+
+    for (;;) {
+        const ssize_t Length = read(NotifyDescriptor, Buffer, sizeof Buffer);
+        if (Length <= 0) {
+            if (Length < 0 && errno != EAGAIN && errno != EINTR) {
+                perror("Failed to read file watch events");
+            }
+            return;
+        }
+
+        const char* Event = (const char*)Buffer;
+        while (Event < (const char*)Buffer + Length) {
+            const struct inotify_event* Notify = (const struct inotify_event*)Event;
+            if (Notify->len > 0) {
+                for (U32 Id = 0; Id < WATCH_MAX_FILES; Id++) {
+                    FWatch* Watch = &Watches[Id];
+                    if (Watch->bUsed && Watch->DirectoryWatch == Notify->wd && strcmp(Watch->Name, Notify->name) == 0) {
+                        // Later events of the same save push the handler further out.
+                        Watch->ChangedTime = Now;
+                    }
+                }
+            }
+
+            Event += sizeof(struct inotify_event) + Notify->len;
+        }
+    }
+}
+#endif
+#pragma endregion
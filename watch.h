@@ -0,0 +1,23 @@
+#pragma once
+#include "typedefs.h"
+
+/** Maximum number of watched files. */
+#define WATCH_MAX_FILES 64
+
+/** Called from Watch_Update on the calling thread once per update in which the file changed. */
+typedef void (*WatchHandler)(pStr Path, void* UserData);
+
+/** Starts watching, inotify on Linux and modification time polling elsewhere. */
+Bool Watch_Initialize();
+
+/** Stops watching and removes all watches. */
+void Watch_Shutdown();
+
+/** Watches the file for changes, including editors replacing it by a rename. Returns the watch id or InvalidId. */
+U32 Watch_AddFile(pStr Path, WatchHandler Handler, void* UserData);
+
+/** Stops watching the file. */
+void Watch_Remove(U32 Id);
+
+/** Collects file changes without blocking and calls the handlers. Returns the number of handled changes. */
+U32 Watch_Update();
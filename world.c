@@ -0,0 +1,160 @@
+#include "world.h"
+
+#include <stdlib.h>
+
+#pragma region Settings
+/** Initial number of map slots, a power of two. */
+#define WORLD_MIN_CAPACITY 64
+#pragma endregion
+
+/** Open addressing map with linear probing, empty slots are NULL. Chunk positions are read from the chunks. */
+struct FWorld {
+    FChunk** Slots;
+    U32 Capacity;
+    U32 Count;
+};
+
+#pragma region Private Function Declarations
+/** Returns the home slot of the chunk position. */
+static U32 World_GetSlot(const FWorld* World, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns the slot holding the chunk position or the empty slot ending its probe sequence. */
+static U32 World_FindSlot(const FWorld* World, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Rehashes the chunks into a map of the capacity. */
+static Bool World_Resize(FWorld* World, U32 Capacity);
+#pragma endregion
+
+#pragma region Public Function Definitions
+FWorld* World_Create() {
+    FWorld* World = calloc(1, sizeof *World);
+    if (World == NULL) {
+        return NULL;
+    }
+
+    if (!World_Resize(World, WORLD_MIN_CAPACITY)) {
+        free(World);
+        return NULL;
+    }
+
+    return World;
+}
+
+void World_Destroy(FWorld* World) {
+    if (World == NULL) {
+        return;
+    }
+
+    free(World->Slots);
+    free(World);
+}
+
+void World_AddChunk(FWorld* World, FChunk* Chunk) {
+    // Keep the load factor under a half so probe sequences stay short.
+    if ((World->Count + 1) * 2 > World->Capacity) {
+        World_Resize(World, World->Capacity * 2);
+    }
+
+    const U32 Slot = World_FindSlot(World, Chunk->X, Chunk->Y, Chunk->Z);
+    if (World->Slots[Slot] == NULL) {
+        World->Count++;
+    }
+    World->Slots[Slot] = Chunk;
+}
+
+void World_RemoveChunk(FWorld* World, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    U32 Slot = World_FindSlot(World, ChunkX, ChunkY, ChunkZ);
+    if (World->Slots[Slot] == NULL) {
+        return;
+    }
+
+    World->Slots[Slot] = NULL;
+    World->Count--;
+
+    // Shift the following chunks of the cluster back so lookups don't need tombstones.
+    const U32 Mask = World->Capacity - 1;
+    for (U32 Next = (Slot + 1) & Mask; World->Slots[Next] != NULL; Next = (Next + 1) & Mask) {
+        const FChunk* Chunk = World->Slots[Next];
+        const U32 Home = World_GetSlot(World, Chunk->X, Chunk->Y, Chunk->Z);
+
+        // Move the chunk unless its home lies cyclically within (Slot, Next].
+        const Bool bStays = Slot <= Next ? Slot < Home && Home <= Next : Slot < Home || Home <= Next;
+        if (!bStays) {
+            World->Slots[Slot] = World->Slots[Next];
+            World->Slots[Next] = NULL;
+            Slot = Next;
+        }
+    }
+}
+
+FChunk* World_GetChunk(const FWorld* World, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    return World->Slots[World_FindSlot(World, ChunkX, ChunkY, ChunkZ)];
+}
+
+U32 World_GetChunkCount(const FWorld* World) {
+    return World->Count;
+}
+
+void World_GetNeighbourhood(const FWorld* World, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ, FChunkNeighbourhood* OutNeighbourhood) {
+    for (I32 Index = 0; Index < 27; Index++) {
+        OutNeighbourhood->Chunks[Index] = World_GetChunk(World, ChunkX + Index % 3 - 1, ChunkY + Index / 9 - 1, ChunkZ + Index / 3 % 3 - 1);
+    }
+}
+
+Byte World_GetBlockType(const FWorld* World, const I32 X, const I32 Y, const I32 Z) {
+    const FChunk* Chunk = World_GetChunk(World, World_GetChunkCoordinate(X), World_GetChunkCoordinate(Y), World_GetChunkCoordinate(Z));
+    if (Chunk == NULL) {
+        return BLOCK_TYPE_AIR;
+    }
+
+    return Chunk_GetBlockType(Chunk, World_GetLocalCoordinate(X), World_GetLocalCoordinate(Y), World_GetLocalCoordinate(Z));
+}
+#pragma endregion
+
+#pragma region Private Function Definitions
+U32 World_GetSlot(const FWorld* World, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    U32 Hash = (U32)ChunkX * 0x8DA6B343u ^ (U32)ChunkY * 0xD8163841u ^ (U32)ChunkZ * 0xCB1AB31Fu;
+    Hash ^= Hash >> 15;
+    Hash *= 0x2C1B3C6Du;
+    Hash ^= Hash >> 12;
+
+    return Hash & (World->Capacity - 1);
+}
+
+U32 World_FindSlot(const FWorld* World, const I32 ChunkX, const I32 ChunkY, const I32 ChunkZ) {
+    const U32 Mask = World->Capacity - 1;
+
+    U32 Slot = World_GetSlot(World, ChunkX, ChunkY, ChunkZ);
+    for (;;) {
+        const FChunk* Chunk = World->Slots[Slot];
+        if (Chunk == NULL || (Chunk->X == ChunkX && Chunk->Y == ChunkY && Chunk->Z == ChunkZ)) {
+            return Slot;
+        }
+        Slot = (Slot + 1) & Mask;
+    }
+}
+
+Bool World_Resize(FWorld* World, const U32 Capacity) {
+    FChunk** Slots = calloc(Capacity, sizeof *Slots);
+    if (Slots == NULL) {
+        return False;
+    }
+
+    FChunk** PreviousSlots = World->Slots;
+    const U32 PreviousCapacity = World->Capacity;
+
+    World->Slots = Slots;
+    World->Capacity = Capacity;
+
+    for (U32 Index = 0; Index < PreviousCapacity; Index++) {
+        FChunk* Chunk = PreviousSlots[Index];
+        if (Chunk != NULL) {
+            World->Slots[World_FindSlot(World, Chunk->X, Chunk->Y, Chunk->Z)] = Chunk;
+        }
+    }
+
+    free(PreviousSlots);
+
+    return True;
+}
+#pragma endregion
@@ -0,0 +1,41 @@
+#pragma once
+#include "typedefs.h"
+#include "chunk.h"
+
+/** Map of resident chunks by chunk position. The world doesn't own the chunks. */
+typedef struct FWorld FWorld;
+
+/** Returns the chunk coordinate of a world block coordinate. */
+static inline I32 World_GetChunkCoordinate(const I32 BlockCoordinate) {
+    // Floor division so negative coordinates map to negative chunks.
+    return (BlockCoordinate >= 0 ? BlockCoordinate : BlockCoordinate - CHUNK_SIZE + 1) / CHUNK_SIZE;
+}
+
+/** Returns the coordinate of a world block coordinate local to its chunk. */
+static inline I32 World_GetLocalCoordinate(const I32 BlockCoordinate) {
+    return BlockCoordinate - World_GetChunkCoordinate(BlockCoordinate) * CHUNK_SIZE;
+}
+
+/** Creates an empty world. Returns NULL on failure. */
+FWorld* World_Create();
+
+/** Frees the world, the chunks are left to their owner. */
+void World_Destroy(FWorld* World);
+
+/** Adds the chunk at its position, replacing the chunk previously there. */
+void World_AddChunk(FWorld* World, FChunk* Chunk);
+
+/** Removes the chunk at the chunk position, if any. */
+void World_RemoveChunk(FWorld* World, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns the chunk at the chunk position, NULL if it isn't resident. */
+FChunk* World_GetChunk(const FWorld* World, I32 ChunkX, I32 ChunkY, I32 ChunkZ);
+
+/** Returns the number of resident chunks. */
+U32 World_GetChunkCount(const FWorld* World);
+
+/** Fills the neighbourhood of the chunk position, missing chunks are NULL. */
+void World_GetNeighbourhood(const FWorld* World, I32 ChunkX, I32 ChunkY, I32 ChunkZ, FChunkNeighbourhood* OutNeighbourhood);
+
+/** Returns the type of the block at the world block position, blocks of missing chunks are air. */
+Byte World_GetBlockType(const FWorld* World, I32 X, I32 Y, I32 Z);